@@ -2,8 +2,8 @@
 
 layout(location = 0) in vec3 inPos;
 layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec2 inUV;
-layout(location = 3) in vec3 inColor;
+layout(location = 2) in vec3 inColor;
+layout(location = 3) in vec2 inUV;
 layout(location = 4) in vec4 inTangent;
 
 layout(set = 0, binding = 0) uniform UBOScene
@@ -0,0 +1,60 @@
+#version 450
+
+// NOTE: sponza.vert for the compact and the quantized vertices(engine/mesh/vertex_packing.h). The vertex fetch turns
+// the unorm/snorm/half attributes into floats, the normal and the tangent are octahedral encoded and the tangent's
+// handedness is in the color's alpha.
+layout(location = 0) in vec3 inPos;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec4 inColor;
+layout(location = 3) in vec2 inUV;
+layout(location = 4) in vec2 inTangent;
+
+layout(set = 0, binding = 0) uniform UBOScene
+{
+    layout(row_major) mat4 projection;
+    layout(row_major) mat4 view;
+    vec4 lightPos;
+    vec4 viewPos;
+    vec4 posDequantScale;
+    vec4 posDequantOffset;
+}
+uboScene;
+
+layout(push_constant) uniform PushConsts
+{
+    layout(row_major) mat4 model;
+} primitive;
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec3 outColor;
+layout(location = 2) out vec2 outUV;
+layout(location = 3) out vec3 outViewVec;
+layout(location = 4) out vec3 outLightVec;
+layout(location = 5) out vec4 outTangent;
+
+vec3
+DecodeOctahedral(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.x += (v.x >= 0.0) ? -t : t;
+    v.y += (v.y >= 0.0) ? -t : t;
+    return normalize(v);
+}
+
+void
+main()
+{
+    // NOTE: The scale is 1 and the offset 0 for the compact vertices, which keep the float positions.
+    vec3 localPos = inPos * uboScene.posDequantScale.xyz + uboScene.posDequantOffset.xyz;
+
+    outColor = inColor.rgb;
+    outUV = inUV;
+    outTangent = vec4(DecodeOctahedral(inTangent), (inColor.a > 0.5) ? 1.0 : -1.0);
+    gl_Position = vec4(localPos, 1.0) * primitive.model * uboScene.view * uboScene.projection;
+
+    outNormal = DecodeOctahedral(inNormal) * mat3(primitive.model);
+    vec4 pos = vec4(localPos, 1.0) * primitive.model;
+    outLightVec = uboScene.lightPos.xyz - pos.xyz;
+    outViewVec = uboScene.viewPos.xyz - pos.xyz;
+}
@@ -0,0 +1,160 @@
+#include "dynamic_array.h"
+
+#if _SHU_DEBUG
+#include <vector>
+
+struct benchmark_item
+{
+    f32 Position[3];
+    f32 Normal[3];
+    i32 BodyA;
+    i32 BodyB;
+};
+
+struct dynamic_array_benchmark_result
+{
+    f32 ShooraMs;
+    f32 VectorMs;
+};
+
+static inline f32
+BenchmarkMs(u64 Start)
+{
+    return 1000.0f * Platform_GetSecondsElapsed(Start, Platform_GetWallClock());
+}
+
+// NOTE: Every pattern runs for Frames frames on a fresh array, like a per frame list that gets rebuilt. The
+// checksum only makes sure the compiler does not throw the work away.
+void
+dynamic_array_benchmark()
+{
+    const i32 Frames = 200;
+    const i32 Count = 4096;
+
+    size_t HeapSize = MEGABYTES(64);
+    void *Memory = malloc(HeapSize);
+    freelist_allocator Allocator;
+    Allocator.Initialize(Memory, HeapSize, MEGABYTES(8), FREELIST_DEFAULT_POLICY);
+
+    benchmark_item *Source = (benchmark_item *)malloc(sizeof(benchmark_item) * Count);
+    for(i32 i = 0; i < Count; ++i)
+    {
+        Source[i] = {{(f32)i, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, i, i + 1};
+    }
+
+    u64 Checksum = 0;
+    dynamic_array_benchmark_result PushBack, PushBackOneAndHalf, Append, SwapErase, ClearRefill;
+
+    // NOTE: push_back from empty, so the growth is part of the time.
+    u64 Start = Platform_GetWallClock();
+    for(i32 Frame = 0; Frame < Frames; ++Frame)
+    {
+        shoora_dynamic_array<benchmark_item> Array(&Allocator);
+        for(i32 i = 0; i < Count; ++i) { Array.push_back(Source[i]); }
+        Checksum += Array[Count - 1].BodyB;
+    }
+    PushBack.ShooraMs = BenchmarkMs(Start);
+
+    Start = Platform_GetWallClock();
+    for(i32 Frame = 0; Frame < Frames; ++Frame)
+    {
+        shoora_dynamic_array<benchmark_item, dynamic_array_grow_one_and_half> Array(&Allocator);
+        for(i32 i = 0; i < Count; ++i) { Array.push_back(Source[i]); }
+        Checksum += Array[Count - 1].BodyB;
+    }
+    PushBackOneAndHalf.ShooraMs = BenchmarkMs(Start);
+
+    Start = Platform_GetWallClock();
+    for(i32 Frame = 0; Frame < Frames; ++Frame)
+    {
+        std::vector<benchmark_item> Vector;
+        for(i32 i = 0; i < Count; ++i) { Vector.push_back(Source[i]); }
+        Checksum += Vector[Count - 1].BodyB;
+    }
+    PushBack.VectorMs = PushBackOneAndHalf.VectorMs = BenchmarkMs(Start);
+
+    // NOTE: Bulk append.
+    Start = Platform_GetWallClock();
+    for(i32 Frame = 0; Frame < Frames; ++Frame)
+    {
+        shoora_dynamic_array<benchmark_item> Array(&Allocator);
+        for(i32 i = 0; i < Count; i += 256) { Array.append(Source + i, 256); }
+        Checksum += Array[Count - 1].BodyB;
+    }
+    Append.ShooraMs = BenchmarkMs(Start);
+
+    Start = Platform_GetWallClock();
+    for(i32 Frame = 0; Frame < Frames; ++Frame)
+    {
+        std::vector<benchmark_item> Vector;
+        for(i32 i = 0; i < Count; i += 256) { Vector.insert(Vector.end(), Source + i, Source + i + 256); }
+        Checksum += Vector[Count - 1].BodyB;
+    }
+    Append.VectorMs = BenchmarkMs(Start);
+
+    // NOTE: Removing every other element, like expired manifolds. std::vector gets the same swap and pop.
+    {
+        shoora_dynamic_array<benchmark_item> Array(&Allocator);
+        std::vector<benchmark_item> Vector;
+
+        Start = Platform_GetWallClock();
+        for(i32 Frame = 0; Frame < Frames; ++Frame)
+        {
+            Array.Clear();
+            Array.append(Source, Count);
+            for(i32 i = Array.size() - 1; i >= 0; i -= 2) { Array.swap_erase(i); }
+            Checksum += Array.size();
+        }
+        SwapErase.ShooraMs = BenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 Frame = 0; Frame < Frames; ++Frame)
+        {
+            Vector.clear();
+            Vector.insert(Vector.end(), Source, Source + Count);
+            for(i32 i = (i32)Vector.size() - 1; i >= 0; i -= 2)
+            {
+                Vector[i] = Vector.back();
+                Vector.pop_back();
+            }
+            Checksum += Vector.size();
+        }
+        SwapErase.VectorMs = BenchmarkMs(Start);
+    }
+
+    // NOTE: The array is kept around and refilled every frame, so only Clear and push_back are timed.
+    {
+        shoora_dynamic_array<benchmark_item> Array(&Allocator);
+        std::vector<benchmark_item> Vector;
+
+        Start = Platform_GetWallClock();
+        for(i32 Frame = 0; Frame < Frames; ++Frame)
+        {
+            Array.Clear();
+            for(i32 i = 0; i < Count; ++i) { Array.push_back(Source[i]); }
+            Checksum += Array[Frame].BodyA;
+        }
+        ClearRefill.ShooraMs = BenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 Frame = 0; Frame < Frames; ++Frame)
+        {
+            Vector.clear();
+            for(i32 i = 0; i < Count; ++i) { Vector.push_back(Source[i]); }
+            Checksum += Vector[Frame].BodyA;
+        }
+        ClearRefill.VectorMs = BenchmarkMs(Start);
+    }
+
+    LogInfo("[Dynamic Array Benchmark]: %d frames of %d elements(checksum %llu).\n", Frames, Count, Checksum);
+    LogInfo("  push_back(2x)    %8.3fms, std::vector %8.3fms.\n", PushBack.ShooraMs, PushBack.VectorMs);
+    LogInfo("  push_back(1.5x)  %8.3fms, std::vector %8.3fms.\n", PushBackOneAndHalf.ShooraMs,
+            PushBackOneAndHalf.VectorMs);
+    LogInfo("  append           %8.3fms, std::vector %8.3fms.\n", Append.ShooraMs, Append.VectorMs);
+    LogInfo("  swap_erase       %8.3fms, std::vector %8.3fms.\n", SwapErase.ShooraMs, SwapErase.VectorMs);
+    LogInfo("  clear + refill   %8.3fms, std::vector %8.3fms.\n", ClearRefill.ShooraMs, ClearRefill.VectorMs);
+
+    free(Source);
+    free(Memory);
+}
+#endif
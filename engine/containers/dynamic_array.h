@@ -4,16 +4,33 @@
 #include <memory.h>
 #include <platform/platform.h>
 #include <utility>
+#include <type_traits>
 #include <memory/memory.h>
 
-template<typename T>
+// NOTE: Capacity the array starts with the first time it grows, so that small arrays do not reallocate on every
+// one of their first few pushes.
+#define DYNAMIC_ARRAY_MIN_CAPACITY 8
+
+// NOTE: Growth policies. Doubling reallocates the least, 1.5x wastes less memory on big arrays and lets the
+// freelist reuse the blocks that were freed by the earlier growths.
+struct dynamic_array_grow_double
+{
+    static constexpr i32 Grow(i32 Capacity) { return Capacity * 2; }
+};
+
+struct dynamic_array_grow_one_and_half
+{
+    static constexpr i32 Grow(i32 Capacity) { return Capacity + (Capacity / 2); }
+};
+
+template<typename T, typename growth_policy = dynamic_array_grow_double>
 struct shoora_dynamic_array
 {
   private:
-    T *arr;
+    T *arr = nullptr;
     i32 Size = 0;
     i32 Capacity = 0;
-    freelist_allocator *Allocator;
+    freelist_allocator *Allocator = nullptr;
 
   public:
     shoora_dynamic_array()
@@ -53,6 +70,16 @@ struct shoora_dynamic_array
         this->Allocator = GetFreelistAllocator(Type);
     }
 
+    shoora_dynamic_array(shoora_memory_type Type, i32 Capacity)
+    {
+        Size = 0;
+        this->Capacity = 0;
+        this->arr = nullptr;
+
+        this->Allocator = GetFreelistAllocator(Type);
+        reserve(Capacity);
+    }
+
     void
     SetAllocator(shoora_memory_type Type)
     {
@@ -65,7 +92,7 @@ struct shoora_dynamic_array
         this->Allocator = Allocator;
     }
 
-    shoora_dynamic_array(const shoora_dynamic_array<T> &Rhs) = delete;
+    shoora_dynamic_array(const shoora_dynamic_array &Rhs) = delete;
 #if 0
     {
         this->Capacity = Rhs.Capacity;
@@ -81,7 +108,7 @@ struct shoora_dynamic_array
     }
 #endif
 
-    shoora_dynamic_array(shoora_dynamic_array<T> &&Rhs)
+    shoora_dynamic_array(shoora_dynamic_array &&Rhs)
     {
         this->Capacity = Rhs.Capacity;
         this->Size = Rhs.Size;
@@ -94,7 +121,7 @@ struct shoora_dynamic_array
         Rhs.Allocator = nullptr;
     }
 
-    shoora_dynamic_array &operator=(const shoora_dynamic_array<T> &Rhs) = delete;
+    shoora_dynamic_array &operator=(const shoora_dynamic_array &Rhs) = delete;
 #if 0
     {
         if(this->arr)
@@ -119,7 +146,7 @@ struct shoora_dynamic_array
 #endif
 
     shoora_dynamic_array &
-    operator=(shoora_dynamic_array<T> &&Rhs)
+    operator=(shoora_dynamic_array &&Rhs)
     {
         this->Capacity = Rhs.Capacity;
         Size = Rhs.Size;
@@ -136,7 +163,6 @@ struct shoora_dynamic_array
         return *this;
     }
 
-    shoora_dynamic_array(i32 ReserveCapacity) { reserve(ReserveCapacity); }
     ~shoora_dynamic_array()
     {
         // LogFatalUnformatted("Dynamic array destructor called!\n");
@@ -152,32 +178,32 @@ struct shoora_dynamic_array
         this->Size = 0;
     }
 
+    // NOTE: Makes sure there is space for capacity elements. The elements already in the array are kept.
     inline void
     reserve(i32 capacity)
     {
-        ASSERT(this->Capacity == 0 && this->Size == 0);
-
-        this->Capacity = capacity;
-        this->arr = (T *)this->Allocator->Allocate(sizeof(T) * this->Capacity);
-        // arr = new T[this->Capacity];
-        Size = 0;
-
-        this->Clear();
+        ASSERT(this->Allocator != nullptr);
+        if(capacity > this->Capacity)
+        {
+            SetCapacity(capacity);
+        }
     }
 
     inline i32 size() const { return Size; }
     inline i32 capacity() { return Capacity; }
 
     inline void
-    Resize()
+    SetCapacity(i32 NewCapacity)
     {
-        i32 NewCapacity = Capacity == 0 ? 1 : Capacity*2;
+        ASSERT(NewCapacity >= Size);
+
         T *NewArr = nullptr;
         if (this->arr != nullptr) {
             NewArr = (T *)this->Allocator->ReAllocate(arr, NewCapacity * sizeof(T));
         } else {
-            NewArr = (T *)this->Allocator->Allocate(sizeof(T));
+            NewArr = (T *)this->Allocator->Allocate(NewCapacity * sizeof(T));
         }
+        ASSERT(NewArr != nullptr);
 
         this->arr = NewArr;
         this->Capacity = NewCapacity;
@@ -185,10 +211,24 @@ struct shoora_dynamic_array
         // LogWarn("Array has been resized to capacity: %d!\n", Capacity);
     }
 
+    // NOTE: Grows by the growth policy, or straight to RequiredCapacity if that is bigger.
+    inline void
+    Grow(i32 RequiredCapacity)
+    {
+        i32 NewCapacity = (Capacity == 0) ? DYNAMIC_ARRAY_MIN_CAPACITY : growth_policy::Grow(Capacity);
+        SetCapacity(MAX(NewCapacity, RequiredCapacity));
+    }
+
+    inline void
+    Resize()
+    {
+        Grow(Capacity + 1);
+    }
+
     inline void
     push_back(T &&item)
     {
-        if((Size + 1) >= Capacity)
+        if(Size == Capacity)
         {
             Resize();
         }
@@ -199,7 +239,7 @@ struct shoora_dynamic_array
     inline void
     push_back(T &item)
     {
-        if((Size + 1) >= Capacity)
+        if(Size == Capacity)
         {
             Resize();
         }
@@ -207,11 +247,43 @@ struct shoora_dynamic_array
         arr[Size++] = std::forward<T>(item);
     }
 
+    // NOTE: Copies Count elements to the end of the array in one go.
+    inline void
+    append(const T *Items, i32 Count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "append copies the bytes, T has to be trivially copyable.");
+        ASSERT(Count >= 0);
+
+        if((Size + Count) > Capacity)
+        {
+            Grow(Size + Count);
+        }
+
+        memcpy(arr + Size, Items, sizeof(T) * Count);
+        Size += Count;
+    }
+
+    // NOTE: Sets the size without constructing or zeroing anything, the caller fills in the new elements.
+    inline void
+    resize_uninitialized(i32 NewSize)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "resize_uninitialized leaves the elements as garbage, "
+                                                       "T has to be trivially copyable.");
+        ASSERT(NewSize >= 0);
+
+        if(NewSize > Capacity)
+        {
+            Grow(NewSize);
+        }
+
+        Size = NewSize;
+    }
+
     template <typename... Args>
     inline void
     emplace_back(Args &&...args)
     {
-        if ((Size + 1) > Capacity)
+        if (Size == Capacity)
         {
             Resize();
         }
@@ -238,13 +310,33 @@ struct shoora_dynamic_array
         return Result;
     }
 
+    // NOTE: Keeps the order of the elements, so everything after Index gets moved down by one.
     inline void
     erase(i32 Index)
     {
         ASSERT(Index < Size);
-        for(i32 i = Index; i < (Size-1); ++i)
+        if constexpr(std::is_trivially_copyable_v<T>)
+        {
+            memmove(arr + Index, arr + Index + 1, sizeof(T) * (Size - Index - 1));
+        }
+        else
         {
-            SWAP(arr[i], arr[i + 1]);
+            for(i32 i = Index; i < (Size-1); ++i)
+            {
+                arr[i] = std::move(arr[i + 1]);
+            }
+        }
+        --Size;
+    }
+
+    // NOTE: O(1) erase, the last element takes the place of the erased one. Does not keep the order.
+    inline void
+    swap_erase(i32 Index)
+    {
+        ASSERT(Index < Size);
+        if(Index != (Size - 1))
+        {
+            arr[Index] = std::move(arr[Size - 1]);
         }
         --Size;
     }
@@ -255,14 +347,19 @@ struct shoora_dynamic_array
         return arr;
     }
 
+    // NOTE: Does not touch the memory, the elements are overwritten when they get pushed again.
     inline void
     Clear()
     {
         ASSERT(Capacity >= Size);
-        SHU_MEMZERO(arr, sizeof(T) * Capacity);
         Size = 0;
     }
 };
 
+#if _SHU_DEBUG
+// NOTE: Times the common per frame patterns(push, bulk append, erase, clear and refill) against std::vector.
+void dynamic_array_benchmark();
+#endif
+
 #define DYNAMIC_ARRAY_H
 #endif
\ No newline at end of file
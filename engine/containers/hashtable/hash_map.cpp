@@ -0,0 +1,178 @@
+#include "hash_map.h"
+
+#if _SHU_DEBUG
+#include <unordered_map>
+#include "hashtable.h"
+#include <platform/platform.h>
+#include <utils/random/random.h>
+
+// NOTE: Random inserts and removes checked against a plain array indexed by the key.
+void
+hash_map_test()
+{
+    const u32 KeyRange = 4096;
+    i32 *Expected = (i32 *)malloc(sizeof(i32) * KeyRange);
+    for(u32 i = 0; i < KeyRange; ++i) { Expected[i] = -1; }
+
+    shoora_hash_map<u32, i32> Map;
+    u32 ExpectedCount = 0;
+
+    shoora_random Random(0x4a5b6c7d);
+    for(i32 Iteration = 0; Iteration < 200000; ++Iteration)
+    {
+        // NOTE: Between can return the max. The keys are spread out so that they do not hash to neighbours.
+        u32 KeyIndex = MIN(Random.Between(0u, KeyRange), KeyRange - 1);
+        u32 Key = KeyIndex * 2654435761u;
+        if(Random.Between(0u, 100u) < 60)
+        {
+            Map.Insert(Key, Iteration);
+            if(Expected[KeyIndex] < 0) { ++ExpectedCount; }
+            Expected[KeyIndex] = Iteration;
+        }
+        else
+        {
+            b32 Removed = Map.Remove(Key);
+            ASSERT(Removed == (Expected[KeyIndex] >= 0));
+            if(Removed) { --ExpectedCount; }
+            Expected[KeyIndex] = -1;
+        }
+
+        if((Iteration % 1009) == 0)
+        {
+            ASSERT(Map.size() == ExpectedCount);
+            for(u32 i = 0; i < KeyRange; ++i)
+            {
+                i32 *Value = Map.Find(i * 2654435761u);
+                ASSERT((Value == nullptr) == (Expected[i] < 0));
+                ASSERT(Value == nullptr || *Value == Expected[i]);
+            }
+        }
+    }
+
+    u32 Visited = 0;
+    for(u32 i = 0; i < Map.GetCapacity(); ++i)
+    {
+        if(Map.IsSlotUsed(i))
+        {
+            ++Visited;
+        }
+    }
+    ASSERT(Visited == ExpectedCount);
+
+    free(Expected);
+    LogInfoUnformatted("[Hash Map Test]: Passed.\n");
+}
+
+// NOTE: htable keys are pointers, the integer key is stored in the pointer itself(never zero).
+static u32
+BenchmarkHTableHash(const void *Key, u32 Seed)
+{
+    return (u32)HashMapMix64((u64)Key ^ Seed);
+}
+
+static b32
+BenchmarkHTableEquals(const void *A, const void *B)
+{
+    return A == B;
+}
+
+struct hash_map_benchmark_times
+{
+    f32 Insert;
+    f32 Hit;
+    f32 Miss;
+    f32 Remove;
+};
+
+static inline f32
+HashMapBenchmarkMs(u64 Start)
+{
+    return 1000.0f * Platform_GetSecondsElapsed(Start, Platform_GetWallClock());
+}
+
+void
+hash_map_benchmark()
+{
+    const i32 Count = 200000;
+    u64 *Keys = (u64 *)malloc(sizeof(u64) * Count * 2);
+    shoora_random Random(0x1337);
+    for(i32 i = 0; i < Count * 2; ++i)
+    {
+        // NOTE: The second half are the keys for the misses.
+        Keys[i] = ((u64)Random.NextU32() << 32) | (u64)(i + 1);
+    }
+
+    u64 Checksum = 0;
+    hash_map_benchmark_times Shoora, HTable, Std;
+
+    {
+        shoora_hash_map<u64, u64> Map;
+
+        u64 Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; ++i) { Map.Insert(Keys[i], (u64)i); }
+        Shoora.Insert = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; ++i) { Checksum += *Map.Find(Keys[i]); }
+        Shoora.Hit = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = Count; i < Count * 2; ++i) { Checksum += (Map.Find(Keys[i]) != nullptr); }
+        Shoora.Miss = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; i += 2) { Checksum += Map.Remove(Keys[i]); }
+        Shoora.Remove = HashMapBenchmarkMs(Start);
+    }
+
+    {
+        htable *Table = HashTableCreate(BenchmarkHTableHash, BenchmarkHTableEquals, nullptr);
+
+        u64 Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; ++i) { HashTableInsert(Table, (void *)Keys[i], (void *)(u64)(i + 1)); }
+        HTable.Insert = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; ++i) { Checksum += (u64)HashTableGetDirect(Table, (void *)Keys[i]) - 1; }
+        HTable.Hit = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = Count; i < Count * 2; ++i) { Checksum += HashTableGet(Table, (void *)Keys[i], nullptr); }
+        HTable.Miss = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; i += 2) { HashTableRemove(Table, (void *)Keys[i]); ++Checksum; }
+        HTable.Remove = HashMapBenchmarkMs(Start);
+
+        HashTableDestroy(Table);
+    }
+
+    {
+        std::unordered_map<u64, u64> Map;
+
+        u64 Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; ++i) { Map[Keys[i]] = (u64)i; }
+        Std.Insert = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; ++i) { Checksum += Map.find(Keys[i])->second; }
+        Std.Hit = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = Count; i < Count * 2; ++i) { Checksum += (Map.find(Keys[i]) != Map.end()); }
+        Std.Miss = HashMapBenchmarkMs(Start);
+
+        Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; i += 2) { Checksum += Map.erase(Keys[i]); }
+        Std.Remove = HashMapBenchmarkMs(Start);
+    }
+
+    LogInfo("[Hash Map Benchmark]: %d u64 keys(checksum %llu). Insert / Hit / Miss / Remove in ms:\n", Count,
+            Checksum);
+    LogInfo("  shoora_hash_map    %8.3f %8.3f %8.3f %8.3f\n", Shoora.Insert, Shoora.Hit, Shoora.Miss, Shoora.Remove);
+    LogInfo("  htable             %8.3f %8.3f %8.3f %8.3f\n", HTable.Insert, HTable.Hit, HTable.Miss, HTable.Remove);
+    LogInfo("  std::unordered_map %8.3f %8.3f %8.3f %8.3f\n", Std.Insert, Std.Hit, Std.Miss, Std.Remove);
+
+    free(Keys);
+}
+#endif
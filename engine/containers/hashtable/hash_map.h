@@ -0,0 +1,396 @@
+#if !defined(HASH_MAP_H)
+
+#include <defines.h>
+#include <emmintrin.h>
+#include <type_traits>
+#include <memory/memory.h>
+
+// NOTE: Open addressing hash map in the style of SwissTable. Every slot has a control byte next to it in a separate
+// array: HASH_MAP_EMPTY, HASH_MAP_DELETED or the low 7 bits of the hash(H2) if the slot is used. The slots are split
+// into groups of 16 and one SSE2 compare checks the H2 of a whole group at once, so a lookup almost never touches a
+// slot with the wrong key. The upper bits of the hash(H1) pick the first group, the groups after that are probed
+// with triangular steps, which visits every group once since the group count is a power of two.
+// Keys and values live inline in the slots, so K and V have to be trivially copyable.
+#define HASH_MAP_GROUP_WIDTH 16
+#define HASH_MAP_EMPTY ((i8)-128)
+#define HASH_MAP_DELETED ((i8)-2)
+// NOTE: Grows when used + deleted slots go over 7/8 of the capacity.
+#define HASH_MAP_MAX_LOAD_NUMERATOR 7
+#define HASH_MAP_MAX_LOAD_DENOMINATOR 8
+
+inline u64
+HashMapMix64(u64 Key)
+{
+    Key ^= Key >> 33;
+    Key *= 0xff51afd7ed558ccdULL;
+    Key ^= Key >> 33;
+    Key *= 0xc4ceb9fe1a85ec53ULL;
+    Key ^= Key >> 33;
+    return Key;
+}
+
+// NOTE: Hash and equality for a key type. Specialize this for the key types that are not integers or pointers.
+template <typename K>
+struct shoora_hash
+{
+    static_assert(std::is_integral_v<K> || std::is_pointer_v<K> || std::is_enum_v<K>,
+                  "shoora_hash needs a specialization for this key type.");
+
+    static inline u64 Hash(const K &Key) { return HashMapMix64((u64)Key); }
+    static inline b32 Equals(const K &A, const K &B) { return A == B; }
+};
+
+// NOTE: Where the memory of the map comes from. Arenas never get memory back, so a map on an arena leaves its old
+// memory behind every time it grows. Reserve up front if that matters. Without an allocator it uses malloc.
+struct hash_map_allocator
+{
+    freelist_allocator *Freelist = nullptr;
+    memory_arena *Arena = nullptr;
+
+    inline void *
+    Allocate(size_t Size)
+    {
+        void *Result = nullptr;
+        if(this->Freelist != nullptr) { Result = this->Freelist->Allocate(Size, 16); }
+        else if(this->Arena != nullptr) { Result = ShuAllocate_(this->Arena, Size, 16); }
+        else { Result = malloc(Size); }
+
+        ASSERT(Result != nullptr);
+        return Result;
+    }
+
+    inline void
+    Free(void *Memory)
+    {
+        if(this->Freelist != nullptr) { this->Freelist->Free(Memory); }
+        else if(this->Arena == nullptr) { free(Memory); }
+    }
+};
+
+inline u32
+HashMapFirstSetBit(u32 Mask)
+{
+    ASSERT(Mask != 0);
+#if defined(_MSC_VER)
+    unsigned long Index;
+    _BitScanForward(&Index, Mask);
+    return (u32)Index;
+#else
+    return (u32)__builtin_ctz(Mask);
+#endif
+}
+
+template <typename K, typename V, typename hasher = shoora_hash<K>>
+struct shoora_hash_map
+{
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "shoora_hash_map keeps the keys and values inline and moves them with memcpy.");
+
+    struct slot
+    {
+        K Key;
+        V Value;
+    };
+
+  private:
+    i8 *Control = nullptr;
+    slot *Slots = nullptr;
+    // NOTE: Always a multiple of HASH_MAP_GROUP_WIDTH and a power of two, or zero.
+    u32 Capacity = 0;
+    u32 Count = 0;
+    u32 DeletedCount = 0;
+    hash_map_allocator Allocator;
+
+  public:
+    shoora_hash_map() = default;
+    shoora_hash_map(const shoora_hash_map &) = delete;
+    shoora_hash_map &operator=(const shoora_hash_map &) = delete;
+    ~shoora_hash_map() { Free(); }
+
+    void
+    SetAllocator(freelist_allocator *Freelist)
+    {
+        ASSERT(this->Capacity == 0);
+        this->Allocator = {};
+        this->Allocator.Freelist = Freelist;
+    }
+
+    void
+    SetAllocator(memory_arena *Arena)
+    {
+        ASSERT(this->Capacity == 0);
+        this->Allocator = {};
+        this->Allocator.Arena = Arena;
+    }
+
+    // NOTE: MEMTYPE_FREELISTGLOBAL/MEMTYPE_FREELISTFRAME use the freelist, the other types the arena.
+    void
+    SetAllocator(shoora_memory_type Type)
+    {
+        if(Type == MEMTYPE_FREELISTGLOBAL || Type == MEMTYPE_FREELISTFRAME)
+        {
+            SetAllocator(GetFreelistAllocator(Type));
+        }
+        else
+        {
+            SetAllocator(GetArena(Type));
+        }
+    }
+
+    void
+    Free()
+    {
+        if(this->Control != nullptr)
+        {
+            this->Allocator.Free(this->Control);
+        }
+        this->Control = nullptr;
+        this->Slots = nullptr;
+        this->Capacity = 0;
+        this->Count = 0;
+        this->DeletedCount = 0;
+    }
+
+    // NOTE: Makes sure ItemCount items fit without growing.
+    void
+    Reserve(u32 ItemCount)
+    {
+        u32 NewCapacity = HASH_MAP_GROUP_WIDTH;
+        while(((u64)NewCapacity * HASH_MAP_MAX_LOAD_NUMERATOR) / HASH_MAP_MAX_LOAD_DENOMINATOR < ItemCount)
+        {
+            NewCapacity *= 2;
+        }
+
+        if(NewCapacity > this->Capacity)
+        {
+            Rehash(NewCapacity);
+        }
+    }
+
+    inline u32 size() const { return this->Count; }
+    inline u32 GetCapacity() const { return this->Capacity; }
+
+    V *
+    Find(const K &Key) const
+    {
+        if(this->Count == 0)
+        {
+            return nullptr;
+        }
+
+        i32 Index = FindIndex(Key, hasher::Hash(Key));
+        V *Result = (Index >= 0) ? &this->Slots[Index].Value : nullptr;
+        return Result;
+    }
+
+    inline b32 Contains(const K &Key) const { return Find(Key) != nullptr; }
+
+    // NOTE: Returns the value of the key, adding the key with a zeroed value if it is not there. Inserted(if passed
+    // in) tells which one happened. The pointer is good until the next insert.
+    V *
+    FindOrInsert(const K &Key, b32 *Inserted = nullptr)
+    {
+        u64 Hash = hasher::Hash(Key);
+        if(this->Count > 0)
+        {
+            i32 Index = FindIndex(Key, Hash);
+            if(Index >= 0)
+            {
+                if(Inserted) { *Inserted = false; }
+                return &this->Slots[Index].Value;
+            }
+        }
+
+        if(((u64)(this->Count + this->DeletedCount + 1) * HASH_MAP_MAX_LOAD_DENOMINATOR) >
+           ((u64)this->Capacity * HASH_MAP_MAX_LOAD_NUMERATOR))
+        {
+            // NOTE: If the live items are less than half of the max load, most of it is tombstones and rehashing at the
+            // same size is enough to clean them up.
+            u32 NewCapacity = HASH_MAP_GROUP_WIDTH;
+            if(this->Capacity > 0)
+            {
+                b32 MostlyDeleted = ((u64)(this->Count + 1) * HASH_MAP_MAX_LOAD_DENOMINATOR * 2) <=
+                                    ((u64)this->Capacity * HASH_MAP_MAX_LOAD_NUMERATOR);
+                NewCapacity = MostlyDeleted ? this->Capacity : this->Capacity * 2;
+            }
+            Rehash(NewCapacity);
+        }
+
+        u32 Index = FindInsertIndex(Hash);
+        if(this->Control[Index] == HASH_MAP_DELETED)
+        {
+            --this->DeletedCount;
+        }
+        this->Control[Index] = H2(Hash);
+        this->Slots[Index].Key = Key;
+        SHU_MEMZERO(&this->Slots[Index].Value, sizeof(V));
+        ++this->Count;
+
+        if(Inserted) { *Inserted = true; }
+        return &this->Slots[Index].Value;
+    }
+
+    // NOTE: Adds the key or overwrites its value.
+    inline V *
+    Insert(const K &Key, const V &Value)
+    {
+        V *Result = FindOrInsert(Key);
+        *Result = Value;
+        return Result;
+    }
+
+    b32
+    Remove(const K &Key)
+    {
+        if(this->Count == 0)
+        {
+            return false;
+        }
+
+        i32 Index = FindIndex(Key, hasher::Hash(Key));
+        if(Index < 0)
+        {
+            return false;
+        }
+
+        // NOTE: Lookups stop at the first group with an empty slot. If the group of this slot has one, no probe ever
+        // went past this group, so the slot can go back to empty instead of becoming a tombstone.
+        u32 GroupStart = (u32)Index & ~(HASH_MAP_GROUP_WIDTH - 1);
+        __m128i Group = _mm_loadu_si128((const __m128i *)(this->Control + GroupStart));
+        u32 EmptyMask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(Group, _mm_set1_epi8(HASH_MAP_EMPTY)));
+        if(EmptyMask != 0)
+        {
+            this->Control[Index] = HASH_MAP_EMPTY;
+        }
+        else
+        {
+            this->Control[Index] = HASH_MAP_DELETED;
+            ++this->DeletedCount;
+        }
+        --this->Count;
+
+        return true;
+    }
+
+    // NOTE: Keeps the memory.
+    void
+    Clear()
+    {
+        if(this->Capacity > 0)
+        {
+            SHU_MEMSET(this->Control, HASH_MAP_EMPTY, this->Capacity);
+        }
+        this->Count = 0;
+        this->DeletedCount = 0;
+    }
+
+    // NOTE: Slot access for going over all the items: for(i < GetCapacity()) if(IsSlotUsed(i)) GetSlot(i).
+    inline b32 IsSlotUsed(u32 Index) const { return this->Control[Index] >= 0; }
+    inline slot &GetSlot(u32 Index) const { return this->Slots[Index]; }
+
+  private:
+    static inline u64 H1(u64 Hash) { return Hash >> 7; }
+    static inline i8 H2(u64 Hash) { return (i8)(Hash & 0x7F); }
+
+    i32
+    FindIndex(const K &Key, u64 Hash) const
+    {
+        const u32 GroupMask = (this->Capacity / HASH_MAP_GROUP_WIDTH) - 1;
+        const __m128i Match = _mm_set1_epi8(H2(Hash));
+        const __m128i Empty = _mm_set1_epi8(HASH_MAP_EMPTY);
+
+        u32 GroupIndex = (u32)H1(Hash) & GroupMask;
+        for(u32 Step = 1; Step <= GroupMask + 1; ++Step)
+        {
+            const i8 *GroupControl = this->Control + GroupIndex * HASH_MAP_GROUP_WIDTH;
+            __m128i Group = _mm_loadu_si128((const __m128i *)GroupControl);
+
+            u32 MatchMask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(Group, Match));
+            while(MatchMask != 0)
+            {
+                u32 Index = GroupIndex * HASH_MAP_GROUP_WIDTH + HashMapFirstSetBit(MatchMask);
+                if(hasher::Equals(this->Slots[Index].Key, Key))
+                {
+                    return (i32)Index;
+                }
+                MatchMask &= MatchMask - 1;
+            }
+
+            if(_mm_movemask_epi8(_mm_cmpeq_epi8(Group, Empty)) != 0)
+            {
+                break;
+            }
+            GroupIndex = (GroupIndex + Step) & GroupMask;
+        }
+
+        return -1;
+    }
+
+    // NOTE: First empty or deleted slot on the probe sequence of the hash. There always is one because of the
+    // load factor.
+    u32
+    FindInsertIndex(u64 Hash) const
+    {
+        const u32 GroupMask = (this->Capacity / HASH_MAP_GROUP_WIDTH) - 1;
+        u32 GroupIndex = (u32)H1(Hash) & GroupMask;
+        for(u32 Step = 1;; ++Step)
+        {
+            const i8 *GroupControl = this->Control + GroupIndex * HASH_MAP_GROUP_WIDTH;
+            __m128i Group = _mm_loadu_si128((const __m128i *)GroupControl);
+
+            // NOTE: Empty and deleted are the only control bytes with the top bit set.
+            u32 FreeMask = (u32)_mm_movemask_epi8(Group);
+            if(FreeMask != 0)
+            {
+                return GroupIndex * HASH_MAP_GROUP_WIDTH + HashMapFirstSetBit(FreeMask);
+            }
+
+            ASSERT(Step <= GroupMask + 1);
+            GroupIndex = (GroupIndex + Step) & GroupMask;
+        }
+    }
+
+    void
+    Rehash(u32 NewCapacity)
+    {
+        ASSERT(NewCapacity >= HASH_MAP_GROUP_WIDTH && (NewCapacity & (NewCapacity - 1)) == 0);
+
+        i8 *OldControl = this->Control;
+        slot *OldSlots = this->Slots;
+        u32 OldCapacity = this->Capacity;
+
+        // NOTE: One block, the control bytes first and then the slots.
+        size_t ControlSize = AlignAsPow2(NewCapacity, alignof(slot) > 16 ? alignof(slot) : 16);
+        u8 *Memory = (u8 *)this->Allocator.Allocate(ControlSize + sizeof(slot) * NewCapacity);
+        this->Control = (i8 *)Memory;
+        this->Slots = (slot *)(Memory + ControlSize);
+        this->Capacity = NewCapacity;
+        this->DeletedCount = 0;
+        SHU_MEMSET(this->Control, HASH_MAP_EMPTY, NewCapacity);
+
+        for(u32 i = 0; i < OldCapacity; ++i)
+        {
+            if(OldControl[i] >= 0)
+            {
+                u64 Hash = hasher::Hash(OldSlots[i].Key);
+                u32 Index = FindInsertIndex(Hash);
+                this->Control[Index] = H2(Hash);
+                this->Slots[Index] = OldSlots[i];
+            }
+        }
+
+        if(OldControl != nullptr)
+        {
+            this->Allocator.Free(OldControl);
+        }
+    }
+};
+
+#if _SHU_DEBUG
+// NOTE: Inserts, hit and miss lookups and removes with integer keys, against htable and std::unordered_map.
+void hash_map_benchmark();
+void hash_map_test();
+#endif
+
+#define HASH_MAP_H
+#endif // HASH_MAP_H
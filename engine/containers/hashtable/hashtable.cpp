@@ -193,7 +193,7 @@ HashTableRehash(htable *HashTable)
 
 
 // Create a new hashtable.
-static htable *
+htable *
 HashTableCreate(htable_hash HashFunc, htable_key_equals KeyEqualityFunc, htable_callbacks *Callbacks)
 {
     htable *HashTable;
@@ -229,7 +229,7 @@ HashTableCreate(htable_hash HashFunc, htable_key_equals KeyEqualityFunc, htable_
     return HashTable;
 }
 
-static void
+void
 HashTableDestroy(htable *HashTable)
 {
     htable_bucket *Next;
@@ -265,7 +265,7 @@ HashTableDestroy(htable *HashTable)
     free(HashTable);
 }
 
-static void
+void
 HashTableInsert(htable *HashTable, void *Key, void *Value)
 {
     void *CKey;
@@ -345,7 +345,7 @@ HashTableRemove(htable *HashTable, void *Key)
 }
 
 // NOTE: Get the Value out of the hashtable for the given Key.
-static b32
+b32
 HashTableGet(htable *HashTable, void *Key, void **Value)
 {
     htable_bucket *Current;
@@ -379,7 +379,7 @@ HashTableGet(htable *HashTable, void *Key, void **Value)
     return false;
 }
 
-static void *
+void *
 HashTableGetDirect(htable *HashTable, void *Key)
 {
     void *Value = nullptr;
@@ -390,7 +390,7 @@ HashTableGetDirect(htable *HashTable, void *Key)
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // NOTE: Enumerate the HashTable
-static htable_enum *
+htable_enum *
 HashTableEnumCreate(htable *HashTable)
 {
     htable_enum *HashTableEnum;
@@ -404,7 +404,7 @@ HashTableEnumCreate(htable *HashTable)
     return HashTableEnum;
 }
 
-static b32
+b32
 HashTableEnumNext(htable_enum *HashEnum, void **Key, void **Value)
 {
     void *MyKey = nullptr;
@@ -448,7 +448,7 @@ HashTableEnumNext(htable_enum *HashEnum, void **Key, void **Value)
     return true;
 }
 
-static void
+void
 HashTableEnumDestroy(htable_enum *HashEnum)
 {
     if (HashEnum == nullptr)
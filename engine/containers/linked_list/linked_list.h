@@ -38,4 +38,7 @@ struct singly_linked_list
     void Clear();
 };
 
-#include "linked_list_impl.h"
\ No newline at end of file
+#include "linked_list_impl.h"
+
+// NOTE: Only a shorthand for the declarations above, it must not leak into the files that include this.
+#undef node
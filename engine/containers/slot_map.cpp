@@ -0,0 +1,77 @@
+#include "slot_map.h"
+
+#if _SHU_DEBUG
+#include <utils/random/random.h>
+
+// NOTE: Random adds and removes, checked against a plain array of the handles that should still be alive.
+void
+slot_map_test()
+{
+    size_t HeapSize = MEGABYTES(4);
+    void *Memory = malloc(HeapSize);
+    freelist_allocator Allocator;
+    Allocator.Initialize(Memory, HeapSize, 0, FREELIST_DEFAULT_POLICY);
+
+    {
+        shoora_slot_map<i32> Map;
+        Map.SetAllocator(&Allocator);
+
+        const i32 MaxAlive = 512;
+        slot_handle Alive[MaxAlive];
+        i32 Values[MaxAlive];
+        i32 AliveCount = 0;
+        slot_handle Dead[64];
+        i32 DeadCount = 0;
+
+        shoora_random Random(0x51071234);
+        for(i32 Iteration = 0; Iteration < 100000; ++Iteration)
+        {
+            if(AliveCount < MaxAlive && (AliveCount == 0 || Random.Between(0u, 100u) < 55))
+            {
+                i32 Value = Iteration;
+                Alive[AliveCount] = Map.Add(Value);
+                Values[AliveCount++] = Value;
+            }
+            else
+            {
+                // NOTE: Between can return the max.
+                i32 Index = MIN((i32)Random.Between(0u, (u32)AliveCount), AliveCount - 1);
+                b32 Removed = Map.Remove(Alive[Index]);
+                b32 RemovedAgain = Map.Remove(Alive[Index]);
+                ASSERT(Removed && !RemovedAgain);
+                Dead[DeadCount++ % ARRAY_SIZE(Dead)] = Alive[Index];
+
+                --AliveCount;
+                Alive[Index] = Alive[AliveCount];
+                Values[Index] = Values[AliveCount];
+            }
+
+            if((Iteration % 97) == 0)
+            {
+                ASSERT(Map.size() == AliveCount);
+                for(i32 i = 0; i < AliveCount; ++i)
+                {
+                    i32 *Value = Map.Get(Alive[i]);
+                    ASSERT(Value != nullptr && *Value == Values[i]);
+                    ASSERT(Map.GetHandle(Map.GetDenseIndex(Alive[i])) == Alive[i]);
+                }
+                for(i32 i = 0; i < MIN(DeadCount, ARRAY_SIZE(Dead)); ++i)
+                {
+                    ASSERT(!Map.IsValid(Dead[i]));
+                }
+            }
+        }
+
+        ASSERT(!Map.IsValid(slot_handle{}));
+        Map.Clear();
+        ASSERT(Map.size() == 0);
+        for(i32 i = 0; i < AliveCount; ++i)
+        {
+            ASSERT(Map.Get(Alive[i]) == nullptr);
+        }
+    }
+
+    free(Memory);
+    LogInfoUnformatted("[Slot Map Test]: Passed.\n");
+}
+#endif
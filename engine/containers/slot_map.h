@@ -0,0 +1,195 @@
+#if !defined(SLOT_MAP_H)
+
+#include <defines.h>
+#include "dynamic_array.h"
+
+// NOTE: A handle is the slot index in the low bits and the generation of the slot in the high bits. The generation
+// goes up every time the slot is freed, so a handle to something that has been removed never matches again(until
+// the generation wraps around after 4096 reuses of the same slot). Generations start at 1, so a zero handle is never
+// valid.
+#define SLOT_HANDLE_INDEX_BITS 20
+#define SLOT_HANDLE_GENERATION_BITS 12
+#define SLOT_HANDLE_INDEX_MASK ((1u << SLOT_HANDLE_INDEX_BITS) - 1)
+#define SLOT_HANDLE_GENERATION_MASK ((1u << SLOT_HANDLE_GENERATION_BITS) - 1)
+#define SLOT_MAP_MAX_COUNT (1 << SLOT_HANDLE_INDEX_BITS)
+#define SLOT_MAP_INVALID_INDEX 0xFFFFFFFFu
+
+struct slot_handle
+{
+    u32 Value = 0;
+
+    inline u32 Index() const { return this->Value & SLOT_HANDLE_INDEX_MASK; }
+    inline u32 Generation() const { return this->Value >> SLOT_HANDLE_INDEX_BITS; }
+    inline b32 IsNull() const { return this->Value == 0; }
+
+    inline bool operator==(const slot_handle &Rhs) const { return this->Value == Rhs.Value; }
+    inline bool operator!=(const slot_handle &Rhs) const { return this->Value != Rhs.Value; }
+};
+
+// NOTE: When the slot is in use DenseIndex is where its item lives, otherwise it is the next slot in the free list.
+struct slot_map_slot
+{
+    u32 DenseIndex;
+    u32 Generation;
+};
+
+// NOTE: Items are kept packed in one array with no holes, so looping over all of them is the same as looping over a
+// shoora_dynamic_array. Handles go through the slot array to find the item, so they stay valid when the items move.
+// Remove moves the last item into the hole, so Add/Remove/Get are all O(1), but the item order is not kept and
+// pointers to the last item are not valid after a Remove.
+template <typename T>
+struct shoora_slot_map
+{
+  private:
+    shoora_dynamic_array<T> Dense;
+    // NOTE: Slot of every item in Dense, to fix up the slot of the item which gets moved by Remove.
+    shoora_dynamic_array<u32> DenseToSlot;
+    shoora_dynamic_array<slot_map_slot> Slots;
+    u32 FreeSlotHead = SLOT_MAP_INVALID_INDEX;
+
+  public:
+    void
+    SetAllocator(shoora_memory_type Type)
+    {
+        this->Dense.SetAllocator(Type);
+        this->DenseToSlot.SetAllocator(Type);
+        this->Slots.SetAllocator(Type);
+    }
+
+    void
+    SetAllocator(freelist_allocator *Allocator)
+    {
+        this->Dense.SetAllocator(Allocator);
+        this->DenseToSlot.SetAllocator(Allocator);
+        this->Slots.SetAllocator(Allocator);
+    }
+
+    inline void
+    reserve(i32 Capacity)
+    {
+        this->Dense.reserve(Capacity);
+        this->DenseToSlot.reserve(Capacity);
+        this->Slots.reserve(Capacity);
+    }
+
+    template <typename... Args>
+    slot_handle
+    Emplace(Args &&...args)
+    {
+        u32 SlotIndex = this->FreeSlotHead;
+        if(SlotIndex != SLOT_MAP_INVALID_INDEX)
+        {
+            this->FreeSlotHead = this->Slots[SlotIndex].DenseIndex;
+        }
+        else
+        {
+            ASSERT(this->Slots.size() < SLOT_MAP_MAX_COUNT);
+            SlotIndex = (u32)this->Slots.size();
+            this->Slots.push_back(slot_map_slot{0, 1});
+        }
+
+        slot_map_slot &Slot = this->Slots[SlotIndex];
+        Slot.DenseIndex = (u32)this->Dense.size();
+        this->Dense.emplace_back(std::forward<Args>(args)...);
+        this->DenseToSlot.push_back(SlotIndex);
+
+        slot_handle Result;
+        Result.Value = (Slot.Generation << SLOT_HANDLE_INDEX_BITS) | SlotIndex;
+        return Result;
+    }
+
+    inline slot_handle Add(const T &Item) { return Emplace(Item); }
+    inline slot_handle Add(T &&Item) { return Emplace(std::move(Item)); }
+
+    // NOTE: -1 if the handle is not valid anymore.
+    inline i32
+    GetDenseIndex(slot_handle Handle) const
+    {
+        u32 SlotIndex = Handle.Index();
+        if(SlotIndex >= (u32)this->Slots.size())
+        {
+            return -1;
+        }
+
+        const slot_map_slot &Slot = this->Slots[SlotIndex];
+        i32 Result = (Slot.Generation == Handle.Generation()) ? (i32)Slot.DenseIndex : -1;
+        return Result;
+    }
+
+    inline b32 IsValid(slot_handle Handle) const { return GetDenseIndex(Handle) >= 0; }
+
+    inline T *
+    Get(slot_handle Handle) const
+    {
+        i32 DenseIndex = GetDenseIndex(Handle);
+        T *Result = (DenseIndex >= 0) ? (this->Dense.data() + DenseIndex) : nullptr;
+        return Result;
+    }
+
+    inline slot_handle
+    GetHandle(i32 DenseIndex) const
+    {
+        ASSERT(DenseIndex >= 0 && DenseIndex < this->Dense.size());
+
+        u32 SlotIndex = this->DenseToSlot[DenseIndex];
+        slot_handle Result;
+        Result.Value = (this->Slots[SlotIndex].Generation << SLOT_HANDLE_INDEX_BITS) | SlotIndex;
+        return Result;
+    }
+
+    // NOTE: Returns false if the handle was not valid. The last item takes the place of the removed one.
+    b32
+    Remove(slot_handle Handle)
+    {
+        i32 DenseIndex = GetDenseIndex(Handle);
+        if(DenseIndex < 0)
+        {
+            return false;
+        }
+
+        u32 SlotIndex = Handle.Index();
+        i32 LastIndex = this->Dense.size() - 1;
+        if(DenseIndex != LastIndex)
+        {
+            u32 MovedSlotIndex = this->DenseToSlot[LastIndex];
+            this->Slots[MovedSlotIndex].DenseIndex = (u32)DenseIndex;
+            this->DenseToSlot[DenseIndex] = MovedSlotIndex;
+        }
+        this->Dense.swap_erase(DenseIndex);
+        this->DenseToSlot.swap_erase(DenseIndex);
+
+        slot_map_slot &Slot = this->Slots[SlotIndex];
+        Slot.Generation = (Slot.Generation + 1) & SLOT_HANDLE_GENERATION_MASK;
+        if(Slot.Generation == 0)
+        {
+            Slot.Generation = 1;
+        }
+        Slot.DenseIndex = this->FreeSlotHead;
+        this->FreeSlotHead = SlotIndex;
+
+        return true;
+    }
+
+    // NOTE: Removes everything. All the handles handed out so far become invalid.
+    void
+    Clear()
+    {
+        for(i32 DenseIndex = this->Dense.size() - 1; DenseIndex >= 0; --DenseIndex)
+        {
+            Remove(GetHandle(DenseIndex));
+        }
+    }
+
+    // NOTE: Dense access, for looping over all the items.
+    inline i32 size() const { return this->Dense.size(); }
+    inline T *data() const { return this->Dense.data(); }
+    inline T &operator[](i32 DenseIndex) const { return this->Dense[DenseIndex]; }
+    inline T *get(i32 DenseIndex) { return this->Dense.get(DenseIndex); }
+};
+
+#if _SHU_DEBUG
+void slot_map_test();
+#endif
+
+#define SLOT_MAP_H
+#endif // SLOT_MAP_H
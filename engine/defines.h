@@ -48,7 +48,8 @@ typedef double f64;
 #define SHU_UINT_MIN 0UL
 
 #define USE_CPP_ATOMIC 0
-#if USE_CPP_ATOMIC
+// NOTE: intrin.h and the barrier intrinsics are MSVC only, the other compilers always use the C++ fences.
+#if USE_CPP_ATOMIC || !defined(_MSC_VER)
 #include <atomic>
 // NOTE: This is to stop the compiler from rearranging stuff for optimization. Since this is multithreaded
 // code, we have to do this! This prevents any writes that are below it to be moved above it by the compiler during
@@ -63,6 +64,28 @@ typedef double f64;
 #define CompletePastReadsBeforeFutureReads _ReadBarrier()
 #endif
 
+#if !defined(_MSC_VER)
+// NOTE: What intrin.h and malloc.h give MSVC.
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include <alloca.h>
+#define _alloca alloca
+#endif
+
+// NOTE: Sets *Dest to New if it is equal to Expected. Returns the value *Dest had before, so the exchange happened
+// if the return value is Expected.
+inline u32
+AtomicCompareExchangeU32(u32 volatile *Dest, u32 New, u32 Expected)
+{
+#if defined(_MSC_VER)
+    u32 Result = (u32)_InterlockedCompareExchange((long volatile *)Dest, (long)New, (long)Expected);
+#else
+    u32 Result = __sync_val_compare_and_swap(Dest, Expected, New);
+#endif
+    return Result;
+}
+
 #ifdef _MSC_VER
 #define SHU_ALIGN_16 __declspec(align(16))
 #include <cfloat>
@@ -79,12 +102,27 @@ typedef double f64;
     #define _SHU_RELEASE 1
     #define SHU_CRASH_DUMP_ENABLE 1
 #endif
-#elif defined(__clang__)
-#define SHU_FLOAT_MIN -__FLT_MAX__
-#define SHU_FLOAT_MAX __FLT_MAX__
+#else
+// NOTE: GCC and Clang.
 #define SHU_ALIGN_16 __attribute__((aligned(16)))
+#include <cfloat>
+#define SHU_FLOAT_MIN -FLT_MAX
+#define SHU_FLOAT_MAX FLT_MAX
+#define SHU_EPSILON FLT_EPSILON
+#define TEST_STR_FUNCTIONS 0
+// NOTE: The crash dumps are written with DbgHelp, so they are Win32 only.
+#define SHU_CRASH_DUMP_ENABLE 0
+#if _DEBUG
+    #define _SHU_DEBUG 1
 #else
-#define ALIGN_16
+    #define _SHU_RELEASE 1
+#endif
+#endif
+
+#ifdef _MSC_VER
+#define SHU_EXPORT __declspec(dllexport)
+#else
+#define SHU_EXPORT __attribute__((visibility("default")))
 #endif
 
 inline b32
@@ -408,6 +446,10 @@ NearlyEqual(f32 n, f32 expected, f32 epsilon = 2.0f*SHU_EPSILON)
         res = (diff <= maxUlps);                                                                                  \
     }
 
+// NOTE: Declared in platform.h, which includes this file. The template below needs it declared before it for GCC's two
+// phase lookup.
+extern "C" SHU_EXPORT void LogWarnUnformatted(const char *Message);
+
 template<typename T>
 inline b32
 NearlyEqualUlps(T n, T expected, i64 maxUlps = 2)
@@ -513,11 +555,5 @@ struct stack_array
         OutputDebugStringA(TextBuffer);                                                                           \
     }
 
-#ifdef _MSC_VER
-#define SHU_EXPORT __declspec(dllexport)
-#elif defined(__clang__)
-#define SHU_EXPORT __attribute__((visibility("default")))
-#endif
-
 #define DEFINES_H
 #endif // DEFINES_H
\ No newline at end of file
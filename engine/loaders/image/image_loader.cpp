@@ -5,10 +5,9 @@
 // TODO: Define STBI_MALLOC, REALLOC and FREE from freelist_allocator
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
-#else
+#endif
 #include "png_loader.h"
 #include "jpeg_loader.h"
-#endif
 
 shoora_image_mipmap
 GetMipmapLevelData()
@@ -16,47 +15,75 @@ GetMipmapLevelData()
     return {};
 }
 
-// TODO)): Check the filename for png/jpeg format and choose appropriately.
+// NOTE: The format is picked by the file's signature, not its extension. PNGs and JPEGs go through the native decoders,
+// the rest, and the JPEGs the native decoder does not support(CMYK, arithmetic coded, 12 bit), through stb_image. The
+// data is always RGBA.
 shoora_image_data
 LoadImageFile(const char *Filename, b32 FlipImage, u32 MipmapCount, u32 DesiredChannelCount)
 {
     shoora_image_data ImageData = {};
 
-#if SHU_USE_STB
-#if 0
-    stbi_info(Filename, &ImageData.Dim.Width, &ImageData.Dim.Height, &ChannelCount);
-#endif
-    if(FlipImage)
+    platform_mapped_file File = Platform_MapFile(Filename);
+    if(File.Data == nullptr)
     {
-        stbi_set_flip_vertically_on_load(1);
+        LogError("Image file %s could not be opened!\n", Filename);
+        ASSERT(!"Image file could not be opened!");
+        return ImageData;
     }
-    ImageData.Data = stbi_load(Filename, &ImageData.Dim.w, &ImageData.Dim.h, &ImageData.NumChannels,
-                               STBI_rgb_alpha);
 
+    const u8 *FileData = (const u8 *)File.Data;
+    b32 IsPNGFile = IsPNG(FileData, File.Size);
+    b32 IsJPEGFile = IsJPEG(FileData, File.Size);
+    if(IsPNGFile)
+    {
+        ImageData = LoadPNG(FileData, File.Size, FlipImage, 4);
+    }
+    else if(IsJPEGFile)
+    {
+        ImageData = LoadJPEG(FileData, File.Size, FlipImage, 4);
+    }
+
+#if SHU_USE_STB
+    if(ImageData.Data == nullptr && !IsPNGFile)
+    {
+        if(FlipImage)
+        {
+            stbi_set_flip_vertically_on_load(1);
+        }
+        ImageData.Data = stbi_load_from_memory(FileData, (i32)File.Size, &ImageData.Dim.w, &ImageData.Dim.h,
+                                               &ImageData.NumChannels, STBI_rgb_alpha);
+        ImageData.TotalSize = (ImageData.Dim.w)*(ImageData.Dim.h)*(4);
+        ImageData.DecodedByStb = true;
+        if(FlipImage)
+        {
+            stbi_set_flip_vertically_on_load(0);
+        }
+    }
+#else
+    if(!IsPNGFile && !IsJPEGFile)
+    {
+        ASSERT(!"Only PNG and JPEG files can be loaded without stb_image right now!");
+    }
+#endif
+    Platform_UnmapFile(&File);
 
-    // ASSERT(ImageData.NumChannels == 4);
+    if(ImageData.Data == nullptr)
+    {
+        LogError("Image file %s could not be decoded!\n", Filename);
+        ASSERT(!"Image file could not be decoded!");
+    }
 
     if((DesiredChannelCount != 0) &&
        (DesiredChannelCount != ImageData.NumChannels))
     {
         ASSERT(!"Your desired number of channels for this file is not supported!");
     }
-    ImageData.TotalSize = (ImageData.Dim.w)*(ImageData.Dim.h)*(4);
 
     if(MipmapCount > 0)
     {
         ASSERT(!"Mipmaps are not supported right now!\n");
     }
 
-    if(FlipImage)
-    {
-        stbi_set_flip_vertically_on_load(0);
-    }
-#else
-    LoadPNG(Filename);
-#error "custom loaders for file not supported yet!"
-#endif
-
     return ImageData;
 }
 
@@ -66,11 +93,16 @@ FreeImageData(shoora_image_data *ImageData)
     ASSERT((ImageData != nullptr) && (ImageData->Data != nullptr));
 
 #if SHU_USE_STB
-    stbi_image_free(ImageData->Data);
-#else
-    FreePng(ImageData);
-#error "custom image loaders are not implemented yet!"
+    if(ImageData->DecodedByStb)
+    {
+        stbi_image_free(ImageData->Data);
+    }
+    else
 #endif
+    {
+        // NOTE: The native decoders malloc their pixels.
+        free(ImageData->Data);
+    }
     ImageData->Data = nullptr;
     ImageData->Dim.w = 0;
     ImageData->Dim.h = 0;
@@ -23,6 +23,8 @@ struct shoora_image_data
 
     u32 TotalSize;
     u8 *Data;
+    // NOTE: stb_image's pixels go back through stbi_image_free, the native decoders' through free.
+    b32 DecodedByStb;
 };
 
 shoora_image_data LoadImageFile(const char *Filename, b32 FlipImageVertically = true, u32 MipmapCount = 0,
@@ -0,0 +1,682 @@
+#include "inflate.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+// NOTE: The codes are decoded with one table lookup for the codes up to the root bits and a second one into a
+// subtable for the longer ones. The literal/length table is 11 bits, most of a texture's literals are shorter than
+// that, so two literals whose codes fit in the root bits together are decoded by one lookup.
+#define INFLATE_LITLEN_ROOT_BITS 11
+#define INFLATE_DIST_ROOT_BITS 8
+#define INFLATE_CODE_LENGTH_ROOT_BITS 7
+#define INFLATE_MAX_CODE_LENGTH 15
+// NOTE: The root table and the most the subtables can need, every symbol in its own 15 bit subtable.
+#define INFLATE_LITLEN_TABLE_SIZE ((1 << INFLATE_LITLEN_ROOT_BITS) + 288*(1 << (15 - INFLATE_LITLEN_ROOT_BITS)))
+#define INFLATE_DIST_TABLE_SIZE ((1 << INFLATE_DIST_ROOT_BITS) + 32*(1 << (15 - INFLATE_DIST_ROOT_BITS)))
+#define INFLATE_CODE_LENGTH_TABLE_SIZE (1 << INFLATE_CODE_LENGTH_ROOT_BITS)
+// NOTE: The fast loop runs while a whole match and the 8 byte copies past its end fit in the output.
+#define INFLATE_FAST_LOOP_MARGIN (258 + 16)
+
+// NOTE: A table entry is Bits(8) | Kind(4) | Extra(4) | Value(16). Bits is the length of the code, or of both codes
+// for a literal pair. Value is the literal(s), the length/distance base or the subtable's offset, Extra is the count
+// of extra bits after a length/distance code or the bits a subtable is indexed with.
+enum inflate_entry_kind
+{
+    InflateEntry_Invalid,
+    InflateEntry_Literal,
+    InflateEntry_LiteralPair,
+    InflateEntry_Length,
+    InflateEntry_Distance,
+    InflateEntry_EndOfBlock,
+    InflateEntry_SubTable,
+};
+
+#define INFLATE_ENTRY(Bits, Kind, Extra, Value)                                                                   \
+    ((u32)(Bits) | ((u32)(Kind) << 8) | ((u32)(Extra) << 12) | ((u32)(Value) << 16))
+
+static inline u32 EntryBits(u32 Entry) { return Entry & 0xFF; }
+static inline u32 EntryKind(u32 Entry) { return (Entry >> 8) & 0xF; }
+static inline u32 EntryExtra(u32 Entry) { return (Entry >> 12) & 0xF; }
+static inline u32 EntryValue(u32 Entry) { return Entry >> 16; }
+
+static const u16 LengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                   31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const u8 LengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                   2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const u16 DistanceBase[30] = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                     33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                     1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577};
+static const u8 DistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                     6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+static const u8 CodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+enum inflate_table_type
+{
+    InflateTable_CodeLength,
+    InflateTable_LitLen,
+    InflateTable_Distance,
+};
+
+struct inflate_tables
+{
+    u32 LitLen[INFLATE_LITLEN_TABLE_SIZE];
+    u32 Distance[INFLATE_DIST_TABLE_SIZE];
+    u32 CodeLength[INFLATE_CODE_LENGTH_TABLE_SIZE];
+    // NOTE: The literal/length root table before the pairs go in, the pairs are made from the single entries.
+    u32 SingleLitLen[1 << INFLATE_LITLEN_ROOT_BITS];
+};
+
+// NOTE: The bits come in least significant bit first. The refill reads 8 bytes at a time while the current input has
+// them and a byte at a time across the ends of the inputs. Past the last input it feeds zeros and counts them, a
+// stream which used any of them was cut short.
+struct inflate_bit_reader
+{
+    u64 Bits;
+    u32 BitCount;
+    u32 PaddingBytes;
+    const u8 *At;
+    const u8 *End;
+    const inflate_input *NextInput;
+    const inflate_input *LastInput;
+};
+
+static inflate_bit_reader
+RefillSlow(inflate_bit_reader R)
+{
+    while(R.BitCount <= 56)
+    {
+        if(R.At < R.End)
+        {
+            R.Bits |= (u64)(*R.At++) << R.BitCount;
+            R.BitCount += 8;
+        }
+        else if(R.NextInput < R.LastInput)
+        {
+            R.At = R.NextInput->Data;
+            R.End = R.At + R.NextInput->Size;
+            ++R.NextInput;
+        }
+        else
+        {
+            ++R.PaddingBytes;
+            R.BitCount += 8;
+        }
+    }
+
+    return R;
+}
+
+// NOTE: Leaves at least 56 bits in the buffer. The bytes above BitCount from the 8 byte load are the next bytes of
+// the input, so loading them again later ors in the same bits.
+static inline void
+Refill(inflate_bit_reader &R)
+{
+    if(R.End - R.At >= 8)
+    {
+        u64 Next;
+        memcpy(&Next, R.At, sizeof(Next));
+        R.Bits |= Next << R.BitCount;
+        R.At += (63 - R.BitCount) >> 3;
+        R.BitCount |= 56;
+    }
+    else
+    {
+        R = RefillSlow(R);
+    }
+}
+
+static inline void
+Consume(inflate_bit_reader &R, u32 Count)
+{
+    R.Bits >>= Count;
+    R.BitCount -= Count;
+}
+
+static inline u32
+GetBits(inflate_bit_reader &R, u32 Count)
+{
+    u32 Result = (u32)(R.Bits & ((1ull << Count) - 1));
+    Consume(R, Count);
+    return Result;
+}
+
+static inline u32
+DecodeEntry(const u32 *Table, u32 RootBits, u64 Bits)
+{
+    u32 Entry = Table[Bits & ((1u << RootBits) - 1)];
+    if(EntryKind(Entry) == InflateEntry_SubTable)
+    {
+        Entry = Table[EntryValue(Entry) + ((u32)(Bits >> RootBits) & ((1u << EntryExtra(Entry)) - 1))];
+    }
+
+    return Entry;
+}
+
+static inline u32
+ReverseBits(u32 Code, u32 Length)
+{
+    u32 Result = 0;
+    for(u32 Index = 0; Index < Length; ++Index)
+    {
+        Result = (Result << 1) | (Code & 1);
+        Code >>= 1;
+    }
+
+    return Result;
+}
+
+static inline u32
+GetSymbolEntry(inflate_table_type Type, u32 Symbol, u32 Length)
+{
+    u32 Result = INFLATE_ENTRY(Length, InflateEntry_Invalid, 0, 0);
+    if(Type == InflateTable_CodeLength)
+    {
+        Result = INFLATE_ENTRY(Length, InflateEntry_Literal, 0, Symbol);
+    }
+    else if(Type == InflateTable_LitLen)
+    {
+        if(Symbol < 256)
+        {
+            Result = INFLATE_ENTRY(Length, InflateEntry_Literal, 0, Symbol);
+        }
+        else if(Symbol == 256)
+        {
+            Result = INFLATE_ENTRY(Length, InflateEntry_EndOfBlock, 0, 0);
+        }
+        else if(Symbol < 286)
+        {
+            Result = INFLATE_ENTRY(Length, InflateEntry_Length, LengthExtra[Symbol - 257], LengthBase[Symbol - 257]);
+        }
+    }
+    else if(Symbol < 30)
+    {
+        Result = INFLATE_ENTRY(Length, InflateEntry_Distance, DistanceExtra[Symbol], DistanceBase[Symbol]);
+    }
+
+    return Result;
+}
+
+// NOTE: Canonical Huffman codes(RFC 1951 3.2.2) from the code lengths. Over subscribed codes fail, incomplete ones
+// are allowed(a single distance code is) and the entries no code reaches stay invalid.
+static b32
+BuildHuffmanTable(const u8 *Lengths, u32 SymbolCount, inflate_table_type Type, u32 RootBits, u32 *Table,
+                  u32 TableSize)
+{
+    u32 Counts[INFLATE_MAX_CODE_LENGTH + 1] = {};
+    for(u32 Symbol = 0; Symbol < SymbolCount; ++Symbol)
+    {
+        ++Counts[Lengths[Symbol]];
+    }
+    Counts[0] = 0;
+
+    i32 Left = 1;
+    u32 NextCode[INFLATE_MAX_CODE_LENGTH + 1];
+    u32 Code = 0;
+    for(u32 Length = 1; Length <= INFLATE_MAX_CODE_LENGTH; ++Length)
+    {
+        Left = (Left << 1) - (i32)Counts[Length];
+        if(Left < 0)
+        {
+            return false;
+        }
+        Code = (Code + Counts[Length - 1]) << 1;
+        NextCode[Length] = Code;
+    }
+
+    // NOTE: The reversed codes, and the longest code under every root entry to size its subtable.
+    const u32 RootSize = 1u << RootBits;
+    const u32 RootMask = RootSize - 1;
+    u16 Codes[288];
+    u8 SubTableBits[1 << INFLATE_LITLEN_ROOT_BITS];
+    memset(SubTableBits, 0, RootSize);
+    for(u32 Symbol = 0; Symbol < SymbolCount; ++Symbol)
+    {
+        u32 Length = Lengths[Symbol];
+        if(Length > 0)
+        {
+            Codes[Symbol] = (u16)ReverseBits(NextCode[Length]++, Length);
+            if(Length > RootBits)
+            {
+                u8 *SubBits = SubTableBits + (Codes[Symbol] & RootMask);
+                *SubBits = (u8)MAX(*SubBits, Length - RootBits);
+            }
+        }
+    }
+
+    memset(Table, 0, RootSize*sizeof(u32));
+    u32 Used = RootSize;
+    for(u32 Index = 0; Index < RootSize; ++Index)
+    {
+        if(SubTableBits[Index] > 0)
+        {
+            u32 SubTableSize = 1u << SubTableBits[Index];
+            if(Used + SubTableSize > TableSize)
+            {
+                return false;
+            }
+            Table[Index] = INFLATE_ENTRY(0, InflateEntry_SubTable, SubTableBits[Index], Used);
+            memset(Table + Used, 0, SubTableSize*sizeof(u32));
+            Used += SubTableSize;
+        }
+    }
+
+    // NOTE: A code shorter than the table's bits fills every entry whose low bits are the code.
+    for(u32 Symbol = 0; Symbol < SymbolCount; ++Symbol)
+    {
+        u32 Length = Lengths[Symbol];
+        if(Length == 0)
+        {
+            continue;
+        }
+
+        u32 Entry = GetSymbolEntry(Type, Symbol, Length);
+        u32 Reversed = Codes[Symbol];
+        if(Length <= RootBits)
+        {
+            for(u32 Index = Reversed; Index < RootSize; Index += (1u << Length))
+            {
+                Table[Index] = Entry;
+            }
+        }
+        else
+        {
+            u32 SubTable = Table[Reversed & RootMask];
+            u32 *Sub = Table + EntryValue(SubTable);
+            u32 SubSize = 1u << EntryExtra(SubTable);
+            for(u32 Index = Reversed >> RootBits; Index < SubSize; Index += (1u << (Length - RootBits)))
+            {
+                Sub[Index] = Entry;
+            }
+        }
+    }
+
+    return true;
+}
+
+// NOTE: A literal whose code leaves room in the root bits for the whole code of the literal after it becomes a pair.
+// The second code is looked up with only the bits left after the first one, which finds it only when it is not
+// longer than those.
+static void
+AddLiteralPairs(inflate_tables *Tables)
+{
+    const u32 RootSize = 1u << INFLATE_LITLEN_ROOT_BITS;
+    memcpy(Tables->SingleLitLen, Tables->LitLen, sizeof(Tables->SingleLitLen));
+    for(u32 Index = 0; Index < RootSize; ++Index)
+    {
+        u32 First = Tables->SingleLitLen[Index];
+        u32 FirstBits = EntryBits(First);
+        if(EntryKind(First) != InflateEntry_Literal || FirstBits >= INFLATE_LITLEN_ROOT_BITS)
+        {
+            continue;
+        }
+
+        u32 Second = Tables->SingleLitLen[Index >> FirstBits];
+        if(EntryKind(Second) == InflateEntry_Literal && FirstBits + EntryBits(Second) <= INFLATE_LITLEN_ROOT_BITS)
+        {
+            Tables->LitLen[Index] = INFLATE_ENTRY(FirstBits + EntryBits(Second), InflateEntry_LiteralPair, 0,
+                                                  EntryValue(First) | (EntryValue(Second) << 8));
+        }
+    }
+}
+
+static b32
+BuildFixedTables(inflate_tables *Tables)
+{
+    u8 Lengths[288 + 32];
+    memset(Lengths, 8, 144);
+    memset(Lengths + 144, 9, 256 - 144);
+    memset(Lengths + 256, 7, 280 - 256);
+    memset(Lengths + 280, 8, 288 - 280);
+    memset(Lengths + 288, 5, 32);
+
+    b32 Result = BuildHuffmanTable(Lengths, 288, InflateTable_LitLen, INFLATE_LITLEN_ROOT_BITS, Tables->LitLen,
+                                   INFLATE_LITLEN_TABLE_SIZE) &&
+                 BuildHuffmanTable(Lengths + 288, 32, InflateTable_Distance, INFLATE_DIST_ROOT_BITS,
+                                   Tables->Distance, INFLATE_DIST_TABLE_SIZE);
+    if(Result)
+    {
+        AddLiteralPairs(Tables);
+    }
+
+    return Result;
+}
+
+static b32
+ReadDynamicTables(inflate_bit_reader &R, inflate_tables *Tables)
+{
+    Refill(R);
+    u32 LitLenCount = GetBits(R, 5) + 257;
+    u32 DistanceCount = GetBits(R, 5) + 1;
+    u32 CodeLengthCount = GetBits(R, 4) + 4;
+    if(LitLenCount > 286 || DistanceCount > 30)
+    {
+        return false;
+    }
+
+    u8 CodeLengthLengths[19] = {};
+    for(u32 Index = 0; Index < CodeLengthCount; ++Index)
+    {
+        Refill(R);
+        CodeLengthLengths[CodeLengthOrder[Index]] = (u8)GetBits(R, 3);
+    }
+    if(!BuildHuffmanTable(CodeLengthLengths, 19, InflateTable_CodeLength, INFLATE_CODE_LENGTH_ROOT_BITS,
+                          Tables->CodeLength, INFLATE_CODE_LENGTH_TABLE_SIZE))
+    {
+        return false;
+    }
+
+    // NOTE: The literal/length and the distance lengths are one run, a repeat can go from one into the other.
+    u8 Lengths[286 + 30];
+    u32 TotalCount = LitLenCount + DistanceCount;
+    u32 Count = 0;
+    while(Count < TotalCount)
+    {
+        Refill(R);
+        u32 Entry = DecodeEntry(Tables->CodeLength, INFLATE_CODE_LENGTH_ROOT_BITS, R.Bits);
+        if(EntryKind(Entry) != InflateEntry_Literal)
+        {
+            return false;
+        }
+        Consume(R, EntryBits(Entry));
+
+        u32 Symbol = EntryValue(Entry);
+        if(Symbol < 16)
+        {
+            Lengths[Count++] = (u8)Symbol;
+            continue;
+        }
+
+        u32 Repeat;
+        u8 Value = 0;
+        if(Symbol == 16)
+        {
+            if(Count == 0)
+            {
+                return false;
+            }
+            Value = Lengths[Count - 1];
+            Repeat = 3 + GetBits(R, 2);
+        }
+        else if(Symbol == 17)
+        {
+            Repeat = 3 + GetBits(R, 3);
+        }
+        else
+        {
+            Repeat = 11 + GetBits(R, 7);
+        }
+
+        if(Repeat > TotalCount - Count)
+        {
+            return false;
+        }
+        memset(Lengths + Count, Value, Repeat);
+        Count += Repeat;
+    }
+
+    // NOTE: A block has to be able to end.
+    if(Lengths[256] == 0)
+    {
+        return false;
+    }
+
+    b32 Result = BuildHuffmanTable(Lengths, LitLenCount, InflateTable_LitLen, INFLATE_LITLEN_ROOT_BITS,
+                                   Tables->LitLen, INFLATE_LITLEN_TABLE_SIZE) &&
+                 BuildHuffmanTable(Lengths + LitLenCount, DistanceCount, InflateTable_Distance,
+                                   INFLATE_DIST_ROOT_BITS, Tables->Distance, INFLATE_DIST_TABLE_SIZE);
+    if(Result)
+    {
+        AddLiteralPairs(Tables);
+    }
+
+    return Result;
+}
+
+static b32
+CopyStoredBlock(inflate_bit_reader &R, u8 **OutAt, u8 *OutEnd)
+{
+    Consume(R, R.BitCount & 7);
+    Refill(R);
+    u32 Length = GetBits(R, 16);
+    u32 NotLength = GetBits(R, 16);
+    u8 *At = *OutAt;
+    if(Length != (~NotLength & 0xFFFF) || Length > (size_t)(OutEnd - At) || R.BitCount < R.PaddingBytes*8)
+    {
+        return false;
+    }
+
+    // NOTE: The bytes already in the bit buffer first, then straight from the inputs.
+    u32 BufferedBytes = R.BitCount / 8 - R.PaddingBytes;
+    u32 Count = MIN(Length, BufferedBytes);
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        *At++ = (u8)GetBits(R, 8);
+    }
+    Length -= Count;
+
+    if(Length > 0)
+    {
+        ASSERT(R.BitCount == R.PaddingBytes*8);
+        if(R.PaddingBytes > 0)
+        {
+            return false;
+        }
+        R.Bits = 0;
+        R.BitCount = 0;
+        while(Length > 0)
+        {
+            if(R.At == R.End)
+            {
+                if(R.NextInput == R.LastInput)
+                {
+                    return false;
+                }
+                R.At = R.NextInput->Data;
+                R.End = R.At + R.NextInput->Size;
+                ++R.NextInput;
+                continue;
+            }
+
+            u32 Size = MIN(Length, (u32)(R.End - R.At));
+            memcpy(At, R.At, Size);
+            At += Size;
+            R.At += Size;
+            Length -= Size;
+        }
+    }
+
+    *OutAt = At;
+    return true;
+}
+
+// NOTE: Out is the start of the whole output, matches can reach back into the earlier blocks.
+static b32
+DecodeHuffmanBlock(inflate_bit_reader *Reader, const inflate_tables *Tables, u8 *Out, u8 **OutAt, u8 *OutEnd)
+{
+    inflate_bit_reader R = *Reader;
+    u8 *At = *OutAt;
+    const u32 *LitLen = Tables->LitLen;
+    const u32 *Distance = Tables->Distance;
+    b32 Result = false;
+
+    // NOTE: One refill covers the longest length code and distance code with their extra bits, 15 + 5 + 15 + 13.
+    // The match copies go 8 bytes at a time and can write up to 7 bytes past the match, which the margin leaves room
+    // for. The last few hundred bytes go through the checked loop below.
+    while(OutEnd - At >= INFLATE_FAST_LOOP_MARGIN)
+    {
+        Refill(R);
+        u32 Entry = DecodeEntry(LitLen, INFLATE_LITLEN_ROOT_BITS, R.Bits);
+        Consume(R, EntryBits(Entry));
+        u32 Kind = EntryKind(Entry);
+        if(Kind == InflateEntry_LiteralPair)
+        {
+            At[0] = (u8)EntryValue(Entry);
+            At[1] = (u8)(EntryValue(Entry) >> 8);
+            At += 2;
+        }
+        else if(Kind == InflateEntry_Literal)
+        {
+            *At++ = (u8)EntryValue(Entry);
+        }
+        else if(Kind == InflateEntry_Length)
+        {
+            u32 Length = EntryValue(Entry) + GetBits(R, EntryExtra(Entry));
+            u32 DistanceEntry = DecodeEntry(Distance, INFLATE_DIST_ROOT_BITS, R.Bits);
+            if(EntryKind(DistanceEntry) != InflateEntry_Distance)
+            {
+                goto Done;
+            }
+            Consume(R, EntryBits(DistanceEntry));
+            u32 MatchDistance = EntryValue(DistanceEntry) + GetBits(R, EntryExtra(DistanceEntry));
+            if(MatchDistance > (size_t)(At - Out))
+            {
+                goto Done;
+            }
+
+            const u8 *Source = At - MatchDistance;
+            if(MatchDistance >= 8)
+            {
+                u8 *Dest = At;
+                u8 *DestEnd = At + Length;
+                do
+                {
+                    memcpy(Dest, Source, 8);
+                    Dest += 8;
+                    Source += 8;
+                } while(Dest < DestEnd);
+            }
+            else if(MatchDistance == 1)
+            {
+                memset(At, At[-1], Length);
+            }
+            else
+            {
+                for(u32 Index = 0; Index < Length; ++Index)
+                {
+                    At[Index] = Source[Index];
+                }
+            }
+            At += Length;
+        }
+        else
+        {
+            Result = (Kind == InflateEntry_EndOfBlock);
+            goto Done;
+        }
+    }
+
+    for(;;)
+    {
+        Refill(R);
+        u32 Entry = DecodeEntry(LitLen, INFLATE_LITLEN_ROOT_BITS, R.Bits);
+        Consume(R, EntryBits(Entry));
+        u32 Kind = EntryKind(Entry);
+        if(Kind == InflateEntry_LiteralPair)
+        {
+            if(OutEnd - At < 2)
+            {
+                goto Done;
+            }
+            At[0] = (u8)EntryValue(Entry);
+            At[1] = (u8)(EntryValue(Entry) >> 8);
+            At += 2;
+        }
+        else if(Kind == InflateEntry_Literal)
+        {
+            if(At == OutEnd)
+            {
+                goto Done;
+            }
+            *At++ = (u8)EntryValue(Entry);
+        }
+        else if(Kind == InflateEntry_Length)
+        {
+            u32 Length = EntryValue(Entry) + GetBits(R, EntryExtra(Entry));
+            u32 DistanceEntry = DecodeEntry(Distance, INFLATE_DIST_ROOT_BITS, R.Bits);
+            if(EntryKind(DistanceEntry) != InflateEntry_Distance)
+            {
+                goto Done;
+            }
+            Consume(R, EntryBits(DistanceEntry));
+            u32 MatchDistance = EntryValue(DistanceEntry) + GetBits(R, EntryExtra(DistanceEntry));
+            if(MatchDistance > (size_t)(At - Out) || Length > (size_t)(OutEnd - At))
+            {
+                goto Done;
+            }
+
+            const u8 *Source = At - MatchDistance;
+            for(u32 Index = 0; Index < Length; ++Index)
+            {
+                At[Index] = Source[Index];
+            }
+            At += Length;
+        }
+        else
+        {
+            Result = (Kind == InflateEntry_EndOfBlock);
+            goto Done;
+        }
+    }
+
+Done:
+    *Reader = R;
+    *OutAt = At;
+    return Result;
+}
+
+b32
+ZlibInflate(const inflate_input *Inputs, u32 InputCount, u8 *Out, size_t OutSize, size_t *OutWritten)
+{
+    *OutWritten = 0;
+
+    inflate_bit_reader R = {};
+    R.NextInput = Inputs;
+    R.LastInput = Inputs + InputCount;
+    Refill(R);
+
+    // NOTE: RFC 1950 2.2. Deflate with a window of at most 32KB and no preset dictionary.
+    u32 CMF = GetBits(R, 8);
+    u32 FLG = GetBits(R, 8);
+    if((CMF & 0xF) != 8 || (CMF >> 4) > 7 || ((CMF << 8) | FLG) % 31 != 0 || (FLG & 0x20) != 0 ||
+       R.PaddingBytes > 0)
+    {
+        return false;
+    }
+
+    inflate_tables *Tables = (inflate_tables *)malloc(sizeof(inflate_tables));
+    if(Tables == nullptr)
+    {
+        return false;
+    }
+
+    u8 *At = Out;
+    u8 *OutEnd = Out + OutSize;
+    b32 Result = true;
+    b32 FinalBlock = false;
+    while(Result && !FinalBlock)
+    {
+        Refill(R);
+        FinalBlock = GetBits(R, 1);
+        u32 BlockType = GetBits(R, 2);
+        switch(BlockType)
+        {
+            case 0: { Result = CopyStoredBlock(R, &At, OutEnd); } break;
+            case 1: { Result = BuildFixedTables(Tables) && DecodeHuffmanBlock(&R, Tables, Out, &At, OutEnd); } break;
+            case 2:
+            {
+                Result = ReadDynamicTables(R, Tables) && DecodeHuffmanBlock(&R, Tables, Out, &At, OutEnd);
+            } break;
+            default: { Result = false; } break;
+        }
+
+        // NOTE: The stream went past the end of the last input.
+        if(R.BitCount < R.PaddingBytes*8)
+        {
+            Result = false;
+        }
+    }
+
+    free(Tables);
+    *OutWritten = (size_t)(At - Out);
+    return Result;
+}
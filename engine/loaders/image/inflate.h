@@ -0,0 +1,20 @@
+#if !defined(INFLATE_H)
+
+#include <defines.h>
+
+// NOTE: A zlib(RFC 1950) stream of DEFLATE(RFC 1951) blocks which is split over several buffers, the way PNG splits
+// it over its IDAT chunks. The decoder reads straight out of the buffers, they are never joined.
+struct inflate_input
+{
+    const u8 *Data;
+    u32 Size;
+};
+
+// NOTE: Decompresses the stream into Out. It fails if the stream is broken, if it ends before its last block or if
+// it does not fit in OutSize. *OutWritten is how much it wrote. The Adler-32 at the end is not checked(stb_image does
+// not either), broken data almost always trips the code or the size checks and the checksum is another pass over the
+// output.
+b32 ZlibInflate(const inflate_input *Inputs, u32 InputCount, u8 *Out, size_t OutSize, size_t *OutWritten);
+
+#define INFLATE_H
+#endif // INFLATE_H
@@ -1,4 +1,1721 @@
 #include "jpeg_loader.h"
+#include "platform/job_system.h"
+
+#include <emmintrin.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if _SHU_DEBUG && SHU_USE_STB
+#include <stb_image.h>
+#endif
+
+// NOTE: From https://www.w3.org/Graphics/JPEG/itu-t81.pdf(ITU T.81), Table B.1.
+enum jpeg_marker
+{
+    JPEGMarker_SOF0 = 0xC0,
+    JPEGMarker_SOF1 = 0xC1,
+    JPEGMarker_SOF2 = 0xC2,
+    JPEGMarker_DHT = 0xC4,
+    JPEGMarker_DAC = 0xCC,
+    JPEGMarker_RST0 = 0xD0,
+    JPEGMarker_RST7 = 0xD7,
+    JPEGMarker_SOI = 0xD8,
+    JPEGMarker_EOI = 0xD9,
+    JPEGMarker_SOS = 0xDA,
+    JPEGMarker_DQT = 0xDB,
+    JPEGMarker_DRI = 0xDD,
+    JPEGMarker_APP14 = 0xEE,
+    JPEGMarker_TEM = 0x01,
+};
+
+#define JPEG_MAX_COMPONENTS 3
+// NOTE: Codes up to this long are looked up in one go, the longer ones are searched for.
+#define JPEG_FAST_BITS 10
+
+// NOTE: The coefficients are stored zig-zag ordered in the file, this is where each one goes in the 8x8 block.
+static const u8 JPEGNaturalOrder[64] =
+{
+     0,  1,  8, 16,  9,  2,  3, 10,
+    17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34,
+    27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36,
+    29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46,
+    53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+struct jpeg_huffman
+{
+    // NOTE: Indexed by the next JPEG_FAST_BITS bits, (code length << 8) | symbol for the codes which fit, 0 for the
+    // longer ones.
+    u16 Fast[1 << JPEG_FAST_BITS];
+    // NOTE: AC tables only. (coefficient << 8) | (run << 4) | (code length + size) for the codes whose extra bits fit
+    // in JPEG_FAST_BITS too and whose coefficient fits in a byte, so most coefficients take one lookup.
+    i16 FastAC[1 << JPEG_FAST_BITS];
+    // NOTE: The first code after the codes of each length, left justified to 16 bits. MaxCode[17] ends the search.
+    u32 MaxCode[18];
+    // NOTE: Added to a code of each length to get its symbol's index.
+    i32 ValueOffset[17];
+    u8 Symbols[256];
+    b32 Defined;
+};
+
+struct jpeg_component
+{
+    u32 Id;
+    u32 H;
+    u32 V;
+    u32 QuantIndex;
+    // NOTE: The size of the component in samples, and in blocks padded out to whole MCUs.
+    u32 Width;
+    u32 Height;
+    u32 BlocksPerLine;
+    u32 BlocksPerColumn;
+    // NOTE: The tables of the current scan.
+    u32 DCTable;
+    u32 ACTable;
+    // NOTE: The decoded samples, BlocksPerLine*8 bytes a row. A progressive image keeps the quantized coefficients of
+    // every block, 64 per block in natural order, until the last scan.
+    u8 *Plane;
+    i16 *Coefs;
+};
+
+struct jpeg_scan
+{
+    u32 ComponentCount;
+    jpeg_component *Components[JPEG_MAX_COMPONENTS];
+    u32 SpectralStart;
+    u32 SpectralEnd;
+    u32 ApproxHigh;
+    u32 ApproxLow;
+    // NOTE: In a scan of one component an MCU is a single block and the lines are as long as the component.
+    u32 MCUsPerLine;
+    u32 MCUCount;
+};
+
+// NOTE: The entropy coded data between two restart markers. Nothing carries over from one to the next, which is what
+// lets them be decoded in parallel.
+struct jpeg_segment
+{
+    const u8 *Start;
+    const u8 *End;
+};
+
+struct jpeg_decoder
+{
+    jpeg_image_info Info;
+    const u8 *Data;
+    size_t Size;
+    size_t At;
+
+    b32 FrameRead;
+    u32 ScanCount;
+    u32 ComponentCount;
+    jpeg_component Components[JPEG_MAX_COMPONENTS];
+    u32 HMax;
+    u32 VMax;
+    u32 MCUsPerLine;
+    u32 MCUsPerColumn;
+    // NOTE: -1 without an Adobe APP14 marker, 0 for RGB, 1 for YCbCr.
+    i32 AdobeTransform;
+
+    // NOTE: In natural order.
+    u16 Quant[4][64];
+    b32 QuantDefined[4];
+    jpeg_huffman DC[4];
+    jpeg_huffman AC[4];
+};
+
+// NOTE: Reads MSB first. The next bit is the top bit of Bits, the stuffed zero after every FF in the data is skipped
+// and the reader feeds zeros once it gets to a marker or the end of its segment.
+struct jpeg_bit_reader
+{
+    u64 Bits;
+    u32 BitCount;
+    const u8 *At;
+    const u8 *End;
+};
+
+static inline u16
+ReadU16BE(const u8 *At)
+{
+    u16 Result = (u16)((At[0] << 8) | At[1]);
+    return Result;
+}
+
+static inline u64
+ByteSwap64(u64 Value)
+{
+#if defined(_MSC_VER)
+    return _byteswap_uint64(Value);
+#else
+    return __builtin_bswap64(Value);
+#endif
+}
+
+b32
+IsJPEG(const u8 *Data, size_t Size)
+{
+    b32 Result = (Size >= 3) && (Data[0] == 0xFF) && (Data[1] == JPEGMarker_SOI) && (Data[2] == 0xFF);
+    return Result;
+}
+
+static void
+JPEGRefill(jpeg_bit_reader *Reader)
+{
+    // NOTE: Eight bytes at a time when none of them is an FF. The bytes which do not fit are ORed in again by the next
+    // refill at the same place, so the whole word can be ORed in.
+    if(Reader->End - Reader->At >= 8)
+    {
+        u64 Word;
+        memcpy(&Word, Reader->At, 8);
+        if(((~Word - 0x0101010101010101ull) & Word & 0x8080808080808080ull) == 0)
+        {
+            Reader->Bits |= ByteSwap64(Word) >> Reader->BitCount;
+            Reader->At += (63 - Reader->BitCount) >> 3;
+            Reader->BitCount |= 56;
+            return;
+        }
+    }
+
+    while(Reader->BitCount <= 56)
+    {
+        u32 Byte = 0;
+        if(Reader->At < Reader->End)
+        {
+            Byte = *Reader->At++;
+            if(Byte == 0xFF)
+            {
+                if((Reader->At < Reader->End) && (*Reader->At == 0))
+                {
+                    ++Reader->At;
+                }
+                else
+                {
+                    // NOTE: A marker, or the fill bytes in front of one. The segment ends here.
+                    Reader->End = Reader->At - 1;
+                    Reader->At = Reader->End;
+                    Byte = 0;
+                }
+            }
+        }
+        Reader->Bits |= (u64)Byte << (56 - Reader->BitCount);
+        Reader->BitCount += 8;
+    }
+}
+
+static inline void
+ConsumeBits(jpeg_bit_reader *Reader, u32 Count)
+{
+    Reader->Bits <<= Count;
+    Reader->BitCount -= Count;
+}
+
+// NOTE: Count is 1 to 16, the caller makes sure there are enough bits.
+static inline u32
+ReadBits(jpeg_bit_reader *Reader, u32 Count)
+{
+    u32 Result = (u32)(Reader->Bits >> (64 - Count));
+    ConsumeBits(Reader, Count);
+    return Result;
+}
+
+// NOTE: A Count bit coefficient, the ones with a 0 top bit are the negative ones(T.81 F.2.2.1).
+static inline i32
+ReadExtendedBits(jpeg_bit_reader *Reader, u32 Count)
+{
+    i32 Result = (i32)ReadBits(Reader, Count);
+    if(Result < (1 << (Count - 1)))
+    {
+        Result -= (1 << Count) - 1;
+    }
+    return Result;
+}
+
+static inline u32
+ReadBit(jpeg_bit_reader *Reader)
+{
+    if(Reader->BitCount < 16)
+    {
+        JPEGRefill(Reader);
+    }
+    u32 Result = (u32)(Reader->Bits >> 63);
+    ConsumeBits(Reader, 1);
+    return Result;
+}
+
+// NOTE: The symbol, or -1 for a code which is not in the table. There have to be 16 bits in the reader.
+static inline i32
+DecodeHuffman(jpeg_bit_reader *Reader, const jpeg_huffman *Table)
+{
+    u32 Fast = Table->Fast[Reader->Bits >> (64 - JPEG_FAST_BITS)];
+    if(Fast)
+    {
+        ConsumeBits(Reader, Fast >> 8);
+        return (i32)(Fast & 0xFF);
+    }
+
+    u32 Code = (u32)(Reader->Bits >> 48);
+    u32 Length = JPEG_FAST_BITS + 1;
+    while(Code >= Table->MaxCode[Length])
+    {
+        ++Length;
+    }
+    if(Length > 16)
+    {
+        return -1;
+    }
+
+    ConsumeBits(Reader, Length);
+    i32 Result = Table->Symbols[(i32)(Code >> (16 - Length)) + Table->ValueOffset[Length]];
+    return Result;
+}
+
+// NOTE: Builds the canonical code of T.81 Annex C out of the code counts of each length.
+static b32
+BuildHuffman(jpeg_huffman *Table, const u8 *Counts, const u8 *Symbols, u32 SymbolCount, b32 IsAC)
+{
+    memset(Table->Fast, 0, sizeof(Table->Fast));
+    memset(Table->FastAC, 0, sizeof(Table->FastAC));
+    memcpy(Table->Symbols, Symbols, SymbolCount);
+
+    u32 Code = 0;
+    u32 Index = 0;
+    for(u32 Length = 1; Length <= 16; ++Length)
+    {
+        Table->ValueOffset[Length] = (i32)Index - (i32)Code;
+        // NOTE: A length cannot have more codes than it has bits for, the fast table fill below would run past the
+        // end of the table.
+        if(Code + Counts[Length - 1] > (1u << Length))
+        {
+            return false;
+        }
+        for(u32 Count = 0; Count < Counts[Length - 1]; ++Count)
+        {
+            if(Length <= JPEG_FAST_BITS)
+            {
+                u32 First = Code << (JPEG_FAST_BITS - Length);
+                u32 FillCount = 1u << (JPEG_FAST_BITS - Length);
+                for(u32 Fill = 0; Fill < FillCount; ++Fill)
+                {
+                    Table->Fast[First + Fill] = (u16)((Length << 8) | Symbols[Index]);
+                }
+            }
+            ++Code;
+            ++Index;
+        }
+
+        Table->MaxCode[Length] = Code << (16 - Length);
+        Code <<= 1;
+    }
+    Table->MaxCode[17] = 0xFFFFFFFF;
+
+    if(IsAC)
+    {
+        for(u32 Peek = 0; Peek < (1u << JPEG_FAST_BITS); ++Peek)
+        {
+            u32 Fast = Table->Fast[Peek];
+            u32 Length = Fast >> 8;
+            u32 Run = (Fast >> 4) & 15;
+            u32 Size = Fast & 15;
+            if((Fast == 0) || (Size == 0) || (Length + Size > JPEG_FAST_BITS))
+            {
+                continue;
+            }
+
+            i32 Value = (i32)((Peek << Length) & ((1u << JPEG_FAST_BITS) - 1)) >> (JPEG_FAST_BITS - Size);
+            if(Value < (1 << (Size - 1)))
+            {
+                Value -= (1 << Size) - 1;
+            }
+            if((Value >= -128) && (Value <= 127))
+            {
+                Table->FastAC[Peek] = (i16)(Value*256 + (i32)(Run << 4) + (i32)(Length + Size));
+            }
+        }
+    }
+
+    Table->Defined = true;
+    return true;
+}
+
+//
+// NOTE: Inverse DCT
+//
+// The accurate integer IDCT of libjpeg(jidctint.c) with the rotations done as pairs of 16 bit multiplies by
+// _mm_madd_epi16, the way stb_image's SSE2 IDCT does it. Both passes work on 8 columns at once and the block is
+// transposed between them. The constants have 12 fractional bits and the first pass keeps 2 more bits than it
+// needs, so everything fits in 16 bits between the passes.
+//
+
+#define JPEG_IDCT_CONST_BITS 12
+#define JPEG_IDCT_PASS1_BITS 2
+#define JPEG_IDCT_FIX(x) ((i16)((x)*(1 << JPEG_IDCT_CONST_BITS) + (((x) < 0) ? -0.5 : 0.5)))
+
+struct jpeg_idct_wide
+{
+    __m128i Low;
+    __m128i High;
+};
+
+// NOTE: X*C0 + Y*C1 as eight 32 bit sums.
+static inline jpeg_idct_wide
+IDCTRotate(__m128i X, __m128i Y, i16 C0, i16 C1)
+{
+    __m128i Constants = _mm_setr_epi16(C0, C1, C0, C1, C0, C1, C0, C1);
+    jpeg_idct_wide Result;
+    Result.Low = _mm_madd_epi16(_mm_unpacklo_epi16(X, Y), Constants);
+    Result.High = _mm_madd_epi16(_mm_unpackhi_epi16(X, Y), Constants);
+    return Result;
+}
+
+// NOTE: X << CONST_BITS as eight 32 bit values, plus the bias.
+static inline jpeg_idct_wide
+IDCTWiden(__m128i X, __m128i Bias)
+{
+    jpeg_idct_wide Result;
+    Result.Low = _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), X),
+                                              16 - JPEG_IDCT_CONST_BITS), Bias);
+    Result.High = _mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), X),
+                                               16 - JPEG_IDCT_CONST_BITS), Bias);
+    return Result;
+}
+
+static inline jpeg_idct_wide
+IDCTAdd(jpeg_idct_wide A, jpeg_idct_wide B)
+{
+    jpeg_idct_wide Result = {_mm_add_epi32(A.Low, B.Low), _mm_add_epi32(A.High, B.High)};
+    return Result;
+}
+
+static inline jpeg_idct_wide
+IDCTSub(jpeg_idct_wide A, jpeg_idct_wide B)
+{
+    jpeg_idct_wide Result = {_mm_sub_epi32(A.Low, B.Low), _mm_sub_epi32(A.High, B.High)};
+    return Result;
+}
+
+template <i32 Shift>
+static inline __m128i
+IDCTDescale(jpeg_idct_wide A)
+{
+    __m128i Result = _mm_packs_epi32(_mm_srai_epi32(A.Low, Shift), _mm_srai_epi32(A.High, Shift));
+    return Result;
+}
+
+// NOTE: One dimensional IDCTs of the 8 columns of Rows. Bias is added once to the even part so it reaches every
+// output, it does the rounding and in the second pass the +128 level shift.
+template <i32 Shift>
+static inline void
+IDCTPass(__m128i *Rows, __m128i Bias)
+{
+    // NOTE: The even part.
+    jpeg_idct_wide Tmp3 = IDCTRotate(Rows[2], Rows[6], JPEG_IDCT_FIX(0.541196100 + 0.765366865),
+                                     JPEG_IDCT_FIX(0.541196100));
+    jpeg_idct_wide Tmp2 = IDCTRotate(Rows[2], Rows[6], JPEG_IDCT_FIX(0.541196100),
+                                     JPEG_IDCT_FIX(0.541196100 - 1.847759065));
+    jpeg_idct_wide Tmp0 = IDCTWiden(_mm_add_epi16(Rows[0], Rows[4]), Bias);
+    jpeg_idct_wide Tmp1 = IDCTWiden(_mm_sub_epi16(Rows[0], Rows[4]), Bias);
+    jpeg_idct_wide Tmp10 = IDCTAdd(Tmp0, Tmp3);
+    jpeg_idct_wide Tmp13 = IDCTSub(Tmp0, Tmp3);
+    jpeg_idct_wide Tmp11 = IDCTAdd(Tmp1, Tmp2);
+    jpeg_idct_wide Tmp12 = IDCTSub(Tmp1, Tmp2);
+
+    // NOTE: The odd part. jidctint's multiplies by z1..z5 folded into the rotations of (in7, in1), (in5, in3) and
+    // (in7 + in3, in5 + in1).
+    __m128i Sum73 = _mm_add_epi16(Rows[7], Rows[3]);
+    __m128i Sum51 = _mm_add_epi16(Rows[5], Rows[1]);
+    jpeg_idct_wide Z3 = IDCTRotate(Sum73, Sum51, JPEG_IDCT_FIX(1.175875602 - 1.961570560),
+                                   JPEG_IDCT_FIX(1.175875602));
+    jpeg_idct_wide Z4 = IDCTRotate(Sum73, Sum51, JPEG_IDCT_FIX(1.175875602),
+                                   JPEG_IDCT_FIX(1.175875602 - 0.390180644));
+    jpeg_idct_wide Odd0 = IDCTRotate(Rows[7], Rows[1], JPEG_IDCT_FIX(0.298631336 - 0.899976223),
+                                     JPEG_IDCT_FIX(-0.899976223));
+    jpeg_idct_wide Odd3 = IDCTRotate(Rows[7], Rows[1], JPEG_IDCT_FIX(-0.899976223),
+                                     JPEG_IDCT_FIX(1.501321110 - 0.899976223));
+    jpeg_idct_wide Odd1 = IDCTRotate(Rows[5], Rows[3], JPEG_IDCT_FIX(2.053119869 - 2.562915447),
+                                     JPEG_IDCT_FIX(-2.562915447));
+    jpeg_idct_wide Odd2 = IDCTRotate(Rows[5], Rows[3], JPEG_IDCT_FIX(-2.562915447),
+                                     JPEG_IDCT_FIX(3.072711026 - 2.562915447));
+    Odd0 = IDCTAdd(Odd0, Z3);
+    Odd1 = IDCTAdd(Odd1, Z4);
+    Odd2 = IDCTAdd(Odd2, Z3);
+    Odd3 = IDCTAdd(Odd3, Z4);
+
+    Rows[0] = IDCTDescale<Shift>(IDCTAdd(Tmp10, Odd3));
+    Rows[7] = IDCTDescale<Shift>(IDCTSub(Tmp10, Odd3));
+    Rows[1] = IDCTDescale<Shift>(IDCTAdd(Tmp11, Odd2));
+    Rows[6] = IDCTDescale<Shift>(IDCTSub(Tmp11, Odd2));
+    Rows[2] = IDCTDescale<Shift>(IDCTAdd(Tmp12, Odd1));
+    Rows[5] = IDCTDescale<Shift>(IDCTSub(Tmp12, Odd1));
+    Rows[3] = IDCTDescale<Shift>(IDCTAdd(Tmp13, Odd0));
+    Rows[4] = IDCTDescale<Shift>(IDCTSub(Tmp13, Odd0));
+}
+
+static inline void
+Transpose8x8(__m128i *Rows)
+{
+    __m128i A0 = _mm_unpacklo_epi16(Rows[0], Rows[1]);
+    __m128i A1 = _mm_unpackhi_epi16(Rows[0], Rows[1]);
+    __m128i A2 = _mm_unpacklo_epi16(Rows[2], Rows[3]);
+    __m128i A3 = _mm_unpackhi_epi16(Rows[2], Rows[3]);
+    __m128i A4 = _mm_unpacklo_epi16(Rows[4], Rows[5]);
+    __m128i A5 = _mm_unpackhi_epi16(Rows[4], Rows[5]);
+    __m128i A6 = _mm_unpacklo_epi16(Rows[6], Rows[7]);
+    __m128i A7 = _mm_unpackhi_epi16(Rows[6], Rows[7]);
+
+    __m128i B0 = _mm_unpacklo_epi32(A0, A2);
+    __m128i B1 = _mm_unpackhi_epi32(A0, A2);
+    __m128i B2 = _mm_unpacklo_epi32(A1, A3);
+    __m128i B3 = _mm_unpackhi_epi32(A1, A3);
+    __m128i B4 = _mm_unpacklo_epi32(A4, A6);
+    __m128i B5 = _mm_unpackhi_epi32(A4, A6);
+    __m128i B6 = _mm_unpacklo_epi32(A5, A7);
+    __m128i B7 = _mm_unpackhi_epi32(A5, A7);
+
+    Rows[0] = _mm_unpacklo_epi64(B0, B4);
+    Rows[1] = _mm_unpackhi_epi64(B0, B4);
+    Rows[2] = _mm_unpacklo_epi64(B1, B5);
+    Rows[3] = _mm_unpackhi_epi64(B1, B5);
+    Rows[4] = _mm_unpacklo_epi64(B2, B6);
+    Rows[5] = _mm_unpackhi_epi64(B2, B6);
+    Rows[6] = _mm_unpacklo_epi64(B3, B7);
+    Rows[7] = _mm_unpackhi_epi64(B3, B7);
+}
+
+// NOTE: Dequantizes the block's coefficients and writes its 8x8 samples to Out.
+static void
+IDCTBlock(const i16 *Coefs, const u16 *Quant, u8 *Out, size_t Stride)
+{
+    __m128i Rows[8];
+    __m128i AnyAC = _mm_setzero_si128();
+    for(u32 Row = 0; Row < 8; ++Row)
+    {
+        Rows[Row] = _mm_mullo_epi16(_mm_loadu_si128((const __m128i *)(Coefs + Row*8)),
+                                    _mm_loadu_si128((const __m128i *)(Quant + Row*8)));
+        AnyAC = _mm_or_si128(AnyAC, (Row > 0) ? Rows[Row] : _mm_slli_si128(_mm_srli_si128(Rows[0], 2), 2));
+    }
+
+    // NOTE: Most of the blocks of a smooth image have only their DC left after quantization and come out flat. This
+    // is what the two passes give for them.
+    if(_mm_movemask_epi8(_mm_cmpeq_epi8(AnyAC, _mm_setzero_si128())) == 0xFFFF)
+    {
+        i32 DC = (i16)_mm_cvtsi128_si32(Rows[0]);
+        i32 Value = ((DC + 4) >> 3) + 128;
+        u8 Sample = (u8)ClampToRange(Value, 0, 255);
+        for(u32 Row = 0; Row < 8; ++Row)
+        {
+            memset(Out + Row*Stride, Sample, 8);
+        }
+        return;
+    }
+
+    IDCTPass<JPEG_IDCT_CONST_BITS - JPEG_IDCT_PASS1_BITS>(
+        Rows, _mm_set1_epi32(1 << (JPEG_IDCT_CONST_BITS - JPEG_IDCT_PASS1_BITS - 1)));
+    Transpose8x8(Rows);
+    IDCTPass<JPEG_IDCT_CONST_BITS + JPEG_IDCT_PASS1_BITS + 3>(
+        Rows, _mm_set1_epi32((1 << (JPEG_IDCT_CONST_BITS + JPEG_IDCT_PASS1_BITS + 2)) +
+                             (128 << (JPEG_IDCT_CONST_BITS + JPEG_IDCT_PASS1_BITS + 3))));
+    Transpose8x8(Rows);
+
+    for(u32 Row = 0; Row < 8; Row += 2)
+    {
+        __m128i Samples = _mm_packus_epi16(Rows[Row], Rows[Row + 1]);
+        _mm_storel_epi64((__m128i *)(Out + Row*Stride), Samples);
+        _mm_storel_epi64((__m128i *)(Out + (Row + 1)*Stride), _mm_srli_si128(Samples, 8));
+    }
+}
+
+//
+// NOTE: Entropy decoding
+//
+
+// NOTE: A baseline block(T.81 F.2.2), its quantized coefficients in natural order.
+static b32
+DecodeBlock(jpeg_bit_reader *Reader, const jpeg_huffman *DC, const jpeg_huffman *AC, i32 *Predictor, i16 *Block)
+{
+    memset(Block, 0, 64*sizeof(i16));
+
+    if(Reader->BitCount < 32)
+    {
+        JPEGRefill(Reader);
+    }
+    i32 Size = DecodeHuffman(Reader, DC);
+    if((Size < 0) || (Size > 15))
+    {
+        return false;
+    }
+    if(Size)
+    {
+        *Predictor += ReadExtendedBits(Reader, (u32)Size);
+    }
+    Block[0] = (i16)*Predictor;
+
+    u32 K = 1;
+    do
+    {
+        if(Reader->BitCount < 32)
+        {
+            JPEGRefill(Reader);
+        }
+
+        i32 Fast = AC->FastAC[Reader->Bits >> (64 - JPEG_FAST_BITS)];
+        if(Fast)
+        {
+            K += (Fast >> 4) & 15;
+            ConsumeBits(Reader, Fast & 15);
+            if(K > 63)
+            {
+                return false;
+            }
+            Block[JPEGNaturalOrder[K++]] = (i16)(Fast >> 8);
+            continue;
+        }
+
+        i32 RunSize = DecodeHuffman(Reader, AC);
+        if(RunSize < 0)
+        {
+            return false;
+        }
+        u32 Run = (u32)RunSize >> 4;
+        u32 BitSize = (u32)RunSize & 15;
+        if(BitSize == 0)
+        {
+            // NOTE: End of block, or a run of 16 zeros.
+            if(Run != 15)
+            {
+                break;
+            }
+            K += 16;
+            continue;
+        }
+
+        K += Run;
+        if(K > 63)
+        {
+            return false;
+        }
+        Block[JPEGNaturalOrder[K++]] = (i16)ReadExtendedBits(Reader, BitSize);
+    } while(K < 64);
+
+    return true;
+}
+
+// NOTE: The progressive scans(T.81 G.1.2). The first scan of a band gives its coefficients without their ApproxLow
+// low bits, each refining scan after it adds a bit.
+static b32
+DecodeDCFirst(jpeg_bit_reader *Reader, const jpeg_huffman *DC, i32 *Predictor, i16 *Coefs, u32 ApproxLow)
+{
+    if(Reader->BitCount < 32)
+    {
+        JPEGRefill(Reader);
+    }
+    i32 Size = DecodeHuffman(Reader, DC);
+    if((Size < 0) || (Size > 15))
+    {
+        return false;
+    }
+    if(Size)
+    {
+        *Predictor += ReadExtendedBits(Reader, (u32)Size);
+    }
+    Coefs[0] = (i16)(*Predictor * (1 << ApproxLow));
+    return true;
+}
+
+static void
+DecodeDCRefine(jpeg_bit_reader *Reader, i16 *Coefs, u32 ApproxLow)
+{
+    if(ReadBit(Reader))
+    {
+        Coefs[0] |= (i16)(1 << ApproxLow);
+    }
+}
+
+static b32
+DecodeACFirst(jpeg_bit_reader *Reader, const jpeg_huffman *AC, u32 *EobRun, i16 *Coefs, const jpeg_scan *Scan)
+{
+    if(*EobRun)
+    {
+        --*EobRun;
+        return true;
+    }
+
+    u32 K = Scan->SpectralStart;
+    while(K <= Scan->SpectralEnd)
+    {
+        if(Reader->BitCount < 32)
+        {
+            JPEGRefill(Reader);
+        }
+        i32 RunSize = DecodeHuffman(Reader, AC);
+        if(RunSize < 0)
+        {
+            return false;
+        }
+        u32 Run = (u32)RunSize >> 4;
+        u32 BitSize = (u32)RunSize & 15;
+        if(BitSize == 0)
+        {
+            if(Run < 15)
+            {
+                // NOTE: This block and the next EobRun ones have no more coefficients in the band.
+                *EobRun = (1u << Run) - 1;
+                if(Run)
+                {
+                    *EobRun += ReadBits(Reader, Run);
+                }
+                break;
+            }
+            K += 16;
+            continue;
+        }
+
+        K += Run;
+        if(K > Scan->SpectralEnd)
+        {
+            return false;
+        }
+        Coefs[JPEGNaturalOrder[K++]] = (i16)(ReadExtendedBits(Reader, BitSize) * (1 << Scan->ApproxLow));
+    }
+
+    return true;
+}
+
+// NOTE: A coefficient which is already nonzero gets a correction bit in every refining scan.
+static inline void
+RefineCoefficient(jpeg_bit_reader *Reader, i16 *Coef, i16 Bit)
+{
+    if(ReadBit(Reader) && ((*Coef & Bit) == 0))
+    {
+        *Coef += (*Coef >= 0) ? Bit : (i16)-Bit;
+    }
+}
+
+static b32
+DecodeACRefine(jpeg_bit_reader *Reader, const jpeg_huffman *AC, u32 *EobRun, i16 *Coefs, const jpeg_scan *Scan)
+{
+    i16 Bit = (i16)(1 << Scan->ApproxLow);
+    u32 K = Scan->SpectralStart;
+    if(*EobRun == 0)
+    {
+        while(K <= Scan->SpectralEnd)
+        {
+            if(Reader->BitCount < 32)
+            {
+                JPEGRefill(Reader);
+            }
+            i32 RunSize = DecodeHuffman(Reader, AC);
+            if(RunSize < 0)
+            {
+                return false;
+            }
+            u32 Run = (u32)RunSize >> 4;
+            u32 BitSize = (u32)RunSize & 15;
+            i16 Value = 0;
+            if(BitSize == 0)
+            {
+                if(Run < 15)
+                {
+                    // NOTE: The run includes this block, whose rest is refined below.
+                    *EobRun = 1u << Run;
+                    if(Run)
+                    {
+                        *EobRun += ReadBits(Reader, Run);
+                    }
+                    break;
+                }
+                // NOTE: 16 zeros, the last one gets the 0 Value.
+            }
+            else
+            {
+                // NOTE: A coefficient which becomes nonzero in this scan is always +-Bit.
+                if(BitSize != 1)
+                {
+                    return false;
+                }
+                Value = ReadBit(Reader) ? Bit : (i16)-Bit;
+            }
+
+            // NOTE: Skips Run zero coefficients, refining the nonzero ones on the way, and puts Value in the zero after
+            // them.
+            while(K <= Scan->SpectralEnd)
+            {
+                i16 *Coef = Coefs + JPEGNaturalOrder[K++];
+                if(*Coef != 0)
+                {
+                    RefineCoefficient(Reader, Coef, Bit);
+                }
+                else
+                {
+                    if(Run == 0)
+                    {
+                        *Coef = Value;
+                        break;
+                    }
+                    --Run;
+                }
+            }
+        }
+    }
+
+    if(*EobRun > 0)
+    {
+        for(; K <= Scan->SpectralEnd; ++K)
+        {
+            i16 *Coef = Coefs + JPEGNaturalOrder[K];
+            if(*Coef != 0)
+            {
+                RefineCoefficient(Reader, Coef, Bit);
+            }
+        }
+        --*EobRun;
+    }
+
+    return true;
+}
+
+static inline b32
+DecodeScanBlock(const jpeg_decoder *Decoder, const jpeg_scan *Scan, const jpeg_component *Component, u32 BlockX,
+                u32 BlockY, jpeg_bit_reader *Reader, i32 *Predictor, u32 *EobRun, i16 *Block)
+{
+    const jpeg_huffman *DC = Decoder->DC + Component->DCTable;
+    const jpeg_huffman *AC = Decoder->AC + Component->ACTable;
+    if(!Decoder->Info.Progressive)
+    {
+        if(!DecodeBlock(Reader, DC, AC, Predictor, Block))
+        {
+            return false;
+        }
+        size_t Stride = (size_t)Component->BlocksPerLine*8;
+        IDCTBlock(Block, Decoder->Quant[Component->QuantIndex], Component->Plane + BlockY*8*Stride + BlockX*8,
+                  Stride);
+        return true;
+    }
+
+    i16 *Coefs = Component->Coefs + ((size_t)BlockY*Component->BlocksPerLine + BlockX)*64;
+    if(Scan->SpectralStart == 0)
+    {
+        if(Scan->ApproxHigh == 0)
+        {
+            return DecodeDCFirst(Reader, DC, Predictor, Coefs, Scan->ApproxLow);
+        }
+        DecodeDCRefine(Reader, Coefs, Scan->ApproxLow);
+        return true;
+    }
+    if(Scan->ApproxHigh == 0)
+    {
+        return DecodeACFirst(Reader, AC, EobRun, Coefs, Scan);
+    }
+    return DecodeACRefine(Reader, AC, EobRun, Coefs, Scan);
+}
+
+// NOTE: Decodes the MCUs [FirstMCU, LastMCU) out of one restart interval. The DC predictions and the EOB run start
+// over at every restart marker.
+static b32
+DecodeScanSegment(const jpeg_decoder *Decoder, const jpeg_scan *Scan, jpeg_segment Segment, u32 FirstMCU,
+                  u32 LastMCU)
+{
+    jpeg_bit_reader Reader = {0, 0, Segment.Start, Segment.End};
+    i32 Predictors[JPEG_MAX_COMPONENTS] = {};
+    u32 EobRun = 0;
+    i16 Block[64];
+
+    for(u32 MCU = FirstMCU; MCU < LastMCU; ++MCU)
+    {
+        u32 MCUX = MCU % Scan->MCUsPerLine;
+        u32 MCUY = MCU / Scan->MCUsPerLine;
+        if(Scan->ComponentCount == 1)
+        {
+            if(!DecodeScanBlock(Decoder, Scan, Scan->Components[0], MCUX, MCUY, &Reader, Predictors, &EobRun, Block))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        for(u32 Index = 0; Index < Scan->ComponentCount; ++Index)
+        {
+            const jpeg_component *Component = Scan->Components[Index];
+            for(u32 Y = 0; Y < Component->V; ++Y)
+            {
+                for(u32 X = 0; X < Component->H; ++X)
+                {
+                    if(!DecodeScanBlock(Decoder, Scan, Component, MCUX*Component->H + X, MCUY*Component->V + Y,
+                                        &Reader, Predictors + Index, &EobRun, Block))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// NOTE: Splits the scan's entropy coded data at its restart markers and returns where the data ends, at the first
+// marker which is not a restart marker. A file with fewer markers than it should have gets empty segments at the end,
+// the extra markers of one with more are left in the last segment, whose reader stops at them.
+static size_t
+FindScanSegments(const jpeg_decoder *Decoder, jpeg_segment *Segments, u32 SegmentCount)
+{
+    const u8 *At = Decoder->Data + Decoder->At;
+    const u8 *End = Decoder->Data + Decoder->Size;
+    u32 Found = 0;
+    Segments[0].Start = At;
+    while(At < End)
+    {
+        At = (const u8 *)memchr(At, 0xFF, (size_t)(End - At));
+        if((At == nullptr) || (At + 1 >= End))
+        {
+            At = End;
+            break;
+        }
+
+        u32 Next = At[1];
+        if(Next == 0x00)
+        {
+            At += 2;
+        }
+        else if(Next == 0xFF)
+        {
+            ++At;
+        }
+        else if((Next >= JPEGMarker_RST0) && (Next <= JPEGMarker_RST7))
+        {
+            if(Found + 1 < SegmentCount)
+            {
+                Segments[Found++].End = At;
+                Segments[Found].Start = At + 2;
+            }
+            At += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    Segments[Found].End = At;
+    for(u32 Index = Found + 1; Index < SegmentCount; ++Index)
+    {
+        Segments[Index] = {At, At};
+    }
+    return (size_t)(At - Decoder->Data);
+}
+
+// NOTE: The restart intervals touch different blocks, so they are decoded in parallel on the job system, a few of
+// them per job.
+static b32
+DecodeScan(jpeg_decoder *Decoder, const jpeg_scan *Scan)
+{
+    u32 Interval = Decoder->Info.RestartInterval;
+    u32 SegmentCount = (Interval > 0) ? (Scan->MCUCount + Interval - 1) / Interval : 1;
+    if(Interval == 0)
+    {
+        Interval = Scan->MCUCount;
+    }
+
+    jpeg_segment *Segments = (jpeg_segment *)malloc(SegmentCount*sizeof(jpeg_segment));
+    if(Segments == nullptr)
+    {
+        return false;
+    }
+    Decoder->At = FindScanSegments(Decoder, Segments, SegmentCount);
+
+    b32 Result = true;
+    if(SegmentCount == 1)
+    {
+        Result = DecodeScanSegment(Decoder, Scan, Segments[0], 0, Scan->MCUCount);
+    }
+    else
+    {
+        std::atomic<b32> Failed{false};
+        const jpeg_decoder *Shared = Decoder;
+        JobSystem_ParallelFor((i32)SegmentCount, (i32)MAX(1u, 1024 / Interval), [&](i32 First, i32 Last) {
+            for(i32 Index = First; Index < Last; ++Index)
+            {
+                u32 FirstMCU = (u32)Index*Interval;
+                u32 LastMCU = MIN(FirstMCU + Interval, Scan->MCUCount);
+                if(!DecodeScanSegment(Shared, Scan, Segments[Index], FirstMCU, LastMCU))
+                {
+                    Failed.store(true, std::memory_order_relaxed);
+                }
+            }
+        });
+        Result = !Failed.load(std::memory_order_relaxed);
+    }
+
+    free(Segments);
+    return Result;
+}
+
+//
+// NOTE: Markers
+//
+
+static b32
+ReadQuantTables(jpeg_decoder *Decoder, const u8 *Segment, u32 SegmentSize)
+{
+    while(SegmentSize > 0)
+    {
+        u32 Precision = Segment[0] >> 4;
+        u32 Index = Segment[0] & 15;
+        u32 TableSize = 1 + 64*(Precision + 1);
+        if((Precision > 1) || (Index > 3) || (SegmentSize < TableSize))
+        {
+            return false;
+        }
+
+        for(u32 K = 0; K < 64; ++K)
+        {
+            Decoder->Quant[Index][JPEGNaturalOrder[K]] = Precision ? ReadU16BE(Segment + 1 + K*2) : Segment[1 + K];
+        }
+        Decoder->QuantDefined[Index] = true;
+        Segment += TableSize;
+        SegmentSize -= TableSize;
+    }
+
+    return true;
+}
+
+static b32
+ReadHuffmanTables(jpeg_decoder *Decoder, const u8 *Segment, u32 SegmentSize)
+{
+    while(SegmentSize > 0)
+    {
+        if(SegmentSize < 17)
+        {
+            return false;
+        }
+        u32 Class = Segment[0] >> 4;
+        u32 Index = Segment[0] & 15;
+        u32 SymbolCount = 0;
+        for(u32 Length = 0; Length < 16; ++Length)
+        {
+            SymbolCount += Segment[1 + Length];
+        }
+        if((Class > 1) || (Index > 3) || (SymbolCount > 256) || (SegmentSize < 17 + SymbolCount))
+        {
+            return false;
+        }
+
+        jpeg_huffman *Table = (Class == 0) ? (Decoder->DC + Index) : (Decoder->AC + Index);
+        if(!BuildHuffman(Table, Segment + 1, Segment + 17, SymbolCount, Class == 1))
+        {
+            return false;
+        }
+        Segment += 17 + SymbolCount;
+        SegmentSize -= 17 + SymbolCount;
+    }
+
+    return true;
+}
+
+static b32
+ReadFrame(jpeg_decoder *Decoder, u32 Marker, const u8 *Segment, u32 SegmentSize)
+{
+    if(Decoder->FrameRead || (SegmentSize < 6))
+    {
+        return false;
+    }
+
+    u32 Precision = Segment[0];
+    u32 Height = ReadU16BE(Segment + 1);
+    u32 Width = ReadU16BE(Segment + 3);
+    u32 ComponentCount = Segment[5];
+    // NOTE: A height of 0 means it comes in a DNL marker after the first scan, which nothing writes anymore.
+    if((Precision != 8) || (Width == 0) || (Height == 0) || (ComponentCount != 1 && ComponentCount != 3) ||
+       (SegmentSize < 6 + ComponentCount*3))
+    {
+        return false;
+    }
+
+    Decoder->HMax = 1;
+    Decoder->VMax = 1;
+    for(u32 Index = 0; Index < ComponentCount; ++Index)
+    {
+        jpeg_component *Component = Decoder->Components + Index;
+        const u8 *Spec = Segment + 6 + Index*3;
+        Component->Id = Spec[0];
+        Component->H = Spec[1] >> 4;
+        Component->V = Spec[1] & 15;
+        Component->QuantIndex = Spec[2];
+        if((Component->H < 1) || (Component->H > 4) || (Component->V < 1) || (Component->V > 4) ||
+           (Component->QuantIndex > 3))
+        {
+            return false;
+        }
+
+        // NOTE: The scan of a single component is not interleaved, its sampling factors do not matter.
+        if(ComponentCount == 1)
+        {
+            Component->H = 1;
+            Component->V = 1;
+        }
+        Decoder->HMax = MAX(Decoder->HMax, Component->H);
+        Decoder->VMax = MAX(Decoder->VMax, Component->V);
+    }
+
+    Decoder->MCUsPerLine = (Width + Decoder->HMax*8 - 1) / (Decoder->HMax*8);
+    Decoder->MCUsPerColumn = (Height + Decoder->VMax*8 - 1) / (Decoder->VMax*8);
+    for(u32 Index = 0; Index < ComponentCount; ++Index)
+    {
+        // NOTE: The upsampling only does whole ratios, like 4:2:0 and 4:2:2.
+        jpeg_component *Component = Decoder->Components + Index;
+        if((Decoder->HMax % Component->H) || (Decoder->VMax % Component->V))
+        {
+            return false;
+        }
+        Component->Width = (Width*Component->H + Decoder->HMax - 1) / Decoder->HMax;
+        Component->Height = (Height*Component->V + Decoder->VMax - 1) / Decoder->VMax;
+        Component->BlocksPerLine = Decoder->MCUsPerLine*Component->H;
+        Component->BlocksPerColumn = Decoder->MCUsPerColumn*Component->V;
+    }
+
+    Decoder->ComponentCount = ComponentCount;
+    Decoder->Info.Width = Width;
+    Decoder->Info.Height = Height;
+    Decoder->Info.ChannelCount = ComponentCount;
+    Decoder->Info.Progressive = (Marker == JPEGMarker_SOF2);
+    Decoder->FrameRead = true;
+    return true;
+}
+
+static b32
+ReadScanHeader(jpeg_decoder *Decoder, const u8 *Segment, u32 SegmentSize, jpeg_scan *Scan)
+{
+    if(!Decoder->FrameRead || (SegmentSize < 1))
+    {
+        return false;
+    }
+    u32 ComponentCount = Segment[0];
+    if((ComponentCount < 1) || (ComponentCount > Decoder->ComponentCount) || (SegmentSize < 4 + ComponentCount*2))
+    {
+        return false;
+    }
+
+    *Scan = {};
+    Scan->ComponentCount = ComponentCount;
+    for(u32 Index = 0; Index < ComponentCount; ++Index)
+    {
+        u32 Id = Segment[1 + Index*2];
+        u32 Tables = Segment[2 + Index*2];
+        jpeg_component *Component = nullptr;
+        for(u32 Search = 0; Search < Decoder->ComponentCount; ++Search)
+        {
+            if(Decoder->Components[Search].Id == Id)
+            {
+                Component = Decoder->Components + Search;
+            }
+        }
+        for(u32 Previous = 0; Previous < Index; ++Previous)
+        {
+            if(Scan->Components[Previous] == Component)
+            {
+                Component = nullptr;
+            }
+        }
+        if((Component == nullptr) || ((Tables >> 4) > 3) || ((Tables & 15) > 3))
+        {
+            return false;
+        }
+        Component->DCTable = Tables >> 4;
+        Component->ACTable = Tables & 15;
+        Scan->Components[Index] = Component;
+    }
+
+    const u8 *Selection = Segment + 1 + ComponentCount*2;
+    if(Decoder->Info.Progressive)
+    {
+        Scan->SpectralStart = Selection[0];
+        Scan->SpectralEnd = Selection[1];
+        Scan->ApproxHigh = Selection[2] >> 4;
+        Scan->ApproxLow = Selection[2] & 15;
+        // NOTE: A DC scan can be interleaved, the AC scans are of one component and never have the DC.
+        if((Scan->SpectralStart > Scan->SpectralEnd) || (Scan->SpectralEnd > 63) || (Scan->ApproxLow > 13) ||
+           ((Scan->SpectralStart == 0) && (Scan->SpectralEnd != 0)) ||
+           ((Scan->SpectralStart > 0) && (ComponentCount != 1)))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        Scan->SpectralEnd = 63;
+    }
+
+    b32 NeedsDC = (Scan->SpectralStart == 0) && (Scan->ApproxHigh == 0);
+    b32 NeedsAC = !Decoder->Info.Progressive || (Scan->SpectralStart > 0);
+    for(u32 Index = 0; Index < ComponentCount; ++Index)
+    {
+        const jpeg_component *Component = Scan->Components[Index];
+        if(!Decoder->QuantDefined[Component->QuantIndex] || (NeedsDC && !Decoder->DC[Component->DCTable].Defined) ||
+           (NeedsAC && !Decoder->AC[Component->ACTable].Defined))
+        {
+            return false;
+        }
+    }
+
+    if(ComponentCount == 1)
+    {
+        const jpeg_component *Component = Scan->Components[0];
+        Scan->MCUsPerLine = (Component->Width + 7) / 8;
+        Scan->MCUCount = Scan->MCUsPerLine*((Component->Height + 7) / 8);
+    }
+    else
+    {
+        Scan->MCUsPerLine = Decoder->MCUsPerLine;
+        Scan->MCUCount = Decoder->MCUsPerLine*Decoder->MCUsPerColumn;
+    }
+    return true;
+}
+
+// NOTE: Reads the markers from Decoder->At. With StopAtScan it stops in front of the first scan, once it has the
+// frame header and the tables before it. Otherwise it decodes every scan it comes to, up to the end of the image.
+static b32
+ReadJPEGMarkers(jpeg_decoder *Decoder, b32 StopAtScan)
+{
+    const u8 *Data = Decoder->Data;
+    size_t Size = Decoder->Size;
+    while(Decoder->At < Size)
+    {
+        size_t MarkerStart = Decoder->At;
+        if(Data[Decoder->At] != 0xFF)
+        {
+            break;
+        }
+        // NOTE: Any number of FFs can come before a marker.
+        while((Decoder->At < Size) && (Data[Decoder->At] == 0xFF))
+        {
+            ++Decoder->At;
+        }
+        if(Decoder->At >= Size)
+        {
+            break;
+        }
+
+        u32 Marker = Data[Decoder->At++];
+        if(Marker == JPEGMarker_EOI)
+        {
+            break;
+        }
+        if((Marker == JPEGMarker_SOI) || (Marker == JPEGMarker_TEM) ||
+           ((Marker >= JPEGMarker_RST0) && (Marker <= JPEGMarker_RST7)))
+        {
+            continue;
+        }
+        if(Marker == JPEGMarker_SOS && StopAtScan)
+        {
+            Decoder->At = MarkerStart;
+            return Decoder->FrameRead;
+        }
+
+        if(Decoder->At + 2 > Size)
+        {
+            return false;
+        }
+        u32 Length = ReadU16BE(Data + Decoder->At);
+        if((Length < 2) || (Decoder->At + Length > Size))
+        {
+            return false;
+        }
+        const u8 *Segment = Data + Decoder->At + 2;
+        u32 SegmentSize = Length - 2;
+        Decoder->At += Length;
+
+        b32 Valid = true;
+        switch(Marker)
+        {
+            case JPEGMarker_SOF0:
+            case JPEGMarker_SOF1:
+            case JPEGMarker_SOF2:
+            {
+                Valid = ReadFrame(Decoder, Marker, Segment, SegmentSize);
+            } break;
+
+            case JPEGMarker_DHT: { Valid = ReadHuffmanTables(Decoder, Segment, SegmentSize); } break;
+            case JPEGMarker_DQT: { Valid = ReadQuantTables(Decoder, Segment, SegmentSize); } break;
+
+            case JPEGMarker_DRI:
+            {
+                Valid = (SegmentSize >= 2);
+                Decoder->Info.RestartInterval = Valid ? ReadU16BE(Segment) : 0;
+            } break;
+
+            case JPEGMarker_SOS:
+            {
+                jpeg_scan Scan;
+                Valid = ReadScanHeader(Decoder, Segment, SegmentSize, &Scan) && DecodeScan(Decoder, &Scan);
+                ++Decoder->ScanCount;
+            } break;
+
+            case JPEGMarker_APP14:
+            {
+                if((SegmentSize >= 12) && (memcmp(Segment, "Adobe", 5) == 0))
+                {
+                    Decoder->AdobeTransform = Segment[11];
+                }
+            } break;
+
+            default:
+            {
+                // NOTE: The other frame types, lossless, hierarchical and arithmetic coded, are not supported. The
+                // rest, the APPn and COM segments, are skipped.
+                b32 IsFrame = (Marker >= JPEGMarker_SOF0) && (Marker <= 0xCF) && (Marker != JPEGMarker_DHT);
+                Valid = !IsFrame;
+            } break;
+        }
+
+        if(!Valid)
+        {
+            return false;
+        }
+    }
+
+    // NOTE: A file which is cut off after a scan still gives an image, like it does with stb_image.
+    b32 Result = !StopAtScan && Decoder->FrameRead && (Decoder->ScanCount > 0);
+    return Result;
+}
+
+static jpeg_decoder *
+CreateJPEGDecoder(const u8 *Data, size_t Size)
+{
+    // NOTE: The huffman tables are too big for the stack of a job's fiber.
+    jpeg_decoder *Decoder = (jpeg_decoder *)malloc(sizeof(jpeg_decoder));
+    if(Decoder != nullptr)
+    {
+        memset(Decoder, 0, sizeof(jpeg_decoder));
+        Decoder->Data = Data;
+        Decoder->Size = Size;
+        Decoder->At = 2;
+        Decoder->AdobeTransform = -1;
+    }
+    return Decoder;
+}
+
+b32
+GetJPEGInfo(const u8 *Data, size_t Size, jpeg_image_info *Info)
+{
+    if(!IsJPEG(Data, Size))
+    {
+        return false;
+    }
+
+    jpeg_decoder *Decoder = CreateJPEGDecoder(Data, Size);
+    b32 Result = (Decoder != nullptr) && ReadJPEGMarkers(Decoder, true);
+    if(Result)
+    {
+        *Info = Decoder->Info;
+    }
+    free(Decoder);
+    return Result;
+}
+
+//
+// NOTE: Upsampling and color conversion
+//
+
+// NOTE: Row Y of the component at the image's resolution. A component which is not subsampled is returned as it is,
+// a 2x subsampled one is upsampled into Out with the triangle filter of libjpeg's "fancy" upsampling, which weighs the
+// nearer sample 3 and the farther one 1. The other ratios repeat the samples, like stb_image and libjpeg do. Weighted
+// is a scratch row with a sample of room on both ends.
+static const u8 *
+UpsampleRow(const jpeg_decoder *Decoder, const jpeg_component *Component, u32 Y, i16 *Weighted, u8 *Out)
+{
+    u32 FactorX = Decoder->HMax / Component->H;
+    u32 FactorY = Decoder->VMax / Component->V;
+    size_t Stride = (size_t)Component->BlocksPerLine*8;
+    if((FactorX == 1) && (FactorY == 1))
+    {
+        return Component->Plane + Y*Stride;
+    }
+
+    // NOTE: Vertically first, into 16 bits and 4 times the sample. The farther row is the one above for the upper of
+    // the two rows a 2x subsampled row covers and the one below for the lower one.
+    u32 NearY = Y / FactorY;
+    const u8 *Near = Component->Plane + NearY*Stride;
+    u32 Width = Component->Width;
+    b32 Fancy = (FactorX <= 2) && (FactorY <= 2);
+    __m128i Zero = _mm_setzero_si128();
+    if(Fancy && (FactorY == 2))
+    {
+        u32 FarY = (Y & 1) ? MIN(NearY + 1, Component->Height - 1) : ((NearY > 0) ? NearY - 1 : 0);
+        const u8 *Far = Component->Plane + FarY*Stride;
+        for(u32 X = 0; X < Width; X += 8)
+        {
+            __m128i NearRow = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(Near + X)), Zero);
+            __m128i FarRow = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(Far + X)), Zero);
+            __m128i Sum = _mm_add_epi16(_mm_add_epi16(NearRow, _mm_add_epi16(NearRow, NearRow)), FarRow);
+            _mm_storeu_si128((__m128i *)(Weighted + X), Sum);
+        }
+    }
+    else
+    {
+        for(u32 X = 0; X < Width; X += 8)
+        {
+            __m128i NearRow = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(Near + X)), Zero);
+            _mm_storeu_si128((__m128i *)(Weighted + X), _mm_slli_epi16(NearRow, 2));
+        }
+    }
+    Weighted[-1] = Weighted[0];
+    Weighted[Width] = Weighted[Width - 1];
+
+    if(Fancy && (FactorX == 2))
+    {
+        // NOTE: Each sample becomes two, (3*this + left) / 16 and (3*this + right) / 16 with the 4x and the vertical
+        // weights taken out.
+        __m128i Rounding = _mm_set1_epi16(8);
+        for(u32 X = 0; X < Width; X += 8)
+        {
+            __m128i This = _mm_loadu_si128((const __m128i *)(Weighted + X));
+            __m128i Left = _mm_loadu_si128((const __m128i *)(Weighted + X - 1));
+            __m128i Right = _mm_loadu_si128((const __m128i *)(Weighted + X + 1));
+            __m128i Three = _mm_add_epi16(_mm_add_epi16(This, _mm_add_epi16(This, This)), Rounding);
+            __m128i Even = _mm_srli_epi16(_mm_add_epi16(Three, Left), 4);
+            __m128i Odd = _mm_srli_epi16(_mm_add_epi16(Three, Right), 4);
+            __m128i Samples = _mm_unpacklo_epi8(_mm_packus_epi16(Even, Even), _mm_packus_epi16(Odd, Odd));
+            _mm_storeu_si128((__m128i *)(Out + X*2), Samples);
+        }
+    }
+    else if(FactorX == 1)
+    {
+        __m128i Rounding = _mm_set1_epi16(2);
+        for(u32 X = 0; X < Width; X += 8)
+        {
+            __m128i Samples = _mm_srli_epi16(_mm_add_epi16(_mm_loadu_si128((const __m128i *)(Weighted + X)),
+                                                           Rounding), 2);
+            _mm_storel_epi64((__m128i *)(Out + X), _mm_packus_epi16(Samples, Samples));
+        }
+    }
+    else
+    {
+        u32 OutWidth = (Decoder->Info.Width + 7) & ~7u;
+        for(u32 X = 0; X < OutWidth; ++X)
+        {
+            Out[X] = (u8)((Weighted[X / FactorX] + 2) >> 2);
+        }
+    }
+
+    return Out;
+}
+
+// NOTE: JFIF's YCbCr to RGB(https://www.w3.org/Graphics/JPEG/jfif3.pdf) for 8 pixels, in 16 bits with 4 fractional
+// bits. The chroma goes in the high byte, so that _mm_mulhi_epi16 by the constants with 12 fractional bits leaves it
+// with 4 too.
+static inline void
+YCbCrToRGB(const u8 *YRow, const u8 *CbRow, const u8 *CrRow, __m128i *Red, __m128i *Green, __m128i *Blue)
+{
+    __m128i Zero = _mm_setzero_si128();
+    __m128i SignFlip = _mm_set1_epi16((i16)0x8000);
+    __m128i Luma = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)YRow), Zero);
+    Luma = _mm_add_epi16(_mm_slli_epi16(Luma, 4), _mm_set1_epi16(8));
+    __m128i Cb = _mm_xor_si128(_mm_unpacklo_epi8(Zero, _mm_loadl_epi64((const __m128i *)CbRow)), SignFlip);
+    __m128i Cr = _mm_xor_si128(_mm_unpacklo_epi8(Zero, _mm_loadl_epi64((const __m128i *)CrRow)), SignFlip);
+
+    __m128i R = _mm_add_epi16(Luma, _mm_mulhi_epi16(Cr, _mm_set1_epi16(5743)));
+    __m128i G = _mm_add_epi16(Luma, _mm_add_epi16(_mm_mulhi_epi16(Cb, _mm_set1_epi16(-1410)),
+                                                  _mm_mulhi_epi16(Cr, _mm_set1_epi16(-2925))));
+    __m128i B = _mm_add_epi16(Luma, _mm_mulhi_epi16(Cb, _mm_set1_epi16(7258)));
+    *Red = _mm_srai_epi16(R, 4);
+    *Green = _mm_srai_epi16(G, 4);
+    *Blue = _mm_srai_epi16(B, 4);
+}
+
+static inline u8
+GetLuminance(u32 Red, u32 Green, u32 Blue)
+{
+    u8 Result = (u8)((Red*77 + Green*150 + Blue*29) >> 8);
+    return Result;
+}
+
+// NOTE: One row of pixels out of the components' full resolution rows, converted the way stb_image converts them.
+// Gray is replicated into RGB, RGB turns to gray by its luminance, a YCbCr image turns to gray by its Y, and the alpha
+// is opaque.
+static void
+ConvertRow(const jpeg_decoder *Decoder, const u8 **Rows, u8 *Out, u32 ChannelCount)
+{
+    u32 Width = Decoder->Info.Width;
+    if(Decoder->ComponentCount == 1)
+    {
+        const u8 *Gray = Rows[0];
+        switch(ChannelCount)
+        {
+            case 1: { memcpy(Out, Gray, Width); } break;
+            case 2: { for(u32 X = 0; X < Width; ++X) { Out[X*2] = Gray[X]; Out[X*2 + 1] = 255; } } break;
+            case 3: { for(u32 X = 0; X < Width; ++X) { memset(Out + X*3, Gray[X], 3); } } break;
+            case 4:
+            {
+                for(u32 X = 0; X < Width; ++X)
+                {
+                    u32 Value = Gray[X]*0x010101u | 0xFF000000;
+                    memcpy(Out + X*4, &Value, 4);
+                }
+            } break;
+        }
+        return;
+    }
+
+    b32 IsRGB = (Decoder->AdobeTransform == 0) ||
+                ((Decoder->Components[0].Id == 'R') && (Decoder->Components[1].Id == 'G') &&
+                 (Decoder->Components[2].Id == 'B'));
+    if(ChannelCount < 3)
+    {
+        for(u32 X = 0; X < Width; ++X)
+        {
+            u8 Gray = IsRGB ? GetLuminance(Rows[0][X], Rows[1][X], Rows[2][X]) : Rows[0][X];
+            Out[X*ChannelCount] = Gray;
+            if(ChannelCount == 2)
+            {
+                Out[X*2 + 1] = 255;
+            }
+        }
+        return;
+    }
+
+    // NOTE: 8 pixels at a time. The rows are padded out to whole blocks, the last pixels go through Pixels so that
+    // nothing is written past the row.
+    __m128i Opaque = _mm_set1_epi8((char)0xFF);
+    __m128i Zero = _mm_setzero_si128();
+    u8 Pixels[32];
+    for(u32 X = 0; X < Width; X += 8)
+    {
+        __m128i RGBA0, RGBA1;
+        if(IsRGB)
+        {
+            __m128i RG = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(Rows[0] + X)),
+                                           _mm_loadl_epi64((const __m128i *)(Rows[1] + X)));
+            __m128i BA = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(Rows[2] + X)), Opaque);
+            RGBA0 = _mm_unpacklo_epi16(RG, BA);
+            RGBA1 = _mm_unpackhi_epi16(RG, BA);
+        }
+        else
+        {
+            __m128i R, G, B;
+            YCbCrToRGB(Rows[0] + X, Rows[1] + X, Rows[2] + X, &R, &G, &B);
+            __m128i RG = _mm_unpacklo_epi8(_mm_packus_epi16(R, Zero), _mm_packus_epi16(G, Zero));
+            __m128i BA = _mm_unpacklo_epi8(_mm_packus_epi16(B, Zero), Opaque);
+            RGBA0 = _mm_unpacklo_epi16(RG, BA);
+            RGBA1 = _mm_unpackhi_epi16(RG, BA);
+        }
+
+        u32 Count = MIN(8u, Width - X);
+        if((ChannelCount == 4) && (Count == 8))
+        {
+            _mm_storeu_si128((__m128i *)(Out + X*4), RGBA0);
+            _mm_storeu_si128((__m128i *)(Out + X*4 + 16), RGBA1);
+            continue;
+        }
+
+        _mm_storeu_si128((__m128i *)Pixels, RGBA0);
+        _mm_storeu_si128((__m128i *)(Pixels + 16), RGBA1);
+        if(ChannelCount == 4)
+        {
+            memcpy(Out + X*4, Pixels, Count*4);
+        }
+        else
+        {
+            for(u32 Index = 0; Index < Count; ++Index)
+            {
+                memcpy(Out + (X + Index)*3, Pixels + Index*4, 3);
+            }
+        }
+    }
+}
+
+b32
+DecodeJPEG(const u8 *Data, size_t Size, u8 *Out, size_t OutSize, u32 ChannelCount, b32 FlipVertically)
+{
+    if(!IsJPEG(Data, Size))
+    {
+        return false;
+    }
+    jpeg_decoder *Decoder = CreateJPEGDecoder(Data, Size);
+    if(Decoder == nullptr)
+    {
+        return false;
+    }
+    if(!ReadJPEGMarkers(Decoder, true))
+    {
+        free(Decoder);
+        return false;
+    }
+
+    const jpeg_image_info &Info = Decoder->Info;
+    if(ChannelCount == 0)
+    {
+        ChannelCount = Info.ChannelCount;
+    }
+    size_t OutRowSize = (size_t)Info.Width*ChannelCount;
+    if(ChannelCount > 4 || Out == nullptr || OutRowSize*Info.Height > OutSize)
+    {
+        free(Decoder);
+        return false;
+    }
+
+    // NOTE: The planes, and the coefficients of a progressive image, in one allocation. The coefficients start out
+    // zero, the scans only add to them.
+    size_t PlanesSize = 0;
+    size_t CoefsSize = 0;
+    for(u32 Index = 0; Index < Decoder->ComponentCount; ++Index)
+    {
+        const jpeg_component *Component = Decoder->Components + Index;
+        size_t BlockCount = (size_t)Component->BlocksPerLine*Component->BlocksPerColumn;
+        PlanesSize += BlockCount*64;
+        CoefsSize += Info.Progressive ? BlockCount*64*sizeof(i16) : 0;
+    }
+    u8 *Memory = (u8 *)malloc(CoefsSize + PlanesSize);
+    if(Memory == nullptr)
+    {
+        free(Decoder);
+        return false;
+    }
+    memset(Memory, 0, CoefsSize);
+    u8 *At = Memory;
+    for(u32 Index = 0; Index < Decoder->ComponentCount; ++Index)
+    {
+        jpeg_component *Component = Decoder->Components + Index;
+        size_t BlockCount = (size_t)Component->BlocksPerLine*Component->BlocksPerColumn;
+        if(Info.Progressive)
+        {
+            Component->Coefs = (i16 *)At;
+            At += BlockCount*64*sizeof(i16);
+        }
+    }
+    for(u32 Index = 0; Index < Decoder->ComponentCount; ++Index)
+    {
+        jpeg_component *Component = Decoder->Components + Index;
+        Component->Plane = At;
+        At += (size_t)Component->BlocksPerLine*Component->BlocksPerColumn*64;
+    }
+
+    b32 Result = ReadJPEGMarkers(Decoder, false);
+
+    // NOTE: A progressive image has its IDCTs done once all of the scans are in, a row of blocks per job.
+    if(Result && Info.Progressive)
+    {
+        for(u32 Index = 0; Index < Decoder->ComponentCount; ++Index)
+        {
+            const jpeg_component *Component = Decoder->Components + Index;
+            const u16 *Quant = Decoder->Quant[Component->QuantIndex];
+            JobSystem_ParallelFor((i32)Component->BlocksPerColumn, 4, [&](i32 First, i32 Last) {
+                size_t Stride = (size_t)Component->BlocksPerLine*8;
+                for(i32 BlockY = First; BlockY < Last; ++BlockY)
+                {
+                    for(u32 BlockX = 0; BlockX < Component->BlocksPerLine; ++BlockX)
+                    {
+                        const i16 *Coefs = Component->Coefs + ((size_t)BlockY*Component->BlocksPerLine + BlockX)*64;
+                        IDCTBlock(Coefs, Quant, Component->Plane + (size_t)BlockY*8*Stride + BlockX*8, Stride);
+                    }
+                }
+            });
+        }
+    }
+
+    // NOTE: The rows are upsampled and converted in parallel, each job with its own scratch rows. Weighted has a
+    // sample of room in front and some behind for the 8 wide loads.
+    u32 FullWidth = Decoder->MCUsPerLine*Decoder->HMax*8;
+    size_t WeightedSize = (FullWidth + 16)*sizeof(i16);
+    size_t UpsampledSize = FullWidth + 32;
+    size_t ScratchSize = (WeightedSize + UpsampledSize)*Decoder->ComponentCount;
+    if(Result)
+    {
+        std::atomic<b32> Failed{false};
+        const jpeg_decoder *Shared = Decoder;
+        JobSystem_ParallelFor((i32)Info.Height, 16, [&](i32 First, i32 Last) {
+            u8 *Scratch = (u8 *)malloc(ScratchSize);
+            if(Scratch == nullptr)
+            {
+                Failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+            memset(Scratch, 0, ScratchSize);
+
+            for(i32 Y = First; Y < Last; ++Y)
+            {
+                const u8 *Rows[JPEG_MAX_COMPONENTS];
+                for(u32 Index = 0; Index < Shared->ComponentCount; ++Index)
+                {
+                    u8 *ComponentScratch = Scratch + Index*(WeightedSize + UpsampledSize);
+                    Rows[Index] = UpsampleRow(Shared, Shared->Components + Index, (u32)Y,
+                                              (i16 *)ComponentScratch + 1, ComponentScratch + WeightedSize);
+                }
+                u32 OutY = FlipVertically ? (Info.Height - 1 - (u32)Y) : (u32)Y;
+                ConvertRow(Shared, Rows, Out + OutY*OutRowSize, ChannelCount);
+            }
+
+            free(Scratch);
+        });
+        Result = !Failed.load(std::memory_order_relaxed);
+    }
+
+    free(Memory);
+    free(Decoder);
+    return Result;
+}
+
+shoora_image_data
+LoadJPEG(const u8 *Data, size_t Size, b32 FlipVertically, u32 ChannelCount)
+{
+    shoora_image_data ImageData = {};
+
+    jpeg_image_info Info;
+    if(GetJPEGInfo(Data, Size, &Info))
+    {
+        u32 OutChannelCount = (ChannelCount != 0) ? ChannelCount : Info.ChannelCount;
+        size_t PixelsSize = (size_t)Info.Width*Info.Height*OutChannelCount;
+        u8 *Pixels = (u8 *)malloc(PixelsSize);
+        if(Pixels != nullptr && DecodeJPEG(Data, Size, Pixels, PixelsSize, OutChannelCount, FlipVertically))
+        {
+            ImageData.Dim = shu::vec2i{(i32)Info.Width, (i32)Info.Height};
+            ImageData.NumChannels = (i32)Info.ChannelCount;
+            ImageData.TotalSize = (u32)PixelsSize;
+            ImageData.Data = Pixels;
+        }
+        else
+        {
+            free(Pixels);
+        }
+    }
+
+    return ImageData;
+}
+
+shoora_image_data
+LoadJPEG(const char *Filename, b32 FlipVertically, u32 ChannelCount)
+{
+    shoora_image_data ImageData = {};
+
+    platform_mapped_file File = Platform_MapFile(Filename);
+    if(File.Data == nullptr)
+    {
+        LogError("JPEG file %s could not be opened!\n", Filename);
+        return ImageData;
+    }
+
+    ImageData = LoadJPEG((const u8 *)File.Data, File.Size, FlipVertically, ChannelCount);
+    if(ImageData.Data == nullptr)
+    {
+        LogError("JPEG file %s could not be decoded!\n", Filename);
+    }
+
+    Platform_UnmapFile(&File);
+    return ImageData;
+}
+
+void
+FreeJpeg(shoora_image_data *ImageData)
+{
+    ASSERT((ImageData != nullptr) && (ImageData->Data != nullptr));
+
+    free(ImageData->Data);
+    ImageData->Data = nullptr;
+    ImageData->Dim.w = 0;
+    ImageData->Dim.h = 0;
+    ImageData->NumChannels = 0;
+}
 
 shu::vec3f
 RGBToYCbCr(shu::vec3f Rgb)
@@ -17,4 +1734,163 @@ RGBToYCbCr(shu::vec3f Rgb)
     Result.z = 0.5f*Red - 0.4187f*Green - 0.0813f*Blue + 128;
 
     return Result;
-}
\ No newline at end of file
+}
+
+#if _SHU_DEBUG
+static inline f32
+JPEGBenchmarkMs(u64 Start)
+{
+    return 1000.0f * Platform_GetSecondsElapsed(Start, Platform_GetWallClock());
+}
+
+// NOTE: Both decode to RGBA from the file already in memory, so only the decode is timed. MB/s is of the decoded
+// pixels. The restart intervals and the color conversion run on the job system, so this is the throughput with all
+// of its threads.
+void
+jpeg_decoder_benchmark(const char **Paths, u32 PathCount, u32 Iterations)
+{
+    f64 TotalPixelBytes = 0.0;
+    f32 TotalShooraMs = 0.0f;
+    f32 TotalStbMs = 0.0f;
+    for(u32 PathIndex = 0; PathIndex < PathCount; ++PathIndex)
+    {
+        platform_mapped_file File = Platform_MapFile(Paths[PathIndex]);
+        jpeg_image_info Info;
+        if(File.Data == nullptr || !GetJPEGInfo((const u8 *)File.Data, File.Size, &Info))
+        {
+            LogWarn("[JPEG Benchmark]: %s is not a JPEG file this decoder supports, skipping it.\n",
+                    Paths[PathIndex]);
+            if(File.Data != nullptr)
+            {
+                Platform_UnmapFile(&File);
+            }
+            continue;
+        }
+
+        size_t PixelsSize = (size_t)Info.Width*Info.Height*4;
+        u8 *Pixels = (u8 *)malloc(PixelsSize);
+        b32 Decoded = true;
+        u64 Start = Platform_GetWallClock();
+        for(u32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Decoded = DecodeJPEG((const u8 *)File.Data, File.Size, Pixels, PixelsSize, 4) && Decoded;
+        }
+        f32 ShooraMs = JPEGBenchmarkMs(Start) / Iterations;
+        f32 PixelMB = (f32)PixelsSize / (1024.0f*1024.0f);
+        const char *Kind = Info.Progressive ? "progressive" : "baseline";
+
+#if SHU_USE_STB
+        b32 StbDecoded = false;
+        u32 MaxDifference = 0;
+        f64 MeanDifference = 0.0;
+        Start = Platform_GetWallClock();
+        for(u32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            i32 Width, Height, FileChannelCount;
+            u8 *StbPixels = stbi_load_from_memory((const u8 *)File.Data, (i32)File.Size, &Width, &Height,
+                                                  &FileChannelCount, 4);
+            if(StbPixels != nullptr && Iteration == 0)
+            {
+                StbDecoded = true;
+                u64 DifferenceSum = 0;
+                for(size_t Index = 0; Index < PixelsSize; ++Index)
+                {
+                    u32 Difference = (u32)SHU_ABSOLUTE((i32)StbPixels[Index] - (i32)Pixels[Index]);
+                    MaxDifference = MAX(MaxDifference, Difference);
+                    DifferenceSum += Difference;
+                }
+                MeanDifference = (f64)DifferenceSum / (f64)PixelsSize;
+            }
+            stbi_image_free(StbPixels);
+        }
+        f32 StbMs = JPEGBenchmarkMs(Start) / Iterations;
+
+        LogInfo("[JPEG Benchmark]: %s %ux%u(%s, restart interval %u): %.2fms %.1fMB/s, stb_image %.2fms %.1fMB/s, "
+                "%.2fx. Max difference %u, mean %.3f%s%s.\n",
+                Paths[PathIndex], Info.Width, Info.Height, Kind, Info.RestartInterval, ShooraMs,
+                PixelMB*1000.0f / ShooraMs, StbMs, PixelMB*1000.0f / StbMs, StbMs / ShooraMs, MaxDifference,
+                MeanDifference, Decoded ? "" : ", FAILED", StbDecoded ? "" : ", stb_image FAILED");
+        TotalStbMs += StbMs;
+#else
+        LogInfo("[JPEG Benchmark]: %s %ux%u(%s, restart interval %u): %.2fms %.1fMB/s%s.\n", Paths[PathIndex],
+                Info.Width, Info.Height, Kind, Info.RestartInterval, ShooraMs, PixelMB*1000.0f / ShooraMs,
+                Decoded ? "" : ", FAILED");
+#endif
+
+        TotalShooraMs += ShooraMs;
+        TotalPixelBytes += (f64)PixelsSize;
+        free(Pixels);
+        Platform_UnmapFile(&File);
+    }
+
+    f32 TotalMB = (f32)(TotalPixelBytes / (1024.0*1024.0));
+#if SHU_USE_STB
+    LogInfo("[JPEG Benchmark]: %u files, %.1fMB of pixels. Shoora %.2fms(%.1fMB/s), stb_image %.2fms(%.1fMB/s).\n",
+            PathCount, TotalMB, TotalShooraMs, TotalMB*1000.0f / MAX(TotalShooraMs, 0.001f), TotalStbMs,
+            TotalMB*1000.0f / MAX(TotalStbMs, 0.001f));
+#else
+    LogInfo("[JPEG Benchmark]: %u files, %.1fMB of pixels. Shoora %.2fms(%.1fMB/s).\n", PathCount, TotalMB,
+            TotalShooraMs, TotalMB*1000.0f / MAX(TotalShooraMs, 0.001f));
+#endif
+}
+
+// NOTE: A file which is only SOI, a DHT segment with the given code counts and EOI. Returns its size.
+static u32
+MakeHuffmanOnlyJPEG(u8 *File, u32 TableId, const u8 *Counts)
+{
+    u32 SymbolCount = 0;
+    for(u32 Length = 0; Length < 16; ++Length)
+    {
+        SymbolCount += Counts[Length];
+    }
+
+    u32 Size = 0;
+    File[Size++] = 0xFF; File[Size++] = JPEGMarker_SOI;
+    File[Size++] = 0xFF; File[Size++] = JPEGMarker_DHT;
+    u32 SegmentSize = 2 + 17 + SymbolCount;
+    File[Size++] = (u8)(SegmentSize >> 8); File[Size++] = (u8)SegmentSize;
+    File[Size++] = (u8)TableId;
+    memcpy(File + Size, Counts, 16);
+    Size += 16;
+    for(u32 Symbol = 0; Symbol < SymbolCount; ++Symbol)
+    {
+        File[Size++] = (u8)Symbol;
+    }
+    File[Size++] = 0xFF; File[Size++] = JPEGMarker_EOI;
+
+    return Size;
+}
+
+void
+jpeg_decoder_test()
+{
+    u8 File[512];
+    jpeg_image_info Info;
+
+    // NOTE: More codes at one length than the length has room for. These used to fill the fast table past its end
+    // before the code space was checked. One length 1 code and three length 2 ones would need codes 0, 10, 11 and 100.
+    const u8 OverfullCounts[][16] =
+    {
+        {200},
+        {1, 3},
+    };
+    for(u32 Case = 0; Case < ARRAY_SIZE(OverfullCounts); ++Case)
+    {
+        // NOTE: The last DC and the last AC table, the ones at the end of the decoder.
+        for(u32 TableId = 0x03; TableId <= 0x13; TableId += 0x10)
+        {
+            u32 Size = MakeHuffmanOnlyJPEG(File, TableId, OverfullCounts[Case]);
+            ASSERT(!GetJPEGInfo(File, Size, &Info));
+            ASSERT(!DecodeJPEG(File, Size, File, sizeof(File)));
+        }
+    }
+
+    // NOTE: Lengths which are exactly full are fine.
+    jpeg_huffman Table;
+    const u8 FullCounts[16] = {1, 1, 2};
+    const u8 Symbols[4] = {0x01, 0x02, 0x03, 0x04};
+    ASSERT(BuildHuffman(&Table, FullCounts, Symbols, ARRAY_SIZE(Symbols), true));
+
+    LogInfo("[JPEG Test]: Passed.\n");
+}
+#endif
@@ -2,6 +2,44 @@
 
 #include <defines.h>
 #include <math/math.h>
+#include "platform/platform.h"
+#include "image_loader.h"
+
+// NOTE: What the frame header says about the image. ChannelCount is 1 for gray and 3 for the color images, which are
+// YCbCr unless an Adobe marker or the component ids say they are RGB.
+struct jpeg_image_info
+{
+    u32 Width;
+    u32 Height;
+    u32 ChannelCount;
+    b32 Progressive;
+    // NOTE: MCUs between the restart markers, 0 if there are none. The intervals are decoded in parallel.
+    u32 RestartInterval;
+};
+
+b32 IsJPEG(const u8 *Data, size_t Size);
+b32 GetJPEGInfo(const u8 *Data, size_t Size, jpeg_image_info *Info);
+
+// NOTE: Decodes a baseline or progressive huffman coded 8 bit JPEG into Out, which has room for
+// Width*Height*ChannelCount bytes. ChannelCount 0 keeps the file's channels, otherwise they are converted the way
+// stb_image does. The chroma is upsampled with the same triangle filter as stb_image's and libjpeg's. CMYK,
+// arithmetic coding, 12 bit and lossless files are not supported.
+b32 DecodeJPEG(const u8 *Data, size_t Size, u8 *Out, size_t OutSize, u32 ChannelCount = 0,
+               b32 FlipVertically = false);
+
+// NOTE: The pixels are malloc'd, FreeJpeg frees them. NumChannels is the file's channel count like stb_image reports
+// it, the data has ChannelCount channels. A file which cannot be decoded gives an image with no data.
+shoora_image_data LoadJPEG(const u8 *Data, size_t Size, b32 FlipVertically = false, u32 ChannelCount = 4);
+shoora_image_data LoadJPEG(const char *Filename, b32 FlipVertically = false, u32 ChannelCount = 4);
+void FreeJpeg(shoora_image_data *ImageData);
+
+#if _SHU_DEBUG
+// NOTE: Decodes every file Iterations times with DecodeJPEG and with stb_image and logs the throughput of both and
+// how far apart their pixels are. They upsample and round a little differently, so they are not bit exact.
+void jpeg_decoder_benchmark(const char **Paths, u32 PathCount, u32 Iterations = 4);
+// NOTE: Checks that broken files which used to run past the decoder's tables are rejected.
+void jpeg_decoder_test();
+#endif
 
 #define JPEG_LOADER_H
-#endif // JPEG_LOADER_H
\ No newline at end of file
+#endif // JPEG_LOADER_H
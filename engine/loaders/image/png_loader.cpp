@@ -1,282 +1,847 @@
 #include "png_loader.h"
+#include "inflate.h"
 
-#if !SHU_USE_STB
-#include <cstdio>
-#include <memory>
+#include <emmintrin.h>
+#include <stdlib.h>
+#include <string.h>
 
-struct shoora_file
-{
-    u32 ContentSize;
-    void *Contents;
-};
+#if _SHU_DEBUG && SHU_USE_STB
+#include <stb_image.h>
+#endif
+
+// NOTE: From https://www.w3.org/TR/2003/REC-PNG-20031110/
+static const u8 PNGSignature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+
+// NOTE: The chunk types are read big endian, so the characters go from the high byte down.
+#define FOURCC(String)                                                                                            \
+    (((u32)(String[0]) << 24) | ((u32)(String[1]) << 16) | ((u32)(String[2]) << 8) | ((u32)(String[3]) << 0))
+
+// NOTE: Bit 5 of the first character is set for the ancillary chunks, which a decoder can skip.
+#define PNG_CHUNK_ANCILLARY_BIT (1u << 29)
+#define PNG_MAX_DIMENSION (1u << 24)
 
-#pragma pack(push, 1)
-// NOTE: From https://www.w3.org/TR/2003/REC-PNG-20031110/#5DataRep
-struct png_header
+enum png_color_type
 {
-    u8 Signature[8];
+    PNGColor_Gray = 0,
+    PNGColor_RGB = 2,
+    PNGColor_Palette = 3,
+    PNGColor_GrayAlpha = 4,
+    PNGColor_RGBA = 6,
 };
-static u8 PNGSignature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
 
-struct png_chunk_header
+enum png_filter_type
 {
-    u32 Length;
-    union
-    {
-        u32 TypeU32;
-        char Type[4];
-    };
+    PNGFilter_None = 0,
+    PNGFilter_Sub = 1,
+    PNGFilter_Up = 2,
+    PNGFilter_Average = 3,
+    PNGFilter_Paeth = 4,
 };
 
-struct png_chunk_footer
+struct png_decoder
 {
-    u32 CRC;
+    png_image_info Info;
+    // NOTE: Samples per pixel in the image data, the palette images have one, the index.
+    u32 SampleCount;
+    u32 PaletteCount;
+    b32 PaletteHasAlpha;
+    b32 HasTransparentKey;
+    u16 TransparentKey[3];
+    u8 Palette[256*4];
+    u32 IdatCount;
 };
 
-struct png_ihdr
+// NOTE: A non interlaced image is one pass over the whole image, an Adam7 one is 7 passes over every StepX'th pixel
+// of every StepY'th row.
+struct png_pass
 {
+    u32 X;
+    u32 Y;
+    u32 StepX;
+    u32 StepY;
     u32 Width;
     u32 Height;
-    u8 BitDepth;
-    u8 ColourType;
-    u8 CompressionMethod;
-    u8 FilterMethod;
-    u8 InterlaceMethod;
+    size_t RowBytes;
 };
 
-struct png_idat_header
+static inline u32
+ReadU32BE(const u8 *At)
 {
-    u8 ZLibMethodFlags;
-    u8 AdditionalFlags;
-};
+    u32 Result = ((u32)At[0] << 24) | ((u32)At[1] << 16) | ((u32)At[2] << 8) | (u32)At[3];
+    return Result;
+}
 
-// NOTE: From https://www.ietf.org/rfc/rfc1950.txt and https://www.ietf.org/rfc/rfc1951.txt
-struct png_idat_zlib_flags
+static inline u16
+ReadU16BE(const u8 *At)
 {
-    u8 CM;
-    u8 CINFO;
-    u8 FCHECK;
-    u8 FDICT;
-    u8 FLEVEL;
-};
+    u16 Result = (u16)((At[0] << 8) | At[1]);
+    return Result;
+}
 
-struct png_idat_footer
+b32
+IsPNG(const u8 *Data, size_t Size)
 {
-    u8 CheckValue;
-};
-#pragma pack(pop)
+    b32 Result = (Data != nullptr) && (Size >= sizeof(PNGSignature)) &&
+                 (memcmp(Data, PNGSignature, sizeof(PNGSignature)) == 0);
+    return Result;
+}
+
+static b32
+ReadHeader(const u8 *Chunk, png_decoder *Decoder)
+{
+    png_image_info *Info = &Decoder->Info;
+    Info->Width = ReadU32BE(Chunk);
+    Info->Height = ReadU32BE(Chunk + 4);
+    Info->BitDepth = Chunk[8];
+    Info->ColorType = Chunk[9];
+    Info->Interlaced = Chunk[12];
+    if(Info->Width == 0 || Info->Height == 0 || Info->Width > PNG_MAX_DIMENSION || Info->Height > PNG_MAX_DIMENSION ||
+       Chunk[10] != 0 || Chunk[11] != 0 || Chunk[12] > 1 || Info->BitDepth > 16)
+    {
+        return false;
+    }
 
-#define FOURCC(String) (((u32)(String[0]) << 0) | ((u32)(String[1]) << 8) | ((u32)(String[2]) << 16) | ((u32)(String[3]) << 24))
+    // NOTE: The bit depths each color type allows, as a mask of 1 << BitDepth.
+    u32 AllowedDepths = 0;
+    switch(Info->ColorType)
+    {
+        case PNGColor_Gray: { Decoder->SampleCount = 1; AllowedDepths = 0x10116; } break;
+        case PNGColor_RGB: { Decoder->SampleCount = 3; AllowedDepths = 0x10100; } break;
+        case PNGColor_Palette: { Decoder->SampleCount = 1; AllowedDepths = 0x00116; } break;
+        case PNGColor_GrayAlpha: { Decoder->SampleCount = 2; AllowedDepths = 0x10100; } break;
+        case PNGColor_RGBA: { Decoder->SampleCount = 4; AllowedDepths = 0x10100; } break;
+    }
 
-shoora_file
-ReadFile(const char *Filename)
+    b32 Result = (AllowedDepths & (1u << Info->BitDepth)) != 0;
+    return Result;
+}
+
+// NOTE: Walks the chunks up to IEND and reads the ones the decoder needs. Idats is filled with the IDAT chunks if it
+// is not null, it has room for as many as a first call with a null one counted.
+static b32
+ParsePNGChunks(const u8 *Data, size_t Size, png_decoder *Decoder, inflate_input *Idats)
 {
-    shoora_file Result = {};
+    if(!IsPNG(Data, Size))
+    {
+        return false;
+    }
+
+    memset(Decoder, 0, sizeof(png_decoder));
+    for(u32 Index = 0; Index < 256; ++Index)
+    {
+        Decoder->Palette[Index*4 + 3] = 255;
+    }
 
-    FILE *In = fopen(Filename, "rb");
-    if(In)
+    const u8 *At = Data + sizeof(PNGSignature);
+    const u8 *End = Data + Size;
+    b32 SeenHeader = false;
+    for(;;)
     {
-        fseek(In, 0, SEEK_END);
-        Result.ContentSize = ftell(In);
-        fseek(In, 0, SEEK_SET);
+        // NOTE: Length, type, the data and the CRC.
+        if(End - At < 12)
+        {
+            return false;
+        }
+        u32 Length = ReadU32BE(At);
+        u32 Type = ReadU32BE(At + 4);
+        const u8 *Chunk = At + 8;
+        if(Length > (size_t)(End - Chunk) - 4)
+        {
+            return false;
+        }
+        At = Chunk + Length + 4;
+
+        if(!SeenHeader && Type != FOURCC("IHDR"))
+        {
+            return false;
+        }
+
+        png_image_info *Info = &Decoder->Info;
+        switch(Type)
+        {
+            case FOURCC("IHDR"):
+            {
+                if(SeenHeader || Length != 13 || !ReadHeader(Chunk, Decoder))
+                {
+                    return false;
+                }
+                SeenHeader = true;
+            } break;
+
+            case FOURCC("PLTE"):
+            {
+                if(Length == 0 || (Length % 3) != 0 || Length > 256*3)
+                {
+                    return false;
+                }
+                Decoder->PaletteCount = Length / 3;
+                for(u32 Index = 0; Index < Decoder->PaletteCount; ++Index)
+                {
+                    memcpy(Decoder->Palette + Index*4, Chunk + Index*3, 3);
+                }
+            } break;
+
+            case FOURCC("tRNS"):
+            {
+                // NOTE: Alpha for the palette entries, or the one gray/RGB value which is transparent. The key of an
+                // 8 bit or lower image only has its low byte compared, like stb_image does it. The color types which
+                // have an alpha channel cannot have one and it is ignored for them.
+                if(Info->ColorType == PNGColor_Palette)
+                {
+                    if(Decoder->PaletteCount == 0 || Length > Decoder->PaletteCount)
+                    {
+                        return false;
+                    }
+                    for(u32 Index = 0; Index < Length; ++Index)
+                    {
+                        Decoder->Palette[Index*4 + 3] = Chunk[Index];
+                    }
+                    Decoder->PaletteHasAlpha = true;
+                }
+                else if(Info->ColorType == PNGColor_Gray || Info->ColorType == PNGColor_RGB)
+                {
+                    if(Length != Decoder->SampleCount*2)
+                    {
+                        return false;
+                    }
+                    u16 Mask = (Info->BitDepth == 16) ? 0xFFFF : 0xFF;
+                    for(u32 Index = 0; Index < Decoder->SampleCount; ++Index)
+                    {
+                        Decoder->TransparentKey[Index] = ReadU16BE(Chunk + Index*2) & Mask;
+                    }
+                    Decoder->HasTransparentKey = true;
+                }
+            } break;
+
+            case FOURCC("IDAT"):
+            {
+                if(Info->ColorType == PNGColor_Palette && Decoder->PaletteCount == 0)
+                {
+                    return false;
+                }
+                if(Idats != nullptr)
+                {
+                    Idats[Decoder->IdatCount] = {Chunk, Length};
+                }
+                ++Decoder->IdatCount;
+            } break;
+
+            case FOURCC("IEND"):
+            {
+                if(Info->ColorType == PNGColor_Palette)
+                {
+                    Info->ChannelCount = Decoder->PaletteHasAlpha ? 4 : 3;
+                }
+                else
+                {
+                    Info->ChannelCount = Decoder->SampleCount + (Decoder->HasTransparentKey ? 1 : 0);
+                }
+                return Decoder->IdatCount > 0;
+            } break;
+
+            default:
+            {
+                // NOTE: A critical chunk this decoder does not know could change how the image is read.
+                if((Type & PNG_CHUNK_ANCILLARY_BIT) == 0)
+                {
+                    return false;
+                }
+            } break;
+        }
+    }
+}
 
-        Result.Contents = malloc(Result.ContentSize);
-        fread(Result.Contents, Result.ContentSize, 1, In);
-        fclose(In);
+b32
+GetPNGInfo(const u8 *Data, size_t Size, png_image_info *Info)
+{
+    png_decoder Decoder;
+    b32 Result = ParsePNGChunks(Data, Size, &Decoder, nullptr);
+    if(Result)
+    {
+        *Info = Decoder.Info;
     }
-    else
+
+    return Result;
+}
+
+static u32
+GetPNGPasses(const png_decoder *Decoder, png_pass *Passes)
+{
+    static const u8 Adam7[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4},
+                                   {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+    static const u8 NoInterlace[1][4] = {{0, 0, 1, 1}};
+
+    const png_image_info &Info = Decoder->Info;
+    const u8 (*Layout)[4] = Info.Interlaced ? Adam7 : NoInterlace;
+    u32 PassCount = Info.Interlaced ? 7 : 1;
+    for(u32 Index = 0; Index < PassCount; ++Index)
     {
-        LogFatal("File %s could not be opened!\n", Filename);
+        png_pass *Pass = Passes + Index;
+        Pass->X = Layout[Index][0];
+        Pass->Y = Layout[Index][1];
+        Pass->StepX = Layout[Index][2];
+        Pass->StepY = Layout[Index][3];
+        Pass->Width = (Info.Width > Pass->X) ? (Info.Width - Pass->X + Pass->StepX - 1) / Pass->StepX : 0;
+        Pass->Height = (Info.Height > Pass->Y) ? (Info.Height - Pass->Y + Pass->StepY - 1) / Pass->StepY : 0;
+        Pass->RowBytes = ((size_t)Pass->Width*Decoder->SampleCount*Info.BitDepth + 7) / 8;
     }
 
+    return PassCount;
+}
+
+// NOTE: The filtered rows, each one behind its filter type byte. A pass with no pixels has no rows at all.
+static inline size_t
+GetPassSize(const png_pass *Pass)
+{
+    size_t Result = (Pass->Width > 0 && Pass->Height > 0) ? Pass->Height*(1 + Pass->RowBytes) : 0;
     return Result;
 }
 
-#define Consume(File, Type) (Type *)ConsumeSize(File, sizeof(Type))
-void *
-ConsumeSize(shoora_file *File, u32 Size)
+// NOTE: Without branches, the predictor changes from byte to byte too often for them to be predicted.
+static inline u8
+PaethPredictor(i32 Left, i32 Up, i32 UpLeft)
 {
-    void *Result = 0;
+    i32 DistanceLeft = abs(Up - UpLeft);
+    i32 DistanceUp = abs(Left - UpLeft);
+    i32 DistanceUpLeft = abs(Up - UpLeft + Left - UpLeft);
+    i32 Result = (DistanceUp <= DistanceUpLeft) ? Up : UpLeft;
+    Result = (DistanceLeft <= DistanceUp && DistanceLeft <= DistanceUpLeft) ? Left : Result;
+    return (u8)Result;
+}
 
-    if(File->ContentSize >= Size)
+// NOTE: One pixel of 2 to 8 bytes in the low lanes of a register. The 3 and 6 byte pixels are put together from
+// their parts, copying them into an 8 byte value on the stack makes the load of it wait for the copy.
+template <u32 BytesPerPixel>
+static inline __m128i
+LoadPixel(const u8 *At)
+{
+    u64 Value;
+    if constexpr(BytesPerPixel == 2)
     {
-        Result = File->Contents;
-        File->Contents = (u8 *)File->Contents + Size;
-        File->ContentSize -= Size;
+        u16 Pixel;
+        memcpy(&Pixel, At, 2);
+        Value = Pixel;
+    }
+    else if constexpr(BytesPerPixel == 3)
+    {
+        u16 Low;
+        memcpy(&Low, At, 2);
+        Value = Low | ((u64)At[2] << 16);
+    }
+    else if constexpr(BytesPerPixel == 4)
+    {
+        u32 Pixel;
+        memcpy(&Pixel, At, 4);
+        Value = Pixel;
+    }
+    else if constexpr(BytesPerPixel == 6)
+    {
+        u32 Low;
+        u16 High;
+        memcpy(&Low, At, 4);
+        memcpy(&High, At + 4, 2);
+        Value = Low | ((u64)High << 32);
     }
     else
     {
-        // LogOutput(!"Invalid Path");
-        File->ContentSize = 0;
+        static_assert(BytesPerPixel == 8);
+        memcpy(&Value, At, 8);
     }
+    return _mm_cvtsi64_si128((i64)Value);
+}
 
-    return Result;
+template <u32 BytesPerPixel>
+static inline void
+StorePixel(u8 *At, __m128i Pixel)
+{
+    u64 Value = (u64)_mm_cvtsi128_si64(Pixel);
+    if constexpr(BytesPerPixel == 2)
+    {
+        u16 Low = (u16)Value;
+        memcpy(At, &Low, 2);
+    }
+    else if constexpr(BytesPerPixel == 3)
+    {
+        u16 Low = (u16)Value;
+        memcpy(At, &Low, 2);
+        At[2] = (u8)(Value >> 16);
+    }
+    else if constexpr(BytesPerPixel == 4)
+    {
+        u32 Low = (u32)Value;
+        memcpy(At, &Low, 4);
+    }
+    else if constexpr(BytesPerPixel == 6)
+    {
+        u32 Low = (u32)Value;
+        u16 High = (u16)(Value >> 32);
+        memcpy(At, &Low, 4);
+        memcpy(At + 4, &High, 2);
+    }
+    else
+    {
+        memcpy(At, &Value, 8);
+    }
 }
 
-void
-EndianSwap(u32 *Val)
+static inline __m128i
+AbsEpi16(__m128i Value)
 {
-    u32 V = *Val;
+#if SHU_MATH_SIMD_SSE
+    return _mm_abs_epi16(Value);
+#else
+    return _mm_max_epi16(Value, _mm_sub_epi16(_mm_setzero_si128(), Value));
+#endif
+}
 
-    u8 B0 = ((V >> 0) & 0xFF);
-    u8 B1 = ((V >> 8) & 0xFF);
-    u8 B2 = ((V >> 16) & 0xFF);
-    u8 B3 = ((V >> 24) & 0xFF);
+// NOTE: A where Mask is set, B where it is not.
+static inline __m128i
+Select(__m128i Mask, __m128i A, __m128i B)
+{
+#if SHU_MATH_SIMD_SSE
+    return _mm_blendv_epi8(B, A, Mask);
+#else
+    return _mm_or_si128(_mm_and_si128(Mask, A), _mm_andnot_si128(Mask, B));
+#endif
+}
 
-    V = ((B0 << 24) | (B1 << 16) | (B2 << 8) | B3);
+// NOTE: Sub, Average and Paeth depend on the pixel to the left, so they go a pixel at a time with all of its bytes in
+// one register. _mm_avg_epu8 rounds up where Average rounds down, they differ by one exactly when the sum is odd.
+// Paeth works in 16 bit lanes so the differences do not overflow, Up - UpLeft and Left - UpLeft are the distances
+// of the Left and the Up predictions and their sum the distance of UpLeft. SSE2 is all this needs, every x64 CPU has
+// it. The abs and the select have single SSE4.1 instructions when the SHU_MATH_SIMD build has it(math/math_simd.h).
+template <u32 BytesPerPixel>
+static void
+UnfilterRowSSE(u32 Filter, u8 *Row, const u8 *Prior, size_t RowBytes)
+{
+    const __m128i Zero = _mm_setzero_si128();
+    __m128i Left = Zero;
+    if(Filter == PNGFilter_Sub)
+    {
+        for(size_t At = 0; At < RowBytes; At += BytesPerPixel)
+        {
+            Left = _mm_add_epi8(LoadPixel<BytesPerPixel>(Row + At), Left);
+            StorePixel<BytesPerPixel>(Row + At, Left);
+        }
+    }
+    else if(Filter == PNGFilter_Average)
+    {
+        const __m128i One = _mm_set1_epi8(1);
+        for(size_t At = 0; At < RowBytes; At += BytesPerPixel)
+        {
+            __m128i Up = LoadPixel<BytesPerPixel>(Prior + At);
+            __m128i Average = _mm_sub_epi8(_mm_avg_epu8(Left, Up), _mm_and_si128(_mm_xor_si128(Left, Up), One));
+            Left = _mm_add_epi8(LoadPixel<BytesPerPixel>(Row + At), Average);
+            StorePixel<BytesPerPixel>(Row + At, Left);
+        }
+    }
+    else
+    {
+        __m128i UpLeft = Zero;
+        for(size_t At = 0; At < RowBytes; At += BytesPerPixel)
+        {
+            __m128i Up = _mm_unpacklo_epi8(LoadPixel<BytesPerPixel>(Prior + At), Zero);
+            __m128i DistanceLeft = _mm_sub_epi16(Up, UpLeft);
+            __m128i DistanceUp = _mm_sub_epi16(Left, UpLeft);
+            __m128i DistanceUpLeft = AbsEpi16(_mm_add_epi16(DistanceLeft, DistanceUp));
+            DistanceLeft = AbsEpi16(DistanceLeft);
+            DistanceUp = AbsEpi16(DistanceUp);
+
+            __m128i Smallest = _mm_min_epi16(DistanceUpLeft, _mm_min_epi16(DistanceLeft, DistanceUp));
+            __m128i Predictor = Select(_mm_cmpeq_epi16(DistanceUp, Smallest), Up, UpLeft);
+            Predictor = Select(_mm_cmpeq_epi16(DistanceLeft, Smallest), Left, Predictor);
+
+            // NOTE: The byte add wraps inside the low byte of each lane, the high bytes stay zero.
+            Left = _mm_add_epi8(_mm_unpacklo_epi8(LoadPixel<BytesPerPixel>(Row + At), Zero), Predictor);
+            StorePixel<BytesPerPixel>(Row + At, _mm_packus_epi16(Left, Left));
+            UpLeft = Up;
+        }
+    }
+}
 
-    *Val = V;
+// NOTE: For the 1 byte pixels, a whole register for one byte does not pay off.
+static void
+UnfilterRowScalar(u32 Filter, u8 *Row, const u8 *Prior, size_t RowBytes, u32 BytesPerPixel)
+{
+    size_t First = MIN((size_t)BytesPerPixel, RowBytes);
+    if(Filter == PNGFilter_Sub)
+    {
+        for(size_t At = First; At < RowBytes; ++At)
+        {
+            Row[At] += Row[At - BytesPerPixel];
+        }
+    }
+    else if(Filter == PNGFilter_Average)
+    {
+        for(size_t At = 0; At < First; ++At)
+        {
+            Row[At] += Prior[At] >> 1;
+        }
+        for(size_t At = First; At < RowBytes; ++At)
+        {
+            Row[At] += (u8)(((u32)Row[At - BytesPerPixel] + (u32)Prior[At]) >> 1);
+        }
+    }
+    else
+    {
+        for(size_t At = 0; At < First; ++At)
+        {
+            Row[At] += Prior[At];
+        }
+        for(size_t At = First; At < RowBytes; ++At)
+        {
+            Row[At] += PaethPredictor(Row[At - BytesPerPixel], Prior[At], Prior[At - BytesPerPixel]);
+        }
+    }
 }
 
-void *
-AllocatePixels(u32 Width, u32 Height, u32 BytesPerPixel)
+// NOTE: Undoes the row's filter in place. Prior is the row above, already unfiltered, or zeros for the first row of a
+// pass. The pixels of the bit depths under 8 are a byte apart for the filters. Up has no dependency between the
+// pixels and goes 16 bytes at a time.
+static b32
+UnfilterRow(u32 Filter, u8 *Row, const u8 *Prior, size_t RowBytes, u32 BytesPerPixel)
 {
-    void *Result = malloc(Width * Height * BytesPerPixel);
-    ASSERT(Result != nullptr);
+    if(Filter > PNGFilter_Paeth)
+    {
+        return false;
+    }
+
+    if(Filter == PNGFilter_Up)
+    {
+        size_t At = 0;
+        for(; At + 16 <= RowBytes; At += 16)
+        {
+            __m128i Value = _mm_add_epi8(_mm_loadu_si128((const __m128i *)(Row + At)),
+                                         _mm_loadu_si128((const __m128i *)(Prior + At)));
+            _mm_storeu_si128((__m128i *)(Row + At), Value);
+        }
+        for(; At < RowBytes; ++At)
+        {
+            Row[At] += Prior[At];
+        }
+    }
+    else if(Filter != PNGFilter_None)
+    {
+        switch(BytesPerPixel)
+        {
+            case 2: { UnfilterRowSSE<2>(Filter, Row, Prior, RowBytes); } break;
+            case 3: { UnfilterRowSSE<3>(Filter, Row, Prior, RowBytes); } break;
+            case 4: { UnfilterRowSSE<4>(Filter, Row, Prior, RowBytes); } break;
+            case 6: { UnfilterRowSSE<6>(Filter, Row, Prior, RowBytes); } break;
+            case 8: { UnfilterRowSSE<8>(Filter, Row, Prior, RowBytes); } break;
+            default: { UnfilterRowScalar(Filter, Row, Prior, RowBytes, BytesPerPixel); } break;
+        }
+    }
 
-    memset(Result, 0, Width * Height * BytesPerPixel);
+    return true;
+}
 
+static inline u32
+GetLowBitSample(const u8 *Row, u32 X, u32 BitDepth)
+{
+    u32 Bit = X*BitDepth;
+    u32 Result = (Row[Bit >> 3] >> (8 - BitDepth - (Bit & 7))) & ((1u << BitDepth) - 1);
     return Result;
 }
 
-void
-FreePixels(void *Memory)
+// NOTE: The row as 8 bit samples in Info.ChannelCount channels, with the palette looked up and the transparent key
+// turned into an alpha channel.
+static void
+ExpandRow(const png_decoder *Decoder, const u8 *Source, u32 Width, u8 *Dest)
 {
-    ASSERT(Memory != nullptr);
-    free(Memory);
-    Memory = nullptr;
+    const png_image_info &Info = Decoder->Info;
+    u32 BitDepth = Info.BitDepth;
+    u32 SampleCount = Decoder->SampleCount;
+    if(Info.ColorType == PNGColor_Palette)
+    {
+        u32 ChannelCount = Info.ChannelCount;
+        for(u32 X = 0; X < Width; ++X)
+        {
+            u32 Index = (BitDepth == 8) ? Source[X] : GetLowBitSample(Source, X, BitDepth);
+            memcpy(Dest + X*ChannelCount, Decoder->Palette + Index*4, ChannelCount);
+        }
+    }
+    else if(BitDepth < 8)
+    {
+        // NOTE: Only gray goes under 8 bits. 1, 2 and 4 bit samples scale to 0-255 by 255, 85 and 17.
+        u32 Scale = 255 / ((1u << BitDepth) - 1);
+        u32 Stride = Decoder->HasTransparentKey ? 2 : 1;
+        for(u32 X = 0; X < Width; ++X)
+        {
+            u32 Sample = GetLowBitSample(Source, X, BitDepth);
+            Dest[X*Stride] = (u8)(Sample*Scale);
+            if(Decoder->HasTransparentKey)
+            {
+                Dest[X*Stride + 1] = (Sample == Decoder->TransparentKey[0]) ? 0 : 255;
+            }
+        }
+    }
+    else if(!Decoder->HasTransparentKey)
+    {
+        // NOTE: 16 bit samples keep their high byte.
+        if(BitDepth == 8)
+        {
+            memcpy(Dest, Source, (size_t)Width*SampleCount);
+        }
+        else
+        {
+            size_t Count = (size_t)Width*SampleCount;
+            for(size_t Index = 0; Index < Count; ++Index)
+            {
+                Dest[Index] = Source[Index*2];
+            }
+        }
+    }
+    else
+    {
+        u32 BytesPerSample = BitDepth / 8;
+        for(u32 X = 0; X < Width; ++X)
+        {
+            const u8 *Pixel = Source + (size_t)X*SampleCount*BytesPerSample;
+            u8 *Out = Dest + (size_t)X*(SampleCount + 1);
+            b32 Transparent = true;
+            for(u32 Sample = 0; Sample < SampleCount; ++Sample)
+            {
+                const u8 *At = Pixel + Sample*BytesPerSample;
+                u32 Value = (BytesPerSample == 2) ? ReadU16BE(At) : At[0];
+                Transparent = Transparent && (Value == Decoder->TransparentKey[Sample]);
+                Out[Sample] = At[0];
+            }
+            Out[SampleCount] = Transparent ? 0 : 255;
+        }
+    }
 }
 
-void
-ParsePNG(shoora_file File)
+static inline u8
+GetLuminance(const u8 *Pixel)
 {
-    shoora_file *At = &File;
-    b32 Supported = false;
+    u8 Result = (u8)(((u32)Pixel[0]*77 + (u32)Pixel[1]*150 + (u32)Pixel[2]*29) >> 8);
+    return Result;
+}
 
-    u8 *DecompressedPixels = nullptr;
+// NOTE: The same conversions as stb_image's. Gray is replicated into RGB, RGB turns to gray by its luminance and a
+// missing alpha is opaque.
+static void
+ConvertChannels(const u8 *Source, u32 SourceCount, u8 *Dest, u32 DestCount, u32 Width)
+{
+    if(SourceCount == DestCount)
+    {
+        memcpy(Dest, Source, (size_t)Width*DestCount);
+        return;
+    }
 
-    LogInfoUnformatted("PNG Headers...\n");
-    png_header *PngHeader = Consume(At, png_header);
-    if(PngHeader)
+    u32 X = 0;
+    switch(SourceCount*8 + DestCount)
     {
-        while(At->ContentSize > 0)
+        case 1*8 + 2: { for(; X < Width; ++X) { Dest[X*2] = Source[X]; Dest[X*2 + 1] = 255; } } break;
+        case 1*8 + 3: { for(; X < Width; ++X) { memset(Dest + X*3, Source[X], 3); } } break;
+        case 1*8 + 4:
+        {
+            for(; X < Width; ++X)
+            {
+                memset(Dest + X*4, Source[X], 3);
+                Dest[X*4 + 3] = 255;
+            }
+        } break;
+        case 2*8 + 1: { for(; X < Width; ++X) { Dest[X] = Source[X*2]; } } break;
+        case 2*8 + 3: { for(; X < Width; ++X) { memset(Dest + X*3, Source[X*2], 3); } } break;
+        case 2*8 + 4:
         {
-            png_chunk_header *ChunkHeader = Consume(At, png_chunk_header);
-            if(ChunkHeader)
+            for(; X < Width; ++X)
             {
-                LogInfo("%c%c%c%c\n", ChunkHeader->Type[0],
-                                      ChunkHeader->Type[1],
-                                      ChunkHeader->Type[2],
-                                      ChunkHeader->Type[3]);
-                EndianSwap(&ChunkHeader->Length);
+                memset(Dest + X*4, Source[X*2], 3);
+                Dest[X*4 + 3] = Source[X*2 + 1];
+            }
+        } break;
+        case 3*8 + 1: { for(; X < Width; ++X) { Dest[X] = GetLuminance(Source + X*3); } } break;
+        case 3*8 + 2: { for(; X < Width; ++X) { Dest[X*2] = GetLuminance(Source + X*3); Dest[X*2 + 1] = 255; } } break;
+        case 3*8 + 4:
+        {
+            // NOTE: The common case, the RGB textures. A pixel at a time as one 4 byte store.
+            for(; X < Width; ++X)
+            {
+                const u8 *Pixel = Source + X*3;
+                u32 Value = (u32)Pixel[0] | ((u32)Pixel[1] << 8) | ((u32)Pixel[2] << 16) | 0xFF000000;
+                memcpy(Dest + X*4, &Value, 4);
+            }
+        } break;
+        case 4*8 + 1: { for(; X < Width; ++X) { Dest[X] = GetLuminance(Source + X*4); } } break;
+        case 4*8 + 2:
+        {
+            for(; X < Width; ++X)
+            {
+                Dest[X*2] = GetLuminance(Source + X*4);
+                Dest[X*2 + 1] = Source[X*4 + 3];
+            }
+        } break;
+        case 4*8 + 3: { for(; X < Width; ++X) { memcpy(Dest + X*3, Source + X*4, 3); } } break;
+        default: { ASSERT(!"Invalid channel conversion!"); } break;
+    }
+}
 
-                void *ChunkData = ConsumeSize(At, ChunkHeader->Length);
-                png_chunk_footer *ChunkFooter = Consume(At, png_chunk_footer);
-                EndianSwap(&ChunkFooter->CRC);
+// NOTE: Expanded is a row of Width*4 bytes for when the row has to be expanded before it is converted.
+static void
+ConvertRow(const png_decoder *Decoder, const u8 *Source, u32 Width, u8 *Expanded, u8 *Dest, u32 ChannelCount)
+{
+    const png_image_info &Info = Decoder->Info;
+    const u8 *Pixels = Source;
+    b32 NeedsExpand = (Info.BitDepth != 8) || (Info.ColorType == PNGColor_Palette) || Decoder->HasTransparentKey;
+    if(NeedsExpand)
+    {
+        if(ChannelCount == Info.ChannelCount)
+        {
+            ExpandRow(Decoder, Source, Width, Dest);
+            return;
+        }
+        ExpandRow(Decoder, Source, Width, Expanded);
+        Pixels = Expanded;
+    }
 
-                switch(ChunkHeader->TypeU32)
-                {
-                    case FOURCC("IHDR"):
-                    {
-                        png_ihdr *IHDR = (png_ihdr *)ChunkData;
-
-                        EndianSwap(&IHDR->Width);
-                        EndianSwap(&IHDR->Height);
-
-                        LogInfo("   Width: %u\n", IHDR->Width);
-                        LogInfo("   Height: %u\n", IHDR->Height);
-                        LogInfo("   BitDepth: %u\n", IHDR->BitDepth);
-                        LogInfo("   ColourType: %u\n", IHDR->ColourType);
-                        LogInfo("   CompressionMethod: %u\n", IHDR->CompressionMethod);
-                        LogInfo("   FilterMethod: %u\n", IHDR->FilterMethod);
-                        LogInfo("   InterlaceMethod: %u\n", IHDR->InterlaceMethod);
-
-                        if (IHDR->BitDepth == 8 &&
-                            IHDR->ColourType == 6 &&
-                            IHDR->CompressionMethod == 0 &&
-                            IHDR->FilterMethod == 0 &&
-                            IHDR->InterlaceMethod == 0)
-                        {
-                            DecompressedPixels = (u8 *)AllocatePixels(IHDR->Width, IHDR->Height, 4);
-                            Supported = true;
-                        }
-                    } break;
-
-                    case FOURCC("iCCP"):
-                    {
+    ConvertChannels(Pixels, Info.ChannelCount, Dest, ChannelCount, Width);
+}
 
-                    } break;
+b32
+DecodePNG(const u8 *Data, size_t Size, u8 *Out, size_t OutSize, u32 ChannelCount, b32 FlipVertically)
+{
+    png_decoder Decoder;
+    if(!ParsePNGChunks(Data, Size, &Decoder, nullptr))
+    {
+        return false;
+    }
 
-                    case FOURCC("bKGD"):
-                    {
+    const png_image_info &Info = Decoder.Info;
+    if(ChannelCount == 0)
+    {
+        ChannelCount = Info.ChannelCount;
+    }
+    size_t OutRowSize = (size_t)Info.Width*ChannelCount;
+    if(ChannelCount > 4 || Out == nullptr || OutRowSize*Info.Height > OutSize)
+    {
+        return false;
+    }
 
-                    } break;
+    png_pass Passes[7];
+    u32 PassCount = GetPNGPasses(&Decoder, Passes);
+    size_t InflatedSize = 0;
+    size_t MaxRowBytes = 0;
+    for(u32 Index = 0; Index < PassCount; ++Index)
+    {
+        InflatedSize += GetPassSize(Passes + Index);
+        MaxRowBytes = MAX(MaxRowBytes, Passes[Index].RowBytes);
+    }
 
-                    case FOURCC("pHYs"):
-                    {
+    // NOTE: The IDAT list, the inflated rows, the zero row above the first row of a pass, a row for the expansion and
+    // one for an interlaced pass' converted pixels, all in one allocation.
+    size_t IdatListSize = Decoder.IdatCount*sizeof(inflate_input);
+    size_t ScratchSize = IdatListSize + InflatedSize + MaxRowBytes + (size_t)Info.Width*4 + OutRowSize;
+    u8 *Scratch = (u8 *)malloc(ScratchSize);
+    if(Scratch == nullptr)
+    {
+        return false;
+    }
+    inflate_input *Idats = (inflate_input *)Scratch;
+    u8 *Inflated = Scratch + IdatListSize;
+    u8 *ZeroRow = Inflated + InflatedSize;
+    u8 *Expanded = ZeroRow + MaxRowBytes;
+    u8 *PassRow = Expanded + (size_t)Info.Width*4;
+    memset(ZeroRow, 0, MaxRowBytes);
+
+    ParsePNGChunks(Data, Size, &Decoder, Idats);
+    size_t Written = 0;
+    b32 Result = ZlibInflate(Idats, Decoder.IdatCount, Inflated, InflatedSize, &Written) && (Written == InflatedSize);
+
+    // NOTE: Each row is converted right after it is unfiltered, while it is still in the cache.
+    u32 BytesPerPixel = MAX(1u, Decoder.SampleCount*Info.BitDepth / 8);
+    const u8 *PassData = Inflated;
+    for(u32 PassIndex = 0; Result && PassIndex < PassCount; ++PassIndex)
+    {
+        const png_pass *Pass = Passes + PassIndex;
+        if(Pass->Width == 0 || Pass->Height == 0)
+        {
+            continue;
+        }
 
-                    } break;
+        const u8 *Prior = ZeroRow;
+        for(u32 Y = 0; Y < Pass->Height; ++Y)
+        {
+            u8 *Row = (u8 *)PassData + Y*(1 + Pass->RowBytes);
+            if(!UnfilterRow(Row[0], Row + 1, Prior, Pass->RowBytes, BytesPerPixel))
+            {
+                Result = false;
+                break;
+            }
+            Prior = Row + 1;
 
-                    case FOURCC("tIME"):
-                    {
+            u32 ImageY = Pass->Y + Y*Pass->StepY;
+            u8 *OutRow = Out + (FlipVertically ? (Info.Height - 1 - ImageY) : ImageY)*OutRowSize;
+            if(PassCount == 1)
+            {
+                ConvertRow(&Decoder, Row + 1, Info.Width, Expanded, OutRow, ChannelCount);
+            }
+            else
+            {
+                ConvertRow(&Decoder, Row + 1, Pass->Width, Expanded, PassRow, ChannelCount);
+                for(u32 X = 0; X < Pass->Width; ++X)
+                {
+                    memcpy(OutRow + (Pass->X + X*Pass->StepX)*ChannelCount, PassRow + X*ChannelCount,
+                           ChannelCount);
+                }
+            }
+        }
 
-                    } break;
+        PassData += GetPassSize(Pass);
+    }
 
-                    case FOURCC("tEXt"):
-                    {
-                        char *Keyword = (char *)ChunkData;
-                        char *String = Keyword;
-                        while(*String++) {}
-                        LogInfo("   %s: %.*s\n", Keyword, (u32)((char *)ChunkFooter - String), String);
-                    } break;
+    free(Scratch);
+    return Result;
+}
 
-                    case FOURCC("IDAT"):
-                    {
-                        if(Supported)
-                        {
-                            LogInfoUnformatted("    Got an IDAT Chunk\n");
-                            png_idat_header *IDATHeader = (png_idat_header *)ChunkData;
-
-                            png_idat_zlib_flags ZlibFlags = {};
-                            ZlibFlags.CM = (IDATHeader->ZLibMethodFlags & 0xF);
-                            ZlibFlags.CINFO = (IDATHeader->ZLibMethodFlags >> 4);
-                            ZlibFlags.FCHECK = (IDATHeader->AdditionalFlags & 0x1F);
-                            ZlibFlags.FDICT = (IDATHeader->AdditionalFlags >> 5) & 0x1;
-                            ZlibFlags.FLEVEL = (IDATHeader->AdditionalFlags >> 6);
-
-                            LogInfo("   CM: %u\n", ZlibFlags.CM);
-                            LogInfo("   CINFO: %u\n", ZlibFlags.CINFO);
-                            LogInfo("   FCHECK: %u\n", ZlibFlags.FCHECK);
-                            LogInfo("   FDICT: %u\n", ZlibFlags.FDICT);
-                            LogInfo("   FLEVEL: %u\n", ZlibFlags.FLEVEL);
-
-                            int x = 0;
-                        }
-                    } break;
-
-                    case FOURCC("IEND"):
-                    {
+shoora_image_data
+LoadPNG(const u8 *Data, size_t Size, b32 FlipVertically, u32 ChannelCount)
+{
+    shoora_image_data ImageData = {};
 
-                    } break;
-                }
-            }
+    png_image_info Info;
+    if(GetPNGInfo(Data, Size, &Info))
+    {
+        u32 OutChannelCount = (ChannelCount != 0) ? ChannelCount : Info.ChannelCount;
+        size_t PixelsSize = (size_t)Info.Width*Info.Height*OutChannelCount;
+        u8 *Pixels = (u8 *)malloc(PixelsSize);
+        if(Pixels != nullptr && DecodePNG(Data, Size, Pixels, PixelsSize, OutChannelCount, FlipVertically))
+        {
+            ImageData.Dim = shu::vec2i{(i32)Info.Width, (i32)Info.Height};
+            ImageData.NumChannels = (i32)Info.ChannelCount;
+            ImageData.TotalSize = (u32)PixelsSize;
+            ImageData.Data = Pixels;
+        }
+        else
+        {
+            free(Pixels);
         }
     }
 
-    LogInfo("SUPPORTED: %s\n", Supported ? "TRUE" : "FALSE");
-
-    free(DecompressedPixels);
+    return ImageData;
 }
 
 shoora_image_data
-LoadPNG(const char *Filename)
+LoadPNG(const char *Filename, b32 FlipVertically, u32 ChannelCount)
 {
-    LogInfo("Parsing %s...\n", Filename);
     shoora_image_data ImageData = {};
 
-    ParsePNG(ReadFile(Filename));
-    int x = 0;
+    platform_mapped_file File = Platform_MapFile(Filename);
+    if(File.Data == nullptr)
+    {
+        LogError("PNG file %s could not be opened!\n", Filename);
+        return ImageData;
+    }
 
+    ImageData = LoadPNG((const u8 *)File.Data, File.Size, FlipVertically, ChannelCount);
+    if(ImageData.Data == nullptr)
+    {
+        LogError("PNG file %s could not be decoded!\n", Filename);
+    }
+
+    Platform_UnmapFile(&File);
     return ImageData;
 }
 
@@ -287,8 +852,90 @@ FreePng(shoora_image_data *ImageData)
 
     free(ImageData->Data);
     ImageData->Data = nullptr;
-    ImageData->Dim.Width = 0;
-    ImageData->Dim.Height = 0;
+    ImageData->Dim.w = 0;
+    ImageData->Dim.h = 0;
     ImageData->NumChannels = 0;
 }
-#endif
\ No newline at end of file
+
+#if _SHU_DEBUG
+static inline f32
+PNGBenchmarkMs(u64 Start)
+{
+    return 1000.0f * Platform_GetSecondsElapsed(Start, Platform_GetWallClock());
+}
+
+// NOTE: Both decode to RGBA from the file already in memory, so only the decode is timed. MB/s is of the decoded
+// pixels.
+void
+png_decoder_benchmark(const char **Paths, u32 PathCount, u32 Iterations)
+{
+    f64 TotalPixelBytes = 0.0;
+    f32 TotalShooraMs = 0.0f;
+    f32 TotalStbMs = 0.0f;
+    for(u32 PathIndex = 0; PathIndex < PathCount; ++PathIndex)
+    {
+        platform_mapped_file File = Platform_MapFile(Paths[PathIndex]);
+        png_image_info Info;
+        if(File.Data == nullptr || !GetPNGInfo((const u8 *)File.Data, File.Size, &Info))
+        {
+            LogWarn("[PNG Benchmark]: %s is not a PNG file, skipping it.\n", Paths[PathIndex]);
+            if(File.Data != nullptr)
+            {
+                Platform_UnmapFile(&File);
+            }
+            continue;
+        }
+
+        size_t PixelsSize = (size_t)Info.Width*Info.Height*4;
+        u8 *Pixels = (u8 *)malloc(PixelsSize);
+        b32 Decoded = true;
+        u64 Start = Platform_GetWallClock();
+        for(u32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Decoded = DecodePNG((const u8 *)File.Data, File.Size, Pixels, PixelsSize, 4) && Decoded;
+        }
+        f32 ShooraMs = PNGBenchmarkMs(Start) / Iterations;
+        f32 PixelMB = (f32)PixelsSize / (1024.0f*1024.0f);
+
+#if SHU_USE_STB
+        b32 Matches = false;
+        Start = Platform_GetWallClock();
+        for(u32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            i32 Width, Height, FileChannelCount;
+            u8 *StbPixels = stbi_load_from_memory((const u8 *)File.Data, (i32)File.Size, &Width, &Height,
+                                                  &FileChannelCount, 4);
+            Matches = (StbPixels != nullptr) && (memcmp(StbPixels, Pixels, PixelsSize) == 0);
+            stbi_image_free(StbPixels);
+        }
+        f32 StbMs = PNGBenchmarkMs(Start) / Iterations;
+
+        LogInfo("[PNG Benchmark]: %s %ux%u(color type %u, %u bits): %.2fms %.1fMB/s, stb_image %.2fms %.1fMB/s, "
+                "%.2fx. Pixels %s.\n",
+                Paths[PathIndex], Info.Width, Info.Height, Info.ColorType, Info.BitDepth, ShooraMs,
+                PixelMB*1000.0f / ShooraMs, StbMs, PixelMB*1000.0f / StbMs, StbMs / ShooraMs,
+                (Decoded && Matches) ? "match" : "DIFFER");
+        TotalStbMs += StbMs;
+#else
+        LogInfo("[PNG Benchmark]: %s %ux%u(color type %u, %u bits): %.2fms %.1fMB/s%s.\n", Paths[PathIndex],
+                Info.Width, Info.Height, Info.ColorType, Info.BitDepth, ShooraMs, PixelMB*1000.0f / ShooraMs,
+                Decoded ? "" : ", FAILED");
+#endif
+
+        TotalShooraMs += ShooraMs;
+        TotalPixelBytes += (f64)PixelsSize;
+        free(Pixels);
+        Platform_UnmapFile(&File);
+    }
+
+    f32 TotalMB = (f32)(TotalPixelBytes / (1024.0*1024.0));
+#if SHU_USE_STB
+    LogInfo("[PNG Benchmark]: %u files, %.1fMB of pixels. Shoora %.2fms(%.1fMB/s), stb_image %.2fms(%.1fMB/s).\n",
+            PathCount, TotalMB, TotalShooraMs, TotalMB*1000.0f / MAX(TotalShooraMs, 0.001f), TotalStbMs,
+            TotalMB*1000.0f / MAX(TotalStbMs, 0.001f));
+#else
+    LogInfo("[PNG Benchmark]: %u files, %.1fMB of pixels. Shoora %.2fms(%.1fMB/s).\n", PathCount, TotalMB,
+            TotalShooraMs, TotalMB*1000.0f / MAX(TotalShooraMs, 0.001f));
+#endif
+}
+#endif
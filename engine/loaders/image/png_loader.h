@@ -4,10 +4,39 @@
 #include "platform/platform.h"
 #include "image_loader.h"
 
-#if !SHU_USE_STB
-shoora_image_data LoadPNG(const char *Filename);
+// NOTE: What the IHDR chunk says about the image. ChannelCount is the channels in the file, a palette's are the
+// palette's, and a tRNS chunk counts as an alpha channel.
+struct png_image_info
+{
+    u32 Width;
+    u32 Height;
+    u32 ChannelCount;
+    u32 BitDepth;
+    u32 ColorType;
+    b32 Interlaced;
+};
+
+b32 IsPNG(const u8 *Data, size_t Size);
+b32 GetPNGInfo(const u8 *Data, size_t Size, png_image_info *Info);
+
+// NOTE: Decodes into Out, which has room for Width*Height*ChannelCount bytes. ChannelCount 0 keeps the file's channels,
+// otherwise they are converted the way stb_image does. The samples are always 8 bits, 16 bit ones keep their high
+// byte and the 1, 2 and 4 bit ones are scaled up to 0-255. Every color type, bit depth and Adam7 interlacing is
+// supported. The chunk CRCs are not checked.
+b32 DecodePNG(const u8 *Data, size_t Size, u8 *Out, size_t OutSize, u32 ChannelCount = 0,
+              b32 FlipVertically = false);
+
+// NOTE: The pixels are malloc'd, FreePng frees them. NumChannels is the file's channel count like stb_image reports it,
+// the data has ChannelCount channels. A file which cannot be decoded gives an image with no data.
+shoora_image_data LoadPNG(const u8 *Data, size_t Size, b32 FlipVertically = false, u32 ChannelCount = 4);
+shoora_image_data LoadPNG(const char *Filename, b32 FlipVertically = false, u32 ChannelCount = 4);
 void FreePng(shoora_image_data *ImageData);
+
+#if _SHU_DEBUG
+// NOTE: Decodes every file Iterations times with DecodePNG and with stb_image and logs the throughput of both and
+// whether they decoded the same pixels.
+void png_decoder_benchmark(const char **Paths, u32 PathCount, u32 Iterations = 4);
 #endif
 
 #define PNG_LOADER_H
-#endif // PNG_LOADER_H
\ No newline at end of file
+#endif // PNG_LOADER_H
@@ -0,0 +1,482 @@
+#include "mesh_binary.h"
+
+#include <platform/platform.h>
+#include <utils/utils.h>
+#include <memory/memory.h>
+#include <renderer/vulkan/vulkan_vertex_definitions.h>
+#include <mesh/vertex_packing.h>
+
+static inline u64
+AlignOffset(u64 Offset, u64 Alignment)
+{
+    u64 Result = (Offset + Alignment - 1) & ~(Alignment - 1);
+    return Result;
+}
+
+// NOTE: The sizes every section has to have for the counts in the header. The strings can be any size.
+static void
+GetMeshFileSectionSizes(const shoora_mesh_file_header *Header, u64 *Sizes)
+{
+    Sizes[MeshFileSection_Vertices] = (u64)Header->VertexCount*sizeof(shoora_vertex_info);
+    Sizes[MeshFileSection_Indices] = (u64)Header->IndexCount*sizeof(u32);
+    Sizes[MeshFileSection_Primitives] = (u64)Header->PrimitiveCount*sizeof(shoora_mesh_primitive);
+    Sizes[MeshFileSection_Nodes] = (u64)Header->NodeCount*sizeof(shoora_mesh_file_node);
+    Sizes[MeshFileSection_ChildIndices] = (u64)(Header->NodeCount - Header->RootNodeCount)*sizeof(u32);
+    Sizes[MeshFileSection_RootIndices] = (u64)Header->RootNodeCount*sizeof(u32);
+    Sizes[MeshFileSection_Materials] = (u64)Header->MaterialCount*sizeof(shoora_mesh_file_material);
+    Sizes[MeshFileSection_Textures] = (u64)Header->TextureCount*sizeof(u32);
+    Sizes[MeshFileSection_Strings] = 0;
+    shoora_vertex_format VertexFormat = (shoora_vertex_format)Header->VertexFormat;
+    Sizes[MeshFileSection_PackedVertices] = (VertexFormat != VertexFormat_Full) ?
+                                            (u64)Header->VertexCount*GetVertexFormatSize(VertexFormat) : 0;
+}
+
+struct mesh_file_string_writer
+{
+    char *Base;
+    u32 Used;
+};
+
+static u32
+WriteMeshFileString(mesh_file_string_writer *Writer, const char *String)
+{
+    u32 Result = SHOORA_MESH_FILE_NO_STRING;
+    if(String != nullptr)
+    {
+        u32 Length = (u32)strlen(String);
+        Result = Writer->Used;
+        if(Writer->Base != nullptr)
+        {
+            memcpy(Writer->Base + Writer->Used, String, Length + 1);
+        }
+        Writer->Used += Length + 1;
+    }
+
+    return Result;
+}
+
+// NOTE: Run once without a Base to size the strings section, then again to write it. Both runs hand out the same
+// offsets.
+static void
+WriteMeshFileStrings(const shoora_model *Model, mesh_file_string_writer *Writer, shoora_mesh_file_node *Nodes,
+                     shoora_mesh_file_material *Materials, u32 *Textures)
+{
+    for(u32 NodeIndex = 0; NodeIndex < Model->AllNodeCount; ++NodeIndex)
+    {
+        u32 Offset = WriteMeshFileString(Writer, Model->AllNodes[NodeIndex].Name);
+        if(Nodes) { Nodes[NodeIndex].NameOffset = Offset; }
+    }
+    for(u32 MatIndex = 0; MatIndex < Model->MaterialCount; ++MatIndex)
+    {
+        string_id NameId = Model->Materials[MatIndex].NameId;
+        u32 Offset = WriteMeshFileString(Writer, (NameId != STRING_ID_NONE) ? GetInternedString(NameId) : nullptr);
+        if(Materials) { Materials[MatIndex].NameOffset = Offset; }
+    }
+    for(u32 TexIndex = 0; TexIndex < Model->TextureCount; ++TexIndex)
+    {
+        u32 Offset = WriteMeshFileString(Writer, Model->Textures[TexIndex].ImageFilename);
+        if(Textures) { Textures[TexIndex] = Offset; }
+    }
+}
+
+b32
+SaveModelBinary(const shoora_model *Model, const char *Path)
+{
+    ASSERT(Model->AllNodes != nullptr || Model->AllNodeCount == 0);
+
+    shoora_mesh_file_header Header = {};
+    Header.Magic = SHOORA_MESH_FILE_MAGIC;
+    Header.Version = SHOORA_MESH_FILE_VERSION;
+    Header.VertexSize = sizeof(shoora_vertex_info);
+    Header.PrimitiveSize = sizeof(shoora_mesh_primitive);
+    Header.VertexCount = Model->MeshFilter.VertexCount;
+    Header.IndexCount = Model->MeshFilter.IndexCount;
+    Header.NodeCount = Model->AllNodeCount;
+    Header.RootNodeCount = Model->NodeCount;
+    Header.MaterialCount = Model->MaterialCount;
+    Header.TextureCount = Model->TextureCount;
+    Header.VertexFormat = (u32)Model->MeshFilter.PackedFormat;
+    Header.PositionDequant = Model->MeshFilter.PositionDequant;
+    for(u32 NodeIndex = 0; NodeIndex < Model->AllNodeCount; ++NodeIndex)
+    {
+        Header.PrimitiveCount += Model->AllNodes[NodeIndex].PrimitiveCount;
+    }
+
+    mesh_file_string_writer StringWriter = {};
+    WriteMeshFileStrings(Model, &StringWriter, nullptr, nullptr, nullptr);
+
+    u64 Sizes[MeshFileSection_Count];
+    GetMeshFileSectionSizes(&Header, Sizes);
+    Sizes[MeshFileSection_Strings] = StringWriter.Used;
+
+    // NOTE: The indices come right after the vertices, so the renderer can stage both with one copy.
+    u64 Offset = AlignOffset(sizeof(shoora_mesh_file_header), SHOORA_MESH_FILE_VERTEX_ALIGNMENT);
+    for(u32 SectionIndex = 0; SectionIndex < MeshFileSection_Count; ++SectionIndex)
+    {
+        if(SectionIndex == MeshFileSection_PackedVertices && Sizes[SectionIndex] > 0)
+        {
+            Offset = AlignOffset(Offset, SHOORA_MESH_FILE_VERTEX_ALIGNMENT);
+        }
+        else if(SectionIndex != MeshFileSection_Vertices)
+        {
+            Offset = AlignOffset(Offset, SHOORA_MESH_FILE_SECTION_ALIGNMENT);
+        }
+        Header.Sections[SectionIndex].Offset = Offset;
+        Header.Sections[SectionIndex].Size = Sizes[SectionIndex];
+        Offset += Sizes[SectionIndex];
+    }
+    Header.FileSize = Offset;
+
+    if(Header.FileSize > 0xFFFFFFFF)
+    {
+        LogError("%s is too big for a baked mesh file.\n", Path);
+        return false;
+    }
+
+    u8 *File = (u8 *)malloc(Header.FileSize);
+    ASSERT(File != nullptr);
+    memset(File, 0, Header.FileSize);
+    memcpy(File, &Header, sizeof(Header));
+
+    const shoora_mesh_filter *MeshFilter = &Model->MeshFilter;
+    memcpy(File + Header.Sections[MeshFileSection_Vertices].Offset, MeshFilter->Vertices,
+           Sizes[MeshFileSection_Vertices]);
+    memcpy(File + Header.Sections[MeshFileSection_Indices].Offset, MeshFilter->Indices,
+           Sizes[MeshFileSection_Indices]);
+    if(MeshFilter->PackedVertices != nullptr)
+    {
+        memcpy(File + Header.Sections[MeshFileSection_PackedVertices].Offset, MeshFilter->PackedVertices,
+               Sizes[MeshFileSection_PackedVertices]);
+    }
+
+    const shoora_mesh_file_section *Sections = Header.Sections;
+    shoora_mesh_primitive *Primitives = (shoora_mesh_primitive *)(File + Sections[MeshFileSection_Primitives].Offset);
+    shoora_mesh_file_node *Nodes = (shoora_mesh_file_node *)(File + Sections[MeshFileSection_Nodes].Offset);
+    u32 *ChildIndices = (u32 *)(File + Sections[MeshFileSection_ChildIndices].Offset);
+    u32 *RootIndices = (u32 *)(File + Sections[MeshFileSection_RootIndices].Offset);
+    shoora_mesh_file_material *Materials =
+        (shoora_mesh_file_material *)(File + Sections[MeshFileSection_Materials].Offset);
+    u32 *Textures = (u32 *)(File + Sections[MeshFileSection_Textures].Offset);
+
+    u32 PrimitiveCount = 0;
+    u32 ChildIndexCount = 0;
+    for(u32 NodeIndex = 0; NodeIndex < Model->AllNodeCount; ++NodeIndex)
+    {
+        const shoora_mesh_cgltf_node *Node = Model->AllNodes + NodeIndex;
+        shoora_mesh_file_node *FileNode = Nodes + NodeIndex;
+        FileNode->ModelMatrix = Node->ModelMatrix;
+        FileNode->WorldMatrix = Node->WorldMatrix;
+        FileNode->ParentIndex = Node->ParentNode ? (i32)(Node->ParentNode - Model->AllNodes) : -1;
+
+        FileNode->FirstChild = ChildIndexCount;
+        FileNode->ChildCount = Node->ChildrenCount;
+        for(u32 ChildIndex = 0; ChildIndex < Node->ChildrenCount; ++ChildIndex)
+        {
+            ChildIndices[ChildIndexCount++] = (u32)(Node->ChildNodes[ChildIndex] - Model->AllNodes);
+        }
+
+        FileNode->FirstPrimitive = PrimitiveCount;
+        FileNode->PrimitiveCount = Node->PrimitiveCount;
+        if(Node->PrimitiveCount > 0)
+        {
+            memcpy(Primitives + PrimitiveCount, Node->Primitives, Node->PrimitiveCount*sizeof(shoora_mesh_primitive));
+            PrimitiveCount += Node->PrimitiveCount;
+        }
+    }
+    ASSERT(PrimitiveCount == Header.PrimitiveCount);
+    ASSERT(ChildIndexCount == Header.NodeCount - Header.RootNodeCount);
+
+    for(u32 RootIndex = 0; RootIndex < Model->NodeCount; ++RootIndex)
+    {
+        RootIndices[RootIndex] = (u32)(Model->Nodes[RootIndex] - Model->AllNodes);
+    }
+
+    for(u32 MatIndex = 0; MatIndex < Model->MaterialCount; ++MatIndex)
+    {
+        const shoora_mesh_material *Mat = Model->Materials + MatIndex;
+        shoora_mesh_file_material *FileMat = Materials + MatIndex;
+        FileMat->BaseColorFactor = Mat->BaseColorFactor;
+        FileMat->BaseColorTextureIndex = Mat->BaseColorTextureIndex;
+        FileMat->NormalTextureIndex = Mat->NormalTextureIndex;
+        FileMat->MetallicTextureIndex = Mat->MetallicTextureIndex;
+        FileMat->AlphaCutoff = Mat->AlphaCutoff;
+        FileMat->DoubleSided = Mat->DoubleSided ? 1 : 0;
+        FileMat->AlphaMode = (u32)Mat->AlphaMode;
+    }
+
+    StringWriter.Base = (char *)(File + Header.Sections[MeshFileSection_Strings].Offset);
+    StringWriter.Used = 0;
+    WriteMeshFileStrings(Model, &StringWriter, Nodes, Materials, Textures);
+
+    b32 Result = Platform_WriteFile(const_cast<char *>(Path), (u32)Header.FileSize, File);
+    free(File);
+
+    return Result;
+}
+
+// NOTE: Checks everything the loader follows, so a broken or stale file can not send it out of the mapped range. The
+// index values are not looked at, that would touch every page of them.
+static b32
+ValidateMeshFile(const u8 *File, u64 FileSize)
+{
+    if(FileSize < sizeof(shoora_mesh_file_header))
+    {
+        return false;
+    }
+
+    const shoora_mesh_file_header *Header = (const shoora_mesh_file_header *)File;
+    if(Header->Magic != SHOORA_MESH_FILE_MAGIC || Header->Version != SHOORA_MESH_FILE_VERSION ||
+       Header->VertexSize != sizeof(shoora_vertex_info) || Header->PrimitiveSize != sizeof(shoora_mesh_primitive) ||
+       Header->FileSize != FileSize || Header->RootNodeCount > Header->NodeCount ||
+       Header->VertexFormat >= VertexFormat_Count)
+    {
+        return false;
+    }
+
+    u64 Sizes[MeshFileSection_Count];
+    GetMeshFileSectionSizes(Header, Sizes);
+    for(u32 SectionIndex = 0; SectionIndex < MeshFileSection_Count; ++SectionIndex)
+    {
+        const shoora_mesh_file_section *Section = Header->Sections + SectionIndex;
+        if((SectionIndex != MeshFileSection_Strings && Section->Size != Sizes[SectionIndex]) ||
+           (Section->Offset % 16) != 0 || Section->Offset > FileSize || Section->Size > FileSize - Section->Offset)
+        {
+            return false;
+        }
+    }
+
+    const shoora_mesh_file_section *StringSection = Header->Sections + MeshFileSection_Strings;
+    const char *Strings = (const char *)(File + StringSection->Offset);
+    if(StringSection->Size > 0 && Strings[StringSection->Size - 1] != '\0')
+    {
+        return false;
+    }
+    auto IsValidString = [StringSection](u32 Offset) {
+        return Offset == SHOORA_MESH_FILE_NO_STRING || Offset < StringSection->Size;
+    };
+
+    const shoora_mesh_primitive *Primitives =
+        (const shoora_mesh_primitive *)(File + Header->Sections[MeshFileSection_Primitives].Offset);
+    for(u32 PrimitiveIndex = 0; PrimitiveIndex < Header->PrimitiveCount; ++PrimitiveIndex)
+    {
+        const shoora_mesh_primitive *Primitive = Primitives + PrimitiveIndex;
+        // NOTE: Primitives without a material use material 0, even when there are no materials.
+        if(Primitive->FirstIndex > Header->IndexCount ||
+           Primitive->IndexCount > Header->IndexCount - Primitive->FirstIndex || Primitive->MaterialIndex < 0 ||
+           (Primitive->MaterialIndex > 0 && (u32)Primitive->MaterialIndex >= Header->MaterialCount))
+        {
+            return false;
+        }
+    }
+
+    const shoora_mesh_file_node *Nodes =
+        (const shoora_mesh_file_node *)(File + Header->Sections[MeshFileSection_Nodes].Offset);
+    const u32 *ChildIndices = (const u32 *)(File + Header->Sections[MeshFileSection_ChildIndices].Offset);
+    const u32 ChildIndexCount = Header->NodeCount - Header->RootNodeCount;
+    for(u32 NodeIndex = 0; NodeIndex < Header->NodeCount; ++NodeIndex)
+    {
+        const shoora_mesh_file_node *Node = Nodes + NodeIndex;
+        if(!IsValidString(Node->NameOffset) || Node->ParentIndex >= (i32)NodeIndex || Node->ParentIndex < -1 ||
+           Node->FirstChild > ChildIndexCount || Node->ChildCount > ChildIndexCount - Node->FirstChild ||
+           Node->FirstPrimitive > Header->PrimitiveCount ||
+           Node->PrimitiveCount > Header->PrimitiveCount - Node->FirstPrimitive)
+        {
+            return false;
+        }
+        for(u32 ChildIndex = 0; ChildIndex < Node->ChildCount; ++ChildIndex)
+        {
+            u32 Child = ChildIndices[Node->FirstChild + ChildIndex];
+            if(Child >= Header->NodeCount || Nodes[Child].ParentIndex != (i32)NodeIndex)
+            {
+                return false;
+            }
+        }
+    }
+
+    const u32 *RootIndices = (const u32 *)(File + Header->Sections[MeshFileSection_RootIndices].Offset);
+    for(u32 RootIndex = 0; RootIndex < Header->RootNodeCount; ++RootIndex)
+    {
+        if(RootIndices[RootIndex] >= Header->NodeCount || Nodes[RootIndices[RootIndex]].ParentIndex != -1)
+        {
+            return false;
+        }
+    }
+
+    const shoora_mesh_file_material *Materials =
+        (const shoora_mesh_file_material *)(File + Header->Sections[MeshFileSection_Materials].Offset);
+    const i32 TextureCount = (i32)Header->TextureCount;
+    for(u32 MatIndex = 0; MatIndex < Header->MaterialCount; ++MatIndex)
+    {
+        const shoora_mesh_file_material *Mat = Materials + MatIndex;
+        if(!IsValidString(Mat->NameOffset) || Mat->BaseColorTextureIndex >= TextureCount ||
+           Mat->NormalTextureIndex >= TextureCount || Mat->MetallicTextureIndex >= TextureCount ||
+           Mat->AlphaMode >= AlphaMode_MaxCount)
+        {
+            return false;
+        }
+    }
+
+    const u32 *Textures = (const u32 *)(File + Header->Sections[MeshFileSection_Textures].Offset);
+    for(u32 TexIndex = 0; TexIndex < Header->TextureCount; ++TexIndex)
+    {
+        if(Textures[TexIndex] == SHOORA_MESH_FILE_NO_STRING || !IsValidString(Textures[TexIndex]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+LoadModelBinary(shoora_model *Model, const char *Path, b32 LoadImages, shoora_vertex_format VertexFormat)
+{
+    *Model = {};
+
+    platform_mapped_file MappedFile = Platform_MapFile(Path);
+    if(MappedFile.Data == nullptr)
+    {
+        LogError("Could not map the mesh file %s.\n", Path);
+        ASSERT(!"Could not map the mesh file!");
+        return;
+    }
+
+    const u8 *File = (const u8 *)MappedFile.Data;
+    if(!ValidateMeshFile(File, MappedFile.Size))
+    {
+        LogError("%s is not a baked mesh file of version %d, bake it again.\n", Path, SHOORA_MESH_FILE_VERSION);
+        Platform_UnmapFile(&MappedFile);
+        ASSERT(!"Invalid baked mesh file!");
+        return;
+    }
+    Model->MappedFile = MappedFile;
+
+    const shoora_mesh_file_header *Header = (const shoora_mesh_file_header *)File;
+    const char *Strings = (const char *)(File + Header->Sections[MeshFileSection_Strings].Offset);
+    auto GetString = [Strings](u32 Offset) {
+        return (Offset != SHOORA_MESH_FILE_NO_STRING) ? (Strings + Offset) : nullptr;
+    };
+
+    // NOTE: The vertices, indices and primitives are used where they are. The copy on write mapping lets the rest of
+    // the engine treat them like any other memory.
+    u8 *MappedBase = (u8 *)MappedFile.Data;
+    shoora_mesh_filter *MeshFilter = &Model->MeshFilter;
+    MeshFilter->Vertices = (shoora_vertex_info *)(MappedBase + Header->Sections[MeshFileSection_Vertices].Offset);
+    MeshFilter->VertexCount = Header->VertexCount;
+    MeshFilter->Indices = (u32 *)(MappedBase + Header->Sections[MeshFileSection_Indices].Offset);
+    MeshFilter->IndexCount = Header->IndexCount;
+    shoora_mesh_primitive *Primitives =
+        (shoora_mesh_primitive *)(MappedBase + Header->Sections[MeshFileSection_Primitives].Offset);
+
+    // NOTE: The packed vertices are only made here when the file was baked in another format.
+    b32 PackedInFile = (Header->VertexFormat == (u32)VertexFormat);
+    size_t PackedVerticesSize = (!PackedInFile && VertexFormat != VertexFormat_Full) ?
+                                (size_t)GetVertexFormatSize(VertexFormat)*Header->VertexCount : 0;
+
+    // NOTE: Only the parts with pointers in them are rebuilt, they are small next to the vertices.
+    size_t ArenaSize = sizeof(shoora_mesh_texture)*Header->TextureCount +
+                       sizeof(shoora_mesh_material)*Header->MaterialCount +
+                       sizeof(shoora_mesh_cgltf_node)*Header->NodeCount +
+                       sizeof(shoora_mesh_cgltf_node *)*Header->NodeCount + PackedVerticesSize + 6*16;
+    Model->Arena.Base = malloc(ArenaSize);
+    Model->Arena.Size = ArenaSize;
+    Model->Arena.Used = 0;
+    ASSERT(Model->Arena.Base != nullptr);
+
+    if(PackedInFile)
+    {
+        MeshFilter->PackedFormat = VertexFormat;
+        MeshFilter->PositionDequant = Header->PositionDequant;
+        MeshFilter->PackedVertices = (VertexFormat != VertexFormat_Full) ?
+                                     (MappedBase + Header->Sections[MeshFileSection_PackedVertices].Offset) : nullptr;
+    }
+    else
+    {
+        void *PackedVertices = nullptr;
+        if(VertexFormat != VertexFormat_Full)
+        {
+            LogWarn("%s was baked with %s vertices, packing them as %s. Bake it in that format to skip this.\n",
+                    Path, GetVertexFormatName((shoora_vertex_format)Header->VertexFormat),
+                    GetVertexFormatName(VertexFormat));
+            PackedVertices = ShuAllocate_(&Model->Arena, PackedVerticesSize, 16);
+        }
+        PackMeshFilter(MeshFilter, VertexFormat, PackedVertices);
+    }
+
+    char BasePath[512];
+    GetBasePath(Path, BasePath);
+
+    const u32 *TextureNames = (const u32 *)(File + Header->Sections[MeshFileSection_Textures].Offset);
+    temporary_memory TempMemory = BeginTemporaryMemory(GetArena(MEMTYPE_THREADFRAME));
+    const char **ImageUris = ShuAllocateArray(const char *, Header->TextureCount, MEMTYPE_THREADFRAME);
+    for(u32 TexIndex = 0; TexIndex < Header->TextureCount; ++TexIndex)
+    {
+        ImageUris[TexIndex] = GetString(TextureNames[TexIndex]);
+    }
+    LoadModelTextures(Model, ImageUris, Header->TextureCount, BasePath, LoadImages);
+    EndTemporaryMemory(TempMemory);
+
+    const shoora_mesh_file_material *FileMaterials =
+        (const shoora_mesh_file_material *)(File + Header->Sections[MeshFileSection_Materials].Offset);
+    Model->MaterialCount = Header->MaterialCount;
+    Model->Materials = (shoora_mesh_material *)ShuAllocate_(&Model->Arena,
+                                                            sizeof(shoora_mesh_material)*Header->MaterialCount, 16);
+    for(u32 MatIndex = 0; MatIndex < Header->MaterialCount; ++MatIndex)
+    {
+        const shoora_mesh_file_material *FileMat = FileMaterials + MatIndex;
+        shoora_mesh_material *Mat = Model->Materials + MatIndex;
+        *Mat = {};
+        const char *Name = GetString(FileMat->NameOffset);
+        Mat->NameId = (Name != nullptr) ? InternString(Name) : STRING_ID_NONE;
+        Mat->BaseColorFactor = FileMat->BaseColorFactor;
+        Mat->BaseColorTextureIndex = FileMat->BaseColorTextureIndex;
+        Mat->NormalTextureIndex = FileMat->NormalTextureIndex;
+        Mat->MetallicTextureIndex = FileMat->MetallicTextureIndex;
+        Mat->AlphaCutoff = FileMat->AlphaCutoff;
+        Mat->DoubleSided = FileMat->DoubleSided;
+        Mat->AlphaMode = (shoora_mesh_alpha_mode)FileMat->AlphaMode;
+    }
+
+    const shoora_mesh_file_node *FileNodes =
+        (const shoora_mesh_file_node *)(File + Header->Sections[MeshFileSection_Nodes].Offset);
+    const u32 *ChildIndices = (const u32 *)(File + Header->Sections[MeshFileSection_ChildIndices].Offset);
+    const u32 *RootIndices = (const u32 *)(File + Header->Sections[MeshFileSection_RootIndices].Offset);
+
+    Model->AllNodeCount = Header->NodeCount;
+    Model->AllNodes = (shoora_mesh_cgltf_node *)ShuAllocate_(&Model->Arena,
+                                                             sizeof(shoora_mesh_cgltf_node)*Header->NodeCount, 16);
+    // NOTE: The child lists and the root list share one block, the same way the child indices are laid out.
+    shoora_mesh_cgltf_node **NodePointers = (shoora_mesh_cgltf_node **)ShuAllocate_(&Model->Arena,
+                                                                                    sizeof(shoora_mesh_cgltf_node *)*
+                                                                                    Header->NodeCount, 16);
+    const u32 ChildIndexCount = Header->NodeCount - Header->RootNodeCount;
+    for(u32 Index = 0; Index < ChildIndexCount; ++Index)
+    {
+        NodePointers[Index] = Model->AllNodes + ChildIndices[Index];
+    }
+
+    for(u32 NodeIndex = 0; NodeIndex < Header->NodeCount; ++NodeIndex)
+    {
+        const shoora_mesh_file_node *FileNode = FileNodes + NodeIndex;
+        shoora_mesh_cgltf_node *Node = Model->AllNodes + NodeIndex;
+        const char *Name = GetString(FileNode->NameOffset);
+        Node->Name = (Name != nullptr) ? GetInternedString(InternString(Name)) : nullptr;
+        Node->ParentNode = (FileNode->ParentIndex >= 0) ? (Model->AllNodes + FileNode->ParentIndex) : nullptr;
+        Node->ChildNodes = NodePointers + FileNode->FirstChild;
+        Node->ChildrenCount = FileNode->ChildCount;
+        Node->ModelMatrix = FileNode->ModelMatrix;
+        Node->WorldMatrix = FileNode->WorldMatrix;
+        Node->Primitives = (FileNode->PrimitiveCount > 0) ? (Primitives + FileNode->FirstPrimitive) : nullptr;
+        Node->PrimitiveCount = FileNode->PrimitiveCount;
+    }
+
+    Model->Nodes = NodePointers + ChildIndexCount;
+    Model->NodeCount = Header->RootNodeCount;
+    for(u32 RootIndex = 0; RootIndex < Header->RootNodeCount; ++RootIndex)
+    {
+        Model->Nodes[RootIndex] = Model->AllNodes + RootIndices[RootIndex];
+    }
+
+    LogInfo("Mapped %s: %d vertices, %d indices, %d nodes.\n", Path, Header->VertexCount, Header->IndexCount,
+            Header->NodeCount);
+}
@@ -0,0 +1,105 @@
+#if !defined(MESH_BINARY_H)
+
+#include <defines.h>
+#include <math/math.h>
+#include "mesh_loader.h"
+
+// NOTE: The baked mesh file. The mesh baker(tools/mesh_baker) loads a glTF file once and writes everything the
+// engine keeps from it in the layout the engine uses, so loading it is a map of the file and a few fixups instead of
+// parsing JSON and converting the vertices one at a time. The vertices, indices and primitives are used straight from
+// the mapped pages. Little endian only. Any change to the layout here or to shoora_vertex_info/shoora_mesh_primitive
+// needs a new SHOORA_MESH_FILE_VERSION, old files then have to be baked again.
+#define SHOORA_MESH_FILE_MAGIC 0x48534853 // NOTE: "SHSH"
+#define SHOORA_MESH_FILE_VERSION 2
+#define SHOORA_MESH_FILE_EXTENSION ".shmesh"
+// NOTE: Every section starts on a cache line, the vertices and the packed vertices start on a page.
+#define SHOORA_MESH_FILE_SECTION_ALIGNMENT 64
+#define SHOORA_MESH_FILE_VERTEX_ALIGNMENT 4096
+#define SHOORA_MESH_FILE_NO_STRING 0xFFFFFFFF
+
+struct shoora_mesh_file_section
+{
+    u64 Offset;
+    u64 Size;
+};
+
+enum shoora_mesh_file_section_type
+{
+    MeshFileSection_Vertices,     // NOTE: shoora_vertex_info[VertexCount]
+    MeshFileSection_Indices,      // NOTE: u32[IndexCount], right after the vertices.
+    MeshFileSection_Primitives,   // NOTE: shoora_mesh_primitive[PrimitiveCount], in node order.
+    MeshFileSection_Nodes,        // NOTE: shoora_mesh_file_node[NodeCount], parents before their children.
+    MeshFileSection_ChildIndices, // NOTE: u32[NodeCount - RootNodeCount], node indices.
+    MeshFileSection_RootIndices,  // NOTE: u32[RootNodeCount], node indices.
+    MeshFileSection_Materials,    // NOTE: shoora_mesh_file_material[MaterialCount]
+    MeshFileSection_Textures,     // NOTE: u32[TextureCount], string offsets of the image uris.
+    MeshFileSection_Strings,      // NOTE: Null terminated strings, one after the other.
+    // NOTE: The vertices in the header's VertexFormat(mesh/vertex_packing.h) for the GPU, empty for
+    // VertexFormat_Full.
+    MeshFileSection_PackedVertices,
+
+    MeshFileSection_Count
+};
+
+struct shoora_mesh_file_header
+{
+    u32 Magic;
+    u32 Version;
+    // NOTE: sizeof(shoora_vertex_info) when the file was baked.
+    u32 VertexSize;
+    u32 PrimitiveSize;
+
+    u32 VertexCount;
+    u32 IndexCount;
+    u32 PrimitiveCount;
+    u32 NodeCount;
+    u32 RootNodeCount;
+    u32 MaterialCount;
+    u32 TextureCount;
+    // NOTE: shoora_vertex_format of the packed vertices.
+    u32 VertexFormat;
+
+    u64 FileSize;
+    shoora_vertex_dequant PositionDequant;
+    shoora_mesh_file_section Sections[MeshFileSection_Count];
+};
+
+struct shoora_mesh_file_node
+{
+    shu::mat4f ModelMatrix;
+    shu::mat4f WorldMatrix;
+    u32 NameOffset;
+    // NOTE: -1 for the root nodes.
+    i32 ParentIndex;
+    u32 FirstChild;
+    u32 ChildCount;
+    u32 FirstPrimitive;
+    u32 PrimitiveCount;
+    u32 Reserved[2];
+};
+
+struct shoora_mesh_file_material
+{
+    shu::vec4f BaseColorFactor;
+    u32 NameOffset;
+    i32 BaseColorTextureIndex;
+    i32 NormalTextureIndex;
+    i32 MetallicTextureIndex;
+    f32 AlphaCutoff;
+    u32 DoubleSided;
+    u32 AlphaMode;
+    u32 Reserved;
+};
+
+// NOTE: LoadModel calls this for paths which end in SHOORA_MESH_FILE_EXTENSION. A file which does not map, is from
+// another version or does not hold together leaves the model empty. The packed vertices come from the file when it
+// was baked in VertexFormat, otherwise they are packed here.
+void LoadModelBinary(shoora_model *Model, const char *Path, b32 LoadImages = true,
+                     shoora_vertex_format VertexFormat = VertexFormat_Full);
+// NOTE: Writes a loaded model out as a baked mesh file, with the packed vertices in the format the model was loaded
+// in. Only the texture names are written, the images stay where they are and are found next to the baked file when
+// it is loaded.
+b32 SaveModelBinary(const shoora_model *Model, const char *Path);
+
+#define MESH_BINARY_H
+#endif // MESH_BINARY_H
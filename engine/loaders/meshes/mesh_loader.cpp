@@ -1,7 +1,12 @@
 #include "mesh_loader.h"
+#include "mesh_binary.h"
 
 #include <platform/platform.h>
 #include <utils/utils.h>
+#include <containers/hashtable/hash_map.h>
+#include <platform/job_system.h>
+#include <memory/memory.h>
+#include <mesh/vertex_packing.h>
 
 #ifndef CGLTF_IMPLEMENTATION
 #define CGLTF_IMPLEMENTATION
@@ -16,32 +21,38 @@
 #include "meshloader/fast_obj.h"
 #endif
 
+// NOTE: The folder of the file with the separator at the end, so the uris in the file can be put right after it.
+// Empty for a file in the working folder.
 void
 GetBasePath(const char *Path, char *BasePath)
 {
-    u32 Pos = shu::StringFindLastOf(Path, '/');
-    shu::StringSubString(Path, 0, Pos, BasePath);
+    const char *Separator = nullptr;
+    for(const char *C = Path; *C != '\0'; ++C)
+    {
+        if(*C == '/' || *C == '\\')
+        {
+            Separator = C;
+        }
+    }
+
+    size_t Length = Separator ? (size_t)(Separator - Path) + 1 : 0;
+    memcpy(BasePath, Path, Length);
+    BasePath[Length] = '\0';
 }
 
+// NOTE: Interned image uri to the index of the texture in the model, only needed while the model is being loaded.
+typedef shoora_hash_map<string_id, u32> texture_lookup;
+
 i32
-GetImageIndex(const char *ImageFilename, shoora_model *Model)
+GetImageIndex(const char *ImageUri, const texture_lookup &TextureLookup)
 {
-    i32 Result = -1;
+    string_id ImageNameId = FindInternedString(ImageUri);
+    ASSERT(ImageNameId != STRING_ID_NONE);
 
-    for(u32 Index = 0;
-        Index < Model->TextureCount;
-        ++Index)
-    {
-        const char *LoadedImageFilename = Model->Textures[Index].ImageFilename;
+    const u32 *Index = TextureLookup.Find(ImageNameId);
+    ASSERT(Index != nullptr);
 
-        if(shu::StringsEqual(ImageFilename, LoadedImageFilename))
-        {
-            Result = Index;
-            break;
-        }
-    }
-
-    ASSERT(Result != -1);
+    i32 Result = (i32)*Index;
     return Result;
 }
 
@@ -56,29 +67,75 @@ Free(void **Data)
 }
 
 void
-LoadTextureImages(cgltf_image *Images, u32 ImageCount, const char *BasePath, shoora_model *Model)
+LoadModelTextures(shoora_model *Model, const char *const *ImageUris, u32 ImageCount, const char *BasePath,
+                  b32 LoadImages)
 {
     Model->TextureCount = ImageCount;
     Model->Textures = nullptr;
     if(ImageCount > 0)
     {
-        Model->Textures = (shoora_mesh_texture *)malloc(sizeof(shoora_mesh_texture)*ImageCount);
+        Model->Textures = (shoora_mesh_texture *)ShuAllocate_(&Model->Arena, sizeof(shoora_mesh_texture)*ImageCount,
+                                                              16);
         memset(Model->Textures, 0, sizeof(shoora_mesh_texture) * ImageCount);
         LogInfoUnformatted("Images are: \n");
 
+        // NOTE: Interned before the decode jobs start, the jobs build the image paths from the interned names.
         for(u32 Index = 0; Index < ImageCount; ++Index)
         {
             shoora_mesh_texture *Tex = Model->Textures + Index;
-            Tex->ImageFilename = Images[Index].uri;
+            Tex->ImageNameId = InternString(ImageUris[Index]);
+            Tex->ImageFilename = GetInternedString(Tex->ImageNameId);
+
+            LogInfo("Image[%d]: %s%s \n", Index, BasePath, ImageUris[Index]);
+        }
 
-            char ImagePath[512];
-            shu::StringConcat(BasePath, Images[Index].uri, ImagePath);
+        if(!LoadImages)
+        {
+            return;
+        }
 
-            // TODO)): Load the Image Data.
-            LogInfo("Image[%d]: %s \n", Index, ImagePath);
+        // NOTE: Decoding is most of the load time for the bigger scenes, every image is its own job. Each job only
+        // writes the texture at its index.
+        shoora_mesh_texture *Textures = Model->Textures;
+        JobSystem_ParallelFor((i32)ImageCount, 1, [Textures, BasePath](i32 First, i32 Last) {
+            for(i32 Index = First; Index < Last; ++Index)
+            {
+                char ImagePath[512];
+                shu::StringConcat(BasePath, Textures[Index].ImageFilename, ImagePath);
+                Textures[Index].ImageData = LoadImageFile(ImagePath, false);
+            }
+        });
 
-            Tex->ImageData = LoadImageFile(ImagePath, false);
-            Model->TotalTextureSize += Tex->ImageData.TotalSize;
+        for(u32 Index = 0; Index < ImageCount; ++Index)
+        {
+            Model->TotalTextureSize += Model->Textures[Index].ImageData.TotalSize;
+        }
+    }
+}
+
+static void
+LoadTextureImages(cgltf_image *Images, u32 ImageCount, const char *BasePath, shoora_model *Model,
+                  texture_lookup &TextureLookup, b32 LoadImages)
+{
+    temporary_memory TempMemory = BeginTemporaryMemory(GetArena(MEMTYPE_THREADFRAME));
+    const char **ImageUris = ShuAllocateArray(const char *, ImageCount, MEMTYPE_THREADFRAME);
+    for(u32 Index = 0; Index < ImageCount; ++Index)
+    {
+        ImageUris[Index] = Images[Index].uri;
+    }
+    LoadModelTextures(Model, ImageUris, ImageCount, BasePath, LoadImages);
+    EndTemporaryMemory(TempMemory);
+
+    // NOTE: TextureLookup is a plain hash map with no lock, so it is filled here on the loading thread after the
+    // decode jobs are done. If two images have the same uri, the first one is used for both.
+    TextureLookup.Reserve(ImageCount);
+    for(u32 Index = 0; Index < ImageCount; ++Index)
+    {
+        b32 Inserted;
+        u32 *LookupIndex = TextureLookup.FindOrInsert(Model->Textures[Index].ImageNameId, &Inserted);
+        if(Inserted)
+        {
+            *LookupIndex = Index;
         }
     }
 }
@@ -94,18 +151,22 @@ static int UsedTexIndices[4096];
 u32 UsedCount = 0;
 
 void
-LoadMaterials(cgltf_material *Materials, u32 MaterialCount, shoora_model *Model)
+LoadMaterials(cgltf_material *Materials, u32 MaterialCount, shoora_model *Model,
+              const texture_lookup &TextureLookup)
 {
     Model->Materials = nullptr;
     Model->MaterialCount = MaterialCount;
 
     if(MaterialCount > 0)
     {
-        Model->Materials = (shoora_mesh_material *)malloc(sizeof(shoora_mesh_material)*MaterialCount);
+        Model->Materials = (shoora_mesh_material *)ShuAllocate_(&Model->Arena,
+                                                                sizeof(shoora_mesh_material)*MaterialCount, 16);
         for(u32 Index = 0; Index < MaterialCount; ++Index)
         {
             cgltf_material *glTFMat = Materials + Index;
             shoora_mesh_material *Mat = Model->Materials + Index;
+            *Mat = {};
+            Mat->NameId = (glTFMat->name != nullptr) ? InternString(glTFMat->name) : STRING_ID_NONE;
 
             cgltf_texture *glTFColorTex = glTFMat->pbr_metallic_roughness.base_color_texture.texture;
             if(glTFMat->has_pbr_metallic_roughness &&
@@ -113,7 +174,7 @@ LoadMaterials(cgltf_material *Materials, u32 MaterialCount, shoora_model *Model)
             {
                 const char* BaseColorTexUri = glTFColorTex->image->uri;
                 ASSERT(BaseColorTexUri);
-                Mat->BaseColorTextureIndex = GetImageIndex(BaseColorTexUri, Model);
+                Mat->BaseColorTextureIndex = GetImageIndex(BaseColorTexUri, TextureLookup);
                 UsedTexIndices[UsedCount++] = Mat->BaseColorTextureIndex;
             }
             else
@@ -127,7 +188,7 @@ LoadMaterials(cgltf_material *Materials, u32 MaterialCount, shoora_model *Model)
             {
                 const char *MetallicRoughnessTex = glTFMetallicTex->image->uri;
                 ASSERT(MetallicRoughnessTex);
-                Mat->MetallicTextureIndex = GetImageIndex(MetallicRoughnessTex, Model);
+                Mat->MetallicTextureIndex = GetImageIndex(MetallicRoughnessTex, TextureLookup);
                 UsedTexIndices[UsedCount++] = Mat->MetallicTextureIndex;
             }
             else
@@ -141,7 +202,7 @@ LoadMaterials(cgltf_material *Materials, u32 MaterialCount, shoora_model *Model)
             {
                 const char *NormalTexUri = glTFNormalTex->image->uri;
                 ASSERT(NormalTexUri);
-                Mat->NormalTextureIndex = GetImageIndex(NormalTexUri, Model);
+                Mat->NormalTextureIndex = GetImageIndex(NormalTexUri, TextureLookup);
                 UsedTexIndices[UsedCount++] = Mat->NormalTextureIndex;
             }
             else
@@ -153,271 +214,314 @@ LoadMaterials(cgltf_material *Materials, u32 MaterialCount, shoora_model *Model)
             Mat->AlphaCutoff = glTFMat->alpha_cutoff;
             Mat->AlphaMode = (shoora_mesh_alpha_mode)glTFMat->alpha_mode;
             Mat->DoubleSided = glTFMat->double_sided;
-            // Mat->BaseColorFactor = GLTFMat->BaseColorFactor;
+            Mat->BaseColorFactor = shu::MakeVec4(glTFMat->pbr_metallic_roughness.base_color_factor);
         }
     }
 }
 
-void
-GetTotalVertexIndicesCount(const cgltf_scene *pScenes, const u32 SceneCount,
-                           u32 *pVertexCount, u32 *pIndexCount, u32 *pNodeCount)
+static void
+GetNodeVertexIndicesCount(const cgltf_node *Node, u32 *pVertexCount, u32 *pIndexCount, u32 *pNodeCount,
+                          u32 *pPrimitiveCount)
 {
-    for(u32 SceneIndex = 0; SceneIndex < SceneCount; ++SceneIndex)
-    {
-        const cgltf_scene *Scene = pScenes + SceneIndex;
+    *pNodeCount += 1;
 
-        *pNodeCount += Scene->nodes_count;
-        for(u32 NodeIndex = 0; NodeIndex < Scene->nodes_count; ++NodeIndex)
+    const cgltf_mesh *NodeMesh = Node->mesh;
+    if(NodeMesh != nullptr)
+    {
+        *pPrimitiveCount += NodeMesh->primitives_count;
+        for(u32 PrimitiveIndex = 0; PrimitiveIndex < NodeMesh->primitives_count; ++PrimitiveIndex)
         {
-            cgltf_node *Node = Scene->nodes[NodeIndex];
-            cgltf_mesh *NodeMesh = Node->mesh;
-            *pNodeCount += Node->children_count;
+            const cgltf_primitive *Primitive = NodeMesh->primitives + PrimitiveIndex;
 
-            for(u32 PrimitiveIndex = 0; PrimitiveIndex < NodeMesh->primitives_count; ++PrimitiveIndex)
+            u32 VertexCount = 0;
+            u32 AttributeCount = Primitive->attributes_count;
+            for(u32 AttrIndex = 0; AttrIndex < AttributeCount; ++AttrIndex)
             {
-                cgltf_primitive *Primitive = NodeMesh->primitives + PrimitiveIndex;
-
-                u32 AttributeCount = Primitive->attributes_count;
-                for(u32 AttrIndex = 0; AttrIndex < AttributeCount; ++AttrIndex)
+                const cgltf_attribute *Attribute = &Primitive->attributes[AttrIndex];
+                if(Attribute->type == cgltf_attribute_type_position)
                 {
-                    const cgltf_attribute *Attribute = &Primitive->attributes[AttrIndex];
-                    if(Attribute->type == cgltf_attribute_type_position)
-                    {
-                        u32 VertexCount = Attribute->data->count;
-                        *pVertexCount += VertexCount;
-                        break;
-                    }
+                    VertexCount = Attribute->data->count;
+                    break;
                 }
-
-                *pIndexCount += Primitive->indices->count;
             }
+
+            *pVertexCount += VertexCount;
+            // NOTE: Primitives without indices get one index per vertex.
+            *pIndexCount += (Primitive->indices != nullptr) ? (u32)Primitive->indices->count : VertexCount;
         }
     }
+
+    for(u32 ChildIndex = 0; ChildIndex < Node->children_count; ++ChildIndex)
+    {
+        GetNodeVertexIndicesCount(Node->children[ChildIndex], pVertexCount, pIndexCount, pNodeCount,
+                                  pPrimitiveCount);
+    }
 }
 
+// NOTE: Counts the whole node tree of every scene. The root node count is the sum of the scenes' nodes_count.
 void
-LoadGLTFNode(cgltf_node *InputNode, cgltf_material *glTFMaterials, shoora_model *Model, shoora_mesh_cgltf_node *Parent)
+GetTotalVertexIndicesCount(const cgltf_scene *pScenes, const u32 SceneCount,
+                           u32 *pVertexCount, u32 *pIndexCount, u32 *pNodeCount, u32 *pPrimitiveCount)
 {
-    cgltf_mesh *NodeMesh = InputNode->mesh;
+    for(u32 SceneIndex = 0; SceneIndex < SceneCount; ++SceneIndex)
+    {
+        const cgltf_scene *Scene = pScenes + SceneIndex;
+        for(u32 NodeIndex = 0; NodeIndex < Scene->nodes_count; ++NodeIndex)
+        {
+            GetNodeVertexIndicesCount(Scene->nodes[NodeIndex], pVertexCount, pIndexCount, pNodeCount,
+                                      pPrimitiveCount);
+        }
+    }
+}
 
-    shoora_mesh_cgltf_node *CurrentNode = (shoora_mesh_cgltf_node *)malloc(sizeof(shoora_mesh_cgltf_node));
-    memset(CurrentNode, 0, sizeof(shoora_mesh_cgltf_node));
+// NOTE: Where the vertices and indices of one primitive go in the mesh filter. The node walk hands these out in
+// order, then the primitives are converted in parallel since none of them overlap.
+struct gltf_primitive_load
+{
+    const cgltf_primitive *Primitive;
+    u32 VertexStart;
+    u32 FirstIndex;
+};
 
-    CurrentNode->Name = InputNode->name;
-    CurrentNode->ParentNode = Parent;
+// NOTE: The node walk takes its nodes, child lists and primitives from these, all of them sized up front.
+struct gltf_node_load_state
+{
+    cgltf_material *glTFMaterials;
 
-    CurrentNode->ModelMatrix = shu::Mat4(1.0f);
-    if(InputNode->has_scale)
-    {
-        CurrentNode->ModelMatrix = shu::Scale(CurrentNode->ModelMatrix, shu::MakeVec3(InputNode->scale));
-    }
-    if(InputNode->has_rotation)
-    {
-        // TODO)): Make quaternion support since gltf contains quaternions for rotation data.
-        i32 x = 0;
-    }
-    if(InputNode->has_translation)
-    {
-        CurrentNode->ModelMatrix = shu::Translate(CurrentNode->ModelMatrix, shu::MakeVec3(InputNode->translation));
-    }
+    shoora_mesh_cgltf_node *NextNode;
+    shoora_mesh_cgltf_node **NextChildNodes;
+    shoora_mesh_primitive *NextPrimitive;
+
+    gltf_primitive_load *PrimitiveLoads;
+    u32 PrimitiveLoadCount;
+
+    u32 VertexCount;
+    u32 IndexCount;
+};
+
+// NOTE: The node's transform relative to its parent. glTF stores the matrix column major for column vectors, which
+// is the same 16 floats as our row major matrix for row vectors, so it is copied as it is.
+static shu::mat4f
+GetGLTFNodeMatrix(const cgltf_node *InputNode)
+{
+    shu::mat4f Result;
     if(InputNode->has_matrix)
     {
-        // TODO)): Read more about what does this? Do I need to calculate the model matrix if the gltf input contains a matrix?
-        i32 x = 0;
+        memcpy(Result.E, InputNode->matrix, sizeof(Result.E));
     }
-
-    if(InputNode->children_count > 0)
+    else
     {
-        for(u32 NodeChildIndex = 0;
-            NodeChildIndex < InputNode->children_count;
-            ++NodeChildIndex)
-        {
-            cgltf_node *ChildNode = InputNode->children[NodeChildIndex];
-            LoadGLTFNode(ChildNode, glTFMaterials, Model, CurrentNode);
-        }
+        shu::vec3f Translation = InputNode->has_translation ? shu::MakeVec3(InputNode->translation) : shu::Vec3f(0.0f);
+        shu::vec3f Scale = InputNode->has_scale ? shu::MakeVec3(InputNode->scale) : shu::Vec3f(1.0f);
+        // NOTE: glTF rotations are x, y, z, w.
+        shu::quat Rotation = InputNode->has_rotation ? shu::Quat(InputNode->rotation[3], InputNode->rotation[0],
+                                                                 InputNode->rotation[1], InputNode->rotation[2])
+                                                     : shu::Quat(1.0f, 0.0f, 0.0f, 0.0f);
+        Result = shu::TRS(Translation, Scale, Rotation);
     }
 
-    CurrentNode->PrimitiveCount = NodeMesh->primitives_count;
-    CurrentNode->Primitives = (shoora_mesh_primitive *)malloc(CurrentNode->PrimitiveCount *
-                                                                   sizeof(shoora_mesh_primitive));
-    memset(CurrentNode->Primitives, 0, sizeof(shoora_mesh_primitive));
+    return Result;
+}
 
-    shoora_mesh_filter *MeshFilter = &Model->MeshFilter;
+void
+LoadGLTFNode(cgltf_node *InputNode, shoora_model *Model, shoora_mesh_cgltf_node *Parent,
+             gltf_node_load_state *State)
+{
+    shoora_mesh_cgltf_node *CurrentNode = State->NextNode++;
+    memset(CurrentNode, 0, sizeof(shoora_mesh_cgltf_node));
 
-    for(u32 PrimitiveIndex = 0;
-        PrimitiveIndex < NodeMesh->primitives_count;
-        ++PrimitiveIndex)
-    {
-        cgltf_primitive *Primitive = NodeMesh->primitives + PrimitiveIndex;
-        ASSERT(Primitive->type == cgltf_primitive_type_triangles);
+    CurrentNode->Name = (InputNode->name != nullptr) ? GetInternedString(InternString(InputNode->name)) : nullptr;
+    CurrentNode->ParentNode = Parent;
 
-        u32 VertexStart = MeshFilter->VertexCount;
+    // NOTE: Row vectors, so the node's own transform goes first and the parent's after it.
+    CurrentNode->ModelMatrix = GetGLTFNodeMatrix(InputNode);
+    CurrentNode->WorldMatrix = Parent ? (CurrentNode->ModelMatrix * Parent->WorldMatrix) : CurrentNode->ModelMatrix;
 
-        // NOTE: Vertices
-        {
-            const f32 *PositionBuffer = nullptr;
-            const f32 *NormalsBuffer = nullptr;
-            const f32 *ColorsBuffer = nullptr;
-            const f32 *TexCoordsBuffer = nullptr;
-            const f32 *TangentsBuffer = nullptr;
+    CurrentNode->ChildNodes = State->NextChildNodes;
+    State->NextChildNodes += InputNode->children_count;
 
-            u64 VertexCount = 0;
+    cgltf_mesh *NodeMesh = InputNode->mesh;
+    if(NodeMesh != nullptr)
+    {
+        CurrentNode->PrimitiveCount = NodeMesh->primitives_count;
+        CurrentNode->Primitives = State->NextPrimitive;
+        State->NextPrimitive += NodeMesh->primitives_count;
 
-            u32 AttributeCount = Primitive->attributes_count;
-            for(u32 AttrIndex = 0;
-                AttrIndex < AttributeCount;
-                ++AttrIndex)
+        for(u32 PrimitiveIndex = 0; PrimitiveIndex < NodeMesh->primitives_count; ++PrimitiveIndex)
+        {
+            cgltf_primitive *Primitive = NodeMesh->primitives + PrimitiveIndex;
+            ASSERT(Primitive->type == cgltf_primitive_type_triangles);
+
+            u32 VertexCount = 0;
+            for(u32 AttrIndex = 0; AttrIndex < Primitive->attributes_count; ++AttrIndex)
             {
-                const cgltf_attribute *Attribute = &Primitive->attributes[AttrIndex];
-                switch (Attribute->type)
+                if(Primitive->attributes[AttrIndex].type == cgltf_attribute_type_position)
                 {
-                    case cgltf_attribute_type_position:
-                    {
-                        cgltf_accessor *Accessor = Attribute->data;
-                        cgltf_buffer_view *BufferView = Accessor->buffer_view;
-
-                        u8 *BuffData = (u8 *)BufferView->buffer->data;
-                        PositionBuffer = (const f32 *)(BuffData + (Accessor->offset + BufferView->offset));
-                        VertexCount = Accessor->count;
-                    }
+                    VertexCount = Primitive->attributes[AttrIndex].data->count;
                     break;
+                }
+            }
+            u32 IndexCount = (Primitive->indices != nullptr) ? (u32)Primitive->indices->count : VertexCount;
+
+            gltf_primitive_load *Load = State->PrimitiveLoads + State->PrimitiveLoadCount++;
+            Load->Primitive = Primitive;
+            Load->VertexStart = State->VertexCount;
+            Load->FirstIndex = State->IndexCount;
+
+            shoora_mesh_primitive *MeshPrimitive = CurrentNode->Primitives + PrimitiveIndex;
+            MeshPrimitive->FirstIndex = State->IndexCount;
+            MeshPrimitive->IndexCount = IndexCount;
+            MeshPrimitive->MaterialIndex = (Primitive->material != nullptr)
+                                               ? GetMaterialIndex(State->glTFMaterials, Primitive->material)
+                                               : 0;
+
+            State->VertexCount += VertexCount;
+            State->IndexCount += IndexCount;
+        }
+    }
 
-                    case cgltf_attribute_type_normal:
-                    {
-                        cgltf_accessor *Accessor = Attribute->data;
-                        cgltf_buffer_view *BufferView = Accessor->buffer_view;
-
-                        u8 *BuffData = (u8 *)BufferView->buffer->data;
-                        NormalsBuffer = (const f32 *)(BuffData + (Accessor->offset + BufferView->offset));
-                    } break;
+    if(Parent)
+    {
+        Parent->ChildNodes[Parent->ChildrenCount++] = CurrentNode;
+    }
+    else
+    {
+        Model->Nodes[Model->NodeCount++] = CurrentNode;
+    }
 
-                    case cgltf_attribute_type_color:
-                    {
-                        cgltf_accessor *Accessor = Attribute->data;
-                        cgltf_buffer_view *BufferView = Accessor->buffer_view;
+    for(u32 NodeChildIndex = 0; NodeChildIndex < InputNode->children_count; ++NodeChildIndex)
+    {
+        LoadGLTFNode(InputNode->children[NodeChildIndex], Model, CurrentNode, State);
+    }
+}
 
-                        u8 *BuffData = (u8 *)BufferView->buffer->data;
-                        ColorsBuffer = (const f32 *)(BuffData + (Accessor->offset + BufferView->offset));
-                    } break;
+static const u8 *
+GetAccessorData(const cgltf_accessor *Accessor)
+{
+    const cgltf_buffer_view *BufferView = Accessor->buffer_view;
+    const u8 *Result = (const u8 *)BufferView->buffer->data + Accessor->offset + BufferView->offset;
+    return Result;
+}
 
-                    case cgltf_attribute_type_tangent:
-                    {
-                        cgltf_accessor *Accessor = Attribute->data;
-                        cgltf_buffer_view *BufferView = Accessor->buffer_view;
+// NOTE: Converts the vertex streams and indices of one primitive into its part of the mesh filter. Only writes to
+// that part, so the primitives can be converted at the same time.
+static void
+LoadGLTFPrimitive(const gltf_primitive_load *Load, shoora_mesh_filter *MeshFilter)
+{
+    const cgltf_primitive *Primitive = Load->Primitive;
 
-                        u8 *BuffData = (u8 *)BufferView->buffer->data;
-                        TangentsBuffer = (const f32 *)(BuffData + (Accessor->offset + BufferView->offset));
-                    } break;
+    const cgltf_accessor *Accessors[cgltf_attribute_type_max_enum] = {};
+    u64 VertexCount = 0;
+    for(u32 AttrIndex = 0; AttrIndex < Primitive->attributes_count; ++AttrIndex)
+    {
+        const cgltf_attribute *Attribute = &Primitive->attributes[AttrIndex];
+        // NOTE: Only the first set of each, TEXCOORD_1 and the rest are not used.
+        if(Accessors[Attribute->type] == nullptr)
+        {
+            Accessors[Attribute->type] = Attribute->data;
+        }
+        if(Attribute->type == cgltf_attribute_type_position)
+        {
+            VertexCount = Attribute->data->count;
+        }
+    }
 
-                    case cgltf_attribute_type_texcoord:
-                    {
-                        cgltf_accessor *Accessor = Attribute->data;
-                        cgltf_buffer_view *BufferView = Accessor->buffer_view;
+    const cgltf_accessor *Positions = Accessors[cgltf_attribute_type_position];
+    const cgltf_accessor *Normals = Accessors[cgltf_attribute_type_normal];
+    const cgltf_accessor *Colors = Accessors[cgltf_attribute_type_color];
+    const cgltf_accessor *TexCoords = Accessors[cgltf_attribute_type_texcoord];
+    const cgltf_accessor *Tangents = Accessors[cgltf_attribute_type_tangent];
+    ASSERT(Positions != nullptr);
+
+    const u8 *PositionData = GetAccessorData(Positions);
+    const u8 *NormalData = Normals ? GetAccessorData(Normals) : nullptr;
+    const u8 *ColorData = Colors ? GetAccessorData(Colors) : nullptr;
+    const u8 *TexCoordData = TexCoords ? GetAccessorData(TexCoords) : nullptr;
+    const u8 *TangentData = Tangents ? GetAccessorData(Tangents) : nullptr;
+
+    shoora_vertex_info *Vertices = MeshFilter->Vertices + Load->VertexStart;
+    for(u64 VertexIndex = 0; VertexIndex < VertexCount; ++VertexIndex)
+    {
+        shoora_vertex_info Vert = {};
+        Vert.Pos = shu::MakeVec3((const f32 *)(PositionData + VertexIndex*Positions->stride));
+        Vert.Normal = NormalData ? shu::MakeVec3((const f32 *)(NormalData + VertexIndex*Normals->stride))
+                                 : shu::Vec3(0.0f);
+        Vert.Color = ColorData ? shu::MakeVec3((const f32 *)(ColorData + VertexIndex*Colors->stride))
+                               : shu::Vec3(1.0f);
+        Vert.UV = TexCoordData ? shu::MakeVec2((const f32 *)(TexCoordData + VertexIndex*TexCoords->stride))
+                               : shu::Vec2(0.0f);
+        Vert.Tangent = TangentData ? shu::MakeVec4((const f32 *)(TangentData + VertexIndex*Tangents->stride))
+                                   : shu::Vec4(0.0f);
+
+        Vertices[VertexIndex] = Vert;
+    }
 
-                        u8 *BuffData = (u8 *)BufferView->buffer->data;
-                        TexCoordsBuffer = (const f32 *)(BuffData + (Accessor->offset + BufferView->offset));
-                    } break;
+    u32 *Indices = MeshFilter->Indices + Load->FirstIndex;
+    const u32 VertexStart = Load->VertexStart;
+    const cgltf_accessor *IndexAccessor = Primitive->indices;
+    if(IndexAccessor == nullptr)
+    {
+        for(u32 Index = 0; Index < (u32)VertexCount; ++Index)
+        {
+            Indices[Index] = Index + VertexStart;
+        }
+        return;
+    }
 
-                    SHU_INVALID_DEFAULT
-                }
+    const u8 *IndexData = GetAccessorData(IndexAccessor);
+    switch(IndexAccessor->component_type)
+    {
+        case cgltf_component_type_r_32u:
+        {
+            const u32 *Buf = (const u32 *)IndexData;
+            for(u64 Index = 0; Index < IndexAccessor->count; ++Index)
+            {
+                Indices[Index] = Buf[Index] + VertexStart;
             }
+        } break;
 
-            for(u32 VertexIndex = 0;
-                VertexIndex < VertexCount;
-                ++VertexIndex)
+        case cgltf_component_type_r_16u:
+        {
+            const u16 *Buf = (const u16 *)IndexData;
+            for(u64 Index = 0; Index < IndexAccessor->count; ++Index)
             {
-                shoora_vertex_info Vert = {};
-                Vert.Pos        = shu::MakeVec3(&PositionBuffer[VertexIndex*3]);
-                Vert.Normal     = shu::MakeVec3(&NormalsBuffer[VertexIndex*3]);
-                Vert.Color      = ColorsBuffer ? shu::MakeVec3(&ColorsBuffer[VertexIndex*3]) : shu::Vec3(1.0f);
-                Vert.UV         = TexCoordsBuffer ? shu::MakeVec2(&TexCoordsBuffer[VertexIndex*2]) : shu::Vec2(0.0f);
-                Vert.Tangent    = TangentsBuffer ? shu::MakeVec4(&TangentsBuffer[VertexIndex*4]) : shu::Vec4(0.0f);
-
-                MeshFilter->Vertices[MeshFilter->VertexCount++] = Vert;
+                Indices[Index] = (u32)Buf[Index] + VertexStart;
             }
-        }
+        } break;
 
-        // NOTE: Indices
+        case cgltf_component_type_r_8u:
         {
-            u32 FirstIndex = MeshFilter->IndexCount;
-
-            cgltf_accessor *IndexAccessor = Primitive->indices;
-            cgltf_buffer_view *IndexBufferView = IndexAccessor->buffer_view;
-            cgltf_buffer *IndexBuffer = IndexBufferView->buffer;
-
-            switch(IndexAccessor->component_type)
+            const u8 *Buf = IndexData;
+            for(u64 Index = 0; Index < IndexAccessor->count; ++Index)
             {
-                case cgltf_component_type_r_32u:
-                {
-                    const u32 *Buf = (u32 *)((u8 *)IndexBuffer->data +
-                                            IndexAccessor->offset + IndexBufferView->offset);
-                    for(u64 Index = 0;
-                        Index < IndexAccessor->count;
-                        ++Index)
-                    {
-                        MeshFilter->Indices[MeshFilter->IndexCount++] = Buf[Index] + VertexStart;
-                    }
-                } break;
-
-                case cgltf_component_type_r_16u:
-                {
-                    const u16 *Buf = (u16 *)((u8 *)IndexBuffer->data + IndexAccessor->offset +
-                                            IndexBufferView->offset);
-                    for(u64 Index = 0;
-                        Index < IndexAccessor->count;
-                        ++Index)
-                    {
-                        MeshFilter->Indices[MeshFilter->IndexCount++] = (u32)(Buf[Index] + VertexStart);
-                    }
-                } break;
-
-                case cgltf_component_type_r_8u:
-                {
-                    const u8 *Buf = (u8 *)((u8 *)IndexBuffer->data + IndexAccessor->offset +
-                                        IndexBufferView->offset);
-                    for(u64 Index = 0;
-                        Index < IndexAccessor->count;
-                        ++Index)
-                    {
-                        MeshFilter->Indices[MeshFilter->IndexCount++] = (u32)(Buf[Index] + VertexStart);
-                    }
-                } break;
-
-                SHU_INVALID_DEFAULT
+                Indices[Index] = (u32)Buf[Index] + VertexStart;
             }
+        } break;
 
-            shoora_mesh_primitive MeshPrimitive;
-            MeshPrimitive.FirstIndex = FirstIndex;
-            MeshPrimitive.IndexCount = IndexAccessor->count;
-            // TODO)): This is remaining!
-            MeshPrimitive.MaterialIndex = GetMaterialIndex(glTFMaterials, Primitive->material);
-            CurrentNode->Primitives[PrimitiveIndex] = MeshPrimitive;
-        }
-    }
-
-    if(Parent)
-    {
-        Parent->ChildNodes[Parent->ChildrenCount++] = CurrentNode;
-    }
-    else
-    {
-        Model->Nodes[Model->NodeCount++] = CurrentNode;
+        SHU_INVALID_DEFAULT
     }
+}
 
-#if 0
-    for(u32 Index = 0;
-        Index < Model->IndicesCount;
-        ++Index)
-    {
-        u32 VertIndex = Model->Indices[Index];
-        ASSERT(VertIndex < Model->VertexCount);
-    }
-#endif
+static b32
+IsBakedMeshFile(const char *Path)
+{
+    size_t Length = strlen(Path);
+    size_t ExtensionLength = sizeof(SHOORA_MESH_FILE_EXTENSION) - 1;
+    b32 Result = (Length > ExtensionLength) &&
+                 (strcmp(Path + Length - ExtensionLength, SHOORA_MESH_FILE_EXTENSION) == 0);
+    return Result;
 }
 
 void
-LoadModel(shoora_model *Model, const char *Path)
+LoadModel(shoora_model *Model, const char *Path, b32 LoadImages, shoora_vertex_format VertexFormat)
 {
+    if(IsBakedMeshFile(Path))
+    {
+        LoadModelBinary(Model, Path, LoadImages, VertexFormat);
+        LogMeshMemory(Path, &Model->MeshFilter);
+        return;
+    }
+
     cgltf_options Options = {};
     cgltf_data *MeshData = nullptr;
     cgltf_result Result = cgltf_parse_file(&Options, Path, &MeshData);
@@ -443,44 +547,145 @@ LoadModel(shoora_model *Model, const char *Path)
         ASSERT(!"Validation Failed!");
     }
 
-    char BasePath[512];
-    GetBasePath(Path, BasePath);
-    LoadTextureImages(MeshData->images, MeshData->images_count, BasePath, Model);
-    LoadMaterials(MeshData->materials, MeshData->materials_count, Model);
-
     u32 TotalVerticesCount = 0;
     u32 TotalIndicesCount = 0;
     u32 TotalNodesCount = 0;
-    GetTotalVertexIndicesCount(MeshData->scenes, MeshData->scenes_count,
-                               &TotalVerticesCount, &TotalIndicesCount, &TotalNodesCount);
-    MeshFilter->Vertices = (shoora_vertex_info *)malloc(TotalVerticesCount * sizeof(shoora_vertex_info));
-    memset(MeshFilter->Vertices, 0, sizeof(shoora_vertex_info) * TotalVerticesCount);
-    MeshFilter->Indices = (u32 *)malloc(TotalIndicesCount * sizeof(u32));
-    memset(MeshFilter->Indices, 0, sizeof(u32) * TotalIndicesCount);
-    Model->Nodes = (shoora_mesh_cgltf_node **)malloc(TotalNodesCount*sizeof(shoora_mesh_cgltf_node *));
-    memset(Model->Nodes, 0, sizeof(shoora_mesh_cgltf_node *)*TotalNodesCount);
+    u32 TotalPrimitivesCount = 0;
+    GetTotalVertexIndicesCount(MeshData->scenes, MeshData->scenes_count, &TotalVerticesCount, &TotalIndicesCount,
+                               &TotalNodesCount, &TotalPrimitivesCount);
+    u32 RootNodesCount = 0;
+    for(u32 SceneIndex = 0; SceneIndex < MeshData->scenes_count; ++SceneIndex)
+    {
+        RootNodesCount += MeshData->scenes[SceneIndex].nodes_count;
+    }
+
+    // NOTE: One block for everything in the model except the decoded images, so CleanupModelResources frees it in
+    // one go. Every allocation gets 16 bytes for its alignment.
+    size_t ArenaSize = sizeof(shoora_mesh_texture)*MeshData->images_count +
+                       sizeof(shoora_mesh_material)*MeshData->materials_count +
+                       sizeof(shoora_mesh_cgltf_node *)*RootNodesCount +
+                       sizeof(shoora_mesh_cgltf_node)*TotalNodesCount +
+                       sizeof(shoora_mesh_cgltf_node *)*TotalNodesCount +
+                       sizeof(shoora_mesh_primitive)*TotalPrimitivesCount +
+                       sizeof(shoora_vertex_info)*TotalVerticesCount + sizeof(u32)*TotalIndicesCount + 8*16;
+    // NOTE: The packed vertices for the GPU are kept next to the full ones.
+    size_t PackedVerticesSize = (VertexFormat != VertexFormat_Full) ?
+                                (size_t)GetVertexFormatSize(VertexFormat)*TotalVerticesCount : 0;
+    ArenaSize += PackedVerticesSize + 16;
+    Model->Arena.Base = malloc(ArenaSize);
+    Model->Arena.Size = ArenaSize;
+    Model->Arena.Used = 0;
+    ASSERT(Model->Arena.Base != nullptr);
+
+    char BasePath[512];
+    GetBasePath(Path, BasePath);
+    texture_lookup TextureLookup;
+    LoadTextureImages(MeshData->images, MeshData->images_count, BasePath, Model, TextureLookup, LoadImages);
+    LoadMaterials(MeshData->materials, MeshData->materials_count, Model, TextureLookup);
+
+    MeshFilter->Vertices = (shoora_vertex_info *)ShuAllocate_(&Model->Arena,
+                                                              TotalVerticesCount*sizeof(shoora_vertex_info), 16);
+    MeshFilter->Indices = (u32 *)ShuAllocate_(&Model->Arena, TotalIndicesCount*sizeof(u32), 16);
+    Model->Nodes = (shoora_mesh_cgltf_node **)ShuAllocate_(&Model->Arena,
+                                                            RootNodesCount*sizeof(shoora_mesh_cgltf_node *), 16);
+
+    Model->AllNodes = (shoora_mesh_cgltf_node *)ShuAllocate_(&Model->Arena,
+                                                             TotalNodesCount*sizeof(shoora_mesh_cgltf_node), 16);
+    Model->AllNodeCount = TotalNodesCount;
+
+    gltf_node_load_state State = {};
+    State.glTFMaterials = MeshData->materials;
+    State.NextNode = Model->AllNodes;
+    State.NextChildNodes = (shoora_mesh_cgltf_node **)ShuAllocate_(&Model->Arena,
+                                                                   TotalNodesCount*sizeof(shoora_mesh_cgltf_node *),
+                                                                   16);
+    State.NextPrimitive = (shoora_mesh_primitive *)ShuAllocate_(&Model->Arena,
+                                                                TotalPrimitivesCount*sizeof(shoora_mesh_primitive),
+                                                                16);
+
+    temporary_memory TempMemory = BeginTemporaryMemory(GetArena(MEMTYPE_THREADFRAME));
+    State.PrimitiveLoads = ShuAllocateArray(gltf_primitive_load, TotalPrimitivesCount, MEMTYPE_THREADFRAME);
 
     for(u32 SceneIndex = 0;
         SceneIndex < MeshData->scenes_count;
         ++SceneIndex)
     {
-        cgltf_scene *Scene = MeshData->scene + SceneIndex;
+        cgltf_scene *Scene = MeshData->scenes + SceneIndex;
         for(u32 NodeIndex = 0;
             NodeIndex < Scene->nodes_count;
             ++NodeIndex)
         {
             cgltf_node *Node = Scene->nodes[NodeIndex];
-            LoadGLTFNode(Node, MeshData->materials, Model, nullptr);
+            LoadGLTFNode(Node, Model, nullptr, &State);
+        }
+    }
+
+    ASSERT(State.VertexCount == TotalVerticesCount);
+    ASSERT(State.IndexCount == TotalIndicesCount);
+    ASSERT(State.PrimitiveLoadCount == TotalPrimitivesCount);
+    ASSERT(Model->NodeCount == RootNodesCount);
+
+    gltf_primitive_load *PrimitiveLoads = State.PrimitiveLoads;
+    JobSystem_ParallelFor((i32)State.PrimitiveLoadCount, 1, [PrimitiveLoads, MeshFilter](i32 First, i32 Last) {
+        for(i32 Index = First; Index < Last; ++Index)
+        {
+            LoadGLTFPrimitive(PrimitiveLoads + Index, MeshFilter);
         }
+    });
+    MeshFilter->VertexCount = TotalVerticesCount;
+    MeshFilter->IndexCount = TotalIndicesCount;
+
+    EndTemporaryMemory(TempMemory);
+
+    void *PackedVertices = nullptr;
+    if(VertexFormat != VertexFormat_Full)
+    {
+        PackedVertices = ShuAllocate_(&Model->Arena, PackedVerticesSize, 16);
     }
+    PackMeshFilter(MeshFilter, VertexFormat, PackedVertices);
+    LogMeshMemory(Path, MeshFilter);
 
-    ASSERT(MeshFilter->VertexCount == TotalVerticesCount);
-    ASSERT(MeshFilter->IndexCount == TotalIndicesCount);
-    ASSERT(Model->NodeCount == TotalNodesCount);
+    // NOTE: Everything the model keeps has been copied or interned, the glTF data is not needed any more.
+    Free((void **)&MeshData);
+}
+
+i32
+FindMaterialIndex(const shoora_model *Model, string_id NameId)
+{
+    i32 Result = -1;
+    for(u32 Index = 0; Index < Model->MaterialCount; ++Index)
+    {
+        if(Model->Materials[Index].NameId == NameId)
+        {
+            Result = Index;
+            break;
+        }
+    }
+
+    return Result;
 }
 
 void
 CleanupModelResources(shoora_model *Model)
 {
-    // TODO)): To be Implemented!
+    for(u32 TexIndex = 0; TexIndex < Model->TextureCount; ++TexIndex)
+    {
+        shoora_image_data *ImageData = &Model->Textures[TexIndex].ImageData;
+        if(ImageData->Data != nullptr)
+        {
+            FreeImageData(ImageData);
+        }
+    }
+
+    // NOTE: Everything else is in the one block, or in the mapped file for baked models.
+    if(Model->Arena.Base != nullptr)
+    {
+        free(Model->Arena.Base);
+    }
+    if(Model->MappedFile.Data != nullptr)
+    {
+        Platform_UnmapFile(&Model->MappedFile);
+    }
+
+    *Model = {};
 }
@@ -8,6 +8,9 @@
 #include <math/math.h>
 #include <volk/volk.h>
 #include <mesh/mesh_filter.h>
+#include <utils/string_intern.h>
+#include <memory/memory.h>
+#include <platform/platform.h>
 
 enum shoora_mesh_alpha_mode
 {
@@ -19,6 +22,8 @@ enum shoora_mesh_alpha_mode
 
 struct shoora_mesh_material
 {
+    // NOTE: Interned material name, STRING_ID_NONE if the material has no name.
+    string_id NameId;
     shu::vec4f BaseColorFactor;
     i32 BaseColorTextureIndex = -1;
     i32 NormalTextureIndex = -1;
@@ -35,6 +40,8 @@ struct shoora_mesh_material
 
 struct shoora_mesh_texture
 {
+    // NOTE: Interned uri of the image. ImageFilename is the interned string, so it outlives the glTF data.
+    string_id ImageNameId;
     const char *ImageFilename;
     shoora_image_data ImageData;
 };
@@ -48,13 +55,17 @@ struct shoora_mesh_primitive
 
 struct shoora_mesh_cgltf_node
 {
+    // NOTE: Interned, nullptr if the node has no name.
     const char *Name;
     shoora_mesh_cgltf_node *ParentNode;
 
     shoora_mesh_cgltf_node **ChildNodes;
     u32 ChildrenCount;
 
+    // NOTE: Relative to the parent node.
     shu::mat4f ModelMatrix;
+    // NOTE: ModelMatrix with all of the parents applied.
+    shu::mat4f WorldMatrix;
     shoora_mesh_primitive *Primitives;
     u32 PrimitiveCount;
 };
@@ -68,14 +79,40 @@ struct shoora_model
     shoora_mesh_material *Materials;
     u32 MaterialCount;
 
+    // NOTE: The root nodes of all the scenes, the rest are reached through ChildNodes.
     shoora_mesh_cgltf_node **Nodes;
     u32 NodeCount;
 
+    // NOTE: Every node of the tree, parents before their children. Nodes points into this.
+    shoora_mesh_cgltf_node *AllNodes;
+    u32 AllNodeCount;
+
     shoora_mesh_filter MeshFilter;
+
+    // NOTE: Holds the textures, materials, nodes, primitives, vertices and indices. It is sized before any of them
+    // are loaded. The decoded image data is not in it, it comes from the image loader.
+    memory_arena Arena;
+
+    // NOTE: Only for models loaded from a baked mesh file(mesh_binary.h). The vertices, indices and primitives point
+    // into the mapped file instead of the arena.
+    platform_mapped_file MappedFile;
 };
 
-void LoadModel(shoora_model *Model, const char *Path);
+// NOTE: Loads a glTF/glb file, or a baked .shmesh file made by the mesh baker. With LoadImages false only the
+// texture names are filled in, the images are not decoded. VertexFormat is what the GPU gets(mesh/vertex_packing.h),
+// the packed vertices are made here unless the baked file already has them in that format.
+void LoadModel(shoora_model *Model, const char *Path, b32 LoadImages = true,
+               shoora_vertex_format VertexFormat = VertexFormat_Full);
+// NOTE: Interns the image names and decodes the images(in parallel) into Model->Textures, which is allocated from
+// the model's arena. Used by both the glTF and the baked loaders.
+void LoadModelTextures(shoora_model *Model, const char *const *ImageUris, u32 ImageCount, const char *BasePath,
+                       b32 LoadImages);
+void GetBasePath(const char *Path, char *BasePath);
+// NOTE: Frees the image data and the model's arena and unmaps the baked file. The GPU resources made from the model
+// are not touched.
 void CleanupModelResources(shoora_model *Model);
+// NOTE: -1 if the model has no material with that name.
+i32 FindMaterialIndex(const shoora_model *Model, string_id NameId);
 
 #define MESH_LOADER_H
 #endif // MESH_LOADER_H
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "defines.h"
 #include "platform/platform.h"
+#include "platform/job_system.h"
 #include "platform/windows/win_platform.h"
 #include <Windows.h>
 #include <shellapi.h> /* external debug console */
@@ -551,6 +552,21 @@ Win32GetSecondsElapsed(LARGE_INTEGER Start, LARGE_INTEGER End)
     return Result;
 }
 
+u64
+Platform_GetWallClock()
+{
+    LARGE_INTEGER Counter = Win32GetWallClock();
+    u64 Result = (u64)Counter.QuadPart;
+    return Result;
+}
+
+f32
+Platform_GetSecondsElapsed(u64 Start, u64 End)
+{
+    f32 Result = ((f32)(End - Start) / (f32)Win32State.PerfFrequency);
+    return Result;
+}
+
 void
 Win32SetOutOfBoundsCursor(HWND Handle)
 {
@@ -601,167 +617,10 @@ void Platform_Sleep(u32 ms)
     Sleep(ms);
 }
 
-struct platform_work_queue_entry
-{
-    platform_work_queue_callback *Callback;
-    void *Args;
-};
-
-struct platform_work_queue
-{
-    // How many entries of the worker should be completed.
-    u32 volatile CompletionGoal;
-    // How manyu tasks have been completed.
-    u32 volatile CompletionCount;
-    // If a new work entry, which index in the queue array should it go to?
-    u32 volatile NextEntryToWrite;
-    u32 volatile NextEntryToRead;
-    HANDLE SemaphoreHandle;
-
-    // Queue Size.
-    platform_work_queue_entry Entries[256];
-};
-
-static b32
-Win32DoNextWorkQueueEntry(platform_work_queue *Queue)
-{
-    b32 WeShouldSleep = false;
-
-    // Work queue is a Circular buffer.
-    // NOTE: we do not want two threads to read the same entry (in other words, we dont want two threads
-    // doing the same work).
-    // What is the next index in queue array that we should pick to complete using a thread?
-    u32 OriginalNextEntryToRead = Queue->NextEntryToRead;
-    // What will be the next index of the work to pick after the thread has picked the original one?
-    u32 NewNextEntryToRead = ((OriginalNextEntryToRead + 1) % ARRAY_SIZE(Queue->Entries));
-
-    // NextEntryToRead is the index of work entries which need to be picked up by threads for completion.
-    // Next Entry to Write is the index where new work if requested will be added to.
-    // We dont want a thread to pick up work that we are or will be writing to.
-    // Either it is in the process of being written to
-    if (OriginalNextEntryToRead != Queue->NextEntryToWrite)
-    {
-        // Compare the value of NextEntryToRead with OriginalNextEntryToRead, if its different then replace it with
-        // NewNextEntryToRead and return the original expected value, otherwise do nothing.
-        //
-        // NOTE: Take this scenario where this will fail.
-        // Let's say thread A reached here, it had an idea of what the OriginalNextEntryToRead was.
-        // Then our OS scheduled another thread B which did the same thing, got the same value for OriginalNextEntryToRead.
-        // It exchanged it and set Queue's NextEntryToRead value to Original+1.
-        //
-        // Now let's say thread A again got scheduled and it started from this line. Now, Queue's NextEntryRead has
-        // changed to Original+1, and it had the old Original value. In this case InterlockedCompareExchange will
-        // tell thread A that it was changed since the last time you stored Original's value. thread B now knows
-        // some other thread already updated the value, in which case it should not pick the same work again to
-        // complete that thread B already picked up. so it will do nothing and continue checking for more qork from
-        // the queue.
-        u32 Index = InterlockedCompareExchange((LONG volatile *)&Queue->NextEntryToRead, NewNextEntryToRead,
-                                               OriginalNextEntryToRead);
-        // Index will be the Original value since the original value will be returned if the exchange did happen
-        // safely above.
-        if (Index == OriginalNextEntryToRead)
-        {
-            platform_work_queue_entry Entry = Queue->Entries[Index];
-            Entry.Callback(Queue, Entry.Args);
-            // Thread Safe way to increment CompletionCount.
-            InterlockedIncrement((LONG volatile *)&Queue->CompletionCount);
-        }
-    }
-    else
-    {
-        // This will come when OriginalNextEntryToRead will be equal to that of Write.
-        // which essentially means there is no work left in the queue. In which case the thread is instructed to
-        // sleep until some new work gets added to the queue.
-        WeShouldSleep = true;
-    }
-
-    return WeShouldSleep;
-}
-
-DWORD WINAPI
-ThreadProc(LPVOID lpParameter)
-{
-    platform_work_queue *Queue = (platform_work_queue *)lpParameter;
-
-#if __MS10
-    // NOTE: Setting thread name for debugging later in vs2022
-    // wchar_t Buffer[256];
-    // ConstructWideString(Buffer, ArrayCount(Buffer), L"Thread %d", ThreadInfo->LogicalThreadIndex);
-    // HRESULT r = SetThreadDescription(GetCurrentThread(), (PCWSTR)Buffer);
-#endif
-
-    for (;;)
-    {
-        if (Win32DoNextWorkQueueEntry(Queue))
-        {
-            // Sleep Infinitely until the semaphore is released.
-            // Semaphore is released when there is work in the queue to be completed.
-            WaitForSingleObjectEx(Queue->SemaphoreHandle, INFINITE, FALSE);
-        }
-    }
-}
-
-static void
-Win32MakeWorkQueue(platform_work_queue *Queue, u32 ThreadCount)
-{
-    Queue->CompletionGoal = 0;
-    Queue->CompletionCount = 0;
-    Queue->NextEntryToWrite = 0;
-    Queue->NextEntryToRead = 0;
-
-    u32 InitialCount = 0;
-    Queue->SemaphoreHandle = CreateSemaphoreExA(0, InitialCount, ThreadCount, 0, 0, SEMAPHORE_ALL_ACCESS);
-
-    for(u32 ThreadIndex = 0; ThreadIndex < ThreadCount; ++ThreadIndex)
-    {
-        DWORD ThreadID;
-        HANDLE ThreadHandle = CreateThread(0, 0, ThreadProc, Queue, 0, &ThreadID);
-        CloseHandle(ThreadHandle);
-    }
-}
-
-void
-Platform_AddWorkEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
-{
-    // The Thread Work Queue is a circular buffer. Write pointer can get
-    // ahead of the read as it wraps areound the entries array.
-    //
-    // if some new work comes in, which index should we choose to store the work related info. That's the
-    // NextEntryToWrite.
-    u32 NewNextEntryToWrite = ((Queue->NextEntryToWrite + 1) % ARRAY_SIZE(Queue->Entries));
-    // NextEntryToRead is where the next available thread will pick from to complete.
-    // We dont want to write data to the same place and simulataneously have a thread picking it to complete.
-    ASSERT(NewNextEntryToWrite != Queue->NextEntryToRead);
-
-    platform_work_queue_entry *Entry = Queue->Entries + Queue->NextEntryToWrite;
-
-    // Data related to the work entry
-    Entry->Args = Data;
-    Entry->Callback = Callback;
-
-    // Thread safe way of incrementing completion goal.
-    InterlockedIncrement(&Queue->CompletionGoal);
-
-    CompletePastWritesBeforeFutureWrites;
-
-    // Circular buffer.
-    Queue->NextEntryToWrite = NewNextEntryToWrite;
-    // Release 1 count for the semaphore so that sleeping threads are woken up to start doing work for this newly
-    // added entry.
-    ReleaseSemaphore(Queue->SemaphoreHandle, 1, 0);
-}
-
-void
-Platform_CompleteAllWork(platform_work_queue *Queue)
+u32
+Platform_GetThreadIndex()
 {
-    while (Queue->CompletionGoal != Queue->CompletionCount)
-    {
-        Win32DoNextWorkQueueEntry(Queue);
-    }
-
-    // NOTE: Reset the Queue.
-    Queue->CompletionCount = 0;
-    Queue->CompletionGoal = 0;
+    return JobSystem_GetThreadIndex();
 }
 
 static
@@ -875,6 +734,49 @@ Platform_WriteFile(char *Filename, u32 Size, void *Data)
     return Result;
 }
 
+platform_mapped_file
+Platform_MapFile(const char *Path)
+{
+    platform_mapped_file Result = {};
+    ASSERT(Path != nullptr);
+
+    HANDLE FileHandle = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+    if (FileHandle != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER FileSize;
+        if (GetFileSizeEx(FileHandle, &FileSize) && FileSize.QuadPart > 0)
+        {
+            HANDLE MappingHandle = CreateFileMappingA(FileHandle, 0, PAGE_WRITECOPY, 0, 0, 0);
+            if (MappingHandle != nullptr)
+            {
+                Result.Data = MapViewOfFile(MappingHandle, FILE_MAP_COPY, 0, 0, 0);
+                if (Result.Data != nullptr)
+                {
+                    Result.Size = (u64)FileSize.QuadPart;
+                }
+
+                // NOTE: The view keeps the mapping and the file open until it is unmapped.
+                CloseHandle(MappingHandle);
+            }
+        }
+
+        CloseHandle(FileHandle);
+    }
+
+    return Result;
+}
+
+void
+Platform_UnmapFile(platform_mapped_file *File)
+{
+    if (File->Data)
+    {
+        UnmapViewOfFile(File->Data);
+    }
+    File->Data = nullptr;
+    File->Size = 0;
+}
+
 u64
 Platform_GetFileTime()
 {
@@ -928,11 +830,11 @@ Platform_GetWindowDetails(void **WindowHandle, void **WindowInstance)
 i32 WINAPI
 wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int CmdShow)
 {
-    platform_work_queue HighPriorityQueue = {};
-    Win32MakeWorkQueue(&HighPriorityQueue, 7);
+    JobSystem_Initialize();
 
+    // NOTE: Both queues run on the same workers, they only wait on their own work.
+    platform_work_queue HighPriorityQueue = {};
     platform_work_queue LowPriorityQueue = {};
-    Win32MakeWorkQueue(&LowPriorityQueue, 3);
 
 #if 0
     Platform_AddWorkEntry(&HighPriorityQueue, DoWorkerWork, (void *)"String A0.");
@@ -1141,6 +1043,7 @@ wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int CmdSh
     }
 
     DestroyRenderer();
+    JobSystem_Shutdown();
     CloseWindow(Win32State.WindowContext.Handle);
 
     if(CreateConsole)
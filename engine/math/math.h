@@ -9,5 +9,8 @@
 #include "math_trig.h"
 #include "math_vector.h"
 #include "math_barycentric.h"
+#include "math_simd.h"
+#include "math_wide.h"
+#include "math_jacobian.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "math.h"
+
+#if _SHU_DEBUG
+#include <platform/platform.h>
+#include <utils/random/random.h>
+
+namespace shu
+{
+    static inverse_mass_12
+    RandomInverseMass(shoora_random &Random)
+    {
+        // NOTE: Inverse inertia tensors are symmetric positive definite, R*diag*Rt is.
+        inverse_mass_12 Result;
+        Result.InvMassA = Random.Between(0.1f, 2.0f);
+        Result.InvMassB = Random.Between(0.1f, 2.0f);
+        mat3f *Tensors[2] = {&Result.InvInertiaA, &Result.InvInertiaB};
+        for(i32 t = 0; t < 2; ++t)
+        {
+            quat Q = QuatNormalize(Quat(Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f),
+                                        Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f)));
+            mat3f R = Q.ToMat3f();
+            vec3f Diagonal = Vec3f(Random.Between(0.2f, 3.0f), Random.Between(0.2f, 3.0f), Random.Between(0.2f, 3.0f));
+            for(i32 i = 0; i < 3; ++i)
+            {
+                for(i32 j = 0; j < 3; ++j)
+                {
+                    Tensors[t]->m[i][j] = R.m[0][i]*Diagonal.x*R.m[0][j] + R.m[1][i]*Diagonal.y*R.m[1][j] +
+                                          R.m[2][i]*Diagonal.z*R.m[2][j];
+                }
+            }
+        }
+        return Result;
+    }
+
+    // NOTE: The dense 12x12 matrix the constraints used to build.
+    static matN<f32, 12>
+    InverseMassMatrix(const inverse_mass_12 &InvM)
+    {
+        matN<f32, 12> Result;
+        for(i32 i = 0; i < 3; ++i)
+        {
+            Result.Data[i][i] = InvM.InvMassA;
+            Result.Data[6 + i][6 + i] = InvM.InvMassB;
+            for(i32 j = 0; j < 3; ++j)
+            {
+                Result.Data[3 + i][3 + j] = InvM.InvInertiaA.m[i][j];
+                Result.Data[9 + i][9 + j] = InvM.InvInertiaB.m[i][j];
+            }
+        }
+        return Result;
+    }
+
+    template <size_t M>
+    static void
+    RandomJacobian(shoora_random &Random, matMN<f32, M, 12> &J)
+    {
+        for(size_t i = 0; i < M; ++i)
+        {
+            for(size_t k = 0; k < 12; ++k)
+            {
+                J.Data[i][k] = Random.Between(-1.0f, 1.0f);
+            }
+        }
+    }
+
+    template <size_t M>
+    static void
+    CheckJacobianKernels(shoora_random &Random)
+    {
+        for(i32 Iteration = 0; Iteration < 200; ++Iteration)
+        {
+            matMN<f32, M, 12> J;
+            RandomJacobian(Random, J);
+            inverse_mass_12 InvM = RandomInverseMass(Random);
+            vecN<f32, 12> V;
+            for(size_t k = 0; k < 12; ++k)
+            {
+                V.Data[k] = Random.Between(-4.0f, 4.0f);
+            }
+
+            matN<f32, M> Expected = J * InverseMassMatrix(InvM) * J.Transposed();
+            symN<M> A = JMJt(J, InvM);
+            matN<f32, M> Dense = A.ToMatN();
+            for(size_t i = 0; i < M; ++i)
+            {
+                for(size_t j = 0; j < M; ++j)
+                {
+                    ASSERT(NearlyEqual(Dense.Data[i][j], Expected.Data[i][j], 1e-4f));
+                }
+            }
+
+            vecN<f32, M> ExpectedJV = J * V;
+            vecN<f32, M> JV = JMul(J, V);
+            vecN<f32, 12> ExpectedJtV = J.Transposed() * JV;
+            vecN<f32, 12> JtV = JtMul(J, JV);
+            for(size_t i = 0; i < M; ++i)
+            {
+                ASSERT(NearlyEqual(JV.Data[i], ExpectedJV.Data[i], 1e-4f));
+            }
+            for(size_t k = 0; k < 12; ++k)
+            {
+                ASSERT(NearlyEqual(JtV.Data[k], ExpectedJtV.Data[k], 1e-3f));
+            }
+
+            // NOTE: Both factorizations have to give back the right hand side.
+            symN<M> LD = A, L = A;
+            vecN<f32, M> X = JV, Y = JV;
+            LDLtFactor(LD);
+            LDLtSolve(LD, X);
+            ASSERT(CholeskyFactor(L));
+            CholeskySolve(L, Y);
+            vecN<f32, M> Ax = Dense * X;
+            vecN<f32, M> Ay = Dense * Y;
+            for(size_t i = 0; i < M; ++i)
+            {
+                ASSERT(NearlyEqual(Ax.Data[i], JV.Data[i], 1e-2f));
+                ASSERT(NearlyEqual(Ay.Data[i], JV.Data[i], 1e-2f));
+            }
+        }
+    }
+
+    // NOTE: Checks the kernels against the generic matN/matMN products.
+    void
+    MathJacobianTest()
+    {
+        shoora_random Random(0x1ac0);
+        CheckJacobianKernels<1>(Random);
+        CheckJacobianKernels<2>(Random);
+        CheckJacobianKernels<3>(Random);
+        CheckJacobianKernels<5>(Random);
+        CheckJacobianKernels<6>(Random);
+
+        // NOTE: A zero row(friction without friction) and a repeated row. LDLt gives zero for the row it cannot
+        // solve, Cholesky reports it.
+        matMN<f32, 3, 12> J;
+        RandomJacobian(Random, J);
+        J.Rows[1].Zero();
+        symN<3> A = JMJt(J, RandomInverseMass(Random));
+        symN<3> L = A;
+        ASSERT(!CholeskyFactor(L));
+        LDLtFactor(A);
+        vecN<f32, 3> b{1.0f, 1.0f, 1.0f};
+        LDLtSolve(A, b);
+        ASSERT(b.Data[1] == 0.0f);
+        ASSERT(b.IsValid());
+
+        J.Rows[1] = J.Rows[0];
+        A = JMJt(J, RandomInverseMass(Random));
+        LDLtFactor(A);
+        b = vecN<f32, 3>{1.0f, 1.0f, 1.0f};
+        LDLtSolve(A, b);
+        ASSERT(b.IsValid());
+
+        LogInfo("[Math Jacobian Test]: Passed.\n");
+    }
+
+    static inline f32
+    BenchmarkMs(u64 Start)
+    {
+        return 1000.0f * Platform_GetSecondsElapsed(Start, Platform_GetWallClock());
+    }
+
+    // NOTE: One constraint solve the old way(dense 12x12 inverse mass, generic products, Gauss Seidel) and the new
+    // way, Count times over the same inputs. The checksum only makes sure the compiler does not throw the work away.
+    template <size_t M>
+    static void
+    BenchmarkJacobianKernels(shoora_random &Random, i32 Count)
+    {
+        matMN<f32, M, 12> J;
+        RandomJacobian(Random, J);
+        inverse_mass_12 InvM = RandomInverseMass(Random);
+        vecN<f32, 12> V;
+        for(size_t k = 0; k < 12; ++k)
+        {
+            V.Data[k] = Random.Between(-4.0f, 4.0f);
+        }
+
+        f32 GenericChecksum = 0.0f;
+        u64 Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; ++i)
+        {
+            matMN<f32, 12, M> Jt = J.Transposed();
+            matN<f32, 12> Dense = InverseMassMatrix(InvM);
+            auto A = J * Dense * Jt;
+            auto Rhs = J * V * -1.0f;
+            auto Lambda = LCP_GaussSeidel(A, Rhs);
+            auto Impulses = Jt * Lambda;
+            GenericChecksum += Impulses.Data[i % 12];
+            J.Data[0][0] += 1e-7f;
+        }
+        f32 GenericMs = BenchmarkMs(Start);
+
+        f32 KernelChecksum = 0.0f;
+        Start = Platform_GetWallClock();
+        for(i32 i = 0; i < Count; ++i)
+        {
+            symN<M> A = JMJt(J, InvM);
+            vecN<f32, M> Lambda = JMul(J, V) * -1.0f;
+            LDLtFactor(A);
+            LDLtSolve(A, Lambda);
+            vecN<f32, 12> Impulses = JtMul(J, Lambda);
+            KernelChecksum += Impulses.Data[i % 12];
+            J.Data[0][0] -= 1e-7f;
+        }
+        f32 KernelMs = BenchmarkMs(Start);
+
+        LogInfo("  %zux12  generic %8.3fms, kernels %8.3fms(checksums %f, %f).\n", M, GenericMs, KernelMs,
+                GenericChecksum, KernelChecksum);
+    }
+
+    void
+    MathJacobianBenchmark()
+    {
+        const i32 Count = 100000;
+        shoora_random Random(0xbe9c);
+
+        LogInfo("[Math Jacobian Benchmark]: %d solves per size.\n", Count);
+        BenchmarkJacobianKernels<1>(Random, Count);
+        BenchmarkJacobianKernels<2>(Random, Count);
+        BenchmarkJacobianKernels<3>(Random, Count);
+        BenchmarkJacobianKernels<5>(Random, Count);
+        BenchmarkJacobianKernels<6>(Random, Count);
+    }
+} // namespace shu
+#endif
@@ -0,0 +1,256 @@
+#if !defined(MATH_JACOBIAN_H)
+
+#include <defines.h>
+#include "math_vector.h"
+#include "math_matrix.h"
+
+// NOTE: Kernels for the two body constraints. Their Jacobian is always M x 12(linear and angular parts of A, then
+// of B) and the 12x12 inverse mass matrix is block diagonal, so J*InvM*Jt only needs the two masses and the two
+// inverse inertia tensors. All the loops here run to template sizes, so the compiler unrolls them for the exact
+// constraint sizes(1, 2, 3, 5 and 6 rows). Nothing here allocates.
+namespace shu
+{
+    // NOTE: diag(InvMassA, InvMassA, InvMassA, InvInertiaA, InvMassB, InvMassB, InvMassB, InvInertiaB).
+    struct inverse_mass_12
+    {
+        f32 InvMassA;
+        mat3f InvInertiaA;
+        f32 InvMassB;
+        mat3f InvInertiaB;
+    };
+
+    // NOTE: Symmetric N x N matrix. Only the lower triangle is stored, row by row.
+    template <size_t N>
+    struct symN
+    {
+        static constexpr size_t Count = N*(N + 1) / 2;
+        f32 Data[Count];
+
+        static constexpr size_t
+        Index(size_t Row, size_t Col)
+        {
+            return (Row >= Col) ? (Row*(Row + 1) / 2 + Col) : (Col*(Col + 1) / 2 + Row);
+        }
+
+        f32 &operator()(size_t Row, size_t Col) { return this->Data[Index(Row, Col)]; }
+        f32 operator()(size_t Row, size_t Col) const { return this->Data[Index(Row, Col)]; }
+
+        matN<f32, N>
+        ToMatN() const
+        {
+            matN<f32, N> Result;
+            for(size_t i = 0; i < N; ++i)
+            {
+                for(size_t j = 0; j < N; ++j)
+                {
+                    Result.Data[i][j] = (*this)(i, j);
+                }
+            }
+            return Result;
+        }
+    };
+
+    // NOTE: J*InvM*Jt. Each row of J is scaled by InvM once, then only the lower triangle of the products is
+    // worked out.
+    template <size_t M>
+    inline symN<M>
+    JMJt(const matMN<f32, M, 12> &J, const inverse_mass_12 &InvM)
+    {
+        f32 W[M][12];
+        for(size_t i = 0; i < M; ++i)
+        {
+            const f32 *Row = J.Data[i];
+            for(size_t k = 0; k < 3; ++k)
+            {
+                W[i][k] = InvM.InvMassA*Row[k];
+                W[i][3 + k] = InvM.InvInertiaA.m[k][0]*Row[3] + InvM.InvInertiaA.m[k][1]*Row[4] +
+                              InvM.InvInertiaA.m[k][2]*Row[5];
+                W[i][6 + k] = InvM.InvMassB*Row[6 + k];
+                W[i][9 + k] = InvM.InvInertiaB.m[k][0]*Row[9] + InvM.InvInertiaB.m[k][1]*Row[10] +
+                              InvM.InvInertiaB.m[k][2]*Row[11];
+            }
+        }
+
+        symN<M> Result;
+        for(size_t i = 0; i < M; ++i)
+        {
+            for(size_t j = 0; j <= i; ++j)
+            {
+                f32 Sum = 0.0f;
+                for(size_t k = 0; k < 12; ++k)
+                {
+                    Sum += J.Data[i][k]*W[j][k];
+                }
+                Result(i, j) = Sum;
+            }
+        }
+        return Result;
+    }
+
+    // NOTE: J*V.
+    template <size_t M>
+    inline vecN<f32, M>
+    JMul(const matMN<f32, M, 12> &J, const vecN<f32, 12> &V)
+    {
+        vecN<f32, M> Result;
+        for(size_t i = 0; i < M; ++i)
+        {
+            f32 Sum = 0.0f;
+            for(size_t k = 0; k < 12; ++k)
+            {
+                Sum += J.Data[i][k]*V.Data[k];
+            }
+            Result.Data[i] = Sum;
+        }
+        return Result;
+    }
+
+    // NOTE: Jt*Lambda, without building the transpose.
+    template <size_t M>
+    inline vecN<f32, 12>
+    JtMul(const matMN<f32, M, 12> &J, const vecN<f32, M> &Lambda)
+    {
+        vecN<f32, 12> Result;
+        for(size_t i = 0; i < M; ++i)
+        {
+            for(size_t k = 0; k < 12; ++k)
+            {
+                Result.Data[k] += J.Data[i][k]*Lambda.Data[i];
+            }
+        }
+        return Result;
+    }
+
+    // NOTE: A = L*D*Lt in place. L has ones on the diagonal, so the diagonal of A keeps D. A pivot which is not
+    // bigger than a small part of its diagonal is a row which cannot be solved for(a zero friction row, or two rows
+    // which are the same), its D is set to zero and LDLtSolve gives zero for it. This is what the Gauss Seidel
+    // solver did by skipping the rows that came out as NaN.
+    template <size_t N>
+    inline void
+    LDLtFactor(symN<N> &A)
+    {
+        for(size_t j = 0; j < N; ++j)
+        {
+            const f32 Diagonal = A(j, j);
+            f32 D = Diagonal;
+            for(size_t k = 0; k < j; ++k)
+            {
+                D -= A(j, k)*A(j, k)*A(k, k);
+            }
+
+            if(!(D > 0.0f && D > 1e-6f*Diagonal))
+            {
+                A(j, j) = 0.0f;
+                for(size_t i = j + 1; i < N; ++i)
+                {
+                    A(i, j) = 0.0f;
+                }
+                continue;
+            }
+
+            A(j, j) = D;
+            const f32 InvD = 1.0f / D;
+            for(size_t i = j + 1; i < N; ++i)
+            {
+                f32 Sum = A(i, j);
+                for(size_t k = 0; k < j; ++k)
+                {
+                    Sum -= A(i, k)*A(j, k)*A(k, k);
+                }
+                A(i, j) = Sum*InvD;
+            }
+        }
+    }
+
+    // NOTE: Solves L*D*Lt*x = b with the output of LDLtFactor. b is overwritten with x.
+    template <size_t N>
+    inline void
+    LDLtSolve(const symN<N> &LD, vecN<f32, N> &b)
+    {
+        for(size_t i = 0; i < N; ++i)
+        {
+            for(size_t k = 0; k < i; ++k)
+            {
+                b.Data[i] -= LD(i, k)*b.Data[k];
+            }
+        }
+        for(size_t i = 0; i < N; ++i)
+        {
+            b.Data[i] = (LD(i, i) != 0.0f) ? (b.Data[i] / LD(i, i)) : 0.0f;
+        }
+        for(size_t i = N; i-- > 0;)
+        {
+            for(size_t k = i + 1; k < N; ++k)
+            {
+                b.Data[i] -= LD(k, i)*b.Data[k];
+            }
+        }
+    }
+
+    // NOTE: A = L*Lt in place. Returns false if A is not symmetric positive definite, A is left half factored then.
+    template <size_t N>
+    inline b32
+    CholeskyFactor(symN<N> &A)
+    {
+        for(size_t j = 0; j < N; ++j)
+        {
+            f32 D = A(j, j);
+            for(size_t k = 0; k < j; ++k)
+            {
+                D -= A(j, k)*A(j, k);
+            }
+            if(!(D > 0.0f))
+            {
+                return false;
+            }
+
+            const f32 Ljj = sqrtf(D);
+            const f32 InvLjj = 1.0f / Ljj;
+            A(j, j) = Ljj;
+            for(size_t i = j + 1; i < N; ++i)
+            {
+                f32 Sum = A(i, j);
+                for(size_t k = 0; k < j; ++k)
+                {
+                    Sum -= A(i, k)*A(j, k);
+                }
+                A(i, j) = Sum*InvLjj;
+            }
+        }
+        return true;
+    }
+
+    // NOTE: Solves L*Lt*x = b with the output of CholeskyFactor. b is overwritten with x.
+    template <size_t N>
+    inline void
+    CholeskySolve(const symN<N> &L, vecN<f32, N> &b)
+    {
+        for(size_t i = 0; i < N; ++i)
+        {
+            for(size_t k = 0; k < i; ++k)
+            {
+                b.Data[i] -= L(i, k)*b.Data[k];
+            }
+            b.Data[i] /= L(i, i);
+        }
+        for(size_t i = N; i-- > 0;)
+        {
+            for(size_t k = i + 1; k < N; ++k)
+            {
+                b.Data[i] -= L(k, i)*b.Data[k];
+            }
+            b.Data[i] /= L(i, i);
+        }
+    }
+} // namespace shu
+
+#if _SHU_DEBUG
+namespace shu
+{
+    void MathJacobianTest();
+    void MathJacobianBenchmark();
+}
+#endif
+
+#define MATH_JACOBIAN_H
+#endif // MATH_JACOBIAN_H
@@ -2420,6 +2420,217 @@ namespace shu
     }
 
 #endif
+
+#if SHU_MATH_SIMD != SHU_MATH_SIMD_NONE
+    // ----------------------------------------------------------------------------------------------------------------
+    // NOTE: f32 versions on the SIMD backend. The matrices are row major and vectors are multiplied as rows from the
+    // left, so a row of the result is the rows of the right matrix scaled by one row of the left one.
+    // ----------------------------------------------------------------------------------------------------------------
+    template <>
+    inline mat3<f32>
+    operator*(const mat3<f32> &M1, const mat3<f32> &M2)
+    {
+        simd_f32x4 B0 = SimdLoad3(M2.m[0]);
+        simd_f32x4 B1 = SimdLoad3(M2.m[1]);
+        simd_f32x4 B2 = SimdLoad3(M2.m[2]);
+
+        mat3<f32> Result;
+        for (u32 i = 0; i < 3; ++i)
+        {
+            simd_f32x4 Row = SimdMul(SimdSplat(M1.m[i][0]), B0);
+            Row = SimdMulAdd(SimdSplat(M1.m[i][1]), B1, Row);
+            Row = SimdMulAdd(SimdSplat(M1.m[i][2]), B2, Row);
+            SimdStore3(Result.m[i], Row);
+        }
+
+        return Result;
+    }
+
+    template <>
+    inline vec3<f32>
+    operator*(const mat3<f32> &M, const vec3<f32> &V)
+    {
+        simd_f32x4 v = SimdLoad3(V.E);
+
+        vec3<f32> Result;
+        Result.x = SimdDot3(SimdLoad3(M.m[0]), v);
+        Result.y = SimdDot3(SimdLoad3(M.m[1]), v);
+        Result.z = SimdDot3(SimdLoad3(M.m[2]), v);
+
+        return Result;
+    }
+
+    template <>
+    inline vec3<f32>
+    operator*(const vec3<f32> &V, const mat3<f32> &M)
+    {
+        simd_f32x4 Row = SimdMul(SimdSplat(V.x), SimdLoad3(M.m[0]));
+        Row = SimdMulAdd(SimdSplat(V.y), SimdLoad3(M.m[1]), Row);
+        Row = SimdMulAdd(SimdSplat(V.z), SimdLoad3(M.m[2]), Row);
+
+        vec3<f32> Result;
+        SimdStore3(Result.E, Row);
+        return Result;
+    }
+
+    // NOTE: The rows of the adjoint's transpose are the cross products of the rows, so the inverse is three crosses,
+    // a dot for the determinant and a transpose.
+    template <>
+    inline mat3<f32>
+    mat3<f32>::Inverse() const
+    {
+        simd_f32x4 R0 = SimdLoad3(this->m[0]);
+        simd_f32x4 R1 = SimdLoad3(this->m[1]);
+        simd_f32x4 R2 = SimdLoad3(this->m[2]);
+
+        simd_f32x4 C0 = SimdCross3(R1, R2);
+        simd_f32x4 C1 = SimdCross3(R2, R0);
+        simd_f32x4 C2 = SimdCross3(R0, R1);
+        f32 det = SimdDot3(R0, C0);
+        ASSERT(det != 0.0f);
+
+        simd_f32x4 C3 = SimdZero();
+        SimdTranspose4(C0, C1, C2, C3);
+        simd_f32x4 Det = SimdSplat(det);
+
+        mat3<f32> Result;
+        SimdStore3(Result.m[0], SimdDiv(C0, Det));
+        SimdStore3(Result.m[1], SimdDiv(C1, Det));
+        SimdStore3(Result.m[2], SimdDiv(C2, Det));
+
+        return Result;
+    }
+
+    template <>
+    inline mat4<f32>
+    operator+(const mat4<f32> &M1, const mat4<f32> &M2)
+    {
+        mat4<f32> Result;
+        for (u32 i = 0; i < 4; ++i)
+        {
+            SimdStore(Result.m[i], SimdAdd(SimdLoad(M1.m[i]), SimdLoad(M2.m[i])));
+        }
+
+        return Result;
+    }
+
+    template <>
+    inline mat4<f32>
+    operator-(const mat4<f32> &M1, const mat4<f32> &M2)
+    {
+        mat4<f32> Result;
+        for (u32 i = 0; i < 4; ++i)
+        {
+            SimdStore(Result.m[i], SimdSub(SimdLoad(M1.m[i]), SimdLoad(M2.m[i])));
+        }
+
+        return Result;
+    }
+
+    template <>
+    inline mat4<f32>
+    operator*(const mat4<f32> &M1, f32 B)
+    {
+        simd_f32x4 b = SimdSplat(B);
+
+        mat4<f32> Result;
+        for (u32 i = 0; i < 4; ++i)
+        {
+            SimdStore(Result.m[i], SimdMul(SimdLoad(M1.m[i]), b));
+        }
+
+        return Result;
+    }
+
+    template <>
+    inline mat4<f32>
+    operator*(const mat4<f32> &M1, const mat4<f32> &M2)
+    {
+        simd_f32x4 B0 = SimdLoad(M2.m[0]);
+        simd_f32x4 B1 = SimdLoad(M2.m[1]);
+        simd_f32x4 B2 = SimdLoad(M2.m[2]);
+        simd_f32x4 B3 = SimdLoad(M2.m[3]);
+
+        mat4<f32> Result;
+        for (u32 i = 0; i < 4; ++i)
+        {
+            simd_f32x4 Row = SimdMul(SimdSplat(M1.m[i][0]), B0);
+            Row = SimdMulAdd(SimdSplat(M1.m[i][1]), B1, Row);
+            Row = SimdMulAdd(SimdSplat(M1.m[i][2]), B2, Row);
+            Row = SimdMulAdd(SimdSplat(M1.m[i][3]), B3, Row);
+            SimdStore(Result.m[i], Row);
+        }
+
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator*(const vec4<f32> &V, const mat4<f32> &M)
+    {
+        simd_f32x4 Row = SimdMul(SimdSplat(V.x), SimdLoad(M.m[0]));
+        Row = SimdMulAdd(SimdSplat(V.y), SimdLoad(M.m[1]), Row);
+        Row = SimdMulAdd(SimdSplat(V.z), SimdLoad(M.m[2]), Row);
+        Row = SimdMulAdd(SimdSplat(V.w), SimdLoad(M.m[3]), Row);
+
+        vec4<f32> Result;
+        SimdStore(Result.E, Row);
+        return Result;
+    }
+
+    // NOTE: Dots the rows with V, done as the columns scaled by the components of V.
+    inline simd_f32x4
+    SimdMat4MulColumnVec(const mat4<f32> &M, simd_f32x4 V)
+    {
+        simd_f32x4 C0 = SimdLoad(M.m[0]);
+        simd_f32x4 C1 = SimdLoad(M.m[1]);
+        simd_f32x4 C2 = SimdLoad(M.m[2]);
+        simd_f32x4 C3 = SimdLoad(M.m[3]);
+        SimdTranspose4(C0, C1, C2, C3);
+
+        simd_f32x4 Result = SimdMul(SimdSplatLane<0>(V), C0);
+        Result = SimdMulAdd(SimdSplatLane<1>(V), C1, Result);
+        Result = SimdMulAdd(SimdSplatLane<2>(V), C2, Result);
+        Result = SimdMulAdd(SimdSplatLane<3>(V), C3, Result);
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator*(const mat4<f32> &M, const vec4<f32> &V)
+    {
+        vec4<f32> Result;
+        SimdStore(Result.E, SimdMat4MulColumnVec(M, SimdLoad(V.E)));
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator*(const mat4<f32> &M, const vec3<f32> &V)
+    {
+        vec4<f32> Result;
+        SimdStore(Result.E, SimdMat4MulColumnVec(M, SimdSet(V.x, V.y, V.z, 1.0f)));
+        return Result;
+    }
+
+    template <>
+    inline mat4<f32>
+    Transpose(const mat4<f32> &M)
+    {
+        simd_f32x4 R0 = SimdLoad(M.m[0]);
+        simd_f32x4 R1 = SimdLoad(M.m[1]);
+        simd_f32x4 R2 = SimdLoad(M.m[2]);
+        simd_f32x4 R3 = SimdLoad(M.m[3]);
+        SimdTranspose4(R0, R1, R2, R3);
+
+        mat4<f32> Result;
+        SimdStore(Result.m[0], R0);
+        SimdStore(Result.m[1], R1);
+        SimdStore(Result.m[2], R2);
+        SimdStore(Result.m[3], R3);
+        return Result;
+    }
+#endif
 }
 
 #endif // MATH_MATRIX_H
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "math_matrix_transforms.h"
+#include "math_wide.h"
 
 
 namespace shu
@@ -20,27 +21,52 @@ namespace shu
     TRS(const shu::vec3f &Pos, const shu::vec3f &Scale,
         const f32 RotationAngleDegrees, const shu::vec3f &RotationAxis)
     {
-        shu::mat4f Model = shu::Mat4f(1.0f);
-
-        shu::Scale(Model, Scale);
-        shu::Rotate(Model, shu::QuatAngleAxisDeg(RotationAngleDegrees, RotationAxis));
-        shu::Translate(Model, Pos);
-
+        shu::mat4f Model = TRS(Pos, Scale, shu::QuatAngleAxisDeg(RotationAngleDegrees, RotationAxis));
         return Model;
     }
 
+    // NOTE: The same matrix as Scale, Rotate and Translate on an identity matrix, built straight from the rows of the
+    // rotation instead of through a full matrix product. The scale only scales the rows.
     mat4f
     TRS(const shu::vec3f &Pos, const shu::vec3f &Scale, const shu::quat Rotation)
     {
-        shu::mat4f Model = shu::Mat4f(1.0f);
+        f32 w = Rotation.real;
+        f32 x = Rotation.complex.x;
+        f32 y = Rotation.complex.y;
+        f32 z = Rotation.complex.z;
 
-        shu::Scale(Model, Scale);
-        shu::Rotate(Model, Rotation);
-        shu::Translate(Model, Pos);
+        shu::vec4f Row0 = shu::Vec4f(1.0f - 2.0f*y*y - 2.0f*z*z,    2.0f*x*y + 2.0f*w*z,            2.0f*x*z - 2.0f*w*y,            0.0f);
+        shu::vec4f Row1 = shu::Vec4f(2.0f*x*y - 2.0f*w*z,           1.0f - 2.0f*x*x - 2.0f*z*z,     2.0f*y*z + 2.0f*w*x,            0.0f);
+        shu::vec4f Row2 = shu::Vec4f(2.0f*x*z + 2.0f*w*y,           2.0f*y*z - 2.0f*w*x,            1.0f - 2.0f*x*x - 2.0f*y*y,     0.0f);
+        shu::vec4f Row3 = shu::Vec4f(Pos, 1.0f);
 
+        shu::mat4f Model = shu::Mat4f(Row0*Scale.x, Row1*Scale.y, Row2*Scale.z, Row3);
         return Model;
     }
 
+    void
+    TRSBatch(const shu::vec3f *Positions, const shu::vec3f *Scales, const shu::quat *Rotations, i32 Count,
+             mat4f *Out)
+    {
+        for(i32 First = 0; First < Count; First += 8)
+        {
+            const i32 LaneCount = MIN(8, Count - First);
+            vec3x8 Row0, Row1, Row2;
+            QuatToMat3Rows(LoadQuat<f32x8>(Rotations + First, LaneCount), Row0, Row1, Row2);
+
+            vec3x8 Scale = LoadVec3<f32x8>(Scales + First, LaneCount);
+            vec3f Rows[3][8];
+            StoreVec3(Rows[0], Row0*Scale.x, LaneCount);
+            StoreVec3(Rows[1], Row1*Scale.y, LaneCount);
+            StoreVec3(Rows[2], Row2*Scale.z, LaneCount);
+            for(i32 i = 0; i < LaneCount; ++i)
+            {
+                Out[First + i] = shu::Mat4f(shu::Vec4f(Rows[0][i], 0.0f), shu::Vec4f(Rows[1][i], 0.0f),
+                                            shu::Vec4f(Rows[2][i], 0.0f), shu::Vec4f(Positions[First + i], 1.0f));
+            }
+        }
+    }
+
     mat4f
     Rotate(mat4f &Mat, const quat &Q)
     {
@@ -15,6 +15,9 @@ namespace shu
     SHU_EXPORT mat4f TRS(const shu::vec3f &Pos, const shu::vec3f &Scale, const f32 RotationAngle,
                          const shu::vec3f &RotationAxis);
     SHU_EXPORT mat4f TRS(const shu::vec3f &Pos, const shu::vec3f &Scale, const shu::quat Rotation);
+    // NOTE: Out[i] = TRS(Positions[i], Scales[i], Rotations[i]), 8 at a time.
+    SHU_EXPORT void TRSBatch(const shu::vec3f *Positions, const shu::vec3f *Scales, const shu::quat *Rotations,
+                             i32 Count, mat4f *Out);
     SHU_EXPORT mat4f RotateGimbalLock(mat4f &Mat, const vec3f &Axis, f32 AngleInDegrees);
     SHU_EXPORT mat4f Rotate(mat4f &Mat, const quat &Q);
     SHU_EXPORT mat3f QuatRotationMatrix_Left(const quat &Q);
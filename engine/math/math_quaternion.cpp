@@ -101,6 +101,16 @@ namespace shu
     {
         quat Result;
 
+#if SHU_MATH_SIMD != SHU_MATH_SIMD_NONE
+        // NOTE: The lanes are w, x, y, z. Every component of A scales B shuffled and with some signs flipped.
+        simd_f32x4 b = SimdLoad(B.E);
+        simd_f32x4 R = SimdMul(SimdSplat(A.w), b);
+        R = SimdMulAdd(SimdSplat(A.vx), SimdMul(SimdSwizzle<1, 0, 3, 2>(b), SimdSet(-1.0f,  1.0f, -1.0f,  1.0f)), R);
+        R = SimdMulAdd(SimdSplat(A.vy), SimdMul(SimdSwizzle<2, 3, 0, 1>(b), SimdSet(-1.0f,  1.0f,  1.0f, -1.0f)), R);
+        R = SimdMulAdd(SimdSplat(A.vz), SimdMul(SimdSwizzle<3, 2, 1, 0>(b), SimdSet(-1.0f, -1.0f,  1.0f,  1.0f)), R);
+        SimdStore(Result.E, R);
+#else
+
         vec3f P = shu::Vec3f(A.vx, A.vy, A.vz);
         vec3f Q = shu::Vec3f(B.vx, B.vy, B.vz);
 
@@ -113,6 +123,7 @@ namespace shu
         Result.vx = T.x;
         Result.vy = T.y;
         Result.vz = T.z;
+#endif
 
         return Result;
     }
@@ -413,6 +424,22 @@ namespace shu
     vec3f
     QuatRotateVec(const quat &Q, const vec3f &V)
     {
+#if SHU_MATH_SIMD != SHU_MATH_SIMD_NONE
+        // NOTE: v' = v + w*t + u x t with t = 2(u x v), where w and u are the real and complex parts of the
+        // normalized quaternion. The same rotation as q*v*q^-1 without the two full quaternion products.
+        simd_f32x4 q = SimdDiv(SimdLoad(Q.E), SimdSplat(QuatMagnitude(Q)));
+        simd_f32x4 u = SimdSwizzle<1, 2, 3, 0>(q);
+        simd_f32x4 v = SimdLoad3(V.E);
+
+        simd_f32x4 t = SimdCross3(u, v);
+        t = SimdAdd(t, t);
+        simd_f32x4 Rotated = SimdMulAdd(SimdSplatLane<3>(u), t, v);
+        Rotated = SimdAdd(Rotated, SimdCross3(u, t));
+
+        vec3f Result;
+        SimdStore3(Result.E, Rotated);
+        return Result;
+#else
         shu::quat qNormalized = shu::QuatNormalize(Q);
 
         quat InvQ = QuatConjugate(qNormalized);
@@ -421,6 +448,7 @@ namespace shu
 
         vec3f Result = qProduct.complex;
         return Result;
+#endif
     }
 
     vec3f
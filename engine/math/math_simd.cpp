@@ -0,0 +1,111 @@
+#include "math.h"
+
+#if _SHU_DEBUG
+#include <utils/random/random.h>
+
+namespace shu
+{
+    static b32
+    NearlyEqualArrays(const f32 *A, const f32 *B, i32 Count, f32 Epsilon)
+    {
+        for(i32 i = 0; i < Count; ++i)
+        {
+            if(!NearlyEqual(A[i], B[i], Epsilon))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // NOTE: Checks the f32 operators against the plain loops. Passes on the scalar code too, so it can be run with
+    // and without a SIMD backend.
+    void
+    MathSimdTest()
+    {
+        shoora_random Random(0x517d);
+        for(i32 Iteration = 0; Iteration < 1000; ++Iteration)
+        {
+            mat4f A, B;
+            for(i32 i = 0; i < 16; ++i)
+            {
+                A.E[i] = Random.Between(-4.0f, 4.0f);
+                B.E[i] = Random.Between(-4.0f, 4.0f);
+            }
+            vec4f V = Vec4f(Random.Between(-4.0f, 4.0f), Random.Between(-4.0f, 4.0f), Random.Between(-4.0f, 4.0f),
+                            Random.Between(-4.0f, 4.0f));
+
+            mat4f ExpectedAB = {};
+            vec4f ExpectedAV = {};
+            vec4f ExpectedVA = {};
+            for(i32 i = 0; i < 4; ++i)
+            {
+                for(i32 j = 0; j < 4; ++j)
+                {
+                    for(i32 k = 0; k < 4; ++k)
+                    {
+                        ExpectedAB.m[i][j] += A.m[i][k]*B.m[k][j];
+                    }
+                    ExpectedAV.E[i] += A.m[i][j]*V.E[j];
+                    ExpectedVA.E[i] += V.E[j]*A.m[j][i];
+                }
+            }
+
+            mat4f AB = A*B;
+            vec4f AV = A*V;
+            vec4f VA = V*A;
+            ASSERT(NearlyEqualArrays(AB.E, ExpectedAB.E, 16, 1e-3f));
+            ASSERT(NearlyEqualArrays(AV.E, ExpectedAV.E, 4, 1e-3f));
+            ASSERT(NearlyEqualArrays(VA.E, ExpectedVA.E, 4, 1e-3f));
+            ASSERT(NearlyEqual(Dot(V, V), V.x*V.x + V.y*V.y + V.z*V.z + V.w*V.w, 1e-3f));
+
+            mat4f At = Transpose(A);
+            for(i32 i = 0; i < 16; ++i)
+            {
+                ASSERT(At.m[i / 4][i % 4] == A.m[i % 4][i / 4]);
+            }
+
+            // NOTE: Rotation times a scale, so the matrix is never close to singular.
+            quat Q = QuatNormalize(Quat(Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f),
+                                        Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f)));
+            vec3f Scale = Vec3f(Random.Between(0.5f, 2.0f), Random.Between(0.5f, 2.0f), Random.Between(0.5f, 2.0f));
+            mat3f M = Q.ToMat3f() * Mat3f(Scale.x, 0, 0, 0, Scale.y, 0, 0, 0, Scale.z);
+            mat3f Identity = M * M.Inverse();
+            for(i32 i = 0; i < 9; ++i)
+            {
+                ASSERT(NearlyEqual(Identity.E[i], (i % 4 == 0) ? 1.0f : 0.0f, 1e-4f));
+            }
+
+            // NOTE: The rotation against the full quaternion product q*v*q^-1 written out.
+            vec3f P = Vec3f(Random.Between(-4.0f, 4.0f), Random.Between(-4.0f, 4.0f), Random.Between(-4.0f, 4.0f));
+            vec3f u = Vec3f(Q.vx, Q.vy, Q.vz);
+            vec3f ExpectedP = u*(2.0f*Dot(u, P)) + P*(Q.w*Q.w - Dot(u, u)) + Cross(u, P)*(2.0f*Q.w);
+            vec3f RotatedP = QuatRotateVec(Q, P);
+            ASSERT(NearlyEqualArrays(RotatedP.E, ExpectedP.E, 3, 1e-4f));
+
+            quat QB = QuatNormalize(Quat(Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f),
+                                         Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f)));
+            quat QQ = Q * QB;
+            vec3f ExpectedQQ = Cross(u, Vec3f(QB.vx, QB.vy, QB.vz)) + Vec3f(QB.vx, QB.vy, QB.vz)*Q.w + u*QB.w;
+            ASSERT(NearlyEqual(QQ.w, Q.w*QB.w - Dot(u, Vec3f(QB.vx, QB.vy, QB.vz)), 1e-5f));
+            ASSERT(NearlyEqualArrays(&QQ.vx, ExpectedQQ.E, 3, 1e-5f));
+
+            mat4f Model = Mat4f(1.0f);
+            shu::Scale(Model, Scale);
+            Rotate(Model, Q);
+            Translate(Model, P);
+            mat4f ModelTRS = TRS(P, Scale, Q);
+            ASSERT(NearlyEqualArrays(Model.E, ModelTRS.E, 16, 1e-5f));
+        }
+
+        vec3fa A = Vec3fa(1, 2, 3);
+        vec3fa B = Vec3fa(Vec3f(-4, 5, 0.5f));
+        vec3f C = ToVec3f(Cross(A, B));
+        ASSERT(C == Cross(Vec3f(1, 2, 3), Vec3f(-4, 5, 0.5f)));
+        ASSERT(Dot(A, B) == 7.5f);
+        ASSERT((A + B*2.0f).Pad == 0.0f);
+
+        LogInfo("[Math SIMD Test]: Passed with backend %d.\n", SHU_MATH_SIMD);
+    }
+} // namespace shu
+#endif
@@ -0,0 +1,226 @@
+#if !defined(MATH_SIMD_H)
+
+#include "defines.h"
+
+// NOTE: SIMD backend for the f32 vec4, mat3, mat4 and quat math. It is picked at compile time by defining
+// SHU_MATH_SIMD(the SHU_MATH_SIMD cmake option does this). It is off by default, the SIMD code does not round
+// exactly like the scalar code(AVX2 and NEON fuse the multiply adds), so a build which has to match the scalar
+// results bit for bit keeps it off.
+// The math types keep their layout and are not aligned any more than they were, every load and store here is
+// unaligned. vec3fa is the one type which is padded and aligned for it.
+#define SHU_MATH_SIMD_NONE 0
+#define SHU_MATH_SIMD_SSE41 1
+#define SHU_MATH_SIMD_AVX2 2
+#define SHU_MATH_SIMD_NEON 3
+
+#if !defined(SHU_MATH_SIMD)
+#define SHU_MATH_SIMD SHU_MATH_SIMD_NONE
+#endif
+
+#if SHU_MATH_SIMD == SHU_MATH_SIMD_SSE41
+#include <smmintrin.h>
+#define SHU_MATH_SIMD_SSE 1
+#elif SHU_MATH_SIMD == SHU_MATH_SIMD_AVX2
+#include <immintrin.h>
+#define SHU_MATH_SIMD_SSE 1
+#elif SHU_MATH_SIMD == SHU_MATH_SIMD_NEON
+#include <arm_neon.h>
+#elif SHU_MATH_SIMD != SHU_MATH_SIMD_NONE
+#error "Unknown SHU_MATH_SIMD backend."
+#endif
+
+#if SHU_MATH_SIMD != SHU_MATH_SIMD_NONE
+namespace shu
+{
+#if SHU_MATH_SIMD_SSE
+    typedef __m128 simd_f32x4;
+#else
+    typedef float32x4_t simd_f32x4;
+#endif
+
+    inline simd_f32x4
+    SimdLoad(const f32 *Ptr)
+    {
+#if SHU_MATH_SIMD_SSE
+        return _mm_loadu_ps(Ptr);
+#else
+        return vld1q_f32(Ptr);
+#endif
+    }
+
+    // NOTE: x, y, z and zero in w. Does not read past Ptr[2], so it works on the last row of a mat3.
+    inline simd_f32x4
+    SimdLoad3(const f32 *Ptr)
+    {
+#if SHU_MATH_SIMD_SSE
+        __m128 xy = _mm_castsi128_ps(_mm_loadu_si64(Ptr));
+        return _mm_movelh_ps(xy, _mm_load_ss(Ptr + 2));
+#else
+        return vcombine_f32(vld1_f32(Ptr), vset_lane_f32(Ptr[2], vdup_n_f32(0.0f), 0));
+#endif
+    }
+
+    inline void
+    SimdStore(f32 *Ptr, simd_f32x4 V)
+    {
+#if SHU_MATH_SIMD_SSE
+        _mm_storeu_ps(Ptr, V);
+#else
+        vst1q_f32(Ptr, V);
+#endif
+    }
+
+    inline void
+    SimdStore3(f32 *Ptr, simd_f32x4 V)
+    {
+#if SHU_MATH_SIMD_SSE
+        _mm_storeu_si64(Ptr, _mm_castps_si128(V));
+        _mm_store_ss(Ptr + 2, _mm_movehl_ps(V, V));
+#else
+        vst1_f32(Ptr, vget_low_f32(V));
+        vst1q_lane_f32(Ptr + 2, V, 2);
+#endif
+    }
+
+    inline simd_f32x4
+    SimdSet(f32 x, f32 y, f32 z, f32 w)
+    {
+#if SHU_MATH_SIMD_SSE
+        return _mm_setr_ps(x, y, z, w);
+#else
+        f32 Lanes[4] = {x, y, z, w};
+        return vld1q_f32(Lanes);
+#endif
+    }
+
+    inline simd_f32x4
+    SimdSplat(f32 A)
+    {
+#if SHU_MATH_SIMD_SSE
+        return _mm_set1_ps(A);
+#else
+        return vdupq_n_f32(A);
+#endif
+    }
+
+    inline simd_f32x4
+    SimdZero()
+    {
+#if SHU_MATH_SIMD_SSE
+        return _mm_setzero_ps();
+#else
+        return vdupq_n_f32(0.0f);
+#endif
+    }
+
+#if SHU_MATH_SIMD_SSE
+    inline simd_f32x4 SimdAdd(simd_f32x4 A, simd_f32x4 B) { return _mm_add_ps(A, B); }
+    inline simd_f32x4 SimdSub(simd_f32x4 A, simd_f32x4 B) { return _mm_sub_ps(A, B); }
+    inline simd_f32x4 SimdMul(simd_f32x4 A, simd_f32x4 B) { return _mm_mul_ps(A, B); }
+    inline simd_f32x4 SimdDiv(simd_f32x4 A, simd_f32x4 B) { return _mm_div_ps(A, B); }
+    inline simd_f32x4 SimdMin(simd_f32x4 A, simd_f32x4 B) { return _mm_min_ps(A, B); }
+    inline simd_f32x4 SimdMax(simd_f32x4 A, simd_f32x4 B) { return _mm_max_ps(A, B); }
+    inline simd_f32x4 SimdSqrt(simd_f32x4 A) { return _mm_sqrt_ps(A); }
+#else
+    inline simd_f32x4 SimdAdd(simd_f32x4 A, simd_f32x4 B) { return vaddq_f32(A, B); }
+    inline simd_f32x4 SimdSub(simd_f32x4 A, simd_f32x4 B) { return vsubq_f32(A, B); }
+    inline simd_f32x4 SimdMul(simd_f32x4 A, simd_f32x4 B) { return vmulq_f32(A, B); }
+    inline simd_f32x4 SimdDiv(simd_f32x4 A, simd_f32x4 B) { return vdivq_f32(A, B); }
+    inline simd_f32x4 SimdMin(simd_f32x4 A, simd_f32x4 B) { return vminq_f32(A, B); }
+    inline simd_f32x4 SimdMax(simd_f32x4 A, simd_f32x4 B) { return vmaxq_f32(A, B); }
+    inline simd_f32x4 SimdSqrt(simd_f32x4 A) { return vsqrtq_f32(A); }
+#endif
+
+    // NOTE: A*B + C.
+    inline simd_f32x4
+    SimdMulAdd(simd_f32x4 A, simd_f32x4 B, simd_f32x4 C)
+    {
+#if SHU_MATH_SIMD == SHU_MATH_SIMD_AVX2
+        return _mm_fmadd_ps(A, B, C);
+#elif SHU_MATH_SIMD_SSE
+        return _mm_add_ps(_mm_mul_ps(A, B), C);
+#else
+        return vfmaq_f32(C, A, B);
+#endif
+    }
+
+    // NOTE: Lane i of the result is the lane of V named by the i-th template argument.
+    template <i32 X, i32 Y, i32 Z, i32 W>
+    inline simd_f32x4
+    SimdSwizzle(simd_f32x4 V)
+    {
+#if SHU_MATH_SIMD_SSE
+        return _mm_shuffle_ps(V, V, _MM_SHUFFLE(W, Z, Y, X));
+#else
+        return SimdSet(vgetq_lane_f32(V, X), vgetq_lane_f32(V, Y), vgetq_lane_f32(V, Z), vgetq_lane_f32(V, W));
+#endif
+    }
+
+    template <i32 Lane>
+    inline simd_f32x4
+    SimdSplatLane(simd_f32x4 V)
+    {
+#if SHU_MATH_SIMD_SSE
+        return _mm_shuffle_ps(V, V, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+#else
+        return vdupq_laneq_f32(V, Lane);
+#endif
+    }
+
+    inline f32
+    SimdDot4(simd_f32x4 A, simd_f32x4 B)
+    {
+#if SHU_MATH_SIMD_SSE
+        return _mm_cvtss_f32(_mm_dp_ps(A, B, 0xF1));
+#else
+        return vaddvq_f32(vmulq_f32(A, B));
+#endif
+    }
+
+    // NOTE: Ignores w.
+    inline f32
+    SimdDot3(simd_f32x4 A, simd_f32x4 B)
+    {
+#if SHU_MATH_SIMD_SSE
+        return _mm_cvtss_f32(_mm_dp_ps(A, B, 0x71));
+#else
+        return vaddvq_f32(vsetq_lane_f32(0.0f, vmulq_f32(A, B), 3));
+#endif
+    }
+
+    // NOTE: Cross product of the xyz lanes, w is A.w*B.w - A.w*B.w, which is zero for finite inputs.
+    inline simd_f32x4
+    SimdCross3(simd_f32x4 A, simd_f32x4 B)
+    {
+        simd_f32x4 A_yzx = SimdSwizzle<1, 2, 0, 3>(A);
+        simd_f32x4 B_yzx = SimdSwizzle<1, 2, 0, 3>(B);
+        simd_f32x4 Result = SimdSub(SimdMul(A, B_yzx), SimdMul(A_yzx, B));
+        return SimdSwizzle<1, 2, 0, 3>(Result);
+    }
+
+    inline void
+    SimdTranspose4(simd_f32x4 &R0, simd_f32x4 &R1, simd_f32x4 &R2, simd_f32x4 &R3)
+    {
+#if SHU_MATH_SIMD_SSE
+        _MM_TRANSPOSE4_PS(R0, R1, R2, R3);
+#else
+        float32x4x2_t T01 = vtrnq_f32(R0, R1);
+        float32x4x2_t T23 = vtrnq_f32(R2, R3);
+        R0 = vcombine_f32(vget_low_f32(T01.val[0]), vget_low_f32(T23.val[0]));
+        R1 = vcombine_f32(vget_low_f32(T01.val[1]), vget_low_f32(T23.val[1]));
+        R2 = vcombine_f32(vget_high_f32(T01.val[0]), vget_high_f32(T23.val[0]));
+        R3 = vcombine_f32(vget_high_f32(T01.val[1]), vget_high_f32(T23.val[1]));
+#endif
+    }
+} // namespace shu
+#endif // SHU_MATH_SIMD != SHU_MATH_SIMD_NONE
+
+#if _SHU_DEBUG
+namespace shu
+{
+    void MathSimdTest();
+}
+#endif
+
+#define MATH_SIMD_H
+#endif // MATH_SIMD_H
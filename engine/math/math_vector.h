@@ -2,6 +2,7 @@
 #include "defines.h"
 #include <platform/platform.h>
 #include "math_trig.h"
+#include "math_simd.h"
 #include <cmath>
 
 namespace shu
@@ -232,6 +233,26 @@ namespace shu
     #define Vec4u Vec4<u32>
     #define Vec4i Vec4<i32>
 
+    // NOTE: vec3f padded to 16 bytes and aligned to 16, so it is one load into a SIMD register. Pad is kept at zero.
+    struct alignas(16) vec3fa
+    {
+        union
+        {
+            struct { f32 x, y, z, Pad; };
+            vec3f xyz;
+            f32 E[4];
+        };
+    };
+
+    inline vec3fa Vec3fa(f32 x, f32 y, f32 z);
+    inline vec3fa Vec3fa(const vec3f &V);
+    inline vec3f ToVec3f(const vec3fa &V);
+    inline f32 Dot(const vec3fa &A, const vec3fa &B);
+    inline vec3fa Cross(const vec3fa &A, const vec3fa &B);
+    inline vec3fa operator+(const vec3fa &A, const vec3fa &B);
+    inline vec3fa operator-(const vec3fa &A, const vec3fa &B);
+    inline vec3fa operator*(const vec3fa &A, f32 B);
+
     template <typename T>
     struct vec6
     {
@@ -1262,6 +1283,177 @@ namespace shu
         return Result;
     }
 
+#if SHU_MATH_SIMD != SHU_MATH_SIMD_NONE
+    // NOTE: f32 versions on the SIMD backend.
+    template <>
+    inline f32
+    Dot(const vec4<f32> &A, const vec4<f32> &B)
+    {
+        f32 Result = SimdDot4(SimdLoad(A.E), SimdLoad(B.E));
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator+(const vec4<f32> &A, const vec4<f32> &B)
+    {
+        vec4<f32> Result;
+        SimdStore(Result.E, SimdAdd(SimdLoad(A.E), SimdLoad(B.E)));
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator-(const vec4<f32> &A, const vec4<f32> &B)
+    {
+        vec4<f32> Result;
+        SimdStore(Result.E, SimdSub(SimdLoad(A.E), SimdLoad(B.E)));
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator*(const vec4<f32> &A, const vec4<f32> &B)
+    {
+        vec4<f32> Result;
+        SimdStore(Result.E, SimdMul(SimdLoad(A.E), SimdLoad(B.E)));
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator*(const vec4<f32> &A, f32 B)
+    {
+        vec4<f32> Result;
+        SimdStore(Result.E, SimdMul(SimdLoad(A.E), SimdSplat(B)));
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator/(const vec4<f32> &A, const vec4<f32> &B)
+    {
+        ASSERT(B.x != 0.0f && B.y != 0.0f && B.z != 0.0f && B.w != 0.0f);
+        vec4<f32> Result;
+        SimdStore(Result.E, SimdDiv(SimdLoad(A.E), SimdLoad(B.E)));
+        return Result;
+    }
+
+    template <>
+    inline vec4<f32>
+    operator/(const vec4<f32> &A, f32 B)
+    {
+        ASSERT(B != 0.0f);
+        vec4<f32> Result;
+        SimdStore(Result.E, SimdDiv(SimdLoad(A.E), SimdSplat(B)));
+        return Result;
+    }
+#endif
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Vec3fa
+    // ----------------------------------------------------------------------------------------------------------------
+    vec3fa
+    Vec3fa(f32 x, f32 y, f32 z)
+    {
+        vec3fa Result;
+        Result.x = x;
+        Result.y = y;
+        Result.z = z;
+        Result.Pad = 0.0f;
+        return Result;
+    }
+
+    vec3fa
+    Vec3fa(const vec3f &V)
+    {
+        vec3fa Result = Vec3fa(V.x, V.y, V.z);
+        return Result;
+    }
+
+    vec3f
+    ToVec3f(const vec3fa &V)
+    {
+        vec3f Result = V.xyz;
+        return Result;
+    }
+
+#if SHU_MATH_SIMD != SHU_MATH_SIMD_NONE
+    f32
+    Dot(const vec3fa &A, const vec3fa &B)
+    {
+        f32 Result = SimdDot3(SimdLoad(A.E), SimdLoad(B.E));
+        return Result;
+    }
+
+    vec3fa
+    Cross(const vec3fa &A, const vec3fa &B)
+    {
+        vec3fa Result;
+        SimdStore(Result.E, SimdCross3(SimdLoad(A.E), SimdLoad(B.E)));
+        return Result;
+    }
+
+    vec3fa
+    operator+(const vec3fa &A, const vec3fa &B)
+    {
+        vec3fa Result;
+        SimdStore(Result.E, SimdAdd(SimdLoad(A.E), SimdLoad(B.E)));
+        return Result;
+    }
+
+    vec3fa
+    operator-(const vec3fa &A, const vec3fa &B)
+    {
+        vec3fa Result;
+        SimdStore(Result.E, SimdSub(SimdLoad(A.E), SimdLoad(B.E)));
+        return Result;
+    }
+
+    vec3fa
+    operator*(const vec3fa &A, f32 B)
+    {
+        vec3fa Result;
+        SimdStore(Result.E, SimdMul(SimdLoad(A.E), SimdSet(B, B, B, 0.0f)));
+        return Result;
+    }
+#else
+    f32
+    Dot(const vec3fa &A, const vec3fa &B)
+    {
+        f32 Result = A.x*B.x + A.y*B.y + A.z*B.z;
+        return Result;
+    }
+
+    vec3fa
+    Cross(const vec3fa &A, const vec3fa &B)
+    {
+        vec3fa Result = Vec3fa(A.y*B.z - A.z*B.y, A.z*B.x - A.x*B.z, A.x*B.y - A.y*B.x);
+        return Result;
+    }
+
+    vec3fa
+    operator+(const vec3fa &A, const vec3fa &B)
+    {
+        vec3fa Result = Vec3fa(A.x + B.x, A.y + B.y, A.z + B.z);
+        return Result;
+    }
+
+    vec3fa
+    operator-(const vec3fa &A, const vec3fa &B)
+    {
+        vec3fa Result = Vec3fa(A.x - B.x, A.y - B.y, A.z - B.z);
+        return Result;
+    }
+
+    vec3fa
+    operator*(const vec3fa &A, f32 B)
+    {
+        vec3fa Result = Vec3fa(A.x*B, A.y*B, A.z*B);
+        return Result;
+    }
+#endif
+
     // ----------------------------------------------------------------------------------------------------------------
     // Vec6
     // ----------------------------------------------------------------------------------------------------------------
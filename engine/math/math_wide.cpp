@@ -0,0 +1,139 @@
+#include "math.h"
+
+#if _SHU_DEBUG
+#include <utils/random/random.h>
+
+namespace shu
+{
+    // NOTE: The wide and the scalar code may round differently, the compiler is free to fuse either of them into FMAs.
+    static b32
+    WideNearlyEqual(f32 A, f32 B)
+    {
+        f32 Scale = MAX(1.0f, MAX(SHU_ABSOLUTE(A), SHU_ABSOLUTE(B)));
+        b32 Result = NearlyEqual(A, B, 1e-5f*Scale);
+        return Result;
+    }
+
+    static b32
+    WideNearlyEqual(const vec3f &A, const vec3f &B)
+    {
+        b32 Result = WideNearlyEqual(A.x, B.x) && WideNearlyEqual(A.y, B.y) && WideNearlyEqual(A.z, B.z);
+        return Result;
+    }
+
+    // NOTE: Checks the wide types and the point loops against scalar loops over the same points.
+    void
+    MathWideTest()
+    {
+        shoora_random Random(0x3a1e);
+        vec3f Points[37];
+        for(i32 Iteration = 0; Iteration < 1000; ++Iteration)
+        {
+            i32 Count = Random.Between(1, (i32)ARRAY_SIZE(Points));
+            for(i32 i = 0; i < Count; ++i)
+            {
+                Points[i] = Vec3f(Random.Between(-8.0f, 8.0f), Random.Between(-8.0f, 8.0f), Random.Between(-8.0f, 8.0f));
+            }
+            // NOTE: A copy of an earlier point, so the first of two equal dots has to be picked.
+            if(Count > 2)
+            {
+                Points[Count - 1] = Points[Count / 2];
+            }
+            vec3f Direction = Vec3f(Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f));
+
+            i32 ExpectedIndex = 0;
+            f32 ExpectedDot = Points[0].Dot(Direction);
+            vec3f ExpectedMins = Points[0], ExpectedMaxs = Points[0];
+            for(i32 i = 1; i < Count; ++i)
+            {
+                f32 PointDot = Points[i].Dot(Direction);
+                if(PointDot > ExpectedDot)
+                {
+                    ExpectedDot = PointDot;
+                    ExpectedIndex = i;
+                }
+                ExpectedMins = Vec3f(MIN(ExpectedMins.x, Points[i].x), MIN(ExpectedMins.y, Points[i].y),
+                                     MIN(ExpectedMins.z, Points[i].z));
+                ExpectedMaxs = Vec3f(MAX(ExpectedMaxs.x, Points[i].x), MAX(ExpectedMaxs.y, Points[i].y),
+                                     MAX(ExpectedMaxs.z, Points[i].z));
+            }
+
+            i32 Index;
+            f32 Dot = MaxDot(Points, Count, Direction, &Index);
+            // NOTE: Two dots which are a rounding apart can be picked either way.
+            ASSERT(Index == ExpectedIndex || WideNearlyEqual(Points[Index].Dot(Direction), ExpectedDot));
+            ASSERT(WideNearlyEqual(Dot, ExpectedDot));
+
+            vec3f Mins, Maxs;
+            MinMaxPoints(Points, Count, Mins, Maxs);
+            ASSERT(Mins == ExpectedMins);
+            ASSERT(Maxs == ExpectedMaxs);
+
+            // NOTE: Rotations and products, lane by lane.
+            quat Q = QuatNormalize(Quat(Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f),
+                                        Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f)));
+            quat QB = QuatNormalize(Quat(Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f),
+                                         Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f)));
+            i32 WideCount = MIN(Count, 4);
+            vec3f Rotated[4];
+            StoreVec3(Rotated, QuatRotateVec(SplatQuat<f32x4>(Q), LoadVec3<f32x4>(Points, WideCount)), WideCount);
+            for(i32 i = 0; i < WideCount; ++i)
+            {
+                ASSERT(WideNearlyEqual(Rotated[i], QuatRotateVec(Q, Points[i])));
+            }
+
+            quatx4 QQ = SplatQuat<f32x4>(Q) * SplatQuat<f32x4>(QB);
+            quat ExpectedQQ = Q * QB;
+            f32 Lanes[4];
+            StoreF32x4(Lanes, QQ.w);
+            ASSERT(NearlyEqual(Lanes[3], ExpectedQQ.w, 1e-5f));
+            StoreF32x4(Lanes, QQ.z);
+            ASSERT(NearlyEqual(Lanes[0], ExpectedQQ.vz, 1e-5f));
+
+            vec3x8 A = LoadVec3<f32x8>(Points, MIN(Count, 8));
+            vec3x8 B = SplatVec3<f32x8>(Direction);
+            vec3f Crossed[8];
+            StoreVec3(Crossed, Cross(A, B), MIN(Count, 8));
+            for(i32 i = 0; i < MIN(Count, 8); ++i)
+            {
+                ASSERT(WideNearlyEqual(Crossed[i], Cross(Points[i], Direction)));
+            }
+        }
+
+        // NOTE: The batched TRS and point transforms against the one at a time versions.
+        vec3f Positions[13], Scales[13];
+        quat Rotations[13];
+        mat4f Models[13];
+        for(i32 i = 0; i < 13; ++i)
+        {
+            Positions[i] = Vec3f(Random.Between(-8.0f, 8.0f), Random.Between(-8.0f, 8.0f), Random.Between(-8.0f, 8.0f));
+            Scales[i] = Vec3f(Random.Between(0.5f, 2.0f), Random.Between(0.5f, 2.0f), Random.Between(0.5f, 2.0f));
+            Rotations[i] = QuatNormalize(Quat(Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f),
+                                              Random.Between(-1.0f, 1.0f), Random.Between(-1.0f, 1.0f)));
+        }
+        TRSBatch(Positions, Scales, Rotations, 13, Models);
+        for(i32 i = 0; i < 13; ++i)
+        {
+            mat4f Expected = TRS(Positions[i], Scales[i], Rotations[i]);
+            for(i32 j = 0; j < 16; ++j)
+            {
+                ASSERT(NearlyEqual(Models[i].E[j], Expected.E[j], 1e-5f));
+            }
+        }
+
+        vec3f Transformed[13];
+        MulPoints(Models[0], Positions, 13, Transformed);
+        for(i32 i = 0; i < 13; ++i)
+        {
+            ASSERT(WideNearlyEqual(Transformed[i], (Models[0] * Positions[i]).xyz));
+        }
+
+        f32x4 Mask = F32x4(1, 5, 2, 8) > F32x4(3.0f);
+        ASSERT(MaskBits(Mask) == 0xA);
+        ASSERT(ReduceMin(Select(Mask, F32x4(9.0f), F32x4(4, 3, 2, 1))) == 2.0f);
+        ASSERT(ReduceMin(F32x4(4, 3, -2, 1)) == -2.0f);
+
+        LogInfo("[Math Wide Test]: Passed.\n");
+    }
+} // namespace shu
+#endif
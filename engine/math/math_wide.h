@@ -0,0 +1,578 @@
+#if !defined(MATH_WIDE_H)
+
+#include "defines.h"
+#include "math_simd.h"
+#include "math_vector.h"
+#include "math_matrix.h"
+#include "math_quaternion.h"
+
+// NOTE: Wide types for running one piece of math on 4 or 8 values at once. f32x4 and f32x8 hold one lane per value,
+// vec3x4/vec3x8 and quatx4/quatx8 keep every component in its own lane type(x of 8 points, then y, then z), so a
+// loop over points does 8 of them with no shuffles and no branches.
+// These are always on, they do not need SHU_MATH_SIMD. x86 always has SSE2 and ARM64 always has NEON, f32x8 is two
+// f32x4s unless the AVX2 backend is picked. Comparisons give masks(all bits set in the lanes where it is true) which
+// go to Select.
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#include <emmintrin.h>
+#define SHU_WIDE_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SHU_WIDE_NEON 1
+#endif
+
+#if SHU_MATH_SIMD == SHU_MATH_SIMD_AVX2
+#define SHU_WIDE_AVX 1
+#endif
+
+namespace shu
+{
+    // ----------------------------------------------------------------------------------------------------------------
+    // f32x4
+    // ----------------------------------------------------------------------------------------------------------------
+    struct f32x4
+    {
+        enum { LaneCount = 4 };
+#if SHU_WIDE_SSE
+        __m128 V;
+#elif SHU_WIDE_NEON
+        float32x4_t V;
+#else
+        union
+        {
+            f32 E[4];
+            u32 U[4];
+        };
+#endif
+    };
+
+#if SHU_WIDE_SSE
+    inline f32x4 F32x4(f32 A) { return {_mm_set1_ps(A)}; }
+    inline f32x4 F32x4(f32 x, f32 y, f32 z, f32 w) { return {_mm_setr_ps(x, y, z, w)}; }
+    inline f32x4 LoadF32x4(const f32 *Ptr) { return {_mm_loadu_ps(Ptr)}; }
+    inline void StoreF32x4(f32 *Ptr, f32x4 A) { _mm_storeu_ps(Ptr, A.V); }
+
+    inline f32x4 operator+(f32x4 A, f32x4 B) { return {_mm_add_ps(A.V, B.V)}; }
+    inline f32x4 operator-(f32x4 A, f32x4 B) { return {_mm_sub_ps(A.V, B.V)}; }
+    inline f32x4 operator*(f32x4 A, f32x4 B) { return {_mm_mul_ps(A.V, B.V)}; }
+    inline f32x4 operator/(f32x4 A, f32x4 B) { return {_mm_div_ps(A.V, B.V)}; }
+    inline f32x4 Min(f32x4 A, f32x4 B) { return {_mm_min_ps(A.V, B.V)}; }
+    inline f32x4 Max(f32x4 A, f32x4 B) { return {_mm_max_ps(A.V, B.V)}; }
+    inline f32x4 Sqrt(f32x4 A) { return {_mm_sqrt_ps(A.V)}; }
+
+    inline f32x4 operator<(f32x4 A, f32x4 B) { return {_mm_cmplt_ps(A.V, B.V)}; }
+    inline f32x4 operator>(f32x4 A, f32x4 B) { return {_mm_cmpgt_ps(A.V, B.V)}; }
+    inline f32x4 operator<=(f32x4 A, f32x4 B) { return {_mm_cmple_ps(A.V, B.V)}; }
+    inline f32x4 operator>=(f32x4 A, f32x4 B) { return {_mm_cmpge_ps(A.V, B.V)}; }
+    inline f32x4 operator&(f32x4 A, f32x4 B) { return {_mm_and_ps(A.V, B.V)}; }
+    inline f32x4 operator|(f32x4 A, f32x4 B) { return {_mm_or_ps(A.V, B.V)}; }
+
+    // NOTE: Mask ? A : B, per lane.
+    inline f32x4
+    Select(f32x4 Mask, f32x4 A, f32x4 B)
+    {
+        return {_mm_or_ps(_mm_and_ps(Mask.V, A.V), _mm_andnot_ps(Mask.V, B.V))};
+    }
+
+    // NOTE: Bit i is set if lane i of the mask is set.
+    inline u32 MaskBits(f32x4 Mask) { return (u32)_mm_movemask_ps(Mask.V); }
+
+    inline f32
+    ReduceMin(f32x4 A)
+    {
+        __m128 M = _mm_min_ps(A.V, _mm_shuffle_ps(A.V, A.V, _MM_SHUFFLE(1, 0, 3, 2)));
+        M = _mm_min_ps(M, _mm_shuffle_ps(M, M, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(M);
+    }
+
+    inline f32
+    ReduceMax(f32x4 A)
+    {
+        __m128 M = _mm_max_ps(A.V, _mm_shuffle_ps(A.V, A.V, _MM_SHUFFLE(1, 0, 3, 2)));
+        M = _mm_max_ps(M, _mm_shuffle_ps(M, M, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(M);
+    }
+#elif SHU_WIDE_NEON
+    inline f32x4 F32x4(f32 A) { return {vdupq_n_f32(A)}; }
+    inline f32x4 F32x4(f32 x, f32 y, f32 z, f32 w) { f32 Lanes[4] = {x, y, z, w}; return {vld1q_f32(Lanes)}; }
+    inline f32x4 LoadF32x4(const f32 *Ptr) { return {vld1q_f32(Ptr)}; }
+    inline void StoreF32x4(f32 *Ptr, f32x4 A) { vst1q_f32(Ptr, A.V); }
+
+    inline f32x4 operator+(f32x4 A, f32x4 B) { return {vaddq_f32(A.V, B.V)}; }
+    inline f32x4 operator-(f32x4 A, f32x4 B) { return {vsubq_f32(A.V, B.V)}; }
+    inline f32x4 operator*(f32x4 A, f32x4 B) { return {vmulq_f32(A.V, B.V)}; }
+    inline f32x4 operator/(f32x4 A, f32x4 B) { return {vdivq_f32(A.V, B.V)}; }
+    inline f32x4 Min(f32x4 A, f32x4 B) { return {vminq_f32(A.V, B.V)}; }
+    inline f32x4 Max(f32x4 A, f32x4 B) { return {vmaxq_f32(A.V, B.V)}; }
+    inline f32x4 Sqrt(f32x4 A) { return {vsqrtq_f32(A.V)}; }
+
+    inline f32x4 operator<(f32x4 A, f32x4 B) { return {vreinterpretq_f32_u32(vcltq_f32(A.V, B.V))}; }
+    inline f32x4 operator>(f32x4 A, f32x4 B) { return {vreinterpretq_f32_u32(vcgtq_f32(A.V, B.V))}; }
+    inline f32x4 operator<=(f32x4 A, f32x4 B) { return {vreinterpretq_f32_u32(vcleq_f32(A.V, B.V))}; }
+    inline f32x4 operator>=(f32x4 A, f32x4 B) { return {vreinterpretq_f32_u32(vcgeq_f32(A.V, B.V))}; }
+    inline f32x4
+    operator&(f32x4 A, f32x4 B)
+    {
+        return {vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(A.V), vreinterpretq_u32_f32(B.V)))};
+    }
+    inline f32x4
+    operator|(f32x4 A, f32x4 B)
+    {
+        return {vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(A.V), vreinterpretq_u32_f32(B.V)))};
+    }
+
+    inline f32x4 Select(f32x4 Mask, f32x4 A, f32x4 B) { return {vbslq_f32(vreinterpretq_u32_f32(Mask.V), A.V, B.V)}; }
+
+    inline u32
+    MaskBits(f32x4 Mask)
+    {
+        const i32 Shifts[4] = {0, 1, 2, 3};
+        uint32x4_t Bits = vshrq_n_u32(vreinterpretq_u32_f32(Mask.V), 31);
+        return vaddvq_u32(vshlq_u32(Bits, vld1q_s32(Shifts)));
+    }
+
+    inline f32 ReduceMin(f32x4 A) { return vminvq_f32(A.V); }
+    inline f32 ReduceMax(f32x4 A) { return vmaxvq_f32(A.V); }
+#else
+    inline f32x4 F32x4(f32 A) { f32x4 R; for(i32 i = 0; i < 4; ++i) { R.E[i] = A; } return R; }
+    inline f32x4 F32x4(f32 x, f32 y, f32 z, f32 w) { f32x4 R; R.E[0] = x; R.E[1] = y; R.E[2] = z; R.E[3] = w; return R; }
+    inline f32x4 LoadF32x4(const f32 *Ptr) { f32x4 R; for(i32 i = 0; i < 4; ++i) { R.E[i] = Ptr[i]; } return R; }
+    inline void StoreF32x4(f32 *Ptr, f32x4 A) { for(i32 i = 0; i < 4; ++i) { Ptr[i] = A.E[i]; } }
+
+#define SHU_WIDE_LANE_OP(Expression) f32x4 R; for(i32 i = 0; i < 4; ++i) { Expression; } return R;
+    inline f32x4 operator+(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.E[i] = A.E[i] + B.E[i]) }
+    inline f32x4 operator-(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.E[i] = A.E[i] - B.E[i]) }
+    inline f32x4 operator*(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.E[i] = A.E[i] * B.E[i]) }
+    inline f32x4 operator/(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.E[i] = A.E[i] / B.E[i]) }
+    inline f32x4 Min(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.E[i] = (A.E[i] < B.E[i]) ? A.E[i] : B.E[i]) }
+    inline f32x4 Max(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.E[i] = (A.E[i] > B.E[i]) ? A.E[i] : B.E[i]) }
+    inline f32x4 Sqrt(f32x4 A) { SHU_WIDE_LANE_OP(R.E[i] = sqrtf(A.E[i])) }
+
+    inline f32x4 operator<(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.U[i] = (A.E[i] < B.E[i]) ? 0xFFFFFFFF : 0) }
+    inline f32x4 operator>(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.U[i] = (A.E[i] > B.E[i]) ? 0xFFFFFFFF : 0) }
+    inline f32x4 operator<=(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.U[i] = (A.E[i] <= B.E[i]) ? 0xFFFFFFFF : 0) }
+    inline f32x4 operator>=(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.U[i] = (A.E[i] >= B.E[i]) ? 0xFFFFFFFF : 0) }
+    inline f32x4 operator&(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.U[i] = A.U[i] & B.U[i]) }
+    inline f32x4 operator|(f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.U[i] = A.U[i] | B.U[i]) }
+    inline f32x4 Select(f32x4 Mask, f32x4 A, f32x4 B) { SHU_WIDE_LANE_OP(R.U[i] = Mask.U[i] ? A.U[i] : B.U[i]) }
+#undef SHU_WIDE_LANE_OP
+
+    inline u32 MaskBits(f32x4 Mask) { u32 R = 0; for(i32 i = 0; i < 4; ++i) { R |= (Mask.U[i] >> 31) << i; } return R; }
+    inline f32 ReduceMin(f32x4 A) { return MIN(MIN(A.E[0], A.E[1]), MIN(A.E[2], A.E[3])); }
+    inline f32 ReduceMax(f32x4 A) { return MAX(MAX(A.E[0], A.E[1]), MAX(A.E[2], A.E[3])); }
+#endif
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // f32x8
+    // ----------------------------------------------------------------------------------------------------------------
+#if SHU_WIDE_AVX
+    struct f32x8
+    {
+        enum { LaneCount = 8 };
+        __m256 V;
+    };
+
+    inline f32x8 F32x8(f32 A) { return {_mm256_set1_ps(A)}; }
+    inline f32x8 LoadF32x8(const f32 *Ptr) { return {_mm256_loadu_ps(Ptr)}; }
+    inline void StoreF32x8(f32 *Ptr, f32x8 A) { _mm256_storeu_ps(Ptr, A.V); }
+
+    inline f32x8 operator+(f32x8 A, f32x8 B) { return {_mm256_add_ps(A.V, B.V)}; }
+    inline f32x8 operator-(f32x8 A, f32x8 B) { return {_mm256_sub_ps(A.V, B.V)}; }
+    inline f32x8 operator*(f32x8 A, f32x8 B) { return {_mm256_mul_ps(A.V, B.V)}; }
+    inline f32x8 operator/(f32x8 A, f32x8 B) { return {_mm256_div_ps(A.V, B.V)}; }
+    inline f32x8 Min(f32x8 A, f32x8 B) { return {_mm256_min_ps(A.V, B.V)}; }
+    inline f32x8 Max(f32x8 A, f32x8 B) { return {_mm256_max_ps(A.V, B.V)}; }
+    inline f32x8 Sqrt(f32x8 A) { return {_mm256_sqrt_ps(A.V)}; }
+
+    inline f32x8 operator<(f32x8 A, f32x8 B) { return {_mm256_cmp_ps(A.V, B.V, _CMP_LT_OQ)}; }
+    inline f32x8 operator>(f32x8 A, f32x8 B) { return {_mm256_cmp_ps(A.V, B.V, _CMP_GT_OQ)}; }
+    inline f32x8 operator<=(f32x8 A, f32x8 B) { return {_mm256_cmp_ps(A.V, B.V, _CMP_LE_OQ)}; }
+    inline f32x8 operator>=(f32x8 A, f32x8 B) { return {_mm256_cmp_ps(A.V, B.V, _CMP_GE_OQ)}; }
+    inline f32x8 operator&(f32x8 A, f32x8 B) { return {_mm256_and_ps(A.V, B.V)}; }
+    inline f32x8 operator|(f32x8 A, f32x8 B) { return {_mm256_or_ps(A.V, B.V)}; }
+    inline f32x8 Select(f32x8 Mask, f32x8 A, f32x8 B) { return {_mm256_blendv_ps(B.V, A.V, Mask.V)}; }
+    inline u32 MaskBits(f32x8 Mask) { return (u32)_mm256_movemask_ps(Mask.V); }
+
+    inline f32
+    ReduceMin(f32x8 A)
+    {
+        f32x4 Half = {_mm_min_ps(_mm256_castps256_ps128(A.V), _mm256_extractf128_ps(A.V, 1))};
+        return ReduceMin(Half);
+    }
+
+    inline f32
+    ReduceMax(f32x8 A)
+    {
+        f32x4 Half = {_mm_max_ps(_mm256_castps256_ps128(A.V), _mm256_extractf128_ps(A.V, 1))};
+        return ReduceMax(Half);
+    }
+#else
+    struct f32x8
+    {
+        enum { LaneCount = 8 };
+        f32x4 Lo, Hi;
+    };
+
+    inline f32x8 F32x8(f32 A) { return {F32x4(A), F32x4(A)}; }
+    inline f32x8 LoadF32x8(const f32 *Ptr) { return {LoadF32x4(Ptr), LoadF32x4(Ptr + 4)}; }
+    inline void StoreF32x8(f32 *Ptr, f32x8 A) { StoreF32x4(Ptr, A.Lo); StoreF32x4(Ptr + 4, A.Hi); }
+
+    inline f32x8 operator+(f32x8 A, f32x8 B) { return {A.Lo + B.Lo, A.Hi + B.Hi}; }
+    inline f32x8 operator-(f32x8 A, f32x8 B) { return {A.Lo - B.Lo, A.Hi - B.Hi}; }
+    inline f32x8 operator*(f32x8 A, f32x8 B) { return {A.Lo * B.Lo, A.Hi * B.Hi}; }
+    inline f32x8 operator/(f32x8 A, f32x8 B) { return {A.Lo / B.Lo, A.Hi / B.Hi}; }
+    inline f32x8 Min(f32x8 A, f32x8 B) { return {Min(A.Lo, B.Lo), Min(A.Hi, B.Hi)}; }
+    inline f32x8 Max(f32x8 A, f32x8 B) { return {Max(A.Lo, B.Lo), Max(A.Hi, B.Hi)}; }
+    inline f32x8 Sqrt(f32x8 A) { return {Sqrt(A.Lo), Sqrt(A.Hi)}; }
+
+    inline f32x8 operator<(f32x8 A, f32x8 B) { return {A.Lo < B.Lo, A.Hi < B.Hi}; }
+    inline f32x8 operator>(f32x8 A, f32x8 B) { return {A.Lo > B.Lo, A.Hi > B.Hi}; }
+    inline f32x8 operator<=(f32x8 A, f32x8 B) { return {A.Lo <= B.Lo, A.Hi <= B.Hi}; }
+    inline f32x8 operator>=(f32x8 A, f32x8 B) { return {A.Lo >= B.Lo, A.Hi >= B.Hi}; }
+    inline f32x8 operator&(f32x8 A, f32x8 B) { return {A.Lo & B.Lo, A.Hi & B.Hi}; }
+    inline f32x8 operator|(f32x8 A, f32x8 B) { return {A.Lo | B.Lo, A.Hi | B.Hi}; }
+    inline f32x8 Select(f32x8 Mask, f32x8 A, f32x8 B) { return {Select(Mask.Lo, A.Lo, B.Lo), Select(Mask.Hi, A.Hi, B.Hi)}; }
+    inline u32 MaskBits(f32x8 Mask) { return MaskBits(Mask.Lo) | (MaskBits(Mask.Hi) << 4); }
+
+    inline f32 ReduceMin(f32x8 A) { return ReduceMin(Min(A.Lo, A.Hi)); }
+    inline f32 ReduceMax(f32x8 A) { return ReduceMax(Max(A.Lo, A.Hi)); }
+#endif
+
+    // NOTE: Lets the templates below make a lane type out of plain f32s.
+    template <typename lane> lane Splat(f32 A);
+    template <> inline f32x4 Splat<f32x4>(f32 A) { return F32x4(A); }
+    template <> inline f32x8 Splat<f32x8>(f32 A) { return F32x8(A); }
+    template <typename lane> lane LoadLanes(const f32 *Ptr);
+    template <> inline f32x4 LoadLanes<f32x4>(const f32 *Ptr) { return LoadF32x4(Ptr); }
+    template <> inline f32x8 LoadLanes<f32x8>(const f32 *Ptr) { return LoadF32x8(Ptr); }
+    inline void StoreLanes(f32 *Ptr, f32x4 A) { StoreF32x4(Ptr, A); }
+    inline void StoreLanes(f32 *Ptr, f32x8 A) { StoreF32x8(Ptr, A); }
+
+    template <typename lane>
+    inline lane
+    Abs(const lane &A)
+    {
+        lane Result = Max(A, Splat<lane>(0.0f) - A);
+        return Result;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // vec3x4, vec3x8
+    // ----------------------------------------------------------------------------------------------------------------
+    template <typename lane>
+    struct vec3w
+    {
+        lane x, y, z;
+    };
+
+    typedef vec3w<f32x4> vec3x4;
+    typedef vec3w<f32x8> vec3x8;
+
+    template <typename lane>
+    inline vec3w<lane>
+    SplatVec3(const vec3f &V)
+    {
+        vec3w<lane> Result = {Splat<lane>(V.x), Splat<lane>(V.y), Splat<lane>(V.z)};
+        return Result;
+    }
+
+    // NOTE: Reads Count points(at most the lane count) into the lanes. The lanes past Count get Points[0], which
+    // does not change a min, a max or which point is furthest.
+    template <typename lane>
+    inline vec3w<lane>
+    LoadVec3(const vec3f *Points, i32 Count = lane::LaneCount)
+    {
+        ASSERT(Count > 0 && Count <= lane::LaneCount);
+        f32 X[lane::LaneCount], Y[lane::LaneCount], Z[lane::LaneCount];
+        for(i32 i = 0; i < lane::LaneCount; ++i)
+        {
+            const vec3f &Point = Points[(i < Count) ? i : 0];
+            X[i] = Point.x;
+            Y[i] = Point.y;
+            Z[i] = Point.z;
+        }
+
+        vec3w<lane> Result = {LoadLanes<lane>(X), LoadLanes<lane>(Y), LoadLanes<lane>(Z)};
+        return Result;
+    }
+
+    template <typename lane>
+    inline void
+    StoreVec3(vec3f *Points, const vec3w<lane> &V, i32 Count = lane::LaneCount)
+    {
+        f32 X[lane::LaneCount], Y[lane::LaneCount], Z[lane::LaneCount];
+        StoreLanes(X, V.x);
+        StoreLanes(Y, V.y);
+        StoreLanes(Z, V.z);
+        for(i32 i = 0; i < Count; ++i)
+        {
+            Points[i] = Vec3f(X[i], Y[i], Z[i]);
+        }
+    }
+
+    template <typename lane>
+    inline vec3w<lane>
+    operator+(const vec3w<lane> &A, const vec3w<lane> &B)
+    {
+        vec3w<lane> Result = {A.x + B.x, A.y + B.y, A.z + B.z};
+        return Result;
+    }
+
+    template <typename lane>
+    inline vec3w<lane>
+    operator-(const vec3w<lane> &A, const vec3w<lane> &B)
+    {
+        vec3w<lane> Result = {A.x - B.x, A.y - B.y, A.z - B.z};
+        return Result;
+    }
+
+    template <typename lane>
+    inline vec3w<lane>
+    operator*(const vec3w<lane> &A, const lane &B)
+    {
+        vec3w<lane> Result = {A.x * B, A.y * B, A.z * B};
+        return Result;
+    }
+
+    template <typename lane>
+    inline vec3w<lane>
+    operator*(const vec3w<lane> &A, f32 B)
+    {
+        vec3w<lane> Result = A * Splat<lane>(B);
+        return Result;
+    }
+
+    // NOTE: Same order of operations as the scalar Dot, so the lanes match it exactly.
+    template <typename lane>
+    inline lane
+    Dot(const vec3w<lane> &A, const vec3w<lane> &B)
+    {
+        lane Result = A.x*B.x + A.y*B.y + A.z*B.z;
+        return Result;
+    }
+
+    template <typename lane>
+    inline vec3w<lane>
+    Cross(const vec3w<lane> &A, const vec3w<lane> &B)
+    {
+        vec3w<lane> Result = {A.y*B.z - A.z*B.y, A.z*B.x - A.x*B.z, A.x*B.y - A.y*B.x};
+        return Result;
+    }
+
+    template <typename lane>
+    inline vec3w<lane>
+    Select(const lane &Mask, const vec3w<lane> &A, const vec3w<lane> &B)
+    {
+        vec3w<lane> Result = {Select(Mask, A.x, B.x), Select(Mask, A.y, B.y), Select(Mask, A.z, B.z)};
+        return Result;
+    }
+
+    template <typename lane>
+    inline vec3w<lane>
+    Min(const vec3w<lane> &A, const vec3w<lane> &B)
+    {
+        vec3w<lane> Result = {Min(A.x, B.x), Min(A.y, B.y), Min(A.z, B.z)};
+        return Result;
+    }
+
+    template <typename lane>
+    inline vec3w<lane>
+    Max(const vec3w<lane> &A, const vec3w<lane> &B)
+    {
+        vec3w<lane> Result = {Max(A.x, B.x), Max(A.y, B.y), Max(A.z, B.z)};
+        return Result;
+    }
+
+    // NOTE: The smallest x, y and z over all lanes.
+    template <typename lane>
+    inline vec3f
+    ReduceMin(const vec3w<lane> &A)
+    {
+        vec3f Result = Vec3f(ReduceMin(A.x), ReduceMin(A.y), ReduceMin(A.z));
+        return Result;
+    }
+
+    template <typename lane>
+    inline vec3f
+    ReduceMax(const vec3w<lane> &A)
+    {
+        vec3f Result = Vec3f(ReduceMax(A.x), ReduceMax(A.y), ReduceMax(A.z));
+        return Result;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // quatx4, quatx8
+    // ----------------------------------------------------------------------------------------------------------------
+    template <typename lane>
+    struct quatw
+    {
+        lane w, x, y, z;
+    };
+
+    typedef quatw<f32x4> quatx4;
+    typedef quatw<f32x8> quatx8;
+
+    // NOTE: Normalizes Q first, like QuatRotateVec does.
+    template <typename lane>
+    inline quatw<lane>
+    SplatQuat(const quat &Q)
+    {
+        quat N = QuatNormalize(Q);
+        quatw<lane> Result = {Splat<lane>(N.w), Splat<lane>(N.vx), Splat<lane>(N.vy), Splat<lane>(N.vz)};
+        return Result;
+    }
+
+    // NOTE: Same as LoadVec3, the lanes past Count get Rotations[0].
+    template <typename lane>
+    inline quatw<lane>
+    LoadQuat(const quat *Rotations, i32 Count = lane::LaneCount)
+    {
+        ASSERT(Count > 0 && Count <= lane::LaneCount);
+        f32 W[lane::LaneCount], X[lane::LaneCount], Y[lane::LaneCount], Z[lane::LaneCount];
+        for(i32 i = 0; i < lane::LaneCount; ++i)
+        {
+            const quat &Q = Rotations[(i < Count) ? i : 0];
+            W[i] = Q.w;
+            X[i] = Q.vx;
+            Y[i] = Q.vy;
+            Z[i] = Q.vz;
+        }
+
+        quatw<lane> Result = {LoadLanes<lane>(W), LoadLanes<lane>(X), LoadLanes<lane>(Y), LoadLanes<lane>(Z)};
+        return Result;
+    }
+
+    template <typename lane>
+    inline quatw<lane>
+    operator*(const quatw<lane> &A, const quatw<lane> &B)
+    {
+        quatw<lane> Result;
+        Result.w = A.w*B.w - A.x*B.x - A.y*B.y - A.z*B.z;
+        Result.x = A.w*B.x + A.x*B.w + A.y*B.z - A.z*B.y;
+        Result.y = A.w*B.y - A.x*B.z + A.y*B.w + A.z*B.x;
+        Result.z = A.w*B.z + A.x*B.y - A.y*B.x + A.z*B.w;
+        return Result;
+    }
+
+    template <typename lane>
+    inline quatw<lane>
+    QuatNormalize(const quatw<lane> &Q)
+    {
+        lane InvMagnitude = Splat<lane>(1.0f) / Sqrt(Q.w*Q.w + Q.x*Q.x + Q.y*Q.y + Q.z*Q.z);
+        quatw<lane> Result = {Q.w*InvMagnitude, Q.x*InvMagnitude, Q.y*InvMagnitude, Q.z*InvMagnitude};
+        return Result;
+    }
+
+    // NOTE: Q has to be normalized. v + w*t + u x t with t = 2(u x v), u being the complex part.
+    template <typename lane>
+    inline vec3w<lane>
+    QuatRotateVec(const quatw<lane> &Q, const vec3w<lane> &V)
+    {
+        vec3w<lane> u = {Q.x, Q.y, Q.z};
+        vec3w<lane> t = Cross(u, V);
+        t = t + t;
+        vec3w<lane> Result = V + t*Q.w + Cross(u, t);
+        return Result;
+    }
+
+    // NOTE: The rows of quat::ToMat3f(), which are also the rotation rows of TRS. Does not normalize Q.
+    template <typename lane>
+    inline void
+    QuatToMat3Rows(const quatw<lane> &Q, vec3w<lane> &Row0, vec3w<lane> &Row1, vec3w<lane> &Row2)
+    {
+        const lane One = Splat<lane>(1.0f);
+        const lane Two = Splat<lane>(2.0f);
+        lane xx = Q.x*Q.x, yy = Q.y*Q.y, zz = Q.z*Q.z;
+        lane xy = Q.x*Q.y, xz = Q.x*Q.z, yz = Q.y*Q.z;
+        lane wx = Q.w*Q.x, wy = Q.w*Q.y, wz = Q.w*Q.z;
+
+        Row0 = {One - Two*(yy + zz), Two*(xy + wz), Two*(xz - wy)};
+        Row1 = {Two*(xy - wz), One - Two*(xx + zz), Two*(yz + wx)};
+        Row2 = {Two*(xz + wy), Two*(yz - wx), One - Two*(xx + yy)};
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // NOTE: Loops over arrays of points, 8 at a time.
+    // ----------------------------------------------------------------------------------------------------------------
+
+    // NOTE: The largest Dot(Points[i], Direction). MaxIndex gets the first point with it, like a scalar loop with
+    // a strict > would.
+    inline f32
+    MaxDot(const vec3f *Points, i32 Count, const vec3f &Direction, i32 *MaxIndex = nullptr)
+    {
+        ASSERT(Count > 0);
+        const f32 LaneOffsets[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+        vec3x8 Dir = SplatVec3<f32x8>(Direction);
+        f32x8 BestDot = F32x8(SHU_FLOAT_MIN);
+        f32x8 BestIndex = F32x8(0.0f);
+        f32x8 Index = LoadF32x8(LaneOffsets);
+        for(i32 i = 0; i < Count; i += 8)
+        {
+            f32x8 PointDot = Dot(LoadVec3<f32x8>(Points + i, MIN(8, Count - i)), Dir);
+            f32x8 Better = PointDot > BestDot;
+            BestDot = Select(Better, PointDot, BestDot);
+            BestIndex = Select(Better, Index, BestIndex);
+            Index = Index + F32x8(8.0f);
+        }
+
+        f32 Dots[8], Indices[8];
+        StoreF32x8(Dots, BestDot);
+        StoreF32x8(Indices, BestIndex);
+        f32 Result = Dots[0];
+        f32 ResultIndex = Indices[0];
+        for(i32 i = 1; i < 8; ++i)
+        {
+            if(Dots[i] > Result || (Dots[i] == Result && Indices[i] < ResultIndex))
+            {
+                Result = Dots[i];
+                ResultIndex = Indices[i];
+            }
+        }
+
+        if(MaxIndex != nullptr)
+        {
+            *MaxIndex = (i32)ResultIndex;
+        }
+        return Result;
+    }
+
+    inline void
+    MinMaxPoints(const vec3f *Points, i32 Count, vec3f &Mins, vec3f &Maxs)
+    {
+        ASSERT(Count > 0);
+        vec3x8 WideMins = LoadVec3<f32x8>(Points, MIN(8, Count));
+        vec3x8 WideMaxs = WideMins;
+        for(i32 i = 8; i < Count; i += 8)
+        {
+            vec3x8 P = LoadVec3<f32x8>(Points + i, MIN(8, Count - i));
+            WideMins = Min(WideMins, P);
+            WideMaxs = Max(WideMaxs, P);
+        }
+
+        Mins = ReduceMin(WideMins);
+        Maxs = ReduceMax(WideMaxs);
+    }
+
+    // NOTE: Out[i] = (M * Points[i]).xyz, the points taken with w = 1. Out can be Points.
+    inline void
+    MulPoints(const mat4f &M, const vec3f *Points, i32 Count, vec3f *Out)
+    {
+        const vec3x8 Row0 = SplatVec3<f32x8>(M.Row0.xyz), Row1 = SplatVec3<f32x8>(M.Row1.xyz);
+        const vec3x8 Row2 = SplatVec3<f32x8>(M.Row2.xyz);
+        const f32x8 W0 = F32x8(M.Row0.w), W1 = F32x8(M.Row1.w), W2 = F32x8(M.Row2.w);
+        for(i32 i = 0; i < Count; i += 8)
+        {
+            i32 LaneCount = MIN(8, Count - i);
+            vec3x8 P = LoadVec3<f32x8>(Points + i, LaneCount);
+            vec3x8 Result = {Dot(Row0, P) + W0, Dot(Row1, P) + W1, Dot(Row2, P) + W2};
+            StoreVec3(Out + i, Result, LaneCount);
+        }
+    }
+
+#if _SHU_DEBUG
+    void MathWideTest();
+#endif
+} // namespace shu
+
+#define MATH_WIDE_H
+#endif // MATH_WIDE_H
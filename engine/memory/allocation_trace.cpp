@@ -0,0 +1,292 @@
+#include "allocation_trace.h"
+
+#include "freelist_allocator.h"
+#include <platform/platform.h>
+#include <utils/random/random.h>
+
+void
+allocation_trace::Initialize(allocation_trace_entry *Entries, i32 Capacity)
+{
+    ASSERT(Entries != nullptr && Capacity > 0);
+
+    this->Entries = Entries;
+    this->Capacity = Capacity;
+    this->Count = 0;
+    this->Overflowed = false;
+}
+
+void
+GenerateAllocationTrace(allocation_trace *Trace, i32 OperationCount, u32 Seed)
+{
+    struct live_block
+    {
+        u64 Id;
+        u64 Size;
+        b32 IsArray;
+    };
+
+    const i32 MaxLive = 4096;
+    live_block *Live = (live_block *)malloc(sizeof(live_block) * MaxLive);
+    i32 LiveCount = 0;
+    u64 NextId = 1;
+
+    shoora_random Random(Seed);
+    for(i32 Operation = 0; Operation < OperationCount; ++Operation)
+    {
+        u32 Roll = Random.Between(0u, 100u);
+        if(LiveCount == MaxLive || (LiveCount > 0 && Roll < 40))
+        {
+            // NOTE: Free. Most of the blocks are short lived, so the newer ones are more likely to go.
+            i32 Index = LiveCount - 1 - (i32)Random.Between(0u, (u32)MIN(LiveCount, 64));
+            Index = MAX(Index, 0);
+            Trace->Record(ALLOCATION_TRACE_FREE, (void *)Live[Index].Id, nullptr, 0, 0);
+            Live[Index] = Live[--LiveCount];
+        }
+        else if(LiveCount > 0 && Roll < 55)
+        {
+            // NOTE: Dynamic array growth.
+            live_block &Block = Live[Random.Between(0u, (u32)LiveCount)];
+            if(Block.IsArray && Block.Size < KILOBYTES(64))
+            {
+                u64 NewId = NextId++;
+                Block.Size *= 2;
+                Trace->Record(ALLOCATION_TRACE_REALLOCATE, (void *)Block.Id, (void *)NewId, Block.Size, 4);
+                Block.Id = NewId;
+            }
+        }
+        else
+        {
+            live_block &Block = Live[LiveCount++];
+            Block.Id = NextId++;
+            Block.IsArray = false;
+            if(Roll < 95)
+            {
+                Block.Size = Random.Between(16u, 256u);
+                Block.IsArray = (Roll < 70);
+            }
+            else
+            {
+                Block.Size = Random.Between(KILOBYTES(16), KILOBYTES(512));
+            }
+
+            u32 Alignment = (Roll & 1) ? 16 : 4;
+            Trace->Record(ALLOCATION_TRACE_ALLOCATE, nullptr, (void *)Block.Id, Block.Size, Alignment);
+        }
+    }
+
+    free(Live);
+}
+
+#if _SHU_DEBUG
+// NOTE: Open addressing map from a recorded address to the index of the trace entry that created the block. Only
+// used to turn the addresses into indices once before the replay, so that the timed part does no lookups.
+struct trace_address_map
+{
+    u64 *Keys;
+    i32 *Values;
+    u64 Mask;
+};
+
+static inline u64
+HashTraceAddress(u64 Key)
+{
+    Key ^= Key >> 33;
+    Key *= 0xff51afd7ed558ccdULL;
+    Key ^= Key >> 33;
+    return Key;
+}
+
+static void
+TraceMapInsert(trace_address_map *Map, u64 Key, i32 Value)
+{
+    u64 Slot = HashTraceAddress(Key) & Map->Mask;
+    while(Map->Keys[Slot] != 0 && Map->Keys[Slot] != Key)
+    {
+        Slot = (Slot + 1) & Map->Mask;
+    }
+
+    Map->Keys[Slot] = Key;
+    Map->Values[Slot] = Value;
+}
+
+// NOTE: Returns -1 if the block was allocated before the recording started.
+static i32
+TraceMapRemove(trace_address_map *Map, u64 Key)
+{
+    u64 Slot = HashTraceAddress(Key) & Map->Mask;
+    while(Map->Keys[Slot] != Key)
+    {
+        if(Map->Keys[Slot] == 0)
+        {
+            return -1;
+        }
+        Slot = (Slot + 1) & Map->Mask;
+    }
+
+    i32 Result = Map->Values[Slot];
+
+    // NOTE: Backward shift deletion, so that the probe sequences stay intact without tombstones.
+    u64 Hole = Slot;
+    for(u64 Next = (Hole + 1) & Map->Mask; Map->Keys[Next] != 0; Next = (Next + 1) & Map->Mask)
+    {
+        u64 Home = HashTraceAddress(Map->Keys[Next]) & Map->Mask;
+        if(((Next - Home) & Map->Mask) >= ((Next - Hole) & Map->Mask))
+        {
+            Map->Keys[Hole] = Map->Keys[Next];
+            Map->Values[Hole] = Map->Values[Next];
+            Hole = Next;
+        }
+    }
+    Map->Keys[Hole] = 0;
+
+    return Result;
+}
+
+// NOTE: Source[i] is the index of the entry which created the block that entry i frees or reallocates.
+static void
+ResolveTrace(const allocation_trace *Trace, i32 *Source)
+{
+    u64 Capacity = 16;
+    while(Capacity < 2 * (u64)Trace->Count) { Capacity *= 2; }
+
+    trace_address_map Map;
+    Map.Keys = (u64 *)calloc(Capacity, sizeof(u64));
+    Map.Values = (i32 *)malloc(Capacity * sizeof(i32));
+    Map.Mask = Capacity - 1;
+
+    for(i32 i = 0; i < Trace->Count; ++i)
+    {
+        const allocation_trace_entry &Entry = Trace->Entries[i];
+        Source[i] = -1;
+        if(Entry.Op != ALLOCATION_TRACE_ALLOCATE)
+        {
+            Source[i] = TraceMapRemove(&Map, Entry.Memory);
+        }
+        if(Entry.Op != ALLOCATION_TRACE_FREE && Entry.NewMemory != 0)
+        {
+            TraceMapInsert(&Map, Entry.NewMemory, i);
+        }
+    }
+
+    free(Map.Keys);
+    free(Map.Values);
+}
+
+struct trace_replay_result
+{
+    f32 Milliseconds;
+    f32 PeakFragmentation;
+    i32 PeakFreeBlockCount;
+    i32 FailedCount;
+};
+
+// NOTE: If SampleInterval is not zero, the allocator stats are looked at every SampleInterval operations. That walks
+// the free lists, so the timing is only meaningful for the runs without sampling.
+static void
+ReplayTrace(freelist_allocator *Allocator, const allocation_trace *Trace, const i32 *Source, void **Blocks,
+            i32 SampleInterval, trace_replay_result *Result)
+{
+    *Result = {};
+
+    u64 Start = Platform_GetWallClock();
+    for(i32 i = 0; i < Trace->Count; ++i)
+    {
+        const allocation_trace_entry &Entry = Trace->Entries[i];
+        Blocks[i] = nullptr;
+
+        switch(Entry.Op)
+        {
+            case ALLOCATION_TRACE_ALLOCATE:
+            {
+                Blocks[i] = Allocator->Allocate(Entry.Size, Entry.Alignment);
+                Result->FailedCount += (Blocks[i] == nullptr) ? 1 : 0;
+            } break;
+
+            case ALLOCATION_TRACE_REALLOCATE:
+            {
+                void *Old = (Source[i] >= 0) ? Blocks[Source[i]] : nullptr;
+                Blocks[i] = (Old != nullptr) ? Allocator->ReAllocate(Old, Entry.Size, Entry.Alignment) :
+                                               Allocator->Allocate(Entry.Size, Entry.Alignment);
+                Result->FailedCount += (Blocks[i] == nullptr) ? 1 : 0;
+            } break;
+
+            case ALLOCATION_TRACE_FREE:
+            {
+                if(Source[i] >= 0 && Blocks[Source[i]] != nullptr)
+                {
+                    Allocator->Free(Blocks[Source[i]]);
+                }
+            } break;
+
+            SHU_INVALID_DEFAULT;
+        }
+
+        if(SampleInterval > 0 && (i % SampleInterval) == 0)
+        {
+            freelist_allocator_stats Stats;
+            Allocator->GetStats(&Stats);
+            Result->PeakFragmentation = MAX(Result->PeakFragmentation, Stats.Fragmentation);
+            Result->PeakFreeBlockCount = MAX(Result->PeakFreeBlockCount, Stats.FreeBlockCount);
+        }
+    }
+    u64 End = Platform_GetWallClock();
+
+    Result->Milliseconds = 1000.0f * Platform_GetSecondsElapsed(Start, End);
+}
+
+void
+allocation_trace_benchmark(const allocation_trace *Trace, size_t HeapSize)
+{
+    if(Trace->Count == 0)
+    {
+        LogWarnUnformatted("[Allocation Trace Benchmark]: The trace is empty!\n");
+        return;
+    }
+
+    struct benchmark_config
+    {
+        const char *Name;
+        freelist_policy Policy;
+        size_t SlabRegionSize;
+    };
+    const benchmark_config Configs[] =
+    {
+        {"First Fit", FREELIST_POLICY_FIRST_FIT, 0},
+        {"TLSF", FREELIST_POLICY_TLSF, 0},
+        {"TLSF + Slabs", FREELIST_POLICY_TLSF, HeapSize / 8},
+    };
+
+    i32 *Source = (i32 *)malloc(sizeof(i32) * Trace->Count);
+    void **Blocks = (void **)malloc(sizeof(void *) * Trace->Count);
+    void *Memory = malloc(HeapSize);
+    ResolveTrace(Trace, Source);
+
+    LogInfo("[Allocation Trace Benchmark]: %d operations%s.\n", Trace->Count,
+            Trace->Overflowed ? " (the recording overflowed)" : "");
+    for(i32 ConfigIndex = 0; ConfigIndex < ARRAY_SIZE(Configs); ++ConfigIndex)
+    {
+        const benchmark_config &Config = Configs[ConfigIndex];
+
+        // NOTE: One run for the time and one for the fragmentation.
+        trace_replay_result Timed, Sampled;
+        {
+            freelist_allocator Allocator;
+            Allocator.Initialize(Memory, HeapSize, Config.SlabRegionSize, Config.Policy);
+            ReplayTrace(&Allocator, Trace, Source, Blocks, 0, &Timed);
+        }
+        {
+            freelist_allocator Allocator;
+            Allocator.Initialize(Memory, HeapSize, Config.SlabRegionSize, Config.Policy);
+            ReplayTrace(&Allocator, Trace, Source, Blocks, 64, &Sampled);
+        }
+
+        LogInfo("  %-14s %8.3fms %7.1fns/op, peak fragmentation: %5.1f%%, peak free blocks: %d, failed: %d.\n",
+                Config.Name, Timed.Milliseconds, (1000000.0f * Timed.Milliseconds) / (f32)Trace->Count,
+                100.0f * Sampled.PeakFragmentation, Sampled.PeakFreeBlockCount, Timed.FailedCount);
+    }
+
+    free(Memory);
+    free(Blocks);
+    free(Source);
+}
+#endif
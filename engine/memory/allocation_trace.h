@@ -0,0 +1,65 @@
+#if !defined(ALLOCATION_TRACE_H)
+#define ALLOCATION_TRACE_H
+
+#include <defines.h>
+
+enum allocation_trace_op
+{
+    ALLOCATION_TRACE_ALLOCATE,
+    ALLOCATION_TRACE_REALLOCATE,
+    ALLOCATION_TRACE_FREE,
+};
+
+// NOTE: Memory/NewMemory are only used to match up the operations on the same block when the trace is replayed.
+// Allocate fills in NewMemory, Free fills in Memory and ReAllocate fills in both.
+struct allocation_trace_entry
+{
+    u32 Op;
+    u32 Alignment;
+    u64 Size;
+    u64 Memory;
+    u64 NewMemory;
+};
+
+// NOTE: A recording of the calls made to an allocator. The entries are not allocated from anything, the memory is
+// passed in by the caller so that the trace can record the allocator it lives in. Recording stops when it is full.
+struct allocation_trace
+{
+    void Initialize(allocation_trace_entry *Entries, i32 Capacity);
+
+    inline void
+    Record(allocation_trace_op Op, const void *Memory, const void *NewMemory, size_t Size, size_t Alignment)
+    {
+        if(this->Count < this->Capacity)
+        {
+            allocation_trace_entry *Entry = this->Entries + this->Count++;
+            Entry->Op = Op;
+            Entry->Alignment = (u32)Alignment;
+            Entry->Size = Size;
+            Entry->Memory = (u64)Memory;
+            Entry->NewMemory = (u64)NewMemory;
+        }
+        else
+        {
+            this->Overflowed = true;
+        }
+    }
+
+    allocation_trace_entry *Entries = nullptr;
+    i32 Count = 0;
+    i32 Capacity = 0;
+    b32 Overflowed = false;
+};
+
+// NOTE: Fills the trace with a made up workload that looks like what the physics does every frame: lots of small
+// short lived blocks(manifolds, constraints, pairs), dynamic arrays that grow by reallocating and a few big
+// buffers that stay around for a long time.
+void GenerateAllocationTrace(allocation_trace *Trace, i32 OperationCount, u32 Seed);
+
+#if _SHU_DEBUG
+// NOTE: Replays the trace on a first fit heap, a TLSF heap and a TLSF heap with slabs(what the engine uses), each
+// in a fresh HeapSize block of memory. Logs the time per operation and the peak fragmentation of every policy.
+void allocation_trace_benchmark(const allocation_trace *Trace, size_t HeapSize);
+#endif
+
+#endif // ALLOCATION_TRACE_H
@@ -4,21 +4,214 @@
 #include <platform/platform.h>
 
 void
-freelist_allocator::Initialize(void *Memory, size_t Size)
+freelist_allocator::Initialize(void *Memory, size_t Size, size_t SlabRegionSize, freelist_policy Policy)
 {
     ASSERT(Memory != nullptr && Size > 0 && "You have to pass in something valid here!");
 
     this->Memory = Memory;
     this->TotalSize = Size;
 
-    flNode *newNode = (flNode *)Memory;
-    newNode->next = nullptr;
-    newNode->data.BlockSize = Size;
+    u8 *FreelistMemory = (u8 *)Memory;
+    size_t FreelistSize = Size;
+    if(SlabRegionSize > 0)
+    {
+        // NOTE: Layout is [Page metadata][Padding to the page boundary][Slab pages][Freelist].
+        size_t PageCount = SlabRegionSize / SLAB_PAGE_SIZE;
+        ASSERT(PageCount > 0);
+
+        slab_page *Pages = (slab_page *)AlignAsPow2((u64)Memory, 16);
+        u8 *SlabRegion = (u8 *)AlignAsPow2((u64)(Pages + PageCount), SLAB_PAGE_SIZE);
+        u8 *SlabRegionEnd = SlabRegion + PageCount * SLAB_PAGE_SIZE;
+        ASSERT(SlabRegionEnd + freelist_allocator::FreeNodeHeaderSize <= (u8 *)Memory + Size &&
+               "The slab region does not fit in the memory given to the allocator!");
+
+        this->Slabs.Initialize(SlabRegion, PageCount * SLAB_PAGE_SIZE, Pages);
 
-    Freelist.Insert(nullptr, newNode);
+        FreelistMemory = SlabRegionEnd;
+        FreelistSize = Size - (size_t)(SlabRegionEnd - (u8 *)Memory);
+    }
+    this->FreelistSize = FreelistSize;
+    this->Policy = Policy;
+
+    if(Policy == FREELIST_POLICY_TLSF)
+    {
+        this->Tlsf.Initialize(FreelistMemory, FreelistSize);
+    }
+    else
+    {
+        flNode *newNode = (flNode *)FreelistMemory;
+        newNode->next = nullptr;
+        newNode->data.BlockSize = FreelistSize;
+
+        Freelist.Insert(nullptr, newNode);
+    }
     this->IsInitialized = true;
 }
 
+void *
+freelist_allocator::Allocate(size_t RequiredSize, const size_t Alignment)
+{
+    void *Result = this->AllocateInternal(RequiredSize, Alignment);
+    if(this->Trace != nullptr)
+    {
+        this->Trace->Record(ALLOCATION_TRACE_ALLOCATE, nullptr, Result, RequiredSize, Alignment);
+    }
+
+    return Result;
+}
+
+void *
+freelist_allocator::ReAllocate(void *MemoryPtr, size_t NewSize, const size_t Alignment)
+{
+    ASSERT(MemoryPtr != nullptr);
+
+    size_t OldSize = this->GetAllocationSize(MemoryPtr);
+    return this->ReAllocateSized(MemoryPtr, OldSize, NewSize, Alignment);
+}
+
+void *
+freelist_allocator::ReAllocateSized(void *OldMemoryPtr, size_t OldSize, size_t NewSize, const size_t Alignment)
+{
+    ASSERT(OldMemoryPtr != nullptr);
+
+    void *Result = this->ReAllocateInternal(OldMemoryPtr, OldSize, NewSize, Alignment);
+    if(this->Trace != nullptr)
+    {
+        this->Trace->Record(ALLOCATION_TRACE_REALLOCATE, OldMemoryPtr, Result, NewSize, Alignment);
+    }
+
+    return Result;
+}
+
+void
+freelist_allocator::Free(void *MemoryPtr)
+{
+    if(MemoryPtr == nullptr)
+    {
+        LogWarnUnformatted("[Allocator::Free]: Ptr passed in here was nullptr!\n");
+        return;
+    }
+
+    if(this->Trace != nullptr)
+    {
+        this->Trace->Record(ALLOCATION_TRACE_FREE, MemoryPtr, nullptr, 0, 0);
+    }
+    this->FreeInternal(MemoryPtr);
+}
+
+void *
+freelist_allocator::AllocateInternal(size_t RequiredSize, size_t Alignment)
+{
+    ASSERT(this->IsInitialized);
+
+    // NOTE: Small blocks come from the slabs. If the slabs are out of pages, this goes through the freelist.
+    if(this->Slabs.RegionSize > 0 && RequiredSize <= SLAB_MAX_BLOCK_SIZE && Alignment <= SLAB_MAX_ALIGNMENT)
+    {
+        void *SlabMemory = this->Slabs.Allocate(RequiredSize);
+        if(SlabMemory != nullptr)
+        {
+            return SlabMemory;
+        }
+    }
+
+    void *Result = nullptr;
+    if(this->Policy == FREELIST_POLICY_TLSF)
+    {
+        Result = this->Tlsf.Allocate(RequiredSize, Alignment);
+        if(Result == nullptr)
+        {
+            LogFatalUnformatted("There is no space available in the freelist!\n");
+        }
+    }
+    else
+    {
+        Result = this->FirstFitAllocate(RequiredSize, Alignment);
+    }
+
+    return Result;
+}
+
+void *
+freelist_allocator::ReAllocateInternal(void *OldMemoryPtr, size_t OldSize, size_t NewSize, size_t Alignment)
+{
+    if(this->Slabs.Owns(OldMemoryPtr))
+    {
+        // NOTE: Slab blocks can't grow or shrink in place. If the new size still maps to the same size class the
+        // block is kept, otherwise it moves to wherever Allocate puts the new size.
+        size_t BlockSize = this->Slabs.GetBlockSize(OldMemoryPtr);
+        if(NewSize <= BlockSize && Alignment <= SLAB_MAX_ALIGNMENT &&
+           slab_allocator::GetClassBlockSize(slab_allocator::GetClassIndex(NewSize)) == BlockSize)
+        {
+            return OldMemoryPtr;
+        }
+
+        void *NewMemoryPtr = this->AllocateInternal(NewSize, Alignment);
+        if(NewMemoryPtr != nullptr)
+        {
+            SHU_MEMCOPY(OldMemoryPtr, NewMemoryPtr, MIN(OldSize, NewSize));
+            this->Slabs.Free(OldMemoryPtr);
+        }
+        return NewMemoryPtr;
+    }
+
+    void *Result = nullptr;
+    if(this->Policy == FREELIST_POLICY_TLSF)
+    {
+        Result = this->Tlsf.ReAllocate(OldMemoryPtr, NewSize, Alignment);
+        if(Result == nullptr)
+        {
+            LogErrorUnformatted("[ALLOCATOR: ReAlloc] Could not allocate for new size since the allocator has "
+                                "run out of space.\n");
+        }
+    }
+    else
+    {
+        Result = this->FirstFitReAllocateSized(OldMemoryPtr, OldSize, MAX(NewSize, FreeNodeHeaderSize), Alignment);
+    }
+
+    return Result;
+}
+
+void
+freelist_allocator::FreeInternal(void *MemoryPtr)
+{
+    if(this->Slabs.Owns(MemoryPtr))
+    {
+        this->Slabs.Free(MemoryPtr);
+    }
+    else if(this->Policy == FREELIST_POLICY_TLSF)
+    {
+        this->Tlsf.Free(MemoryPtr);
+    }
+    else
+    {
+        this->FirstFitFree(MemoryPtr);
+    }
+}
+
+size_t
+freelist_allocator::GetAllocationSize(void *MemoryPtr)
+{
+    size_t Result = 0;
+    if(this->Slabs.Owns(MemoryPtr))
+    {
+        Result = this->Slabs.GetBlockSize(MemoryPtr);
+    }
+    else if(this->Policy == FREELIST_POLICY_TLSF)
+    {
+        Result = this->Tlsf.GetBlockSize(MemoryPtr);
+    }
+    else
+    {
+        auto *AllocationHeader = (freelist_allocation_header *)((u8 *)MemoryPtr -
+                                                                freelist_allocator::AllocationHeaderSize);
+        size_t HeaderPlusAlign = freelist_allocator::AllocationHeaderSize + AllocationHeader->AlignmentPadding;
+        Result = AllocationHeader->BlockSize - HeaderPlusAlign;
+    }
+
+    return Result;
+}
+
 void
 freelist_allocator::FirstFit(const size_t &Alignment, const size_t &RequiredSize, size_t &OutPadding,
                              flNode **OutFoundNode, flNode **OutPreviousNode)
@@ -47,10 +240,8 @@ freelist_allocator::FirstFit(const size_t &Alignment, const size_t &RequiredSize
 }
 
 void *
-freelist_allocator::Allocate(size_t RequiredSize, const size_t Alignment)
+freelist_allocator::FirstFitAllocate(size_t RequiredSize, size_t Alignment)
 {
-    ASSERT(this->IsInitialized);
-
     if (RequiredSize <= freelist_allocator::AllocationHeaderSize)
     {
         LogWarn("The header size is %zu and you are trying to allocate %zu bytes. This is not efficient since the "
@@ -76,6 +267,14 @@ freelist_allocator::Allocate(size_t RequiredSize, const size_t Alignment)
         ASSERT(FreeNode->data.BlockSize >= AllocationBlockSize);
         size_t RemainingSpace = FreeNode->data.BlockSize - AllocationBlockSize;
 
+        // NOTE: A remainder too small to hold a free node can't go back to the freelist. It becomes part of this
+        // allocation instead.
+        if(RemainingSpace < freelist_allocator::FreeNodeHeaderSize)
+        {
+            AllocationBlockSize += RemainingSpace;
+            RemainingSpace = 0;
+        }
+
         ASSERT(RemainingSpace >= 0 && "Freelist should have enough space for this allocation");
 
         // NOTE: Create a new free node, which has remaining space.
@@ -114,24 +313,8 @@ freelist_allocator::Allocate(size_t RequiredSize, const size_t Alignment)
 }
 
 void *
-freelist_allocator::ReAllocate(void *MemoryPtr, size_t NewSize, const size_t Alignment)
-{
-    ASSERT(MemoryPtr != nullptr);
-
-    auto *AllocationHeader = (freelist_allocation_header *)((u8 *)MemoryPtr -
-                                                            freelist_allocator::AllocationHeaderSize);
-    size_t HeaderPlusAlign = freelist_allocator::AllocationHeaderSize + AllocationHeader->AlignmentPadding;
-    size_t OldSize = AllocationHeader->BlockSize - HeaderPlusAlign;
-    NewSize = MAX(NewSize, freelist_allocator::FreeNodeHeaderSize);
-
-    return this->ReAllocateSized(MemoryPtr, OldSize, NewSize, Alignment);
-}
-
-void *
-freelist_allocator::ReAllocateSized(void *OldMemoryPtr, size_t OldSize, size_t NewSize, const size_t Alignment)
+freelist_allocator::FirstFitReAllocateSized(void *OldMemoryPtr, size_t OldSize, size_t NewSize, size_t Alignment)
 {
-    ASSERT(OldMemoryPtr != nullptr);
-
     // NOTE: The Allocation Header contains info about the allocated memory. It is always Header Size(16 bytes) behind the
     // allocated memory pointer.
     auto *AllocationHeader = (freelist_allocation_header *)((u8 *)OldMemoryPtr -
@@ -157,8 +340,11 @@ freelist_allocator::ReAllocateSized(void *OldMemoryPtr, size_t OldSize, size_t N
                 if((u8 *)CurrFreeBlock == (u8 *)OldMemoryPtr + OldSize)
                 {
                     size_t ExtraSpace = (NewSize - OldSize);
-                    // NOTE: Check if the lined up free block has enough space to fit the new size.
-                    if(CurrFreeBlock->data.BlockSize >= ExtraSpace)
+                    // NOTE: Check if the lined up free block has enough space to fit the new size. Whatever is
+                    // left of it has to be able to hold a free node.
+                    size_t SpaceLeft = CurrFreeBlock->data.BlockSize - ExtraSpace;
+                    if(CurrFreeBlock->data.BlockSize >= ExtraSpace &&
+                       (SpaceLeft == 0 || SpaceLeft >= freelist_allocator::FreeNodeHeaderSize))
                     {
                         AllocationHeader->BlockSize += ExtraSpace;
 
@@ -213,7 +399,7 @@ freelist_allocator::ReAllocateSized(void *OldMemoryPtr, size_t OldSize, size_t N
         if(!FoundContiguousFreeblock)
         {
             // NOTE: Set the Memory that we return to the newly allocated memory containing old data.
-            NewMemoryPtr = this->Allocate(NewSize, Alignment);
+            NewMemoryPtr = this->AllocateInternal(NewSize, Alignment);
 
             if(NewMemoryPtr)
             {
@@ -222,7 +408,7 @@ freelist_allocator::ReAllocateSized(void *OldMemoryPtr, size_t OldSize, size_t N
 
                 // NOTE: Freeing the old memory allocation since we got a new one and we have copied all data from
                 // old to new.
-                this->Free(OldMemoryPtr);
+                this->FreeInternal(OldMemoryPtr);
             }
             else
             {
@@ -231,16 +417,15 @@ freelist_allocator::ReAllocateSized(void *OldMemoryPtr, size_t OldSize, size_t N
             }
         }
     }
-    else if (OldSize > NewSize)
+    else if (OldSize >= NewSize + freelist_allocator::FreeNodeHeaderSize)
     {
         // NOTE: The New Size requires is less than the old size allocated. We calculate the difference and set
         // that as the free block.
         size_t ExtraSpaceToFree = OldSize - NewSize;
 
-        // TODO: Handle this case where the memory to be freed is even less than required to fill freeNode info.
-        // NOTE: The memory to be freed is less than the freenode header size. If we write to the head, it will
-        // likely overwrite to values beyond the ExtraSpaceToFree range and invalidate memory already getting
-        // used/a free block node in the freelist.
+        // NOTE: If the memory to be freed is less than the freenode header size, writing the node would overwrite
+        // values beyond the ExtraSpaceToFree range. Such small shrinks keep the old block as it is(see the check
+        // above).
         ASSERT(ExtraSpaceToFree >= freelist_allocator::FreeNodeHeaderSize);
 
         // NOTE: Updating the old memory header to reflect the reduced size.
@@ -310,14 +495,8 @@ freelist_allocator::ReAllocateSized(void *OldMemoryPtr, size_t OldSize, size_t N
 }
 
 void
-freelist_allocator::Free(void *MemoryPtr)
+freelist_allocator::FirstFitFree(void *MemoryPtr)
 {
-    if(MemoryPtr == nullptr)
-    {
-        LogWarnUnformatted("[Allocator::Free]: Ptr passed in here was nullptr!\n");
-        return;
-    }
-
     // NOTE: The memory was always on the aligned boundary when allocation was done. Allocation Header contains
     // info on how many bytes were used to align the boundary. The Allocation header directly precedes this memory.
 
@@ -396,11 +575,49 @@ freelist_allocator::Free(void *MemoryPtr)
     }
 }
 
+void
+freelist_allocator::GetStats(freelist_allocator_stats *Stats)
+{
+    *Stats = {};
+    Stats->TotalSize = this->TotalSize;
+    Stats->FreelistSize = this->FreelistSize;
+
+    if(this->Policy == FREELIST_POLICY_TLSF)
+    {
+        tlsf_stats TlsfStats;
+        this->Tlsf.GetStats(&TlsfStats);
+        Stats->FreeBytes = TlsfStats.FreeBytes;
+        Stats->LargestFreeBlock = TlsfStats.LargestFreeBlock;
+        Stats->FreeBlockCount = TlsfStats.FreeBlockCount;
+    }
+    else
+    {
+        for(flNode *Node = this->Freelist.head; Node != nullptr; Node = Node->next)
+        {
+            Stats->FreeBytes += Node->data.BlockSize;
+            Stats->LargestFreeBlock = MAX(Stats->LargestFreeBlock, Node->data.BlockSize);
+            ++Stats->FreeBlockCount;
+        }
+    }
+
+    Stats->Fragmentation = (Stats->FreeBytes > 0) ?
+                               (1.0f - ((f32)Stats->LargestFreeBlock / (f32)Stats->FreeBytes)) : 0.0f;
+
+    this->Slabs.GetStats(&Stats->Slabs);
+}
+
 #if _SHU_DEBUG
 size_t
 freelist_allocator::DEBUGGetRemainingSpace()
 {
     size_t Result = 0;
+    if(this->Policy == FREELIST_POLICY_TLSF)
+    {
+        tlsf_stats TlsfStats;
+        this->Tlsf.GetStats(&TlsfStats);
+        return TlsfStats.FreeBytes;
+    }
+
     flNode *fNode = Freelist.head;
 
     while (fNode != nullptr)
@@ -2,6 +2,9 @@
 #define FREELIST_ALLOCATOR_H
 
 #include <containers/linked_list/linked_list.h>
+#include "slab_allocator.h"
+#include "tlsf_heap.h"
+#include "allocation_trace.h"
 
 struct free_block_header
 {
@@ -14,25 +17,63 @@ struct freelist_allocation_header
     size_t BlockSize;
 };
 
+// NOTE: How the blocks that don't go to the slabs are found.
+// FIRST_FIT walks an address ordered list of free blocks. Cheap when there are only a few free blocks, but the walk
+// gets longer the more fragmented the memory gets.
+// TLSF uses segregated free lists with bitmaps (see tlsf_heap.h). O(1) allocation and free with immediate
+// coalescing.
+enum freelist_policy
+{
+    FREELIST_POLICY_FIRST_FIT,
+    FREELIST_POLICY_TLSF,
+};
+
+struct freelist_allocator_stats
+{
+    size_t TotalSize;
+
+    // NOTE: The part of the memory that is managed by the freelist, the rest is the slab region.
+    size_t FreelistSize;
+    size_t FreeBytes;
+    size_t LargestFreeBlock;
+    i32 FreeBlockCount;
+    // NOTE: 1 - LargestFreeBlock/FreeBytes. 0 means all the free memory is in one block.
+    f32 Fragmentation;
+
+    slab_stats Slabs;
+};
+
 typedef singly_linked_list_node<free_block_header> flNode;
 struct freelist_allocator
 {
     freelist_allocator() : Memory(nullptr), TotalSize(0) {}
     explicit freelist_allocator(void *Mem, size_t Size) { Initialize(Mem, Size); }
 
-    void Initialize(void *Memory, size_t Size);
+    // NOTE: If SlabRegionSize is not zero, that much of the memory is set aside for the slab allocator. Every
+    // allocation upto SLAB_MAX_BLOCK_SIZE bytes(and upto SLAB_MAX_ALIGNMENT alignment) then comes from the slabs in
+    // O(1) and only the bigger ones walk the freelist.
+    void Initialize(void *Memory, size_t Size, size_t SlabRegionSize = 0,
+                    freelist_policy Policy = FREELIST_POLICY_FIRST_FIT);
     void *Allocate(size_t Size, const size_t Alignment = 4);
     // NOTE: Same as C's realloc
     void *ReAllocate(void *MemoryPtr, size_t NewSize, const size_t Alignment = 4);
     void *ReAllocateSized(void *MemoryPtr, size_t OldSize, size_t NewSize, const size_t Alignment = 4);
     void Free(void *Memory);
 
+    // NOTE: Walks the freelist, so this is not free. Meant for the debug UI.
+    void GetStats(freelist_allocator_stats *Stats);
+
     const size_t AllocationHeaderSize = sizeof(freelist_allocation_header);
     const size_t FreeNodeHeaderSize = sizeof(free_block_header) + sizeof(void *);
 
   public:
     void *Memory = nullptr;
     size_t TotalSize = 0;
+    freelist_policy Policy = FREELIST_POLICY_FIRST_FIT;
+
+    // NOTE: If set, every Allocate/ReAllocate/Free call is recorded into it so that it can be replayed later(see
+    // allocation_trace.h).
+    allocation_trace *Trace = nullptr;
 
   private:
 #if _SHU_DEBUG
@@ -45,9 +86,21 @@ struct freelist_allocator
     singly_linked_list<free_block_header> Freelist;
 #endif
 
+    void *AllocateInternal(size_t Size, size_t Alignment);
+    void *ReAllocateInternal(void *MemoryPtr, size_t OldSize, size_t NewSize, size_t Alignment);
+    void FreeInternal(void *MemoryPtr);
+    size_t GetAllocationSize(void *MemoryPtr);
+
     void FirstFit(const size_t &Alignment, const size_t &RequiredSize, size_t &Padding, flNode **FoundNode,
                   flNode **PreviousNode);
+    void *FirstFitAllocate(size_t Size, size_t Alignment);
+    void *FirstFitReAllocateSized(void *MemoryPtr, size_t OldSize, size_t NewSize, size_t Alignment);
+    void FirstFitFree(void *MemoryPtr);
     b32 IsInitialized = false;
+
+    slab_allocator Slabs;
+    tlsf_heap Tlsf;
+    size_t FreelistSize = 0;
 };
 
 #if _SHU_DEBUG
@@ -1,9 +1,11 @@
 #include "memory.h"
 #include "memory_utils.h"
+#include <platform/platform.h>
 
 static shoora_memory ShuMemory = {};
 
-inline void InitializeTaskMemories(memory_arena *Arena);
+inline void InitializeTaskMemories(memory_arena *Arena, u32 Count, size_t Size);
+inline void InitializeThreadArenas(memory_arena *Arena, const memory_config &Config);
 
 memory_arena *
 GetArena(shoora_memory_type Type)
@@ -15,6 +17,12 @@ GetArena(shoora_memory_type Type)
         case MEMTYPE_FRAME: { Result = &ShuMemory.FrameArena; } break;
         case MEMTYPE_FREELISTGLOBAL: { Result = &ShuMemory.GlobalFreelistArena; } break;
         case MEMTYPE_FREELISTFRAME: { Result = &ShuMemory.FrameFreelistArena; } break;
+        case MEMTYPE_THREADFRAME:
+        {
+            u32 ThreadIndex = Platform_GetThreadIndex();
+            ASSERT(ThreadIndex < ShuMemory.ThreadArenaCount);
+            Result = &ShuMemory.ThreadArenas[ThreadIndex].Arena;
+        } break;
 
         SHU_INVALID_DEFAULT;
     }
@@ -23,6 +31,19 @@ GetArena(shoora_memory_type Type)
     return Result;
 }
 
+memory_arena *
+FindThreadFrameArena()
+{
+    memory_arena *Result = nullptr;
+    u32 ThreadIndex = Platform_GetThreadIndex();
+    if(ThreadIndex < ShuMemory.ThreadArenaCount)
+    {
+        Result = &ShuMemory.ThreadArenas[ThreadIndex].Arena;
+    }
+
+    return Result;
+}
+
 freelist_allocator *
 GetFreelistAllocator(shoora_memory_type Type)
 {
@@ -71,24 +92,40 @@ InitializeArena(memory_arena *Arena, size_t Size, void *BasePtr)
 }
 
 void
-InitializeMemory(size_t GlobalMemSize, void *GlobalMem, size_t FrameMemSize, void *FrameMem)
+InitializeMemory(size_t GlobalMemSize, void *GlobalMem, size_t FrameMemSize, void *FrameMem,
+                 const memory_config &Config)
 {
     InitializeArena(&ShuMemory.PermanentArena, GlobalMemSize, GlobalMem);
     InitializeArena(&ShuMemory.FrameArena, FrameMemSize, FrameMem);
 
-    InitializeTaskMemories(&ShuMemory.PermanentArena);
+    InitializeTaskMemories(&ShuMemory.PermanentArena, Config.TaskMemoryCount, Config.TaskMemorySize);
 
     size_t GlobalFreelistSize = MEGABYTES(128);
     SubArena(&ShuMemory.GlobalFreelistArena, &ShuMemory.PermanentArena, GlobalFreelistSize);
     void *GlobalFreelistMemory = ShuAllocate_(&ShuMemory.GlobalFreelistArena, GlobalFreelistSize);
-    ShuMemory.GlobalFreelistAllocator.Initialize(GlobalFreelistMemory, GlobalFreelistSize);
+    ShuMemory.GlobalFreelistAllocator.Initialize(GlobalFreelistMemory, GlobalFreelistSize, GLOBAL_SLAB_REGION_SIZE,
+                                                 FREELIST_DEFAULT_POLICY);
 
     size_t FrameFreelistSize = MEGABYTES(64);
     SubArena(&ShuMemory.FrameFreelistArena, &ShuMemory.FrameArena, FrameFreelistSize);
     void *FrameFreelistMemory = ShuAllocate_(&ShuMemory.FrameFreelistArena, FrameFreelistSize);
-    ShuMemory.FrameFreelistAllocator.Initialize(FrameFreelistMemory, FrameFreelistSize);
+    ShuMemory.FrameFreelistAllocator.Initialize(FrameFreelistMemory, FrameFreelistSize, FRAME_SLAB_REGION_SIZE,
+                                                FREELIST_DEFAULT_POLICY);
+
+    InitializeThreadArenas(&ShuMemory.FrameArena, Config);
+}
 
-    int x = 0;
+// NOTE: The per thread arenas are only ever touched by their own thread, so there is nothing to synchronize here
+// as long as this gets called when no work that uses them is in flight.
+void
+ResetThreadFrameArenas()
+{
+    for(u32 ThreadIndex = 0; ThreadIndex < ShuMemory.ThreadArenaCount; ++ThreadIndex)
+    {
+        memory_arena *Arena = &ShuMemory.ThreadArenas[ThreadIndex].Arena;
+        ASSERT(Arena->TempMemoryCount == 0);
+        Arena->Used = 0;
+    }
 }
 
 size_t
@@ -181,17 +218,35 @@ SubArena(memory_arena *Result, shoora_memory_type Type, size_t Size, size_t Alig
     SubArena(Result, Arena, Size, Alignment);
 }
 
-// NOTE: Initialize TASK_COUNT number of MemoryArenas which will be used by the individual threads in the
+// NOTE: Initialize Count number of MemoryArenas which will be used by the individual threads in the
 // threadPool presnet in the platform layer.
 inline void
-InitializeTaskMemories(memory_arena *Arena)
+InitializeTaskMemories(memory_arena *Arena, u32 Count, size_t Size)
 {
-    for (i32 TaskIndex = 0; TaskIndex < MAX_TASK_MEMORY_COUNT; ++TaskIndex)
+    ASSERT(Count > 0 && Size > 0);
+
+    ShuMemory.TaskMemoryCount = Count;
+    ShuMemory.TaskMemories = (task_with_memory *)ShuAllocate_(Arena, sizeof(task_with_memory)*Count, 16);
+    for (u32 TaskIndex = 0; TaskIndex < Count; ++TaskIndex)
     {
         task_with_memory *Task = ShuMemory.TaskMemories + TaskIndex;
-        Task->BeingUsed = false;
+        Task->BeingUsed = 0;
         Task->TemporaryMemory = {};
-        SubArena(&Task->Arena, Arena, MEGABYTES(4));
+        SubArena(&Task->Arena, Arena, Size);
+    }
+}
+
+// NOTE: Thread index 0 is the main thread which does most of the frame work, the rest are the worker threads.
+inline void
+InitializeThreadArenas(memory_arena *Arena, const memory_config &Config)
+{
+    ASSERT(Config.ThreadArenaCount > 0 && Config.ThreadArenaCount <= MAX_THREAD_ARENA_COUNT);
+
+    ShuMemory.ThreadArenaCount = Config.ThreadArenaCount;
+    for(u32 ThreadIndex = 0; ThreadIndex < Config.ThreadArenaCount; ++ThreadIndex)
+    {
+        size_t Size = (ThreadIndex == 0) ? Config.MainThreadArenaSize : Config.WorkerThreadArenaSize;
+        SubArena(&ShuMemory.ThreadArenas[ThreadIndex].Arena, Arena, Size, 64);
     }
 }
 
@@ -199,12 +254,12 @@ task_with_memory *
 GetTaskMemory()
 {
     task_with_memory *FreeTask = nullptr;
-    for (i32 i = 0; i < MAX_TASK_MEMORY_COUNT; ++i)
+    for (u32 i = 0; i < ShuMemory.TaskMemoryCount; ++i)
     {
         task_with_memory *Task = ShuMemory.TaskMemories + i;
-        if(!Task->BeingUsed)
+        // NOTE: Plain read first so that the slots that are taken don't cost an interlocked op.
+        if(!Task->BeingUsed && AtomicCompareExchangeU32(&Task->BeingUsed, 1, 0) == 0)
         {
-            // TODO(mani): Make this thread safe.
             FreeTask = Task;
             ASSERT(FreeTask->Arena.Used == 0);
             FreeTask->TemporaryMemory = BeginTemporaryMemory(&FreeTask->Arena);
@@ -224,7 +279,7 @@ FreeTaskMemory(task_with_memory *Task)
 
     // NOTE: Doing this since this free gets called directly from the thread when its ending.
     CompletePastWritesBeforeFutureWrites;
-    Task->BeingUsed = false;
+    Task->BeingUsed = 0;
 }
 
 #if 0
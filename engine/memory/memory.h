@@ -4,11 +4,24 @@
 #include <defines.h>
 #include "freelist_allocator.h"
 
-#define MAX_TASK_MEMORY_COUNT 4
-
-#define ShuAllocate(Size, MemType, ...) ShuAllocate_(Size, MemType, __VA_ARGS__)
-#define ShuAllocateStruct(Type, MemType, ...) (Type *)ShuAllocate_(sizeof(Type), MemType, __VA_ARGS__)
-#define ShuAllocateArray(Type, Count, MemType, ...) (Type *)ShuAllocate_(sizeof(Type)*Count, MemType, __VA_ARGS__)
+#define DEFAULT_TASK_MEMORY_COUNT 4
+#define DEFAULT_TASK_MEMORY_SIZE MEGABYTES(4)
+// NOTE: One linear arena per thread(the main thread and every worker thread in the platform work queues), carved
+// out of the frame memory and reset at the start of every frame.
+#define MAX_THREAD_ARENA_COUNT 16
+#define DEFAULT_MAIN_THREAD_ARENA_SIZE MEGABYTES(256)
+#define DEFAULT_WORKER_THREAD_ARENA_SIZE MEGABYTES(16)
+// NOTE: Part of the freelist allocators set aside for the small block slabs.
+#define GLOBAL_SLAB_REGION_SIZE MEGABYTES(16)
+#define FRAME_SLAB_REGION_SIZE MEGABYTES(8)
+// NOTE: TLSF keeps allocation time flat over long sessions where the first fit walk gets longer and longer.
+#define FREELIST_DEFAULT_POLICY FREELIST_POLICY_TLSF
+
+// NOTE: ##__VA_ARGS__ drops the comma when there is no alignment, MSVC does that for a plain __VA_ARGS__ too but GCC and
+// Clang do not.
+#define ShuAllocate(Size, MemType, ...) ShuAllocate_(Size, MemType, ##__VA_ARGS__)
+#define ShuAllocateStruct(Type, MemType, ...) (Type *)ShuAllocate_(sizeof(Type), MemType, ##__VA_ARGS__)
+#define ShuAllocateArray(Type, Count, MemType, ...) (Type *)ShuAllocate_(sizeof(Type)*Count, MemType, ##__VA_ARGS__)
 
 #if 0
 #define ShuAllocateGlobal(Size, ...) ShuAllocate_(Size, __VA_ARGS__)
@@ -38,12 +51,30 @@ struct temporary_memory
 
 struct task_with_memory
 {
-    b32 BeingUsed;
+    // NOTE: Claimed with a compare exchange, so more than one thread can ask for task memory at the same time.
+    u32 volatile BeingUsed;
     memory_arena Arena;
     // NOTE: This is used to reset the Arena after a thread is done with its work.
     temporary_memory TemporaryMemory;
 };
 
+// NOTE: Aligned to a cache line so that threads bumping their own arena do not fight over the same line.
+struct alignas(64) thread_arena
+{
+    memory_arena Arena;
+};
+
+struct memory_config
+{
+    u32 TaskMemoryCount = DEFAULT_TASK_MEMORY_COUNT;
+    size_t TaskMemorySize = DEFAULT_TASK_MEMORY_SIZE;
+
+    // NOTE: Includes the main thread, which is always thread index 0.
+    u32 ThreadArenaCount = MAX_THREAD_ARENA_COUNT;
+    size_t MainThreadArenaSize = DEFAULT_MAIN_THREAD_ARENA_SIZE;
+    size_t WorkerThreadArenaSize = DEFAULT_WORKER_THREAD_ARENA_SIZE;
+};
+
 struct shoora_memory
 {
     memory_arena PermanentArena;
@@ -54,7 +85,11 @@ struct shoora_memory
     freelist_allocator GlobalFreelistAllocator;
     freelist_allocator FrameFreelistAllocator;
 
-    task_with_memory TaskMemories[MAX_TASK_MEMORY_COUNT];
+    task_with_memory *TaskMemories;
+    u32 TaskMemoryCount;
+
+    thread_arena ThreadArenas[MAX_THREAD_ARENA_COUNT];
+    u32 ThreadArenaCount;
 };
 
 enum shoora_memory_type
@@ -64,11 +99,18 @@ enum shoora_memory_type
     MEMTYPE_FREELISTGLOBAL,
     MEMTYPE_FREELISTFRAME,
     MEMTYPE_FRAME,
+    // NOTE: The frame arena of the calling thread. Only for work that is done before the frame ends.
+    MEMTYPE_THREADFRAME,
 };
 
 memory_arena *GetArena(shoora_memory_type Type);
+// NOTE: The calling thread's frame arena, or nullptr if the memory is not initialized or the thread has none.
+memory_arena *FindThreadFrameArena();
 
-void InitializeMemory(size_t GlobalMemSize, void *GlobalMem, size_t FrameMemSize, void *FrameMem);
+void InitializeMemory(size_t GlobalMemSize, void *GlobalMem, size_t FrameMemSize, void *FrameMem,
+                      const memory_config &Config = memory_config{});
+// NOTE: Called once at the start of the frame, when none of the threads are using their frame arena.
+void ResetThreadFrameArenas();
 size_t GetRemainingMemory(shoora_memory_type Type, size_t Alignment = 4);
 freelist_allocator *GetFreelistAllocator(shoora_memory_type Type);
 
@@ -84,7 +126,7 @@ void *ShuAllocate_(size_t SizeInit, shoora_memory_type Type = MEMTYPE_GLOBAL, si
 void *ShuAllocate_(memory_arena *Arena, size_t SizeInit, size_t Alignment = 4);
 char *ShuAllocateString(const char *Source, shoora_memory_type Type = MEMTYPE_GLOBAL);
 
-// NOTE: Gets called before starting a thread
+// NOTE: Gets called before starting a thread. Returns nullptr if all the task memories are being used.
 task_with_memory *GetTaskMemory();
 // NOTE: Gets called from a thread at its end.
 void FreeTaskMemory(task_with_memory *Task);
@@ -0,0 +1,354 @@
+#include "slab_allocator.h"
+
+#include <platform/platform.h>
+
+constexpr u32
+SlabClassBlockSize(i32 ClassIndex)
+{
+    u32 Result = 0;
+    if(ClassIndex < 8)
+    {
+        Result = (u32)(ClassIndex + 1) * SLAB_MIN_BLOCK_SIZE;
+    }
+    else
+    {
+        // NOTE: 4 classes per power of two: 5/4, 6/4, 7/4 and 8/4 of the previous power of two.
+        u32 Group = (u32)(ClassIndex - 8) / 4;
+        u32 Sub = (u32)(ClassIndex - 8) % 4;
+        Result = (5 + Sub) << (5 + Group);
+    }
+
+    return Result;
+}
+
+struct slab_class_table
+{
+    // NOTE: Indexed by the size rounded up to SLAB_MIN_BLOCK_SIZE units.
+    u8 Index[(SLAB_MAX_BLOCK_SIZE / SLAB_MIN_BLOCK_SIZE) + 1];
+};
+
+constexpr slab_class_table
+BuildSlabClassTable()
+{
+    slab_class_table Table = {};
+    i32 ClassIndex = 0;
+    for(u32 Units = 1; Units < ARRAY_SIZE(Table.Index); ++Units)
+    {
+        while(SlabClassBlockSize(ClassIndex) < Units * SLAB_MIN_BLOCK_SIZE)
+        {
+            ++ClassIndex;
+        }
+        Table.Index[Units] = (u8)ClassIndex;
+    }
+
+    return Table;
+}
+
+static constexpr slab_class_table SlabClassTable = BuildSlabClassTable();
+static_assert(SlabClassBlockSize(SLAB_CLASS_COUNT - 1) == SLAB_MAX_BLOCK_SIZE,
+              "The last size class should be SLAB_MAX_BLOCK_SIZE!");
+
+static inline void
+LinkPage(slab_page **Head, slab_page *Page)
+{
+    Page->Prev = nullptr;
+    Page->Next = *Head;
+    if(*Head != nullptr)
+    {
+        (*Head)->Prev = Page;
+    }
+    *Head = Page;
+}
+
+static inline void
+UnlinkPage(slab_page **Head, slab_page *Page)
+{
+    if(Page->Prev != nullptr) { Page->Prev->Next = Page->Next; }
+    else                      { *Head = Page->Next; }
+
+    if(Page->Next != nullptr) { Page->Next->Prev = Page->Prev; }
+
+    Page->Prev = Page->Next = nullptr;
+}
+
+i32
+slab_allocator::GetClassIndex(size_t Size)
+{
+    ASSERT(Size <= SLAB_MAX_BLOCK_SIZE);
+
+    size_t Units = (MAX(Size, 1) + (SLAB_MIN_BLOCK_SIZE - 1)) / SLAB_MIN_BLOCK_SIZE;
+    i32 Result = SlabClassTable.Index[Units];
+    return Result;
+}
+
+u32
+slab_allocator::GetClassBlockSize(i32 ClassIndex)
+{
+    ASSERT(ClassIndex >= 0 && ClassIndex < SLAB_CLASS_COUNT);
+    u32 Result = SlabClassBlockSize(ClassIndex);
+    return Result;
+}
+
+void
+slab_allocator::Initialize(void *Region, size_t RegionSize, slab_page *Pages)
+{
+    ASSERT(Region != nullptr && Pages != nullptr);
+    ASSERT(((size_t)Region % SLAB_PAGE_SIZE) == 0 && "The slab region has to be page aligned!");
+
+    this->Base = (u8 *)Region;
+    this->PageCount = (u32)(RegionSize / SLAB_PAGE_SIZE);
+    this->RegionSize = (size_t)this->PageCount * SLAB_PAGE_SIZE;
+    this->Pages = Pages;
+    this->AllocationCount = 0;
+    this->FallbackCount = 0;
+
+    // NOTE: Pushing them in reverse so that the pages get used from the start of the region.
+    this->FreePages = nullptr;
+    for(i32 PageIndex = (i32)this->PageCount - 1; PageIndex >= 0; --PageIndex)
+    {
+        slab_page *Page = this->Pages + PageIndex;
+        *Page = {};
+        Page->ClassIndex = -1;
+        Page->Next = this->FreePages;
+        this->FreePages = Page;
+    }
+    this->FreePageCount = this->PageCount;
+
+    for(i32 ClassIndex = 0; ClassIndex < SLAB_CLASS_COUNT; ++ClassIndex)
+    {
+        slab_class *Class = this->Classes + ClassIndex;
+        *Class = {};
+        Class->BlockSize = SlabClassBlockSize(ClassIndex);
+    }
+}
+
+slab_page *
+slab_allocator::AcquirePage(i32 ClassIndex)
+{
+    slab_page *Page = this->FreePages;
+    if(Page != nullptr)
+    {
+        this->FreePages = Page->Next;
+        --this->FreePageCount;
+
+        slab_class *Class = this->Classes + ClassIndex;
+        Page->FreeBlocks = nullptr;
+        Page->BumpOffset = 0;
+        Page->UsedCount = 0;
+        Page->BlockCount = SLAB_PAGE_SIZE / Class->BlockSize;
+        Page->ClassIndex = ClassIndex;
+
+        LinkPage(&Class->PartialPages, Page);
+        ++Class->PageCount;
+    }
+
+    return Page;
+}
+
+void
+slab_allocator::ReleasePage(slab_page *Page)
+{
+    ASSERT(Page->UsedCount == 0);
+
+    slab_class *Class = this->Classes + Page->ClassIndex;
+    UnlinkPage(&Class->PartialPages, Page);
+    --Class->PageCount;
+
+    Page->ClassIndex = -1;
+    Page->Next = this->FreePages;
+    this->FreePages = Page;
+    ++this->FreePageCount;
+}
+
+void *
+slab_allocator::Allocate(size_t Size)
+{
+    if(Size > SLAB_MAX_BLOCK_SIZE || this->PageCount == 0)
+    {
+        return nullptr;
+    }
+
+    i32 ClassIndex = GetClassIndex(Size);
+    slab_class *Class = this->Classes + ClassIndex;
+
+    slab_page *Page = Class->PartialPages;
+    if(Page == nullptr)
+    {
+        Page = this->AcquirePage(ClassIndex);
+        if(Page == nullptr)
+        {
+            // NOTE: The caller falls back to the freelist.
+            ++this->FallbackCount;
+            return nullptr;
+        }
+    }
+
+    void *Result = nullptr;
+    if(Page->FreeBlocks != nullptr)
+    {
+        Result = Page->FreeBlocks;
+        Page->FreeBlocks = Page->FreeBlocks->Next;
+    }
+    else
+    {
+        ASSERT(Page->BumpOffset + Class->BlockSize <= SLAB_PAGE_SIZE);
+        u8 *PageMemory = this->Base + (size_t)(Page - this->Pages) * SLAB_PAGE_SIZE;
+        Result = PageMemory + Page->BumpOffset;
+        Page->BumpOffset += Class->BlockSize;
+    }
+
+    ++Page->UsedCount;
+    ++Class->UsedBlocks;
+    ++this->AllocationCount;
+
+    // NOTE: Full pages are not kept in the partial list, so the head of the list always has a free block.
+    if(Page->UsedCount == Page->BlockCount)
+    {
+        UnlinkPage(&Class->PartialPages, Page);
+    }
+
+    return Result;
+}
+
+void
+slab_allocator::Free(void *Memory)
+{
+    ASSERT(this->Owns(Memory));
+
+    size_t PageIndex = (size_t)((u8 *)Memory - this->Base) / SLAB_PAGE_SIZE;
+    slab_page *Page = this->Pages + PageIndex;
+    ASSERT(Page->ClassIndex >= 0 && Page->UsedCount > 0);
+
+    slab_class *Class = this->Classes + Page->ClassIndex;
+#if _SHU_DEBUG
+    size_t OffsetInPage = (size_t)((u8 *)Memory - this->Base) % SLAB_PAGE_SIZE;
+    ASSERT((OffsetInPage % Class->BlockSize) == 0 && "Pointer is not the start of a slab block!");
+#endif
+
+    b32 WasFull = (Page->UsedCount == Page->BlockCount);
+
+    slab_free_block *Block = (slab_free_block *)Memory;
+    Block->Next = Page->FreeBlocks;
+    Page->FreeBlocks = Block;
+    --Page->UsedCount;
+    --Class->UsedBlocks;
+
+    if(WasFull)
+    {
+        LinkPage(&Class->PartialPages, Page);
+    }
+
+    // NOTE: Keeping the last page of a class around, otherwise a single block going back and forth would keep
+    // acquiring and releasing the same page.
+    if(Page->UsedCount == 0 && Class->PageCount > 1)
+    {
+        this->ReleasePage(Page);
+    }
+}
+
+size_t
+slab_allocator::GetBlockSize(const void *Memory) const
+{
+    ASSERT(this->Owns(Memory));
+
+    size_t PageIndex = (size_t)((const u8 *)Memory - this->Base) / SLAB_PAGE_SIZE;
+    const slab_page *Page = this->Pages + PageIndex;
+    ASSERT(Page->ClassIndex >= 0);
+
+    size_t Result = this->Classes[Page->ClassIndex].BlockSize;
+    return Result;
+}
+
+void
+slab_allocator::GetStats(slab_stats *Stats) const
+{
+    *Stats = {};
+    Stats->PageCount = this->PageCount;
+    Stats->PagesInUse = this->PageCount - this->FreePageCount;
+    Stats->AllocationCount = this->AllocationCount;
+    Stats->FallbackCount = this->FallbackCount;
+    if(this->PageCount == 0)
+    {
+        return;
+    }
+
+    for(i32 ClassIndex = 0; ClassIndex < SLAB_CLASS_COUNT; ++ClassIndex)
+    {
+        const slab_class *Class = this->Classes + ClassIndex;
+        slab_class_stats *ClassStats = Stats->Classes + ClassIndex;
+
+        ClassStats->BlockSize = Class->BlockSize;
+        ClassStats->PageCount = Class->PageCount;
+        ClassStats->UsedBlocks = Class->UsedBlocks;
+        ClassStats->TotalBlocks = Class->PageCount * (SLAB_PAGE_SIZE / Class->BlockSize);
+        ClassStats->Occupancy = (ClassStats->TotalBlocks > 0) ?
+                                    ((f32)ClassStats->UsedBlocks / (f32)ClassStats->TotalBlocks) : 0.0f;
+
+        Stats->UsedBytes += (size_t)Class->UsedBlocks * Class->BlockSize;
+    }
+
+    Stats->CommittedBytes = (size_t)Stats->PagesInUse * SLAB_PAGE_SIZE;
+    Stats->Fragmentation = (Stats->CommittedBytes > 0) ?
+                               (1.0f - ((f32)Stats->UsedBytes / (f32)Stats->CommittedBytes)) : 0.0f;
+}
+
+#if _SHU_DEBUG
+void
+slab_allocator_test()
+{
+    const u32 PageCount = 4;
+    const size_t RegionSize = PageCount * SLAB_PAGE_SIZE;
+    u8 *Memory = (u8 *)malloc(RegionSize + SLAB_PAGE_SIZE);
+    u8 *Region = (u8 *)AlignAsPow2((u64)Memory, SLAB_PAGE_SIZE);
+    slab_page Pages[PageCount];
+
+    slab_allocator Slabs;
+    Slabs.Initialize(Region, RegionSize, Pages);
+
+    for(u32 Size = 1; Size <= SLAB_MAX_BLOCK_SIZE; ++Size)
+    {
+        u32 BlockSize = slab_allocator::GetClassBlockSize(slab_allocator::GetClassIndex(Size));
+        ASSERT(BlockSize >= Size && (BlockSize % 16) == 0);
+    }
+    ASSERT(Slabs.Allocate(SLAB_MAX_BLOCK_SIZE + 1) == nullptr);
+
+    // NOTE: Filling a whole page of one class, the next allocation has to get a second page.
+    u32 BlocksPerPage = SLAB_PAGE_SIZE / 64;
+    void *Blocks[(SLAB_PAGE_SIZE / 64) + 1];
+    for(u32 i = 0; i < ARRAY_SIZE(Blocks); ++i)
+    {
+        Blocks[i] = Slabs.Allocate(64);
+        ASSERT(Blocks[i] != nullptr && ((size_t)Blocks[i] % 16) == 0);
+        ASSERT(Slabs.GetBlockSize(Blocks[i]) == 64);
+    }
+
+    slab_stats Stats;
+    Slabs.GetStats(&Stats);
+    ASSERT(Stats.PagesInUse == 2 && Stats.Classes[3].UsedBlocks == BlocksPerPage + 1);
+
+    // NOTE: Freed blocks are handed out again before the page bump pointer.
+    void *Freed = Blocks[10];
+    Slabs.Free(Freed);
+    ASSERT(Slabs.Allocate(50) == Freed);
+
+    for(u32 i = 0; i < ARRAY_SIZE(Blocks); ++i)
+    {
+        Slabs.Free(Blocks[i]);
+    }
+
+    // NOTE: One page is kept for the class, the other one goes back to the pool.
+    Slabs.GetStats(&Stats);
+    ASSERT(Stats.PagesInUse == 1 && Stats.UsedBytes == 0);
+
+    // NOTE: Running out of pages.
+    void *Big[PageCount * (SLAB_PAGE_SIZE / SLAB_MAX_BLOCK_SIZE)];
+    for(u32 i = 0; i < ARRAY_SIZE(Big) - (SLAB_PAGE_SIZE / SLAB_MAX_BLOCK_SIZE); ++i)
+    {
+        Big[i] = Slabs.Allocate(SLAB_MAX_BLOCK_SIZE);
+        ASSERT(Big[i] != nullptr);
+    }
+    ASSERT(Slabs.Allocate(SLAB_MAX_BLOCK_SIZE) == nullptr && Slabs.FallbackCount == 1);
+
+    free(Memory);
+}
+#endif
@@ -0,0 +1,127 @@
+#if !defined(SLAB_ALLOCATOR_H)
+#define SLAB_ALLOCATOR_H
+
+#include <defines.h>
+
+// NOTE: Size classes are 16 bytes apart upto 128 bytes and then 4 classes for every power of two upto
+// SLAB_MAX_BLOCK_SIZE (160, 192, 224, 256, 320, ...). All of them are multiples of 16, so every block is 16 byte
+// aligned. Worst case waste is 25% of the block.
+#define SLAB_PAGE_SIZE KILOBYTES(64)
+#define SLAB_MIN_BLOCK_SIZE 16
+#define SLAB_MAX_BLOCK_SIZE 1024
+#define SLAB_MAX_ALIGNMENT 16
+#define SLAB_CLASS_COUNT 20
+
+struct slab_free_block
+{
+    slab_free_block *Next;
+};
+
+// NOTE: Metadata of a page. It is kept outside the page so that the whole page can be used for the blocks.
+struct slab_page
+{
+    slab_page *Prev;
+    slab_page *Next;
+
+    // NOTE: Freed blocks. Blocks that were never handed out are taken from BumpOffset instead, so a new page does
+    // not have to be threaded into a list up front.
+    slab_free_block *FreeBlocks;
+    u32 BumpOffset;
+
+    u32 UsedCount;
+    u32 BlockCount;
+    // NOTE: -1 if the page is not assigned to any size class.
+    i32 ClassIndex;
+};
+
+struct slab_class
+{
+    u32 BlockSize;
+    // NOTE: Pages of this class which have at least one free block.
+    slab_page *PartialPages;
+
+    u32 PageCount;
+    u32 UsedBlocks;
+};
+
+struct slab_class_stats
+{
+    u32 BlockSize;
+    u32 PageCount;
+    u32 UsedBlocks;
+    u32 TotalBlocks;
+    // NOTE: UsedBlocks / TotalBlocks.
+    f32 Occupancy;
+};
+
+struct slab_stats
+{
+    u32 PageCount;
+    u32 PagesInUse;
+
+    // NOTE: Bytes handed out(as block sizes) and bytes owned by the pages in use.
+    size_t UsedBytes;
+    size_t CommittedBytes;
+    // NOTE: 1 - UsedBytes/CommittedBytes. How much of the pages in use is sitting in free blocks.
+    f32 Fragmentation;
+
+    u64 AllocationCount;
+    // NOTE: Small allocations that went to the freelist since there was no page left.
+    u64 FallbackCount;
+
+    slab_class_stats Classes[SLAB_CLASS_COUNT];
+};
+
+// NOTE: Segregated size class allocator for small blocks. The memory region is split into SLAB_PAGE_SIZE pages and
+// every page is assigned to a single size class when it is first needed. Allocate and Free are O(1): the class is
+// found with a lookup table, the page of a block with a shift, and both the blocks and the pages are kept in
+// intrusive lists. Pages that become empty go back to a shared pool so that any class can reuse them.
+// This sits in front of the freelist_allocator. It does not own its memory and it is not thread safe.
+struct slab_allocator
+{
+    // NOTE: Region has to be SLAB_PAGE_SIZE aligned and Pages should have room for RegionSize/SLAB_PAGE_SIZE
+    // entries.
+    void Initialize(void *Region, size_t RegionSize, slab_page *Pages);
+
+    // NOTE: Returns nullptr if the size is too big for the slabs or if there is no page left for its class.
+    void *Allocate(size_t Size);
+    void Free(void *Memory);
+
+    inline b32
+    Owns(const void *Memory) const
+    {
+        b32 Result = ((const u8 *)Memory >= this->Base) && ((const u8 *)Memory < this->Base + this->RegionSize);
+        return Result;
+    }
+
+    // NOTE: Usable size of a block that was returned by Allocate.
+    size_t GetBlockSize(const void *Memory) const;
+
+    static i32 GetClassIndex(size_t Size);
+    static u32 GetClassBlockSize(i32 ClassIndex);
+
+    void GetStats(slab_stats *Stats) const;
+
+  public:
+    u8 *Base = nullptr;
+    size_t RegionSize = 0;
+    u64 FallbackCount = 0;
+
+  private:
+    slab_page *AcquirePage(i32 ClassIndex);
+    void ReleasePage(slab_page *Page);
+
+    slab_page *Pages = nullptr;
+    u32 PageCount = 0;
+    slab_page *FreePages = nullptr;
+    u32 FreePageCount = 0;
+
+    slab_class Classes[SLAB_CLASS_COUNT] = {};
+    u64 AllocationCount = 0;
+};
+
+#if _SHU_DEBUG
+void slab_allocator_test();
+#endif
+
+#endif // SLAB_ALLOCATOR_H
@@ -0,0 +1,494 @@
+#include "tlsf_heap.h"
+
+#include <platform/platform.h>
+#include <utils/utils.h>
+
+#define TLSF_BLOCK_FREE ((size_t)1)
+#define TLSF_PREV_FREE ((size_t)2)
+#define TLSF_FLAG_MASK (TLSF_BLOCK_FREE | TLSF_PREV_FREE)
+
+// NOTE: PrevPhysical and Size.
+#define TLSF_HEADER_SIZE (2 * sizeof(size_t))
+// NOTE: A free block has to be able to hold the free list links.
+#define TLSF_MIN_BLOCK_SIZE (2 * sizeof(void *))
+
+static_assert(TLSF_HEADER_SIZE == TLSF_ALIGN_SIZE, "The payload has to stay aligned after the header!");
+
+static inline i32
+TlsfFindFirstSet(u32 Word)
+{
+    ASSERT(Word != 0);
+#if defined(_MSC_VER)
+    unsigned long Index;
+    _BitScanForward(&Index, Word);
+    return (i32)Index;
+#else
+    return __builtin_ctz(Word);
+#endif
+}
+
+static inline i32
+TlsfFindLastSet(u64 Value)
+{
+    ASSERT(Value != 0);
+#if defined(_MSC_VER)
+    unsigned long Index;
+    _BitScanReverse64(&Index, Value);
+    return (i32)Index;
+#else
+    return 63 - __builtin_clzll(Value);
+#endif
+}
+
+static inline size_t BlockSize(const tlsf_block *Block) { return Block->Size & ~TLSF_FLAG_MASK; }
+static inline b32 IsFree(const tlsf_block *Block) { return (Block->Size & TLSF_BLOCK_FREE) != 0; }
+static inline b32 IsPrevFree(const tlsf_block *Block) { return (Block->Size & TLSF_PREV_FREE) != 0; }
+static inline void SetBlockSize(tlsf_block *Block, size_t Size) { Block->Size = Size | (Block->Size & TLSF_FLAG_MASK); }
+
+static inline void *
+BlockToPayload(const tlsf_block *Block)
+{
+    void *Result = (u8 *)Block + TLSF_HEADER_SIZE;
+    return Result;
+}
+
+static inline tlsf_block *
+PayloadToBlock(const void *Payload)
+{
+    tlsf_block *Result = (tlsf_block *)((u8 *)Payload - TLSF_HEADER_SIZE);
+    return Result;
+}
+
+static inline tlsf_block *
+NextPhysical(const tlsf_block *Block)
+{
+    tlsf_block *Result = (tlsf_block *)((u8 *)BlockToPayload(Block) + BlockSize(Block));
+    return Result;
+}
+
+// NOTE: Marks the block as free and lets the next block know about it.
+static inline void
+MarkFree(tlsf_block *Block)
+{
+    Block->Size |= TLSF_BLOCK_FREE;
+    tlsf_block *Next = NextPhysical(Block);
+    Next->PrevPhysical = Block;
+    Next->Size |= TLSF_PREV_FREE;
+}
+
+static inline void
+MarkUsed(tlsf_block *Block)
+{
+    Block->Size &= ~TLSF_BLOCK_FREE;
+    tlsf_block *Next = NextPhysical(Block);
+    Next->PrevPhysical = Block;
+    Next->Size &= ~TLSF_PREV_FREE;
+}
+
+// NOTE: Splits off everything after the first Size bytes of the payload into a new block. The new block has no
+// flags set, the caller has to mark it.
+static inline tlsf_block *
+SplitBlock(tlsf_block *Block, size_t Size)
+{
+    ASSERT(BlockSize(Block) >= Size + TLSF_HEADER_SIZE + TLSF_MIN_BLOCK_SIZE);
+
+    tlsf_block *Remainder = (tlsf_block *)((u8 *)BlockToPayload(Block) + Size);
+    Remainder->Size = BlockSize(Block) - Size - TLSF_HEADER_SIZE;
+    Remainder->PrevPhysical = Block;
+    SetBlockSize(Block, Size);
+
+    NextPhysical(Remainder)->PrevPhysical = Remainder;
+    return Remainder;
+}
+
+static inline size_t
+AdjustRequestSize(size_t Size)
+{
+    size_t Result = AlignAsPow2(MAX(Size, TLSF_MIN_BLOCK_SIZE), TLSF_ALIGN_SIZE);
+    return Result;
+}
+
+// NOTE: The list a block of this size goes into.
+static inline void
+MappingInsert(size_t Size, i32 *FL, i32 *SL)
+{
+    if(Size < TLSF_SMALL_BLOCK_SIZE)
+    {
+        *FL = 0;
+        *SL = (i32)(Size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_COUNT));
+    }
+    else
+    {
+        i32 Last = TlsfFindLastSet(Size);
+        *SL = (i32)(Size >> (Last - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *FL = Last - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+// NOTE: The first list where every block is big enough for this size. Rounding the size up to the next list is
+// what makes the search a bit scan instead of a walk.
+static inline void
+MappingSearch(size_t Size, i32 *FL, i32 *SL)
+{
+    if(Size >= TLSF_SMALL_BLOCK_SIZE)
+    {
+        Size += ((size_t)1 << (TlsfFindLastSet(Size) - TLSF_SL_LOG2)) - 1;
+    }
+
+    MappingInsert(Size, FL, SL);
+}
+
+void
+tlsf_heap::Initialize(void *Memory, size_t Size)
+{
+    ASSERT(Memory != nullptr);
+
+    this->FLBitmap = 0;
+    SHU_MEMZERO(this->SLBitmap, sizeof(this->SLBitmap));
+    SHU_MEMZERO(this->FreeLists, sizeof(this->FreeLists));
+
+    u8 *Start = (u8 *)AlignAsPow2((u64)Memory, TLSF_ALIGN_SIZE);
+    size_t Usable = Size - (size_t)(Start - (u8 *)Memory);
+
+    // NOTE: The last header is a zero sized used block, so the last real block never tries to merge past the end.
+    size_t PayloadSize = (Usable - 2 * TLSF_HEADER_SIZE) & ~(size_t)(TLSF_ALIGN_SIZE - 1);
+    ASSERT(Usable > 2 * TLSF_HEADER_SIZE + TLSF_MIN_BLOCK_SIZE);
+    ASSERT(PayloadSize < ((size_t)1 << TLSF_FL_MAX) && "The heap is too big for the first level index!");
+
+    tlsf_block *Block = (tlsf_block *)Start;
+    Block->PrevPhysical = nullptr;
+    Block->Size = PayloadSize;
+
+    tlsf_block *Sentinel = NextPhysical(Block);
+    Sentinel->Size = 0;
+
+    MarkFree(Block);
+    this->InsertFree(Block);
+    this->FirstBlock = Block;
+}
+
+void
+tlsf_heap::InsertFree(tlsf_block *Block)
+{
+    i32 FL, SL;
+    MappingInsert(BlockSize(Block), &FL, &SL);
+
+    tlsf_block *Head = this->FreeLists[FL][SL];
+    Block->NextFree = Head;
+    Block->PrevFree = nullptr;
+    if(Head != nullptr)
+    {
+        Head->PrevFree = Block;
+    }
+
+    this->FreeLists[FL][SL] = Block;
+    this->FLBitmap |= (1u << FL);
+    this->SLBitmap[FL] |= (1u << SL);
+}
+
+void
+tlsf_heap::RemoveFree(tlsf_block *Block)
+{
+    i32 FL, SL;
+    MappingInsert(BlockSize(Block), &FL, &SL);
+
+    if(Block->PrevFree != nullptr) { Block->PrevFree->NextFree = Block->NextFree; }
+    if(Block->NextFree != nullptr) { Block->NextFree->PrevFree = Block->PrevFree; }
+
+    if(this->FreeLists[FL][SL] == Block)
+    {
+        this->FreeLists[FL][SL] = Block->NextFree;
+        if(Block->NextFree == nullptr)
+        {
+            this->SLBitmap[FL] &= ~(1u << SL);
+            if(this->SLBitmap[FL] == 0)
+            {
+                this->FLBitmap &= ~(1u << FL);
+            }
+        }
+    }
+}
+
+tlsf_block *
+tlsf_heap::LocateFree(size_t Size)
+{
+    i32 FL, SL;
+    MappingSearch(Size, &FL, &SL);
+    if(FL >= TLSF_FL_COUNT)
+    {
+        return nullptr;
+    }
+
+    // NOTE: First a list in the same first level with at least this size, then the smallest non empty first level
+    // above it.
+    u32 SLMap = this->SLBitmap[FL] & (~0u << SL);
+    if(SLMap == 0)
+    {
+        u32 FLMap = (FL + 1 < 32) ? (this->FLBitmap & (~0u << (FL + 1))) : 0;
+        if(FLMap == 0)
+        {
+            return nullptr;
+        }
+
+        FL = TlsfFindFirstSet(FLMap);
+        SLMap = this->SLBitmap[FL];
+    }
+
+    SL = TlsfFindFirstSet(SLMap);
+    tlsf_block *Result = this->FreeLists[FL][SL];
+    ASSERT(Result != nullptr && BlockSize(Result) >= Size);
+    return Result;
+}
+
+tlsf_block *
+tlsf_heap::MergeWithFreeNeighbours(tlsf_block *Block)
+{
+    if(IsPrevFree(Block))
+    {
+        tlsf_block *Prev = Block->PrevPhysical;
+        ASSERT(IsFree(Prev));
+        this->RemoveFree(Prev);
+        SetBlockSize(Prev, BlockSize(Prev) + BlockSize(Block) + TLSF_HEADER_SIZE);
+        Block = Prev;
+    }
+
+    tlsf_block *Next = NextPhysical(Block);
+    if(IsFree(Next))
+    {
+        this->RemoveFree(Next);
+        SetBlockSize(Block, BlockSize(Block) + BlockSize(Next) + TLSF_HEADER_SIZE);
+    }
+
+    NextPhysical(Block)->PrevPhysical = Block;
+    return Block;
+}
+
+// NOTE: Gives the part of a used block after Size back to the heap, if it is big enough to be a block.
+void
+tlsf_heap::TrimUsed(tlsf_block *Block, size_t Size)
+{
+    ASSERT(!IsFree(Block));
+
+    if(BlockSize(Block) >= Size + TLSF_HEADER_SIZE + TLSF_MIN_BLOCK_SIZE)
+    {
+        tlsf_block *Remainder = SplitBlock(Block, Size);
+        // NOTE: The block in front of the remainder is used.
+        Remainder = this->MergeWithFreeNeighbours(Remainder);
+        MarkFree(Remainder);
+        this->InsertFree(Remainder);
+    }
+}
+
+void *
+tlsf_heap::Allocate(size_t Size, size_t Alignment)
+{
+    ASSERTPow2(MAX(Alignment, 1));
+    size_t Adjusted = AdjustRequestSize(Size);
+
+    // NOTE: For bigger alignments, look for a block that still fits after moving the payload forward. The gap in
+    // front becomes a free block of its own, so it has to be big enough to be one.
+    size_t MinGap = TLSF_HEADER_SIZE + TLSF_MIN_BLOCK_SIZE;
+    size_t SearchSize = (Alignment > TLSF_ALIGN_SIZE) ? (Adjusted + Alignment + MinGap) : Adjusted;
+
+    tlsf_block *Block = this->LocateFree(SearchSize);
+    if(Block == nullptr)
+    {
+        return nullptr;
+    }
+
+    this->RemoveFree(Block);
+
+    if(Alignment > TLSF_ALIGN_SIZE)
+    {
+        u8 *Payload = (u8 *)BlockToPayload(Block);
+        u8 *Aligned = (u8 *)AlignAsPow2((u64)Payload, Alignment);
+        size_t Gap = (size_t)(Aligned - Payload);
+        if(Gap > 0 && Gap < MinGap)
+        {
+            Aligned = (u8 *)AlignAsPow2((u64)(Payload + MinGap), Alignment);
+            Gap = (size_t)(Aligned - Payload);
+        }
+
+        if(Gap > 0)
+        {
+            // NOTE: The block in front of a free block is always used, so the gap can't merge with anything.
+            tlsf_block *Leading = Block;
+            Block = SplitBlock(Leading, Gap - TLSF_HEADER_SIZE);
+            Block->Size |= TLSF_PREV_FREE;
+            Leading->Size |= TLSF_BLOCK_FREE;
+            this->InsertFree(Leading);
+        }
+    }
+
+    MarkUsed(Block);
+    this->TrimUsed(Block, Adjusted);
+
+    void *Result = BlockToPayload(Block);
+    return Result;
+}
+
+void
+tlsf_heap::Free(void *Memory)
+{
+    ASSERT(Memory != nullptr);
+
+    tlsf_block *Block = PayloadToBlock(Memory);
+    ASSERT(!IsFree(Block) && "Double free!");
+
+    Block = this->MergeWithFreeNeighbours(Block);
+    MarkFree(Block);
+    this->InsertFree(Block);
+}
+
+void *
+tlsf_heap::ReAllocate(void *Memory, size_t NewSize, size_t Alignment)
+{
+    ASSERT(Memory != nullptr);
+
+    tlsf_block *Block = PayloadToBlock(Memory);
+    size_t CurrentSize = BlockSize(Block);
+    size_t Adjusted = AdjustRequestSize(NewSize);
+
+    if(Adjusted > CurrentSize)
+    {
+        // NOTE: Grow in place into the next block if it is free and big enough.
+        tlsf_block *Next = NextPhysical(Block);
+        if(IsFree(Next) && (CurrentSize + TLSF_HEADER_SIZE + BlockSize(Next)) >= Adjusted)
+        {
+            this->RemoveFree(Next);
+            SetBlockSize(Block, CurrentSize + TLSF_HEADER_SIZE + BlockSize(Next));
+            MarkUsed(Block);
+        }
+        else
+        {
+            void *Result = this->Allocate(NewSize, Alignment);
+            if(Result != nullptr)
+            {
+                SHU_MEMCOPY(Memory, Result, CurrentSize);
+                this->Free(Memory);
+            }
+            return Result;
+        }
+    }
+
+    this->TrimUsed(Block, Adjusted);
+    return Memory;
+}
+
+size_t
+tlsf_heap::GetBlockSize(const void *Memory) const
+{
+    size_t Result = BlockSize(PayloadToBlock(Memory));
+    return Result;
+}
+
+void
+tlsf_heap::GetStats(tlsf_stats *Stats) const
+{
+    *Stats = {};
+    for(i32 FL = 0; FL < TLSF_FL_COUNT; ++FL)
+    {
+        for(i32 SL = 0; SL < TLSF_SL_COUNT; ++SL)
+        {
+            for(tlsf_block *Block = this->FreeLists[FL][SL]; Block != nullptr; Block = Block->NextFree)
+            {
+                size_t Size = BlockSize(Block);
+                Stats->FreeBytes += Size;
+                Stats->LargestFreeBlock = MAX(Stats->LargestFreeBlock, Size);
+                ++Stats->FreeBlockCount;
+            }
+        }
+    }
+}
+
+#if _SHU_DEBUG
+void
+tlsf_heap::Validate() const
+{
+    i32 FreeBlocks = 0;
+    b32 PrevWasFree = false;
+    const tlsf_block *Prev = nullptr;
+    for(const tlsf_block *Block = this->FirstBlock; BlockSize(Block) != 0; Block = NextPhysical(Block))
+    {
+        ASSERT(((size_t)BlockToPayload(Block) % TLSF_ALIGN_SIZE) == 0);
+        ASSERT(Prev == nullptr || Block->PrevPhysical == Prev);
+        ASSERT(IsPrevFree(Block) == PrevWasFree);
+        ASSERT(!(PrevWasFree && IsFree(Block)) && "Two free blocks next to each other!");
+
+        PrevWasFree = IsFree(Block);
+        FreeBlocks += PrevWasFree ? 1 : 0;
+        Prev = Block;
+    }
+
+    tlsf_stats Stats;
+    this->GetStats(&Stats);
+    ASSERT(Stats.FreeBlockCount == FreeBlocks);
+}
+
+#include <utils/random/random.h>
+void
+tlsf_heap_test()
+{
+    const size_t MemSize = MEGABYTES(4);
+    void *Mem = malloc(MemSize);
+
+    tlsf_heap Heap;
+    Heap.Initialize(Mem, MemSize);
+
+    tlsf_stats Stats;
+    Heap.GetStats(&Stats);
+    const size_t InitialFree = Stats.FreeBytes;
+
+    struct test_allocation
+    {
+        u8 *Memory;
+        size_t Size;
+    };
+    test_allocation Allocations[512] = {};
+
+    shoora_random Random(1234);
+    for(i32 Iteration = 0; Iteration < 20000; ++Iteration)
+    {
+        test_allocation &A = Allocations[Random.Between(0u, (u32)ARRAY_SIZE(Allocations))];
+        size_t Size = Random.Between(1u, 4096u);
+        if(A.Memory == nullptr)
+        {
+            size_t Alignment = (size_t)1 << Random.Between(0u, 7u);
+            A.Memory = (u8 *)Heap.Allocate(Size, Alignment);
+            ASSERT(A.Memory != nullptr && ((size_t)A.Memory % Alignment) == 0);
+            A.Size = Size;
+            SHU_MEMSET(A.Memory, (u8)A.Size, A.Size);
+        }
+        else if(Random.Between(0u, 2u))
+        {
+            A.Memory = (u8 *)Heap.ReAllocate(A.Memory, Size, TLSF_ALIGN_SIZE);
+            for(size_t i = 0; i < MIN(Size, A.Size); ++i) { ASSERT(A.Memory[i] == (u8)A.Size); }
+            A.Size = Size;
+            SHU_MEMSET(A.Memory, (u8)A.Size, A.Size);
+        }
+        else
+        {
+            for(size_t i = 0; i < A.Size; ++i) { ASSERT(A.Memory[i] == (u8)A.Size); }
+            Heap.Free(A.Memory);
+            A.Memory = nullptr;
+        }
+
+        if((Iteration % 1000) == 0)
+        {
+            Heap.Validate();
+        }
+    }
+
+    for(i32 i = 0; i < ARRAY_SIZE(Allocations); ++i)
+    {
+        if(Allocations[i].Memory != nullptr) { Heap.Free(Allocations[i].Memory); }
+    }
+
+    // NOTE: Everything got coalesced back into one block.
+    Heap.Validate();
+    Heap.GetStats(&Stats);
+    ASSERT(Stats.FreeBlockCount == 1 && Stats.FreeBytes == InitialFree);
+
+    free(Mem);
+}
+#endif
@@ -0,0 +1,78 @@
+#if !defined(TLSF_HEAP_H)
+#define TLSF_HEAP_H
+
+#include <defines.h>
+
+// NOTE: Block sizes are multiples of 16. The first level splits the sizes by powers of two, the second level splits
+// each power of two into TLSF_SL_COUNT linear ranges. Everything below TLSF_SMALL_BLOCK_SIZE lives in the first
+// first-level list, split into 16 byte ranges.
+#define TLSF_ALIGN_LOG2 4
+#define TLSF_ALIGN_SIZE (1 << TLSF_ALIGN_LOG2)
+#define TLSF_SL_LOG2 4
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_MAX 32
+#define TLSF_FL_COUNT (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SMALL_BLOCK_SIZE (1 << TLSF_FL_SHIFT)
+
+struct tlsf_block
+{
+    // NOTE: Block right before this one in memory.
+    tlsf_block *PrevPhysical;
+    // NOTE: Size of the payload. The low 2 bits are the TLSF_BLOCK_FREE and TLSF_PREV_FREE flags.
+    size_t Size;
+
+    // NOTE: The payload starts here, these two are only used while the block is free.
+    tlsf_block *NextFree;
+    tlsf_block *PrevFree;
+};
+
+struct tlsf_stats
+{
+    size_t FreeBytes;
+    size_t LargestFreeBlock;
+    i32 FreeBlockCount;
+};
+
+// NOTE: Two Level Segregated Fit heap (Masmano et al.). Free blocks are kept in TLSF_FL_COUNT x TLSF_SL_COUNT
+// size segregated lists with a bitmap per level, so finding a block that fits is two bit scans and Allocate/Free
+// are O(1) no matter how fragmented the memory gets. Blocks are coalesced with their free neighbours as soon as
+// they are freed, so there are never two free blocks next to each other.
+// Every block has a 16 byte header in front of the payload. It does not own its memory and it is not thread safe.
+struct tlsf_heap
+{
+    void Initialize(void *Memory, size_t Size);
+
+    void *Allocate(size_t Size, size_t Alignment);
+    void *ReAllocate(void *Memory, size_t NewSize, size_t Alignment);
+    void Free(void *Memory);
+
+    // NOTE: Usable size of an allocated block, can be bigger than what was asked for.
+    size_t GetBlockSize(const void *Memory) const;
+
+    // NOTE: Walks the free lists.
+    void GetStats(tlsf_stats *Stats) const;
+#if _SHU_DEBUG
+    // NOTE: Walks all the blocks and checks the flags, the links and that no two free blocks are next to each other.
+    void Validate() const;
+#endif
+
+  private:
+    tlsf_block *LocateFree(size_t Size);
+    void InsertFree(tlsf_block *Block);
+    void RemoveFree(tlsf_block *Block);
+    tlsf_block *MergeWithFreeNeighbours(tlsf_block *Block);
+    void TrimUsed(tlsf_block *Block, size_t Size);
+
+    tlsf_block *FirstBlock = nullptr;
+
+    u32 FLBitmap = 0;
+    u32 SLBitmap[TLSF_FL_COUNT];
+    tlsf_block *FreeLists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+};
+
+#if _SHU_DEBUG
+void tlsf_heap_test();
+#endif
+
+#endif // TLSF_HEAP_H
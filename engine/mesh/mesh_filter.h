@@ -1,6 +1,26 @@
 #if !defined(MESH_FILTER_H)
 
 #include <defines.h>
+#include <math/math.h>
+
+// NOTE: The vertex layouts the GPU can get a mesh in(mesh/vertex_packing.h). The CPU side always keeps the full
+// shoora_vertex_info ones.
+enum shoora_vertex_format
+{
+    VertexFormat_Full,      // NOTE: shoora_vertex_info, 60 bytes.
+    VertexFormat_Compact,   // NOTE: shoora_vertex_info_compact, 28 bytes.
+    VertexFormat_Quantized, // NOTE: shoora_vertex_info_quantized, 24 bytes.
+
+    VertexFormat_Count
+};
+
+// NOTE: Position = Offset + Scale*QuantizedPosition, with the quantized position in [0, 1]. Scale 1 and Offset 0 for
+// the formats which keep the float positions.
+struct shoora_vertex_dequant
+{
+    shu::vec3f Scale;
+    shu::vec3f Offset;
+};
 
 struct shoora_mesh_filter
 {
@@ -8,7 +28,13 @@ struct shoora_mesh_filter
     u32 VertexCount;
     u32 *Indices;
     u32 IndexCount;
+
+    // NOTE: The vertices in PackedFormat for the GPU, nullptr for VertexFormat_Full where Vertices is uploaded as it
+    // is.
+    shoora_vertex_format PackedFormat;
+    void *PackedVertices;
+    shoora_vertex_dequant PositionDequant;
 };
 
 #define MESH_FILTER_H
-#endif
\ No newline at end of file
+#endif
@@ -415,11 +415,5 @@ shoora_primitive_collection::Cleanup()
 {
     ASSERT(UVSphereModel.MeshFilter.Vertices != nullptr &&
            UVSphereModel.MeshFilter.Indices != nullptr);
-    free(UVSphereModel.MeshFilter.Vertices);
-    free(UVSphereModel.MeshFilter.Indices);
-
-    if(UVSphereModel.Nodes) { free(UVSphereModel.Nodes); }
-    if(UVSphereModel.Materials) { free(UVSphereModel.Materials); }
-    if(UVSphereModel.Textures) { free(UVSphereModel.Textures); }
-
+    CleanupModelResources(&UVSphereModel);
 }
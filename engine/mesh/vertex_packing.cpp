@@ -0,0 +1,466 @@
+#include "vertex_packing.h"
+
+#include <platform/platform.h>
+#include <platform/job_system.h>
+#include <renderer/vulkan/vulkan_vertex_definitions.h>
+#include <utils/random/random.h>
+
+static_assert(sizeof(shoora_vertex_info_compact) == 28, "The compact vertex has padding!");
+static_assert(sizeof(shoora_vertex_info_quantized) == 24, "The quantized vertex has padding!");
+
+// NOTE: Vertices per job when packing.
+#define VERTEX_PACKING_BATCH_SIZE 4096
+
+u32
+GetVertexFormatSize(shoora_vertex_format Format)
+{
+    u32 Result = 0;
+    switch(Format)
+    {
+        case VertexFormat_Full: { Result = sizeof(shoora_vertex_info); } break;
+        case VertexFormat_Compact: { Result = sizeof(shoora_vertex_info_compact); } break;
+        case VertexFormat_Quantized: { Result = sizeof(shoora_vertex_info_quantized); } break;
+        default: { ASSERT(!"Invalid vertex format!"); } break;
+    }
+
+    return Result;
+}
+
+const char *
+GetVertexFormatName(shoora_vertex_format Format)
+{
+    const char *Result = "invalid";
+    switch(Format)
+    {
+        case VertexFormat_Full: { Result = "full"; } break;
+        case VertexFormat_Compact: { Result = "compact"; } break;
+        case VertexFormat_Quantized: { Result = "quantized"; } break;
+        default: break;
+    }
+
+    return Result;
+}
+
+static inline f32
+SignNotZero(f32 Value)
+{
+    f32 Result = (Value >= 0.0f) ? 1.0f : -1.0f;
+    return Result;
+}
+
+static inline i16
+EncodeSnorm16(f32 Value)
+{
+    f32 Clamped = ClampToRange(Value, -1.0f, 1.0f);
+    i16 Result = (i16)roundf(Clamped*32767.0f);
+    return Result;
+}
+
+// NOTE: Projects the direction on the octahedron |x| + |y| + |z| = 1 and folds the lower half over the upper one, so
+// it becomes a point in the [-1, 1] square. A zero direction(meshes without normals) comes back as +z.
+void
+EncodeOctahedral(const shu::vec3f &Direction, i16 *Out)
+{
+    f32 L1 = fabsf(Direction.x) + fabsf(Direction.y) + fabsf(Direction.z);
+    if(L1 == 0.0f)
+    {
+        Out[0] = 0;
+        Out[1] = 0;
+        return;
+    }
+
+    f32 x = Direction.x / L1;
+    f32 y = Direction.y / L1;
+    if(Direction.z < 0.0f)
+    {
+        f32 FoldedX = (1.0f - fabsf(y))*SignNotZero(x);
+        f32 FoldedY = (1.0f - fabsf(x))*SignNotZero(y);
+        x = FoldedX;
+        y = FoldedY;
+    }
+
+    Out[0] = EncodeSnorm16(x);
+    Out[1] = EncodeSnorm16(y);
+}
+
+// NOTE: The same thing the vertex shaders do(sponza_compact.vert.glsl).
+shu::vec3f
+DecodeOctahedral(const i16 *Encoded)
+{
+    f32 x = MAX((f32)Encoded[0] / 32767.0f, -1.0f);
+    f32 y = MAX((f32)Encoded[1] / 32767.0f, -1.0f);
+    f32 z = 1.0f - fabsf(x) - fabsf(y);
+    f32 t = MAX(-z, 0.0f);
+    x += (x >= 0.0f) ? -t : t;
+    y += (y >= 0.0f) ? -t : t;
+
+    shu::vec3f Result = shu::Normalize(shu::Vec3f(x, y, z));
+    return Result;
+}
+
+// NOTE: Round to nearest even. Too big values become infinity, too small ones become half denormals or zero.
+u16
+EncodeHalf(f32 Value)
+{
+    u32 Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+    u32 Sign = (Bits >> 16) & 0x8000;
+    u32 Abs = Bits & 0x7FFFFFFF;
+
+    u32 Result;
+    if(Abs >= 0x7F800000)
+    {
+        // NOTE: Infinity stays infinity and NaN stays a quiet NaN.
+        Result = 0x7C00 | ((Abs > 0x7F800000) ? 0x200 : 0);
+    }
+    else if(Abs >= 0x477FF000)
+    {
+        // NOTE: 65520 and up round past the biggest half.
+        Result = 0x7C00;
+    }
+    else if(Abs < 0x38800000)
+    {
+        // NOTE: Below the smallest normal half. Adding 0.5 moves the value's bits down to where the half denormal
+        // ones are and the float add does the rounding.
+        f32 AbsValue;
+        memcpy(&AbsValue, &Abs, sizeof(AbsValue));
+        AbsValue += 0.5f;
+        u32 AbsBits;
+        memcpy(&AbsBits, &AbsValue, sizeof(AbsBits));
+        Result = AbsBits - 0x3F000000;
+    }
+    else
+    {
+        // NOTE: Rebias the exponent(127 to 15) and round the 13 mantissa bits which are dropped.
+        u32 MantissaOdd = (Abs >> 13) & 1;
+        Abs += 0xC8000FFF + MantissaOdd;
+        Result = Abs >> 13;
+    }
+
+    return (u16)(Result | Sign);
+}
+
+f32
+DecodeHalf(u16 Half)
+{
+    u32 Sign = (u32)(Half & 0x8000) << 16;
+    u32 Exponent = (Half >> 10) & 0x1F;
+    u32 Mantissa = Half & 0x3FF;
+
+    f32 Result;
+    if(Exponent == 0)
+    {
+        Result = (f32)Mantissa*(1.0f / 16777216.0f);
+        Result = Sign ? -Result : Result;
+    }
+    else
+    {
+        u32 Bits = Sign | (Mantissa << 13) | ((Exponent == 0x1F) ? 0x7F800000 : ((Exponent + 112) << 23));
+        memcpy(&Result, &Bits, sizeof(Result));
+    }
+
+    return Result;
+}
+
+u8
+EncodeUnorm8(f32 Value)
+{
+    f32 Clamped = ClampToRange(Value, 0.0f, 1.0f);
+    u8 Result = (u8)(Clamped*255.0f + 0.5f);
+    return Result;
+}
+
+f32
+DecodeUnorm8(u8 Value)
+{
+    f32 Result = (f32)Value / 255.0f;
+    return Result;
+}
+
+static inline u16
+EncodeUnorm16(f32 Value)
+{
+    f32 Clamped = ClampToRange(Value, 0.0f, 1.0f);
+    u16 Result = (u16)(Clamped*65535.0f + 0.5f);
+    return Result;
+}
+
+shoora_vertex_dequant
+GetPositionDequant(const shoora_vertex_info *Vertices, u32 VertexCount, shoora_vertex_format Format)
+{
+    shoora_vertex_dequant Result;
+    Result.Scale = shu::Vec3f(1.0f);
+    Result.Offset = shu::Vec3f(0.0f);
+    if(Format != VertexFormat_Quantized || VertexCount == 0)
+    {
+        return Result;
+    }
+
+    shu::vec3f Min = Vertices[0].Pos;
+    shu::vec3f Max = Vertices[0].Pos;
+    for(u32 Index = 1; Index < VertexCount; ++Index)
+    {
+        const shu::vec3f &Pos = Vertices[Index].Pos;
+        Min = shu::Vec3f(MIN(Min.x, Pos.x), MIN(Min.y, Pos.y), MIN(Min.z, Pos.z));
+        Max = shu::Vec3f(MAX(Max.x, Pos.x), MAX(Max.y, Pos.y), MAX(Max.z, Pos.z));
+    }
+
+    Result.Scale = Max - Min;
+    Result.Offset = Min;
+    return Result;
+}
+
+template <typename vertex_type>
+static inline void
+PackVertexAttributes(const shoora_vertex_info *Vertex, vertex_type *Out)
+{
+    EncodeOctahedral(Vertex->Normal, Out->Normal);
+    EncodeOctahedral(shu::Vec3f(Vertex->Tangent.x, Vertex->Tangent.y, Vertex->Tangent.z), Out->Tangent);
+    Out->UV[0] = EncodeHalf(Vertex->UV.x);
+    Out->UV[1] = EncodeHalf(Vertex->UV.y);
+    Out->Color[0] = EncodeUnorm8(Vertex->Color.x);
+    Out->Color[1] = EncodeUnorm8(Vertex->Color.y);
+    Out->Color[2] = EncodeUnorm8(Vertex->Color.z);
+    Out->Color[3] = (Vertex->Tangent.w < 0.0f) ? 0 : 255;
+}
+
+template <typename vertex_type>
+static inline void
+UnpackVertexAttributes(const vertex_type *Packed, shoora_vertex_info *Out)
+{
+    Out->Normal = DecodeOctahedral(Packed->Normal);
+    shu::vec3f Tangent = DecodeOctahedral(Packed->Tangent);
+    Out->Tangent = shu::Vec4f(Tangent.x, Tangent.y, Tangent.z, (Packed->Color[3] >= 128) ? 1.0f : -1.0f);
+    Out->UV = shu::Vec2f(DecodeHalf(Packed->UV[0]), DecodeHalf(Packed->UV[1]));
+    Out->Color = shu::Vec3f(DecodeUnorm8(Packed->Color[0]), DecodeUnorm8(Packed->Color[1]),
+                            DecodeUnorm8(Packed->Color[2]));
+}
+
+static void
+PackVertexRange(const shoora_vertex_info *Vertices, u32 First, u32 Last, shoora_vertex_format Format,
+                const shoora_vertex_dequant &Dequant, void *Out)
+{
+    if(Format == VertexFormat_Compact)
+    {
+        shoora_vertex_info_compact *Packed = (shoora_vertex_info_compact *)Out;
+        for(u32 Index = First; Index < Last; ++Index)
+        {
+            Packed[Index].Pos = Vertices[Index].Pos;
+            PackVertexAttributes(Vertices + Index, Packed + Index);
+        }
+    }
+    else if(Format == VertexFormat_Quantized)
+    {
+        // NOTE: An axis the mesh is flat on has a zero scale, everything on it is at the offset.
+        shu::vec3f InvScale = shu::Vec3f((Dequant.Scale.x > 0.0f) ? 1.0f / Dequant.Scale.x : 0.0f,
+                                         (Dequant.Scale.y > 0.0f) ? 1.0f / Dequant.Scale.y : 0.0f,
+                                         (Dequant.Scale.z > 0.0f) ? 1.0f / Dequant.Scale.z : 0.0f);
+        shoora_vertex_info_quantized *Packed = (shoora_vertex_info_quantized *)Out;
+        for(u32 Index = First; Index < Last; ++Index)
+        {
+            shu::vec3f Pos = Vertices[Index].Pos - Dequant.Offset;
+            Packed[Index].Pos[0] = EncodeUnorm16(Pos.x*InvScale.x);
+            Packed[Index].Pos[1] = EncodeUnorm16(Pos.y*InvScale.y);
+            Packed[Index].Pos[2] = EncodeUnorm16(Pos.z*InvScale.z);
+            Packed[Index].Pos[3] = 0;
+            PackVertexAttributes(Vertices + Index, Packed + Index);
+        }
+    }
+    else
+    {
+        ASSERT(Format == VertexFormat_Full);
+        memcpy((shoora_vertex_info *)Out + First, Vertices + First, (Last - First)*sizeof(shoora_vertex_info));
+    }
+}
+
+void
+PackVertices(const shoora_vertex_info *Vertices, u32 VertexCount, shoora_vertex_format Format,
+             const shoora_vertex_dequant &Dequant, void *Out)
+{
+    JobSystem_ParallelFor((i32)VertexCount, VERTEX_PACKING_BATCH_SIZE,
+                          [Vertices, Format, &Dequant, Out](i32 First, i32 Last) {
+        PackVertexRange(Vertices, (u32)First, (u32)Last, Format, Dequant, Out);
+    });
+}
+
+shoora_vertex_info
+UnpackVertex(const void *Packed, u32 Index, shoora_vertex_format Format, const shoora_vertex_dequant &Dequant)
+{
+    shoora_vertex_info Result = {};
+    if(Format == VertexFormat_Compact)
+    {
+        const shoora_vertex_info_compact *Vertex = (const shoora_vertex_info_compact *)Packed + Index;
+        Result.Pos = Vertex->Pos;
+        UnpackVertexAttributes(Vertex, &Result);
+    }
+    else if(Format == VertexFormat_Quantized)
+    {
+        const shoora_vertex_info_quantized *Vertex = (const shoora_vertex_info_quantized *)Packed + Index;
+        shu::vec3f Unorm = shu::Vec3f((f32)Vertex->Pos[0] / 65535.0f, (f32)Vertex->Pos[1] / 65535.0f,
+                                      (f32)Vertex->Pos[2] / 65535.0f);
+        Result.Pos = shu::Vec3f(Dequant.Offset.x + Dequant.Scale.x*Unorm.x, Dequant.Offset.y + Dequant.Scale.y*Unorm.y,
+                                Dequant.Offset.z + Dequant.Scale.z*Unorm.z);
+        UnpackVertexAttributes(Vertex, &Result);
+    }
+    else
+    {
+        ASSERT(Format == VertexFormat_Full);
+        Result = ((const shoora_vertex_info *)Packed)[Index];
+    }
+
+    return Result;
+}
+
+void
+PackMeshFilter(shoora_mesh_filter *MeshFilter, shoora_vertex_format Format, void *Memory)
+{
+    MeshFilter->PackedFormat = Format;
+    MeshFilter->PositionDequant = GetPositionDequant(MeshFilter->Vertices, MeshFilter->VertexCount, Format);
+    MeshFilter->PackedVertices = nullptr;
+    if(Format != VertexFormat_Full)
+    {
+        ASSERT(Memory != nullptr);
+        PackVertices(MeshFilter->Vertices, MeshFilter->VertexCount, Format, MeshFilter->PositionDequant, Memory);
+        MeshFilter->PackedVertices = Memory;
+    }
+}
+
+void
+LogMeshMemory(const char *Name, const shoora_mesh_filter *MeshFilter)
+{
+    f32 FullKB = (f32)((u64)MeshFilter->VertexCount*sizeof(shoora_vertex_info)) / 1024.0f;
+    f32 PackedKB = (f32)((u64)MeshFilter->VertexCount*GetVertexFormatSize(MeshFilter->PackedFormat)) / 1024.0f;
+    f32 IndexKB = (f32)((u64)MeshFilter->IndexCount*sizeof(u32)) / 1024.0f;
+    LogInfo("Mesh %s: %u vertices(%s) %.2fKB, %.0f%% of %.2fKB full, %u indices %.2fKB.\n", Name,
+            MeshFilter->VertexCount, GetVertexFormatName(MeshFilter->PackedFormat), PackedKB,
+            (FullKB > 0.0f) ? 100.0f*PackedKB / FullKB : 100.0f, FullKB, MeshFilter->IndexCount, IndexKB);
+}
+
+#if _SHU_DEBUG
+static shu::vec3f
+RandomDirection(shoora_random &Random)
+{
+    shu::vec3f Result;
+    do
+    {
+        Result = shu::Vec3f(Random.Bilateral(), Random.Bilateral(), Random.Bilateral());
+    } while(Result.SqMagnitude() < 0.0001f || Result.SqMagnitude() > 1.0f);
+
+    Result.Normalize();
+    return Result;
+}
+
+static f32
+OctahedralError(const shu::vec3f &Direction)
+{
+    i16 Encoded[2];
+    EncodeOctahedral(Direction, Encoded);
+    shu::vec3f Decoded = DecodeOctahedral(Encoded);
+    f32 CosAngle = ClampToRange(shu::Dot(Direction, Decoded), -1.0f, 1.0f);
+    // NOTE: acos loses everything near 1, the cross product keeps the small angles.
+    f32 Result = atan2f(shu::Magnitude(shu::Cross(Direction, Decoded)), CosAngle);
+    return Result;
+}
+
+void
+VertexPackingTest()
+{
+    shoora_random Random(0x0c7a);
+
+    f32 MaxOctError = 0.0f;
+    shu::vec3f Axes[] = {shu::Vec3f(1, 0, 0), shu::Vec3f(-1, 0, 0), shu::Vec3f(0, 1, 0), shu::Vec3f(0, -1, 0),
+                         shu::Vec3f(0, 0, 1), shu::Vec3f(0, 0, -1), shu::Normalize(shu::Vec3f(1, 1, -1)),
+                         shu::Normalize(shu::Vec3f(-1, -1, -0.001f))};
+    for(u32 Index = 0; Index < ARRAY_SIZE(Axes); ++Index)
+    {
+        MaxOctError = MAX(MaxOctError, OctahedralError(Axes[Index]));
+    }
+    for(u32 Index = 0; Index < 100000; ++Index)
+    {
+        MaxOctError = MAX(MaxOctError, OctahedralError(RandomDirection(Random)));
+    }
+    ASSERT(MaxOctError <= SHOORA_OCTAHEDRAL_MAX_ERROR);
+    i16 Zero[2];
+    EncodeOctahedral(shu::Vec3f(0.0f), Zero);
+    ASSERT(DecodeOctahedral(Zero).z == 1.0f);
+
+    // NOTE: Every half goes to a float and back unchanged, apart from NaN payloads.
+    for(u32 Half = 0; Half <= 0xFFFF; ++Half)
+    {
+        u32 Exponent = (Half >> 10) & 0x1F;
+        if(Exponent != 0x1F || (Half & 0x3FF) == 0)
+        {
+            ASSERT(EncodeHalf(DecodeHalf((u16)Half)) == Half);
+        }
+    }
+    f32 MaxHalfError = 0.0f;
+    for(u32 Index = 0; Index < 100000; ++Index)
+    {
+        f32 Value = Random.Between(-64.0f, 64.0f);
+        f32 Error = fabsf(DecodeHalf(EncodeHalf(Value)) - Value);
+        ASSERT(Error <= fabsf(Value)*(1.0f / 2048.0f) + (1.0f / 16777216.0f));
+        MaxHalfError = MAX(MaxHalfError, (Value != 0.0f) ? Error / fabsf(Value) : 0.0f);
+    }
+    ASSERT(EncodeHalf(65519.0f) == 0x7BFF && EncodeHalf(65520.0f) == 0x7C00 && EncodeHalf(-1e9f) == 0xFC00);
+    ASSERT(EncodeHalf(1.0f + 1.0f / 2048.0f) == 0x3C00 && EncodeHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);
+
+    for(u32 Value = 0; Value < 256; ++Value)
+    {
+        ASSERT(EncodeUnorm8(DecodeUnorm8((u8)Value)) == Value);
+    }
+    for(u32 Index = 0; Index < 10000; ++Index)
+    {
+        f32 Value = Random.R01();
+        ASSERT(fabsf(DecodeUnorm8(EncodeUnorm8(Value)) - Value) <= 0.5f / 255.0f + 1e-6f);
+    }
+
+    // NOTE: A whole mesh through both formats.
+    const u32 VertexCount = 5000;
+    shoora_vertex_info *Vertices = (shoora_vertex_info *)malloc(VertexCount*sizeof(shoora_vertex_info));
+    u8 *Packed = (u8 *)malloc(VertexCount*sizeof(shoora_vertex_info_compact));
+    ASSERT(Vertices != nullptr && Packed != nullptr);
+    for(u32 Index = 0; Index < VertexCount; ++Index)
+    {
+        shoora_vertex_info *Vertex = Vertices + Index;
+        Vertex->Pos = shu::Vec3f(Random.Between(-20.0f, 30.0f), Random.Between(0.0f, 2.0f), 5.0f);
+        Vertex->Normal = RandomDirection(Random);
+        shu::vec3f Tangent = RandomDirection(Random);
+        Vertex->Tangent = shu::Vec4f(Tangent.x, Tangent.y, Tangent.z, (Index & 1) ? 1.0f : -1.0f);
+        Vertex->UV = shu::Vec2f(Random.Between(-2.0f, 2.0f), Random.R01());
+        Vertex->Color = shu::Vec3f(Random.R01(), Random.R01(), Random.R01());
+    }
+
+    f32 MaxPosError = 0.0f;
+    for(u32 Format = VertexFormat_Compact; Format < VertexFormat_Count; ++Format)
+    {
+        shoora_vertex_format VertexFormat = (shoora_vertex_format)Format;
+        shoora_vertex_dequant Dequant = GetPositionDequant(Vertices, VertexCount, VertexFormat);
+        PackVertices(Vertices, VertexCount, VertexFormat, Dequant, Packed);
+
+        // NOTE: Half a step of 16 bits over the bounds, plus the float rounding of the dequant.
+        shu::vec3f PosBound = Dequant.Scale*(0.5f / 65535.0f) + shu::Vec3f(1e-5f);
+        for(u32 Index = 0; Index < VertexCount; ++Index)
+        {
+            const shoora_vertex_info *Vertex = Vertices + Index;
+            shoora_vertex_info Unpacked = UnpackVertex(Packed, Index, VertexFormat, Dequant);
+            shu::vec3f PosError = Unpacked.Pos - Vertex->Pos;
+            ASSERT(fabsf(PosError.x) <= PosBound.x && fabsf(PosError.y) <= PosBound.y &&
+                   fabsf(PosError.z) <= PosBound.z);
+            MaxPosError = MAX(MaxPosError, MAX(fabsf(PosError.x), MAX(fabsf(PosError.y), fabsf(PosError.z))));
+            ASSERT(shu::Dot(Unpacked.Normal, Vertex->Normal) >= cosf(SHOORA_OCTAHEDRAL_MAX_ERROR) - 1e-6f);
+            ASSERT(Unpacked.Tangent.w == Vertex->Tangent.w);
+            ASSERT(fabsf(Unpacked.UV.x - Vertex->UV.x) <= fabsf(Vertex->UV.x)*(1.0f / 2048.0f) + 1e-7f);
+            ASSERT(fabsf(Unpacked.Color.y - Vertex->Color.y) <= 0.5f / 255.0f + 1e-6f);
+        }
+        if(VertexFormat == VertexFormat_Compact)
+        {
+            ASSERT(MaxPosError == 0.0f);
+        }
+    }
+    free(Vertices);
+    free(Packed);
+
+    LogInfo("[Vertex Packing Test]: Passed. Octahedral %.3g rad, half %.3g relative, position %.3g.\n", MaxOctError,
+            MaxHalfError, MaxPosError);
+}
+#endif
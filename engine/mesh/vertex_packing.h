@@ -0,0 +1,45 @@
+#if !defined(VERTEX_PACKING_H)
+
+#include <defines.h>
+#include "mesh_filter.h"
+
+// NOTE: Packs the full shoora_vertex_info vertices into the compact GPU formats(shoora_vertex_format) and back.
+//     Normal, Tangent: octahedral, two snorm16. The decoded direction is within SHOORA_OCTAHEDRAL_MAX_ERROR radians.
+//     UV: half floats, within half a unit in the last place(2^-11 relative) in the normal range.
+//     Color: unorm8, within 0.5/255.
+//     Pos(Quantized only): unorm16 inside the mesh bounds, within Scale/(2*65535) on each axis.
+#define SHOORA_OCTAHEDRAL_MAX_ERROR 0.0001f
+
+u32 GetVertexFormatSize(shoora_vertex_format Format);
+const char *GetVertexFormatName(shoora_vertex_format Format);
+
+void EncodeOctahedral(const shu::vec3f &Direction, i16 *Out);
+shu::vec3f DecodeOctahedral(const i16 *Encoded);
+u16 EncodeHalf(f32 Value);
+f32 DecodeHalf(u16 Half);
+u8 EncodeUnorm8(f32 Value);
+f32 DecodeUnorm8(u8 Value);
+
+// NOTE: The bounds of the positions as a dequant transform. For VertexFormat_Full and VertexFormat_Compact it is the
+// identity.
+shoora_vertex_dequant GetPositionDequant(const shoora_vertex_info *Vertices, u32 VertexCount,
+                                         shoora_vertex_format Format);
+// NOTE: Out has room for VertexCount vertices of GetVertexFormatSize(Format) bytes. Runs on the job system.
+void PackVertices(const shoora_vertex_info *Vertices, u32 VertexCount, shoora_vertex_format Format,
+                  const shoora_vertex_dequant &Dequant, void *Out);
+shoora_vertex_info UnpackVertex(const void *Packed, u32 Index, shoora_vertex_format Format,
+                                const shoora_vertex_dequant &Dequant);
+
+// NOTE: Fills the mesh filter's PackedFormat, PositionDequant and PackedVertices. Memory has room for the packed
+// vertices, it is not used for VertexFormat_Full.
+void PackMeshFilter(shoora_mesh_filter *MeshFilter, shoora_vertex_format Format, void *Memory);
+// NOTE: What the mesh takes on the GPU in its packed format against the full one.
+void LogMeshMemory(const char *Name, const shoora_mesh_filter *MeshFilter);
+
+#if _SHU_DEBUG
+// NOTE: Checks the encode/decode error bounds above over random and edge case inputs.
+void VertexPackingTest();
+#endif
+
+#define VERTEX_PACKING_H
+#endif // VERTEX_PACKING_H
@@ -10,6 +10,8 @@ shoora_body::shoora_body(const shu::vec3f &Color, const shu::vec3f &InitPos, f32
     this->Color = Color;
     this->Position = InitPos;
     this->Rotation = shu::QuatFromEuler(eulerAngles.x, eulerAngles.y, eulerAngles.z);
+    this->PreviousPosition = this->Position;
+    this->PreviousRotation = this->Rotation;
 
     this->FrictionCoeff = 0.7f;
 
@@ -35,6 +37,7 @@ shoora_body::shoora_body(shoora_body &&other) noexcept
     : IsColliding(other.IsColliding), Position(std::move(other.Position)),
       LinearVelocity(std::move(other.LinearVelocity)), AngularVelocity(std::move(other.AngularVelocity)),
       Acceleration(std::move(other.Acceleration)), Rotation(std::move(other.Rotation)),
+      PreviousPosition(other.PreviousPosition), PreviousRotation(other.PreviousRotation),
       CoeffRestitution(other.CoeffRestitution), SumForces(std::move(other.SumForces)),
       SumTorques(other.SumTorques), FrictionCoeff(other.FrictionCoeff), Mass(other.Mass), InvMass(other.InvMass),
       InertiaTensor(other.InertiaTensor), InverseInertiaTensor(other.InverseInertiaTensor),
@@ -55,6 +58,8 @@ shoora_body::operator=(shoora_body &&other) noexcept
         AngularVelocity = std::move(other.AngularVelocity);
         Acceleration = std::move(other.Acceleration);
         Rotation = std::move(other.Rotation);
+        PreviousPosition = other.PreviousPosition;
+        PreviousRotation = other.PreviousRotation;
         CoeffRestitution = other.CoeffRestitution;
         SumForces = std::move(other.SumForces);
         SumTorques = other.SumTorques;
@@ -259,6 +264,13 @@ shoora_body::ClearTorques()
     this->SumTorques = 0.0f;
 }
 
+void
+shoora_body::GetInterpolatedTransform(f32 Alpha, shu::vec3f &OutPosition, shu::quat &OutRotation) const
+{
+    OutPosition = this->PreviousPosition + (this->Position - this->PreviousPosition) * Alpha;
+    OutRotation = shu::QuatSlerp(this->PreviousRotation, this->Rotation, Alpha);
+}
+
 void
 shoora_body::IntegrateForces(const f32 deltaTime)
 {
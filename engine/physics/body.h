@@ -5,6 +5,12 @@
 #include <mesh/primitive/geometry_primitive.h>
 #include <mesh/mesh_filter.h>
 #include <physics/shape/shape.h>
+#include <containers/slot_map.h>
+
+// NOTE: Bodies live in the scene's slot map and move in memory when bodies are added or removed. Anything that holds
+// on to a body across steps(manifolds, constraints) keeps its handle and looks the pointer up at the start of the
+// step.
+typedef slot_handle body_handle;
 
 struct shoora_body
 {
@@ -14,6 +20,10 @@ struct shoora_body
     shu::vec3f Position;
     shu::quat Rotation;
 
+    // NOTE: Transform at the start of the last fixed step. Only used to interpolate the transform for rendering.
+    shu::vec3f PreviousPosition;
+    shu::quat PreviousRotation;
+
     shu::vec3f LinearVelocity;
     shu::vec3f Acceleration;
 
@@ -79,6 +89,9 @@ struct shoora_body
     void ClearForces();
     void ClearTorques();
 
+    // NOTE: Lerps/Slerps between the previous and the current transform. Alpha is in [0, 1].
+    void GetInterpolatedTransform(f32 Alpha, shu::vec3f &OutPosition, shu::quat &OutRotation) const;
+
     void IntegrateForces(const f32 deltaTime);
     void Update(const f32 deltaTime);
 };
@@ -0,0 +1,133 @@
+#include "body_transforms.h"
+#include <memory/memory.h>
+
+// NOTE: How the local bounds of a shape turn into its world bounds. Kept as f32 so that they load into the lanes.
+#define BOUNDS_KIND_ROTATES 0.0f
+// NOTE: Spheres, the bounds only move with the body.
+#define BOUNDS_KIND_FIXED 1.0f
+// NOTE: The shape has no bounds(the 2D shapes), the world bounds stay cleared.
+#define BOUNDS_KIND_EMPTY 2.0f
+
+void
+body_transforms::Reserve(i32 BodyCount)
+{
+    if(BodyCount <= this->Capacity)
+        return;
+
+    this->Free();
+    this->Capacity = BodyCount + BodyCount / 2;
+
+    // NOTE: One block for all of the arrays, the ones with the biggest alignment go first.
+    const i32 Cap = this->Capacity;
+    size_t Size = Cap*(sizeof(shoora_shape *) + sizeof(shoora_bounds) + 2*sizeof(shu::vec3f) + sizeof(f32));
+    freelist_allocator *Allocator = GetFreelistAllocator(MEMTYPE_FREELISTGLOBAL);
+    u8 *Memory = (u8 *)Allocator->Allocate(Size);
+    ASSERT(Memory != nullptr);
+
+    this->Shapes = (const shoora_shape **)Memory;
+    Memory += Cap*sizeof(shoora_shape *);
+    this->WorldBounds = (shoora_bounds *)Memory;
+    Memory += Cap*sizeof(shoora_bounds);
+    this->LocalCenters = (shu::vec3f *)Memory;
+    Memory += Cap*sizeof(shu::vec3f);
+    this->LocalExtents = (shu::vec3f *)Memory;
+    Memory += Cap*sizeof(shu::vec3f);
+    this->BoundsKinds = (f32 *)Memory;
+
+    memset(this->Shapes, 0, Cap*sizeof(shoora_shape *));
+}
+
+void
+body_transforms::Free()
+{
+    if(this->Shapes != nullptr)
+    {
+        freelist_allocator *Allocator = GetFreelistAllocator(MEMTYPE_FREELISTGLOBAL);
+        Allocator->Free(this->Shapes);
+    }
+
+    *this = body_transforms{};
+}
+
+void
+body_transforms::Update(const shoora_body *Bodies, i32 BodyCount)
+{
+    this->Reserve(BodyCount);
+    this->Count = BodyCount;
+
+    for(i32 i = 0; i < BodyCount; ++i)
+    {
+        const shoora_shape *Shape = Bodies[i].Shape;
+        if(this->Shapes[i] == Shape)
+            continue;
+
+        this->Shapes[i] = Shape;
+        shoora_bounds Local = Shape->GetBounds();
+        this->LocalCenters[i] = (Local.Mins + Local.Maxs) * 0.5f;
+        this->LocalExtents[i] = (Local.Maxs - Local.Mins) * 0.5f;
+        if(Local.Mins.x > Local.Maxs.x)
+        {
+            this->BoundsKinds[i] = BOUNDS_KIND_EMPTY;
+            this->LocalCenters[i] = this->LocalExtents[i] = shu::Vec3f(0.0f);
+        }
+        else
+        {
+            this->BoundsKinds[i] = (Shape->GetType() == shoora_mesh_type::SPHERE) ? BOUNDS_KIND_FIXED
+                                                                                   : BOUNDS_KIND_ROTATES;
+        }
+    }
+
+    for(i32 First = 0; First < BodyCount; First += 8)
+    {
+        const i32 LaneCount = MIN(8, BodyCount - First);
+
+        shu::vec3f Positions[8];
+        shu::quat Rotations[8];
+        f32 Kinds[8];
+        for(i32 i = 0; i < 8; ++i)
+        {
+            const shoora_body &Body = Bodies[First + ((i < LaneCount) ? i : 0)];
+            Positions[i] = Body.Position;
+            Rotations[i] = Body.Rotation;
+            Kinds[i] = this->BoundsKinds[First + ((i < LaneCount) ? i : 0)];
+        }
+
+        const shu::vec3x8 Position = shu::LoadVec3<shu::f32x8>(Positions, LaneCount);
+        const shu::quatx8 Rotation = shu::QuatNormalize(shu::LoadQuat<shu::f32x8>(Rotations, LaneCount));
+
+        // NOTE: The rows of the inverse rotation are the columns of the rotation. So the rotated local center is
+        // Row0*c.x + Row1*c.y + Row2*c.z, and the extents of the rotated box are the same with the rows made positive.
+        shu::vec3x8 Row0, Row1, Row2;
+        shu::QuatToMat3Rows(Rotation, Row0, Row1, Row2);
+
+        const shu::vec3x8 Center = shu::LoadVec3<shu::f32x8>(this->LocalCenters + First, LaneCount);
+        const shu::vec3x8 Extents = shu::LoadVec3<shu::f32x8>(this->LocalExtents + First, LaneCount);
+        const shu::f32x8 Kind = shu::LoadF32x8(Kinds);
+        const shu::f32x8 Rotates = Kind < shu::F32x8(0.5f);
+
+        shu::vec3x8 WorldCenter = Row0*Center.x + Row1*Center.y + Row2*Center.z;
+        WorldCenter = shu::Select(Rotates, WorldCenter, Center) + Position;
+        shu::vec3x8 AbsRow0 = {shu::Abs(Row0.x), shu::Abs(Row0.y), shu::Abs(Row0.z)};
+        shu::vec3x8 AbsRow1 = {shu::Abs(Row1.x), shu::Abs(Row1.y), shu::Abs(Row1.z)};
+        shu::vec3x8 AbsRow2 = {shu::Abs(Row2.x), shu::Abs(Row2.y), shu::Abs(Row2.z)};
+        shu::vec3x8 WorldExtents = AbsRow0*Extents.x + AbsRow1*Extents.y + AbsRow2*Extents.z;
+        WorldExtents = shu::Select(Rotates, WorldExtents, Extents);
+
+        shu::vec3f Mins[8], Maxs[8];
+        shu::StoreVec3(Mins, WorldCenter - WorldExtents, LaneCount);
+        shu::StoreVec3(Maxs, WorldCenter + WorldExtents, LaneCount);
+
+        for(i32 i = 0; i < LaneCount; ++i)
+        {
+            const i32 Index = First + i;
+            if(this->BoundsKinds[Index] == BOUNDS_KIND_EMPTY)
+            {
+                this->WorldBounds[Index] = shoora_bounds{};
+            }
+            else
+            {
+                this->WorldBounds[Index] = shoora_bounds{Mins[i], Maxs[i]};
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#if !defined(BODY_TRANSFORMS_H)
+
+#include <defines.h>
+#include <math/math.h>
+#include "body.h"
+#include "bounds.h"
+
+// NOTE: The world bounds of all the bodies, worked out in one pass(8 bodies at a time) into a plain array indexed by
+// the body index. The broadphase, the scene queries and the debug drawing read these instead of calling the shape's
+// virtual GetBounds for every body, every time. The bodies are drawn with their interpolated transforms, so there
+// are no world matrices in here.
+// Update() has to be called again after the bodies move, the scene does that at the end of every physics step.
+struct body_transforms
+{
+    void Update(const shoora_body *Bodies, i32 BodyCount);
+    void Free();
+
+    // NOTE: Same as Shape->GetBounds(Position, Rotation).
+    shoora_bounds *WorldBounds = nullptr;
+    i32 Count = 0;
+
+  private:
+    void Reserve(i32 BodyCount);
+
+    i32 Capacity = 0;
+
+    // NOTE: The local bounds of the shapes as a center and half extents. They only get read again from the shape when
+    // the body at that index has a different shape.
+    const shoora_shape **Shapes = nullptr;
+    shu::vec3f *LocalCenters = nullptr;
+    shu::vec3f *LocalExtents = nullptr;
+    f32 *BoundsKinds = nullptr;
+};
+
+#define BODY_TRANSFORMS_H
+#endif // BODY_TRANSFORMS_H
@@ -34,10 +34,13 @@ shoora_bounds::DoesIntersect(const shoora_bounds &other) const
 void
 shoora_bounds::Expand(const shu::vec3f *Pts, const i32 Num)
 {
-    for(i32 i = 0; i < Num; ++i)
-    {
-        this->Expand(Pts[i]);
-    }
+    if(Num <= 0)
+        return;
+
+    shu::vec3f PtsMins, PtsMaxs;
+    shu::MinMaxPoints(Pts, Num, PtsMins, PtsMaxs);
+    this->Expand(PtsMins);
+    this->Expand(PtsMaxs);
 }
 
 void
@@ -59,6 +62,28 @@ shoora_bounds::Expand(const shoora_bounds &Bounds)
     this->Expand(Bounds.Maxs);
 }
 
+shoora_bounds
+shoora_bounds::Transformed(const shu::vec3f &Pos, const shu::quat &Orientation) const
+{
+    // NOTE: All 8 corners go through the rotation at once, one corner per lane. Lane i takes Maxs on the axes whose
+    // bit is set in i.
+    static const f32 UseMaxX[8] = {0, 1, 0, 1, 0, 1, 0, 1};
+    static const f32 UseMaxY[8] = {0, 0, 1, 1, 0, 0, 1, 1};
+    static const f32 UseMaxZ[8] = {0, 0, 0, 0, 1, 1, 1, 1};
+    const shu::f32x8 Half = shu::F32x8(0.5f);
+
+    shu::vec3x8 Corners;
+    Corners.x = shu::Select(shu::LoadF32x8(UseMaxX) > Half, shu::F32x8(this->Maxs.x), shu::F32x8(this->Mins.x));
+    Corners.y = shu::Select(shu::LoadF32x8(UseMaxY) > Half, shu::F32x8(this->Maxs.y), shu::F32x8(this->Mins.y));
+    Corners.z = shu::Select(shu::LoadF32x8(UseMaxZ) > Half, shu::F32x8(this->Maxs.z), shu::F32x8(this->Mins.z));
+
+    Corners = shu::QuatRotateVec(shu::SplatQuat<shu::f32x8>(Orientation), Corners);
+    Corners = Corners + shu::SplatVec3<shu::f32x8>(Pos);
+
+    shoora_bounds Result{shu::ReduceMin(Corners), shu::ReduceMax(Corners)};
+    return Result;
+}
+
 void
 shoora_bounds::Draw()
 {
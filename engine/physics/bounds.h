@@ -16,6 +16,8 @@ struct shoora_bounds
     void Expand(const shu::vec3f *Pts, const i32 Num);
     void Expand(const shu::vec3f &V);
     void Expand(const shoora_bounds &Bounds);
+    // NOTE: The bounds of these bounds after rotating them by Orientation and moving them to Pos.
+    shoora_bounds Transformed(const shu::vec3f &Pos, const shu::quat &Orientation) const;
 
     f32 WidthX() const { f32 Result = Maxs.x - Mins.x; return Result; }
     f32 WidthY() const { f32 Result = Maxs.y - Mins.y; return Result; }
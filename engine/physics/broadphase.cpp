@@ -1,20 +1,15 @@
 #include "broadphase.h"
 #include <math/math.h>
+#include <memory/memory.h>
 #include <utils/sort/sort.h>
 
-b32
-ComparePseudoBodies(const pseudo_body &A, const pseudo_body &B)
-{
-    b32 Result = (A.Value <= B.Value);
-    return Result;
-}
-
 // NOTE: Sort the bodies based on their bounds along a given axis.
 // WE can't for example, choose the z-axis since that will not be of any use. every rigidbody in the same zPos, not
 // colliding, will still be considered as colliding, and we will get the worst case and not limit the number of
 // collisions in the broadphase which defeats the purpose of doing broadphase collision detection.
 void
-SortBodiesBounds(const shoora_body *Bodies, const i32 BodyCount, pseudo_body *SortedArray, const f32 DeltaTime)
+SortBodiesBounds(const shoora_body *Bodies, const shoora_bounds *WorldBounds, const i32 BodyCount,
+                 pseudo_body *SortedArray, const f32 DeltaTime, shoora_bounds *SweptBounds)
 {
     shu::vec3f Axis = shu::Vec3f(1, 1, 1);
     Axis.Normalize();
@@ -22,7 +17,7 @@ SortBodiesBounds(const shoora_body *Bodies, const i32 BodyCount, pseudo_body *So
     for (i32 i = 0; i < BodyCount; ++i)
     {
         const shoora_body &Body = Bodies[i];
-        shoora_bounds Bounds = Body.Shape->GetBounds(Body.Position, Body.Rotation);
+        shoora_bounds Bounds = WorldBounds[i];
 
         // Expand the bounds by the body's Linear Velocity otherwise the work on continuous collision detection
         // will be of no use.
@@ -37,6 +32,10 @@ SortBodiesBounds(const shoora_body *Bodies, const i32 BodyCount, pseudo_body *So
         f32 Epsilon = 0.01f;
         Bounds.Expand(Bounds.Mins - Axis*Epsilon);
         Bounds.Expand(Bounds.Mins + Axis*Epsilon);
+        if(SweptBounds != nullptr)
+        {
+            SweptBounds[i] = Bounds;
+        }
 
         SortedArray[i*2 + 0].Id = i;
         SortedArray[i*2 + 0].Value = Axis.Dot(Bounds.Mins);
@@ -47,7 +46,11 @@ SortBodiesBounds(const shoora_body *Bodies, const i32 BodyCount, pseudo_body *So
         SortedArray[i*2 + 1].IsMin = false;
     }
 
-    QuicksortRecursive(SortedArray, 0, BodyCount*2, ComparePseudoBodies);
+    // NOTE: Radix sort is stable, so bodies with the same bound keep their order whether or not the sort has to be
+    // deterministic. The endpoints come out almost sorted every frame, which used to be the worst case for quicksort.
+    pseudo_body *Scratch = (pseudo_body *)_alloca(sizeof(pseudo_body) * BodyCount * 2);
+    RadixSort(SortedArray, Scratch, BodyCount*2,
+              [](const pseudo_body &Item) { return FloatToSortableU32(Item.Value); });
 }
 
 void
@@ -78,30 +81,45 @@ BuildPairs(collision_pair *CollisionPairs, i32 &PairCount, const pseudo_body *So
             if (!B.IsMin) { continue; }
 
             Pair.B = B.Id;
+            if(Pair.A > Pair.B) { SWAP(Pair.A, Pair.B); }
             CollisionPairs[PairCount++] = (Pair);
+            Pair.A = A.Id;
         }
     }
 }
 
 void
-SweepAndPrune1D(const shoora_body *Bodies, const i32 BodyCount, collision_pair *FinalPairs, i32 &PairCount,
-                const f32 DeltaTime)
+SweepAndPrune1D(const shoora_body *Bodies, const shoora_bounds *WorldBounds, const i32 BodyCount,
+                collision_pair *FinalPairs, i32 &PairCount, const f32 DeltaTime, b32 Deterministic,
+                shoora_bounds *SweptBounds)
 {
     pseudo_body *SortedPseudoBodies = (pseudo_body *)_alloca(sizeof(pseudo_body) * BodyCount * 2);
 
-    SortBodiesBounds(Bodies, BodyCount, SortedPseudoBodies, DeltaTime);
+    SortBodiesBounds(Bodies, WorldBounds, BodyCount, SortedPseudoBodies, DeltaTime, SweptBounds);
 
     // SortedArray of Pseudobodies is twice the number of bodies passed in here. Since, you have two entries for
     // each body. One is the dot product of its Bounds.Min with Axis, the other is the dot product of its
     // Bounds.Max with chosen Axis.
     i32 SortedPseudoBodyCount = BodyCount * 2;
+    i32 FirstPair = PairCount;
     BuildPairs(FinalPairs, PairCount, SortedPseudoBodies, SortedPseudoBodyCount);
+
+    if(Deterministic)
+    {
+        i32 NewPairCount = PairCount - FirstPair;
+        // NOTE: The pair count can get close to BodyCount^2, so not using the stack for this one.
+        collision_pair *Scratch = ShuAllocateArray(collision_pair, MAX(NewPairCount, 1), MEMTYPE_THREADFRAME);
+        // NOTE: The ids are indices, so (A, B) packed into a u64 sorts the same as comparing A and then B.
+        RadixSort(FinalPairs + FirstPair, Scratch, NewPairCount,
+                  [](const collision_pair &Pair) { return ((u64)(u32)Pair.A << 32) | (u64)(u32)Pair.B; });
+    }
 }
 
 void
-broad_phase::BroadPhase(const shoora_body *Bodies, const i32 BodyCount,
-                        collision_pair *FinalPairs, i32 &PairCount, const f32 deltaTime)
+broad_phase::BroadPhase(const shoora_body *Bodies, const shoora_bounds *WorldBounds, const i32 BodyCount,
+                        collision_pair *FinalPairs, i32 &PairCount, const f32 deltaTime, b32 Deterministic,
+                        shoora_bounds *SweptBounds)
 {
     // FinalPairs.Clear();
-    SweepAndPrune1D(Bodies, BodyCount, FinalPairs, PairCount, deltaTime);
+    SweepAndPrune1D(Bodies, WorldBounds, BodyCount, FinalPairs, PairCount, deltaTime, Deterministic, SweptBounds);
 }
@@ -34,8 +34,13 @@ struct collision_pair
 struct broad_phase
 {
     broad_phase() = delete;
-    static void BroadPhase(const shoora_body *Bodies, const i32 BodyCount, collision_pair *FinalPairs,
-                           i32 &PairCount, const f32 deltaTime);
+    // NOTE: With Deterministic set, the pairs are returned with A < B sorted by (A, B). So the pair list only depends
+    // on which bodies overlap, not on the sort.
+    // WorldBounds are the bounds of the bodies where they are now(body_transforms::WorldBounds). If SweptBounds is
+    // passed in, it gets those bounds grown by how far the bodies move in deltaTime, which the pairs were built from.
+    static void BroadPhase(const shoora_body *Bodies, const shoora_bounds *WorldBounds, const i32 BodyCount,
+                           collision_pair *FinalPairs, i32 &PairCount, const f32 deltaTime,
+                           b32 Deterministic = false, shoora_bounds *SweptBounds = nullptr);
 };
 
 #define BROADPHASE_H
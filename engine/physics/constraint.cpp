@@ -34,6 +34,18 @@ constraint_3d::GetInverseMassMatrix() const
     return InverseMassMatrix;
 }
 
+shu::inverse_mass_12
+constraint_3d::GetInverseMass() const
+{
+    shu::inverse_mass_12 Result;
+    Result.InvMassA = A->InvMass;
+    Result.InvInertiaA = A->GetInverseInertiaTensorWS();
+    Result.InvMassB = B->InvMass;
+    Result.InvInertiaB = B->GetInverseInertiaTensorWS();
+
+    return Result;
+}
+
 shu::vecN<f32, 12>
 constraint_3d::GetVelocities() const
 {
@@ -56,6 +68,17 @@ constraint_3d::GetVelocities() const
     return Velocities;
 }
 
+void
+constraint_3d::ScaleCachedLambdas(f32 Factor)
+{
+    f32 *Lambdas = this->GetCachedLambdas();
+    i32 Count = this->GetCachedLambdaCount();
+    for(i32 i = 0; i < Count; ++i)
+    {
+        Lambdas[i] *= Factor;
+    }
+}
+
 void
 constraint_3d::ApplyImpulses(const shu::vecN<f32, 12> &Impulses)
 {
@@ -20,8 +20,17 @@ struct constraint_3d
     constraint_3d() = default;
     virtual ~constraint_3d() = default;
 
+    // NOTE: The lambdas cached for warm starting. Used to save/restore the solver state in the scene snapshots.
+    virtual i32 GetCachedLambdaCount() const { return 0; }
+    virtual f32 *GetCachedLambdas() { return nullptr; }
+    // NOTE: Damps the cached lambdas by the scene's WarmStartFactor. Called once per step before the substeps, so the
+    // factor means the same thing whatever the substep count is.
+    void ScaleCachedLambdas(f32 Factor);
+
   protected:
     shu::matN<f32, 12> GetInverseMassMatrix() const;
+    // NOTE: Only the blocks of the inverse mass matrix, for the shu::JMJt kernel.
+    shu::inverse_mass_12 GetInverseMass() const;
     shu::vecN<f32, 12> GetVelocities() const;
 
     void ApplyImpulses(const shu::vecN<f32, 12> &Impulses);
@@ -35,11 +44,20 @@ struct constraint_3d
     // bodies.
     shu::vec3f AnchorPointLS_A; // The anchor point in A's Local Space
     shu::vec3f AnchorPointLS_B; // The anchor point in B's Local Space
+    // NOTE: Set HandleA and HandleB before adding the constraint to the scene. A and B are where those bodies are
+    // during the current step, the scene looks them up before every step.
+    body_handle HandleA;
+    body_handle HandleB;
     shoora_body *A;
     shoora_body *B;
 
     shu::vec3f AxisLS_A; // The axis of the the anchor point in A.
     shu::vec3f AxisLS_B; // The axis of the the anchor point in B.
+
+    // NOTE: Set by the scene every substep from its physics_settings.
+    // BiasFactor scales the Baumgarte term in Solve. It is zero during the relaxation iterations so that the
+    // position correction velocity does not stay in the bodies after the positions have been integrated.
+    f32 BiasFactor = 1.0f;
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////////
@@ -58,6 +76,8 @@ struct joint_constraint_3d : public constraint_3d
     void PreSolve(const f32 dt) override;
     void Solve() override;
     void PostSolve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambda.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambda.Data; }
 
   private:
     shu::matMN<f32, 1, 12> Jacobian;
@@ -86,6 +106,8 @@ struct fixed_constraint_3d : public constraint_3d
     void PreSolve(const f32 dt) override;
     void Solve() override;
     void PostSolve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambda.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambda.Data; }
 
   private:
     shu::matMN<f32, 6, 12> Jacobian;
@@ -114,6 +136,8 @@ struct ball_constraint_3d : public constraint_3d
     void PreSolve(const f32 dt) override;
     void Solve() override;
     void PostSolve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambda.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambda.Data; }
 
   private:
     shu::matMN<f32, 3, 12> Jacobian;
@@ -142,6 +166,8 @@ struct hinge_constraint_3d : public constraint_3d
     void PreSolve(const f32 dt) override;
     void Solve() override;
     void PostSolve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambda.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambda.Data; }
 
     // NOTE: q1_inv * q2 inital.
     // shu::quat q0;
@@ -174,6 +200,8 @@ struct hinge_quat_constraint_3d : public constraint_3d
     void PreSolve(const f32 dt) override;
     void Solve() override;
     void PostSolve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambda.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambda.Data; }
 
   private:
     shu::matMN<f32, 5, 12> Jacobian;
@@ -210,6 +238,8 @@ struct cone_twist_constraint : public constraint_3d
     void PreSolve(const f32 dt) override;
     void Solve() override;
     void PostSolve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambda.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambda.Data; }
 
   private:
     shu::matMN<f32, 5, 12> Jacobian;
@@ -239,6 +269,8 @@ struct slider_constraint_3d : public constraint_3d
     void PreSolve(const f32 dt) override;
     void Solve() override;
     void PostSolve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambda.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambda.Data; }
 
   private:
     shu::matMN<f32, 5, 12> Jacobian;
@@ -269,6 +301,8 @@ struct slider_constraint_limit_3d : public constraint_3d
     void PreSolve(const f32 dt) override;
     void Solve() override;
     void PostSolve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambda.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambda.Data; }
 
     shu::vec3f sliderAxisLS_A;
     f32 MinLimit, MaxLimit;
@@ -304,6 +338,8 @@ struct penetration_constraint_3d : public constraint_3d
 
     void PreSolve(const f32 dt) override;
     void Solve() override;
+    i32 GetCachedLambdaCount() const override { return ARRAY_SIZE(this->PreviousFrameLambdas.Data); }
+    f32 *GetCachedLambdas() override { return this->PreviousFrameLambdas.Data; }
 
     shu::vec3f Normal_LocalSpaceA;
     shu::matMN<f32, 3, 12> Jacobian;
@@ -317,6 +353,9 @@ struct penetration_constraint_3d : public constraint_3d
 
 struct constraint_2d
 {
+    // NOTE: Same as constraint_3d, A and B are looked up from the handles by the scene.
+    body_handle HandleA;
+    body_handle HandleB;
     shoora_body *A;
     shoora_body *B;
 
@@ -145,23 +145,24 @@ cone_twist_constraint::PreSolve(const f32 dt)
 void
 cone_twist_constraint::Solve()
 {
-    shu::matMN<f32, 12, 5> JacobianTranspose = this->Jacobian.Transposed();
-    shu::vecN<f32, 12>     V                 = GetVelocities();
-    shu::matN<f32, 12>     InvM              = GetInverseMassMatrix();
-
-    auto J_invM_Jt = this->Jacobian * InvM * JacobianTranspose;
-    auto Rhs = this->Jacobian * V * -1.0f;
-    Rhs[0] += this->TransBaumgarte.x;
-    Rhs[1] += this->TransBaumgarte.y;
-    Rhs[2] += this->TransBaumgarte.z;
-    Rhs[3] += this->RotBaumgarte.x;
-    Rhs[4] += this->RotBaumgarte.y;
-
-    auto LagrangeLambda = shu::LCP_GaussSeidel(J_invM_Jt, Rhs);
+    shu::vecN<f32, 12>   V    = GetVelocities();
+    shu::inverse_mass_12 InvM = GetInverseMass();
+
+    auto J_invM_Jt = shu::JMJt(this->Jacobian, InvM);
+    auto Rhs = shu::JMul(this->Jacobian, V) * -1.0f;
+    Rhs[0] += this->BiasFactor * this->TransBaumgarte.x;
+    Rhs[1] += this->BiasFactor * this->TransBaumgarte.y;
+    Rhs[2] += this->BiasFactor * this->TransBaumgarte.z;
+    Rhs[3] += this->BiasFactor * this->RotBaumgarte.x;
+    Rhs[4] += this->BiasFactor * this->RotBaumgarte.y;
+
+    shu::LDLtFactor(J_invM_Jt);
+    shu::LDLtSolve(J_invM_Jt, Rhs);
+    auto LagrangeLambda = Rhs;
     // if(LagrangeLambda[3] < 0)
     //     LagrangeLambda[3] *= -1.0f;
 
-    auto Impulses       = JacobianTranspose * LagrangeLambda;
+    auto Impulses       = shu::JtMul(this->Jacobian, LagrangeLambda);
     this->ApplyImpulses(Impulses);
 
 #if WARM_STARTING
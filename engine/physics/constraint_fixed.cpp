@@ -119,23 +119,23 @@ fixed_constraint_3d::PreSolve(const f32 dt)
 void
 fixed_constraint_3d::Solve()
 {
-    shu::matMN<f32, 12, 6> JacobianTranspose = this->Jacobian.Transposed();
-
     auto V = GetVelocities();
-    auto InvM = GetInverseMassMatrix();
-
-    auto J_invM_Jt = this->Jacobian * InvM * JacobianTranspose;
-    auto Rhs = this->Jacobian * V * -1.0f;
-    Rhs[0] += this->TransBaumgarte.x;
-    Rhs[1] += this->TransBaumgarte.y;
-    Rhs[2] += this->TransBaumgarte.z;
-    Rhs[3] += this->RotBaumgarte.x;
-    Rhs[4] += this->RotBaumgarte.y;
-    Rhs[5] += this->RotBaumgarte.z;
-
-    auto LagrangeLambda = shu::LCP_GaussSeidel(J_invM_Jt, Rhs);
-
-    auto Impulses = JacobianTranspose * LagrangeLambda;
+    auto InvM = GetInverseMass();
+
+    auto J_invM_Jt = shu::JMJt(this->Jacobian, InvM);
+    auto Rhs = shu::JMul(this->Jacobian, V) * -1.0f;
+    Rhs[0] += this->BiasFactor * this->TransBaumgarte.x;
+    Rhs[1] += this->BiasFactor * this->TransBaumgarte.y;
+    Rhs[2] += this->BiasFactor * this->TransBaumgarte.z;
+    Rhs[3] += this->BiasFactor * this->RotBaumgarte.x;
+    Rhs[4] += this->BiasFactor * this->RotBaumgarte.y;
+    Rhs[5] += this->BiasFactor * this->RotBaumgarte.z;
+
+    shu::LDLtFactor(J_invM_Jt);
+    shu::LDLtSolve(J_invM_Jt, Rhs);
+    auto LagrangeLambda = Rhs;
+
+    auto Impulses = shu::JtMul(this->Jacobian, LagrangeLambda);
     this->ApplyImpulses(Impulses);
 
 #if WARM_STARTING
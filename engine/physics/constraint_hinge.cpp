@@ -118,22 +118,22 @@ hinge_constraint_3d::PreSolve(const f32 dt)
 void
 hinge_constraint_3d::Solve()
 {
-    shu::matMN<f32, 12, 5> JacobianTranspose = this->Jacobian.Transposed();
-
     shu::vecN<f32, 12> V = GetVelocities();
-    shu::matN<f32, 12> InvM = GetInverseMassMatrix();
+    shu::inverse_mass_12 InvM = GetInverseMass();
 
-    auto J_invM_Jt = this->Jacobian * InvM * JacobianTranspose;
-    auto Rhs = this->Jacobian * V * -1.0f;
-    Rhs[0] += this->Baumgarte.x;
-    Rhs[1] += this->Baumgarte.y;
-    Rhs[2] += this->Baumgarte.z;
-    Rhs[3] += this->RotBaumgarte.x;
-    Rhs[4] += this->RotBaumgarte.y;
+    auto J_invM_Jt = shu::JMJt(this->Jacobian, InvM);
+    auto Rhs = shu::JMul(this->Jacobian, V) * -1.0f;
+    Rhs[0] += this->BiasFactor * this->Baumgarte.x;
+    Rhs[1] += this->BiasFactor * this->Baumgarte.y;
+    Rhs[2] += this->BiasFactor * this->Baumgarte.z;
+    Rhs[3] += this->BiasFactor * this->RotBaumgarte.x;
+    Rhs[4] += this->BiasFactor * this->RotBaumgarte.y;
 
-    auto LagrangeLambda = shu::LCP_GaussSeidel(J_invM_Jt, Rhs);
+    shu::LDLtFactor(J_invM_Jt);
+    shu::LDLtSolve(J_invM_Jt, Rhs);
+    auto LagrangeLambda = Rhs;
 
-    auto Impulses = JacobianTranspose * LagrangeLambda;
+    auto Impulses = shu::JtMul(this->Jacobian, LagrangeLambda);
     this->ApplyImpulses(Impulses);
 
 #if WARM_STARTING
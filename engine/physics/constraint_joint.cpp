@@ -58,18 +58,18 @@ joint_constraint_3d::PreSolve(const f32 dt)
 void
 joint_constraint_3d::Solve()
 {
-    shu::matMN<f32, 12, 1> JacobianTranspose = this->Jacobian.Transposed();
-
     auto V = GetVelocities();
-    auto InvM = GetInverseMassMatrix();
+    auto InvM = GetInverseMass();
 
-    auto J_invM_Jt = this->Jacobian * InvM * JacobianTranspose;
-    auto Rhs = this->Jacobian * V * -1.0f;
-    Rhs[0] += this->Baumgarte;
+    auto J_invM_Jt = shu::JMJt(this->Jacobian, InvM);
+    auto Rhs = shu::JMul(this->Jacobian, V) * -1.0f;
+    Rhs[0] += this->BiasFactor * this->Baumgarte;
 
-    auto LagrangeLambda = shu::LCP_GaussSeidel(J_invM_Jt, Rhs);
+    shu::LDLtFactor(J_invM_Jt);
+    shu::LDLtSolve(J_invM_Jt, Rhs);
+    auto LagrangeLambda = Rhs;
 
-    auto Impulses = JacobianTranspose * LagrangeLambda;
+    auto Impulses = shu::JtMul(this->Jacobian, LagrangeLambda);
     this->ApplyImpulses(Impulses);
 
 #if WARM_STARTING
@@ -105,16 +105,16 @@ penetration_constraint_3d::PreSolve(const f32 dt)
 void
 penetration_constraint_3d::Solve()
 {
-    auto JacobianTranspose = this->Jacobian.Transposed();
-
     auto V = GetVelocities();
-    auto InvM = GetInverseMassMatrix();
-    auto J_InvM_Jt = this->Jacobian * InvM * JacobianTranspose;
+    auto InvM = GetInverseMass();
+    auto J_InvM_Jt = shu::JMJt(this->Jacobian, InvM);
 
-    auto Rhs = this->Jacobian * V * -1.0f;
-    Rhs += this->Baumgarte;
+    auto Rhs = shu::JMul(this->Jacobian, V) * -1.0f;
+    Rhs += this->BiasFactor * this->Baumgarte;
 
-    auto LagrangeLambdas = shu::LCP_GaussSeidel(J_InvM_Jt, Rhs);
+    shu::LDLtFactor(J_InvM_Jt);
+    shu::LDLtSolve(J_InvM_Jt, Rhs);
+    auto LagrangeLambdas = Rhs;
 
     auto OldLambdas = this->PreviousFrameLambdas;
     this->PreviousFrameLambdas += LagrangeLambdas;
@@ -145,7 +145,7 @@ penetration_constraint_3d::Solve()
     }
     LagrangeLambdas = this->PreviousFrameLambdas - OldLambdas;
 
-    auto Impulses = JacobianTranspose * LagrangeLambdas;
+    auto Impulses = shu::JtMul(this->Jacobian, LagrangeLambdas);
     this->ApplyImpulses(Impulses);
 }
 
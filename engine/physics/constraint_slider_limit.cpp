@@ -193,33 +193,31 @@ slider_constraint_limit_3d::PreSolve(const f32 dt)
 void
 slider_constraint_limit_3d::Solve()
 {
-    shu::matMN<f32, 12, 5> JacobianTranspose = this->Jacobian.Transposed();
-    shu::vecN <f32, 12>    V                 = GetVelocities();
-    shu::matN <f32, 12>    InvM              = GetInverseMassMatrix();
-
-    auto J_invM_Jt = this->Jacobian * InvM * JacobianTranspose;
-    auto Rhs       = this->Jacobian * V * -1.0f;
-    Rhs[0] += this->TransBaumgarte.x;
-    Rhs[1] += this->TransBaumgarte.y;
-    Rhs[2] += this->RotBaumgarte.x;
-    Rhs[3] += this->RotBaumgarte.y;
-    Rhs[4] += this->RotBaumgarte.z;
-    auto LagrangeLambda = shu::LCP_GaussSeidel(J_invM_Jt, Rhs);
-    auto Impulses = JacobianTranspose * LagrangeLambda;
+    shu::vecN <f32, 12>  V    = GetVelocities();
+    shu::inverse_mass_12 InvM = GetInverseMass();
+
+    auto J_invM_Jt = shu::JMJt(this->Jacobian, InvM);
+    auto Rhs       = shu::JMul(this->Jacobian, V) * -1.0f;
+    Rhs[0] += this->BiasFactor * this->TransBaumgarte.x;
+    Rhs[1] += this->BiasFactor * this->TransBaumgarte.y;
+    Rhs[2] += this->BiasFactor * this->RotBaumgarte.x;
+    Rhs[3] += this->BiasFactor * this->RotBaumgarte.y;
+    Rhs[4] += this->BiasFactor * this->RotBaumgarte.z;
+    shu::LDLtFactor(J_invM_Jt);
+    shu::LDLtSolve(J_invM_Jt, Rhs);
+    auto LagrangeLambda = Rhs;
+    auto Impulses = shu::JtMul(this->Jacobian, LagrangeLambda);
 
     // NOTE: Limit Solver
     if(this->EnforceLimits)
     {
-        // TODO: This can be optimized since the Jacobian "Matrix" is just a row vector in this case.
-        // TODO: Just one row of the limit constraint gradient(Min/Max).
-        shu::matMN<f32, 12, 1> LimitJ_T = this->LimitJacobian.Transposed();
-        // TODO: This is just the gradient divided by Mi and Ii.(?)
-        auto JInvJt_Limit = this->LimitJacobian * InvM * LimitJ_T;
-        auto Rhs_Limit = this->LimitJacobian * V * -1.0f;
-        Rhs_Limit[0] += this->LimitBaumgarte;
-        // TODO: No need to use GS here. Optimize this!
-        auto LagrangeLimit = shu::LCP_GaussSeidel(JInvJt_Limit, Rhs_Limit);
-        auto LimitImpulses = LimitJ_T * LagrangeLimit;
+        // NOTE: One row, so J*InvM*Jt is a single number.
+        auto JInvJt_Limit = shu::JMJt(this->LimitJacobian, InvM);
+        auto Rhs_Limit = shu::JMul(this->LimitJacobian, V) * -1.0f;
+        Rhs_Limit[0] += this->BiasFactor * this->LimitBaumgarte;
+        shu::LDLtFactor(JInvJt_Limit);
+        shu::LDLtSolve(JInvJt_Limit, Rhs_Limit);
+        auto LimitImpulses = shu::JtMul(this->LimitJacobian, Rhs_Limit);
 
         // NOTE: Getting the aggregate impulses with limits included.
         for (int i = 0; i < 12; ++i)
@@ -1,4 +1,5 @@
 #include "contact_manifold.h"
+#include <utils/sort/sort.h>
 
 void
 manifold::AddContact(const contact &NewContact)
@@ -179,7 +180,25 @@ manifold::PostSolve()
 }
 
 void
-manifold_collector::AddContact(const contact &Contact)
+manifold::SetBiasFactor(f32 BiasFactor)
+{
+    for(i32 i = 0; i < this->NumContacts; ++i)
+    {
+        this->PenConstraints[i].BiasFactor = BiasFactor;
+    }
+}
+
+void
+manifold::ScaleCachedLambdas(f32 Factor)
+{
+    for(i32 i = 0; i < this->NumContacts; ++i)
+    {
+        this->PenConstraints[i].ScaleCachedLambdas(Factor);
+    }
+}
+
+void
+manifold_collector::AddContact(const contact &Contact, const shoora_slot_map<shoora_body> &Bodies)
 {
     i32 FoundIdx = -1;
     // NOTE: We have found a contact in the cachedContacts that deals with the same pair of bodies which is there
@@ -202,6 +221,8 @@ manifold_collector::AddContact(const contact &Contact)
     else
     {
         manifold Manifold;
+        Manifold.HandleA = Bodies.GetHandle((i32)(Contact.ReferenceBodyA - Bodies.data()));
+        Manifold.HandleB = Bodies.GetHandle((i32)(Contact.IncidentBodyB - Bodies.data()));
         Manifold.A = Contact.ReferenceBodyA;
         Manifold.B = Contact.IncidentBodyB;
 
@@ -218,13 +239,48 @@ manifold_collector::RemoveExpired()
         manifold &Manifold = this->Manifolds[i];
         Manifold.RemoveExpiredContacts();
 
+        // NOTE: Going backwards, so the manifold that gets swapped in has already been looked at.
         if(Manifold.NumContacts == 0)
         {
-            this->Manifolds.erase(i);
+            this->Manifolds.swap_erase(i);
         }
     }
 }
 
+void
+manifold::SetBodies(shoora_body *BodyA, shoora_body *BodyB)
+{
+    this->A = BodyA;
+    this->B = BodyB;
+
+    // NOTE: AddContact puts every contact in the manifold's A, B order.
+    for(i32 i = 0; i < MAX_CONTACTS; ++i)
+    {
+        this->Contacts[i].ReferenceBodyA = BodyA;
+        this->Contacts[i].IncidentBodyB = BodyB;
+        this->PenConstraints[i].A = BodyA;
+        this->PenConstraints[i].B = BodyB;
+    }
+}
+
+void
+manifold_collector::ResolveBodies(const shoora_slot_map<shoora_body> &Bodies)
+{
+    for(i32 i = (i32)this->Manifolds.size() - 1; i >= 0; --i)
+    {
+        manifold &Manifold = this->Manifolds[i];
+        shoora_body *A = Bodies.Get(Manifold.HandleA);
+        shoora_body *B = Bodies.Get(Manifold.HandleB);
+        if(A == nullptr || B == nullptr)
+        {
+            this->Manifolds.swap_erase(i);
+            continue;
+        }
+
+        Manifold.SetBodies(A, B);
+    }
+}
+
 void
 manifold_collector::Clear()
 {
@@ -256,4 +312,152 @@ manifold_collector::PostSolve()
     {
         this->Manifolds[i].PostSolve();
     }
+}
+
+void
+manifold_collector::SetBiasFactor(f32 BiasFactor)
+{
+    for(i32 i = 0; i < this->Manifolds.size(); ++i)
+    {
+        this->Manifolds[i].SetBiasFactor(BiasFactor);
+    }
+}
+
+void
+manifold_collector::ScaleCachedLambdas(f32 Factor)
+{
+    for(i32 i = 0; i < this->Manifolds.size(); ++i)
+    {
+        this->Manifolds[i].ScaleCachedLambdas(Factor);
+    }
+}
+
+b32
+manifold_collector::CompareBodies(const manifold &M1, const manifold &M2)
+{
+    const shoora_body *MinA = MIN(M1.A, M1.B), *MaxA = MAX(M1.A, M1.B);
+    const shoora_body *MinB = MIN(M2.A, M2.B), *MaxB = MAX(M2.A, M2.B);
+
+    b32 Result = (MinA < MinB) || ((MinA == MinB) && (MaxA <= MaxB));
+    return Result;
+}
+
+void
+manifold_collector::SortByBodies()
+{
+    i32 Count = this->Manifolds.size();
+    if(Count > 1)
+    {
+        // NOTE: No two manifolds have the same pair of bodies, so there are no equal keys here and any sort gives
+        // the same result.
+        IntroSort(this->Manifolds.data(), Count,
+                  [](const manifold &A, const manifold &B) { return !CompareBodies(B, A); });
+    }
+}
+
+i32
+manifold_collector::GetContactCount() const
+{
+    i32 Result = 0;
+    for(i32 i = 0; i < this->Manifolds.size(); ++i)
+    {
+        Result += this->Manifolds[i].NumContacts;
+    }
+
+    return Result;
+}
+
+void
+manifold_collector::Save(physics_snapshot *Snapshot, const shoora_slot_map<shoora_body> &Bodies) const
+{
+    ASSERT(Snapshot->ManifoldCount == this->Manifolds.size());
+
+    i32 *ManifoldBodies = Snapshot->Block<i32>(Snapshot->ManifoldBodiesOffset);
+    i32 *ContactCounts = Snapshot->Block<i32>(Snapshot->ManifoldContactCountsOffset);
+    shu::vec3f *PointsA = Snapshot->Block<shu::vec3f>(Snapshot->ContactPointsAOffset);
+    shu::vec3f *PointsB = Snapshot->Block<shu::vec3f>(Snapshot->ContactPointsBOffset);
+    shu::vec3f *Normals = Snapshot->Block<shu::vec3f>(Snapshot->ContactNormalsOffset);
+    shu::vec3f *NormalsA = Snapshot->Block<shu::vec3f>(Snapshot->ContactNormalsAOffset);
+    f32 *Depths = Snapshot->Block<f32>(Snapshot->ContactDepthsOffset);
+    f32 *Lambdas = Snapshot->Block<f32>(Snapshot->ContactLambdasOffset);
+
+    i32 ContactIndex = 0;
+    for(i32 i = 0; i < this->Manifolds.size(); ++i)
+    {
+        const manifold &Manifold = this->Manifolds[i];
+        ManifoldBodies[2*i + 0] = (i32)(Manifold.A - Bodies.data());
+        ManifoldBodies[2*i + 1] = (i32)(Manifold.B - Bodies.data());
+        ContactCounts[i] = Manifold.NumContacts;
+
+        for(i32 j = 0; j < Manifold.NumContacts; ++j, ++ContactIndex)
+        {
+            ASSERT(ContactIndex < Snapshot->ContactCount);
+            const contact &Contact = Manifold.Contacts[j];
+            const penetration_constraint_3d &Constraint = Manifold.PenConstraints[j];
+            PointsA[ContactIndex] = Contact.ReferenceHitPointA_LocalSpace;
+            PointsB[ContactIndex] = Contact.IncidentHitPointB_LocalSpace;
+            Normals[ContactIndex] = Contact.Normal;
+            NormalsA[ContactIndex] = Constraint.Normal_LocalSpaceA;
+            Depths[ContactIndex] = Contact.Depth;
+            for(i32 k = 0; k < SNAPSHOT_CONTACT_LAMBDA_COUNT; ++k)
+            {
+                Lambdas[SNAPSHOT_CONTACT_LAMBDA_COUNT*ContactIndex + k] = Constraint.PreviousFrameLambdas[k];
+            }
+        }
+    }
+}
+
+void
+manifold_collector::Restore(const physics_snapshot *Snapshot, const shoora_slot_map<shoora_body> &Bodies)
+{
+    const i32 *ManifoldBodies = Snapshot->Block<i32>(Snapshot->ManifoldBodiesOffset);
+    const i32 *ContactCounts = Snapshot->Block<i32>(Snapshot->ManifoldContactCountsOffset);
+    const shu::vec3f *PointsA = Snapshot->Block<shu::vec3f>(Snapshot->ContactPointsAOffset);
+    const shu::vec3f *PointsB = Snapshot->Block<shu::vec3f>(Snapshot->ContactPointsBOffset);
+    const shu::vec3f *Normals = Snapshot->Block<shu::vec3f>(Snapshot->ContactNormalsOffset);
+    const shu::vec3f *NormalsA = Snapshot->Block<shu::vec3f>(Snapshot->ContactNormalsAOffset);
+    const f32 *Depths = Snapshot->Block<f32>(Snapshot->ContactDepthsOffset);
+    const f32 *Lambdas = Snapshot->Block<f32>(Snapshot->ContactLambdasOffset);
+
+    this->Manifolds.Clear();
+    i32 ContactIndex = 0;
+    for(i32 i = 0; i < Snapshot->ManifoldCount; ++i)
+    {
+        i32 IndexA = ManifoldBodies[2*i + 0];
+        i32 IndexB = ManifoldBodies[2*i + 1];
+        ASSERT(IndexA >= 0 && IndexA < Bodies.size() && IndexB >= 0 && IndexB < Bodies.size());
+        ASSERT(ContactCounts[i] > 0 && ContactCounts[i] <= manifold::MAX_CONTACTS);
+
+        shoora_body *A = Bodies.data() + IndexA;
+        shoora_body *B = Bodies.data() + IndexB;
+
+        manifold Manifold;
+        Manifold.HandleA = Bodies.GetHandle(IndexA);
+        Manifold.HandleB = Bodies.GetHandle(IndexB);
+        Manifold.NumContacts = ContactCounts[i];
+        for(i32 j = 0; j < Manifold.NumContacts; ++j, ++ContactIndex)
+        {
+            contact &Contact = Manifold.Contacts[j];
+            Contact = {};
+            Contact.ReferenceHitPointA_LocalSpace = PointsA[ContactIndex];
+            Contact.IncidentHitPointB_LocalSpace = PointsB[ContactIndex];
+            Contact.ReferenceHitPointA = A->LocalToWorldSpace(PointsA[ContactIndex]);
+            Contact.IncidentHitPointB = B->LocalToWorldSpace(PointsB[ContactIndex]);
+            Contact.Normal = Normals[ContactIndex];
+            Contact.Depth = Depths[ContactIndex];
+
+            penetration_constraint_3d &Constraint = Manifold.PenConstraints[j];
+            Constraint.AnchorPointLS_A = PointsA[ContactIndex];
+            Constraint.AnchorPointLS_B = PointsB[ContactIndex];
+            Constraint.Normal_LocalSpaceA = NormalsA[ContactIndex];
+            for(i32 k = 0; k < SNAPSHOT_CONTACT_LAMBDA_COUNT; ++k)
+            {
+                Constraint.PreviousFrameLambdas[k] = Lambdas[SNAPSHOT_CONTACT_LAMBDA_COUNT*ContactIndex + k];
+            }
+        }
+        Manifold.SetBodies(A, B);
+
+        this->Manifolds.emplace_back(Manifold);
+    }
+    ASSERT(ContactIndex == Snapshot->ContactCount);
 }
\ No newline at end of file
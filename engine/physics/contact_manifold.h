@@ -4,6 +4,7 @@
 #include "body.h"
 #include "constraint.h"
 #include "contact.h"
+#include "physics_snapshot.h"
 #include <containers/dynamic_array.h>
 #include <defines.h>
 
@@ -19,12 +20,21 @@ struct manifold
     void Solve();
     void PostSolve();
 
+    void SetBiasFactor(f32 BiasFactor);
+    void ScaleCachedLambdas(f32 Factor);
+
+    // NOTE: Points the contacts and the penetration constraints at A and B.
+    void SetBodies(shoora_body *BodyA, shoora_body *BodyB);
+
   private:
     static const i32 MAX_CONTACTS = 4;
     contact Contacts[MAX_CONTACTS];
     
     i32 NumContacts = 0;
 
+    // NOTE: A and B are only valid during the step, the handles are looked up again at the start of every step.
+    body_handle HandleA;
+    body_handle HandleB;
     shoora_body *A;
     shoora_body *B;
 
@@ -37,15 +47,43 @@ struct manifold_collector
 {
     manifold_collector() {}
 
-    void AddContact(const contact &Contact);
+    // NOTE: Bodies are the ones the contact's bodies live in, for the handles of a new manifold.
+    void AddContact(const contact &Contact, const shoora_slot_map<shoora_body> &Bodies);
 
     void PreSolve(const f32 dt);
     void Solve();
     void PostSolve();
 
+    void SetBiasFactor(f32 BiasFactor);
+    // NOTE: Damps the warm start lambdas of every contact, once per step.
+    void ScaleCachedLambdas(f32 Factor);
+
     void RemoveExpired();
     void Clear();
 
+    // NOTE: Looks up the bodies of every manifold from their handles. Called at the start of every step, the bodies
+    // may have moved since the last one. Manifolds whose body has been removed are dropped here, so removing a body
+    // does not have to look through the manifolds.
+    void ResolveBodies(const shoora_slot_map<shoora_body> &Bodies);
+
+    // NOTE: Sorts the manifolds by the address of their bodies(the bodies live in one array, so this is the body
+    // index order). Manifolds which were added in any order, for example from different threads, end up in the
+    // same order, so the solver visits them in the same order every run.
+    void SortByBodies();
+
+    // NOTE: Number of contacts in all the manifolds, for the snapshot layout.
+    i32 GetContactCount() const;
+    // NOTE: Writes the manifolds into the snapshot's manifold and contact blocks, which have to have been reserved
+    // for ContactCount contacts. The bodies are written as their index in Bodies, the manifolds' A and B have to be
+    // up to date.
+    void Save(physics_snapshot *Snapshot, const shoora_slot_map<shoora_body> &Bodies) const;
+    // NOTE: Replaces all the manifolds with the ones in the snapshot. The bodies have to be restored first, the
+    // world space contact points are worked out from them.
+    void Restore(const physics_snapshot *Snapshot, const shoora_slot_map<shoora_body> &Bodies);
+
+  private:
+    static b32 CompareBodies(const manifold &M1, const manifold &M2);
+
   public:
     shoora_dynamic_array<manifold> Manifolds;
 };
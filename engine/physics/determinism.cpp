@@ -0,0 +1,56 @@
+#include "determinism.h"
+
+// NOTE: MXCSR bits.
+#define MXCSR_EXCEPTION_MASKS 0x1F80
+#define MXCSR_ROUNDING_MASK 0x6000
+#define MXCSR_ROUND_TO_NEAREST 0x0000
+#define MXCSR_FLUSH_TO_ZERO 0x8000
+#define MXCSR_DENORMALS_ARE_ZERO 0x0040
+
+u32
+determinism::BeginFloatEnvironment()
+{
+    u32 Result = _mm_getcsr();
+
+    u32 NewState = Result;
+    NewState &= ~MXCSR_ROUNDING_MASK;
+    NewState |= MXCSR_ROUND_TO_NEAREST;
+    NewState |= MXCSR_EXCEPTION_MASKS;
+    NewState |= MXCSR_FLUSH_TO_ZERO | MXCSR_DENORMALS_ARE_ZERO;
+    _mm_setcsr(NewState);
+
+    return Result;
+}
+
+void
+determinism::EndFloatEnvironment(u32 SavedState)
+{
+    _mm_setcsr(SavedState);
+}
+
+static inline void
+HashBytes(u64 &Hash, const void *Data, size_t Size)
+{
+    const u8 *Bytes = (const u8 *)Data;
+    for(size_t i = 0; i < Size; ++i)
+    {
+        Hash ^= Bytes[i];
+        Hash *= 1099511628211ULL; // FNV Prime.
+    }
+}
+
+u64
+determinism::HashBodyStates(const shoora_body *Bodies, i32 BodyCount)
+{
+    u64 Result = 14695981039346656037ULL; // FNV Offset basis.
+    for(i32 i = 0; i < BodyCount; ++i)
+    {
+        const shoora_body &Body = Bodies[i];
+        HashBytes(Result, Body.Position.E, sizeof(f32) * 3);
+        HashBytes(Result, &Body.Rotation, sizeof(shu::quat));
+        HashBytes(Result, Body.LinearVelocity.E, sizeof(f32) * 3);
+        HashBytes(Result, Body.AngularVelocity.E, sizeof(f32) * 3);
+    }
+
+    return Result;
+}
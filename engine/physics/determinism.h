@@ -0,0 +1,25 @@
+#if !defined(DETERMINISM_H)
+
+#include <defines.h>
+#include "body.h"
+
+// NOTE: Helpers for the deterministic mode of the physics step(physics_settings::Deterministic).
+// IMPORTANT: NOTE: Bit exact results also need the compiler to not reorder/contract floating point math. So no
+// /fp:fast (or -ffast-math / -ffp-contract=fast) on the physics code.
+struct determinism
+{
+    determinism() = delete;
+
+    // NOTE: Saves the SSE control/status register(MXCSR) and sets round to nearest, flush to zero, denormals are
+    // zero and masks all the floating point exceptions. The MXCSR is per thread, so every thread that runs physics
+    // code has to do this. Returns the old state which has to be passed to EndFloatEnvironment.
+    static u32 BeginFloatEnvironment();
+    static void EndFloatEnvironment(u32 SavedState);
+
+    // NOTE: FNV-1a 64 over the bits of the position, rotation and the velocities of all the bodies. Two runs
+    // which are in sync have the same checksum every step.
+    static u64 HashBodyStates(const shoora_body *Bodies, i32 BodyCount);
+};
+
+#define DETERMINISM_H
+#endif // DETERMINISM_H
@@ -382,7 +382,7 @@ EPA_Expand(const shoora_body *A, const shoora_body *B, const f32 Bias, const gjk
     InitializeEPADebug();
 #endif
 
-    memory_arena *Arena = GetArena(shoora_memory_type::MEMTYPE_FRAME);
+    memory_arena *Arena = GetArena(shoora_memory_type::MEMTYPE_THREADFRAME);
     ASSERT(Arena != nullptr);
 
     temporary_memory TempMemory = BeginTemporaryMemory(Arena);
@@ -931,6 +931,153 @@ GJK_ClosestPoints(const shoora_body *A, const shoora_body *B, shu::vec3f &PointO
 #endif
 }
 
+shu::vec3f
+gjk_cast_shape::Support(const shu::vec3f &Direction) const
+{
+    shu::vec3f Result = shu::Vec3f(0.0f);
+
+    // NOTE: Box. The support point is the corner that is in the direction of the local space direction.
+    if(!this->HalfExtents.IsZero())
+    {
+        shu::vec3f DirLS = shu::QuatRotateVec(shu::QuatConjugate(this->Rotation), Direction);
+        shu::vec3f CornerLS = shu::Vec3f((DirLS.x >= 0.0f) ? this->HalfExtents.x : -this->HalfExtents.x,
+                                         (DirLS.y >= 0.0f) ? this->HalfExtents.y : -this->HalfExtents.y,
+                                         (DirLS.z >= 0.0f) ? this->HalfExtents.z : -this->HalfExtents.z);
+        Result = shu::QuatRotateVec(this->Rotation, CornerLS);
+    }
+
+    // NOTE: Sphere swept around it.
+    if(this->Radius > 0.0f)
+    {
+        Result += shu::Normalize(Direction) * this->Radius;
+    }
+
+    return Result;
+}
+
+gjk_cast_result
+GJK_ShapeCast(const shoora_body *A, const gjk_cast_shape &Shape, const shu::vec3f &Start, const shu::vec3f &End,
+              f32 &HitFraction, shu::vec3f &HitNormal)
+{
+    const i32 MaxIterations = 64;
+    const f32 Bias = 0.0f;
+
+    shu::vec3f Ray = End - Start;
+
+    // NOTE: The tolerance is relative to the sizes of A and the cast shape, an absolute one is too tight for big
+    // bodies(never converges) and too loose for small ones. When it is below the float precision of the points, the
+    // loop stops once the simplex does not get any closer(below).
+    shoora_bounds BoundsA = A->Shape->GetBounds();
+    f32 SizeA = (BoundsA.Maxs - BoundsA.Mins).Magnitude();
+    f32 SizeShape = 2.0f*(Shape.HalfExtents.Magnitude() + Shape.Radius);
+    const f32 Epsilon = MAX(0.0001f*MAX(SizeA, SizeShape), SHU_EPSILON);
+    f32 Lambda = 0.0f;
+    shu::vec3f X = Start;
+    shu::vec3f Normal = shu::Vec3f(0.0f);
+
+    // NOTE: The simplex stores the support points on A(PointOnA) and on the cast shape(PointOnB). The
+    // MinkowskiPoint is the vector from the point on A - Shape to the current point on the ray. It is recomputed
+    // every iteration since X moves.
+    gjk_point SimplexPoints[4];
+    i32 NumPoints = 0;
+    shu::vec4f BaryCoords = shu::Vec4f(0.0f);
+
+    // NOTE: Any point inside A - Shape works to start with. The shape is centered at the origin, so A's position
+    // is one.
+    shu::vec3f V = X - A->Position;
+
+    // NOTE: Closest squared distance from X to the simplex since X last moved.
+    f32 ClosestDistance = 1e10f;
+    b32 Converged = false;
+    for(i32 Iteration = 0; Iteration < MaxIterations; ++Iteration)
+    {
+        if(V.SqMagnitude() < (Epsilon * Epsilon))
+        {
+            Converged = true;
+            break;
+        }
+
+        gjk_point NewPoint;
+        shu::vec3f Dir = shu::Normalize(V);
+        NewPoint.PointOnA = A->Shape->SupportPtWorldSpace(Dir, A->Position, A->Rotation, Bias);
+        NewPoint.PointOnB = Shape.Support(-Dir);
+        shu::vec3f P = NewPoint.PointOnA - NewPoint.PointOnB;
+        shu::vec3f W = X - P;
+
+        f32 VdotW = V.Dot(W);
+        if(VdotW > 0.0f)
+        {
+            // NOTE: X is outside and V is a separating axis. If the ray does not go towards the plane, it never
+            // hits. Otherwise move X up to the plane.
+            f32 VdotR = V.Dot(Ray);
+            if(VdotR >= -SHU_EPSILON)
+            {
+                return GjkCast_Miss;
+            }
+
+            Lambda = Lambda - (VdotW / VdotR);
+            if(Lambda > 1.0f)
+            {
+                return GjkCast_Miss;
+            }
+
+            X = Start + Ray * Lambda;
+            Normal = V;
+            ClosestDistance = 1e10f;
+        }
+
+        if(NumPoints < 4)
+        {
+            SimplexPoints[NumPoints++] = NewPoint;
+        }
+        for(i32 i = 0; i < NumPoints; ++i)
+        {
+            SimplexPoints[i].MinkowskiPoint = X - (SimplexPoints[i].PointOnA - SimplexPoints[i].PointOnB);
+        }
+
+        if(NumPoints == 1)
+        {
+            V = SimplexPoints[0].MinkowskiPoint;
+            continue;
+        }
+
+        shu::vec3f NewDirection;
+        b32 ContainsOrigin = SimplexSignedVolumes(SimplexPoints, NumPoints, NewDirection, BaryCoords);
+        if(ContainsOrigin)
+        {
+            Converged = true;
+            break;
+        }
+
+        // NOTE: NewDirection points to the origin from the closest point, V is the other way around.
+        V = -NewDirection;
+        SortValids(SimplexPoints, BaryCoords);
+        NumPoints = NumValids(BaryCoords);
+        if(NumPoints == 4)
+        {
+            Converged = true;
+            break;
+        }
+
+        // NOTE: Same as in GJK_ClosestPoints, if the new point did not get the simplex any closer to X, it is as
+        // close as it gets in float precision. This happens where A - Shape is curved, the support points end up
+        // being dropped from the simplex again.
+        f32 Distance = V.SqMagnitude();
+        if(Distance >= ClosestDistance)
+        {
+            Converged = true;
+            break;
+        }
+        ClosestDistance = Distance;
+    }
+
+    HitFraction = Lambda;
+    HitNormal = Normal.IsZero() ? shu::Vec3f(0.0f) : shu::Normalize(Normal);
+
+    gjk_cast_result Result = Converged ? GjkCast_Hit : GjkCast_NotConverged;
+    return Result;
+}
+
 #if _SHU_DEBUG
 void
 TestSignedVolumeProjection()
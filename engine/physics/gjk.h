@@ -128,6 +128,36 @@ b32 GJK_DoesIntersect(const shoora_body *A, const shoora_body *B, const f32 Bias
                       shu::vec3f &PointOnB);
 void GJK_ClosestPoints(const shoora_body *A, const shoora_body *B, shu::vec3f &PointOnA, shu::vec3f &PointOnB);
 
+// NOTE: The convex shape that is swept in GJK_ShapeCast. It is a box(HalfExtents, Rotation) with a sphere of
+// Radius swept around it, centered at the origin. All zeroes is a point(a ray), zero HalfExtents is a sphere and
+// zero Radius is a box.
+struct gjk_cast_shape
+{
+    shu::vec3f HalfExtents = shu::Vec3f(0.0f);
+    shu::quat Rotation = shu::QuatIdentity();
+    f32 Radius = 0.0f;
+
+    shu::vec3f Support(const shu::vec3f &Direction) const;
+};
+
+// NOTE: GJK Raycast(Gino van den Bergen, "Ray Casting against General Convex Objects with Application to Continuous
+// Collision Detection"). Sweeps the Shape from Start to End against body A using only the support points of A.
+// The ray is cast against the Minkowski difference A - Shape, and whenever the current point on the ray is found to
+// be outside the difference, it is advanced up to the separating plane. On a hit it gives the fraction of
+// (End - Start) at the hit and the normal at the hit which points away from A. A fraction of 0 means the shape
+// already overlaps A at Start.
+enum gjk_cast_result
+{
+    GjkCast_Miss,
+    GjkCast_Hit,
+    // NOTE: Ran out of iterations before getting within the tolerance. The ray was still going towards A, the
+    // fraction and the normal are from the last separating plane it was moved up to, which is at or before the hit.
+    GjkCast_NotConverged,
+};
+
+gjk_cast_result GJK_ShapeCast(const shoora_body *A, const gjk_cast_shape &Shape, const shu::vec3f &Start,
+                              const shu::vec3f &End, f32 &HitFraction, shu::vec3f &HitNormal);
+
 
 #if _SHU_DEBUG
 void TestSignedVolumeProjection();
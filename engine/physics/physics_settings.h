@@ -0,0 +1,77 @@
+#if !defined(PHYSICS_SETTINGS_H)
+
+#include <defines.h>
+#include <math/math.h>
+
+// NOTE: Per scene knobs for the physics step. Each level can trade accuracy for cpu time by changing these at
+// runtime instead of recompiling.
+//
+// Every PhysicsUpdate(dt) is split into "Substeps" substeps of h = dt/Substeps (soft step / TGS style). For every
+// substep we:
+//  1. Integrate the external forces(gravity) into the velocities.
+//  2. PreSolve the constraints and apply the warm start lambdas.
+//  3. Run "VelocityIterations" solver iterations with the Baumgarte bias.
+//  4. Integrate the positions.
+//  5. Run "PositionIterations" relaxation iterations without the bias. This removes the velocity that the
+//     Baumgarte term added, so that it does not turn into energy in the next substep.
+// Broadphase and Narrowphase are run only once per step with the full dt. The cached lambdas are scaled by
+// "WarmStartFactor" once per step too, before the first substep.
+struct physics_settings
+{
+    i32 VelocityIterations = 6;
+    i32 PositionIterations = 0;
+    i32 Substeps = 1;
+
+    // NOTE: 1.0 means the full lambda from the previous step is applied. 0.0 disables warm starting.
+    f32 WarmStartFactor = 1.0f;
+
+    shu::vec3f Gravity = shu::Vec3f(0.0f, -9.8f, 0.0f);
+
+    // NOTE: Step() advances the simulation in fixed steps of FixedDeltaTime. If the frame took longer than
+    // MaxStepsPerFrame steps, the rest of the time is dropped so that a slow frame does not make the next frame
+    // even slower(spiral of death).
+    f32 FixedDeltaTime = (1.0f / 60.0f);
+    i32 MaxStepsPerFrame = 4;
+
+    // NOTE: Bit exact mode for lockstep/replays. Uses stable sorts and a canonical order for the pairs and the
+    // manifolds, fixes the float environment for the step and computes a checksum of the body states after every
+    // step(physics_step_stats::Checksum).
+    b32 Deterministic = false;
+
+    // NOTE: If I am debugging, the frametime is going to be huge. So hence, clamping the dt that comes in. A
+    // value of 0 means no clamping.
+#if _SHU_DEBUG
+    f32 MaxDeltaTime = (1.0f / 29.0f);
+#else
+    f32 MaxDeltaTime = 0.0f;
+#endif
+};
+
+// NOTE: Timings(in milliseconds) of the last physics step. Solve includes the presolve, the iterations, the
+// relaxation iterations and the postsolve for all substeps.
+struct physics_step_stats
+{
+    f32 IntegrateMs;
+    f32 BroadPhaseMs;
+    f32 NarrowPhaseMs;
+    f32 SolveMs;
+    f32 TotalMs;
+
+    i32 PairCount;
+    i32 ManifoldCount;
+    i32 Substeps;
+    i32 VelocityIterations;
+    i32 PositionIterations;
+
+    u64 StepCount;
+    // NOTE: Only computed in the deterministic mode.
+    u64 Checksum;
+
+    // NOTE: Filled in by Step(). Number of fixed steps run in the last frame and the time that was dropped
+    // because the catch-up budget ran out.
+    i32 StepsLastFrame;
+    f32 DroppedTime;
+};
+
+#define PHYSICS_SETTINGS_H
+#endif // PHYSICS_SETTINGS_H
@@ -0,0 +1,65 @@
+#include "physics_snapshot.h"
+#include <memory/memory.h>
+
+// NOTE: Every block starts at a 16 byte boundary.
+static inline size_t
+PushBlock(size_t &Offset, size_t Size)
+{
+    size_t Result = Offset;
+    Offset = ALIGN16(Offset + Size);
+    return Result;
+}
+
+void
+physics_snapshot::Reserve(i32 BodyCount, i32 ManifoldCount, i32 ContactCount, i32 ConstraintCount,
+                          i32 LambdaCount)
+{
+    size_t Offset = 0;
+    this->PositionsOffset = PushBlock(Offset, sizeof(shu::vec3f) * BodyCount);
+    this->RotationsOffset = PushBlock(Offset, sizeof(shu::quat) * BodyCount);
+    this->LinearVelocitiesOffset = PushBlock(Offset, sizeof(shu::vec3f) * BodyCount);
+    this->AngularVelocitiesOffset = PushBlock(Offset, sizeof(shu::vec3f) * BodyCount);
+    this->PreviousPositionsOffset = PushBlock(Offset, sizeof(shu::vec3f) * BodyCount);
+    this->PreviousRotationsOffset = PushBlock(Offset, sizeof(shu::quat) * BodyCount);
+    this->ManifoldBodiesOffset = PushBlock(Offset, sizeof(i32) * 2 * ManifoldCount);
+    this->ManifoldContactCountsOffset = PushBlock(Offset, sizeof(i32) * ManifoldCount);
+    this->ContactPointsAOffset = PushBlock(Offset, sizeof(shu::vec3f) * ContactCount);
+    this->ContactPointsBOffset = PushBlock(Offset, sizeof(shu::vec3f) * ContactCount);
+    this->ContactNormalsOffset = PushBlock(Offset, sizeof(shu::vec3f) * ContactCount);
+    this->ContactNormalsAOffset = PushBlock(Offset, sizeof(shu::vec3f) * ContactCount);
+    this->ContactDepthsOffset = PushBlock(Offset, sizeof(f32) * ContactCount);
+    this->ContactLambdasOffset = PushBlock(Offset, sizeof(f32) * SNAPSHOT_CONTACT_LAMBDA_COUNT * ContactCount);
+    this->LambdasOffset = PushBlock(Offset, sizeof(f32) * LambdaCount);
+
+    this->BodyCount = BodyCount;
+    this->ManifoldCount = ManifoldCount;
+    this->ContactCount = ContactCount;
+    this->ConstraintCount = ConstraintCount;
+    this->LambdaCount = LambdaCount;
+    this->Size = Offset;
+
+    if(this->Size > this->Capacity)
+    {
+        freelist_allocator *Allocator = GetFreelistAllocator(MEMTYPE_FREELISTGLOBAL);
+        if(this->Memory != nullptr)
+        {
+            Allocator->Free(this->Memory);
+        }
+
+        // NOTE: Some headroom for the manifolds that come and go.
+        this->Capacity = this->Size + this->Size / 4;
+        this->Memory = Allocator->Allocate(this->Capacity, 16);
+        ASSERT(this->Memory != nullptr);
+    }
+}
+
+void
+physics_snapshot::Free()
+{
+    if(this->Memory != nullptr)
+    {
+        GetFreelistAllocator(MEMTYPE_FREELISTGLOBAL)->Free(this->Memory);
+    }
+
+    *this = physics_snapshot{};
+}
@@ -0,0 +1,70 @@
+#if !defined(PHYSICS_SNAPSHOT_H)
+
+#include <defines.h>
+#include <math/math.h>
+
+#define SNAPSHOT_CONTACT_LAMBDA_COUNT 3
+
+// NOTE: Saved state of a scene's simulation, for rollbacks. Everything lives in one contiguous block of memory laid
+// out as SoA arrays, one block per field:
+//   Positions | Rotations | LinearVelocities | AngularVelocities | PreviousPositions | PreviousRotations |
+//   ManifoldBodies | ManifoldContactCounts |
+//   ContactPointsA | ContactPointsB | ContactNormals | ContactNormalsA | ContactDepths | ContactLambdas |
+//   Constraint lambdas
+// Nothing that does not change while simulating(the shapes, masses, inertia tensors, the constraint anchors) is
+// saved. The manifolds are saved as the indices of their two bodies and their contacts, and are built again from
+// those on restore. The contacts of all the manifolds are in one run, manifold after manifold. There are no pointers
+// in here, but the body indices are only good for a scene with the same bodies and constraints.
+struct physics_snapshot
+{
+    void *Memory = nullptr;
+    size_t Size = 0;
+    size_t Capacity = 0;
+
+    i32 BodyCount = 0;
+    i32 ManifoldCount = 0;
+    i32 ContactCount = 0;
+    i32 ConstraintCount = 0;
+    i32 LambdaCount = 0;
+
+    u64 StepCount = 0;
+    // NOTE: shoora_scene::StructureVersion when the snapshot was taken.
+    u32 StructureVersion = 0;
+    f32 TimeAccumulator = 0.0f;
+
+    // NOTE: Byte offsets of the blocks in Memory.
+    size_t PositionsOffset;
+    size_t RotationsOffset;
+    size_t LinearVelocitiesOffset;
+    size_t AngularVelocitiesOffset;
+    size_t PreviousPositionsOffset;
+    size_t PreviousRotationsOffset;
+    // NOTE: Two body indices per manifold.
+    size_t ManifoldBodiesOffset;
+    size_t ManifoldContactCountsOffset;
+    // NOTE: The contact points are in the local space of their body, ContactNormalsA in A's local space.
+    size_t ContactPointsAOffset;
+    size_t ContactPointsBOffset;
+    size_t ContactNormalsOffset;
+    size_t ContactNormalsAOffset;
+    size_t ContactDepthsOffset;
+    // NOTE: SNAPSHOT_CONTACT_LAMBDA_COUNT per contact, the normal and the two friction lambdas.
+    size_t ContactLambdasOffset;
+    size_t LambdasOffset;
+
+    // NOTE: Computes the layout for the counts and grows the memory if it does not fit. The memory is only ever
+    // grown, so taking snapshots of the same scene again and again does not allocate.
+    void Reserve(i32 BodyCount, i32 ManifoldCount, i32 ContactCount, i32 ConstraintCount, i32 LambdaCount);
+    void Free();
+
+    template <typename T>
+    T *
+    Block(size_t Offset) const
+    {
+        T *Result = (T *)((u8 *)this->Memory + Offset);
+        return Result;
+    }
+};
+
+#define PHYSICS_SNAPSHOT_H
+#endif // PHYSICS_SNAPSHOT_H
@@ -0,0 +1,266 @@
+#include "scene_query.h"
+#include <memory/memory.h>
+#include <utils/sort/sort.h>
+#include <platform/job_system.h>
+
+// NOTE: Bodies with an extent along the axis bigger than this times the average are put in the large list.
+#define LARGE_PROXY_FACTOR 8.0f
+#define RAY_BATCH_MIN_CHUNK_SIZE 64
+
+// NOTE: Same axis as the one in the broadphase.
+static inline shu::vec3f
+GetQueryAxis()
+{
+    shu::vec3f Result = shu::Normalize(shu::Vec3f(1, 1, 1));
+    return Result;
+}
+
+void
+scene_query::Build(const shoora_body *Bodies, const shoora_bounds *WorldBounds, i32 BodyCount)
+{
+    this->Bodies = Bodies;
+    this->BodyCount = BodyCount;
+
+    if(BodyCount > this->Capacity)
+    {
+        this->Free();
+        this->Bodies = Bodies;
+        this->BodyCount = BodyCount;
+
+        freelist_allocator *Allocator = GetFreelistAllocator(MEMTYPE_FREELISTGLOBAL);
+        this->Capacity = BodyCount + BodyCount / 2;
+        this->Proxies = (query_proxy *)Allocator->Allocate(sizeof(query_proxy) * this->Capacity);
+        this->BodyBounds = (shoora_bounds *)Allocator->Allocate(sizeof(shoora_bounds) * this->Capacity);
+        ASSERT(this->Proxies != nullptr && this->BodyBounds != nullptr);
+    }
+
+    const shu::vec3f Axis = GetQueryAxis();
+    f32 TotalExtent = 0.0f;
+    for(i32 i = 0; i < BodyCount; ++i)
+    {
+        this->BodyBounds[i] = WorldBounds[i];
+
+        query_proxy &Proxy = this->Proxies[i];
+        // NOTE: All the components of the axis are positive, so Mins and Maxs project to the min and max.
+        Proxy.Min = Axis.Dot(this->BodyBounds[i].Mins);
+        Proxy.Max = Axis.Dot(this->BodyBounds[i].Maxs);
+        Proxy.BodyIndex = i;
+        TotalExtent += (Proxy.Max - Proxy.Min);
+    }
+
+    // NOTE: Move the large ones to the end.
+    f32 LargeExtent = (BodyCount > 0) ? LARGE_PROXY_FACTOR * (TotalExtent / (f32)BodyCount) : 0.0f;
+    i32 SortedCount = BodyCount;
+    for(i32 i = 0; i < SortedCount;)
+    {
+        if((this->Proxies[i].Max - this->Proxies[i].Min) > LargeExtent)
+        {
+            --SortedCount;
+            SWAP(this->Proxies[i], this->Proxies[SortedCount]);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    this->SortedCount = SortedCount;
+    this->LargeCount = BodyCount - SortedCount;
+    this->MaxExtent = 0.0f;
+    for(i32 i = 0; i < SortedCount; ++i)
+    {
+        this->MaxExtent = MAX(this->MaxExtent, this->Proxies[i].Max - this->Proxies[i].Min);
+    }
+
+    IntroSort(this->Proxies, SortedCount, [](const query_proxy &A, const query_proxy &B) {
+        return (A.Min < B.Min) || ((A.Min == B.Min) && (A.BodyIndex < B.BodyIndex));
+    });
+}
+
+void
+scene_query::Free()
+{
+    if(this->Proxies != nullptr)
+    {
+        freelist_allocator *Allocator = GetFreelistAllocator(MEMTYPE_FREELISTGLOBAL);
+        Allocator->Free(this->Proxies);
+        Allocator->Free(this->BodyBounds);
+    }
+
+    *this = scene_query{};
+}
+
+template <typename visitor>
+void
+scene_query::VisitCandidates(const shoora_bounds &Bounds, visitor &Visit) const
+{
+    const shu::vec3f Axis = GetQueryAxis();
+    const f32 QueryMin = Axis.Dot(Bounds.Mins);
+    const f32 QueryMax = Axis.Dot(Bounds.Maxs);
+
+    // NOTE: First proxy with Min >= QueryMin - MaxExtent. Nothing before it can reach the query.
+    i32 Low = 0, High = this->SortedCount;
+    const f32 FirstMin = QueryMin - this->MaxExtent;
+    while(Low < High)
+    {
+        i32 Mid = Low + (High - Low) / 2;
+        if(this->Proxies[Mid].Min < FirstMin) { Low = Mid + 1; }
+        else                                  { High = Mid; }
+    }
+
+    for(i32 i = Low; (i < this->SortedCount) && (this->Proxies[i].Min <= QueryMax); ++i)
+    {
+        const query_proxy &Proxy = this->Proxies[i];
+        if(Proxy.Max >= QueryMin && this->BodyBounds[Proxy.BodyIndex].DoesIntersect(Bounds))
+        {
+            Visit(Proxy.BodyIndex);
+        }
+    }
+
+    for(i32 i = this->SortedCount; i < this->SortedCount + this->LargeCount; ++i)
+    {
+        const query_proxy &Proxy = this->Proxies[i];
+        if(this->BodyBounds[Proxy.BodyIndex].DoesIntersect(Bounds))
+        {
+            Visit(Proxy.BodyIndex);
+        }
+    }
+}
+
+b32
+scene_query::ShapeCast(const gjk_cast_shape &Shape, const shoora_bounds &ShapeBounds, const shu::vec3f &Start,
+                       const shu::vec3f &End, ray_hit &Hit) const
+{
+    Hit = ray_hit{};
+
+    // NOTE: Bounds of the whole sweep.
+    shoora_bounds SweptBounds;
+    SweptBounds.Expand(Start + ShapeBounds.Mins);
+    SweptBounds.Expand(Start + ShapeBounds.Maxs);
+    SweptBounds.Expand(End + ShapeBounds.Mins);
+    SweptBounds.Expand(End + ShapeBounds.Maxs);
+
+    const shoora_body *Bodies = this->Bodies;
+    auto Visit = [&](i32 BodyIndex)
+    {
+        f32 Fraction;
+        shu::vec3f Normal;
+        gjk_cast_result CastResult = GJK_ShapeCast(Bodies + BodyIndex, Shape, Start, End, Fraction, Normal);
+        if(CastResult != GjkCast_Miss && (Fraction < Hit.Fraction || Hit.BodyIndex == -1))
+        {
+            Hit.BodyIndex = BodyIndex;
+            Hit.Fraction = Fraction;
+            Hit.Normal = Normal;
+            Hit.Converged = (CastResult == GjkCast_Hit);
+        }
+    };
+    VisitCandidates(SweptBounds, Visit);
+
+    if(Hit.BodyIndex != -1)
+    {
+        Hit.Point = Start + (End - Start) * Hit.Fraction;
+    }
+
+    b32 Result = (Hit.BodyIndex != -1);
+    return Result;
+}
+
+b32
+scene_query::RayCast(const shu::vec3f &Start, const shu::vec3f &End, ray_hit &Hit) const
+{
+    gjk_cast_shape Point;
+    shoora_bounds PointBounds{shu::Vec3f(0.0f), shu::Vec3f(0.0f)};
+
+    b32 Result = ShapeCast(Point, PointBounds, Start, End, Hit);
+    return Result;
+}
+
+b32
+scene_query::SphereCast(f32 Radius, const shu::vec3f &Start, const shu::vec3f &End, ray_hit &Hit) const
+{
+    gjk_cast_shape Sphere;
+    Sphere.Radius = Radius;
+    shoora_bounds SphereBounds{shu::Vec3f(-Radius), shu::Vec3f(Radius)};
+
+    b32 Result = ShapeCast(Sphere, SphereBounds, Start, End, Hit);
+    return Result;
+}
+
+b32
+scene_query::BoxCast(const shu::vec3f &HalfExtents, const shu::quat &Rotation, const shu::vec3f &Start,
+                     const shu::vec3f &End, ray_hit &Hit) const
+{
+    gjk_cast_shape Box;
+    Box.HalfExtents = HalfExtents;
+    Box.Rotation = Rotation;
+
+    // NOTE: The bounds of the rotated box, from its support points along the axes.
+    shu::vec3f Extents = shu::Vec3f(Box.Support(shu::Vec3f(1, 0, 0)).x, Box.Support(shu::Vec3f(0, 1, 0)).y,
+                                    Box.Support(shu::Vec3f(0, 0, 1)).z);
+    shoora_bounds BoxBounds{Extents * -1.0f, Extents};
+
+    b32 Result = ShapeCast(Box, BoxBounds, Start, End, Hit);
+    return Result;
+}
+
+void
+scene_query::RayCastBatch(const ray_query *Rays, i32 Count, ray_hit *Hits, b32 Parallel) const
+{
+    if(!Parallel || Count <= RAY_BATCH_MIN_CHUNK_SIZE)
+    {
+        for(i32 i = 0; i < Count; ++i)
+        {
+            RayCast(Rays[i].Start, Rays[i].End, Hits[i]);
+        }
+        return;
+    }
+
+    JobSystem_ParallelFor(Count, RAY_BATCH_MIN_CHUNK_SIZE, [this, Rays, Hits](i32 First, i32 Last) {
+        for(i32 i = First; i < Last; ++i)
+        {
+            RayCast(Rays[i].Start, Rays[i].End, Hits[i]);
+        }
+    });
+}
+
+i32
+scene_query::OverlapAABB(const shoora_bounds &Bounds, i32 *OutBodyIndices, i32 MaxCount) const
+{
+    i32 Result = 0;
+    auto Visit = [&](i32 BodyIndex)
+    {
+        if(Result < MaxCount)
+        {
+            OutBodyIndices[Result++] = BodyIndex;
+        }
+    };
+    VisitCandidates(Bounds, Visit);
+
+    return Result;
+}
+
+i32
+scene_query::OverlapSphere(const shu::vec3f &Center, f32 Radius, i32 *OutBodyIndices, i32 MaxCount) const
+{
+    gjk_cast_shape Sphere;
+    Sphere.Radius = Radius;
+    shoora_bounds SphereBounds{Center - shu::Vec3f(Radius), Center + shu::Vec3f(Radius)};
+
+    const shoora_body *Bodies = this->Bodies;
+    i32 Result = 0;
+    auto Visit = [&](i32 BodyIndex)
+    {
+        // NOTE: A cast that does not move only hits if the sphere already overlaps the body. One that does not
+        // converge never found a separating plane, so it is counted as overlapping.
+        f32 Fraction;
+        shu::vec3f Normal;
+        if(Result < MaxCount &&
+           GJK_ShapeCast(Bodies + BodyIndex, Sphere, Center, Center, Fraction, Normal) != GjkCast_Miss)
+        {
+            OutBodyIndices[Result++] = BodyIndex;
+        }
+    };
+    VisitCandidates(SphereBounds, Visit);
+
+    return Result;
+}
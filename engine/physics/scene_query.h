@@ -0,0 +1,90 @@
+#if !defined(SCENE_QUERY_H)
+
+#include <defines.h>
+#include <math/math.h>
+#include <platform/platform.h>
+#include "body.h"
+#include "bounds.h"
+#include "gjk.h"
+
+struct ray_query
+{
+    shu::vec3f Start;
+    shu::vec3f End;
+};
+
+struct ray_hit
+{
+    // NOTE: -1 if nothing was hit.
+    i32 BodyIndex = -1;
+    // NOTE: Fraction of (End - Start) at the hit.
+    f32 Fraction = 1.0f;
+    // NOTE: For rays this is the hit point on the body. For shape casts this is where the center of the cast shape
+    // is at the time of the hit.
+    shu::vec3f Point;
+    // NOTE: Points away from the body that was hit. Zero if the ray/shape started inside the body.
+    shu::vec3f Normal;
+    // NOTE: False if GJK ran out of iterations on the body that was hit(GjkCast_NotConverged). The fraction is then
+    // at or a little before the real hit.
+    b32 Converged = true;
+};
+
+// NOTE: Per body entry of the query structure. Min/Max are the body's bounds projected on the same axis the
+// broadphase sweep and prune uses.
+struct query_proxy
+{
+    f32 Min;
+    f32 Max;
+    i32 BodyIndex;
+};
+
+// NOTE: Ray casts, shape casts and overlap tests against the bodies of a scene.
+// The structure is a 1D sweep and prune like the broadphase: the proxies are sorted by their Min along the axis.
+// For a query interval [QMin, QMax] every proxy that can overlap it has Min in [QMin - MaxExtent, QMax], so the
+// candidates are found with a binary search and a short scan. Bodies that are a lot bigger than the rest(floors,
+// walls) would make MaxExtent huge, so they are kept in a separate list which is always tested.
+// It has to be rebuilt(Build) after the bodies move, the scene does that at the end of every physics step. All the
+// queries are read only, so they can run on any number of threads at the same time.
+struct scene_query
+{
+    // NOTE: WorldBounds[i] are the bounds of Bodies[i], see body_transforms.
+    void Build(const shoora_body *Bodies, const shoora_bounds *WorldBounds, i32 BodyCount);
+    void Free();
+
+    b32 RayCast(const shu::vec3f &Start, const shu::vec3f &End, ray_hit &Hit) const;
+    // NOTE: Hits[i] is the result for Rays[i]. If Parallel is set, the rays are split up into chunks and run on the
+    // job system(platform/job_system.h). This waits for all of them to finish.
+    void RayCastBatch(const ray_query *Rays, i32 Count, ray_hit *Hits, b32 Parallel = false) const;
+
+    b32 SphereCast(f32 Radius, const shu::vec3f &Start, const shu::vec3f &End, ray_hit &Hit) const;
+    b32 BoxCast(const shu::vec3f &HalfExtents, const shu::quat &Rotation, const shu::vec3f &Start,
+                const shu::vec3f &End, ray_hit &Hit) const;
+
+    // NOTE: Writes the indices of the bodies overlapping the query to OutBodyIndices(upto MaxCount of them) and
+    // returns how many were found. OverlapAABB only tests the bounds, OverlapSphere is exact.
+    i32 OverlapAABB(const shoora_bounds &Bounds, i32 *OutBodyIndices, i32 MaxCount) const;
+    i32 OverlapSphere(const shu::vec3f &Center, f32 Radius, i32 *OutBodyIndices, i32 MaxCount) const;
+
+  private:
+    b32 ShapeCast(const gjk_cast_shape &Shape, const shoora_bounds &ShapeBounds, const shu::vec3f &Start,
+                  const shu::vec3f &End, ray_hit &Hit) const;
+
+    // NOTE: Calls Visit(BodyIndex) for every body whose bounds overlap the given bounds.
+    template <typename visitor> void VisitCandidates(const shoora_bounds &Bounds, visitor &Visit) const;
+
+    const shoora_body *Bodies = nullptr;
+    i32 BodyCount = 0;
+    i32 Capacity = 0;
+
+    // NOTE: Sorted by Min. The last LargeCount entries are the large bodies and they are not sorted.
+    query_proxy *Proxies = nullptr;
+    i32 SortedCount = 0;
+    i32 LargeCount = 0;
+    f32 MaxExtent = 0.0f;
+
+    // NOTE: Indexed by the body index.
+    shoora_bounds *BodyBounds = nullptr;
+};
+
+#define SCENE_QUERY_H
+#endif // SCENE_QUERY_H
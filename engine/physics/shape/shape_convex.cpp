@@ -30,10 +30,10 @@ BuildConvexThreaded(platform_work_queue *Queue, shoora_shape_convex *ConvexMem,
 {
     ASSERT(Arena != nullptr);
 
+    // NOTE: GetTaskMemory has already claimed it for this task.
     task_with_memory *TaskMem = GetTaskMemory();
+    ASSERT(TaskMem != nullptr);
     ASSERT(TaskMem->Arena.Base != nullptr && TaskMem->Arena.Size > 0 && !TaskMem->Arena.Used);
-    TaskMem->BeingUsed = true;
-
 
     auto *WorkData = (shape_convex_build_work_data *)ShuAllocate_(&TaskMem->Arena,
                                                                   sizeof(shape_convex_build_work_data));
@@ -133,24 +133,7 @@ shoora_shape_convex::GetType() const
 shoora_bounds
 shoora_shape_convex::GetBounds(const shu::vec3f &Pos, const shu::quat &Orientation) const
 {
-    shu::vec3f Corners[8];
-    Corners[0] = shu::Vec3f(this->mBounds.Mins.x, this->mBounds.Mins.y, this->mBounds.Mins.z);
-    Corners[1] = shu::Vec3f(this->mBounds.Mins.x, this->mBounds.Mins.y, this->mBounds.Maxs.z);
-    Corners[2] = shu::Vec3f(this->mBounds.Mins.x, this->mBounds.Maxs.y, this->mBounds.Mins.z);
-    Corners[3] = shu::Vec3f(this->mBounds.Maxs.x, this->mBounds.Mins.y, this->mBounds.Mins.z);
-
-    Corners[4] = shu::Vec3f(this->mBounds.Maxs.x, this->mBounds.Maxs.y, this->mBounds.Maxs.z);
-    Corners[5] = shu::Vec3f(this->mBounds.Maxs.x, this->mBounds.Maxs.y, this->mBounds.Mins.z);
-    Corners[6] = shu::Vec3f(this->mBounds.Maxs.x, this->mBounds.Mins.y, this->mBounds.Maxs.z);
-    Corners[7] = shu::Vec3f(this->mBounds.Mins.x, this->mBounds.Maxs.y, this->mBounds.Maxs.z);
-
-    shoora_bounds Bounds;
-    for (i32 i = 0; i < 8; ++i)
-    {
-        Corners[i] = shu::QuatRotateVec(Orientation, Corners[i]) + Pos;
-        Bounds.Expand(Corners[i]);
-    }
-
+    shoora_bounds Bounds = this->mBounds.Transformed(Pos, Orientation);
     return Bounds;
 }
 
@@ -165,20 +148,12 @@ shu::vec3f
 shoora_shape_convex::SupportPtWorldSpace(const shu::vec3f &Direction, const shu::vec3f &Position,
                                          const shu::quat &Orientation, const f32 Bias) const
 {
-    // NOTE: Find the point furthest in the direction.
-    shu::vec3f MaxPoint = shu::QuatRotateVec(Orientation, this->Points[0]) + Position;
-    f32 MaxProj = MaxPoint.Dot(Direction);
-    for(i32 i = 1; i < this->NumPoints; ++i)
-    {
-        auto Point = shu::QuatRotateVec(Orientation, this->Points[i]) + Position;
-        auto PointDistance = Point.Dot(Direction);
-
-        if(MaxProj < PointDistance)
-        {
-            MaxProj = PointDistance;
-            MaxPoint = Point;
-        }
-    }
+    // NOTE: Find the point furthest in the direction. Same as the cube, the direction is rotated into model space so
+    // that only the furthest point has to be rotated.
+    const shu::vec3f LocalDirection = shu::QuatRotateVec(shu::QuatConjugate(Orientation), Direction);
+    i32 MaxIndex;
+    shu::MaxDot(this->Points, this->NumPoints, LocalDirection, &MaxIndex);
+    shu::vec3f MaxPoint = shu::QuatRotateVec(Orientation, this->Points[MaxIndex]) + Position;
 
     shu::vec3f Normal = shu::Normalize(Direction);
     Normal *= Bias;
@@ -190,18 +165,9 @@ shoora_shape_convex::SupportPtWorldSpace(const shu::vec3f &Direction, const shu:
 f32
 shoora_shape_convex::FastestLinearSpeed(const shu::vec3f &AngularVelocity, const shu::vec3f &Direction) const
 {
-    f32 MaxSpeed = SHU_FLOAT_MIN;
-    for(i32 i = 0; i < this->NumPoints; ++i)
-    {
-        const shu::vec3f r = this->Points[i] - this->mCenterOfMass;
-        shu::vec3f LinearVelocity = AngularVelocity.Cross(r);
-
-        f32 speed = LinearVelocity.Dot(Direction);
-        if(speed > MaxSpeed)
-        {
-            MaxSpeed = speed;
-        }
-    }
+    // NOTE: Direction.(AngularVelocity x r) is r.(Direction x AngularVelocity), see the cube.
+    const shu::vec3f K = Direction.Cross(AngularVelocity);
+    f32 MaxSpeed = shu::MaxDot(this->Points, this->NumPoints, K) - this->mCenterOfMass.Dot(K);
 
     return MaxSpeed;
 }
@@ -211,17 +177,8 @@ i32
 shoora_shape_convex::FindPointFurthestInDirection(const shu::vec3f *Points, const i32 Num,
                                                   const shu::vec3f &Direction)
 {
-    i32 MaxId = 0;
-    f32 MaxDist = Direction.Dot(Points[0]);
-    for(i32 i = 1; i < Num; ++i)
-    {
-        f32 Distance = Direction.Dot(Points[i]);
-        if(Distance > MaxDist)
-        {
-            MaxDist = Distance;
-            MaxId = i;
-        }
-    }
+    i32 MaxId;
+    shu::MaxDot(Points, Num, Direction, &MaxId);
 
     return MaxId;
 }
@@ -112,24 +112,7 @@ shoora_shape_cube::GetType() const
 shoora_bounds
 shoora_shape_cube::GetBounds(const shu::vec3f &Pos, const shu::quat &Orientation) const
 {
-    shu::vec3f Corners[8];
-    Corners[0] = shu::Vec3f(this->mBounds.Mins.x, this->mBounds.Mins.y, this->mBounds.Mins.z);
-    Corners[1] = shu::Vec3f(this->mBounds.Mins.x, this->mBounds.Mins.y, this->mBounds.Maxs.z);
-    Corners[2] = shu::Vec3f(this->mBounds.Mins.x, this->mBounds.Maxs.y, this->mBounds.Mins.z);
-    Corners[3] = shu::Vec3f(this->mBounds.Maxs.x, this->mBounds.Mins.y, this->mBounds.Mins.z);
-
-    Corners[4] = shu::Vec3f(this->mBounds.Maxs.x, this->mBounds.Maxs.y, this->mBounds.Maxs.z);
-    Corners[5] = shu::Vec3f(this->mBounds.Maxs.x, this->mBounds.Maxs.y, this->mBounds.Mins.z);
-    Corners[6] = shu::Vec3f(this->mBounds.Maxs.x, this->mBounds.Mins.y, this->mBounds.Maxs.z);
-    Corners[7] = shu::Vec3f(this->mBounds.Mins.x, this->mBounds.Maxs.y, this->mBounds.Maxs.z);
-
-    shoora_bounds Bounds;
-    for (i32 i = 0; i < 8; ++i)
-    {
-        Corners[i] = shu::QuatRotateVec(Orientation, Corners[i]) + Pos;
-        Bounds.Expand(Corners[i]);
-    }
-
+    shoora_bounds Bounds = this->mBounds.Transformed(Pos, Orientation);
     return Bounds;
 }
 
@@ -144,21 +127,12 @@ shu::vec3f
 shoora_shape_cube::SupportPtWorldSpace(const shu::vec3f &Direction, const shu::vec3f &Position, const shu::quat &Orientation,
                            const f32 Bias) const
 {
-    // NOTE: Find the furthest point/vertex in the given direction.
-    shu::vec3f MaxPoint = shu::QuatRotateVec(Orientation, this->mPoints[0]) + Position;
-    f32 MaxDistance = Direction.Dot(MaxPoint);
-
-    for(i32 i = 1; i < ARRAY_SIZE(mPoints); ++i)
-    {
-        const shu::vec3f Point = shu::QuatRotateVec(Orientation, this->mPoints[i]) + Position;
-        const f32 PointDistance = Direction.Dot(Point);
-
-        if(PointDistance > MaxDistance)
-        {
-            MaxDistance = PointDistance;
-            MaxPoint = Point;
-        }
-    }
+    // NOTE: Find the furthest point/vertex in the given direction. The rotation does not change which point that is,
+    // so the direction goes into model space instead and only the point that wins is rotated.
+    const shu::vec3f LocalDirection = shu::QuatRotateVec(shu::QuatConjugate(Orientation), Direction);
+    i32 MaxIndex;
+    shu::MaxDot(this->mPoints, ARRAY_SIZE(this->mPoints), LocalDirection, &MaxIndex);
+    shu::vec3f MaxPoint = shu::QuatRotateVec(Orientation, this->mPoints[MaxIndex]) + Position;
 
     shu::vec3f Norm = shu::Normalize(Direction);
     Norm *= Bias;
@@ -170,19 +144,11 @@ shoora_shape_cube::SupportPtWorldSpace(const shu::vec3f &Direction, const shu::v
 f32
 shoora_shape_cube::FastestLinearSpeed(const shu::vec3f &AngularVelocity, const shu::vec3f &Direction) const
 {
-    f32 MaxSpeed = 0.0f;
-    for(i32 i = 0; i < ARRAY_SIZE(this->mPoints); ++i)
-    {
-        shu::vec3f r = this->mPoints[i] - this->mCenterOfMass;
-        shu::vec3f LinearVelocity = AngularVelocity.Cross(r);
-        // LinearVelocity in the direction of the "Direction" passed in here.
-        f32 Speed = Direction.Dot(LinearVelocity);
-
-        if(Speed > MaxSpeed)
-        {
-            MaxSpeed = Speed;
-        }
-    }
+    // NOTE: The speed of a point along Direction is Direction.(AngularVelocity x r), which is r.(Direction x
+    // AngularVelocity). So it is one dot product per point and the center of mass part is the same for all of them.
+    const shu::vec3f K = Direction.Cross(AngularVelocity);
+    f32 MaxSpeed = shu::MaxDot(this->mPoints, ARRAY_SIZE(this->mPoints), K) - this->mCenterOfMass.Dot(K);
+    MaxSpeed = MAX(MaxSpeed, 0.0f);
 
     return MaxSpeed;
 }
\ No newline at end of file
@@ -44,11 +44,14 @@ shoora_shape_polygon::GetDim() const
 void
 shoora_shape_polygon::UpdateWorldVertices(shu::mat4f &ModelMatrix)
 {
+    // NOTE: The positions are spread out in the vertex structs, copy them together first and then transform them in
+    // place 8 at a time.
     const auto *LocalVertices = MeshFilter->Vertices;
     for (u32 i = 0; i < this->VertexCount; ++i)
     {
-        this->WorldVertices[i] = (ModelMatrix * LocalVertices[i].Pos).xyz;
+        this->WorldVertices[i] = LocalVertices[i].Pos;
     }
+    shu::MulPoints(ModelMatrix, this->WorldVertices, this->VertexCount, this->WorldVertices);
 }
 
 shu::vec3f
@@ -0,0 +1,1001 @@
+#include "job_system.h"
+#include <memory/memory.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <ucontext.h>
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#include <emmintrin.h>
+#define JOB_SPIN_PAUSE() _mm_pause()
+#else
+#define JOB_SPIN_PAUSE() sched_yield()
+#endif
+
+static_assert(JOB_SYSTEM_MAX_THREADS == MAX_THREAD_ARENA_COUNT, "Every job thread needs a thread frame arena.");
+
+// NOTE: How many times an idle worker looks for work before it goes to sleep.
+#define JOB_WORKER_SPIN_COUNT 256
+
+// ----------------------------------------------------------------------------------------------------------------
+// NOTE: OS threads and semaphores. Win32 and pthreads.
+// ----------------------------------------------------------------------------------------------------------------
+#if defined(_WIN32)
+typedef HANDLE job_thread;
+typedef HANDLE job_semaphore;
+#define JOB_THREAD_PROC(name) DWORD WINAPI name(LPVOID Param)
+typedef JOB_THREAD_PROC(job_thread_proc);
+
+static void JobSemaphoreCreate(job_semaphore *Semaphore) { *Semaphore = CreateSemaphoreExA(0, 0, MAXLONG, 0, 0, SEMAPHORE_ALL_ACCESS); }
+static void JobSemaphoreDestroy(job_semaphore *Semaphore) { CloseHandle(*Semaphore); }
+static void JobSemaphorePost(job_semaphore *Semaphore, u32 Count) { ReleaseSemaphore(*Semaphore, (LONG)Count, 0); }
+static void JobSemaphoreWait(job_semaphore *Semaphore) { WaitForSingleObjectEx(*Semaphore, INFINITE, FALSE); }
+
+static void JobThreadCreate(job_thread *Thread, job_thread_proc *Proc, void *Param) { *Thread = CreateThread(0, 0, Proc, Param, 0, 0); }
+static void JobThreadJoin(job_thread *Thread) { WaitForSingleObject(*Thread, INFINITE); CloseHandle(*Thread); }
+
+static u32
+JobGetHardwareThreadCount()
+{
+    SYSTEM_INFO Info;
+    GetSystemInfo(&Info);
+    return (u32)Info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t job_thread;
+typedef sem_t job_semaphore;
+#define JOB_THREAD_PROC(name) void *name(void *Param)
+typedef JOB_THREAD_PROC(job_thread_proc);
+
+static void JobSemaphoreCreate(job_semaphore *Semaphore) { sem_init(Semaphore, 0, 0); }
+static void JobSemaphoreDestroy(job_semaphore *Semaphore) { sem_destroy(Semaphore); }
+static void JobSemaphorePost(job_semaphore *Semaphore, u32 Count) { while(Count--) { sem_post(Semaphore); } }
+static void JobSemaphoreWait(job_semaphore *Semaphore) { while(sem_wait(Semaphore) != 0 && errno == EINTR) {} }
+
+static void JobThreadCreate(job_thread *Thread, job_thread_proc *Proc, void *Param) { pthread_create(Thread, 0, Proc, Param); }
+static void JobThreadJoin(job_thread *Thread) { pthread_join(*Thread, 0); }
+
+static u32
+JobGetHardwareThreadCount()
+{
+    long Count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (Count > 0) ? (u32)Count : 1;
+}
+#endif
+
+// ----------------------------------------------------------------------------------------------------------------
+// NOTE: Fiber contexts. Win32 fibers and ucontext.
+// ----------------------------------------------------------------------------------------------------------------
+#if defined(_WIN32)
+#define JOB_FIBER_PROC(name) void WINAPI name(void *Param)
+#else
+#define JOB_FIBER_PROC(name) void name(void *Param)
+#endif
+typedef JOB_FIBER_PROC(job_fiber_proc);
+
+// NOTE: Every fiber starts in here.
+static JOB_FIBER_PROC(JobFiberMain);
+
+#if defined(_WIN32)
+struct job_fiber_context
+{
+    void *Fiber;
+};
+
+// NOTE: Win32 can only switch fibers from a fiber. Returns false if the thread already was one, then it is not
+// turned back into a thread at the end.
+static b32
+JobFiberConvertThread(job_fiber_context *Context)
+{
+    Context->Fiber = ConvertThreadToFiberEx(0, FIBER_FLAG_FLOAT_SWITCH);
+    if(Context->Fiber == nullptr)
+    {
+        ASSERT(GetLastError() == ERROR_ALREADY_FIBER);
+        Context->Fiber = GetCurrentFiber();
+        return false;
+    }
+    return true;
+}
+
+static void JobFiberRevertThread() { ConvertFiberToThread(); }
+
+static void
+JobFiberCreate(job_fiber_context *Context, u32 StackSize, memory_arena *StackArena, void *Param)
+{
+    Context->Fiber = CreateFiberEx(StackSize, StackSize, FIBER_FLAG_FLOAT_SWITCH, JobFiberMain, Param);
+    ASSERT(Context->Fiber != nullptr);
+}
+
+static void JobFiberDestroy(job_fiber_context *Context, memory_arena *StackArena) { DeleteFiber(Context->Fiber); }
+static void JobFiberSwitch(job_fiber_context *From, job_fiber_context *To) { SwitchToFiber(To->Fiber); }
+#else
+struct job_fiber_context
+{
+    ucontext_t Context;
+    void *Stack;
+};
+
+static b32 JobFiberConvertThread(job_fiber_context *Context) { return false; }
+static void JobFiberRevertThread() {}
+
+// NOTE: makecontext only passes ints, so the pointer is split in two.
+static void
+JobFiberTrampoline(int Low, int High)
+{
+    u64 Pointer = ((u64)(u32)High << 32) | (u64)(u32)Low;
+    JobFiberMain((void *)(uintptr_t)Pointer);
+}
+
+static void
+JobFiberCreate(job_fiber_context *Context, u32 StackSize, memory_arena *StackArena, void *Param)
+{
+    Context->Stack = (StackArena != nullptr) ? ShuAllocate_(StackArena, StackSize, 16) : malloc(StackSize);
+    ASSERT(Context->Stack != nullptr);
+
+    getcontext(&Context->Context);
+    Context->Context.uc_stack.ss_sp = Context->Stack;
+    Context->Context.uc_stack.ss_size = StackSize;
+    Context->Context.uc_link = nullptr;
+
+    u64 Pointer = (u64)(uintptr_t)Param;
+    makecontext(&Context->Context, (void (*)())JobFiberTrampoline, 2, (int)(u32)Pointer, (int)(u32)(Pointer >> 32));
+}
+
+// NOTE: Stacks from the arena go away with the arena.
+static void
+JobFiberDestroy(job_fiber_context *Context, memory_arena *StackArena)
+{
+    if(StackArena == nullptr)
+    {
+        free(Context->Stack);
+    }
+    Context->Stack = nullptr;
+}
+
+static void JobFiberSwitch(job_fiber_context *From, job_fiber_context *To) { swapcontext(&From->Context, &To->Context); }
+#endif
+
+// ----------------------------------------------------------------------------------------------------------------
+// NOTE: Chase-Lev work stealing deque. "Dynamic Circular Work-Stealing Deque" (Chase, Lev 2005) with the memory
+// orders from "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013).
+// ----------------------------------------------------------------------------------------------------------------
+struct job
+{
+    // NOTE: Work from Platform_AddWorkEntry has a queue and calls the platform callback with it.
+    union
+    {
+        job_entry *Entry;
+        platform_work_queue_callback *QueueCallback;
+    };
+    void *Args;
+    platform_work_queue *Queue;
+    job_counter *Counter;
+};
+
+struct job_deque_buffer
+{
+    i64 Capacity;
+    job_deque_buffer *Previous;
+    // NOTE: The jobs follow.
+
+    inline job *Jobs() { return (job *)(this + 1); }
+    inline job &Get(i64 Index) { return Jobs()[Index & (this->Capacity - 1)]; }
+};
+
+static job_deque_buffer *
+JobDequeBufferCreate(i64 Capacity)
+{
+    ASSERT((Capacity & (Capacity - 1)) == 0);
+    job_deque_buffer *Result = (job_deque_buffer *)malloc(sizeof(job_deque_buffer) + sizeof(job)*Capacity);
+    ASSERT(Result != nullptr);
+    Result->Capacity = Capacity;
+    Result->Previous = nullptr;
+    return Result;
+}
+
+struct job_deque
+{
+    alignas(64) std::atomic<i64> Top;
+    alignas(64) std::atomic<i64> Bottom;
+    std::atomic<job_deque_buffer *> Buffer;
+
+    void
+    Initialize()
+    {
+        this->Top.store(0, std::memory_order_relaxed);
+        this->Bottom.store(0, std::memory_order_relaxed);
+        this->Buffer.store(JobDequeBufferCreate(JOB_DEQUE_INITIAL_CAPACITY), std::memory_order_relaxed);
+    }
+
+    // NOTE: A thief can still be reading an old buffer after it grew, so they are all kept until the deque is freed.
+    void
+    Free()
+    {
+        job_deque_buffer *Buffer = this->Buffer.load(std::memory_order_relaxed);
+        while(Buffer != nullptr)
+        {
+            job_deque_buffer *Previous = Buffer->Previous;
+            free(Buffer);
+            Buffer = Previous;
+        }
+        this->Buffer.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // NOTE: Owner only.
+    void
+    Push(const job &Job)
+    {
+        i64 B = this->Bottom.load(std::memory_order_relaxed);
+        i64 T = this->Top.load(std::memory_order_acquire);
+        job_deque_buffer *Buffer = this->Buffer.load(std::memory_order_relaxed);
+        if((B - T) > (Buffer->Capacity - 1))
+        {
+            job_deque_buffer *Grown = JobDequeBufferCreate(Buffer->Capacity * 2);
+            for(i64 i = T; i < B; ++i)
+            {
+                Grown->Get(i) = Buffer->Get(i);
+            }
+            Grown->Previous = Buffer;
+            this->Buffer.store(Grown, std::memory_order_release);
+            Buffer = Grown;
+        }
+
+        Buffer->Get(B) = Job;
+        this->Bottom.store(B + 1, std::memory_order_release);
+    }
+
+    // NOTE: Owner only. Newest job first.
+    b32
+    Pop(job *Result)
+    {
+        i64 B = this->Bottom.load(std::memory_order_relaxed) - 1;
+        job_deque_buffer *Buffer = this->Buffer.load(std::memory_order_relaxed);
+        this->Bottom.store(B, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 T = this->Top.load(std::memory_order_relaxed);
+
+        b32 Found = false;
+        if(T <= B)
+        {
+            *Result = Buffer->Get(B);
+            Found = true;
+            if(T == B)
+            {
+                // NOTE: The last job, a thief could be taking it at the same time.
+                if(!this->Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    Found = false;
+                }
+                this->Bottom.store(B + 1, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            this->Bottom.store(B + 1, std::memory_order_relaxed);
+        }
+
+        return Found;
+    }
+
+    // NOTE: Any thread. Oldest job first. Fails when the deque is empty or another thread took the job first.
+    b32
+    Steal(job *Result)
+    {
+        i64 T = this->Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 B = this->Bottom.load(std::memory_order_acquire);
+        if(T >= B)
+        {
+            return false;
+        }
+
+        job_deque_buffer *Buffer = this->Buffer.load(std::memory_order_acquire);
+        job Job = Buffer->Get(T);
+        if(!this->Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        *Result = Job;
+        return true;
+    }
+
+    inline b32
+    IsEmpty() const
+    {
+        i64 B = this->Bottom.load(std::memory_order_seq_cst);
+        i64 T = this->Top.load(std::memory_order_seq_cst);
+        return B <= T;
+    }
+};
+
+// ----------------------------------------------------------------------------------------------------------------
+// NOTE: Scheduler.
+// ----------------------------------------------------------------------------------------------------------------
+struct job_fiber
+{
+    job_fiber_context Context;
+    job Job;
+    // NOTE: What the fiber is parked on, while it is in the waiting list.
+    job_counter *WaitCounter;
+    job_fiber *Next;
+    u32 ThreadIndex;
+    b32 Finished;
+
+    // NOTE: The thread's frame arena when the job started, or when it was resumed while not holding any of it. A
+    // fiber which parks with more of the arena used or more temporary memory open than that holds the memory on top
+    // of the arena, see JobFiberCanResume.
+    size_t ArenaUsedAtStart;
+    u32 ArenaTempCountAtStart;
+    b32 HoldsArena;
+    u64 ParkSequence;
+};
+
+// NOTE: Fibers never move to another thread. A job which waits is resumed by the thread it started on, so a job
+// does not see its thread change under it in the middle of the job and this needs no locks.
+struct job_thread_state
+{
+    // NOTE: Where the thread runs the scheduler. Fibers switch back to it when they finish or wait.
+    job_fiber_context SchedulerContext;
+    job_fiber *CurrentFiber;
+    job_fiber *FreeFibers;
+    // NOTE: Newest parked first.
+    job_fiber *WaitingFibers;
+    job_fiber *Fibers;
+    b32 ConvertedThread;
+
+    // NOTE: Parks on this thread so far. A JobSystem_Wait outside of a fiber sets the floor to it, the fibers which
+    // hold some of the frame arena and parked before that cannot resume until the wait is over.
+    u64 ParkCount;
+    u64 ResumeFloor;
+};
+
+struct job_system_state
+{
+    job_deque Deques[JOB_SYSTEM_MAX_THREADS];
+    job_thread Threads[JOB_SYSTEM_MAX_THREADS];
+    job_thread_state ThreadStates[JOB_SYSTEM_MAX_THREADS];
+    u32 ThreadCount;
+
+    b32 UseFibers;
+    u32 FibersPerThread;
+    memory_arena *FiberStackArena;
+
+    std::atomic<b32> Running;
+    std::atomic<i32> SleepingCount;
+    job_semaphore WakeSemaphore;
+};
+
+static job_system_state JobSystem;
+static thread_local u32 JobThreadIndex = 0;
+// NOTE: Only the main thread and the workers own a deque.
+static thread_local b32 JobThreadOwnsDeque = false;
+static thread_local u32 JobThreadRandom = 0;
+
+static void
+ExecuteJob(const job &Job)
+{
+    if(Job.Queue != nullptr)
+    {
+        Job.QueueCallback(Job.Queue, Job.Args);
+    }
+    else
+    {
+        Job.Entry(Job.Args);
+    }
+
+    if(Job.Counter != nullptr)
+    {
+        Job.Counter->Value.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+static
+JOB_FIBER_PROC(JobFiberMain)
+{
+    job_fiber *Fiber = (job_fiber *)Param;
+    job_thread_state *Thread = JobSystem.ThreadStates + Fiber->ThreadIndex;
+    for(;;)
+    {
+        ExecuteJob(Fiber->Job);
+        Fiber->Finished = true;
+        JobFiberSwitch(&Fiber->Context, &Thread->SchedulerContext);
+    }
+}
+
+// NOTE: The thread frame arena is a stack, temporary memory has to end in the reverse order it began. Jobs which run
+// nested on the thread's stack keep that order by themselves, parked fibers do not: a fiber which parks in the middle
+// of its temporary memory has memory in the arena that the jobs running after it allocate on top of. So the fibers
+// which hold arena memory are resumed newest park first, the same order as if they had run nested, and the others
+// can be resumed in any order because they have nothing in the arena.
+static void
+JobFiberMarkArena(job_fiber *Fiber)
+{
+    memory_arena *Arena = FindThreadFrameArena();
+    Fiber->ArenaUsedAtStart = (Arena != nullptr) ? Arena->Used : 0;
+    Fiber->ArenaTempCountAtStart = (Arena != nullptr) ? Arena->TempMemoryCount : 0;
+}
+
+static b32
+JobFiberHoldsArena(const job_fiber *Fiber)
+{
+    memory_arena *Arena = FindThreadFrameArena();
+    b32 Result = (Arena != nullptr) && ((Arena->Used > Fiber->ArenaUsedAtStart) ||
+                                        (Arena->TempMemoryCount > Fiber->ArenaTempCountAtStart));
+    return Result;
+}
+
+static b32
+JobHasArenaHolderAbove(const job_thread_state *Thread, u64 ParkSequence)
+{
+    for(const job_fiber *Fiber = Thread->WaitingFibers; Fiber != nullptr; Fiber = Fiber->Next)
+    {
+        if(Fiber->HoldsArena && (Fiber->ParkSequence > ParkSequence))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// NOTE: Returns when the fiber finished its job or parked itself in JobSystem_Wait.
+static void
+JobRunFiber(job_thread_state *Thread, job_fiber *Fiber)
+{
+    ASSERT(Thread->CurrentFiber == nullptr);
+    Thread->CurrentFiber = Fiber;
+    JobFiberSwitch(&Thread->SchedulerContext, &Fiber->Context);
+    Thread->CurrentFiber = nullptr;
+
+    if(Fiber->Finished)
+    {
+        Fiber->Next = Thread->FreeFibers;
+        Thread->FreeFibers = Fiber;
+    }
+    else
+    {
+        Fiber->Next = Thread->WaitingFibers;
+        Thread->WaitingFibers = Fiber;
+    }
+}
+
+static b32
+JobSystemTakeJob(job *Job)
+{
+    u32 ThreadIndex = JobThreadIndex;
+    if(JobThreadOwnsDeque && JobSystem.Deques[ThreadIndex].Pop(Job))
+    {
+        return true;
+    }
+
+    // NOTE: Xorshift to pick where to start stealing, so the thieves do not all go after the same deque.
+    u32 Random = JobThreadRandom;
+    Random ^= Random << 13;
+    Random ^= Random >> 17;
+    Random ^= Random << 5;
+    JobThreadRandom = Random;
+
+    u32 ThreadCount = JobSystem.ThreadCount;
+    for(u32 i = 0; i < ThreadCount; ++i)
+    {
+        u32 Victim = (Random + i) % ThreadCount;
+        if(Victim != ThreadIndex && JobSystem.Deques[Victim].Steal(Job))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static b32
+JobSystemTryRunOne()
+{
+    job_thread_state *Thread = nullptr;
+    if(JobSystem.UseFibers && JobThreadOwnsDeque)
+    {
+        Thread = JobSystem.ThreadStates + JobThreadIndex;
+
+        // NOTE: Parked fibers whose counter is done go first, the jobs which started them are further along. A fiber
+        // holding arena memory has to wait for the ones which parked holding memory after it, see JobFiberMarkArena.
+        b32 HolderAbove = false;
+        for(job_fiber **Link = &Thread->WaitingFibers; *Link != nullptr; Link = &(*Link)->Next)
+        {
+            job_fiber *Fiber = *Link;
+            b32 CanResume = !Fiber->HoldsArena || (!HolderAbove && (Fiber->ParkSequence > Thread->ResumeFloor));
+            if(CanResume && JobSystem_IsDone(Fiber->WaitCounter))
+            {
+                *Link = Fiber->Next;
+                Fiber->WaitCounter = nullptr;
+                if(!Fiber->HoldsArena)
+                {
+                    JobFiberMarkArena(Fiber);
+                }
+                JobRunFiber(Thread, Fiber);
+                return true;
+            }
+            HolderAbove = HolderAbove || Fiber->HoldsArena;
+        }
+    }
+
+    job Job;
+    if(!JobSystemTakeJob(&Job))
+    {
+        return false;
+    }
+
+    if(Thread != nullptr && Thread->FreeFibers != nullptr)
+    {
+        job_fiber *Fiber = Thread->FreeFibers;
+        Thread->FreeFibers = Fiber->Next;
+        Fiber->Job = Job;
+        Fiber->Finished = false;
+        Fiber->HoldsArena = false;
+        JobFiberMarkArena(Fiber);
+        JobRunFiber(Thread, Fiber);
+    }
+    else
+    {
+        ExecuteJob(Job);
+    }
+
+    return true;
+}
+
+static b32
+JobSystemHasQueuedJobs()
+{
+    for(u32 i = 0; i < JobSystem.ThreadCount; ++i)
+    {
+        if(!JobSystem.Deques[i].IsEmpty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void
+JobThreadStartFibers(u32 ThreadIndex)
+{
+    if(JobSystem.UseFibers)
+    {
+        job_thread_state *Thread = JobSystem.ThreadStates + ThreadIndex;
+        Thread->ConvertedThread = JobFiberConvertThread(&Thread->SchedulerContext);
+    }
+}
+
+static void
+JobThreadStopFibers(u32 ThreadIndex)
+{
+    job_thread_state *Thread = JobSystem.ThreadStates + ThreadIndex;
+    ASSERT(Thread->WaitingFibers == nullptr);
+    if(Thread->ConvertedThread)
+    {
+        JobFiberRevertThread();
+        Thread->ConvertedThread = false;
+    }
+}
+
+static
+JOB_THREAD_PROC(JobWorkerProc)
+{
+    JobThreadIndex = (u32)(uintptr_t)Param;
+    JobThreadOwnsDeque = true;
+    JobThreadRandom = 0x9E3779B9u * (JobThreadIndex + 1);
+    JobThreadStartFibers(JobThreadIndex);
+
+    // NOTE: A worker with parked fibers is the only one which can resume them, it keeps going until they are done.
+    job_thread_state *Thread = JobSystem.ThreadStates + JobThreadIndex;
+    u32 Spins = 0;
+    while(JobSystem.Running.load(std::memory_order_acquire) || Thread->WaitingFibers != nullptr)
+    {
+        if(JobSystemTryRunOne())
+        {
+            Spins = 0;
+            continue;
+        }
+
+        if(++Spins < JOB_WORKER_SPIN_COUNT || Thread->WaitingFibers != nullptr)
+        {
+            JOB_SPIN_PAUSE();
+            continue;
+        }
+
+        // NOTE: Says it is going to sleep before the last look for work. JobSystem_Run pushes before it checks for
+        // sleepers, so either this sees the job or Run sees this worker and wakes it up.
+        JobSystem.SleepingCount.fetch_add(1, std::memory_order_seq_cst);
+        if(!JobSystemHasQueuedJobs() && JobSystem.Running.load(std::memory_order_seq_cst))
+        {
+            JobSemaphoreWait(&JobSystem.WakeSemaphore);
+        }
+        JobSystem.SleepingCount.fetch_sub(1, std::memory_order_seq_cst);
+        Spins = 0;
+    }
+
+    JobThreadStopFibers(JobThreadIndex);
+    return 0;
+}
+
+static void
+JobCreateFibers(u32 ThreadIndex, u32 FiberCount, u32 StackSize)
+{
+    job_thread_state *Thread = JobSystem.ThreadStates + ThreadIndex;
+    Thread->Fibers = (job_fiber *)malloc(sizeof(job_fiber) * FiberCount);
+    ASSERT(Thread->Fibers != nullptr);
+    SHU_MEMZERO(Thread->Fibers, sizeof(job_fiber) * FiberCount);
+
+    for(u32 i = 0; i < FiberCount; ++i)
+    {
+        job_fiber *Fiber = Thread->Fibers + i;
+        Fiber->ThreadIndex = ThreadIndex;
+        Fiber->Finished = true;
+        JobFiberCreate(&Fiber->Context, StackSize, JobSystem.FiberStackArena, Fiber);
+        Fiber->Next = Thread->FreeFibers;
+        Thread->FreeFibers = Fiber;
+    }
+}
+
+static void
+JobDestroyFibers(u32 ThreadIndex)
+{
+    job_thread_state *Thread = JobSystem.ThreadStates + ThreadIndex;
+    if(Thread->Fibers != nullptr)
+    {
+        for(u32 i = 0; i < JobSystem.FibersPerThread; ++i)
+        {
+            JobFiberDestroy(&Thread->Fibers[i].Context, JobSystem.FiberStackArena);
+        }
+        free(Thread->Fibers);
+    }
+    *Thread = {};
+}
+
+void
+JobSystem_Initialize(const job_system_config &Config)
+{
+    ASSERT(!JobSystem.Running.load());
+
+    u32 WorkerCount = Config.WorkerCount;
+    if(WorkerCount == 0)
+    {
+        u32 HardwareThreads = JobGetHardwareThreadCount();
+        WorkerCount = (HardwareThreads > 1) ? (HardwareThreads - 1) : 1;
+    }
+    WorkerCount = MIN(WorkerCount, (u32)(JOB_SYSTEM_MAX_THREADS - 1));
+
+    JobSystem.ThreadCount = WorkerCount + 1;
+    JobSystem.UseFibers = Config.UseFibers && (Config.FibersPerThread > 0);
+    JobSystem.FibersPerThread = JobSystem.UseFibers ? Config.FibersPerThread : 0;
+    JobSystem.FiberStackArena = Config.FiberStackArena;
+    for(u32 i = 0; i < JobSystem.ThreadCount; ++i)
+    {
+        JobSystem.Deques[i].Initialize();
+        JobSystem.ThreadStates[i] = {};
+        if(JobSystem.UseFibers)
+        {
+            JobCreateFibers(i, JobSystem.FibersPerThread, Config.FiberStackSize);
+        }
+    }
+    JobSystem.SleepingCount.store(0);
+    JobSemaphoreCreate(&JobSystem.WakeSemaphore);
+    JobSystem.Running.store(true, std::memory_order_release);
+
+    // NOTE: The thread which initializes the job system is the main thread.
+    JobThreadIndex = 0;
+    JobThreadOwnsDeque = true;
+    JobThreadRandom = 0x9E3779B9u;
+    JobThreadStartFibers(0);
+
+    for(u32 i = 1; i < JobSystem.ThreadCount; ++i)
+    {
+        JobThreadCreate(JobSystem.Threads + i, JobWorkerProc, (void *)(uintptr_t)i);
+    }
+
+    if(JobSystem.UseFibers)
+    {
+        LogInfo("[Job System]: Started %u workers with %u fibers each.\n", WorkerCount, JobSystem.FibersPerThread);
+    }
+    else
+    {
+        LogInfo("[Job System]: Started %u workers.\n", WorkerCount);
+    }
+}
+
+void
+JobSystem_Initialize(u32 WorkerCount)
+{
+    job_system_config Config;
+    Config.WorkerCount = WorkerCount;
+    JobSystem_Initialize(Config);
+}
+
+void
+JobSystem_Shutdown()
+{
+    if(!JobSystem.Running.load())
+        return;
+
+    // NOTE: Finish whatever is left on this thread's deque and its parked fibers, the workers finish the jobs they are
+    // running and their own parked fibers.
+    job_thread_state *MainThread = JobSystem.ThreadStates + 0;
+    while(JobSystemTryRunOne() || MainThread->WaitingFibers != nullptr) {}
+
+    JobSystem.Running.store(false, std::memory_order_seq_cst);
+    JobSemaphorePost(&JobSystem.WakeSemaphore, JobSystem.ThreadCount);
+    for(u32 i = 1; i < JobSystem.ThreadCount; ++i)
+    {
+        JobThreadJoin(JobSystem.Threads + i);
+    }
+    JobThreadStopFibers(0);
+
+    for(u32 i = 0; i < JobSystem.ThreadCount; ++i)
+    {
+        JobSystem.Deques[i].Free();
+        JobDestroyFibers(i);
+    }
+    JobSemaphoreDestroy(&JobSystem.WakeSemaphore);
+    JobSystem.ThreadCount = 0;
+    JobSystem.UseFibers = false;
+    JobSystem.FibersPerThread = 0;
+    JobSystem.FiberStackArena = nullptr;
+    JobThreadOwnsDeque = false;
+}
+
+u32
+JobSystem_GetThreadCount()
+{
+    u32 Result = JobSystem.Running.load(std::memory_order_relaxed) ? JobSystem.ThreadCount : 1;
+    return Result;
+}
+
+u32
+JobSystem_GetThreadIndex()
+{
+    return JobThreadIndex;
+}
+
+static void
+JobSystemPush(const job &Job)
+{
+    if(Job.Counter != nullptr)
+    {
+        Job.Counter->Value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if(!JobThreadOwnsDeque || !JobSystem.Running.load(std::memory_order_relaxed))
+    {
+        ExecuteJob(Job);
+        return;
+    }
+
+    JobSystem.Deques[JobThreadIndex].Push(Job);
+}
+
+static void
+JobSystemWakeWorkers(u32 JobCount)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    i32 Sleeping = JobSystem.SleepingCount.load(std::memory_order_seq_cst);
+    if(Sleeping > 0)
+    {
+        JobSemaphorePost(&JobSystem.WakeSemaphore, MIN((u32)Sleeping, JobCount));
+    }
+}
+
+void
+JobSystem_Run(const job_decl *Jobs, u32 Count, job_counter *Counter)
+{
+    for(u32 i = 0; i < Count; ++i)
+    {
+        job Job = {};
+        Job.Entry = Jobs[i].Entry;
+        Job.Args = Jobs[i].Args;
+        Job.Counter = Counter;
+        JobSystemPush(Job);
+    }
+    JobSystemWakeWorkers(Count);
+}
+
+void
+JobSystem_Run(job_entry *Entry, void *Args, job_counter *Counter)
+{
+    job_decl Decl = {Entry, Args};
+    JobSystem_Run(&Decl, 1, Counter);
+}
+
+void
+JobSystem_Wait(job_counter *Counter)
+{
+    job_thread_state *Thread = nullptr;
+    if(JobSystem.UseFibers && JobThreadOwnsDeque)
+    {
+        Thread = JobSystem.ThreadStates + JobThreadIndex;
+        job_fiber *Fiber = Thread->CurrentFiber;
+        if(Fiber != nullptr)
+        {
+            if(JobSystem_IsDone(Counter))
+            {
+                return;
+            }
+
+            // NOTE: Parks the fiber and goes back to the scheduler, which resumes it here once the counter is done.
+            Fiber->WaitCounter = Counter;
+            Fiber->HoldsArena = JobFiberHoldsArena(Fiber);
+            Fiber->ParkSequence = ++Thread->ParkCount;
+            JobFiberSwitch(&Fiber->Context, &Thread->SchedulerContext);
+            ASSERT(JobSystem_IsDone(Counter));
+            return;
+        }
+    }
+
+    // NOTE: Not on a fiber, the jobs run on top of this one. The fibers which park holding arena memory in the
+    // meantime have it on top of this job's memory, so this does not return before they are done with it.
+    u64 OldResumeFloor = 0;
+    if(Thread != nullptr)
+    {
+        OldResumeFloor = Thread->ResumeFloor;
+        Thread->ResumeFloor = Thread->ParkCount;
+    }
+
+    while(!JobSystem_IsDone(Counter) || ((Thread != nullptr) && JobHasArenaHolderAbove(Thread, Thread->ResumeFloor)))
+    {
+        if(!JobSystemTryRunOne())
+        {
+            JOB_SPIN_PAUSE();
+        }
+    }
+
+    if(Thread != nullptr)
+    {
+        Thread->ResumeFloor = OldResumeFloor;
+    }
+}
+
+void
+Platform_AddWorkEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
+{
+    job Job = {};
+    Job.QueueCallback = Callback;
+    Job.Args = Data;
+    Job.Queue = Queue;
+    Job.Counter = &Queue->Counter;
+    JobSystemPush(Job);
+    JobSystemWakeWorkers(1);
+}
+
+void
+Platform_CompleteAllWork(platform_work_queue *Queue)
+{
+    JobSystem_Wait(&Queue->Counter);
+}
+
+#if _SHU_DEBUG
+struct job_test_node
+{
+    job_counter *Done;
+    std::atomic<i32> *Sum;
+    i32 Depth;
+};
+
+// NOTE: Every job starts two more until the depth runs out and waits for them, so the waits nest.
+static
+JOB_ENTRY(JobTestTree)
+{
+    job_test_node *Node = (job_test_node *)Args;
+    Node->Sum->fetch_add(1, std::memory_order_relaxed);
+    if(Node->Depth == 0)
+    {
+        return;
+    }
+
+    job_counter Children;
+    job_test_node ChildNodes[2] = {{nullptr, Node->Sum, Node->Depth - 1}, {nullptr, Node->Sum, Node->Depth - 1}};
+    job_decl Jobs[2] = {{JobTestTree, ChildNodes + 0}, {JobTestTree, ChildNodes + 1}};
+    JobSystem_Run(Jobs, 2, &Children);
+    JobSystem_Wait(&Children);
+}
+
+struct job_test_arena_node
+{
+    std::atomic<i32> *Failures;
+    i32 Depth;
+    u32 Seed;
+};
+
+// NOTE: Keeps thread frame temporary memory open while it waits on its children, the memory has to be the same when
+// the wait returns.
+static
+JOB_ENTRY(JobTestArenaTree)
+{
+    job_test_arena_node *Node = (job_test_arena_node *)Args;
+    temporary_memory TempMemory = BeginTemporaryMemory(GetArena(MEMTYPE_THREADFRAME));
+    u32 Count = 16 + (Node->Seed & 127);
+    u32 *Values = ShuAllocateArray(u32, Count, MEMTYPE_THREADFRAME);
+    for(u32 i = 0; i < Count; ++i)
+    {
+        Values[i] = Node->Seed * (i + 1);
+    }
+
+    if(Node->Depth > 0)
+    {
+        job_counter Children;
+        job_test_arena_node ChildNodes[2] = {{Node->Failures, Node->Depth - 1, Node->Seed * 2 + 1},
+                                             {Node->Failures, Node->Depth - 1, Node->Seed * 2 + 2}};
+        job_decl Jobs[2] = {{JobTestArenaTree, ChildNodes + 0}, {JobTestArenaTree, ChildNodes + 1}};
+        JobSystem_Run(Jobs, 2, &Children);
+        JobSystem_Wait(&Children);
+    }
+
+    for(u32 i = 0; i < Count; ++i)
+    {
+        if(Values[i] != Node->Seed * (i + 1))
+        {
+            Node->Failures->fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    EndTemporaryMemory(TempMemory);
+}
+
+static
+PLATFORM_WORK_QUEUE_CALLBACK(JobTestQueueWork)
+{
+    ((std::atomic<i32> *)Args)->fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+job_system_test()
+{
+    // NOTE: Nested waits. 2^(Depth+1) - 1 jobs.
+    std::atomic<i32> Sum{0};
+    job_test_node Root = {nullptr, &Sum, 12};
+    job_counter Counter;
+    JobSystem_Run(JobTestTree, &Root, &Counter);
+    JobSystem_Wait(&Counter);
+    ASSERT(Sum.load() == (1 << 13) - 1);
+
+    // NOTE: Nested waits with thread frame temporary memory open. Needs the memory to be initialized.
+    if(FindThreadFrameArena() != nullptr)
+    {
+        std::atomic<i32> Failures{0};
+        job_test_arena_node ArenaRoot = {&Failures, 10, 1};
+        memory_arena *Arena = GetArena(MEMTYPE_THREADFRAME);
+        size_t UsedBefore = Arena->Used;
+        JobSystem_Run(JobTestArenaTree, &ArenaRoot, &Counter);
+        JobSystem_Wait(&Counter);
+        ASSERT(Failures.load() == 0);
+        ASSERT(Arena->Used == UsedBefore);
+    }
+
+    // NOTE: More jobs than the initial deque capacity, so the deque has to grow.
+    std::atomic<i32> QueueSum{0};
+    platform_work_queue Queue = {};
+    for(i32 i = 0; i < JOB_DEQUE_INITIAL_CAPACITY * 4; ++i)
+    {
+        Platform_AddWorkEntry(&Queue, JobTestQueueWork, &QueueSum);
+    }
+    Platform_CompleteAllWork(&Queue);
+    ASSERT(QueueSum.load() == JOB_DEQUE_INITIAL_CAPACITY * 4);
+
+    const i32 Count = 100000;
+    i32 *Values = (i32 *)malloc(sizeof(i32) * Count);
+    JobSystem_ParallelFor(Count, 64, [Values](i32 First, i32 Last) {
+        for(i32 i = First; i < Last; ++i) { Values[i] = i * 3; }
+    });
+    for(i32 i = 0; i < Count; ++i)
+    {
+        ASSERT(Values[i] == i * 3);
+    }
+    free(Values);
+
+    LogInfo("[Job System Test]: Passed on %u threads.\n", JobSystem_GetThreadCount());
+}
+#endif
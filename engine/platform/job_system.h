@@ -0,0 +1,137 @@
+#if !defined(JOB_SYSTEM_H)
+
+#include <defines.h>
+#include "platform.h"
+
+#include <atomic>
+
+// NOTE: The main thread plus the workers. Every thread gets a thread frame arena, so this matches
+// MAX_THREAD_ARENA_COUNT in memory.h.
+#define JOB_SYSTEM_MAX_THREADS 16
+#define JOB_DEQUE_INITIAL_CAPACITY 1024
+#define JOB_PARALLEL_FOR_MAX_BATCHES 256
+// NOTE: ParallelFor aims for this many batches per thread, so that the threads which finish early can steal the rest.
+#define JOB_PARALLEL_FOR_BATCHES_PER_THREAD 4
+#define JOB_DEFAULT_FIBERS_PER_THREAD 32
+#define JOB_DEFAULT_FIBER_STACK_SIZE KILOBYTES(128)
+
+struct memory_arena;
+
+#define JOB_ENTRY(name) void name(void *Args)
+typedef JOB_ENTRY(job_entry);
+
+// NOTE: Counts the jobs which have been started with it and are not done yet. A job can wait on the counter of
+// other jobs, which is how dependencies between jobs are expressed.
+struct job_counter
+{
+    std::atomic<i32> Value{0};
+};
+
+struct job_decl
+{
+    job_entry *Entry;
+    void *Args;
+};
+
+// NOTE: Platform_AddWorkEntry/Platform_CompleteAllWork run on the job system, a queue is just the counter of the
+// work added to it.
+struct platform_work_queue
+{
+    job_counter Counter;
+};
+
+// NOTE: Every thread has its own deque of jobs. A thread pushes and pops its own jobs at the bottom(newest first,
+// which keeps the data in cache) and steals the oldest jobs from the top of the other deques when it runs out.
+// Only the owner pushes and pops, anyone can steal, there are no locks. Jobs pushed from threads which are not the
+// main thread or a worker run right away on that thread.
+struct job_system_config
+{
+    // NOTE: 0 uses one worker per hardware thread, minus the main thread.
+    u32 WorkerCount = 0;
+
+    // NOTE: Runs the jobs on fibers. A job which waits on a counter parks its fiber and the thread goes on with other
+    // jobs, instead of running them on top of the waiting job's stack. Every thread has a pool of FibersPerThread
+    // fibers, a job which finds the pool empty runs on the thread's own stack like it does without fibers.
+    b32 UseFibers = false;
+    u32 FibersPerThread = JOB_DEFAULT_FIBERS_PER_THREAD;
+    u32 FiberStackSize = JOB_DEFAULT_FIBER_STACK_SIZE;
+    // NOTE: The fiber stacks come from here if it is set, malloc otherwise. Win32 fibers always allocate their own
+    // stack, so it is not used there.
+    memory_arena *FiberStackArena = nullptr;
+};
+
+void JobSystem_Initialize(const job_system_config &Config = job_system_config{});
+void JobSystem_Initialize(u32 WorkerCount);
+void JobSystem_Shutdown();
+
+// NOTE: Main thread plus workers, 1 if the job system is not running.
+u32 JobSystem_GetThreadCount();
+// NOTE: 0 for the main thread, 1..N for the workers.
+u32 JobSystem_GetThreadIndex();
+
+// NOTE: Counter can be null for fire and forget jobs.
+void JobSystem_Run(const job_decl *Jobs, u32 Count, job_counter *Counter);
+void JobSystem_Run(job_entry *Entry, void *Args, job_counter *Counter);
+
+// NOTE: Runs other jobs until the counter gets to zero, so a job can wait on the jobs it started without
+// deadlocking the workers. A job running on a fiber parks the fiber instead and is resumed on the same thread. Jobs
+// can keep MEMTYPE_THREADFRAME temporary memory open across a wait, the fibers holding some of it are resumed in
+// the reverse order they parked in.
+void JobSystem_Wait(job_counter *Counter);
+inline b32 JobSystem_IsDone(const job_counter *Counter) { return Counter->Value.load(std::memory_order_acquire) <= 0; }
+
+template <typename fn>
+struct job_parallel_for_batch
+{
+    const fn *Body;
+    i32 First;
+    i32 Last;
+};
+
+template <typename fn>
+JOB_ENTRY(JobParallelForBatch)
+{
+    job_parallel_for_batch<fn> *Batch = (job_parallel_for_batch<fn> *)Args;
+    (*Batch->Body)(Batch->First, Batch->Last);
+}
+
+// NOTE: Calls Body(First, Last) over batches of [0, Count) on all the threads and returns when they are all done.
+// Batches have at least MinBatchSize items. The calling thread runs the first batch itself.
+template <typename fn>
+void
+JobSystem_ParallelFor(i32 Count, i32 MinBatchSize, const fn &Body)
+{
+    if(Count <= 0)
+        return;
+
+    i32 MaxBatches = MIN((i32)(JobSystem_GetThreadCount() * JOB_PARALLEL_FOR_BATCHES_PER_THREAD),
+                         JOB_PARALLEL_FOR_MAX_BATCHES);
+    i32 BatchSize = MAX(MAX(MinBatchSize, 1), (Count + MaxBatches - 1) / MaxBatches);
+    i32 BatchCount = (Count + BatchSize - 1) / BatchSize;
+    if(BatchCount <= 1)
+    {
+        Body(0, Count);
+        return;
+    }
+
+    // NOTE: This waits for all of the batches, so they can live on the stack.
+    job_parallel_for_batch<fn> Batches[JOB_PARALLEL_FOR_MAX_BATCHES];
+    job_decl Jobs[JOB_PARALLEL_FOR_MAX_BATCHES];
+    for(i32 i = 0; i < BatchCount; ++i)
+    {
+        Batches[i] = {&Body, i * BatchSize, MIN((i + 1) * BatchSize, Count)};
+        Jobs[i] = {JobParallelForBatch<fn>, Batches + i};
+    }
+
+    job_counter Counter;
+    JobSystem_Run(Jobs + 1, BatchCount - 1, &Counter);
+    Body(Batches[0].First, Batches[0].Last);
+    JobSystem_Wait(&Counter);
+}
+
+#if _SHU_DEBUG
+void job_system_test();
+#endif
+
+#define JOB_SYSTEM_H
+#endif // JOB_SYSTEM_H
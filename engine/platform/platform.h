@@ -101,6 +101,14 @@ struct platform_read_file_result
     u8 *Data;
 };
 
+// NOTE: A file mapped into memory copy on write. Nothing is read until the pages are touched, and writing to them
+// only changes this process' copy.
+struct platform_mapped_file
+{
+    void *Data;
+    u64 Size;
+};
+
 SHU_EXPORT void LogOutput(LogType LogType, const char *Format, ...);
 SHU_EXPORT void LogInfo(const char *Format, ...);
 SHU_EXPORT void LogDebug(const char *Format, ...);
@@ -127,12 +135,18 @@ SHU_EXPORT u32 Platform_GetRandomSeed();
 SHU_EXPORT platform_read_file_result Platform_ReadFile(const char *Path);
 SHU_EXPORT void Platform_FreeFileMemory(platform_read_file_result *File);
 SHU_EXPORT b32 Platform_WriteFile(char *Filename, u32 Size, void *Data);
+SHU_EXPORT platform_mapped_file Platform_MapFile(const char *Path);
+SHU_EXPORT void Platform_UnmapFile(platform_mapped_file *File);
 
 SHU_EXPORT void Platform_ExitApplication(const char *Reason);
 SHU_EXPORT void Platform_Sleep(u32 ms);
+SHU_EXPORT u64 Platform_GetWallClock();
+SHU_EXPORT f32 Platform_GetSecondsElapsed(u64 Start, u64 End);
 SHU_EXPORT b8 Platform_GetKeyInputState(u8 KeyCode, KeyState State);
 SHU_EXPORT void Platform_ToggleFPSCap();
 SHU_EXPORT void Platform_SetFPS(i32 FPS);
+// NOTE: 0 for the main thread, 1..N for the worker threads of the work queues. Stays the same for the whole run.
+SHU_EXPORT u32 Platform_GetThreadIndex();
 
 #define PLATFORM_WORK_QUEUE_CALLBACK(name) void name(platform_work_queue *Queue, void *Args)
 typedef PLATFORM_WORK_QUEUE_CALLBACK(platform_work_queue_callback);
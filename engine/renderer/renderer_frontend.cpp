@@ -1,4 +1,5 @@
 #include "renderer/renderer_frontend.h"
+#include "memory/memory.h"
 
 #if defined(SHU_RENDERER_BACKEND_VULKAN)
 #include "renderer/vulkan/vulkan_renderer.h"
@@ -24,6 +25,9 @@ InitializeRenderer(shoora_platform_app_info *AppInfo)
 void
 DrawFrame(shoora_platform_frame_packet *FramePacket)
 {
+    // NOTE: Nothing from last frame is in flight on the work queues at this point.
+    ResetThreadFrameArenas();
+
 #if defined(SHU_RENDERER_BACKEND_VULKAN)
     DrawFrameInVulkan(FramePacket);
 #else
@@ -3,9 +3,11 @@
 #include <utils/utils.h>
 #include <physics/collision.h>
 #include <physics/contact.h>
+#include <physics/determinism.h>
 #include <renderer/vulkan/graphics/vulkan_graphics.h>
 
 #include <memory/memory.h>
+#include <platform/platform.h>
 
 #ifdef WIN32
 #include "platform/windows/win_platform.h"
@@ -13,7 +15,7 @@
 
 static b32 MouseTracking = false;
 static shu::vec2f MouseInitialDownPos = shu::Vec2f(0);
-static shoora_body *BodyToMove = nullptr;
+static body_handle BodyToMove = {};
 
 struct scene_shader_data
 {
@@ -39,6 +41,8 @@ shoora_scene::shoora_scene()
 shoora_scene::~shoora_scene()
 {
     LogWarnUnformatted("shoora scene destructor called!\n");
+    Queries.Free();
+    Transforms.Free();
 
 #if 0
     size_t constraintsCount = Constraints2D.size();
@@ -56,30 +60,25 @@ shoora_scene::AddMeshToScene(const shu::vec3f *vPositions, u32 vCount)
 }
 
 #if 0
-shoora_body *
+body_handle
 shoora_scene::AddBody(const shoora_body &Body)
 {
-    Bodies.emplace_back(std::move(Body));
-
-    shoora_body *b = Bodies.get(Bodies.size() - 1);
-    return b;
+    return Bodies.Add(Body);
 }
 #endif
 
 // TODO: Make AddBody Thread Safe.
-shoora_body *
+body_handle
 shoora_scene::AddBody(shoora_body &&Body)
 {
-    // ASSERT(!"Not tested!");
-    Bodies.emplace_back((shoora_body &&)Body);
+    body_handle Handle = Bodies.Emplace((shoora_body &&)Body);
+    ++this->StructureVersion;
+    this->TransformsStale = true;
 
-    // TODO: if the body array gets moved to a new area of memory, whoever received this pointer will have old
-    // data.
-    shoora_body *b = Bodies.get(Bodies.size() - 1);
-    return b;
+    return Handle;
 }
 
-shoora_body *
+body_handle
 shoora_scene::AddCubeBody(const shu::vec3f &Pos, const shu::vec3f &Scale, u32 ColorU32, f32 Mass,
                           f32 Restitution, const shu::vec3f &EulerAngles)
 {
@@ -88,15 +87,10 @@ shoora_scene::AddCubeBody(const shu::vec3f &Pos, const shu::vec3f &Scale, u32 Co
     SHU_MEMCOPY(&shape, CubeShape, sizeof(shoora_shape_cube));
 
     shoora_body Body{GetColor(ColorU32), Pos, Mass, Restitution, CubeShape, EulerAngles};
-    Bodies.emplace_back(std::move(Body));
-
-    // TODO: if the body array gets moved to a new area of memory, whoever received this pointer will have old
-    // data.
-    shoora_body *b = Bodies.get(Bodies.size() - 1);
-    return b;
+    return AddBody(std::move(Body));
 }
 
-shoora_body *
+body_handle
 shoora_scene::AddSphereBody(const shu::vec3f &Pos, u32 ColorU32, f32 Radius, f32 Mass, f32 Restitution,
                             const shu::vec3f &EulerAngles)
 {
@@ -104,15 +98,10 @@ shoora_scene::AddSphereBody(const shu::vec3f &Pos, u32 ColorU32, f32 Radius, f32
     new (SphereShape) shoora_shape_sphere(Radius);
 
     shoora_body Body{GetColor(ColorU32), Pos, Mass, Restitution, SphereShape, EulerAngles};
-    Bodies.emplace_back(std::move(Body));
-
-    // TODO: if the body array gets moved to a new area of memory, whoever received this pointer will have old
-    // data.
-    shoora_body *b = Bodies.get(Bodies.size() - 1);
-    return b;
+    return AddBody(std::move(Body));
 }
 
-shoora_body *
+body_handle
 shoora_scene::AddCircleBody(const shu::vec2f Pos, u32 ColorU32, f32 Radius, f32 Mass, f32 Restitution,
                             const shu::vec3f &EulerAngles)
 {
@@ -121,15 +110,10 @@ shoora_scene::AddCircleBody(const shu::vec2f Pos, u32 ColorU32, f32 Radius, f32
     SHU_MEMCOPY(&shape, CircleShape, sizeof(shoora_shape_circle));
 
     shoora_body Body{GetColor(ColorU32), shu::Vec3f(Pos, 1.0f), Mass, Restitution, CircleShape, EulerAngles};
-    Bodies.emplace_back(std::move(Body));
-
-    // TODO: if the body array gets moved to a new area of memory, whoever received this pointer will have old
-    // data.
-    shoora_body *b = Bodies.get(Bodies.size() - 1);
-    return b;
+    return AddBody(std::move(Body));
 }
 
-shoora_body *
+body_handle
 shoora_scene::AddDiamondBody(const shu::vec3f &Pos, const shu::vec3f &Scale, u32 ColorU32, f32 Mass,
                              f32 Restitution, const shu::vec3f &EulerAngles)
 {
@@ -154,15 +138,10 @@ shoora_scene::AddDiamondBody(const shu::vec3f &Pos, const shu::vec3f &Scale, u32
     DiamondShape->NumHullIndices = DiamondShape->MeshFilter->IndexCount;
 
     shoora_body Body{GetColor(ColorU32), Pos, Mass, Restitution, DiamondShape, EulerAngles};
-    Bodies.emplace_back(std::move(Body));
-
-    // TODO: if the body array gets moved to a new area of memory, whoever received this pointer will have old
-    // data.
-    shoora_body *b = Bodies.get(Bodies.size() - 1);
-    return b;
+    return AddBody(std::move(Body));
 }
 
-shoora_body *
+body_handle
 shoora_scene::AddBoxBody(const shu::vec2f Pos, u32 ColorU32, f32 Width, f32 Height, f32 Mass, f32 Restitution,
                          const shu::vec3f &EulerAngles)
 {
@@ -171,15 +150,10 @@ shoora_scene::AddBoxBody(const shu::vec2f Pos, u32 ColorU32, f32 Width, f32 Heig
     SHU_MEMCOPY(&shape, BoxShape, sizeof(shoora_shape_box));
 
     shoora_body Body{GetColor(ColorU32), shu::Vec3f(Pos, 1.0f), Mass, Restitution, BoxShape, EulerAngles};
-    Bodies.emplace_back(std::move(Body));
-
-    // TODO: if the body array gets moved to a new area of memory, whoever received this pointer will have old
-    // data.
-    shoora_body *b = Bodies.get(Bodies.size() - 1);
-    return b;
+    return AddBody(std::move(Body));
 }
 
-shoora_body *
+body_handle
 shoora_scene::AddPolygonBody(const u32 MeshId, const shu::vec2f Pos, u32 ColorU32, f32 Mass, f32 Restitution,
                              const shu::vec3f &EulerAngles, f32 Scale)
 {
@@ -188,12 +162,7 @@ shoora_scene::AddPolygonBody(const u32 MeshId, const shu::vec2f Pos, u32 ColorU3
     SHU_MEMCOPY(&shape, PolygonShape, sizeof(shoora_shape_polygon));
 
     shoora_body body{GetColor(ColorU32), shu::Vec3f(Pos, 1.0f), Mass, Restitution, PolygonShape, EulerAngles};
-    Bodies.emplace_back(std::move(body));
-
-    // TODO: if the body array gets moved to a new area of memory, whoever received this pointer will have old
-    // data.
-    shoora_body *b = Bodies.get(Bodies.size() - 1);
-    return b;
+    return AddBody(std::move(body));
 }
 
 #if 0
@@ -214,13 +183,14 @@ shoora_scene::UpdateInput(const shu::vec2f &CurrentMouseWorldPos)
                 {
                     MouseTracking = true;
                     MouseInitialDownPos = shu::ToVec2(Body->Position);
-                    BodyToMove = Body;
+                    BodyToMove = Bodies.GetHandle(BodyIndex);
                 }
             }
-            else if (BodyToMove != nullptr)
+            else if (shoora_body *Moving = Bodies.Get(BodyToMove))
             {
-                BodyToMove->Position = shu::Vec3f(CurrentMouseWorldPos, BodyToMove->Position.z);
-                BodyToMove->UpdateWorldVertices();
+                Moving->Position = shu::Vec3f(CurrentMouseWorldPos, Moving->Position.z);
+                Moving->UpdateWorldVertices();
+                MarkTransformsStale();
             }
         }
 
@@ -235,9 +205,8 @@ shoora_scene::UpdateInput(const shu::vec2f &CurrentMouseWorldPos)
 
     if (MouseTracking && Platform_GetKeyInputState(SU_LEFTMOUSEBUTTON, SHU_KEYSTATE_RELEASE))
     {
-        ASSERT(BodyToMove != nullptr);
         MouseTracking = false;
-        BodyToMove = nullptr;
+        BodyToMove = {};
     }
 }
 #endif
@@ -245,13 +214,33 @@ shoora_scene::UpdateInput(const shu::vec2f &CurrentMouseWorldPos)
 void
 shoora_scene::PhysicsUpdate(f32 dt, b32 DebugMode)
 {
-    // NOTE: If I am debugging, the frametime is going to be huge. So hence, clamping here.
-#if _SHU_DEBUG
-    if (dt > (1.0f / 29.0f))
+    u64 StepStartClock = Platform_GetWallClock();
+    const physics_settings &Settings = this->Settings;
+
+    u32 SavedFloatState = 0;
+    if (Settings.Deterministic)
     {
-        dt = (1.0f / 29.0f);
+        SavedFloatState = determinism::BeginFloatEnvironment();
     }
-#endif
+
+    if ((Settings.MaxDeltaTime > 0.0f) && (dt > Settings.MaxDeltaTime))
+    {
+        dt = Settings.MaxDeltaTime;
+    }
+
+    const i32 Substeps = MAX(Settings.Substeps, 1);
+    const i32 VelocityIterations = MAX(Settings.VelocityIterations, 1);
+    const i32 PositionIterations = MAX(Settings.PositionIterations, 0);
+    // NOTE: Substep delta time.
+    const f32 h = dt / (f32)Substeps;
+
+    physics_step_stats Stats = {};
+    Stats.StepCount = this->StepStats.StepCount + 1;
+    Stats.Substeps = Substeps;
+    Stats.VelocityIterations = VelocityIterations;
+    Stats.PositionIterations = PositionIterations;
+
+    ResolveBodyReferences();
     Manifolds.RemoveExpired();
 
     i32 BodyCount = GetBodyCount();
@@ -263,39 +252,35 @@ shoora_scene::PhysicsUpdate(f32 dt, b32 DebugMode)
     auto startPos = diamond->Position;
     shu::vec3f endPos, deltaPos;
 #endif
-    memory_arena *FrameArena = GetArena(MEMTYPE_FRAME);
+    memory_arena *FrameArena = GetArena(MEMTYPE_THREADFRAME);
     temporary_memory MemoryFlush = BeginTemporaryMemory(FrameArena);
 
     // TODO: Make this array Dynamic.
     penetration_constraint_3d PenetrationConstraints3D[32];
     i32 PenetrationConstraintCount = 0;
 
-    // Sum all the external forces to the body
-    for (i32 BodyIndex = 0; BodyIndex < BodyCount; ++BodyIndex)
-    {
-        ASSERT(BodyIndex < BodyCount);
-        shoora_body *Body = Bodies + BodyIndex;
-
-        shu::vec3f WeightForce = shu::Vec3f(0.0f, -9.8f * Body->Mass, 0.0f);
-        Body->AddForce(WeightForce);
-    }
-
-    // integrate the acceleration due to the above forces and calculate the velocity.
-    for (i32 BodyIndex = 0; BodyIndex < BodyCount; ++BodyIndex)
-    {
-        auto *b = Bodies + BodyIndex;
-        b->IntegrateForces(dt);
-    }
-
     // Broadphase
-    collision_pair *CollisionPairs = ShuAllocateArray(collision_pair, BodyCount * BodyCount, MEMTYPE_FRAME);
+    u64 PhaseStartClock = Platform_GetWallClock();
+    collision_pair *CollisionPairs = ShuAllocateArray(collision_pair, BodyCount * BodyCount, MEMTYPE_THREADFRAME);
     SHU_MEMZERO(CollisionPairs, BodyCount * BodyCount * sizeof(collision_pair));
     i32 FinalPairsCount = 0;
 
+    // NOTE: The transforms from the end of the last step are where the bodies are now, unless something changed
+    // the bodies in between.
+    if (this->TransformsStale || (this->Transforms.Count != BodyCount))
+    {
+        UpdateTransforms();
+    }
+    shoora_bounds *SweptBounds = ShuAllocateArray(shoora_bounds, BodyCount, MEMTYPE_THREADFRAME);
+
     // shoora_dynamic_array<collision_pair> CollisionPairs{MEMTYPE_FREELISTGLOBAL};
     // CollisionPairs.reserve(BodyCount*BodyCount);
-    broad_phase::BroadPhase(Bodies, BodyCount, CollisionPairs, FinalPairsCount, dt);
+    broad_phase::BroadPhase(Bodies, this->Transforms.WorldBounds, BodyCount, CollisionPairs, FinalPairsCount, dt,
+                            Settings.Deterministic, SweptBounds);
+    Stats.PairCount = FinalPairsCount;
+    Stats.BroadPhaseMs = 1000.0f * Platform_GetSecondsElapsed(PhaseStartClock, Platform_GetWallClock());
 
+    PhaseStartClock = Platform_GetWallClock();
     i32 NumContacts = 0;
     const int MaxContacts = BodyCount * BodyCount;
 
@@ -315,6 +300,11 @@ shoora_scene::PhysicsUpdate(f32 dt, b32 DebugMode)
         {
             continue;
         }
+        // NOTE: The broadphase only compares the bounds along one axis.
+        if (!SweptBounds[Pair.A].DoesIntersect(SweptBounds[Pair.B]))
+        {
+            continue;
+        }
 
         // TODO: No need for MaxContactCounts here since Contact Manifolds have been added.
         contact _Contacts[MaxContactCountPerPair];
@@ -345,7 +335,7 @@ shoora_scene::PhysicsUpdate(f32 dt, b32 DebugMode)
                 ASSERT(PenetrationConstraintCount <= 30);
                 PenetrationConstraints3D[PenetrationConstraintCount++] = PenConstraint;
 #endif
-                Manifolds.AddContact(Contact);
+                Manifolds.AddContact(Contact, this->Bodies);
             }
             else
             {
@@ -364,144 +354,201 @@ shoora_scene::PhysicsUpdate(f32 dt, b32 DebugMode)
     // NOTE: Sort the timeofImpacts from earliest to latest.
     if (NumContacts > 1)
     {
-        QuicksortRecursive(Contacts, 0, NumContacts, CompareContacts);
+        // NOTE: Radix sort is stable, so contacts with the same toi stay in the pair order.
+        contact *Scratch = ShuAllocateArray(contact, NumContacts, MEMTYPE_THREADFRAME);
+        RadixSort(Contacts, Scratch, NumContacts,
+                  [](const contact &Item) { return FloatToSortableU32(Item.TimeOfImpact); });
     }
-
-    // NOTE: Solve Constraints
-    i32 NumConstraints = this->Constraints3D.size();
-    for (i32 i = 0; i < NumConstraints; ++i)
+    if (Settings.Deterministic)
     {
-        this->Constraints3D[i]->PreSolve(dt);
+        this->Manifolds.SortByBodies();
     }
+    Stats.NarrowPhaseMs = 1000.0f * Platform_GetSecondsElapsed(PhaseStartClock, Platform_GetWallClock());
+    Stats.ManifoldCount = this->Manifolds.Manifolds.size();
 
-#if 0
-    for (i32 i = 0; i < PenetrationConstraintCount; ++i)
+    i32 NumConstraints = this->Constraints3D.size();
+    // NOTE: The cached lambdas are damped once per step. Doing it in every PreSolve would make it
+    // WarmStartFactor^Substeps.
+    if (Settings.WarmStartFactor != 1.0f)
     {
-        PenetrationConstraints3D[i].PreSolve(dt);
+        for (i32 i = 0; i < NumConstraints; ++i)
+        {
+            this->Constraints3D[i]->ScaleCachedLambdas(Settings.WarmStartFactor);
+        }
+        this->Manifolds.ScaleCachedLambdas(Settings.WarmStartFactor);
     }
-#endif
-    this->Manifolds.PreSolve(dt);
 
-    const i32 NumIterations = 6;
-    for (i32 i = 0; i < NumIterations; ++i)
+    for (i32 SubstepIndex = 0; SubstepIndex < Substeps; ++SubstepIndex)
     {
-        for (i32 j = 0; j < NumConstraints; ++j)
+        // Sum all the external forces to the body and integrate the acceleration due to them to get the
+        // velocity.
+        PhaseStartClock = Platform_GetWallClock();
+        for (i32 BodyIndex = 0; BodyIndex < BodyCount; ++BodyIndex)
         {
-            this->Constraints3D[j]->Solve();
+            shoora_body *Body = Bodies + BodyIndex;
+
+            shu::vec3f WeightForce = Settings.Gravity * Body->Mass;
+            Body->AddForce(WeightForce);
+            Body->IntegrateForces(h);
+        }
+        Stats.IntegrateMs += 1000.0f * Platform_GetSecondsElapsed(PhaseStartClock, Platform_GetWallClock());
+
+        // NOTE: Solve Constraints
+        PhaseStartClock = Platform_GetWallClock();
+        for (i32 i = 0; i < NumConstraints; ++i)
+        {
+            this->Constraints3D[i]->BiasFactor = 1.0f;
+            this->Constraints3D[i]->PreSolve(h);
         }
+
 #if 0
         for (i32 i = 0; i < PenetrationConstraintCount; ++i)
         {
-            PenetrationConstraints3D[i].Solve();
+            PenetrationConstraints3D[i].PreSolve(h);
         }
 #endif
-        this->Manifolds.Solve();
-    }
+        this->Manifolds.SetBiasFactor(1.0f);
+        this->Manifolds.PreSolve(h);
 
-    for (i32 i = 0; i < NumConstraints; ++i)
-    {
-        this->Constraints3D[i]->PostSolve();
-    }
+        for (i32 i = 0; i < VelocityIterations; ++i)
+        {
+            for (i32 j = 0; j < NumConstraints; ++j)
+            {
+                this->Constraints3D[j]->Solve();
+            }
 #if 0
-    for (i32 i = 0; i < PenetrationConstraintCount; ++i)
-    {
-        PenetrationConstraints3D[i].PostSolve();
-    }
+            for (i32 i = 0; i < PenetrationConstraintCount; ++i)
+            {
+                PenetrationConstraints3D[i].Solve();
+            }
 #endif
-    this->Manifolds.PostSolve();
-
-    // NOTE: This is where we breakup the update routine for resolving the contacts.
-    // The toi's have been sorted above from earliest to latest. So the first contact in "Contacts" will have the
-    // shortest toi out of all of them. Whatever it is, we advance the bodies by that time(which is really the
-    // fraction of the current frame's deltaTime). so we advance all bodies by the first contact's toi. add that to
-    // the accumulatedTime. The next iteration, we have the next bigger toi. Since we already moved by the first
-    // toi, we subtract the first toi from the second toi and advance all the bodies in the contacts list by
-    // this difference amount. In the end, if there was "TimeRemaining" we advance all the bodies by that amount.
-    // IMPORTANT: NOTE: Why are we doing this?
-    // let's say there are three bodies that are colliding - A, B, C. A-B contact has the least toi, so it advances
-    // by that time. Since A and B collided, their post-collision velocities were such that B now should collide
-    // with C, which originally was colliding with A. We can potentially call IsColliding again to generate new
-    // contacts, but we are not doing that since that will be very expensive. But we atleast do the first collision
-    // handling correctly using Continuous Collision Detection data that we did earlier by only advancing the frame
-    // by toi instead of advancing by its Full DeltaTime which is in the dt variable passed to this function.
-    f32 AccumulatedTime = 0.0f;
+            this->Manifolds.Solve();
+        }
+        Stats.SolveMs += 1000.0f * Platform_GetSecondsElapsed(PhaseStartClock, Platform_GetWallClock());
+
+        PhaseStartClock = Platform_GetWallClock();
+        // NOTE: This is where we breakup the update routine for resolving the contacts.
+        // The toi's have been sorted above from earliest to latest. So the first contact in "Contacts" will have the
+        // shortest toi out of all of them. Whatever it is, we advance the bodies by that time(which is really the
+        // fraction of the current frame's deltaTime). so we advance all bodies by the first contact's toi. add that to
+        // the accumulatedTime. The next iteration, we have the next bigger toi. Since we already moved by the first
+        // toi, we subtract the first toi from the second toi and advance all the bodies in the contacts list by
+        // this difference amount. In the end, if there was "TimeRemaining" we advance all the bodies by that amount.
+        // IMPORTANT: NOTE: Why are we doing this?
+        // let's say there are three bodies that are colliding - A, B, C. A-B contact has the least toi, so it advances
+        // by that time. Since A and B collided, their post-collision velocities were such that B now should collide
+        // with C, which originally was colliding with A. We can potentially call IsColliding again to generate new
+        // contacts, but we are not doing that since that will be very expensive. But we atleast do the first collision
+        // handling correctly using Continuous Collision Detection data that we did earlier by only advancing the frame
+        // by toi instead of advancing by its Full DeltaTime which is in the dt variable passed to this function.
+        // NOTE: The time of impacts are calculated against the full dt, so this only works when there is a single
+        // substep.
+        f32 AccumulatedTime = 0.0f;
 #if ENABLE_CCD
-    for (i32 i = 0; i < NumContacts; ++i)
-    {
-        contact &Contact = Contacts[i];
-        LogWarn("toi: %f.\n", Contact.TimeOfImpact);
-        const f32 local_dt = Contact.TimeOfImpact - AccumulatedTime;
+        for (i32 i = 0; (Substeps == 1) && (i < NumContacts); ++i)
+        {
+            contact &Contact = Contacts[i];
+            LogWarn("toi: %f.\n", Contact.TimeOfImpact);
+            const f32 local_dt = Contact.TimeOfImpact - AccumulatedTime;
 
-        shoora_body *BodyA = Contact.ReferenceBodyA;
-        shoora_body *BodyB = Contact.IncidentBodyB;
+            shoora_body *BodyA = Contact.ReferenceBodyA;
+            shoora_body *BodyB = Contact.IncidentBodyB;
 
-        if (BodyA->IsStatic() && BodyB->IsStatic())
-        {
-            continue;
-        }
+            if (BodyA->IsStatic() && BodyB->IsStatic())
+            {
+                continue;
+            }
 
-        // Velocity + Position Update.
-        for (i32 j = 0; j < BodyCount; ++j)
-        {
-            auto *b = Bodies + j;
-            b->Update(local_dt);
+            // Velocity + Position Update.
+            for (i32 j = 0; j < BodyCount; ++j)
+            {
+                auto *b = Bodies + j;
+                b->Update(local_dt);
 #if 0
-            if(b == diamond)
+                if(b == diamond)
+                {
+                    endPos = diamond->Position;
+                    deltaPos = endPos - startPos;
+                    LogInfo("1. delta Magnitude: %f.\n", deltaPos.SqMagnitude());
+                }
+#endif
+            }
+
+            Contact.ResolveCollision();
+#if 0
+            if (Contact.ReferenceBodyA == diamond || Contact.IncidentBodyB == diamond)
             {
                 endPos = diamond->Position;
                 deltaPos = endPos - startPos;
-                LogInfo("1. delta Magnitude: %f.\n", deltaPos.SqMagnitude());
+                LogFatal("2. delta Magnitude: %f.\n", deltaPos.SqMagnitude());
             }
 #endif
-        }
-
-        Contact.ResolveCollision();
-#if 0
-        if (Contact.ReferenceBodyA == diamond || Contact.IncidentBodyB == diamond)
-        {
-            endPos = diamond->Position;
-            deltaPos = endPos - startPos;
-            LogFatal("2. delta Magnitude: %f.\n", deltaPos.SqMagnitude());
+            AccumulatedTime += local_dt;
         }
 #endif
-        AccumulatedTime += local_dt;
-    }
-#endif
 
-    // NOTE: Making sure that we advance all the bodies by the full dt time passed in here. They have already
-    // advanced by the "AccumulatedTime" amount, doing the remaining time here.
-    const f32 TimeRemaining = dt - AccumulatedTime;
-    // LogDebug("TimeRemaining: %f\n", TimeRemaining);
-    // LogDebug("dt: %f\n", dt);
-    // LogDebug("AccumulatedTime: %f\n", AccumulatedTime);
+        // NOTE: Making sure that we advance all the bodies by the full substep time h. They have already
+        // advanced by the "AccumulatedTime" amount, doing the remaining time here.
+        const f32 TimeRemaining = h - AccumulatedTime;
+        // LogDebug("TimeRemaining: %f\n", TimeRemaining);
+        // LogDebug("dt: %f\n", dt);
+        // LogDebug("AccumulatedTime: %f\n", AccumulatedTime);
 
-    if (TimeRemaining > 0.0f)
-    {
-        for (i32 j = 0; j < BodyCount; ++j)
+        if (TimeRemaining > 0.0f)
         {
-            auto *b = Bodies + j;
-            b->Update(TimeRemaining);
+            for (i32 j = 0; j < BodyCount; ++j)
+            {
+                auto *b = Bodies + j;
+                b->Update(TimeRemaining);
 #if 0
-            if (b == diamond)
+                if (b == diamond)
+                {
+                    endPos = diamond->Position;
+                    deltaPos = endPos - startPos;
+                    LogError("3. delta Magnitude: %f.\n", deltaPos.SqMagnitude());
+                }
+#endif
+            }
+        }
+        Stats.IntegrateMs += 1000.0f * Platform_GetSecondsElapsed(PhaseStartClock, Platform_GetWallClock());
+
+        // NOTE: Relaxation. The positions have been integrated with the biased velocities, now solve again
+        // without the Baumgarte bias so that the velocity which was only added to push the bodies apart is
+        // removed.
+        PhaseStartClock = Platform_GetWallClock();
+        if (PositionIterations > 0)
+        {
+            for (i32 i = 0; i < NumConstraints; ++i)
             {
-                endPos = diamond->Position;
-                deltaPos = endPos - startPos;
-                LogError("3. delta Magnitude: %f.\n", deltaPos.SqMagnitude());
+                this->Constraints3D[i]->BiasFactor = 0.0f;
+            }
+            this->Manifolds.SetBiasFactor(0.0f);
+
+            for (i32 i = 0; i < PositionIterations; ++i)
+            {
+                for (i32 j = 0; j < NumConstraints; ++j)
+                {
+                    this->Constraints3D[j]->Solve();
+                }
+                this->Manifolds.Solve();
             }
-#endif
         }
-    }
 
-    if (DebugMode)
-    {
-        for (i32 i = 0; i < BodyCount; ++i)
+        for (i32 i = 0; i < NumConstraints; ++i)
         {
-            auto *b = Bodies + i;
-            auto bounds = b->Shape->GetBounds(b->Position, b->Rotation);
-            bounds.Draw();
+            this->Constraints3D[i]->PostSolve();
         }
+#if 0
+        for (i32 i = 0; i < PenetrationConstraintCount; ++i)
+        {
+            PenetrationConstraints3D[i].PostSolve();
+        }
+#endif
+        this->Manifolds.PostSolve();
+        Stats.SolveMs += 1000.0f * Platform_GetSecondsElapsed(PhaseStartClock, Platform_GetWallClock());
     }
 
+
 #if 0
     endPos = diamond->Position;
     deltaPos = endPos - startPos;
@@ -513,6 +560,206 @@ shoora_scene::PhysicsUpdate(f32 dt, b32 DebugMode)
 
     EndTemporaryMemory(MemoryFlush);
 
+    UpdateQueries();
+
+    if (DebugMode)
+    {
+        for (i32 i = 0; i < BodyCount; ++i)
+        {
+            this->Transforms.WorldBounds[i].Draw();
+        }
+    }
+
+    if (Settings.Deterministic)
+    {
+        Stats.Checksum = ComputeStateChecksum();
+        determinism::EndFloatEnvironment(SavedFloatState);
+    }
+
+    Stats.TotalMs = 1000.0f * Platform_GetSecondsElapsed(StepStartClock, Platform_GetWallClock());
+    this->StepStats = Stats;
+}
+
+void
+shoora_scene::SaveSnapshot(physics_snapshot *Snapshot)
+{
+    ASSERT(Snapshot != nullptr);
+    ResolveBodyReferences();
+
+    const i32 BodyCount = GetBodyCount();
+    const i32 ManifoldCount = this->Manifolds.Manifolds.size();
+    const i32 ConstraintCount = this->Constraints3D.size();
+
+    i32 LambdaCount = 0;
+    for (i32 i = 0; i < ConstraintCount; ++i)
+    {
+        LambdaCount += this->Constraints3D[i]->GetCachedLambdaCount();
+    }
+
+    Snapshot->Reserve(BodyCount, ManifoldCount, this->Manifolds.GetContactCount(), ConstraintCount, LambdaCount);
+    Snapshot->StepCount = this->StepStats.StepCount;
+    Snapshot->StructureVersion = this->StructureVersion;
+    Snapshot->TimeAccumulator = this->TimeAccumulator;
+
+    shu::vec3f *Positions = Snapshot->Block<shu::vec3f>(Snapshot->PositionsOffset);
+    shu::quat *Rotations = Snapshot->Block<shu::quat>(Snapshot->RotationsOffset);
+    shu::vec3f *LinearVelocities = Snapshot->Block<shu::vec3f>(Snapshot->LinearVelocitiesOffset);
+    shu::vec3f *AngularVelocities = Snapshot->Block<shu::vec3f>(Snapshot->AngularVelocitiesOffset);
+    shu::vec3f *PreviousPositions = Snapshot->Block<shu::vec3f>(Snapshot->PreviousPositionsOffset);
+    shu::quat *PreviousRotations = Snapshot->Block<shu::quat>(Snapshot->PreviousRotationsOffset);
+
+    const shoora_body *Bodies = GetBodies();
+    for (i32 i = 0; i < BodyCount; ++i)
+    {
+        const shoora_body &Body = Bodies[i];
+        Positions[i] = Body.Position;
+        Rotations[i] = Body.Rotation;
+        LinearVelocities[i] = Body.LinearVelocity;
+        AngularVelocities[i] = Body.AngularVelocity;
+        PreviousPositions[i] = Body.PreviousPosition;
+        PreviousRotations[i] = Body.PreviousRotation;
+    }
+
+    this->Manifolds.Save(Snapshot, this->Bodies);
+
+    f32 *Lambdas = Snapshot->Block<f32>(Snapshot->LambdasOffset);
+    for (i32 i = 0; i < ConstraintCount; ++i)
+    {
+        constraint_3d *Constraint = this->Constraints3D[i];
+        i32 Count = Constraint->GetCachedLambdaCount();
+        if (Count > 0)
+        {
+            SHU_MEMCOPY(Constraint->GetCachedLambdas(), Lambdas, sizeof(f32) * Count);
+            Lambdas += Count;
+        }
+    }
+}
+
+b32
+shoora_scene::RestoreSnapshot(const physics_snapshot *Snapshot)
+{
+    ASSERT(Snapshot != nullptr);
+    ResolveBodyReferences();
+
+    const i32 BodyCount = GetBodyCount();
+    const i32 ConstraintCount = this->Constraints3D.size();
+    if (Snapshot->Memory == nullptr || Snapshot->BodyCount != BodyCount ||
+        Snapshot->ConstraintCount != ConstraintCount || Snapshot->StructureVersion != this->StructureVersion)
+    {
+        LogWarn("Snapshot does not match the scene! Bodies: %d/%d, Constraints: %d/%d, Version: %u/%u.\n",
+                Snapshot->BodyCount, BodyCount, Snapshot->ConstraintCount, ConstraintCount,
+                Snapshot->StructureVersion, this->StructureVersion);
+        return false;
+    }
+
+    const shu::vec3f *Positions = Snapshot->Block<shu::vec3f>(Snapshot->PositionsOffset);
+    const shu::quat *Rotations = Snapshot->Block<shu::quat>(Snapshot->RotationsOffset);
+    const shu::vec3f *LinearVelocities = Snapshot->Block<shu::vec3f>(Snapshot->LinearVelocitiesOffset);
+    const shu::vec3f *AngularVelocities = Snapshot->Block<shu::vec3f>(Snapshot->AngularVelocitiesOffset);
+    const shu::vec3f *PreviousPositions = Snapshot->Block<shu::vec3f>(Snapshot->PreviousPositionsOffset);
+    const shu::quat *PreviousRotations = Snapshot->Block<shu::quat>(Snapshot->PreviousRotationsOffset);
+
+    shoora_body *Bodies = GetBodies();
+    for (i32 i = 0; i < BodyCount; ++i)
+    {
+        shoora_body &Body = Bodies[i];
+        Body.Position = Positions[i];
+        Body.Rotation = Rotations[i];
+        Body.LinearVelocity = LinearVelocities[i];
+        Body.AngularVelocity = AngularVelocities[i];
+        Body.PreviousPosition = PreviousPositions[i];
+        Body.PreviousRotation = PreviousRotations[i];
+        Body.SumForces = shu::vec3f::Zero();
+        Body.SumTorques = 0.0f;
+    }
+
+    this->Manifolds.Restore(Snapshot, this->Bodies);
+
+    const f32 *Lambdas = Snapshot->Block<f32>(Snapshot->LambdasOffset);
+    for (i32 i = 0; i < ConstraintCount; ++i)
+    {
+        constraint_3d *Constraint = this->Constraints3D[i];
+        i32 Count = Constraint->GetCachedLambdaCount();
+        if (Count > 0)
+        {
+            SHU_MEMCOPY(Lambdas, Constraint->GetCachedLambdas(), sizeof(f32) * Count);
+            Lambdas += Count;
+        }
+    }
+
+    this->StepStats.StepCount = Snapshot->StepCount;
+    this->TimeAccumulator = Snapshot->TimeAccumulator;
+    this->TransformsStale = true;
+
+    return true;
+}
+
+void
+shoora_scene::UpdateQueries()
+{
+    UpdateTransforms();
+    this->Queries.Build(GetBodies(), this->Transforms.WorldBounds, GetBodyCount());
+}
+
+void
+shoora_scene::UpdateTransforms()
+{
+    this->Transforms.Update(GetBodies(), GetBodyCount());
+    this->TransformsStale = false;
+}
+
+void
+shoora_scene::MarkTransformsStale()
+{
+    this->TransformsStale = true;
+}
+
+u64
+shoora_scene::ComputeStateChecksum()
+{
+    u64 Result = determinism::HashBodyStates(GetBodies(), GetBodyCount());
+    return Result;
+}
+
+i32
+shoora_scene::Step(f32 FrameDeltaTime, b32 DebugMode)
+{
+    const f32 FixedDeltaTime = this->Settings.FixedDeltaTime;
+    ASSERT(FixedDeltaTime > 0.0f);
+    const i32 MaxSteps = MAX(this->Settings.MaxStepsPerFrame, 1);
+
+    this->TimeAccumulator += FrameDeltaTime;
+
+    i32 StepCount = 0;
+    while ((this->TimeAccumulator >= FixedDeltaTime) && (StepCount < MaxSteps))
+    {
+        i32 BodyCount = GetBodyCount();
+        shoora_body *Bodies = GetBodies();
+        for (i32 i = 0; i < BodyCount; ++i)
+        {
+            Bodies[i].PreviousPosition = Bodies[i].Position;
+            Bodies[i].PreviousRotation = Bodies[i].Rotation;
+        }
+
+        PhysicsUpdate(FixedDeltaTime, DebugMode);
+        this->TimeAccumulator -= FixedDeltaTime;
+        ++StepCount;
+    }
+
+    // NOTE: Out of catch-up budget. Drop the whole steps that are left, we only keep the fraction for the
+    // interpolation.
+    f32 DroppedTime = 0.0f;
+    if (this->TimeAccumulator >= FixedDeltaTime)
+    {
+        DroppedTime = this->TimeAccumulator - fmodf(this->TimeAccumulator, FixedDeltaTime);
+        this->TimeAccumulator -= DroppedTime;
+    }
+
+    this->InterpolationAlpha = this->TimeAccumulator / FixedDeltaTime;
+    this->StepStats.StepsLastFrame = StepCount;
+    this->StepStats.DroppedTime = DroppedTime;
+
+    return StepCount;
 }
 
 void
@@ -527,6 +774,22 @@ shoora_scene::Draw(b32 Wireframe)
     for (u32 BodyIndex = 1; BodyIndex < Bodies.size(); ++BodyIndex)
 #endif
 
+    // NOTE: The interpolated transforms are different every frame, so the model matrices are worked out here for all
+    // of the bodies in one go instead of using the ones from the physics step.
+    const i32 BodyCount = GetBodyCount();
+    temporary_memory MemoryFlush = BeginTemporaryMemory(GetArena(MEMTYPE_THREADFRAME));
+    shu::vec3f *Positions = ShuAllocateArray(shu::vec3f, BodyCount, MEMTYPE_THREADFRAME);
+    shu::vec3f *Scales = ShuAllocateArray(shu::vec3f, BodyCount, MEMTYPE_THREADFRAME);
+    shu::quat *Rotations = ShuAllocateArray(shu::quat, BodyCount, MEMTYPE_THREADFRAME);
+    shu::mat4f *Models = ShuAllocateArray(shu::mat4f, BodyCount, MEMTYPE_THREADFRAME);
+    for (i32 BodyIndex = 0; BodyIndex < BodyCount; ++BodyIndex)
+    {
+        const shoora_body *Body = Bodies.data() + BodyIndex;
+        Body->GetInterpolatedTransform(this->InterpolationAlpha, Positions[BodyIndex], Rotations[BodyIndex]);
+        Scales[BodyIndex] = Body->Scale;
+    }
+    shu::TRSBatch(Positions, Scales, Rotations, BodyCount, Models);
+
     for (u32 BodyIndex = 0; BodyIndex < Bodies.size(); ++BodyIndex)
     {
         shoora_body *Body = Bodies.data() + BodyIndex;
@@ -537,7 +800,7 @@ shoora_scene::Draw(b32 Wireframe)
         // Shu::vec3f Color = GetColor(ColorU32);
         shu::vec3f Color = Body->Color;
 
-        shu::mat4f Model = shu::TRS(Body->Position, Body->Scale, Body->Rotation);
+        const shu::mat4f &Model = Models[BodyIndex];
         scene_shader_data Value = {.Mat = Model, .Col = Color};
 
 #if 1
@@ -559,6 +822,7 @@ shoora_scene::Draw(b32 Wireframe)
         Body->DrawWireframe(Model, 1.5f, 0xffffffff);
 #endif
     }
+    EndTemporaryMemory(MemoryFlush);
 
 #if 0
     for (i32 cIndex = 0; cIndex < Constraints2D.size(); ++cIndex)
@@ -584,6 +848,11 @@ shoora_scene::DrawAxes(shu::rect2d &Rect)
 void
 shoora_scene::AddConstraint2D(constraint_2d *Constraint)
 {
+    ASSERT(Constraint != nullptr);
+    Constraint->A = Bodies.Get(Constraint->HandleA);
+    Constraint->B = Bodies.Get(Constraint->HandleB);
+    ASSERT(Constraint->A != nullptr && Constraint->B != nullptr);
+
     Constraints2D.push_back(Constraint);
 }
 
@@ -616,3 +885,87 @@ shoora_scene::GetBody(i32 Index)
 {
     return Bodies.get(Index);
 }
+
+body_handle
+shoora_scene::GetBodyHandle(const shoora_body *Body)
+{
+    i32 Index = (i32)(Body - Bodies.data());
+    ASSERT(Index >= 0 && Index < Bodies.size());
+
+    return Bodies.GetHandle(Index);
+}
+
+shoora_body *
+shoora_scene::GetBody(body_handle Handle)
+{
+    return Bodies.Get(Handle);
+}
+
+// NOTE: The manifolds and the constraints of the body are dropped by the next ResolveBodyReferences(), when their
+// handle does not find the body anymore. The body which Remove moves into the hole keeps its handle, so nothing
+// has to be pointed at its new place either.
+b32
+shoora_scene::RemoveBody(body_handle Handle)
+{
+    b32 Result = Bodies.Remove(Handle);
+    if (Result)
+    {
+        ++this->StructureVersion;
+        this->TransformsStale = true;
+    }
+
+    return Result;
+}
+
+void
+shoora_scene::ResolveBodyReferences()
+{
+    this->Manifolds.ResolveBodies(this->Bodies);
+
+    for (i32 i = Constraints3D.size() - 1; i >= 0; --i)
+    {
+        constraint_3d *Constraint = Constraints3D[i];
+        Constraint->A = Bodies.Get(Constraint->HandleA);
+        Constraint->B = Bodies.Get(Constraint->HandleB);
+        if (Constraint->A == nullptr || Constraint->B == nullptr)
+        {
+            Constraints3D.Remove(Constraints3D.GetHandle(i));
+        }
+    }
+    for (i32 i = Constraints2D.size() - 1; i >= 0; --i)
+    {
+        constraint_2d *Constraint = Constraints2D[i];
+        Constraint->A = Bodies.Get(Constraint->HandleA);
+        Constraint->B = Bodies.Get(Constraint->HandleB);
+        if (Constraint->A == nullptr || Constraint->B == nullptr)
+        {
+            Constraints2D.swap_erase(i);
+        }
+    }
+}
+
+constraint_handle
+shoora_scene::AddConstraint3D(constraint_3d *Constraint)
+{
+    ASSERT(Constraint != nullptr);
+    Constraint->A = Bodies.Get(Constraint->HandleA);
+    Constraint->B = Bodies.Get(Constraint->HandleB);
+    ASSERT(Constraint->A != nullptr && Constraint->B != nullptr);
+
+    constraint_handle Result = Constraints3D.Add(Constraint);
+    ++this->StructureVersion;
+
+    return Result;
+}
+
+b32
+shoora_scene::RemoveConstraint3D(constraint_handle Handle)
+{
+    b32 Result = Constraints3D.Remove(Handle);
+    if (Result)
+    {
+        ++this->StructureVersion;
+    }
+
+    return Result;
+}
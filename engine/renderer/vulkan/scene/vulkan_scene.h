@@ -1,13 +1,21 @@
 #if !defined(VULKAN_SCENE_H)
 
 #include <containers/dynamic_array.h>
+#include <containers/slot_map.h>
 #include <defines.h>
 #include <math/math.h>
 #include <physics/body.h>
+#include <physics/body_transforms.h>
 #include <physics/broadphase.h>
 #include <physics/constraint.h>
 #include <physics/contact_manifold.h>
+#include <physics/physics_settings.h>
+#include <physics/physics_snapshot.h>
+#include <physics/scene_query.h>
 
+// NOTE: Handles stay valid when other bodies/constraints are added or removed, pointers to the bodies do not.
+// body_handle is in physics/body.h.
+typedef slot_handle constraint_handle;
 
 struct shoora_scene
 {
@@ -15,11 +23,35 @@ struct shoora_scene
     b32 SceneAddBegin = false, SceneAddEnd = false;
 
   public:
-    shoora_dynamic_array<shoora_body> Bodies;
+    // NOTE: Packed, so the physics loops over them like a plain array. Removing a body moves the last body into
+    // its place.
+    shoora_slot_map<shoora_body> Bodies;
     shoora_dynamic_array<constraint_2d *> Constraints2D;
     shoora_dynamic_array<penetration_constraint_2d> PenetrationConstraints2D;
-    shoora_dynamic_array<constraint_3d *> Constraints3D;
+    shoora_slot_map<constraint_3d *> Constraints3D;
     manifold_collector Manifolds;
+
+    // NOTE: Goes up every time a body or a constraint is added or removed. Snapshots only restore into the same
+    // version.
+    u32 StructureVersion = 0;
+
+    physics_settings Settings;
+    physics_step_stats StepStats = {};
+
+    // NOTE: Frame time which has not been simulated yet, and how far(0 to 1) we are between the previous and the
+    // current fixed step. Draw() uses the alpha to interpolate the body transforms.
+    f32 TimeAccumulator = 0.0f;
+    f32 InterpolationAlpha = 1.0f;
+
+    // NOTE: Ray/shape casts and overlap tests against the bodies. Rebuilt at the end of every physics step, call
+    // UpdateQueries() if the bodies were moved or added outside of it.
+    scene_query Queries;
+
+    // NOTE: World bounds of all the bodies. Worked out once per step, at the end of it along with the queries, and read
+    // by the next step's broadphase. Adding/removing bodies or restoring a snapshot sets TransformsStale and the next
+    // step works them out again first. Anything else that moves the bodies has to call MarkTransformsStale().
+    body_transforms Transforms;
+    b32 TransformsStale = true;
   
   public:
     shoora_scene();
@@ -27,32 +59,65 @@ struct shoora_scene
 
     void AddMeshToScene(const shu::vec3f *vPositions, u32 vCount);
 
+    // NOTE: HandleA and HandleB of the constraint have to be set.
     void AddConstraint2D(constraint_2d *Constraint);
     i32 GetConstraints2DCount();
 
-    // shoora_body *AddBody(const shoora_body &Body);
-    shoora_body *AddBody(shoora_body &&Body);
-
-    shoora_body *AddCubeBody(const shu::vec3f &Pos, const shu::vec3f &Scale, u32 ColorU32, f32 Mass,
-                             f32 Restitution, const shu::vec3f &EulerAngles = shu::Vec3f(0.0f));
-    shoora_body *AddSphereBody(const shu::vec3f &Pos, u32 ColorU32, f32 Radius, f32 Mass, f32 Restitution,
-                               const shu::vec3f &EulerAngles = shu::Vec3f(0.0f));
-    shoora_body *AddBoxBody(const shu::vec2f Pos, u32 ColorU32, f32 Width, f32 Height, f32 Mass, f32 Restitution,
-                            const shu::vec3f &EulerAngles = shu::Vec3f(0.0f));
-    shoora_body *AddCircleBody(const shu::vec2f Pos, u32 ColorU32, f32 Radius, f32 Mass, f32 Restitution,
-                               const shu::vec3f &EulerAngles = shu::Vec3f(0.0f));
-    shoora_body *AddPolygonBody(const u32 MeshId, const shu::vec2f Pos, u32 ColorU32, f32 Mass, f32 Restitution,
-                                const shu::vec3f &EulerAngles = shu::Vec3f(0.0f), f32 Scale = 1.0f);
-    shoora_body *AddDiamondBody(const shu::vec3f &Pos, const shu::vec3f &Scale, u32 ColorU32, f32 Mass,
-                                f32 Restitution, const shu::vec3f &EulerAngles);
+    // NOTE: Look the body up with GetBody(Handle) when it is needed, the pointer is only good until the next body
+    // is added or removed.
+    // body_handle AddBody(const shoora_body &Body);
+    body_handle AddBody(shoora_body &&Body);
+
+    body_handle AddCubeBody(const shu::vec3f &Pos, const shu::vec3f &Scale, u32 ColorU32, f32 Mass,
+                            f32 Restitution, const shu::vec3f &EulerAngles = shu::Vec3f(0.0f));
+    body_handle AddSphereBody(const shu::vec3f &Pos, u32 ColorU32, f32 Radius, f32 Mass, f32 Restitution,
+                              const shu::vec3f &EulerAngles = shu::Vec3f(0.0f));
+    body_handle AddBoxBody(const shu::vec2f Pos, u32 ColorU32, f32 Width, f32 Height, f32 Mass, f32 Restitution,
+                           const shu::vec3f &EulerAngles = shu::Vec3f(0.0f));
+    body_handle AddCircleBody(const shu::vec2f Pos, u32 ColorU32, f32 Radius, f32 Mass, f32 Restitution,
+                              const shu::vec3f &EulerAngles = shu::Vec3f(0.0f));
+    body_handle AddPolygonBody(const u32 MeshId, const shu::vec2f Pos, u32 ColorU32, f32 Mass, f32 Restitution,
+                               const shu::vec3f &EulerAngles = shu::Vec3f(0.0f), f32 Scale = 1.0f);
+    body_handle AddDiamondBody(const shu::vec3f &Pos, const shu::vec3f &Scale, u32 ColorU32, f32 Mass,
+                               f32 Restitution, const shu::vec3f &EulerAngles);
 
     i32 GetBodyCount();
     shoora_body *GetBodies();
     shoora_body *GetBody(i32 Index);
 
+    body_handle GetBodyHandle(const shoora_body *Body);
+    // NOTE: nullptr if the body has been removed.
+    shoora_body *GetBody(body_handle Handle);
+    // NOTE: O(1). The manifolds and the constraints that use the body are dropped at the start of the next step(or
+    // snapshot). The constraints are not freed, they are owned by whoever made them. Call UpdateQueries() before
+    // querying the scene again, like after AddBody.
+    b32 RemoveBody(body_handle Handle);
+    // NOTE: Points A and B of the manifolds and the constraints at where their bodies are now, and drops the ones
+    // whose body has been removed.
+    void ResolveBodyReferences();
+
+    // NOTE: HandleA and HandleB of the constraint have to be set.
+    constraint_handle AddConstraint3D(constraint_3d *Constraint);
+    b32 RemoveConstraint3D(constraint_handle Handle);
+
     void UpdateInput(const shu::vec2f &CurrentMouseWorldPos);
 
     void PhysicsUpdate(f32 dt, b32 DebugMode);
+    void UpdateQueries();
+    void UpdateTransforms();
+    // NOTE: Call it after setting the position/rotation of a body outside of the step, so the next step's broadphase
+    // does not use its old bounds.
+    void MarkTransformsStale();
+    // NOTE: Runs as many fixed steps as fit in the accumulated frame time and returns how many were run.
+    i32 Step(f32 FrameDeltaTime, b32 DebugMode);
+    // NOTE: Hash of the state of all the bodies. Same on every machine for the same inputs in the deterministic
+    // mode.
+    u64 ComputeStateChecksum();
+
+    // NOTE: Save/Restore the simulation state for rollbacks. Restore fails if the bodies or the constraints have
+    // been added/removed since the snapshot was taken.
+    void SaveSnapshot(physics_snapshot *Snapshot);
+    b32 RestoreSnapshot(const physics_snapshot *Snapshot);
 
     void Draw(b32 Wireframe);
     void DrawAxes(shu::rect2d &Rect);
@@ -1,4 +1,5 @@
 #include "vulkan_buffer.h"
+#include <mesh/vertex_packing.h>
 #include <memory>
 
 shoora_vulkan_buffer
@@ -61,7 +62,7 @@ CreateBuffer(shoora_vulkan_device *RenderDevice, VkBufferUsageFlags Usage, VkSha
 
 void
 CopyBuffers(shoora_vulkan_device *RenderDevice, VkBuffer *SrcBuffers, VkBuffer *DstBuffers, size_t *CopySizes,
-            u32 BufferCount)
+            u32 BufferCount, size_t *SrcOffsets = nullptr)
 {
     VkCommandBuffer CopyBuffer;
 
@@ -92,6 +93,7 @@ CopyBuffers(shoora_vulkan_device *RenderDevice, VkBuffer *SrcBuffers, VkBuffer *
             Index < BufferCount;
             ++Index)
         {
+            CopyRegion.srcOffset = SrcOffsets ? SrcOffsets[Index] : 0;
             CopyRegion.size = CopySizes[Index];
             vkCmdCopyBuffer(CopyBuffer, SrcBuffers[Index], DstBuffers[Index], 1, &CopyRegion);
         }
@@ -115,46 +117,41 @@ CopyBuffers(shoora_vulkan_device *RenderDevice, VkBuffer *SrcBuffers, VkBuffer *
     vkFreeCommandBuffers(RenderDevice->LogicalDevice, RenderDevice->TransferCommandPoolTransient, 1, &CopyBuffer);
 }
 
-void
-CreateVertexBuffers(shoora_vulkan_device *RenderDevice, u8 *Vertices, u32 VertexCount,
-                    u8 *Indices, u32 IndexCount, size_t VertexBufferSize, size_t IndexBufferSize,
-                    shoora_vulkan_buffer *outVertexBuffer, shoora_vulkan_buffer *outIndexBuffer)
-{}
-
-void
-CreateVertexBuffers(shoora_vulkan_device *RenderDevice, shoora_vertex_info *Vertices, u32 VertexCount, u32 *Indices,
-                    u32 IndexCount, shoora_vulkan_buffer *outVertexBuffer, shoora_vulkan_buffer *outIndexBuffer)
+// NOTE: The vertices can be in any of the vertex formats, only their size in bytes matters here.
+static void
+CreateVertexBuffers(shoora_vulkan_device *RenderDevice, const void *Vertices, size_t VertexBufferSize,
+                    const u32 *Indices, u32 IndexCount, shoora_vulkan_buffer *outVertexBuffer,
+                    shoora_vulkan_buffer *outIndexBuffer)
 {
-    size_t VertexBufferSize = VertexCount*sizeof(shoora_vertex_info);
     size_t IndexBufferSize = IndexCount*sizeof(u32);
 
-    auto StagingVertexBuffer = CreateBuffer(RenderDevice, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                            VK_SHARING_MODE_EXCLUSIVE,
-                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                            (u8  *)Vertices, VertexBufferSize);
+    // NOTE: One staging buffer for both, filled straight from the mesh filter. For a baked mesh that is the mapped
+    // file, so this copy is the only time the vertices are read on the CPU.
+    size_t IndexOffset = ALIGN16(VertexBufferSize);
+    auto StagingBuffer = CreateBuffer(RenderDevice, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      nullptr, IndexOffset + IndexBufferSize);
+    memcpy(StagingBuffer.pMapped, Vertices, VertexBufferSize);
+    memcpy((u8 *)StagingBuffer.pMapped + IndexOffset, Indices, IndexBufferSize);
+    vkUnmapMemory(RenderDevice->LogicalDevice, StagingBuffer.Memory);
+
     auto VertexBuffer = CreateBuffer(RenderDevice,
                                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                      VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, nullptr,
                                      VertexBufferSize);
-
-    auto StagingIndexBuffer = CreateBuffer(RenderDevice, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                           VK_SHARING_MODE_EXCLUSIVE,
-                                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                           (u8 *)Indices, IndexBufferSize);
     auto IndexBuffer = CreateBuffer(RenderDevice,
                                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                     VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, nullptr,
                                     IndexBufferSize);
 
-    VkBuffer SourceBuffers[] = {StagingVertexBuffer.Handle, StagingIndexBuffer.Handle};
+    VkBuffer SourceBuffers[] = {StagingBuffer.Handle, StagingBuffer.Handle};
     VkBuffer DestinationBuffers[] = {VertexBuffer.Handle, IndexBuffer.Handle};
     size_t CopySizes[] = {VertexBufferSize, IndexBufferSize};
-    CopyBuffers(RenderDevice, SourceBuffers, DestinationBuffers, CopySizes, ARRAY_SIZE(CopySizes));
+    size_t SourceOffsets[] = {0, IndexOffset};
+    CopyBuffers(RenderDevice, SourceBuffers, DestinationBuffers, CopySizes, ARRAY_SIZE(CopySizes), SourceOffsets);
 
-    vkDestroyBuffer(RenderDevice->LogicalDevice, StagingVertexBuffer.Handle, nullptr);
-    vkFreeMemory(RenderDevice->LogicalDevice, StagingVertexBuffer.Memory, nullptr);
-    vkDestroyBuffer(RenderDevice->LogicalDevice, StagingIndexBuffer.Handle, nullptr);
-    vkFreeMemory(RenderDevice->LogicalDevice, StagingIndexBuffer.Memory, nullptr);
+    vkDestroyBuffer(RenderDevice->LogicalDevice, StagingBuffer.Handle, nullptr);
+    vkFreeMemory(RenderDevice->LogicalDevice, StagingBuffer.Memory, nullptr);
 
     outVertexBuffer->Handle = VertexBuffer.Handle;
     outVertexBuffer->Memory = VertexBuffer.Memory;
@@ -169,13 +166,25 @@ CreateVertexBuffers(shoora_vulkan_device *RenderDevice, shoora_vertex_info *Vert
     LogOutput(LogType_Info, "Created Vertex buffer and Index buffers\n");
 }
 
+void
+CreateVertexBuffers(shoora_vulkan_device *RenderDevice, shoora_vertex_info *Vertices, u32 VertexCount, u32 *Indices,
+                    u32 IndexCount, shoora_vulkan_buffer *outVertexBuffer, shoora_vulkan_buffer *outIndexBuffer)
+{
+    CreateVertexBuffers(RenderDevice, (const void *)Vertices, VertexCount*sizeof(shoora_vertex_info), Indices,
+                        IndexCount, outVertexBuffer, outIndexBuffer);
+}
+
 void
 CreateVertexBuffers(shoora_vulkan_device *RenderDevice, shoora_model *Model,
                     shoora_vulkan_vertex_buffers *VertBuffers)
 {
-    CreateVertexBuffers(RenderDevice, Model->MeshFilter.Vertices, Model->MeshFilter.VertexCount,
-                        Model->MeshFilter.Indices, Model->MeshFilter.IndexCount, &VertBuffers->VertexBuffer,
-                        &VertBuffers->IndexBuffer);
+    // NOTE: The packed vertices when the model was loaded in one of the compact formats.
+    const shoora_mesh_filter *MeshFilter = &Model->MeshFilter;
+    const void *Vertices = (MeshFilter->PackedVertices != nullptr) ? MeshFilter->PackedVertices :
+                                                                     (const void *)MeshFilter->Vertices;
+    size_t VertexBufferSize = (size_t)MeshFilter->VertexCount*GetVertexFormatSize(MeshFilter->PackedFormat);
+    CreateVertexBuffers(RenderDevice, Vertices, VertexBufferSize, MeshFilter->Indices, MeshFilter->IndexCount,
+                        &VertBuffers->VertexBuffer, &VertBuffers->IndexBuffer);
 }
 
 // TODO)): Instead of creating 4 separate uniform buffers, create a single one with each having an offset.
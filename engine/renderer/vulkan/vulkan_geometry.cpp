@@ -28,6 +28,9 @@ UpdateGeometryUniformBuffers(shoora_vulkan_geometry *Geometry, shoora_camera *Ca
     ShaderData->Values.View = Camera->GetViewMatrix(ShaderData->Values.View);
     ShaderData->Values.ViewPosition = shu::Vec4f(Camera->Pos.x, Camera->Pos.y, Camera->Pos.z, 1.0f);
     ShaderData->Values.LightPosition = shu::Vec4f(0.0f, 5.0f, 0.0f, 1.0f);
+    const shoora_vertex_dequant &Dequant = Geometry->Model.MeshFilter.PositionDequant;
+    ShaderData->Values.PositionDequantScale = shu::Vec4f(Dequant.Scale.x, Dequant.Scale.y, Dequant.Scale.z, 0.0f);
+    ShaderData->Values.PositionDequantOffset = shu::Vec4f(Dequant.Offset.x, Dequant.Offset.y, Dequant.Offset.z, 0.0f);
     memcpy(Geometry->ShaderData.Buffer.pMapped, &Geometry->ShaderData.Values, sizeof(shader_data));
 }
 
@@ -155,17 +158,14 @@ SetupPipeline(shoora_vulkan_device *RenderDevice, VkRenderPass RenderPass, shoor
     ShaderStageCreateInfos[1] = GetShaderStageInfo(RenderDevice, FragmentShaderFile, VK_SHADER_STAGE_FRAGMENT_BIT,
                                                    "main");
 
-    auto VertexBindingDesc = GetVertexBindingDescription();
-    VkVertexInputAttributeDescription AttributeDescriptions[] = {
-        GetVertexAttributeDescription(0, 0, VK_FORMAT_R32G32B32_SFLOAT,     OFFSET_OF(shoora_vertex_info, Pos)),
-        GetVertexAttributeDescription(0, 1, VK_FORMAT_R32G32B32_SFLOAT,     OFFSET_OF(shoora_vertex_info, Normal)),
-        GetVertexAttributeDescription(0, 2, VK_FORMAT_R32G32_SFLOAT,        OFFSET_OF(shoora_vertex_info, UV)),
-        GetVertexAttributeDescription(0, 3, VK_FORMAT_R32G32B32_SFLOAT,     OFFSET_OF(shoora_vertex_info, Color)),
-        GetVertexAttributeDescription(0, 4, VK_FORMAT_R32G32B32A32_SFLOAT,  OFFSET_OF(shoora_vertex_info, Tangent))
-    };
+    // NOTE: The vertex buffer is in the format the model was loaded in.
+    shoora_vertex_format VertexFormat = Geometry->Model.MeshFilter.PackedFormat;
+    auto VertexBindingDesc = GetVertexBindingDescription(VertexFormat);
+    VkVertexInputAttributeDescription AttributeDescriptions[16];
+    u32 AttributeCount;
+    GetVertexAttributeDescriptions(AttributeDescriptions, &AttributeCount, VertexFormat);
 
-    auto VertexInputInfo = GetPipelineVertexInputInfo(1, &VertexBindingDesc, ARRAY_SIZE(AttributeDescriptions),
-                                                      AttributeDescriptions);
+    auto VertexInputInfo = GetPipelineVertexInputInfo(1, &VertexBindingDesc, AttributeCount, AttributeDescriptions);
 
     auto PipelineCreateInfo = GetPipelineCreateInfo(Geometry->PipelineLayout, RenderPass);
     PipelineCreateInfo.pVertexInputState = &VertexInputInfo;
@@ -218,17 +218,8 @@ DrawGeometryNode(VkCommandBuffer CommandBuffer, VkPipelineLayout PipelineLayout,
 {
     if(Node->PrimitiveCount > 0)
     {
-        shu::mat4f NodeMatrix = Node->ModelMatrix;
-        shoora_mesh_cgltf_node *ParentNode = Node->ParentNode;
-
-        while(ParentNode)
-        {
-            NodeMatrix = ParentNode->ModelMatrix*NodeMatrix;
-            ParentNode = ParentNode->ParentNode;
-        }
-
         vkCmdPushConstants(CommandBuffer, PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(shu::mat4f),
-                           &NodeMatrix);
+                           &Node->WorldMatrix);
         for(u32 PrimitiveIndex = 0;
             PrimitiveIndex < Node->PrimitiveCount;
             ++PrimitiveIndex)
@@ -266,14 +257,6 @@ CleanupGeometry(shoora_vulkan_device *RenderDevice, shoora_vulkan_geometry *Geom
         TexIndex < Model->TextureCount;
         ++TexIndex)
     {
-        shoora_mesh_texture *Tex = Model->Textures + TexIndex;
-        u8 *ImageData = Tex->ImageData.Data;
-        if(ImageData)
-        {
-            free(ImageData);
-            ImageData = nullptr;
-        }
-
         vkDestroySampler(RenderDevice->LogicalDevice, Geometry->ImageBuffers[TexIndex].Sampler, nullptr);
         DestroyImage2D(RenderDevice, &Geometry->ImageBuffers[TexIndex].Image);
     }
@@ -291,15 +274,17 @@ CleanupGeometry(shoora_vulkan_device *RenderDevice, shoora_vulkan_geometry *Geom
 
         vkDestroyPipeline(RenderDevice->LogicalDevice, Mat->Pipeline, nullptr);
     }
+
+    CleanupModelResources(Model);
 }
 
 void
 SetupGeometry(shoora_vulkan_device *RenderDevice, shoora_vulkan_geometry *Geometry, shoora_camera *Camera,
               const shu::mat4f &Projection, VkRenderPass RenderPass, const char *MeshFile,
-              const char *VertexShaderFile, const char *FragmentShaderFile)
+              const char *VertexShaderFile, const char *FragmentShaderFile, shoora_vertex_format VertexFormat)
 {
     shoora_model *Model = &Geometry->Model;
-    LoadModel(Model, MeshFile);
+    LoadModel(Model, MeshFile, true, VertexFormat);
     CreateVertexBuffers(RenderDevice, Model, &Geometry->VertBuffers);
     CreateUniformBuffers(RenderDevice, Geometry, Camera, Projection);
     CreateImageBuffers(RenderDevice, Geometry);
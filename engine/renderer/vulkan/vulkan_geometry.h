@@ -9,9 +9,11 @@ void UpdateGeometryUniformBuffers(shoora_vulkan_geometry *Geometry, shoora_camer
                                   const shu::mat4f &Projection);
 void DrawGeometry(VkCommandBuffer DrawCmdBuffer, shoora_vulkan_geometry *Geometry);
 
+// NOTE: The vertex shader has to match VertexFormat, sponza_compact.vert for the compact and the quantized ones.
 void SetupGeometry(shoora_vulkan_device *RenderDevice, shoora_vulkan_geometry *Geometry, shoora_camera *Camera,
                    const shu::mat4f &Projection, VkRenderPass RenderPass, const char *MeshFile,
-                   const char *VertexShaderFile, const char *FragmentShaderFile);
+                   const char *VertexShaderFile, const char *FragmentShaderFile,
+                   shoora_vertex_format VertexFormat = VertexFormat_Full);
 
 void CleanupGeometry(shoora_vulkan_device *RenderDevice, shoora_vulkan_geometry *Geometry);
 
@@ -1,5 +1,6 @@
 #include "loaders/meshes/mesh_loader.h"
 #include "loaders/image/png_loader.h"
+#include "loaders/image/jpeg_loader.h"
 #include "renderer/vulkan/vulkan_input_info.h"
 #include "vulkan/vulkan_core.h"
 #include "vulkan_buffer.h"
@@ -142,6 +143,41 @@ static f32 GlobalImGuiDragFloatStep = 0.005f;
 static shu::vec2u GlobalWindowSize = {};
 
 static shoora_scene *Scene;
+static physics_snapshot GlobalPhysicsSnapshot = {};
+#if _SHU_DEBUG
+#define ALLOCATION_TRACE_CAPACITY (1 << 18)
+static allocation_trace GlobalAllocationTrace = {};
+static const char *GlobalPNGBenchmarkPaths[] =
+{
+    "images/cobblestone.png",
+    "images/cobblestone_NRM.png",
+    "images/cobblestone_SPEC.png",
+    "images/paving.png",
+    "images/paving_NRM.png",
+    "images/paving_SPEC.png",
+    "images/orange_lines_512.png",
+    "images/test_png.png",
+    "images/proto/Grid_02.png",
+    "meshes/sponza/5061699253647017043.png",
+    "meshes/sponza/8006627369776289000.png",
+    "meshes/sponza/16275776544635328252.png",
+};
+static const char *GlobalJPEGBenchmarkPaths[] =
+{
+    "images/statue.jpg",
+    "images/brickwall/brickwall.jpg",
+    "images/brickwall/brickwall_NRM.jpg",
+    "images/granite/granite.jpg",
+    "images/granite/granite_SPEC.jpg",
+    "images/wall10/wall10.jpg",
+    "images/cyberpunk_keanu_01.jpg",
+    "images/cyberpunk_keanu_02.jpg",
+    "images/wallpaperflare.com_wallpaper.jpg",
+    "meshes/sponza/10381718147657362067.jpg",
+    "meshes/sponza/14118779221266351425.jpg",
+    "meshes/sponza/8503262930880235456.jpg",
+};
+#endif
 
 void
 WindowWasResized()
@@ -233,6 +269,114 @@ ImGuiNewFrame()
         ImGui::DragFloat3("Euler Angles", EulerAngles.E);
     }
 
+    if (ImGui::CollapsingHeader("Physics"))
+    {
+        physics_settings &Settings = Scene->Settings;
+        ImGui::SliderInt("Substeps", &Settings.Substeps, 1, 16);
+        ImGui::SliderInt("Velocity Iterations", &Settings.VelocityIterations, 1, 32);
+        ImGui::SliderInt("Position Iterations", &Settings.PositionIterations, 0, 16);
+        ImGui::SliderFloat("Warm Start Factor", &Settings.WarmStartFactor, 0.0f, 1.0f);
+        ImGui::DragFloat3("Gravity", Settings.Gravity.E, .1f, -100, 100);
+        ImGui::SliderInt("Max Steps Per Frame", &Settings.MaxStepsPerFrame, 1, 16);
+        ImGui::Checkbox("Deterministic", (bool *)&Settings.Deterministic);
+        if (ImGui::Button("Save Snapshot")) { Scene->SaveSnapshot(&GlobalPhysicsSnapshot); }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(GlobalPhysicsSnapshot.Memory == nullptr);
+        if (ImGui::Button("Restore Snapshot")) { Scene->RestoreSnapshot(&GlobalPhysicsSnapshot); }
+        ImGui::EndDisabled();
+
+        const physics_step_stats &Stats = Scene->StepStats;
+        ImGui::Text("Step: %llu, Pairs: %d, Manifolds: %d", Stats.StepCount, Stats.PairCount, Stats.ManifoldCount);
+        ImGui::Text("Integrate: %.3fms", Stats.IntegrateMs);
+        ImGui::Text("Broadphase: %.3fms", Stats.BroadPhaseMs);
+        ImGui::Text("Narrowphase: %.3fms", Stats.NarrowPhaseMs);
+        ImGui::Text("Solve: %.3fms", Stats.SolveMs);
+        ImGui::Text("Total: %.3fms", Stats.TotalMs);
+        if (Settings.Deterministic)
+        {
+            ImGui::Text("Checksum: %016llx", Stats.Checksum);
+        }
+        ImGui::Text("Steps Last Frame: %d, Dropped: %.3fs, Alpha: %.2f", Stats.StepsLastFrame, Stats.DroppedTime,
+                    Scene->InterpolationAlpha);
+    }
+
+    if (ImGui::CollapsingHeader("Memory"))
+    {
+        freelist_allocator_stats Stats;
+        GetFreelistAllocator(MEMTYPE_FREELISTGLOBAL)->GetStats(&Stats);
+        ImGui::Text("Freelist: %.2f/%.2fMB free, %d blocks", (f32)Stats.FreeBytes / MEGABYTES(1),
+                    (f32)Stats.FreelistSize / MEGABYTES(1), Stats.FreeBlockCount);
+        ImGui::Text("Largest Free Block: %.2fMB, Fragmentation: %.1f%%", (f32)Stats.LargestFreeBlock / MEGABYTES(1),
+                    Stats.Fragmentation * 100.0f);
+
+        const slab_stats &Slabs = Stats.Slabs;
+        ImGui::Text("Slab Pages: %u/%u, Used: %.1fKB/%.1fKB, Fragmentation: %.1f%%", Slabs.PagesInUse,
+                    Slabs.PageCount, (f32)Slabs.UsedBytes / KILOBYTES(1), (f32)Slabs.CommittedBytes / KILOBYTES(1),
+                    Slabs.Fragmentation * 100.0f);
+        ImGui::Text("Slab Allocations: %llu, Fallbacks: %llu", Slabs.AllocationCount, Slabs.FallbackCount);
+
+#if _SHU_DEBUG
+        freelist_allocator *GlobalAllocator = GetFreelistAllocator(MEMTYPE_FREELISTGLOBAL);
+        b32 Recording = (GlobalAllocator->Trace != nullptr);
+        if (ImGui::Button(Recording ? "Stop Recording" : "Record Allocations"))
+        {
+            if (Recording)
+            {
+                GlobalAllocator->Trace = nullptr;
+            }
+            else
+            {
+                // NOTE: The entries can't come from the allocator that is getting recorded.
+                if (GlobalAllocationTrace.Entries == nullptr)
+                {
+                    GlobalAllocationTrace.Initialize(ShuAllocateArray(allocation_trace_entry,
+                                                                      ALLOCATION_TRACE_CAPACITY, MEMTYPE_GLOBAL),
+                                                     ALLOCATION_TRACE_CAPACITY);
+                }
+                GlobalAllocationTrace.Count = 0;
+                GlobalAllocationTrace.Overflowed = false;
+                GlobalAllocator->Trace = &GlobalAllocationTrace;
+            }
+        }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(Recording || GlobalAllocationTrace.Count == 0);
+        if (ImGui::Button("Replay Benchmark"))
+        {
+            allocation_trace_benchmark(&GlobalAllocationTrace, GlobalAllocator->TotalSize);
+        }
+        ImGui::EndDisabled();
+        ImGui::Text("Recorded: %d operations%s", GlobalAllocationTrace.Count,
+                    GlobalAllocationTrace.Overflowed ? " (full)" : "");
+#endif
+        for (i32 ClassIndex = 0; ClassIndex < SLAB_CLASS_COUNT; ++ClassIndex)
+        {
+            const slab_class_stats &Class = Slabs.Classes[ClassIndex];
+            if (Class.PageCount > 0)
+            {
+                ImGui::Text("  %4uB: %u/%u blocks(%.0f%%), %u pages", Class.BlockSize, Class.UsedBlocks,
+                            Class.TotalBlocks, Class.Occupancy * 100.0f, Class.PageCount);
+            }
+        }
+    }
+
+#if _SHU_DEBUG
+    if (ImGui::CollapsingHeader("Textures"))
+    {
+        if (ImGui::Button("PNG Decoder Benchmark"))
+        {
+            png_decoder_benchmark(GlobalPNGBenchmarkPaths, ARRAY_SIZE(GlobalPNGBenchmarkPaths));
+        }
+        if (ImGui::Button("JPEG Decoder Benchmark"))
+        {
+            jpeg_decoder_benchmark(GlobalJPEGBenchmarkPaths, ARRAY_SIZE(GlobalJPEGBenchmarkPaths));
+        }
+        if (ImGui::Button("JPEG Decoder Test"))
+        {
+            jpeg_decoder_test();
+        }
+    }
+#endif
+
 #if CREATE_WIREFRAME_PIPELINE
     ImGui::Checkbox("Toggle Wireframe", (bool *)&GlobalRenderState.WireframeMode);
     ImGui::SliderFloat("Wireframe Line Width", &GlobalRenderState.WireLineWidth, 1.0f, 10.0f);
@@ -490,7 +634,7 @@ OnConvexBodyReady(shoora_shape_convex *Convex, memory_arena *Arena = nullptr)
                         &Convex->VertexBuffer, &Convex->IndexBuffer);
 
     // TODO: Make AddBody Thread Safe.
-    shoora_body *ConvexBody = Scene->AddBody(std::move(body));
+    body_handle ConvexBody = Scene->AddBody(std::move(body));
 }
 #endif
 
@@ -715,14 +859,16 @@ InitScene()
 
 #if 0 // Hinge Joint
     Pos = shu::Vec3f(0, -2.5f, 0);
-    auto *bA = Scene->AddCubeBody(Pos, shu::Vec3f(5), colorU32::Proto_Red, 0.0f, .5f, EulerAngles);
-    auto *bB = Scene->AddCubeBody(shu::Vec3f(0, 2.5f, 0), shu::Vec3f(5), colorU32::Proto_Blue, 1.0f, .5f);
+    body_handle HandleA = Scene->AddCubeBody(Pos, shu::Vec3f(5), colorU32::Proto_Red, 0.0f, .5f, EulerAngles);
+    body_handle HandleB = Scene->AddCubeBody(shu::Vec3f(0, 2.5f, 0), shu::Vec3f(5), colorU32::Proto_Blue, 1.0f, .5f);
+    const shoora_body *bA = Scene->GetBody(HandleA);
+    const shoora_body *bB = Scene->GetBody(HandleB);
 
     hinge_quat_constraint_3d *HingeJoint = ShuAllocateStruct(hinge_quat_constraint_3d, MEMTYPE_GLOBAL);
     new (HingeJoint) hinge_quat_constraint_3d();
 
-    HingeJoint->A = bA;
-    HingeJoint->B = bB;
+    HingeJoint->HandleA = HandleA;
+    HingeJoint->HandleB = HandleB;
     HingeJoint->AnchorPointLS_A = shu::Vec3f(-0.5f, 0.5f, -0.5f);
     HingeJoint->AnchorPointLS_B = shu::Vec3f(-0.5f, -0.5f, -0.5f);
 
@@ -733,20 +879,21 @@ InitScene()
     // bB->LinearVelocity = shu::Vec3f(100,  0,  0);
     // bB->LinearVelocity = shu::Vec3f( 0, 10,  0);
     // bB->LinearVelocity = shu::Vec3f( 0, 0, 10);
-    Scene->Constraints3D.emplace_back(HingeJoint);
+    Scene->AddConstraint3D(HingeJoint);
 
 #endif
 
 #if 0 // Slider Joint
     Pos = shu::Vec3f(0, -2.5f, 0);
-    auto *bA = Scene->AddCubeBody(Pos, shu::Vec3f(5), colorU32::Proto_Red, 0.0f, .5f, EulerAngles); // body A is the slider.
-    auto *bB = Scene->AddCubeBody(shu::Vec3f(0, -2.5f, 0), shu::Vec3f(5), colorU32::Proto_Blue, 1.0f, .5f);
+    body_handle HandleA = Scene->AddCubeBody(Pos, shu::Vec3f(5), colorU32::Proto_Red, 0.0f, .5f, EulerAngles); // body A is the slider.
+    body_handle HandleB = Scene->AddCubeBody(shu::Vec3f(0, -2.5f, 0), shu::Vec3f(5), colorU32::Proto_Blue, 1.0f, .5f);
+    const shoora_body *bB = Scene->GetBody(HandleB);
 
     slider_constraint_3d *SliderJoint = ShuAllocateStruct(slider_constraint_3d, MEMTYPE_GLOBAL);
     new (SliderJoint) slider_constraint_3d();
 
-    SliderJoint->A = bA;
-    SliderJoint->B = bB;
+    SliderJoint->HandleA = HandleA;
+    SliderJoint->HandleB = HandleB;
     SliderJoint->AnchorPointLS_A = shu::Vec3f(0,  0.5f, 0);
     SliderJoint->AnchorPointLS_B = shu::Vec3f(0, -0.5f, 0);
 
@@ -754,20 +901,21 @@ InitScene()
     SliderJoint->AxisLS_A  = SliderAxisLS_A;
     SliderJoint->AxisLS_B = shu::QuatRotateVec(shu::QuatInverse(bB->Rotation), SliderAxisLS_A);
 
-    Scene->Constraints3D.emplace_back(SliderJoint);
+    Scene->AddConstraint3D(SliderJoint);
 
 #endif
 
 #if 0 // Slider Joint Limited
     Pos = shu::Vec3f(0, -2.5f, 0);
-    auto *bA = Scene->AddCubeBody(Pos, shu::Vec3f(90.0f, 2.5f, 2.5f), colorU32::Proto_Red, 0.0f, .5f, EulerAngles); // body A is the slider.
-    auto *bB = Scene->AddCubeBody(shu::Vec3f(0, 1.25f, 0), shu::Vec3f(2.5f), colorU32::Proto_Blue, 1.0f, .5f);
+    body_handle HandleA = Scene->AddCubeBody(Pos, shu::Vec3f(90.0f, 2.5f, 2.5f), colorU32::Proto_Red, 0.0f, .5f, EulerAngles); // body A is the slider.
+    body_handle HandleB = Scene->AddCubeBody(shu::Vec3f(0, 1.25f, 0), shu::Vec3f(2.5f), colorU32::Proto_Blue, 1.0f, .5f);
+    const shoora_body *bB = Scene->GetBody(HandleB);
 
     slider_constraint_limit_3d *SliderJoint = ShuAllocateStruct(slider_constraint_limit_3d, MEMTYPE_GLOBAL);
     new (SliderJoint) slider_constraint_limit_3d();
 
-    SliderJoint->A = bA;
-    SliderJoint->B = bB;
+    SliderJoint->HandleA = HandleA;
+    SliderJoint->HandleB = HandleB;
     SliderJoint->AnchorPointLS_A = shu::Vec3f(0,  0.5f, 0);
     SliderJoint->AnchorPointLS_B = shu::Vec3f(0, -0.5f, 0);
     SliderJoint->MinLimit = -45;
@@ -777,20 +925,21 @@ InitScene()
     SliderJoint->AxisLS_A  = SliderAxisLS_A;
     SliderJoint->AxisLS_B = shu::QuatRotateVec(shu::QuatInverse(bB->Rotation), SliderAxisLS_A);
 
-    Scene->Constraints3D.emplace_back(SliderJoint);
+    Scene->AddConstraint3D(SliderJoint);
     shu::QuaternionTest();
 #endif
 
 #if 1 // Hinge Swing Twist Limited Constraint
     Pos = shu::Vec3f(0, 2.5f, 0);
-    auto *bA = Scene->AddCubeBody(Pos, shu::Vec3f(5), colorU32::Proto_Red, 0.0f, .5f, EulerAngles);
-    auto *bB = Scene->AddCubeBody(Pos + shu::Vec3f(14, 0, 0), shu::Vec3f(20, 5, 5), colorU32::Proto_Blue, 1.0f, .5f);
+    body_handle HandleA = Scene->AddCubeBody(Pos, shu::Vec3f(5), colorU32::Proto_Red, 0.0f, .5f, EulerAngles);
+    body_handle HandleB = Scene->AddCubeBody(Pos + shu::Vec3f(14, 0, 0), shu::Vec3f(20, 5, 5), colorU32::Proto_Blue,
+                                             1.0f, .5f);
 
     cone_twist_constraint *ConeTwist = ShuAllocateStruct(cone_twist_constraint, MEMTYPE_GLOBAL);
     new (ConeTwist) cone_twist_constraint();
 
-    ConeTwist->A = bA;
-    ConeTwist->B = bB;
+    ConeTwist->HandleA = HandleA;
+    ConeTwist->HandleB = HandleB;
     ConeTwist->AnchorPointLS_A = shu::Vec3f( .55f, 0, 0);
     ConeTwist->AnchorPointLS_B = shu::Vec3f(-.55f,  0, 0);
     ConeTwist->ConeLimit = 45;
@@ -801,12 +950,12 @@ InitScene()
     shu::vec3f local_n2 = shu::Vec3f(1, 0, 0);
     ConeTwist->AxisLS_B = local_n2;
 
-    Scene->Constraints3D.emplace_back(ConeTwist);
+    Scene->AddConstraint3D(ConeTwist);
 #endif
 
 #if 0
-    auto *Body = Scene->AddCubeBody(shu::Vec3f(25, 10, 0), shu::Vec3f(2.0f), colorU32::Proto_Blue, 1.0f, 1.0f, shu::Vec3f(0.0f));
-    Body->LinearVelocity = shu::Vec3f(-300.0f, 0, 0);
+    body_handle BodyHandle = Scene->AddCubeBody(shu::Vec3f(25, 10, 0), shu::Vec3f(2.0f), colorU32::Proto_Blue, 1.0f, 1.0f, shu::Vec3f(0.0f));
+    Scene->GetBody(BodyHandle)->LinearVelocity = shu::Vec3f(-300.0f, 0, 0);
 
     Scene->AddCubeBody(shu::Vec3f(-5.0f, 5.0f, 0.0f), shu::Vec3f(1.0f, 50, 50), colorU32::Red, 0.0f, 1.0f);
 
@@ -817,11 +966,12 @@ InitScene()
 #if GJK_STEPTHROUGH
     InitializeGJKDebugTest();
 #else
-    shoora_body *diamond = Scene->AddDiamondBody(shu::Vec3f(0, 8, 10), shu::Vec3f(1.0f), colorU32::Proto_Orange,
-                                                 1.0f, 0.5f, shu::Vec3f(0.0f));
+    body_handle diamond = Scene->AddDiamondBody(shu::Vec3f(0, 8, 10), shu::Vec3f(1.0f), colorU32::Proto_Orange,
+                                                1.0f, 0.5f, shu::Vec3f(0.0f));
     AddStandardSandBox();
 
-    shoora_body *SphereBody = Scene->AddSphereBody(shu::Vec3f(10, 8, 10), colorU32::White, .5f, 1.0f, .5f);
+    shoora_body *SphereBody = Scene->GetBody(Scene->AddSphereBody(shu::Vec3f(10, 8, 10), colorU32::White, .5f, 1.0f,
+                                                                  .5f));
     SphereBody->LinearVelocity = shu::Vec3f(-10, 0, 0);
     SphereBody->FrictionCoeff = .5f;
 #endif
@@ -831,14 +981,17 @@ InitScene()
     i32 NumJoints = 10;
 
     shu::vec3f AnchorPos = shu::Vec3f(0, 15, 5);
-    shoora_body *anchor = Scene->AddCubeBody(AnchorPos, shu::Vec3f(0.5f), colorU32::White, 0.0f, .5f);
+    body_handle anchor = Scene->AddCubeBody(AnchorPos, shu::Vec3f(0.5f), colorU32::White, 0.0f, .5f);
     for(i32 i = 1; i < NumJoints; ++i)
     {
-        shoora_body *JointAnchorBody = Scene->GetBody(i - 1);
+        body_handle JointAnchorHandle = Scene->GetBodyHandle(Scene->GetBody(i - 1));
 
         // shu::vec3f Delta = shu::Vec3f((f32)i * .5f, -(f32)i * 1.5f, 0.0f);
         shu::vec3f Delta = shu::Vec3f(0, -(f32)i, 0.0f);
-        shoora_body *Body = Scene->AddCubeBody(AnchorPos + Delta, shu::Vec3f(0.5f), colorU32::White, 1.0f, .5f);
+        body_handle BodyHandle = Scene->AddCubeBody(AnchorPos + Delta, shu::Vec3f(0.5f), colorU32::White, 1.0f, .5f);
+        // NOTE: Adding the body can move the others, so they are looked up after it.
+        shoora_body *JointAnchorBody = Scene->GetBody(JointAnchorHandle);
+        shoora_body *Body = Scene->GetBody(BodyHandle);
         Body->LinearVelocity = shu::Vec3f(5.0f, 0.0f, 0.0f);
 
         shu::vec3f JointAnchorWS = JointAnchorBody->Position;
@@ -846,11 +999,11 @@ InitScene()
         joint_constraint_3d *Joint = ShuAllocateStruct(joint_constraint_3d, MEMTYPE_GLOBAL);
         new (Joint) joint_constraint_3d();
 
-        Joint->A = JointAnchorBody;
-        Joint->AnchorPointLS_A = Joint->A->WorldToLocalSpace(JointAnchorWS);
-        Joint->B = Body;
-        Joint->AnchorPointLS_B = Joint->B->WorldToLocalSpace(JointAnchorWS);
-        Scene->Constraints3D.emplace_back(Joint);
+        Joint->HandleA = JointAnchorHandle;
+        Joint->AnchorPointLS_A = JointAnchorBody->WorldToLocalSpace(JointAnchorWS);
+        Joint->HandleB = BodyHandle;
+        Joint->AnchorPointLS_B = Body->WorldToLocalSpace(JointAnchorWS);
+        Scene->AddConstraint3D(Joint);
     }
 
     Scene->AddCubeBody(shu::Vec3f(1, 10, 5), shu::Vec3f(0.5f), colorU32::Proto_Orange, 0.0f, 1.0f);
@@ -867,8 +1020,8 @@ InitScene()
     {
         // shu::vec3f RandRotation = shu::Vec3f(0.0f, Rand.RangeBetweenF32(-360.0f, 360.0f), 0.0f);
         shu::vec3f RandRotation = shu::Vec3f(0.0f, 0.0f, 0.0f);
-        Body = Scene->AddCubeBody(shu::Vec3f(0, startY + (f32)i, 0), shu::Vec3f(1.0f),
-                                  GetDebugColor(Rand.NextUInt32()), 1.0f, .5f, RandRotation);
+        Body = Scene->GetBody(Scene->AddCubeBody(shu::Vec3f(0, startY + (f32)i, 0), shu::Vec3f(1.0f),
+                                                 GetDebugColor(Rand.NextUInt32()), 1.0f, .5f, RandRotation));
         Body->FrictionCoeff = .5f;
     }
 
@@ -889,7 +1042,8 @@ InitScene()
             f32 Mass = 1.0f;
             f32 Restitution = 0.5f;
 
-            auto *b = Scene->AddSphereBody(shu::Vec3f(xx, 100.0f, zz), colorU32::Proto_Orange, Radius, Mass, Restitution);
+            shoora_body *b = Scene->GetBody(Scene->AddSphereBody(shu::Vec3f(xx, 100.0f, zz), colorU32::Proto_Orange,
+                                                                 Radius, Mass, Restitution));
             b->FrictionCoeff = 0.5f;
             b->LinearVelocity = shu::Vec3f(0.0f);
         }
@@ -907,7 +1061,8 @@ InitScene()
             f32 Mass = 0.0f;
             f32 Restitution = 0.99f;
 
-            auto *b = Scene->AddSphereBody(shu::Vec3f(xx, 10.0f, zz), colorU32::Gray, Radius, Mass, Restitution);
+            shoora_body *b = Scene->GetBody(Scene->AddSphereBody(shu::Vec3f(xx, 10.0f, zz), colorU32::Gray, Radius,
+                                                                 Mass, Restitution));
             b->FrictionCoeff = 0.5f;
             b->LinearVelocity = shu::Vec3f(0.0f);
         }
@@ -1101,9 +1256,13 @@ InitializeVulkanRenderer(shoora_vulkan_context *VulkanContext, shoora_platform_a
 
 #if RENDER_SPONZA
     // NOTE: This is for Sponza Scene Gemoetry. Loading all meshes, textures and everything else related to it!.
+    // NOTE: VertexFormat_Compact or VertexFormat_Quantized for the smaller vertices, with the compact vertex shader.
+    const shoora_vertex_format SponzaVertexFormat = VertexFormat_Full;
+    const char *SponzaVertexShader = (SponzaVertexFormat == VertexFormat_Full) ? "shaders/spirv/sponza.vert.spv" :
+                                                                                "shaders/spirv/sponza_compact.vert.spv";
     SetupGeometry(RenderDevice, &VulkanContext->Geometry, &VulkanContext->Camera, GlobalVertUniformData.Projection,
-                  VulkanContext->GraphicsRenderPass, "meshes/sponza/Sponza.gltf", "shaders/spirv/sponza.vert.spv",
-                  "shaders/spirv/sponza.frag.spv");
+                  VulkanContext->GraphicsRenderPass, "meshes/sponza/Sponza.gltf", SponzaVertexShader,
+                  "shaders/spirv/sponza.frag.spv", SponzaVertexFormat);
     const char *ppTexturePaths[] =
     {
         "images/cobblestone.png",
@@ -1223,14 +1382,12 @@ DrawCoordinateAxes()
     shoora_graphics::DrawLine3D(shu::Vec3f(0, 0, -1000), shu::Vec3f(0, 0, 1000), colorU32::Proto_Blue);
 }
 
-static i32 NumPhysicsTicks = 60;
-static f32 FixedDeltaTime = 1.0f / (f32)NumPhysicsTicks;
-static f32 _dt = 0.0f;
 void
 DrawFrameInVulkan(shoora_platform_frame_packet *FramePacket)
 {
     Scene->Bodies[0].Position = Pos;
     Scene->Bodies[0].Rotation = shu::QuatFromEuler(EulerAngles.x, EulerAngles.y, EulerAngles.z);
+    Scene->MarkTransformsStale();
 
     // VK_CHECK(vkQueueWaitIdle(Context->Device.GraphicsQueue));
     shu::vec2f CurrentMousePos = shu::Vec2f(FramePacket->MouseXPos, FramePacket->MouseYPos);
@@ -1406,13 +1563,7 @@ DrawFrameInVulkan(shoora_platform_frame_packet *FramePacket)
 #else
         // Scene->UpdateInput(CurrentMouseWorldPos);
         f32 pDt = GlobalPausePhysics ? 0.0f : GlobalDeltaTime;
-        _dt += GlobalDeltaTime;
-        if(_dt >= FixedDeltaTime)
-        {
-            // LogInfo("FDT: %f.\n", FixedDeltaTime);
-            Scene->PhysicsUpdate(FixedDeltaTime, GlobalDebugMode);
-            _dt = 0.0f;
-        }
+        Scene->Step(pDt, GlobalDebugMode);
 #endif
         DrawScene(DrawCmdBuffer);
 
@@ -1463,6 +1614,7 @@ DestroyVulkanRenderer(shoora_vulkan_context *Context)
     VK_CHECK(vkDeviceWaitIdle(Context->Device.LogicalDevice));
     shoora_vulkan_device *RenderDevice = &Context->Device;
     // delete Scene;
+    GlobalPhysicsSnapshot.Free();
     ImGuiCleanup(RenderDevice, &Context->ImContext);
     CleanupGeometry(RenderDevice, &Context->Geometry);
 
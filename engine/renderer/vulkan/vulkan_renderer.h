@@ -218,6 +218,10 @@ struct shader_data
         shu::mat4f View;
         shu::vec4f LightPosition;
         shu::vec4f ViewPosition;
+        // NOTE: The mesh filter's PositionDequant, for the quantized vertices. Only the compact vertex shader reads
+        // them.
+        shu::vec4f PositionDequantScale;
+        shu::vec4f PositionDequantOffset;
     } Values;
 };
 
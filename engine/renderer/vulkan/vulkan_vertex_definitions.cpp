@@ -1,12 +1,13 @@
 #include "vulkan_vertex_definitions.h"
+#include <mesh/vertex_packing.h>
 
 VkVertexInputBindingDescription
-GetVertexBindingDescription()
+GetVertexBindingDescription(shoora_vertex_format Format)
 {
     VkVertexInputBindingDescription BindingDesc;
 
     BindingDesc.binding = 0;
-    BindingDesc.stride = sizeof(shoora_vertex_info);
+    BindingDesc.stride = GetVertexFormatSize(Format);
     BindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
     return BindingDesc;
@@ -24,9 +25,38 @@ GetVertexAttributeDescription(u32 BindingIndex, u32 Location, VkFormat Format, u
     return Desc;
 }
 
+// NOTE: The compact formats only differ in the position, everything after it is at the same place in both.
+template <typename vertex_type>
+static void
+GetPackedVertexAttributeDescriptions(VkVertexInputAttributeDescription *Attributes, u32 *AttributeCount,
+                                     VkFormat PositionFormat)
+{
+    *AttributeCount = 5;
+    Attributes[0] = GetVertexAttributeDescription(0, 0, PositionFormat, (u32)OFFSET_OF(vertex_type, Pos));
+    Attributes[1] = GetVertexAttributeDescription(0, 1, VK_FORMAT_R16G16_SNORM, (u32)OFFSET_OF(vertex_type, Normal));
+    Attributes[2] = GetVertexAttributeDescription(0, 2, VK_FORMAT_R8G8B8A8_UNORM, (u32)OFFSET_OF(vertex_type, Color));
+    Attributes[3] = GetVertexAttributeDescription(0, 3, VK_FORMAT_R16G16_SFLOAT, (u32)OFFSET_OF(vertex_type, UV));
+    Attributes[4] = GetVertexAttributeDescription(0, 4, VK_FORMAT_R16G16_SNORM, (u32)OFFSET_OF(vertex_type, Tangent));
+}
+
 void
-GetVertexAttributeDescriptions(VkVertexInputAttributeDescription *Attributes, u32 *AttributeCount)
+GetVertexAttributeDescriptions(VkVertexInputAttributeDescription *Attributes, u32 *AttributeCount,
+                               shoora_vertex_format Format)
 {
+    if(Format == VertexFormat_Compact)
+    {
+        GetPackedVertexAttributeDescriptions<shoora_vertex_info_compact>(Attributes, AttributeCount,
+                                                                         VK_FORMAT_R32G32B32_SFLOAT);
+        return;
+    }
+    if(Format == VertexFormat_Quantized)
+    {
+        GetPackedVertexAttributeDescriptions<shoora_vertex_info_quantized>(Attributes, AttributeCount,
+                                                                           VK_FORMAT_R16G16B16A16_UNORM);
+        return;
+    }
+    ASSERT(Format == VertexFormat_Full);
+
 #if CALCULATE_BITANGENT
     *AttributeCount = 6;
 #else
@@ -2,6 +2,7 @@
 #include "defines.h"
 #include "volk/volk.h"
 #include "vulkan_renderer.h"
+#include <mesh/mesh_filter.h>
 
 #define CALCULATE_BITANGENT 0
 
@@ -17,8 +18,33 @@ struct shoora_vertex_info
 #endif
 };
 
-VkVertexInputBindingDescription GetVertexBindingDescription();
-void GetVertexAttributeDescriptions(VkVertexInputAttributeDescription *Attributes, u32 *AttributeCount);
+// NOTE: The compact vertices(mesh/vertex_packing.h). Normal and Tangent are octahedral encoded snorm16 pairs, UV is
+// two halfs and Color is unorm8 with the tangent's handedness in the alpha(0 for -1, 255 for +1). The vertex shader
+// decodes the normal and the tangent, the rest come out of the vertex fetch as floats.
+struct shoora_vertex_info_compact
+{
+    shu::vec3f Pos;
+    i16 Normal[2];
+    i16 Tangent[2];
+    u16 UV[2];
+    u8 Color[4];
+};
+
+// NOTE: Same as the compact one, with unorm16 positions inside the mesh's bounds. The fourth one is padding, the
+// mesh filter's PositionDequant turns them back into model space positions.
+struct shoora_vertex_info_quantized
+{
+    u16 Pos[4];
+    i16 Normal[2];
+    i16 Tangent[2];
+    u16 UV[2];
+    u8 Color[4];
+};
+
+VkVertexInputBindingDescription GetVertexBindingDescription(shoora_vertex_format Format = VertexFormat_Full);
+// NOTE: The locations are the same for all the formats: 0 Pos, 1 Normal, 2 Color, 3 UV, 4 Tangent.
+void GetVertexAttributeDescriptions(VkVertexInputAttributeDescription *Attributes, u32 *AttributeCount,
+                                    shoora_vertex_format Format = VertexFormat_Full);
 VkVertexInputAttributeDescription GetVertexAttributeDescription(u32 BindingIndex, u32 Location, VkFormat Format,
                                                                 u32 Offset);
 
@@ -1,7 +1,12 @@
 #include "random.h"
 
 #include <platform/platform.h>
+#include <math/math.h>
 
+#if _SHU_DEBUG
+#include <random>
+
+// NOTE: What shoora_random used to be, it walked through this table. Only kept for RandomBenchmark.
 static u32 RandomNumberTable[] =
 {
     0x4f0143b, 0x3402005, 0x26f2b01, 0x22796b6, 0x57343bb, 0x2d9954e, 0x06f9425, 0x1789180,
@@ -517,37 +522,95 @@ static u32 RandomNumberTable[] =
     0x1d46fff, 0x146703c, 0x07dc71f, 0x05a6b46, 0x53660a3, 0x3b4b5c9, 0x4ec4cbb, 0x248ae53,
     0x0d5d155, 0x4363005, 0x2cbd064, 0x5c18f03, 0x214bedd, 0x42ef202, 0x41827cd, 0x27a8fe9,
 };
+#endif
+
+#define PCG32_MULTIPLIER 6364136223846793005ULL
+
+// NOTE: Output of PCG32 for the state before the step.
+static inline u32
+PCG32Output(u64 State)
+{
+    u32 XorShifted = (u32)(((State >> 18u) ^ State) >> 27u);
+    u32 Rotation = (u32)(State >> 59u);
+    return (XorShifted >> Rotation) | (XorShifted << ((0u - Rotation) & 31u));
+}
+
+// NOTE: Delta steps of State*Multiplier + Increment folded into one State*AccMultiplier + AccIncrement, by squaring.
+// (Brown, "Random Number Generation with Arbitrary Stride")
+static void
+PCG32Stride(u64 Delta, u64 Increment, u64 &AccMultiplier, u64 &AccIncrement)
+{
+    u64 Multiplier = PCG32_MULTIPLIER;
+    AccMultiplier = 1u;
+    AccIncrement = 0u;
+    while(Delta > 0)
+    {
+        if(Delta & 1u)
+        {
+            AccMultiplier *= Multiplier;
+            AccIncrement = AccIncrement*Multiplier + Increment;
+        }
+        Increment = (Multiplier + 1u)*Increment;
+        Multiplier *= Multiplier;
+        Delta >>= 1u;
+    }
+}
 
 shoora_random::shoora_random()
 {
-    Index = 0;
+    this->Seed(0);
 }
 
-shoora_random::shoora_random(u32 RandomSeed)
+shoora_random::shoora_random(u64 RandomSeed, u64 Stream)
 {
-    Index = RandomSeed % ARRAY_SIZE(RandomNumberTable);
+    this->Seed(RandomSeed, Stream);
+}
+
+void
+shoora_random::Seed(u64 RandomSeed, u64 Stream)
+{
+    this->State = 0u;
+    this->Increment = (Stream << 1u) | 1u;
+    this->NextU32();
+    this->State += RandomSeed;
+    this->NextU32();
+}
+
+void
+shoora_random::Advance(u64 Delta)
+{
+    u64 AccMultiplier, AccIncrement;
+    PCG32Stride(Delta, this->Increment, AccMultiplier, AccIncrement);
+    this->State = this->State*AccMultiplier + AccIncrement;
 }
 
 u32
 shoora_random::GetSeed()
 {
-    u32 Seed = RandomNumberTable[this->Index++];
+    u32 Seed = this->NextU32();
     return Seed;
 }
 
 u32
 shoora_random::NextU32()
 {
-    this->Index = (this->Index + 1) % ARRAY_SIZE(RandomNumberTable);
-    u32 Result = RandomNumberTable[this->Index];
+    u64 OldState = this->State;
+    this->State = OldState*PCG32_MULTIPLIER + this->Increment;
 
+    u32 Result = PCG32Output(OldState);
     return Result;
 }
 
+static inline f32
+U32ToR01(u32 Value)
+{
+    return (f32)(Value >> 8u) * (1.0f / 16777216.0f);
+}
+
 f32
 shoora_random::R01()
 {
-    f32 Result = (f32)NextU32() / (f32)MaxRandomNumber;
+    f32 Result = U32ToR01(NextU32());
     return Result;
 }
 
@@ -563,7 +626,8 @@ u32
 shoora_random::Between(u32 Min, u32 Max)
 {
     ASSERT(Max > Min);
-    u32 d = (u32)((f32)(Max - Min) * R01());
+    // NOTE: The 32x32 bit product, the top half is in [0, Max - Min).
+    u32 d = (u32)(((u64)NextU32() * (u64)(Max - Min)) >> 32u);
     u32 Result = Min + d;
 
     return Result;
@@ -573,8 +637,8 @@ i32
 shoora_random::Between(i32 Min, i32 Max)
 {
     ASSERT(Max > Min);
-    i32 d = (i32)((f32)(Max - Min) * R01());
-    i32 Result = Min + d;
+    u32 d = (u32)(((u64)NextU32() * (u64)((u32)Max - (u32)Min)) >> 32u);
+    i32 Result = (i32)((u32)Min + d);
 
     return Result;
 }
@@ -586,35 +650,221 @@ shoora_random::Between(f32 Min, f32 Max)
     return Result;
 }
 
-// void RandomTest()
-// {
-//     shoora_random Rand(0x123);
-//     LogDebugUnformatted("Random Test!\n");
-
-//     for (i32 i = 0; i < 1000; ++i) {
-//         f32 r = Rand.R01();
-//         LogDebug("Rand[%d]: %f.\n", i, r);
-//         ASSERT(r >= 0.0f && r <= 1.0f);
-//     }
-
-//     for (i32 i = 0; i < 1000; ++i) {
-//         f32 r = Rand.Bilateral();
-//         LogWarn("Rand[%d]: %f.\n", i, r);
-//         ASSERT(r >= -1.0f && r <= 1.0f);
-//     }
-
-//     for (i32 i = 0; i < 1000; ++i) {
-//         u32 r = Rand.Between(12U, 35U);
-//         LogDebug("Rand[%d]: %u.\n", i, r);
-//         ASSERT(r >= 12 && r <= 35);
-//     }
-
-//     for (i32 i = 0; i < 1000; ++i) {
-//         f32 r = Rand.Between(-12.0f, 35.0f);
-//         LogDebug("Rand[%d]: %f.\n", i, r);
-//         ASSERT(r >= -12.0f && r <= 35.0f);
-//     }
-// }
+void
+shoora_random::Fill(u32 *Out, i32 Count)
+{
+    // NOTE: Lane i starts i steps ahead and every lane moves 4 steps at a time, so together they give the sequence in
+    // order.
+    i32 WideCount = Count & ~3;
+    if(WideCount > 0)
+    {
+        u64 Lanes[4];
+        Lanes[0] = this->State;
+        for(i32 i = 1; i < 4; ++i)
+        {
+            Lanes[i] = Lanes[i - 1]*PCG32_MULTIPLIER + this->Increment;
+        }
+
+        u64 StrideMultiplier, StrideIncrement;
+        PCG32Stride(4, this->Increment, StrideMultiplier, StrideIncrement);
+        for(i32 First = 0; First < WideCount; First += 4)
+        {
+            for(i32 i = 0; i < 4; ++i)
+            {
+                Out[First + i] = PCG32Output(Lanes[i]);
+                Lanes[i] = Lanes[i]*StrideMultiplier + StrideIncrement;
+            }
+        }
+        this->State = Lanes[0];
+    }
+
+    for(i32 i = WideCount; i < Count; ++i)
+    {
+        Out[i] = this->NextU32();
+    }
+}
+
+void
+shoora_random::Fill(f32 *Out, i32 Count, f32 Min, f32 Max)
+{
+    // NOTE: The raw numbers go into a small buffer and get turned into floats in a second loop, which the compiler
+    // can vectorize.
+    u32 Buffer[256];
+    const f32 Range = Max - Min;
+    for(i32 First = 0; First < Count; First += ARRAY_SIZE(Buffer))
+    {
+        i32 ChunkCount = MIN((i32)ARRAY_SIZE(Buffer), Count - First);
+        this->Fill(Buffer, ChunkCount);
+        for(i32 i = 0; i < ChunkCount; ++i)
+        {
+            Out[First + i] = Min + Range*U32ToR01(Buffer[i]);
+        }
+    }
+}
+
+void
+shoora_random::Fill(shu::vec3f *Out, i32 Count, const shu::vec3f &Min, const shu::vec3f &Max)
+{
+    u32 Buffer[3*128];
+    const shu::vec3f Range = Max - Min;
+    for(i32 First = 0; First < Count; First += 128)
+    {
+        i32 ChunkCount = MIN(128, Count - First);
+        this->Fill(Buffer, 3*ChunkCount);
+        for(i32 i = 0; i < ChunkCount; ++i)
+        {
+            Out[First + i].x = Min.x + Range.x*U32ToR01(Buffer[3*i + 0]);
+            Out[First + i].y = Min.y + Range.y*U32ToR01(Buffer[3*i + 1]);
+            Out[First + i].z = Min.z + Range.z*U32ToR01(Buffer[3*i + 2]);
+        }
+    }
+}
+
+#if _SHU_DEBUG
+void
+RandomTest()
+{
+    shoora_random Random(0x123);
+    for(i32 i = 0; i < 10000; ++i)
+    {
+        f32 r = Random.R01();
+        ASSERT(r >= 0.0f && r < 1.0f);
+        r = Random.Bilateral();
+        ASSERT(r >= -1.0f && r < 1.0f);
+        u32 u = Random.Between(12u, 35u);
+        ASSERT(u >= 12 && u < 35);
+        i32 s = Random.Between(-12, 35);
+        ASSERT(s >= -12 && s < 35);
+        r = Random.Between(-12.0f, 35.0f);
+        ASSERT(r >= -12.0f && r < 35.0f);
+    }
+
+    // NOTE: Roughly even buckets.
+    i32 Buckets[16] = {};
+    for(i32 i = 0; i < 160000; ++i)
+    {
+        Buckets[Random.Between(0u, 16u)]++;
+    }
+    for(i32 i = 0; i < 16; ++i)
+    {
+        ASSERT(Buckets[i] > 9400 && Buckets[i] < 10600);
+    }
+
+    // NOTE: Jumping ahead lands where stepping does, and jumping back undoes it.
+    shoora_random Stepped(0xfeed, 7), Jumped(0xfeed, 7);
+    for(i32 i = 0; i < 1000; ++i)
+    {
+        Stepped.NextU32();
+    }
+    Jumped.Advance(1000);
+    ASSERT(Stepped.State == Jumped.State && Stepped.NextU32() == Jumped.NextU32());
+    Jumped.Advance((u64)-1001);
+    ASSERT(Jumped.State == shoora_random(0xfeed, 7).State);
+
+    // NOTE: Other streams off the same seed do not follow each other.
+    shoora_random StreamA(0xfeed, 0), StreamB(0xfeed, 1);
+    i32 Same = 0;
+    for(i32 i = 0; i < 1000; ++i)
+    {
+        Same += (StreamA.NextU32() == StreamB.NextU32());
+    }
+    ASSERT(Same < 2);
+
+    // NOTE: Fill gives the same numbers as one at a time, for every tail length.
+    for(i32 Count = 0; Count < 70; ++Count)
+    {
+        shoora_random One(Count), Many(Count);
+        u32 Values[70];
+        Many.Fill(Values, Count);
+        for(i32 i = 0; i < Count; ++i)
+        {
+            ASSERT(Values[i] == One.NextU32());
+        }
+        ASSERT(One.State == Many.State);
+    }
+
+    shoora_random One(99), Many(99);
+    f32 Floats[1000];
+    Many.Fill(Floats, ARRAY_SIZE(Floats), -2.0f, 5.0f);
+    for(i32 i = 0; i < ARRAY_SIZE(Floats); ++i)
+    {
+        ASSERT(Floats[i] == One.Between(-2.0f, 5.0f));
+    }
+
+    shu::vec3f Points[300];
+    Many.Fill(Points, ARRAY_SIZE(Points), shu::Vec3f(-1.0f, 0.0f, 10.0f), shu::Vec3f(1.0f, 2.0f, 20.0f));
+    for(i32 i = 0; i < ARRAY_SIZE(Points); ++i)
+    {
+        ASSERT(Points[i].x == One.Between(-1.0f, 1.0f));
+        ASSERT(Points[i].y == One.Between(0.0f, 2.0f));
+        ASSERT(Points[i].z == One.Between(10.0f, 20.0f));
+    }
+
+    LogInfo("[Random Test]: Passed.\n");
+}
+
+static inline f32
+BenchmarkMs(u64 Start)
+{
+    return 1000.0f * Platform_GetSecondsElapsed(Start, Platform_GetWallClock());
+}
+
+// NOTE: Count floats in [0, 1) from the old table walk, std::mt19937(what shoora_random_std wraps), PCG32 one at a
+// time and PCG32 Fill. The sums only make sure the compiler does not throw the work away.
+void
+RandomBenchmark()
+{
+    const i32 Count = 1 << 24;
+    const i32 ChunkCount = 4096;
+    f32 *Values = (f32 *)malloc(sizeof(f32) * ChunkCount);
+
+    f32 TableSum = 0.0f;
+    u64 Start = Platform_GetWallClock();
+    u32 TableIndex = 0;
+    for(i32 i = 0; i < Count; ++i)
+    {
+        TableIndex = (TableIndex + 1) % ARRAY_SIZE(RandomNumberTable);
+        TableSum += (f32)RandomNumberTable[TableIndex] / (f32)0x05f5c21f;
+    }
+    f32 TableMs = BenchmarkMs(Start);
+
+    f32 StdSum = 0.0f;
+    std::mt19937 MT(0x123);
+    std::uniform_real_distribution<f32> Distribution(0.0f, 1.0f);
+    Start = Platform_GetWallClock();
+    for(i32 i = 0; i < Count; ++i)
+    {
+        StdSum += Distribution(MT);
+    }
+    f32 StdMs = BenchmarkMs(Start);
+
+    f32 PCGSum = 0.0f;
+    shoora_random Random(0x123);
+    Start = Platform_GetWallClock();
+    for(i32 i = 0; i < Count; ++i)
+    {
+        PCGSum += Random.R01();
+    }
+    f32 PCGMs = BenchmarkMs(Start);
+
+    f32 FillSum = 0.0f;
+    Start = Platform_GetWallClock();
+    for(i32 First = 0; First < Count; First += ChunkCount)
+    {
+        Random.Fill(Values, ChunkCount);
+        FillSum += Values[(First / ChunkCount) & (ChunkCount - 1)];
+    }
+    f32 FillMs = BenchmarkMs(Start);
+
+    LogInfo("[Random Benchmark]: %d floats(sums %f, %f, %f, %f).\n", Count, TableSum, StdSum, PCGSum, FillSum);
+    LogInfo("  table        %8.3fms.\n", TableMs);
+    LogInfo("  std::mt19937 %8.3fms.\n", StdMs);
+    LogInfo("  pcg32        %8.3fms.\n", PCGMs);
+    LogInfo("  pcg32 Fill   %8.3fms.\n", FillMs);
+
+    free(Values);
+}
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2,6 +2,12 @@
 #define SHOORA_RANDOM_H
 
 #include <defines.h>
+
+namespace shu
+{
+    template <typename T> struct vec3;
+}
+
 #if IMPLEMENT_STD_RANDOM
     #include <random>
     #include <chrono>
@@ -30,25 +36,46 @@
     void RandomTestSTD();
 #endif
 
-#define MaxRandomNumber 0x05f5c21f
-#define MinRandomNumber 0x000025a0
-
+    // NOTE: PCG32(pcg-random.org). 64 bits of state and an odd increment which picks one of 2^63 streams, two
+    // generators with the same seed on different streams give unrelated sequences. So each thread or job can get its
+    // own stream off one seed and stay deterministic whatever order they run in.
+    // Advance() jumps the generator forward(or back, the delta wraps) in O(log Delta) steps, for handing out
+    // non overlapping chunks of one sequence.
     struct shoora_random
     {
-        u32 Index;
+        u64 State;
+        u64 Increment;
 
         shoora_random();
-        shoora_random(u32 RandomSeed);
+        shoora_random(u64 RandomSeed, u64 Stream = 0);
 
+        void Seed(u64 RandomSeed, u64 Stream = 0);
+        void Advance(u64 Delta);
+
+        // NOTE: A value to seed another generator with.
         u32 GetSeed();
         u32 NextU32();
+        // NOTE: [0, 1) with 24 bits, every f32 step in the range can come out.
         f32 R01();
+        // NOTE: [-1, 1).
         f32 Bilateral();
+        // NOTE: [Min, Max).
         i32 Between(i32 Min, i32 Max);
         u32 Between(u32 Min, u32 Max);
         f32 Between(f32 Min, f32 Max);
+
+        // NOTE: The same numbers NextU32(), Between(f32) calls would have given, in the same order, and the generator
+        // ends up in the same state. Four states are stepped side by side, so it does not wait on one multiply after
+        // the other.
+        void Fill(u32 *Out, i32 Count);
+        void Fill(f32 *Out, i32 Count, f32 Min = 0.0f, f32 Max = 1.0f);
+        // NOTE: x, y and z of every vector in that order.
+        void Fill(shu::vec3<f32> *Out, i32 Count, const shu::vec3<f32> &Min, const shu::vec3<f32> &Max);
     };
 
-    // void RandomTest();
+#if _SHU_DEBUG
+    void RandomTest();
+    void RandomBenchmark();
+#endif
 
 #endif
@@ -0,0 +1,197 @@
+#include "sort.h"
+
+#if _SHU_DEBUG
+#include <physics/broadphase.h>
+#include <physics/contact.h>
+#include <utils/random/random.h>
+
+template <typename T, typename less_fn>
+static b32
+IsSorted(const T *Items, i32 Count, less_fn Less)
+{
+    for(i32 i = 1; i < Count; ++i)
+    {
+        if(Less(Items[i], Items[i - 1]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// NOTE: Checks every sort against MergeSortStable. The keys only take a few values, so there are lots of equal
+// keys and the stable sorts also have to agree on the order of the payload.
+void
+sort_test()
+{
+    struct keyed_item
+    {
+        u32 Key;
+        i32 Payload;
+    };
+    auto Less = [](const keyed_item &A, const keyed_item &B) { return A.Key < B.Key; };
+    auto LessEqual = [](const keyed_item &A, const keyed_item &B) -> b32 { return A.Key <= B.Key; };
+
+    const i32 MaxCount = 20000;
+    keyed_item *Items = (keyed_item *)malloc(sizeof(keyed_item) * MaxCount);
+    keyed_item *Expected = (keyed_item *)malloc(sizeof(keyed_item) * MaxCount);
+    keyed_item *Sorted = (keyed_item *)malloc(sizeof(keyed_item) * MaxCount);
+    keyed_item *Scratch = (keyed_item *)malloc(sizeof(keyed_item) * MaxCount);
+
+    shoora_random Random(0x5eed5);
+    i32 Counts[] = {0, 1, 2, 3, 17, 63, 64, 65, 1000, MaxCount};
+    for(i32 CountIndex = 0; CountIndex < ARRAY_SIZE(Counts); ++CountIndex)
+    {
+        i32 Count = Counts[CountIndex];
+        for(i32 Layout = 0; Layout < 3; ++Layout)
+        {
+            for(i32 i = 0; i < Count; ++i)
+            {
+                // NOTE: Random, already sorted and reverse sorted input.
+                u32 Key = Random.Between(0u, 300u) * 0x01010101u;
+                if(Layout == 1) { Key = (u32)i / 4; }
+                if(Layout == 2) { Key = (u32)(Count - i) / 4; }
+                Items[i] = {Key, i};
+            }
+
+            memcpy(Expected, Items, sizeof(keyed_item) * Count);
+            MergeSortStable(Expected, Scratch, Count, (b32 (*)(const keyed_item &, const keyed_item &))LessEqual);
+
+            memcpy(Sorted, Items, sizeof(keyed_item) * Count);
+            IntroSort(Sorted, Count, Less);
+            ASSERT(IsSorted(Sorted, Count, Less));
+
+            memcpy(Sorted, Items, sizeof(keyed_item) * Count);
+            StableSort(Sorted, Scratch, Count, Less);
+            ASSERT(Count == 0 || memcmp(Sorted, Expected, sizeof(keyed_item) * Count) == 0);
+
+            memcpy(Sorted, Items, sizeof(keyed_item) * Count);
+            RadixSort(Sorted, Scratch, Count, [](const keyed_item &Item) { return Item.Key; });
+            ASSERT(Count == 0 || memcmp(Sorted, Expected, sizeof(keyed_item) * Count) == 0);
+
+            memcpy(Sorted, Items, sizeof(keyed_item) * Count);
+            RadixSort(Sorted, Scratch, Count, [](const keyed_item &Item) { return (u64)Item.Key << 20; });
+            ASSERT(Count == 0 || memcmp(Sorted, Expected, sizeof(keyed_item) * Count) == 0);
+        }
+    }
+
+    f32 Floats[] = {3.5f, -0.0f, -1.0f, 0.0f, 1e-30f, -1e30f, 2.0f, -2.5f, 1e30f, -1e-30f};
+    for(i32 i = 1; i < ARRAY_SIZE(Floats); ++i)
+    {
+        ASSERT(SortableU32ToFloat(FloatToSortableU32(Floats[i])) == Floats[i]);
+    }
+    f32 FloatScratch[ARRAY_SIZE(Floats)];
+    RadixSort(Floats, FloatScratch, ARRAY_SIZE(Floats));
+    ASSERT(IsSorted(Floats, ARRAY_SIZE(Floats), [](f32 A, f32 B) { return A < B; }));
+
+    free(Items);
+    free(Expected);
+    free(Sorted);
+    free(Scratch);
+    LogInfoUnformatted("[Sort Test]: Passed.\n");
+}
+
+static inline f32
+SortBenchmarkMs(u64 Start)
+{
+    return 1000.0f * Platform_GetSecondsElapsed(Start, Platform_GetWallClock());
+}
+
+// NOTE: Times every sort on its own copy of Source and prints one line.
+template <typename T, typename key_fn>
+static void
+SortBenchmarkRun(const char *Name, const T *Source, i32 Count, key_fn GetKey, b32 (*LessEqual)(const T &, const T &))
+{
+    T *Items = (T *)malloc(sizeof(T) * Count);
+    T *Scratch = (T *)malloc(sizeof(T) * Count);
+    auto Less = [&GetKey](const T &A, const T &B) { return GetKey(A) < GetKey(B); };
+
+    f32 Times[6];
+    i32 TimeCount = 0;
+
+    memcpy(Items, Source, sizeof(T) * Count);
+    u64 Start = Platform_GetWallClock();
+    QuicksortRecursive(Items, 0, Count, LessEqual);
+    Times[TimeCount++] = SortBenchmarkMs(Start);
+
+    memcpy(Items, Source, sizeof(T) * Count);
+    Start = Platform_GetWallClock();
+    MergeSortStable(Items, Scratch, Count, LessEqual);
+    Times[TimeCount++] = SortBenchmarkMs(Start);
+
+    memcpy(Items, Source, sizeof(T) * Count);
+    Start = Platform_GetWallClock();
+    IntroSort(Items, Count, Less);
+    Times[TimeCount++] = SortBenchmarkMs(Start);
+
+    memcpy(Items, Source, sizeof(T) * Count);
+    Start = Platform_GetWallClock();
+    StableSort(Items, Scratch, Count, Less);
+    Times[TimeCount++] = SortBenchmarkMs(Start);
+
+    memcpy(Items, Source, sizeof(T) * Count);
+    Start = Platform_GetWallClock();
+    RadixSort(Items, Scratch, Count, GetKey);
+    Times[TimeCount++] = SortBenchmarkMs(Start);
+    ASSERT(IsSorted(Items, Count, Less));
+
+    memcpy(Items, Source, sizeof(T) * Count);
+    Start = Platform_GetWallClock();
+    ParallelStableSort(Items, Scratch, Count, Less);
+    Times[TimeCount++] = SortBenchmarkMs(Start);
+    ASSERT(IsSorted(Items, Count, Less));
+
+    LogInfo("  %-28s %7d %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", Name, Count, Times[0], Times[1], Times[2], Times[3],
+            Times[4], Times[5]);
+
+    free(Items);
+    free(Scratch);
+}
+
+// NOTE: Broadphase endpoints(sorted again every frame, so mostly already sorted after the first one) and contact
+// times of impact. The quicksort runs on sorted input are kept small since it goes n^2 deep there.
+void
+sort_benchmark()
+{
+    shoora_random Random(0xb3c4);
+
+    const i32 EndpointCount = 100000;
+    pseudo_body *Endpoints = (pseudo_body *)malloc(sizeof(pseudo_body) * EndpointCount);
+    for(i32 i = 0; i < EndpointCount; ++i)
+    {
+        Endpoints[i].Id = i / 2;
+        Endpoints[i].Value = Random.Between(-500.0f, 500.0f);
+        Endpoints[i].IsMin = (i & 1) == 0;
+    }
+    auto EndpointKey = [](const pseudo_body &Item) { return FloatToSortableU32(Item.Value); };
+    b32 (*EndpointLessEqual)(const pseudo_body &, const pseudo_body &) =
+        [](const pseudo_body &A, const pseudo_body &B) -> b32 { return A.Value <= B.Value; };
+
+    const i32 ContactCount = 2000;
+    contact *Contacts = (contact *)malloc(sizeof(contact) * ContactCount);
+    SHU_MEMZERO(Contacts, sizeof(contact) * ContactCount);
+    for(i32 i = 0; i < ContactCount; ++i)
+    {
+        Contacts[i].TimeOfImpact = Random.Between(0.0f, 1.0f);
+    }
+    auto ContactKey = [](const contact &Item) { return FloatToSortableU32(Item.TimeOfImpact); };
+
+    LogInfoUnformatted("[Sort Benchmark]: Times in ms.\n");
+    LogInfo("  %-28s %7s %9s %9s %9s %9s %9s %9s\n", "", "Count", "Quick", "Merge", "Intro", "Stable", "Radix",
+            "Parallel");
+
+    SortBenchmarkRun("Endpoints random", Endpoints, EndpointCount, EndpointKey, EndpointLessEqual);
+    SortBenchmarkRun("Endpoints random", Endpoints, 2000, EndpointKey, EndpointLessEqual);
+
+    StableSort(Endpoints, Endpoints + 2048, 2048, [&](const pseudo_body &A, const pseudo_body &B) {
+        return EndpointKey(A) < EndpointKey(B);
+    });
+    SortBenchmarkRun("Endpoints sorted", Endpoints, 2048, EndpointKey, EndpointLessEqual);
+
+    SortBenchmarkRun("Contact toi random", Contacts, ContactCount, ContactKey, CompareContacts);
+    SortBenchmarkRun("Contact toi random", Contacts, 64, ContactKey, CompareContacts);
+
+    free(Endpoints);
+    free(Contacts);
+}
+#endif
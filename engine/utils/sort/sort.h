@@ -2,6 +2,17 @@
 
 #include <defines.h>
 #include <containers/stack/stack.h>
+#include <platform/platform.h>
+#include <platform/job_system.h>
+#include <string.h>
+#include <type_traits>
+
+// NOTE: Below this many items insertion sort beats everything else.
+#define SORT_INSERTION_SORT_THRESHOLD 24
+// NOTE: Radix sort has to clear and walk its histograms no matter the count, so small arrays go to insertion sort.
+#define RADIX_SORT_MIN_COUNT 64
+#define PARALLEL_SORT_MIN_CHUNK_SIZE 4096
+#define PARALLEL_SORT_MAX_CHUNKS 16
 
 template <typename T>
 i32
@@ -12,7 +23,7 @@ Partition(T *Arr, i32 Low, i32 High, b32 (*LessEqCmp)(const T &, const T &))
 
     do
     {
-        do { i++; } while (LessEqCmp(Arr[i], pivot) && i < High);
+        do { i++; } while (i < High && LessEqCmp(Arr[i], pivot));
         do { j--; } while (!LessEqCmp(Arr[j], pivot) && j >= Low);
 
         if(i < j) {
@@ -68,7 +79,396 @@ QuicksortRecursive(T *Items, i32 Low, i32 High, b32 (*Cmp)(const T &, const T &)
     QuicksortRecursive(Items, p+1, High, Cmp);
 }
 
-// TODO: Add other sorting algorithms here if needed: Radix sort for integers and merge sort
+// NOTE: Stable merge sort. Items which compare equal keep the order they came in, so the result does not depend
+// on how the pivots happen to fall like it does in the quicksort above. "Scratch" has to hold at least Count items.
+template <typename T>
+void
+MergeSortStable(T *Items, T *Scratch, i32 Count, b32 (*LessEqCmp)(const T &, const T &) = DefaultLessEqualComparator)
+{
+    if(Count <= 1)
+        return;
+
+    // NOTE: Bottom up. Merge runs of Width from Src into Dst and swap the two every pass.
+    T *Src = Items;
+    T *Dst = Scratch;
+    for(i32 Width = 1; Width < Count; Width *= 2)
+    {
+        for(i32 Low = 0; Low < Count; Low += 2*Width)
+        {
+            i32 Mid = MIN(Low + Width, Count);
+            i32 High = MIN(Low + 2*Width, Count);
+
+            i32 i = Low, j = Mid, k = Low;
+            while(i < Mid && j < High)
+            {
+                // NOTE: Taking from the left run when equal is what makes this stable.
+                if(LessEqCmp(Src[i], Src[j])) { Dst[k++] = Src[i++]; }
+                else                          { Dst[k++] = Src[j++]; }
+            }
+            while(i < Mid)  { Dst[k++] = Src[i++]; }
+            while(j < High) { Dst[k++] = Src[j++]; }
+        }
+        SWAP(Src, Dst);
+    }
+
+    if(Src != Items)
+    {
+        for(i32 i = 0; i < Count; ++i)
+        {
+            Items[i] = Src[i];
+        }
+    }
+}
+
+// NOTE: The sorts below take a strict "less than" comparator as a template parameter(a lambda or a functor), so the
+// compiler can inline it. The ones above call a "<=" function pointer for every comparison.
+
+// NOTE: Stable.
+template <typename T, typename less_fn>
+void
+InsertionSort(T *Items, i32 Count, less_fn Less)
+{
+    for(i32 i = 1; i < Count; ++i)
+    {
+        if(!Less(Items[i], Items[i - 1]))
+        {
+            continue;
+        }
+
+        T Item = Items[i];
+        i32 j = i;
+        do
+        {
+            Items[j] = Items[j - 1];
+            --j;
+        } while(j > 0 && Less(Item, Items[j - 1]));
+        Items[j] = Item;
+    }
+}
+
+template <typename T, typename less_fn>
+void
+SortSiftDown(T *Items, i32 Root, i32 Count, less_fn &Less)
+{
+    T Item = Items[Root];
+    for(;;)
+    {
+        i32 Child = 2*Root + 1;
+        if(Child >= Count)
+        {
+            break;
+        }
+        if((Child + 1) < Count && Less(Items[Child], Items[Child + 1]))
+        {
+            ++Child;
+        }
+        if(!Less(Item, Items[Child]))
+        {
+            break;
+        }
+
+        Items[Root] = Items[Child];
+        Root = Child;
+    }
+    Items[Root] = Item;
+}
+
+template <typename T, typename less_fn>
+void
+HeapSort(T *Items, i32 Count, less_fn Less)
+{
+    for(i32 i = Count/2 - 1; i >= 0; --i)
+    {
+        SortSiftDown(Items, i, Count, Less);
+    }
+    for(i32 Last = Count - 1; Last > 0; --Last)
+    {
+        SWAP(Items[0], Items[Last]);
+        SortSiftDown(Items, 0, Last, Less);
+    }
+}
+
+template <typename T, typename less_fn>
+void
+IntroSortLoop(T *Items, i32 Low, i32 High, i32 DepthLimit, less_fn &Less)
+{
+    while((High - Low) > SORT_INSERTION_SORT_THRESHOLD)
+    {
+        // NOTE: The partitions keep coming out lopsided, heap sort bounds the rest to n*log(n).
+        if(DepthLimit == 0)
+        {
+            HeapSort(Items + Low, High - Low, Less);
+            return;
+        }
+        --DepthLimit;
+
+        // NOTE: Median of three, so sorted and reverse sorted input split in the middle.
+        i32 Mid = Low + (High - Low)/2;
+        if(Less(Items[Mid], Items[Low]))      { SWAP(Items[Mid], Items[Low]); }
+        if(Less(Items[High - 1], Items[Mid])) { SWAP(Items[High - 1], Items[Mid]); }
+        if(Less(Items[Mid], Items[Low]))      { SWAP(Items[Mid], Items[Low]); }
+        T Pivot = Items[Mid];
+
+        // NOTE: Hoare partition. Items equal to the pivot get spread over both sides, so lots of equal keys still
+        // split evenly.
+        i32 i = Low - 1;
+        i32 j = High;
+        for(;;)
+        {
+            do { ++i; } while(Less(Items[i], Pivot));
+            do { --j; } while(Less(Pivot, Items[j]));
+            if(i >= j)
+            {
+                break;
+            }
+            SWAP(Items[i], Items[j]);
+        }
+
+        // NOTE: Recurse into the smaller side and loop on the bigger one, so the stack depth stays at log(n).
+        i32 Split = j + 1;
+        if((Split - Low) < (High - Split))
+        {
+            IntroSortLoop(Items, Low, Split, DepthLimit, Less);
+            Low = Split;
+        }
+        else
+        {
+            IntroSortLoop(Items, Split, High, DepthLimit, Less);
+            High = Split;
+        }
+    }
+
+    InsertionSort(Items + Low, High - Low, Less);
+}
+
+// NOTE: Quicksort which falls back to heap sort when it goes too deep, and to insertion sort for small ranges.
+// O(n*log(n)) for any input, already sorted input included. Not stable.
+template <typename T, typename less_fn>
+void
+IntroSort(T *Items, i32 Count, less_fn Less)
+{
+    if(Count <= 1)
+        return;
+
+    i32 DepthLimit = 0;
+    for(i32 n = Count; n > 1; n >>= 1)
+    {
+        DepthLimit += 2;
+    }
+
+    IntroSortLoop(Items, 0, Count, DepthLimit, Less);
+}
+
+template <typename T>
+void
+IntroSort(T *Items, i32 Count)
+{
+    IntroSort(Items, Count, [](const T &A, const T &B) { return A < B; });
+}
+
+// NOTE: Merges the sorted runs [First, Mid) and [Mid, Last) of Src into the same range of Dst. Takes from the left
+// run when the two are equal, which keeps the sort stable.
+template <typename T, typename less_fn>
+void
+SortMergeRuns(const T *Src, T *Dst, i32 First, i32 Mid, i32 Last, less_fn &Less)
+{
+    i32 i = First, j = Mid, k = First;
+    while(i < Mid && j < Last)
+    {
+        if(Less(Src[j], Src[i])) { Dst[k++] = Src[j++]; }
+        else                     { Dst[k++] = Src[i++]; }
+    }
+    while(i < Mid)  { Dst[k++] = Src[i++]; }
+    while(j < Last) { Dst[k++] = Src[j++]; }
+}
+
+// NOTE: Stable. Insertion sorts small runs and merges them bottom up. "Scratch" has to hold at least Count items.
+template <typename T, typename less_fn>
+void
+StableSort(T *Items, T *Scratch, i32 Count, less_fn Less)
+{
+    const i32 RunLength = SORT_INSERTION_SORT_THRESHOLD;
+    for(i32 First = 0; First < Count; First += RunLength)
+    {
+        InsertionSort(Items + First, MIN(RunLength, Count - First), Less);
+    }
+
+    T *Src = Items;
+    T *Dst = Scratch;
+    for(i32 Width = RunLength; Width < Count; Width *= 2)
+    {
+        for(i32 First = 0; First < Count; First += 2*Width)
+        {
+            i32 Mid = MIN(First + Width, Count);
+            i32 Last = MIN(First + 2*Width, Count);
+            SortMergeRuns(Src, Dst, First, Mid, Last, Less);
+        }
+        SWAP(Src, Dst);
+    }
+
+    if(Src != Items)
+    {
+        for(i32 i = 0; i < Count; ++i)
+        {
+            Items[i] = Src[i];
+        }
+    }
+}
+
+// NOTE: Maps a float to an unsigned int which sorts in the same order. Positive floats get their sign bit set so
+// that they come after the negative ones, negative floats get all their bits flipped so that the bigger magnitudes
+// come first. -0 sorts before +0 and NaNs go to the ends.
+inline u32
+FloatToSortableU32(f32 Value)
+{
+    u32 Bits;
+    memcpy(&Bits, &Value, sizeof(u32));
+    u32 Mask = (u32)(-(i32)(Bits >> 31)) | 0x80000000u;
+    u32 Result = Bits ^ Mask;
+    return Result;
+}
+
+inline f32
+SortableU32ToFloat(u32 Key)
+{
+    u32 Mask = ((Key >> 31) - 1) | 0x80000000u;
+    u32 Bits = Key ^ Mask;
+    f32 Result;
+    memcpy(&Result, &Bits, sizeof(u32));
+    return Result;
+}
+
+// NOTE: LSD radix sort, one byte per pass. GetKey returns a u32 or a u64 for an item. Stable. A pass is skipped
+// when every key has the same byte there, so small keys in a u64 cost no more than in a u32.
+// "Scratch" has to hold at least Count items.
+template <typename T, typename key_fn>
+void
+RadixSort(T *Items, T *Scratch, i32 Count, key_fn GetKey)
+{
+    typedef decltype(GetKey(*Items)) key_type;
+    static_assert(std::is_same_v<key_type, u32> || std::is_same_v<key_type, u64>, "Radix sort keys are u32 or u64.");
+    static_assert(std::is_trivially_copyable_v<T>, "Radix sort copies the items with memcpy.");
+    const i32 PassCount = sizeof(key_type);
+
+    if(Count < RADIX_SORT_MIN_COUNT)
+    {
+        InsertionSort(Items, Count, [&GetKey](const T &A, const T &B) { return GetKey(A) < GetKey(B); });
+        return;
+    }
+
+    u32 Histograms[PassCount][256] = {};
+    for(i32 i = 0; i < Count; ++i)
+    {
+        key_type Key = GetKey(Items[i]);
+        for(i32 Pass = 0; Pass < PassCount; ++Pass)
+        {
+            ++Histograms[Pass][(Key >> (Pass*8)) & 0xFF];
+        }
+    }
+
+    T *Src = Items;
+    T *Dst = Scratch;
+    for(i32 Pass = 0; Pass < PassCount; ++Pass)
+    {
+        u32 *Histogram = Histograms[Pass];
+        i32 Shift = Pass*8;
+        if(Histogram[(GetKey(Src[0]) >> Shift) & 0xFF] == (u32)Count)
+        {
+            continue;
+        }
+
+        // NOTE: Counts to the offset each byte value starts at.
+        u32 Offset = 0;
+        for(i32 Digit = 0; Digit < 256; ++Digit)
+        {
+            u32 DigitCount = Histogram[Digit];
+            Histogram[Digit] = Offset;
+            Offset += DigitCount;
+        }
+
+        for(i32 i = 0; i < Count; ++i)
+        {
+            u32 Digit = (u32)(GetKey(Src[i]) >> Shift) & 0xFF;
+            Dst[Histogram[Digit]++] = Src[i];
+        }
+        SWAP(Src, Dst);
+    }
+
+    if(Src != Items)
+    {
+        memcpy(Items, Src, sizeof(T)*Count);
+    }
+}
+
+inline void
+RadixSort(u32 *Items, u32 *Scratch, i32 Count)
+{
+    RadixSort(Items, Scratch, Count, [](u32 Item) { return Item; });
+}
+
+inline void
+RadixSort(f32 *Items, f32 *Scratch, i32 Count)
+{
+    RadixSort(Items, Scratch, Count, [](f32 Item) { return FloatToSortableU32(Item); });
+}
+
+// NOTE: Stable merge sort split over the job system. Every chunk is sorted by one job, then the chunks are merged in
+// pairs, one job per pair, until one run is left. Gives the same result as StableSort. It waits with JobSystem_Wait,
+// so it can be called from a job as well. "Scratch" has to hold at least Count items.
+template <typename T, typename less_fn>
+void
+ParallelStableSort(T *Items, T *Scratch, i32 Count, less_fn Less)
+{
+    if(Count < 2*PARALLEL_SORT_MIN_CHUNK_SIZE)
+    {
+        StableSort(Items, Scratch, Count, Less);
+        return;
+    }
+
+    i32 ChunkCount = PARALLEL_SORT_MAX_CHUNKS;
+    while(ChunkCount > 2 && (Count / ChunkCount) < PARALLEL_SORT_MIN_CHUNK_SIZE)
+    {
+        ChunkCount /= 2;
+    }
+    i32 ChunkSize = (Count + ChunkCount - 1) / ChunkCount;
+    ChunkCount = (Count + ChunkSize - 1) / ChunkSize;
+
+    JobSystem_ParallelFor(ChunkCount, 1, [Items, Scratch, Count, ChunkSize, &Less](i32 FirstChunk, i32 LastChunk) {
+        for(i32 Chunk = FirstChunk; Chunk < LastChunk; ++Chunk)
+        {
+            i32 First = Chunk*ChunkSize;
+            StableSort(Items + First, Scratch + First, MIN(ChunkSize, Count - First), Less);
+        }
+    });
+
+    T *Src = Items;
+    T *Dst = Scratch;
+    for(i32 Width = ChunkSize; Width < Count; Width *= 2)
+    {
+        i32 PairCount = (Count + 2*Width - 1) / (2*Width);
+        JobSystem_ParallelFor(PairCount, 1, [Src, Dst, Count, Width, &Less](i32 FirstPair, i32 LastPair) {
+            for(i32 Pair = FirstPair; Pair < LastPair; ++Pair)
+            {
+                i32 First = Pair*2*Width;
+                SortMergeRuns(Src, Dst, First, MIN(First + Width, Count), MIN(First + 2*Width, Count), Less);
+            }
+        });
+        SWAP(Src, Dst);
+    }
+
+    if(Src != Items)
+    {
+        for(i32 i = 0; i < Count; ++i)
+        {
+            Items[i] = Src[i];
+        }
+    }
+}
+
+#if _SHU_DEBUG
+void sort_test();
+void sort_benchmark();
+#endif
 
 #define SHOORA_SORT_H
 #endif
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "string_intern.h"
+#include "string_utils.h"
+
+#include <emmintrin.h>
+
+u64
+StringHash64(const char *String, size_t Length, b32 IgnoreCase)
+{
+    u64 Result = 14695981039346656037ull; // FNV Offset Basis.
+    for(size_t i = 0; i < Length; ++i)
+    {
+        char Character = String[i];
+        if(IgnoreCase)
+        {
+            Character = shu::ToLower(Character);
+        }
+
+        Result ^= (u8)Character;
+        Result *= 1099511628211ull; // FNV Prime.
+    }
+
+    return Result;
+}
+
+static b32
+InternedStringsEqual(const char *A, const char *B, u32 Length, b32 IgnoreCase)
+{
+    for(u32 i = 0; i < Length; ++i)
+    {
+        char CharA = A[i];
+        char CharB = B[i];
+        if(IgnoreCase)
+        {
+            CharA = shu::ToLower(CharA);
+            CharB = shu::ToLower(CharB);
+        }
+
+        if(CharA != CharB)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+string_intern_table::Initialize(b32 IgnoreCase, hash_map_allocator Allocator)
+{
+    ASSERT(!this->Initialized);
+
+    this->IgnoreCase = IgnoreCase;
+    this->Allocator = Allocator;
+    if(Allocator.Freelist != nullptr) { this->HashToId.SetAllocator(Allocator.Freelist); }
+    else if(Allocator.Arena != nullptr) { this->HashToId.SetAllocator(Allocator.Arena); }
+    this->HashToId.Reserve(256);
+    this->Initialized = true;
+}
+
+void
+string_intern_table::Free()
+{
+    Lock();
+
+    string_intern_block *Block = this->Blocks;
+    while(Block != nullptr)
+    {
+        string_intern_block *Next = Block->Next;
+        this->Allocator.Free(Block);
+        Block = Next;
+    }
+    this->Blocks = nullptr;
+
+    for(u32 PageIndex = 0; PageIndex < STRING_INTERN_MAX_PAGES; ++PageIndex)
+    {
+        if(this->Pages[PageIndex] != nullptr)
+        {
+            this->Allocator.Free(this->Pages[PageIndex]);
+            this->Pages[PageIndex] = nullptr;
+        }
+    }
+
+    this->HashToId.Free();
+    this->Count = 0;
+    this->Initialized = false;
+
+    Unlock();
+}
+
+void
+string_intern_table::Lock()
+{
+    while(AtomicCompareExchangeU32(&this->LockValue, 1, 0) != 0)
+    {
+        _mm_pause();
+    }
+}
+
+void
+string_intern_table::Unlock()
+{
+    CompletePastWritesBeforeFutureWrites;
+    this->LockValue = 0;
+}
+
+string_id
+string_intern_table::FindLocked(const char *String, u32 Length, u64 Hash)
+{
+    string_id *Head = this->HashToId.Find(Hash);
+    if(Head == nullptr)
+    {
+        return STRING_ID_NONE;
+    }
+
+    for(string_id Id = *Head; Id != STRING_ID_NONE; Id = GetEntry(Id)->NextWithSameHash)
+    {
+        const string_intern_entry *Entry = GetEntry(Id);
+        if(Entry->Length == Length && InternedStringsEqual(Entry->String, String, Length, this->IgnoreCase))
+        {
+            return Id;
+        }
+    }
+
+    return STRING_ID_NONE;
+}
+
+const char *
+string_intern_table::CopyString(const char *String, u32 Length)
+{
+    u32 Needed = Length + 1;
+
+    string_intern_block *Block = this->Blocks;
+    if(Block == nullptr || (Block->Size - Block->Used) < Needed)
+    {
+        u32 BlockSize = MAX(Needed, (u32)STRING_INTERN_BLOCK_SIZE);
+        string_intern_block *NewBlock =
+            (string_intern_block *)this->Allocator.Allocate(sizeof(string_intern_block) + BlockSize);
+        NewBlock->Used = 0;
+        NewBlock->Size = BlockSize;
+
+        // NOTE: An oversized string gets its own block behind the current one, so the rest of the current block is
+        // still used by the next strings.
+        if(Block != nullptr && BlockSize > STRING_INTERN_BLOCK_SIZE)
+        {
+            NewBlock->Next = Block->Next;
+            Block->Next = NewBlock;
+        }
+        else
+        {
+            NewBlock->Next = Block;
+            this->Blocks = NewBlock;
+        }
+        Block = NewBlock;
+    }
+
+    char *Result = (char *)(Block + 1) + Block->Used;
+    SHU_MEMCOPY(String, Result, Length);
+    Result[Length] = '\0';
+    Block->Used += Needed;
+
+    return Result;
+}
+
+string_id
+string_intern_table::Intern(const char *String, u32 Length)
+{
+    ASSERT(String != nullptr);
+    u64 Hash = StringHash64(String, Length, this->IgnoreCase);
+
+    Lock();
+
+    if(!this->Initialized)
+    {
+        this->Initialize(this->IgnoreCase, this->Allocator);
+    }
+
+    string_id Result = FindLocked(String, Length, Hash);
+    if(Result == STRING_ID_NONE)
+    {
+        u32 Index = this->Count;
+        u32 PageIndex = Index / STRING_INTERN_ENTRIES_PER_PAGE;
+        ASSERT(PageIndex < STRING_INTERN_MAX_PAGES);
+        if(this->Pages[PageIndex] == nullptr)
+        {
+            this->Pages[PageIndex] = (string_intern_entry *)this->Allocator.Allocate(
+                sizeof(string_intern_entry) * STRING_INTERN_ENTRIES_PER_PAGE);
+        }
+
+        string_intern_entry *Entry = this->Pages[PageIndex] + (Index % STRING_INTERN_ENTRIES_PER_PAGE);
+        Entry->String = CopyString(String, Length);
+        Entry->Length = Length;
+        Entry->Hash = Hash;
+
+        b32 Inserted;
+        string_id *Head = this->HashToId.FindOrInsert(Hash, &Inserted);
+        Entry->NextWithSameHash = Inserted ? STRING_ID_NONE : *Head;
+        Result = Index + 1;
+        *Head = Result;
+
+        // NOTE: The entry has to be complete before another thread can see the new count in GetEntry.
+        CompletePastWritesBeforeFutureWrites;
+        this->Count = Index + 1;
+    }
+
+    Unlock();
+
+    return Result;
+}
+
+string_id
+string_intern_table::Intern(const char *String)
+{
+    string_id Result = Intern(String, (u32)strlen(String));
+    return Result;
+}
+
+string_id
+string_intern_table::Find(const char *String)
+{
+    ASSERT(String != nullptr);
+    u32 Length = (u32)strlen(String);
+    u64 Hash = StringHash64(String, Length, this->IgnoreCase);
+
+    Lock();
+    string_id Result = this->Initialized ? FindLocked(String, Length, Hash) : STRING_ID_NONE;
+    Unlock();
+
+    return Result;
+}
+
+// NOTE: Case sensitive. Material and node names are case sensitive in glTF, and two of them that only differ in
+// case have to stay two names.
+static string_intern_table GlobalStringTable;
+
+string_id
+InternString(const char *String)
+{
+    string_id Result = GlobalStringTable.Intern(String);
+    return Result;
+}
+
+string_id
+FindInternedString(const char *String)
+{
+    string_id Result = GlobalStringTable.Find(String);
+    return Result;
+}
+
+const char *
+GetInternedString(string_id Id)
+{
+    const char *Result = GlobalStringTable.GetString(Id);
+    return Result;
+}
+
+#if _SHU_DEBUG
+#include <platform/platform.h>
+#include <stdio.h>
+
+void
+string_intern_test()
+{
+    string_intern_table Table;
+
+    char Buffer[64];
+    string_id Ids[2000];
+    for(i32 i = 0; i < ARRAY_SIZE(Ids); ++i)
+    {
+        snprintf(Buffer, ARRAY_SIZE(Buffer), "textures/image_%d.png", i);
+        Ids[i] = Table.Intern(Buffer);
+        ASSERT(Ids[i] == (string_id)(i + 1));
+    }
+    ASSERT(Table.GetCount() == ARRAY_SIZE(Ids));
+
+    for(i32 i = 0; i < ARRAY_SIZE(Ids); ++i)
+    {
+        snprintf(Buffer, ARRAY_SIZE(Buffer), "textures/image_%d.png", i);
+        ASSERT(Table.Intern(Buffer) == Ids[i]);
+        ASSERT(Table.Find(Buffer) == Ids[i]);
+        ASSERT(shu::StringsEqual(Table.GetString(Ids[i]), Buffer));
+        ASSERT(Table.GetLength(Ids[i]) == strlen(Buffer));
+    }
+    ASSERT(Table.GetCount() == ARRAY_SIZE(Ids));
+    ASSERT(Table.Find("textures/IMAGE_0.png") == STRING_ID_NONE);
+
+    // NOTE: Longer than a block.
+    char *Long = (char *)malloc(STRING_INTERN_BLOCK_SIZE + 100);
+    SHU_MEMSET(Long, 'a', STRING_INTERN_BLOCK_SIZE + 99);
+    Long[STRING_INTERN_BLOCK_SIZE + 99] = '\0';
+    string_id LongId = Table.Intern(Long);
+    ASSERT(Table.GetLength(LongId) == STRING_INTERN_BLOCK_SIZE + 99);
+    ASSERT(Table.Intern("after the long one") == LongId + 1);
+    ASSERT(Table.Find(Long) == LongId);
+    free(Long);
+    Table.Free();
+
+    string_intern_table CaseTable(true);
+    string_id Albedo = CaseTable.Intern("Albedo.PNG");
+    ASSERT(CaseTable.Intern("albedo.png") == Albedo);
+    ASSERT(CaseTable.Find("ALBEDO.png") == Albedo);
+    ASSERT(shu::StringsEqual(CaseTable.GetString(Albedo), "Albedo.PNG"));
+    ASSERT(CaseTable.Intern("Albedo.PNG ") != Albedo);
+    CaseTable.Free();
+
+    ASSERT(InternString("String Intern Test") != InternString("string intern test"));
+
+    LogInfoUnformatted("[String Intern Test]: Passed.\n");
+}
+#endif
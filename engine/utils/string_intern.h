@@ -0,0 +1,95 @@
+#if !defined(STRING_INTERN_H)
+
+#include <defines.h>
+#include <containers/hashtable/hash_map.h>
+
+// NOTE: Ids start at 1, zero is never a valid string.
+typedef u32 string_id;
+#define STRING_ID_NONE 0
+
+// NOTE: The characters are copied into blocks of STRING_INTERN_BLOCK_SIZE(longer strings get a block of their own)
+// and the entries into pages of STRING_INTERN_ENTRIES_PER_PAGE. Neither ever moves, so the pointers returned by
+// GetString stay valid for the life of the table and reading them needs no lock.
+#define STRING_INTERN_BLOCK_SIZE KILOBYTES(64)
+#define STRING_INTERN_ENTRIES_PER_PAGE 1024
+#define STRING_INTERN_MAX_PAGES 1024
+
+struct string_intern_entry
+{
+    const char *String;
+    u32 Length;
+    // NOTE: Next string with the same 64 bit hash. Practically always STRING_ID_NONE.
+    string_id NextWithSameHash;
+    u64 Hash;
+};
+
+struct string_intern_block
+{
+    string_intern_block *Next;
+    u32 Used;
+    u32 Size;
+    // NOTE: The characters follow.
+};
+
+// NOTE: FNV-1a. Lower cases every character if IgnoreCase is set.
+u64 StringHash64(const char *String, size_t Length, b32 IgnoreCase = false);
+
+// NOTE: Gives every distinct string one 32 bit id, so the strings can be compared and looked up as integers.
+// Intern and Find take a spin lock, so strings can be interned from any thread. The table does not need to be
+// initialized, it initializes itself with malloc on the first Intern.
+// NOTE: Ids are handed out in order, so an id can be used to index arrays which are kept next to the table.
+struct string_intern_table
+{
+    string_intern_table() = default;
+    explicit string_intern_table(b32 IgnoreCase) : IgnoreCase(IgnoreCase) {}
+
+    // NOTE: IgnoreCase makes "Albedo.PNG" and "albedo.png" the same string, the first spelling interned is kept.
+    void Initialize(b32 IgnoreCase = false, hash_map_allocator Allocator = {});
+    void Free();
+
+    string_id Intern(const char *String);
+    string_id Intern(const char *String, u32 Length);
+    // NOTE: STRING_ID_NONE if the string has not been interned.
+    string_id Find(const char *String);
+
+    inline const string_intern_entry *
+    GetEntry(string_id Id) const
+    {
+        ASSERT(Id != STRING_ID_NONE && Id <= this->Count);
+        u32 Index = Id - 1;
+        return this->Pages[Index / STRING_INTERN_ENTRIES_PER_PAGE] + (Index % STRING_INTERN_ENTRIES_PER_PAGE);
+    }
+
+    inline const char *GetString(string_id Id) const { return GetEntry(Id)->String; }
+    inline u32 GetLength(string_id Id) const { return GetEntry(Id)->Length; }
+    inline u64 GetHash(string_id Id) const { return GetEntry(Id)->Hash; }
+    inline u32 GetCount() const { return this->Count; }
+
+  private:
+    void Lock();
+    void Unlock();
+    string_id FindLocked(const char *String, u32 Length, u64 Hash);
+    const char *CopyString(const char *String, u32 Length);
+
+    u32 volatile LockValue = 0;
+    b32 Initialized = false;
+    b32 IgnoreCase = false;
+    hash_map_allocator Allocator;
+
+    shoora_hash_map<u64, string_id> HashToId;
+    string_intern_block *Blocks = nullptr;
+    string_intern_entry *Pages[STRING_INTERN_MAX_PAGES] = {};
+    u32 volatile Count = 0;
+};
+
+// NOTE: The engine wide table for asset, material and mesh names. It is case sensitive.
+string_id InternString(const char *String);
+string_id FindInternedString(const char *String);
+const char *GetInternedString(string_id Id);
+
+#if _SHU_DEBUG
+void string_intern_test();
+#endif
+
+#define STRING_INTERN_H
+#endif // STRING_INTERN_H
@@ -48,17 +48,17 @@ template <typename T>
 void
 GetFormatSpecifier(char *Buffer, T Value)
 {
-    if constexpr (std::is_same_v<T, int>) { StringCopy("%d", Buffer); }
-    else if constexpr (std::is_same_v<T, unsigned int>) { StringCopy("%u", Buffer); }
-    else if constexpr (std::is_same_v<T, long>) { StringCopy("%ld", Buffer); }
-    else if constexpr (std::is_same_v<T, unsigned long>) { StringCopy("%lu", Buffer); }
-    else if constexpr (std::is_same_v<T, long long>) { StringCopy("%lld", Buffer); }
-    else if constexpr (std::is_same_v<T, unsigned long long>) { StringCopy("%llu", Buffer); }
-    else if constexpr (std::is_same_v<T, float>) { StringCopy("%f", Buffer); }
-    else if constexpr (std::is_same_v<T, double>) { StringCopy("%lf", Buffer); }
-    else if constexpr (std::is_same_v<T, char>) { StringCopy("%c", Buffer); }
-    else if constexpr (std::is_same_v<T, const char *>) { StringCopy("%s", Buffer); }
-    else if constexpr (std::is_pointer_v<T>) { StringCopy("%p", Buffer); }
+    if constexpr (std::is_same_v<T, int>) { shu::StringCopy("%d", Buffer); }
+    else if constexpr (std::is_same_v<T, unsigned int>) { shu::StringCopy("%u", Buffer); }
+    else if constexpr (std::is_same_v<T, long>) { shu::StringCopy("%ld", Buffer); }
+    else if constexpr (std::is_same_v<T, unsigned long>) { shu::StringCopy("%lu", Buffer); }
+    else if constexpr (std::is_same_v<T, long long>) { shu::StringCopy("%lld", Buffer); }
+    else if constexpr (std::is_same_v<T, unsigned long long>) { shu::StringCopy("%llu", Buffer); }
+    else if constexpr (std::is_same_v<T, float>) { shu::StringCopy("%f", Buffer); }
+    else if constexpr (std::is_same_v<T, double>) { shu::StringCopy("%lf", Buffer); }
+    else if constexpr (std::is_same_v<T, char>) { shu::StringCopy("%c", Buffer); }
+    else if constexpr (std::is_same_v<T, const char *>) { shu::StringCopy("%s", Buffer); }
+    else if constexpr (std::is_pointer_v<T>) { shu::StringCopy("%p", Buffer); }
     else { SHU_INVALID_CODEPATH; }
 }
 
@@ -85,7 +85,7 @@ struct templated_log_string
         GetFormatSpecifier(FormatSpec, Rhs);
 
         shu::StringConcat(Buffer + Index, FormatSpec);
-        Index += StringLength(FormatSpec);
+        Index += shu::StringLength(FormatSpec);
         return *this;
     }
 
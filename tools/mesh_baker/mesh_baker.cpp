@@ -0,0 +1,292 @@
+// NOTE: Bakes glTF/glb files into the engine's .shmesh files(engine/loaders/meshes/mesh_binary.h). It loads the
+// file with the engine's own loader and writes the result out, so the engine only has to map it.
+//
+// Usage: ShooraMeshBaker [--vertex-format full|compact|quantized] <input.gltf|input.glb> [output.shmesh]
+//
+// The output goes next to the input if it is not given. The vertex format is the one the renderer is going to load
+// the model in(mesh/vertex_packing.h), the packed vertices are baked in so it does not have to pack them. The images
+// are not baked, they are looked up next to the .shmesh file the same way they are for the glTF file. It goes after
+// gltfpack in the asset pipeline:
+//     tools/gltfpack.exe -i model.gltf -o model.glb
+//     ShooraMeshBaker model.glb
+
+#include <defines.h>
+#include <platform/platform.h>
+#include <platform/job_system.h>
+#include <memory/memory.h>
+#include <loaders/meshes/mesh_binary.h>
+#include <mesh/vertex_packing.h>
+#include <renderer/vulkan/vulkan_vertex_definitions.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+
+// NOTE: The baker has no window or renderer, only the platform functions the loader needs are here and they all go
+// to stdio.
+static void
+Log_(FILE *Stream, const char *Format, va_list VarArgs)
+{
+    vfprintf(Stream, Format, VarArgs);
+}
+
+#define LOG_FORMAT(Stream, Format)                                                                                \
+    va_list VarArgs;                                                                                              \
+    va_start(VarArgs, Format);                                                                                    \
+    Log_(Stream, Format, VarArgs);                                                                                \
+    va_end(VarArgs);
+void LogOutput(LogType LogType, const char *Format, ...) { LOG_FORMAT(stdout, Format); }
+void LogInfo(const char *Format, ...) { LOG_FORMAT(stdout, Format); }
+void LogDebug(const char *Format, ...) { LOG_FORMAT(stdout, Format); }
+void LogWarn(const char *Format, ...) { LOG_FORMAT(stderr, Format); }
+void LogError(const char *Format, ...) { LOG_FORMAT(stderr, Format); }
+void LogFatal(const char *Format, ...) { LOG_FORMAT(stderr, Format); }
+void LogTrace(const char *Format, ...) { LOG_FORMAT(stdout, Format); }
+
+void LogUnformatted(const char *Message) { fputs(Message, stdout); }
+void LogInfoUnformatted(const char *Message) { fputs(Message, stdout); }
+void LogDebugUnformatted(const char *Message) { fputs(Message, stdout); }
+void LogWarnUnformatted(const char *Message) { fputs(Message, stderr); }
+void LogErrorUnformatted(const char *Message) { fputs(Message, stderr); }
+void LogFatalUnformatted(const char *Message) { fputs(Message, stderr); }
+void LogTraceUnformatted(const char *Message) { fputs(Message, stdout); }
+void LogString(const char *String) { fputs(String, stdout); }
+
+i32
+Platform_GenerateString(char *Buffer, u32 BufferSize, const char *Format, ...)
+{
+    va_list VarArgs;
+    va_start(VarArgs, Format);
+    i32 Length = vsnprintf(Buffer, BufferSize, Format, VarArgs);
+    va_end(VarArgs);
+    return Length;
+}
+
+void
+Platform_ExitApplication(const char *Reason)
+{
+    LogFatal("%s", Reason);
+    exit(1);
+}
+
+u32
+Platform_GetRandomSeed()
+{
+    return (u32)time(nullptr);
+}
+
+u64
+Platform_GetWallClock()
+{
+    u64 Result = (u64)std::chrono::steady_clock::now().time_since_epoch().count();
+    return Result;
+}
+
+f32
+Platform_GetSecondsElapsed(u64 Start, u64 End)
+{
+    f32 Result = (f32)((f64)(End - Start)*std::chrono::steady_clock::period::num /
+                       std::chrono::steady_clock::period::den);
+    return Result;
+}
+
+u32
+Platform_GetThreadIndex()
+{
+    return JobSystem_GetThreadIndex();
+}
+
+b32
+Platform_WriteFile(char *Filename, u32 Size, void *Data)
+{
+    b32 Result = false;
+    FILE *File = fopen(Filename, "wb");
+    if(File)
+    {
+        Result = (fwrite(Data, 1, Size, File) == Size);
+        fclose(File);
+    }
+
+    return Result;
+}
+
+// NOTE: Only used to read the baked file back and check it, a plain read is enough for that.
+platform_mapped_file
+Platform_MapFile(const char *Path)
+{
+    platform_mapped_file Result = {};
+    FILE *File = fopen(Path, "rb");
+    if(File)
+    {
+        fseek(File, 0, SEEK_END);
+        long Size = ftell(File);
+        fseek(File, 0, SEEK_SET);
+        if(Size > 0)
+        {
+            Result.Data = malloc((size_t)Size);
+            if(Result.Data && fread(Result.Data, 1, (size_t)Size, File) == (size_t)Size)
+            {
+                Result.Size = (u64)Size;
+            }
+            else
+            {
+                free(Result.Data);
+                Result.Data = nullptr;
+            }
+        }
+        fclose(File);
+    }
+
+    return Result;
+}
+
+void
+Platform_UnmapFile(platform_mapped_file *File)
+{
+    free(File->Data);
+    File->Data = nullptr;
+    File->Size = 0;
+}
+
+// NOTE: The loaded and the baked model have to give the renderer the same thing.
+static b32
+CheckBakedModel(const shoora_model *Loaded, const shoora_model *Baked)
+{
+    const shoora_mesh_filter *A = &Loaded->MeshFilter;
+    const shoora_mesh_filter *B = &Baked->MeshFilter;
+    b32 Result = (A->VertexCount == B->VertexCount) && (A->IndexCount == B->IndexCount) &&
+                 (memcmp(A->Vertices, B->Vertices, sizeof(shoora_vertex_info)*A->VertexCount) == 0) &&
+                 (A->PackedFormat == B->PackedFormat) &&
+                 (memcmp(&A->PositionDequant, &B->PositionDequant, sizeof(shoora_vertex_dequant)) == 0) &&
+                 (A->PackedVertices == nullptr ||
+                  memcmp(A->PackedVertices, B->PackedVertices,
+                         (size_t)GetVertexFormatSize(A->PackedFormat)*A->VertexCount) == 0) &&
+                 (memcmp(A->Indices, B->Indices, sizeof(u32)*A->IndexCount) == 0) &&
+                 (Loaded->AllNodeCount == Baked->AllNodeCount) && (Loaded->NodeCount == Baked->NodeCount) &&
+                 (Loaded->MaterialCount == Baked->MaterialCount) && (Loaded->TextureCount == Baked->TextureCount);
+
+    for(u32 NodeIndex = 0; Result && NodeIndex < Loaded->AllNodeCount; ++NodeIndex)
+    {
+        const shoora_mesh_cgltf_node *NodeA = Loaded->AllNodes + NodeIndex;
+        const shoora_mesh_cgltf_node *NodeB = Baked->AllNodes + NodeIndex;
+        Result = (NodeA->Name == NodeB->Name) && (NodeA->ChildrenCount == NodeB->ChildrenCount) &&
+                 (NodeA->PrimitiveCount == NodeB->PrimitiveCount) &&
+                 (memcmp(&NodeA->WorldMatrix, &NodeB->WorldMatrix, sizeof(shu::mat4f)) == 0) &&
+                 (NodeA->PrimitiveCount == 0 || memcmp(NodeA->Primitives, NodeB->Primitives,
+                                                       sizeof(shoora_mesh_primitive)*NodeA->PrimitiveCount) == 0);
+    }
+    for(u32 TexIndex = 0; Result && TexIndex < Loaded->TextureCount; ++TexIndex)
+    {
+        Result = (Loaded->Textures[TexIndex].ImageNameId == Baked->Textures[TexIndex].ImageNameId);
+    }
+
+    return Result;
+}
+
+static b32
+ParseVertexFormat(const char *Name, shoora_vertex_format *Format)
+{
+    for(u32 Index = 0; Index < VertexFormat_Count; ++Index)
+    {
+        if(strcmp(Name, GetVertexFormatName((shoora_vertex_format)Index)) == 0)
+        {
+            *Format = (shoora_vertex_format)Index;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int
+main(int ArgCount, char **Args)
+{
+    shoora_vertex_format VertexFormat = VertexFormat_Full;
+    i32 ArgIndex = 1;
+    if(ArgIndex + 1 < ArgCount && strcmp(Args[ArgIndex], "--vertex-format") == 0)
+    {
+        if(!ParseVertexFormat(Args[ArgIndex + 1], &VertexFormat))
+        {
+            LogError("Unknown vertex format %s, it has to be full, compact or quantized.\n", Args[ArgIndex + 1]);
+            return 1;
+        }
+        ArgIndex += 2;
+    }
+
+    if(ArgIndex >= ArgCount)
+    {
+        LogError("Usage: %s [--vertex-format full|compact|quantized] <input.gltf|input.glb> [output%s]\n", Args[0],
+                 SHOORA_MESH_FILE_EXTENSION);
+        return 1;
+    }
+
+    const char *InputPath = Args[ArgIndex];
+    char OutputPath[512];
+    if(ArgIndex + 1 < ArgCount)
+    {
+        snprintf(OutputPath, sizeof(OutputPath), "%s", Args[ArgIndex + 1]);
+    }
+    else
+    {
+        const char *Extension = strrchr(InputPath, '.');
+        i32 BaseLength = Extension ? (i32)(Extension - InputPath) : (i32)strlen(InputPath);
+        snprintf(OutputPath, sizeof(OutputPath), "%.*s%s", BaseLength, InputPath, SHOORA_MESH_FILE_EXTENSION);
+    }
+
+    // NOTE: The loader only uses the thread frame arenas for its work lists, they do not need to be big.
+    memory_config MemoryConfig;
+    MemoryConfig.MainThreadArenaSize = MEGABYTES(64);
+    MemoryConfig.WorkerThreadArenaSize = MEGABYTES(4);
+    size_t PermSize = MEGABYTES(256);
+    size_t FrameSize = MEGABYTES(256);
+    void *PermMemory = calloc(1, PermSize);
+    void *FrameMemory = calloc(1, FrameSize);
+    if(!PermMemory || !FrameMemory)
+    {
+        LogError("Could not allocate the baker's memory.\n");
+        return 1;
+    }
+    InitializeMemory(PermSize, PermMemory, FrameSize, FrameMemory, MemoryConfig);
+    JobSystem_Initialize();
+
+#if _SHU_DEBUG
+    VertexPackingTest();
+#endif
+
+    shoora_model Model;
+    LoadModel(&Model, InputPath, false, VertexFormat);
+
+    i32 Result = 0;
+    if(!SaveModelBinary(&Model, OutputPath))
+    {
+        LogError("Could not write %s.\n", OutputPath);
+        Result = 1;
+    }
+    else
+    {
+        shoora_model Baked;
+        LoadModel(&Baked, OutputPath, false, VertexFormat);
+        if(!CheckBakedModel(&Model, &Baked))
+        {
+            LogError("%s does not load back the same as %s.\n", OutputPath, InputPath);
+            Result = 1;
+        }
+        else
+        {
+            LogInfo("Baked %s into %s: %u vertices, %u indices, %u nodes, %u materials, %u textures.\n", InputPath,
+                    OutputPath, Model.MeshFilter.VertexCount, Model.MeshFilter.IndexCount, Model.AllNodeCount,
+                    Model.MaterialCount, Model.TextureCount);
+        }
+        CleanupModelResources(&Baked);
+    }
+
+    CleanupModelResources(&Model);
+    JobSystem_Shutdown();
+    free(PermMemory);
+    free(FrameMemory);
+
+    return Result;
+}